@@ -0,0 +1,541 @@
+/**
+ * This program measures the performance of the config tree daemon on a synthetic tree.
+ *
+ * The tree holds a given number of integer leaves, spread under stems with a given fan-out, in a
+ * tree of its own named "configBench".  The program is run in phases, so that the script running
+ * it can restart the daemon in between:
+ *
+ *   configBench build <leafCount> <fanOut>   Creates the tree, and reports how quickly that went.
+ *   configBench run <leafCount> <fanOut>     Reports the time taken to load the tree, the speed of
+ *                                            lookups and of read and write transactions, commit
+ *                                            latency with and without change handlers registered,
+ *                                            and the daemon's memory use.
+ *   configBench delete                       Deletes the tree.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+// Name of the tree used for the benchmark.
+#define TREE_NAME "configBench"
+
+// Maximum depth of the synthetic tree, (a fan-out of 2 with a million leaves needs 20.)
+#define MAX_DEPTH 32
+
+// Number of leaves written by each transaction when the tree is built.
+#define BUILD_TXN_LEAVES 10000
+
+// Number of random leaves looked up in one read transaction.
+#define NUM_LOOKUPS 10000
+
+// Number of transactions in each of the transaction bursts.
+#define NUM_TXNS 2000
+
+// Number of leaves written by each of the large commits.
+#define LARGE_COMMIT_LEAVES 1000
+
+// Number of large commits timed.
+#define NUM_LARGE_COMMITS 20
+
+// Number of change handlers registered for the commit latency tests.
+#define NUM_HANDLERS 100
+
+// Number of leaves in the tree.
+static uint32_t LeafCount;
+
+// Number of children of each stem.
+static uint32_t FanOut;
+
+// Number of stems between the root and each leaf, plus one for the leaf itself.
+static uint32_t Depth;
+
+// Latencies measured by the current burst, in milliseconds.
+static double Latencies[NUM_TXNS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the time elapsed since a given time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double MsecSince
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return (diffTime.sec * 1000.0) + (diffTime.usec / 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the path of a leaf, relative to the root of the tree.  Each stem level is named after one
+ * digit of the leaf's index, in base FanOut.
+ *
+ * @return The length of the path.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t LeafPath
+(
+    uint32_t index,
+    char* bufferPtr,
+    size_t bufferSize
+)
+{
+    uint32_t digits[MAX_DEPTH];
+    uint32_t level;
+    size_t length = 0;
+
+    for (level = Depth; level > 0; level--)
+    {
+        digits[level - 1] = index % FanOut;
+        index /= FanOut;
+    }
+
+    for (level = 0; level < Depth - 1; level++)
+    {
+        length += snprintf(bufferPtr + length, bufferSize - length, "s%u/", digits[level]);
+    }
+
+    length += snprintf(bufferPtr + length, bufferSize - length, "v%u", digits[Depth - 1]);
+
+    LE_ASSERT(length < bufferSize);
+
+    return length;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Picks a random leaf.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RandomLeaf
+(
+    void
+)
+{
+    return (uint32_t)(((uint64_t)rand() * RAND_MAX + rand()) % LeafCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a range of leaves within a write transaction, using as few batches as possible.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteLeaves
+(
+    le_cfg_IteratorRef_t iterRef,
+    uint32_t firstIndex,
+    uint32_t count,
+    int32_t value
+)
+{
+    uint8_t buffer[LE_CFGBATCH_BATCH_BYTES];
+    size_t size = 0;
+    uint32_t index;
+
+    for (index = firstIndex; index < firstIndex + count; index++)
+    {
+        char record[LE_CFG_STR_LEN_BYTES];
+        size_t recordSize = 0;
+
+        record[recordSize++] = LE_CFG_TYPE_INT;
+        recordSize += LeafPath(index, record + recordSize, sizeof(record) - recordSize) + 1;
+        recordSize += snprintf(record + recordSize,
+                               sizeof(record) - recordSize,
+                               "%" PRIi32,
+                               value + (int32_t)index) + 1;
+
+        if (size + recordSize > sizeof(buffer))
+        {
+            LE_ASSERT(le_cfgBatch_SetBatch(iterRef, buffer, size) == LE_OK);
+            size = 0;
+        }
+
+        memcpy(buffer + size, record, recordSize);
+        size += recordSize;
+    }
+
+    if (size > 0)
+    {
+        LE_ASSERT(le_cfgBatch_SetBatch(iterRef, buffer, size) == LE_OK);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the resident set size of the config tree daemon, in kilobytes.
+ *
+ * @return The RSS, or -1 if the daemon's process couldn't be found.
+ */
+//--------------------------------------------------------------------------------------------------
+static long DaemonRss
+(
+    void
+)
+{
+    DIR* dirPtr = opendir("/proc");
+    struct dirent* entryPtr;
+    long rss = -1;
+
+    if (dirPtr == NULL)
+    {
+        return -1;
+    }
+
+    while ((rss < 0) && ((entryPtr = readdir(dirPtr)) != NULL))
+    {
+        char path[PATH_MAX];
+        char line[128];
+        bool isDaemon = false;
+        FILE* filePtr;
+
+        snprintf(path, sizeof(path), "/proc/%s/status", entryPtr->d_name);
+
+        if ((filePtr = fopen(path, "r")) == NULL)
+        {
+            continue;
+        }
+
+        while (fgets(line, sizeof(line), filePtr) != NULL)
+        {
+            if (strcmp(line, "Name:\tconfigTree\n") == 0)
+            {
+                isDaemon = true;
+            }
+            else if (isDaemon && (strncmp(line, "VmRSS:", 6) == 0))
+            {
+                rss = strtol(line + 6, NULL, 10);
+            }
+        }
+
+        fclose(filePtr);
+    }
+
+    closedir(dirPtr);
+
+    return rss;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares two latencies, for sorting.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareLatencies
+(
+    const void* aPtr,
+    const void* bPtr
+)
+{
+    double a = *(const double*)aPtr;
+    double b = *(const double*)bPtr;
+
+    return (a > b) - (a < b);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the distribution of the latencies measured by a burst.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintLatencies
+(
+    const char* burstName,
+    size_t count
+)
+{
+    double total = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        total += Latencies[i];
+    }
+
+    qsort(Latencies, count, sizeof(Latencies[0]), CompareLatencies);
+
+    printf("%-40s avg %8.3f ms  p50 %8.3f ms  p99 %8.3f ms  max %8.3f ms\n",
+           burstName,
+           total / count,
+           Latencies[count / 2],
+           Latencies[(count * 99) / 100],
+           Latencies[count - 1]);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the rate at which a number of operations were done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintRate
+(
+    const char* operationName,
+    size_t count,
+    double msec
+)
+{
+    printf("%-40s %8zu in %10.1f ms  (%.0f per second)\n",
+           operationName,
+           count,
+           msec,
+           (msec > 0) ? (count * 1000.0 / msec) : 0.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Times a burst of write transactions, each changing one random leaf.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SmallCommitBurst
+(
+    const char* burstName
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    size_t i;
+
+    for (i = 0; i < NUM_TXNS; i++)
+    {
+        size_t length = snprintf(path, sizeof(path), TREE_NAME ":/");
+
+        LeafPath(RandomLeaf(), path + length, sizeof(path) - length);
+
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(path);
+        le_cfg_SetInt(iterRef, "", (int32_t)i);
+
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+        le_cfg_CommitTxn(iterRef);
+        Latencies[i] = MsecSince(startTime);
+    }
+
+    PrintLatencies(burstName, NUM_TXNS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Times a number of write transactions, each changing a run of LARGE_COMMIT_LEAVES leaves.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LargeCommitBurst
+(
+    const char* burstName
+)
+{
+    uint32_t count = (LeafCount < LARGE_COMMIT_LEAVES) ? LeafCount : LARGE_COMMIT_LEAVES;
+    size_t i;
+
+    for (i = 0; i < NUM_LARGE_COMMITS; i++)
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(TREE_NAME ":/");
+        WriteLeaves(iterRef, RandomLeaf() % (LeafCount - count + 1), count, (int32_t)i);
+
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+        le_cfg_CommitTxn(iterRef);
+        Latencies[i] = MsecSince(startTime);
+    }
+
+    PrintLatencies(burstName, NUM_LARGE_COMMITS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change handler for the commit latency tests.  Only there to be called.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChangeHandler
+(
+    void* contextPtr
+)
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Build
+(
+    void
+)
+{
+    uint32_t index;
+
+    le_cfgAdmin_DeleteTree(TREE_NAME);
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    for (index = 0; index < LeafCount; index += BUILD_TXN_LEAVES)
+    {
+        uint32_t count = LeafCount - index;
+
+        if (count > BUILD_TXN_LEAVES)
+        {
+            count = BUILD_TXN_LEAVES;
+        }
+
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(TREE_NAME ":/");
+        WriteLeaves(iterRef, index, count, 0);
+        le_cfg_CommitTxn(iterRef);
+    }
+
+    PrintRate("leaves written", LeafCount, MsecSince(startTime));
+    printf("%-40s %8ld kB\n", "daemon RSS", DaemonRss());
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the benchmarks against a tree that was created by an earlier Build().
+ */
+//--------------------------------------------------------------------------------------------------
+static void Run
+(
+    void
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    size_t i;
+
+    printf("%-40s %8ld kB\n", "daemon RSS before load", DaemonRss());
+
+    // The daemon loads a tree the first time a transaction is started on it.
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TREE_NAME ":/");
+    printf("%-40s %10.1f ms\n", "tree load", MsecSince(startTime));
+
+    printf("%-40s %8ld kB\n", "daemon RSS after load", DaemonRss());
+
+    // Look up random leaves, all in the one transaction.
+    int32_t missing = 0;
+    startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < NUM_LOOKUPS; i++)
+    {
+        LeafPath(RandomLeaf(), path, sizeof(path));
+
+        if (le_cfg_GetInt(iterRef, path, -1) < 0)
+        {
+            missing++;
+        }
+    }
+
+    PrintRate("lookups", NUM_LOOKUPS, MsecSince(startTime));
+    le_cfg_CancelTxn(iterRef);
+
+    LE_FATAL_IF(missing > 0, "%d leaves are missing from the tree.", missing);
+
+    // Read transactions, each reading one random leaf.
+    startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < NUM_TXNS; i++)
+    {
+        size_t length = snprintf(path, sizeof(path), TREE_NAME ":/");
+
+        LeafPath(RandomLeaf(), path + length, sizeof(path) - length);
+
+        iterRef = le_cfg_CreateReadTxn(path);
+        le_cfg_GetInt(iterRef, "", 0);
+        le_cfg_CancelTxn(iterRef);
+    }
+
+    PrintRate("read transactions", NUM_TXNS, MsecSince(startTime));
+
+    // Write transactions, first with no change handlers registered.
+    startTime = le_clk_GetRelativeTime();
+    SmallCommitBurst("1 leaf commit, no handlers");
+    PrintRate("write transactions", NUM_TXNS, MsecSince(startTime));
+
+    LargeCommitBurst("1000 leaf commit, no handlers");
+
+    // Then again, with handlers watching random leaves and stems.
+    for (i = 0; i < NUM_HANDLERS; i++)
+    {
+        size_t length = snprintf(path, sizeof(path), TREE_NAME ":/");
+
+        length += LeafPath(RandomLeaf(), path + length, sizeof(path) - length);
+
+        // Every other handler watches a stem rather than a leaf.
+        if ((i % 2 == 1) && (Depth > 1))
+        {
+            *strrchr(path, '/') = '\0';
+        }
+
+        le_cfg_AddChangeHandler(path, ChangeHandler, NULL);
+    }
+
+    SmallCommitBurst("1 leaf commit, 100 handlers");
+    LargeCommitBurst("1000 leaf commit, 100 handlers");
+
+    printf("%-40s %8ld kB\n", "daemon RSS after run", DaemonRss());
+}
+
+
+COMPONENT_INIT
+{
+    const char* phasePtr = (le_arg_NumArgs() >= 1) ? le_arg_GetArg(0) : "";
+
+    if (strcmp(phasePtr, "delete") == 0)
+    {
+        le_cfgAdmin_DeleteTree(TREE_NAME);
+        exit(EXIT_SUCCESS);
+    }
+
+    LE_FATAL_IF(le_arg_NumArgs() != 3,
+                "Usage: configBench build|run <leafCount> <fanOut>, or configBench delete");
+
+    LeafCount = strtoul(le_arg_GetArg(1), NULL, 10);
+    FanOut = strtoul(le_arg_GetArg(2), NULL, 10);
+
+    LE_FATAL_IF((LeafCount == 0) || (FanOut < 2), "Need at least one leaf and a fan-out of 2.");
+
+    // Find the depth needed to give every leaf its own path.
+    uint64_t capacity = FanOut;
+
+    for (Depth = 1; capacity < LeafCount; Depth++)
+    {
+        capacity *= FanOut;
+    }
+
+    LE_FATAL_IF(Depth > MAX_DEPTH, "Fan-out %u is too small for %u leaves.", FanOut, LeafCount);
+
+    printf("==== configBench %s: %u leaves, fan-out %u, depth %u ====\n",
+           phasePtr,
+           LeafCount,
+           FanOut,
+           Depth);
+
+    srand(1);
+
+    if (strcmp(phasePtr, "build") == 0)
+    {
+        Build();
+    }
+    else if (strcmp(phasePtr, "run") == 0)
+    {
+        Run();
+    }
+    else
+    {
+        LE_FATAL("Unknown phase '%s'.", phasePtr);
+    }
+
+    exit(EXIT_SUCCESS);
+}
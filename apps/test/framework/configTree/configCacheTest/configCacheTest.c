@@ -0,0 +1,99 @@
+#include "legato.h"
+#include "interfaces.h"
+#include "cfgCache.h"
+
+
+
+
+/// Where in the tree the test runs.
+#define TEST_ROOT "/configCacheTest"
+
+
+
+
+static cfgCache_Ref_t CacheRef;
+
+
+
+
+static void CheckUpdatedValues
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_INFO("----  Checking the values after the change.  -----------");
+
+    // The change handler has had a chance to run, so the cache has been reloaded.
+    LE_ASSERT(cfgCache_GetInt(CacheRef, "rate", 0) == 10);
+    LE_ASSERT(cfgCache_NodeExists(CacheRef, "sub/added"));
+    LE_ASSERT(cfgCache_GetBool(CacheRef, "flag", true) == false);
+
+    LE_INFO("----  Done.  --------------------------------------------");
+
+    exit(EXIT_SUCCESS);
+}
+
+
+
+
+COMPONENT_INIT
+{
+    char strBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    LE_INFO("----  Checking the cached values.  ----------------------");
+
+    le_cfg_QuickDeleteNode(TEST_ROOT);
+    le_cfg_QuickSetInt(TEST_ROOT "/rate", 5);
+    le_cfg_QuickSetString(TEST_ROOT "/sub/name", "aName");
+    le_cfg_QuickSetBool(TEST_ROOT "/flag", true);
+    le_cfg_QuickSetFloat(TEST_ROOT "/ratio", 0.5);
+
+    CacheRef = cfgCache_Create(TEST_ROOT);
+
+    LE_ASSERT(cfgCache_GetInt(CacheRef, "rate", 0) == 5);
+    LE_ASSERT(cfgCache_GetFloat(CacheRef, "rate", 0.0) == 5.0);
+    LE_ASSERT(cfgCache_GetFloat(CacheRef, "ratio", 0.0) == 0.5);
+    LE_ASSERT(cfgCache_GetInt(CacheRef, "ratio", 0) == 1);
+    LE_ASSERT(cfgCache_GetBool(CacheRef, "flag", false) == true);
+
+    LE_ASSERT(cfgCache_GetString(CacheRef, "sub/name", strBuffer, sizeof(strBuffer), "") == LE_OK);
+    LE_ASSERT(strcmp(strBuffer, "aName") == 0);
+    LE_ASSERT(cfgCache_GetString(CacheRef, "sub/name", strBuffer, 3, "") == LE_OVERFLOW);
+
+    // Missing nodes, and nodes of the wrong type, give back the default value.
+    LE_ASSERT(cfgCache_GetInt(CacheRef, "sub/name", 42) == 42);
+    LE_ASSERT(cfgCache_GetInt(CacheRef, "missing", 42) == 42);
+    LE_ASSERT(cfgCache_GetString(CacheRef, "rate", strBuffer, sizeof(strBuffer), "dflt") == LE_OK);
+    LE_ASSERT(strcmp(strBuffer, "dflt") == 0);
+
+    LE_ASSERT(cfgCache_NodeExists(CacheRef, "sub"));
+    LE_ASSERT(cfgCache_NodeExists(CacheRef, "sub/name"));
+    LE_ASSERT(cfgCache_NodeExists(CacheRef, "missing") == false);
+
+    // Paths are read the same way as le_cfg reads them.
+    LE_ASSERT(cfgCache_GetInt(CacheRef, "./rate", 0) == 5);
+    LE_ASSERT(cfgCache_GetString(CacheRef, "sub//name", strBuffer, sizeof(strBuffer), "") == LE_OK);
+    LE_ASSERT(strcmp(strBuffer, "aName") == 0);
+    LE_ASSERT(cfgCache_GetString(CacheRef, "sub/./name/", strBuffer, sizeof(strBuffer), "")
+              == LE_OK);
+    LE_ASSERT(strcmp(strBuffer, "aName") == 0);
+    LE_ASSERT(cfgCache_NodeExists(CacheRef, "sub/"));
+    LE_ASSERT(cfgCache_NodeExists(CacheRef, ""));
+    LE_ASSERT(cfgCache_GetInt(CacheRef, TEST_ROOT "/rate", 0) == 5);
+    LE_ASSERT(cfgCache_GetInt(CacheRef, "../configCacheTest/rate", 0) == 5);
+
+    // Change the subtree, then give the change notification time to arrive.
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(TEST_ROOT);
+
+    le_cfg_SetInt(iterRef, "rate", 10);
+    le_cfg_SetEmpty(iterRef, "sub/added");
+    le_cfg_SetBool(iterRef, "flag", false);
+    le_cfg_CommitTxn(iterRef);
+
+    le_timer_Ref_t timerRef = le_timer_Create("configCacheTest");
+    le_clk_Time_t delay = { 1, 0 };
+
+    le_timer_SetInterval(timerRef, delay);
+    le_timer_SetHandler(timerRef, CheckUpdatedValues);
+    le_timer_Start(timerRef);
+}
@@ -0,0 +1,231 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads and writes the tree used by configPersistTest.sh, which checks that the config tree daemon
+ * saves trees to the filesystem and loads them back correctly.  The script restarts the daemon and
+ * damages the tree files between runs of this program.
+ *
+ * Usage:
+ *
+ *   configPersistTest write <generation> <count>
+ *   configPersistTest check <generation> <count>
+ *   configPersistTest set <name> <value>
+ *   configPersistTest expect <name> <value>   (a value of "-" means that the node must not exist)
+ *   configPersistTest empty
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+
+
+/// The tree that the test works on.
+#define TEST_TREE "persistTest:"
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value that the write command gives to a data node.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetDataValue
+(
+    int generation,
+    int index,
+    char* bufferPtr,
+    size_t bufferSize
+)
+{
+    snprintf(bufferPtr, bufferSize, "generation %d, value %d, with some padding.", generation, index);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a numeric command line argument.
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetIntArg
+(
+    size_t index
+)
+{
+    const char* argPtr = le_arg_GetArg(index);
+
+    LE_FATAL_IF(argPtr == NULL, "Missing argument %zu.", index);
+
+    return atoi(argPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the data nodes in a single transaction.  This is big enough for its journal entry to get
+ * the tree compacted into a binary tree file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteData
+(
+    int generation,
+    int count
+)
+{
+    char name[32];
+    char value[LE_CFG_STR_LEN_BYTES];
+    int i;
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(TEST_TREE "/data");
+
+    for (i = 0; i < count; i++)
+    {
+        snprintf(name, sizeof(name), "node%d", i);
+        GetDataValue(generation, i, value, sizeof(value));
+        le_cfg_SetString(iterRef, name, value);
+    }
+
+    le_cfg_CommitTxn(iterRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that all of the data nodes have the values written by WriteData().
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckData
+(
+    int generation,
+    int count
+)
+{
+    char name[32];
+    char expected[LE_CFG_STR_LEN_BYTES];
+    char value[LE_CFG_STR_LEN_BYTES];
+    bool isOk = true;
+    int i;
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TEST_TREE "/data");
+
+    for (i = 0; (i < count) && isOk; i++)
+    {
+        snprintf(name, sizeof(name), "node%d", i);
+        GetDataValue(generation, i, expected, sizeof(expected));
+
+        if (   (le_cfg_GetString(iterRef, name, value, sizeof(value), "") != LE_OK)
+            || (strcmp(value, expected) != 0))
+        {
+            LE_ERROR("Node '%s' is '%s', expected '%s'.", name, value, expected);
+            isOk = false;
+        }
+    }
+
+    // Nothing else should be there.
+    snprintf(name, sizeof(name), "node%d", count);
+    if (isOk && le_cfg_NodeExists(iterRef, name))
+    {
+        LE_ERROR("Unexpected node '%s'.", name);
+        isOk = false;
+    }
+
+    le_cfg_CancelTxn(iterRef);
+
+    return isOk;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the value of one of the nodes written by the set command.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckExtra
+(
+    const char* namePtr,
+    const char* expectedPtr
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    char value[LE_CFG_STR_LEN_BYTES] = "";
+
+    snprintf(path, sizeof(path), TEST_TREE "/extra/%s", namePtr);
+
+    if (strcmp(expectedPtr, "-") == 0)
+    {
+        if (le_cfg_QuickGetString(path, value, sizeof(value), "-") == LE_OK)
+        {
+            LE_ERROR_IF(strcmp(value, "-") != 0, "Node '%s' is '%s', expected none.", path, value);
+        }
+
+        return (strcmp(value, "-") == 0);
+    }
+
+    if (   (le_cfg_QuickGetString(path, value, sizeof(value), "") != LE_OK)
+        || (strcmp(value, expectedPtr) != 0))
+    {
+        LE_ERROR("Node '%s' is '%s', expected '%s'.", path, value, expectedPtr);
+        return false;
+    }
+
+    return true;
+}
+
+
+
+
+COMPONENT_INIT
+{
+    const char* commandPtr = le_arg_GetArg(0);
+    bool isOk = true;
+
+    LE_FATAL_IF(commandPtr == NULL, "No command given.");
+
+    if (strcmp(commandPtr, "write") == 0)
+    {
+        WriteData(GetIntArg(1), GetIntArg(2));
+    }
+    else if (strcmp(commandPtr, "check") == 0)
+    {
+        isOk = CheckData(GetIntArg(1), GetIntArg(2));
+    }
+    else if (   (strcmp(commandPtr, "set") == 0)
+             && (le_arg_NumArgs() == 3))
+    {
+        char path[LE_CFG_STR_LEN_BYTES];
+
+        snprintf(path, sizeof(path), TEST_TREE "/extra/%s", le_arg_GetArg(1));
+        le_cfg_QuickSetString(path, le_arg_GetArg(2));
+    }
+    else if (   (strcmp(commandPtr, "expect") == 0)
+             && (le_arg_NumArgs() == 3))
+    {
+        isOk = CheckExtra(le_arg_GetArg(1), le_arg_GetArg(2));
+    }
+    else if (strcmp(commandPtr, "empty") == 0)
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TEST_TREE "/");
+
+        isOk = (le_cfg_GoToFirstChild(iterRef) == LE_NOT_FOUND);
+        LE_ERROR_IF(!isOk, "The tree isn't empty.");
+
+        le_cfg_CancelTxn(iterRef);
+    }
+    else
+    {
+        LE_FATAL("Bad command '%s'.", commandPtr);
+    }
+
+    exit(isOk ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -103,10 +103,15 @@ static void DumpTree(le_cfg_IteratorRef_t iterRef, size_t indent)
 static void ClearTree()
 {
     LE_INFO("---- Clearing Out Current Tree -----------------------------------------------------");
-    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(TestRootDir);
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TestRootDir);
+    DumpTree(iterRef, 0);
+    le_cfg_CancelTxn(iterRef);
+
+    // DumpTree() leaves the iterator on the last sibling of the test root, so delete the test root
+    // through an iterator of its own.
+    iterRef = le_cfg_CreateWriteTxn(TestRootDir);
     LE_FATAL_IF(iterRef == NULL, "Test: %s - Could not create iterator.", TestRootDir);
 
-    DumpTree(iterRef, 0);
     le_cfg_DeleteNode(iterRef, "");
 
     le_cfg_CommitTxn(iterRef);
@@ -263,6 +268,285 @@ static void DeleteTest()
 
 
 
+static void LargeCollectionTest()
+{
+    static char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    char nameBuffer[TEST_NAME_SIZE] = "";
+    int i;
+
+    // Enough children for the collection to be indexed by the config tree.
+    const int numChildren = 200;
+
+    LE_INFO("---- Large Collection Test ---------------------------------------------------------");
+
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/largeCollection/", TestRootDir);
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(pathBuffer);
+
+    for (i = 0; i < numChildren; i++)
+    {
+        snprintf(nameBuffer, TEST_NAME_SIZE, "child%d/value", i);
+        le_cfg_SetInt(iterRef, nameBuffer, i);
+    }
+
+    le_cfg_CommitTxn(iterRef);
+
+
+
+    // Delete every third child and change every fifth one, (bringing back the deleted ones that
+    // are also multiples of five.)
+    iterRef = le_cfg_CreateWriteTxn(pathBuffer);
+
+    for (i = 0; i < numChildren; i += 3)
+    {
+        snprintf(nameBuffer, TEST_NAME_SIZE, "child%d", i);
+        le_cfg_DeleteNode(iterRef, nameBuffer);
+    }
+
+    for (i = 0; i < numChildren; i += 5)
+    {
+        snprintf(nameBuffer, TEST_NAME_SIZE, "child%d/value", i);
+        le_cfg_SetInt(iterRef, nameBuffer, -i);
+    }
+
+    le_cfg_CommitTxn(iterRef);
+
+
+
+    iterRef = le_cfg_CreateReadTxn(pathBuffer);
+
+    for (i = 0; i < numChildren; i++)
+    {
+        int expected = i;
+
+        if ((i % 5) == 0)
+        {
+            expected = -i;
+        }
+        else if ((i % 3) == 0)
+        {
+            expected = 1;
+        }
+
+        snprintf(nameBuffer, TEST_NAME_SIZE, "child%d/value", i);
+
+        int value = le_cfg_GetInt(iterRef, nameBuffer, 1);
+        LE_FATAL_IF(value != expected,
+                    "Test: %s - Expected %d for '%s' but got %d instead.",
+                    TestRootDir,
+                    expected,
+                    nameBuffer,
+                    value);
+    }
+
+    le_cfg_CancelTxn(iterRef);
+}
+
+
+
+
+static size_t AddBatchRecord
+(
+    uint8_t* bufferPtr,
+    size_t offset,
+    le_cfg_nodeType_t type,
+    const char* pathPtr,
+    const char* valuePtr
+)
+{
+    bufferPtr[offset++] = (uint8_t)type;
+
+    strcpy((char*)bufferPtr + offset, pathPtr);
+    offset += strlen(pathPtr) + 1;
+
+    strcpy((char*)bufferPtr + offset, valuePtr);
+    offset += strlen(valuePtr) + 1;
+
+    return offset;
+}
+
+
+
+
+static void BatchTest()
+{
+    static char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    static uint8_t buffer[LE_CFGBATCH_BATCH_BYTES];
+    size_t size = 0;
+
+    LE_INFO("---- Batch Test --------------------------------------------------------------------");
+
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/batchTest/", TestRootDir);
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(pathBuffer);
+
+    size = AddBatchRecord(buffer, size, LE_CFG_TYPE_STRING, "stem/string", "aString");
+    size = AddBatchRecord(buffer, size, LE_CFG_TYPE_INT, "stem/int", "-42");
+    size = AddBatchRecord(buffer, size, LE_CFG_TYPE_BOOL, "bool", "true");
+    size = AddBatchRecord(buffer, size, LE_CFG_TYPE_EMPTY, "empty", "");
+    size = AddBatchRecord(buffer, size, LE_CFG_TYPE_STRING, "deleted", "aString");
+    size = AddBatchRecord(buffer, size, LE_CFG_TYPE_DOESNT_EXIST, "deleted", "");
+
+    LE_ASSERT(le_cfgBatch_SetBatch(iterRef, buffer, size) == LE_OK);
+
+    // A value that doesn't match its type is rejected.
+    size = AddBatchRecord(buffer, 0, LE_CFG_TYPE_INT, "badInt", "12x");
+    LE_ASSERT(le_cfgBatch_SetBatch(iterRef, buffer, size) == LE_FORMAT_ERROR);
+
+    // So are values, node names and paths that are too long for the tree.  None of the records
+    // in a rejected batch are applied.
+    static char longString[LE_CFG_STR_LEN_BYTES + 100];
+    memset(longString, 'x', sizeof(longString) - 1);
+    longString[sizeof(longString) - 1] = '\0';
+
+    size = AddBatchRecord(buffer, 0, LE_CFG_TYPE_STRING, "notApplied", "aString");
+    size = AddBatchRecord(buffer, size, LE_CFG_TYPE_STRING, "longValue", longString);
+    LE_ASSERT(le_cfgBatch_SetBatch(iterRef, buffer, size) == LE_FORMAT_ERROR);
+
+    size_t i;
+    for (i = 1; i < sizeof(longString) - 1; i += 2)
+    {
+        longString[i] = '/';
+    }
+
+    size = AddBatchRecord(buffer, 0, LE_CFG_TYPE_STRING, longString, "aString");
+    LE_ASSERT(le_cfgBatch_SetBatch(iterRef, buffer, size) == LE_FORMAT_ERROR);
+
+    memset(longString, 'x', LE_CFG_NAME_LEN_BYTES);
+    longString[LE_CFG_NAME_LEN_BYTES] = '\0';
+
+    size = AddBatchRecord(buffer, 0, LE_CFG_TYPE_STRING, longString, "aString");
+    LE_ASSERT(le_cfgBatch_SetBatch(iterRef, buffer, size) == LE_FORMAT_ERROR);
+
+    le_cfg_CommitTxn(iterRef);
+
+
+
+    iterRef = le_cfg_CreateReadTxn(pathBuffer);
+
+    TestValue(iterRef, "stem/string", "aString");
+    LE_ASSERT(le_cfg_GetInt(iterRef, "stem/int", 0) == -42);
+    LE_ASSERT(le_cfg_GetBool(iterRef, "bool", false) == true);
+    LE_ASSERT(le_cfg_NodeExists(iterRef, "deleted") == false);
+    LE_ASSERT(le_cfg_NodeExists(iterRef, "badInt") == false);
+    LE_ASSERT(le_cfg_NodeExists(iterRef, "notApplied") == false);
+
+    // Read the whole thing back in one go.
+    static const struct
+    {
+        le_cfg_nodeType_t type;
+        const char* pathPtr;
+        const char* valuePtr;
+    }
+    expected[] =
+        {
+            { LE_CFG_TYPE_STEM, "stem", "" },
+            { LE_CFG_TYPE_STRING, "stem/string", "aString" },
+            { LE_CFG_TYPE_INT, "stem/int", "-42" },
+            { LE_CFG_TYPE_BOOL, "bool", "true" },
+            { LE_CFG_TYPE_EMPTY, "empty", "" }
+        };
+    const size_t numExpected = sizeof(expected) / sizeof(expected[0]);
+    const char* recordPtr = (const char*)buffer;
+
+    i = 0;
+    size = sizeof(buffer);
+    LE_ASSERT(le_cfgBatch_GetSubtree(iterRef, "", buffer, &size) == LE_OK);
+
+    while (recordPtr < (const char*)buffer + size)
+    {
+        const char* nodePathPtr = recordPtr + 1;
+        const char* valuePtr = nodePathPtr + strlen(nodePathPtr) + 1;
+
+        LE_FATAL_IF(i >= numExpected,
+                    "Test: %s - Unexpected record '%s'.",
+                    TestRootDir,
+                    nodePathPtr);
+        LE_FATAL_IF(   ((le_cfg_nodeType_t)recordPtr[0] != expected[i].type)
+                    || (strcmp(nodePathPtr, expected[i].pathPtr) != 0)
+                    || (strcmp(valuePtr, expected[i].valuePtr) != 0),
+                    "Test: %s - Expected %s = '%s' but got %s = '%s' instead.",
+                    TestRootDir,
+                    expected[i].pathPtr,
+                    expected[i].valuePtr,
+                    nodePathPtr,
+                    valuePtr);
+
+        i++;
+        recordPtr = valuePtr + strlen(valuePtr) + 1;
+    }
+
+    LE_FATAL_IF(i != numExpected, "Test: %s - Only got %zu records.", TestRootDir, i);
+
+    // Only whole records are returned when the buffer is too small.
+    size = 8;
+    LE_ASSERT(le_cfgBatch_GetSubtree(iterRef, "", buffer, &size) == LE_OVERFLOW);
+    LE_ASSERT(size == 7);
+
+    le_cfg_CancelTxn(iterRef);
+}
+
+
+
+
+static void ReadSnapshotTest()
+{
+    static char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    LE_INFO("---- Read Snapshot Test ------------------------------------------------------------");
+
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/readSnapshotTest/", TestRootDir);
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(pathBuffer);
+
+    le_cfg_SetString(iterRef, "stem/value", "oldValue");
+    le_cfg_SetString(iterRef, "deleted", "oldValue");
+
+    le_cfg_CommitTxn(iterRef);
+
+
+
+    // Commits and quick writes go through while the read is open, but the read keeps seeing the
+    // values from before them.
+    le_cfg_IteratorRef_t readIterRef = le_cfg_CreateReadTxn(pathBuffer);
+
+    le_cfg_GoToNode(readIterRef, "stem");
+
+    iterRef = le_cfg_CreateWriteTxn(pathBuffer);
+
+    le_cfg_SetString(iterRef, "stem/value", "newValue");
+    le_cfg_SetString(iterRef, "added", "newValue");
+    le_cfg_DeleteNode(iterRef, "deleted");
+
+    le_cfg_CommitTxn(iterRef);
+
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/readSnapshotTest/quick", TestRootDir);
+    le_cfg_QuickSetString(pathBuffer, "newValue");
+
+    TestValue(readIterRef, "value", "oldValue");
+    TestValue(readIterRef, "../deleted", "oldValue");
+    LE_ASSERT(le_cfg_NodeExists(readIterRef, "../added") == false);
+    LE_ASSERT(le_cfg_NodeExists(readIterRef, "../quick") == false);
+
+    LE_ASSERT(le_cfg_GoToFirstChild(readIterRef) == LE_OK);
+    TestValue(readIterRef, "", "oldValue");
+
+    // New reads see the changes.
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/readSnapshotTest/", TestRootDir);
+    iterRef = le_cfg_CreateReadTxn(pathBuffer);
+
+    TestValue(iterRef, "stem/value", "newValue");
+    TestValue(iterRef, "added", "newValue");
+    TestValue(iterRef, "quick", "newValue");
+    LE_ASSERT(le_cfg_NodeExists(iterRef, "deleted") == false);
+
+    le_cfg_CancelTxn(readIterRef);
+    le_cfg_CancelTxn(iterRef);
+}
+
+
+
+
 static void StringSizeTest()
 {
     le_result_t result;
@@ -503,6 +787,143 @@ static void TestImportExport()
 
     CompareFile(filePath, testData);
     unlink(filePath);
+
+
+    // A file with a value that's too long for the tree is rejected.
+    static char longData[LE_CFG_STR_LEN_BYTES + 100];
+    int longLen = snprintf(longData, sizeof(longData), "{ \"tooLong\" \"");
+    memset(longData + longLen, 'x', sizeof(longData) - longLen - 6);
+    strcpy(longData + sizeof(longData) - 6, "\" } ");
+
+    sprintf(nameTemplate, "./%s_testImportData.cfg", TestRootDir);
+    realpath(nameTemplate, filePath);
+    WriteConfigData(filePath, longData);
+
+    iterRef = le_cfg_CreateWriteTxn("");
+    LE_TEST(le_cfgAdmin_ImportTree(iterRef, filePath, pathBuffer) == LE_FORMAT_ERROR);
+    le_cfg_CancelTxn(iterRef);
+
+    unlink(filePath);
+}
+
+
+
+
+static int OpenTestFile
+(
+    const char* filePathPtr,
+    int flags
+)
+{
+    int fd = -1;
+
+    do
+    {
+        fd = open(filePathPtr, flags, S_IRUSR | S_IWUSR);
+    }
+    while (   (fd == -1)
+           && (errno == EINTR));
+
+    LE_FATAL_IF(fd == -1, "Could not open '%s'!!  Reason: %s", filePathPtr, strerror(errno));
+
+    return fd;
+}
+
+
+
+
+static void TestImportExportFd()
+{
+    LE_INFO("---- Import Export Fd Function Test ------------------------------------------------");
+
+    static const char testData[] =
+        {
+            "{ "
+                "\"aBoolValue\" !t "
+                "\"aStringValue\" \"Something \\\"wicked\\\" this way comes!\" "
+                "\"nestedValues\" "
+                "{ "
+                    "\"anIntVal\" [1024] "
+                    "\"aFloatVal\" (10.24) "
+                "} "
+            "} "
+        };
+
+    static char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "/%s/importExportFd", TestRootDir);
+
+    static char jsonPathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    snprintf(jsonPathBuffer, LE_CFG_STR_LEN_BYTES, "/%s/importExportJson", TestRootDir);
+
+    char nameTemplate[100] = "";
+    char filePath[PATH_MAX] = "";
+    char jsonFilePath[PATH_MAX] = "";
+
+    sprintf(nameTemplate, "./%s_testImportFdData.cfg", TestRootDir);
+    realpath(nameTemplate, filePath);
+
+    sprintf(nameTemplate, "./%s_testExportFdData.json", TestRootDir);
+    realpath(nameTemplate, jsonFilePath);
+
+    WriteConfigData(filePath, testData);
+
+
+    // Native import, then JSON export of the same data.
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn("");
+
+    LE_INFO("IMPORT TREE FD: %s", pathBuffer);
+    LE_TEST(le_cfgAdmin_ImportTreeFd(iterRef,
+                                     OpenTestFile(filePath, O_RDONLY),
+                                     pathBuffer,
+                                     LE_CFGADMIN_FORMAT_NATIVE) == LE_OK);
+    unlink(filePath);
+
+    LE_INFO("EXPORT TREE FD: %s To: %s", pathBuffer, jsonFilePath);
+    LE_TEST(le_cfgAdmin_ExportTreeFd(iterRef,
+                                     OpenTestFile(jsonFilePath, O_WRONLY | O_CREAT | O_TRUNC),
+                                     pathBuffer,
+                                     LE_CFGADMIN_FORMAT_JSON) == LE_OK);
+
+    le_cfg_CommitTxn(iterRef);
+
+
+    // Bring the JSON back in under a different node, and make sure that everything made it.
+    iterRef = le_cfg_CreateWriteTxn(jsonPathBuffer);
+
+    LE_INFO("IMPORT TREE FD: %s From: %s", jsonPathBuffer, jsonFilePath);
+    LE_TEST(le_cfgAdmin_ImportTreeFd(iterRef,
+                                     OpenTestFile(jsonFilePath, O_RDONLY),
+                                     "",
+                                     LE_CFGADMIN_FORMAT_JSON) == LE_OK);
+    unlink(jsonFilePath);
+
+    le_cfg_CommitTxn(iterRef);
+
+    char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    iterRef = le_cfg_CreateReadTxn(jsonPathBuffer);
+
+    LE_TEST(le_cfg_GetBool(iterRef, "aBoolValue", false) == true);
+    LE_TEST(le_cfg_GetString(iterRef, "aStringValue", stringBuffer, sizeof(stringBuffer), "")
+            == LE_OK);
+    LE_TEST(strcmp(stringBuffer, "Something \"wicked\" this way comes!") == 0);
+    LE_TEST(le_cfg_GetInt(iterRef, "nestedValues/anIntVal", 0) == 1024);
+    LE_TEST(le_cfg_GetNodeType(iterRef, "nestedValues/aFloatVal") == LE_CFG_TYPE_FLOAT);
+
+    double floatValue = le_cfg_GetFloat(iterRef, "nestedValues/aFloatVal", 0.0);
+    LE_TEST((floatValue > 10.23) && (floatValue < 10.25));
+
+
+    // A native export through a descriptor writes the same text as ExportTree.
+    LE_INFO("EXPORT TREE FD: %s To: %s", pathBuffer, filePath);
+    LE_TEST(le_cfgAdmin_ExportTreeFd(iterRef,
+                                     OpenTestFile(filePath, O_WRONLY | O_CREAT | O_TRUNC),
+                                     pathBuffer,
+                                     LE_CFGADMIN_FORMAT_NATIVE) == LE_OK);
+
+    le_cfg_CancelTxn(iterRef);
+
+    CompareFile(filePath, testData);
+    unlink(filePath);
 }
 
 
@@ -845,8 +1266,12 @@ COMPONENT_INIT
 
     QuickFunctionTest();
     DeleteTest();
+    LargeCollectionTest();
+    BatchTest();
+    ReadSnapshotTest();
     StringSizeTest();
     TestImportExport();
+    TestImportExportFd();
     MultiTreeTest();
     ExistAndEmptyTest();
     ListTreeTest();
@@ -11,6 +11,19 @@ static bool TestCPassed = false;
 static le_event_Id_t EventIdA;
 static le_event_Id_t EventIdB;
 static le_event_Id_t EventIdC;
+static le_event_Id_t EventIdD;
+
+// Batch of payloads reported to Event D, and the number of them received so far.
+static int BatchD[] = { 1, 2, 3, 4, 5 };
+static size_t BatchDCount = 0;
+
+// Event E's payloads are shared by its two handlers.  Whichever handler receives a payload first
+// records it, so the other one can check it received the same copy.
+static le_event_Id_t EventIdE;
+static int BatchE[] = { 10, 20, 30 };
+static void* SharedPayloadE[NUM_ARRAY_MEMBERS(BatchE)];
+static size_t E1Count = 0;
+static size_t E2Count = 0;
 
 static char EventContextA[] = "Context A";
 
@@ -62,6 +75,64 @@ static void EventHandlerB
 }
 
 
+static void EventHandlerD
+(
+    void* reportPtr // Non-ref-counted (copied report from a batch).
+)
+{
+    int* valuePtr = reportPtr;
+
+    LE_INFO("Batch report %zu = %d.", BatchDCount, *valuePtr);
+
+    // Reports from a batch must arrive in array order.
+    LE_ASSERT(BatchDCount < NUM_ARRAY_MEMBERS(BatchD));
+    LE_ASSERT(*valuePtr == BatchD[BatchDCount]);
+
+    BatchDCount++;
+}
+
+
+static void CheckSharedPayloadE
+(
+    void* reportPtr,
+    size_t index
+)
+{
+    LE_ASSERT(index < NUM_ARRAY_MEMBERS(BatchE));
+    LE_ASSERT(*(int*)reportPtr == BatchE[index]);
+    LE_ASSERT(reportPtr != &BatchE[index]);
+
+    if (SharedPayloadE[index] == NULL)
+    {
+        SharedPayloadE[index] = reportPtr;
+    }
+    else
+    {
+        LE_ASSERT(reportPtr == SharedPayloadE[index]);
+    }
+}
+
+
+static void EventHandlerE1
+(
+    void* reportPtr // Shared with Handler E2.
+)
+{
+    CheckSharedPayloadE(reportPtr, E1Count);
+    E1Count++;
+}
+
+
+static void EventHandlerE2
+(
+    void* reportPtr // Shared with Handler E1.
+)
+{
+    CheckSharedPayloadE(reportPtr, E2Count);
+    E2Count++;
+}
+
+
 static void Destructor
 (
     void* objPtr
@@ -94,6 +165,9 @@ static void CheckTestResults
     LE_ASSERT(TestAPassed);
     LE_ASSERT(TestBPassed);
     LE_ASSERT(TestCPassed);
+    LE_ASSERT(BatchDCount == NUM_ARRAY_MEMBERS(BatchD));
+    LE_ASSERT(E1Count == NUM_ARRAY_MEMBERS(BatchE));
+    LE_ASSERT(E2Count == NUM_ARRAY_MEMBERS(BatchE));
 
     LE_INFO("======== EVENT LOOP TEST COMPLETE (PASSED) ========");
     exit(EXIT_SUCCESS);
@@ -111,10 +185,15 @@ COMPONENT_INIT
     EventIdA = le_event_CreateId("Event A", sizeof(ReportA));
     EventIdB = le_event_CreateIdWithRefCounting("Event B");
     EventIdC = le_event_CreateIdWithRefCounting("Event C");
+    EventIdD = le_event_CreateId("Event D", sizeof(BatchD[0]));
+    EventIdE = le_event_CreateIdWithSharedPayload("Event E", sizeof(BatchE[0]));
 
     le_event_SetContextPtr(le_event_AddHandler("Handler A", EventIdA, EventHandlerA), &EventContextA);
     le_event_AddHandler("Handler B", EventIdB, EventHandlerB);
     // Intentionally no handler for ref-counting Event C.
+    le_event_AddHandler("Handler D", EventIdD, EventHandlerD);
+    le_event_AddHandler("Handler E1", EventIdE, EventHandlerE1);
+    le_event_AddHandler("Handler E2", EventIdE, EventHandlerE2);
 
     le_event_Report(EventIdA, &ReportA, sizeof(ReportA));
 
@@ -130,5 +209,10 @@ COMPONENT_INIT
     memcpy(reportPtr, &ReportC, sizeof(*reportPtr));
     le_event_ReportWithRefCounting(EventIdC, reportPtr);
 
+    le_event_ReportBatch(EventIdD, BatchD, sizeof(BatchD[0]), NUM_ARRAY_MEMBERS(BatchD));
+
+    le_event_Report(EventIdE, &BatchE[0], sizeof(BatchE[0]));
+    le_event_ReportBatch(EventIdE, &BatchE[1], sizeof(BatchE[0]), NUM_ARRAY_MEMBERS(BatchE) - 1);
+
     le_event_QueueFunction(CheckTestResults, &ReportA, &ReportB);
 }
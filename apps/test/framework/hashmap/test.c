@@ -20,6 +20,8 @@ size_t le_hashmap_HashCustom(const void* keyPtr);
 bool le_hashmap_EqualsCustom(const void* firstPtr, const void* secondPtr);
 bool itHandler(const void* keyPtr, const void* valuePtr, void* contextPtr);
 void TestIterRemove(le_hashmap_Ref_t map);
+void TestGrowth(le_hashmap_Ref_t map);
+void TestIterGrowth(le_hashmap_Ref_t map);
 
 typedef struct Key Key_t;
 struct Key {
@@ -51,7 +53,14 @@ COMPONENT_INIT
     LE_INFO("Creating pointer map");
     le_hashmap_Ref_t map5 = le_hashmap_Create("Map5", 100, &le_hashmap_HashVoidPointer, &le_hashmap_EqualsVoidPointer);
 
-    LE_TEST(map1 && map2 && map3 && map4 && map5);
+    LE_INFO("Creating open addressed int/int map");
+    le_hashmap_Ref_t map6 = le_hashmap_CreateOpenAddressed("Map6", 200, &le_hashmap_HashUInt32, &le_hashmap_EqualsUInt32);
+
+    LE_INFO("Creating small maps for growth tests");
+    le_hashmap_Ref_t map7 = le_hashmap_Create("Map7", 4, &le_hashmap_HashUInt32, &le_hashmap_EqualsUInt32);
+    le_hashmap_Ref_t map8 = le_hashmap_CreateOpenAddressed("Map8", 4, &le_hashmap_HashUInt32, &le_hashmap_EqualsUInt32);
+
+    LE_TEST(map1 && map2 && map3 && map4 && map5 && map6 && map7 && map8);
 
     TestHashFns();
     TestIntHashMap(map1);
@@ -61,6 +70,12 @@ COMPONENT_INIT
     TestPointerMap(map5);
     TestNewIter();
     TestIterRemove(map1);
+    TestIntHashMap(map6);
+    TestIterRemove(map6);
+    TestGrowth(map7);
+    TestGrowth(map8);
+    TestIterGrowth(map7);
+    TestIterGrowth(map8);
 
     LE_INFO("==== Hashmap Tests PASSED ====\n");
 
@@ -120,7 +135,8 @@ void TestIntHashMap(le_hashmap_Ref_t map)
     }
     LE_INFO("Iterator count = %d", itercnt);
     LE_TEST(itercnt == 500);
-    // Now back again.
+    // Now back again.  Every entry is visited once on the way back too (this used to come out
+    // at -1, because the entries of the last bucket were visited twice).
     while (le_hashmap_PrevNode(mapIt) == LE_OK)
     {
         itercnt--;
@@ -128,7 +144,7 @@ void TestIntHashMap(le_hashmap_Ref_t map)
         le_hashmap_GetValue(mapIt);
     }
     LE_INFO("Iterator count = %d", itercnt);
-    LE_TEST(itercnt == -1);
+    LE_TEST(itercnt == 0);
 
     // Cleanup the map again to allow it to be reused
     le_hashmap_RemoveAll(map);
@@ -428,3 +444,128 @@ void TestIterRemove(le_hashmap_Ref_t map)
     LE_TEST(itercnt == 1000);
     LE_TEST(le_hashmap_Size(map) == 500);
 }
+
+void TestGrowth(le_hashmap_Ref_t map)
+{
+    static uint32_t iKeys[5000];
+    static uint32_t iVals[5000];
+    int j = 0;
+    bool allFound = true;
+
+    LE_INFO("*** Running hashmap growth tests ***");
+
+    le_hashmap_RemoveAll(map);
+
+    // Every key must be retrievable while the map is growing.
+    for (j=0; j<5000; j++) {
+        iKeys[j] = j;
+        iVals[j] = j * 3;
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+
+        if ((le_hashmap_Get(map, &iKeys[j / 2]) != &iVals[j / 2]) ||
+            (le_hashmap_Get(map, &iKeys[j]) != &iVals[j])) {
+            allFound = false;
+        }
+    }
+    LE_TEST(allFound);
+    LE_TEST(le_hashmap_Size(map) == 5000);
+
+    // A map with many more keys than its initial capacity should still have few collisions.
+    LE_INFO("Collision count = %zu", le_hashmap_CountCollisions(map));
+    LE_TEST(le_hashmap_CountCollisions(map) < 5000 / 2);
+
+    // Keys can be removed and re-added while moving entries.
+    for (j=0; j<5000; j+=3) {
+        le_hashmap_Remove(map, &iKeys[j]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 3333);
+
+    allFound = true;
+    for (j=0; j<5000; j++) {
+        bool found = le_hashmap_ContainsKey(map, &iKeys[j]);
+        if (found != (j % 3 != 0)) {
+            allFound = false;
+        }
+    }
+    LE_TEST(allFound);
+
+    int itercnt = 0;
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        itercnt++;
+    }
+    LE_TEST(itercnt == 3333);
+
+    le_hashmap_RemoveAll(map);
+    LE_TEST(le_hashmap_isEmpty(map));
+    LE_TEST(le_hashmap_Get(map, &iKeys[1]) == NULL);
+}
+
+void TestIterGrowth(le_hashmap_Ref_t map)
+{
+    static uint32_t iKeys[200];
+    static uint32_t iVals[200];
+    static bool seen[200];
+    int j = 0;
+    int itercnt = 0;
+    bool noRepeats = true;
+
+    LE_INFO("*** Running hashmap iterate while growing tests ***");
+
+    le_hashmap_RemoveAll(map);
+    for (j=0; j<100; j++) {
+        iKeys[j] = j;
+        iVals[j] = j;
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+    }
+    for (j=100; j<200; j++) {
+        iKeys[j] = j;
+        iVals[j] = j;
+    }
+    memset(seen, 0, sizeof(seen));
+
+    // Add a key for every key visited; the map grows part way through the iteration.  Each of
+    // the original keys must be visited exactly once.
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        const uint32_t* keyPtr = le_hashmap_GetKey(mapIt);
+
+        if (seen[*keyPtr]) {
+            noRepeats = false;
+        }
+        seen[*keyPtr] = true;
+
+        if ((*keyPtr < 100) && (le_hashmap_Size(map) < 200))
+        {
+            le_hashmap_Put(map, &iKeys[le_hashmap_Size(map)], &iVals[le_hashmap_Size(map)]);
+        }
+        itercnt++;
+    }
+    LE_TEST(noRepeats);
+    LE_TEST(le_hashmap_Size(map) == 200);
+
+    bool allSeen = true;
+    for (j=0; j<100; j++) {
+        if (!seen[j]) {
+            allSeen = false;
+        }
+    }
+    LE_TEST(allSeen);
+    LE_INFO("Iterator count = %d", itercnt);
+
+    // Once the iteration is over, the map finishes growing.
+    for (j=0; j<200; j++) {
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 200);
+
+    itercnt = 0;
+    mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        itercnt++;
+    }
+    LE_TEST(itercnt == 200);
+}
@@ -6,6 +6,9 @@
  * - The client can do an asynchronous request-response transaction, with 0xDEADBEEF in the request.
  *   The server responds to this with 0xBEEFDEAD.
  * - The server can send an unsolicited 0xDEADDEAD message.
+ * - The client can do a request-response transaction with 0xFEEDBEEF in the request and some
+ *   bulk data (see BURGER_BULK_BYTE()).  The server responds with 0xBEEFFEED and the same number
+ *   of bytes of bulk data, with every byte inverted.
  *
  * My apologies to vegetarians and cattle rights advocates.  No actual bovines were harmed in
  * the making of this protocol.
@@ -18,6 +21,12 @@
 
 #define BURGER_PROTOCOL_ID_STR "DeadBeefProtocol"
 
+// Size of the bulk channel rings given to each session by the server.
+#define BURGER_BULK_CHANNEL_SIZE 8192
+
+// Value of byte i in a 0xFEEDBEEF request's bulk data of size n.
+#define BURGER_BULK_BYTE(i, n) ((uint8_t)(((i) * 31) + (n)))
+
 typedef struct
 {
     uint32_t payload;
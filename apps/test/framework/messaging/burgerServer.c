@@ -88,6 +88,39 @@ static void MsgRecvHandler
             }
             break;
 
+        case 0xFEEDBEEF:
+        {
+            LE_TEST(le_msg_NeedsResponse(msgRef) == true);
+
+            // Check the bulk data.
+            size_t numBytes;
+            size_t i;
+            const uint8_t* bytePtr = le_msg_GetBulkData(msgRef, &numBytes);
+            LE_TEST(bytePtr != NULL);
+            LE_TEST(numBytes > 0);
+            for (i = 0; (bytePtr != NULL) && (i < numBytes); i++)
+            {
+                if (bytePtr[i] != BURGER_BULK_BYTE(i, numBytes))
+                {
+                    LE_TEST(false);
+                    break;
+                }
+            }
+            LE_INFO("Received %zu bytes of bulk data.", numBytes);
+
+            // Respond with the bytes inverted.  The request's bulk data is released by this.
+            uint8_t* respBytePtr = le_msg_AllocBulkData(msgRef, numBytes);
+            LE_TEST(respBytePtr != NULL);
+            for (i = 0; (respBytePtr != NULL) && (i < numBytes); i++)
+            {
+                respBytePtr[i] = ~BURGER_BULK_BYTE(i, numBytes);
+            }
+
+            msgPtr->payload = 0xBEEFFEED;
+            le_msg_Respond(msgRef);
+            break;
+        }
+
         default:
             LE_FATAL("Unexpected message payload (%x)", msgPtr->payload);
     }
@@ -149,6 +182,7 @@ le_msg_ServiceRef_t burgerServer_Start
     protocolRef = le_msg_GetProtocolRef(BURGER_PROTOCOL_ID_STR, sizeof(burger_Message_t));
     serviceRef = le_msg_CreateService(protocolRef, serviceInstanceName);
     le_msg_SetServiceRecvHandler(serviceRef, MsgRecvHandler, contextPtr);
+    le_msg_SetServiceBulkChannelSize(serviceRef, BURGER_BULK_CHANNEL_SIZE);
     LE_INFO("&ServiceOpenContextPtr = %p.", &ServiceOpenContextPtr);
     le_msg_AddServiceOpenHandler(serviceRef, NewSessionHandler, &ServiceOpenContextPtr);
     le_msg_AdvertiseService(serviceRef);
@@ -0,0 +1,248 @@
+/**
+ * This program measures how quickly messages can be passed between a client and a server in the
+ * same thread, first as a burst of one-way messages and then as a burst of request-response
+ * transactions.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ *
+ */
+
+#include "legato.h"
+
+
+#define SERVICE_INSTANCE_NAME "messagingBench"
+
+#define PROTOCOL_ID_STR "MessagingBenchProtocol"
+
+// Number of messages sent in each burst.
+#define NUM_MSGS 20000
+
+// Payload value that marks a message as the last one-way message of the burst.
+#define LAST_ONE_WAY_MSG 0xFFFFFFFF
+
+typedef struct
+{
+    uint32_t seq;
+}
+Bench_Message_t;
+
+// Number of one-way messages received by the server.
+static size_t NumOneWayReceived = 0;
+
+// Set to false if the server receives a one-way message out of order.
+static bool InOrder = true;
+
+// Number of responses received by the client.
+static size_t NumResponses = 0;
+
+// Set to false if the client receives a response that doesn't match its request.
+static bool ResponsesMatch = true;
+
+// When the current burst was started.
+static le_clk_Time_t StartTime;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the time elapsed since a given time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double MsecSince
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return (diffTime.sec * 1000.0) + (diffTime.usec / 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Logs the time taken by a burst of messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogRate
+(
+    const char* burstName
+)
+{
+    double msec = MsecSince(StartTime);
+
+    LE_INFO("%d %s in %.1f ms (%.0f per second)",
+            NUM_MSGS,
+            burstName,
+            msec,
+            (msec > 0) ? (NUM_MSGS * 1000.0 / msec) : 0.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server's message receive handler.  Responds to requests straight away and counts one-way
+ * messages.  When the last one-way message arrives, sends it back to the client so the client
+ * knows the burst has been received.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,
+    void*               contextPtr
+)
+{
+    Bench_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    if (le_msg_NeedsResponse(msgRef))
+    {
+        le_msg_Respond(msgRef);
+    }
+    else if (msgPtr->seq == LAST_ONE_WAY_MSG)
+    {
+        le_msg_Send(msgRef);
+    }
+    else
+    {
+        if (msgPtr->seq != NumOneWayReceived)
+        {
+            InOrder = false;
+        }
+        NumOneWayReceived++;
+
+        le_msg_ReleaseMsg(msgRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client's response callback for the request-response burst.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResponseHandler
+(
+    le_msg_MessageRef_t msgRef,
+    void*               contextPtr
+)
+{
+    Bench_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    if (msgPtr->seq != (uint32_t)(uintptr_t)contextPtr)
+    {
+        ResponsesMatch = false;
+    }
+    NumResponses++;
+
+    le_msg_ReleaseMsg(msgRef);
+
+    if (NumResponses == NUM_MSGS)
+    {
+        LogRate("request-response transactions");
+
+        LE_TEST(ResponsesMatch);
+
+        LE_TEST_SUMMARY;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends the burst of request-response transactions.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartRequestBurst
+(
+    le_msg_SessionRef_t sessionRef
+)
+{
+    uint32_t i;
+
+    StartTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < NUM_MSGS; i++)
+    {
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+        Bench_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+        msgPtr->seq = i;
+        le_msg_RequestResponse(msgRef, ResponseHandler, (void*)(uintptr_t)i);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client's message receive handler.  The server sends back the last one-way message once it has
+ * received the whole burst.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClientRecvHandler
+(
+    le_msg_MessageRef_t msgRef,
+    void*               contextPtr
+)
+{
+    le_msg_SessionRef_t sessionRef = le_msg_GetSession(msgRef);
+    Bench_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    LE_TEST(msgPtr->seq == LAST_ONE_WAY_MSG);
+    le_msg_ReleaseMsg(msgRef);
+
+    LogRate("one-way messages");
+
+    LE_TEST(NumOneWayReceived == NUM_MSGS);
+    LE_TEST(InOrder);
+
+    StartRequestBurst(sessionRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends the burst of one-way messages, as soon as the session is open.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SessionOpenHandler
+(
+    le_msg_SessionRef_t sessionRef,
+    void*               contextPtr
+)
+{
+    uint32_t i;
+
+    StartTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i <= NUM_MSGS; i++)
+    {
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+        Bench_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+        msgPtr->seq = (i < NUM_MSGS) ? i : LAST_ONE_WAY_MSG;
+        le_msg_Send(msgRef);
+    }
+}
+
+
+COMPONENT_INIT
+{
+    le_msg_ProtocolRef_t protocolRef;
+    le_msg_ServiceRef_t serviceRef;
+    le_msg_SessionRef_t sessionRef;
+
+    LE_TEST_INIT;
+
+    LE_INFO("====  Benchmark for low-level messaging with %d messages per burst. ====", NUM_MSGS);
+
+    system("testFwMessaging-Setup");
+
+    protocolRef = le_msg_GetProtocolRef(PROTOCOL_ID_STR, sizeof(Bench_Message_t));
+
+    serviceRef = le_msg_CreateService(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, NULL);
+    le_msg_AdvertiseService(serviceRef);
+
+    sessionRef = le_msg_CreateSession(protocolRef, SERVICE_INSTANCE_NAME);
+    le_msg_SetSessionRecvHandler(sessionRef, ClientRecvHandler, NULL);
+    le_msg_OpenSession(sessionRef, SessionOpenHandler, NULL);
+}
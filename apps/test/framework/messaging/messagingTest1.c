@@ -6,6 +6,7 @@
  *  - Create a thread that serves up a named service and then acts as its own client.
  *  - Tests creating and advertising services and opening services.
  *  - Also tests for conflicts with server and client being in the same process.
+ *  - Also tests sending bulk data through the session's bulk channel.
  *
  * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
  */
@@ -21,12 +22,19 @@
 
 #define MAX_REQUEST_RESPONSE_TXNS 32
 
+// Number of bulk data request-response transactions, and the size of the first one's bulk data.
+// Two of them fit in the bulk channel at once, but three don't.
+#define BULK_TXNS 8
+#define BULK_SIZE 3000
+
 
 // ==================================
 //  CLIENT
 // ==================================
 
 static int ClientResponseCount = 0; // Count of the number of responses received from the server.
+static int BulkRequestCount = 0;    // Count of the number of bulk data requests sent.
+static int BulkResponseCount = 0;   // Count of the number of bulk data responses received.
 
 static const char ClientIndContextStr[] = "This is the client receiving an indication message.";
 static const char ClientRespContextStr[] = "This is the client receiving a response message.";
@@ -34,6 +42,7 @@ static const char ClientOpenContextStr[] = "This is the client opening a session
 
 
 static void SendSomeStuffToServer(le_msg_SessionRef_t  sessionRef);
+static le_result_t SendBulkRequest(le_msg_SessionRef_t  sessionRef);
 
 
 // This function will be called whenever the server sends us an indication message (as opposed to
@@ -57,6 +66,7 @@ static void ClientIndicationRecvHandler
 
     // This is now the end of the test.  Check that we received all the responses that we expected.
     LE_TEST(ClientResponseCount == MAX_REQUEST_RESPONSE_TXNS);
+    LE_TEST(BulkResponseCount == BULK_TXNS);
 
     LE_TEST_SUMMARY
 }
@@ -104,6 +114,86 @@ static void ClientResponseRecvHandler
 }
 
 
+// This function will be called whenever the server sends us a response to a bulk data request.
+static void BulkResponseRecvHandler
+(
+    le_msg_MessageRef_t  msgRef,    // Reference to response message (NULL if transaction failed).
+    void*                contextPtr // contextPtr passed into le_msg_RequestResponse().
+)
+{
+    LE_TEST(msgRef != NULL);
+    if (msgRef == NULL)
+    {
+        return;
+    }
+
+    burger_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    LE_TEST(msgPtr->payload == 0xBEEFFEED);
+
+    // The response's bulk data should be the request's bulk data, inverted.
+    size_t expectedSize = (size_t)(uintptr_t)contextPtr;
+    size_t numBytes;
+    size_t i;
+    const uint8_t* bytePtr = le_msg_GetBulkData(msgRef, &numBytes);
+    LE_TEST(bytePtr != NULL);
+    LE_TEST(numBytes == expectedSize);
+    for (i = 0; (bytePtr != NULL) && (i < numBytes); i++)
+    {
+        if (bytePtr[i] != (uint8_t)~BURGER_BULK_BYTE(i, numBytes))
+        {
+            LE_TEST(false);
+            break;
+        }
+    }
+
+    BulkResponseCount++;
+    LE_INFO("Bulk data response %d received from server (%zu bytes).", BulkResponseCount, numBytes);
+
+    le_msg_SessionRef_t sessionRef = le_msg_GetSession(msgRef);
+
+    // Releasing the response frees its space in the bulk channel.
+    le_msg_ReleaseMsg(msgRef);
+
+    if (BulkRequestCount < BULK_TXNS)
+    {
+        LE_TEST(SendBulkRequest(sessionRef) == LE_OK);
+    }
+}
+
+
+// Send a bulk data request to the server.  Each one is a bit bigger than the last, so that they
+// wrap around the bulk channel at different places.
+static le_result_t SendBulkRequest
+(
+    le_msg_SessionRef_t  sessionRef  // Reference to the session.
+)
+{
+    size_t numBytes = BULK_SIZE + (BulkRequestCount * 111);
+    size_t i;
+
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+    uint8_t* bytePtr = le_msg_AllocBulkData(msgRef, numBytes);
+    if (bytePtr == NULL)
+    {
+        le_msg_ReleaseMsg(msgRef);
+        return LE_NO_MEMORY;
+    }
+
+    for (i = 0; i < numBytes; i++)
+    {
+        bytePtr[i] = BURGER_BULK_BYTE(i, numBytes);
+    }
+
+    burger_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    msgPtr->payload = 0xFEEDBEEF;
+    le_msg_RequestResponse(msgRef, BulkResponseRecvHandler, (void*)(uintptr_t)numBytes);
+
+    BulkRequestCount++;
+
+    return LE_OK;
+}
+
+
 // Send some stuff to the server.
 static void SendSomeStuffToServer
 (
@@ -125,10 +215,13 @@ static void SendSomeStuffToServer
     msgPtr->payload = 0xDEADBEEF;
     le_msg_RequestResponse(msgRef, ClientResponseRecvHandler, (void*)ClientRespContextStr);
 
-    // Send a non-request message to the server.
-    msgRef = le_msg_CreateMsg(sessionRef);
+    // Send a non-request message to the server, sized to fit exactly what it carries.
+    msgRef = le_msg_CreateMsgWithSize(sessionRef, sizeof(*msgPtr));
+    LE_TEST(le_msg_GetMaxPayloadSize(msgRef) >= sizeof(*msgPtr));
     msgPtr = le_msg_GetPayloadPtr(msgRef);
     msgPtr->payload = 0xBEEFBEEF;
+    le_msg_SetPayloadSize(msgRef, sizeof(*msgPtr));
+    LE_TEST(le_msg_GetPayloadSize(msgRef) == sizeof(*msgPtr));
     le_msg_Send(msgRef);
 }
 
@@ -143,6 +236,12 @@ static void SessionOpenHandlerFunc
     LE_TEST(contextPtr == ClientOpenContextStr);
     LE_TEST(strcmp(contextPtr, ClientOpenContextStr) == 0);
 
+    // The server hasn't had a chance to free anything yet, so only two bulk data requests fit
+    // in the bulk channel.  The rest are sent as responses come back.
+    LE_TEST(SendBulkRequest(sessionRef) == LE_OK);
+    LE_TEST(SendBulkRequest(sessionRef) == LE_OK);
+    LE_TEST(SendBulkRequest(sessionRef) == LE_NO_MEMORY);
+
     SendSomeStuffToServer(sessionRef);
 }
 
@@ -0,0 +1,219 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client for unit test 4 for the Low-Level Messaging APIs.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "messagingTest4Protocol.h"
+
+// 1. Client opens a session three times, sending a request each time.  The first two opens go
+//    through the Service Directory, and the second one makes the server open a direct endpoint.
+//    The third open connects straight to that endpoint.
+// 2. Client deletes its binding.  The Service Directory revokes the endpoint, so the server closes
+//    it, and opening a session fails because the client is no longer bound.
+// 3. Client binds again.  The next open goes through the Service Directory and makes the server
+//    open a new endpoint, which the open after that connects to.
+// 4. If running as root, a child process running as another user connects to the endpoint.
+//    The server must close that connection without sending it a welcome message, and the endpoint
+//    must still work for the real client afterwards.
+// 5. Client sends "DONE" to the server and closes the session.  The server then exits.
+
+
+/// User ID that the other user's connection is made as ("nobody").
+#define OTHER_UID   65534
+
+
+/// Protocol used to talk to the server.
+static le_msg_ProtocolRef_t ProtocolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a session, sends a request through it, then closes it.
+ *
+ * @return true if the session was connected to the server through its direct endpoint.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool OpenRequestClose
+(
+    const char* textPtr,    ///< [in] Text to send to the server.
+    char* nameBuffPtr,      ///< [out] Name of the server's direct endpoint ("" if none).
+    size_t nameBuffSize     ///< [in] Size of the name buffer, in bytes.
+)
+{
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(ProtocolRef, TEST4_INTERFACE_NAME);
+    le_msg_OpenSessionSync(sessionRef);
+
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+    test4_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    LE_ASSERT(le_utf8_Copy(msgPtr->text, textPtr, sizeof(msgPtr->text), NULL) == LE_OK);
+
+    msgRef = le_msg_RequestSyncResponse(msgRef);
+    LE_ASSERT(msgRef != NULL);
+
+    msgPtr = le_msg_GetPayloadPtr(msgRef);
+    LE_TEST(strcmp(msgPtr->text, textPtr) == 0);
+    LE_ASSERT(le_utf8_Copy(nameBuffPtr, msgPtr->endpointName, nameBuffSize, NULL) == LE_OK);
+    bool isDirect = (msgPtr->directCount == 1);
+    le_msg_ReleaseMsg(msgRef);
+
+    le_msg_CloseSession(sessionRef);
+    le_msg_DeleteSession(sessionRef);
+
+    LE_INFO("'%s' was sent %s. Server's direct endpoint is '%s'.",
+            textPtr,
+            isDirect ? "directly" : "through a session opened by the Service Directory",
+            nameBuffPtr);
+
+    return isDirect;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connects a new socket to a direct endpoint.
+ *
+ * @return The socket's file descriptor, or -1 if the connection could not be made.
+ */
+//--------------------------------------------------------------------------------------------------
+static int ConnectToEndpoint
+(
+    const char* namePtr
+)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    // Names in the abstract namespace start with a null byte.
+    LE_ASSERT(le_utf8_Copy(addr.sun_path + 1, namePtr, sizeof(addr.sun_path) - 1, NULL) == LE_OK);
+    socklen_t addrLen = offsetof(struct sockaddr_un, sun_path) + 1 + strlen(namePtr);
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    LE_FATAL_IF(fd < 0, "socket() failed (%m).");
+
+    if (connect(fd, (struct sockaddr*)&addr, addrLen) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connects to a direct endpoint from a child process running as another user.
+ *
+ * @return true if the server closed the connection without sending anything.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsOtherUserRefused
+(
+    const char* namePtr
+)
+{
+    pid_t pid = fork();
+    LE_FATAL_IF(pid < 0, "fork() failed (%m).");
+
+    if (pid == 0)
+    {
+        if ((setgid(OTHER_UID) != 0) || (setuid(OTHER_UID) != 0))
+        {
+            _exit(EXIT_FAILURE);
+        }
+
+        int fd = ConnectToEndpoint(namePtr);
+        if (fd < 0)
+        {
+            _exit(EXIT_FAILURE);
+        }
+
+        char buff[64];
+        ssize_t byteCount;
+        do
+        {
+            byteCount = recv(fd, buff, sizeof(buff), 0);
+        } while ((byteCount == -1) && (errno == EINTR));
+
+        _exit(((byteCount == 0) || ((byteCount == -1) && (errno == ECONNRESET))) ?
+              EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    int status;
+    while ((waitpid(pid, &status, 0) == -1) && (errno == EINTR))
+    {
+    }
+
+    return (WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS));
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    char name[sizeof(((test4_Message_t*)0)->endpointName)];
+    char oldName[sizeof(name)];
+
+    ProtocolRef = le_msg_GetProtocolRef(TEST4_PROTOCOL_ID_STR, sizeof(test4_Message_t));
+
+    LE_INFO("----  Connecting directly.  ----");
+
+    LE_TEST(OpenRequestClose("first", name, sizeof(name)) == false);
+    LE_TEST(name[0] == '\0');
+    LE_TEST(OpenRequestClose("second", name, sizeof(name)) == false);
+    LE_TEST(name[0] != '\0');
+    LE_TEST(OpenRequestClose("third", oldName, sizeof(oldName)) == true);
+    LE_TEST(strcmp(name, oldName) == 0);
+
+    LE_INFO("----  Revoking the endpoint on unbind.  ----");
+
+    LE_TEST(system("config delete users/$USER/bindings/" TEST4_INTERFACE_NAME
+                   " && sdir load") == 0);
+
+    // The revoke goes from the Service Directory to the server, so give the server time to
+    // close the endpoint.
+    int tries = 50;
+    int fd;
+    while (((fd = ConnectToEndpoint(oldName)) >= 0) && (--tries > 0))
+    {
+        close(fd);
+        usleep(100000);
+    }
+    LE_TEST(fd < 0);
+
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(ProtocolRef, TEST4_INTERFACE_NAME);
+    LE_TEST(le_msg_TryOpenSessionSync(sessionRef) == LE_NOT_PERMITTED);
+    le_msg_DeleteSession(sessionRef);
+
+    LE_TEST(system("config set users/$USER/bindings/" TEST4_INTERFACE_NAME "/user $USER"
+                   " && config set users/$USER/bindings/" TEST4_INTERFACE_NAME "/interface "
+                   TEST4_INTERFACE_NAME
+                   " && sdir load") == 0);
+
+    LE_TEST(OpenRequestClose("rebound", name, sizeof(name)) == false);
+    LE_TEST(name[0] != '\0');
+    LE_TEST(strcmp(name, oldName) != 0);
+    LE_TEST(OpenRequestClose("direct again", name, sizeof(name)) == true);
+
+    LE_INFO("----  Refusing other users.  ----");
+
+    if (geteuid() == 0)
+    {
+        LE_TEST(IsOtherUserRefused(name));
+        LE_TEST(OpenRequestClose("still direct", name, sizeof(name)) == true);
+    }
+    else
+    {
+        LE_INFO("Not running as root, so can't connect as another user.  Skipping.");
+    }
+
+    OpenRequestClose("DONE", name, sizeof(name));
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,175 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server for unit test 4 for the Low-Level Messaging APIs.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "messagingTest4Protocol.h"
+
+
+// NOTE: See messagingTest4-client.c for a description of the test.
+
+
+/// Highest number of sockets that this process is expected to have open.
+#define MAX_SOCKETS 64
+
+/// true once the client has told us that it's done.
+static bool IsDone = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the inode numbers of all the sockets that this process has open.
+ *
+ * @return The number of sockets found.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetOwnSockets
+(
+    unsigned long* inodeListPtr,
+    size_t maxCount
+)
+{
+    size_t count = 0;
+
+    DIR* dirPtr = opendir("/proc/self/fd");
+    LE_FATAL_IF(dirPtr == NULL, "Can't open /proc/self/fd (%m).");
+
+    struct dirent* entryPtr;
+    while (((entryPtr = readdir(dirPtr)) != NULL) && (count < maxCount))
+    {
+        char target[64];
+
+        ssize_t len = readlinkat(dirfd(dirPtr), entryPtr->d_name, target, sizeof(target) - 1);
+        if (len > 0)
+        {
+            target[len] = '\0';
+            if (sscanf(target, "socket:[%lu]", &inodeListPtr[count]) == 1)
+            {
+                count++;
+            }
+        }
+    }
+
+    closedir(dirPtr);
+
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds this process's direct endpoint, and counts the sessions connected through it.
+ *
+ * Sockets accepted on a listening socket have the same name as it, so they show up in
+ * /proc/net/unix under the endpoint's name in the connected state.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetDirectSockets
+(
+    test4_Message_t* msgPtr
+)
+{
+    unsigned long inodeList[MAX_SOCKETS];
+    size_t inodeCount = GetOwnSockets(inodeList, NUM_ARRAY_MEMBERS(inodeList));
+
+    msgPtr->endpointName[0] = '\0';
+    msgPtr->directCount = 0;
+
+    FILE* filePtr = fopen("/proc/net/unix", "r");
+    LE_FATAL_IF(filePtr == NULL, "Can't open /proc/net/unix (%m).");
+
+    char line[256];
+    while (fgets(line, sizeof(line), filePtr) != NULL)
+    {
+        unsigned int state;
+        unsigned long inode;
+        char path[128];
+
+        // Abstract names are shown with a leading '@'.  The header line doesn't match.
+        if (   (sscanf(line, "%*s %*s %*s %*s %*s %x %lu %127s", &state, &inode, path) != 3)
+            || (path[0] != '@')
+            || (strncmp(path + 1, TEST4_ENDPOINT_PREFIX, sizeof(TEST4_ENDPOINT_PREFIX) - 1) != 0) )
+        {
+            continue;
+        }
+
+        size_t i;
+        for (i = 0; (i < inodeCount) && (inodeList[i] != inode); i++)
+        {
+        }
+        if (i == inodeCount)
+        {
+            continue;
+        }
+
+        if (state == 1)     // SS_UNCONNECTED, which is what a listening socket is in.
+        {
+            LE_ASSERT(le_utf8_Copy(msgPtr->endpointName,
+                                   path + 1,
+                                   sizeof(msgPtr->endpointName),
+                                   NULL) == LE_OK);
+        }
+        else if (state == 3)    // SS_CONNECTED
+        {
+            msgPtr->directCount++;
+        }
+    }
+
+    fclose(filePtr);
+}
+
+
+static void MessageReceiveHandler
+(
+    le_msg_MessageRef_t msgRef,
+    void* ignored
+)
+{
+    test4_Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+    LE_ASSERT(msgPtr != NULL);
+
+    LE_INFO("Received '%s' from client.", msgPtr->text);
+
+    if (strcmp(msgPtr->text, "DONE") == 0)
+    {
+        IsDone = true;
+    }
+
+    // Echo the text back, along with what the client can't see for itself.
+    GetDirectSockets(msgPtr);
+    le_msg_Respond(msgRef);
+}
+
+
+static void SessionCloseHandler
+(
+    le_msg_SessionRef_t sessionRef,
+    void* ignored
+)
+{
+    if (IsDone)
+    {
+        LE_INFO("Client is done.");
+        LE_TEST_EXIT;
+    }
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    le_msg_ProtocolRef_t protocolRef;
+    le_msg_ServiceRef_t serviceRef;
+
+    // Create and advertise the service.
+    protocolRef = le_msg_GetProtocolRef(TEST4_PROTOCOL_ID_STR, sizeof(test4_Message_t));
+    serviceRef = le_msg_CreateService(protocolRef, TEST4_INTERFACE_NAME);
+    le_msg_SetServiceRecvHandler(serviceRef, MessageReceiveHandler, NULL);
+    le_msg_AddServiceCloseHandler(serviceRef, SessionCloseHandler, NULL);
+    le_msg_AdvertiseService(serviceRef);
+}
@@ -0,0 +1,35 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unit test 4 for the Low-Level Messaging APIs.
+ *
+ *  - Server and Client in different processes.
+ *  - Client opens sessions directly on the server's endpoint (LE_MSG_DIRECT_CONNECT).
+ *  - Endpoint is revoked when the client's binding is deleted.
+ *  - Connections from other users are refused.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_INFO("======= Test 4: Server and Client in different processes, direct connections. ========");
+
+#ifdef LE_MSG_DIRECT_CONNECT
+    system("testFwMessaging-Setup");
+
+    le_test_ChildRef_t client = LE_TEST_FORK("testFwMessaging-Test4-client");
+    le_test_ChildRef_t server = LE_TEST_FORK("testFwMessaging-Test4-server");
+
+    LE_TEST_JOIN(client);
+    LE_TEST_JOIN(server);
+#else
+    LE_INFO("LE_MSG_DIRECT_CONNECT is not defined in le_build_config.h.  Skipping.");
+#endif
+
+    LE_TEST_EXIT;
+}
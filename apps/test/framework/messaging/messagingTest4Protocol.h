@@ -0,0 +1,30 @@
+/**
+ * Protocol used by unit test 4 for the Low-Level Messaging APIs.
+ *
+ * The client sends a request with some text in it.  The server responds with the same text, the
+ * name of the direct endpoint that it has open (if any) and the number of sessions that are
+ * connected to it through a direct endpoint.  The server finds these by looking its own sockets up
+ * in /proc/net/unix, so the test doesn't need to look inside the messaging implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+
+#ifndef MESSAGING_TEST4_PROTOCOL_H_INCLUDE_GUARD
+#define MESSAGING_TEST4_PROTOCOL_H_INCLUDE_GUARD
+
+#define TEST4_PROTOCOL_ID_STR "testFwMessaging4"
+
+#define TEST4_INTERFACE_NAME "messagingTest4"
+
+// Prefix of the names of the direct endpoints opened by servers (see messagingInterface.c).
+#define TEST4_ENDPOINT_PREFIX "le_msg."
+
+typedef struct
+{
+    char text[16];              // Text sent by the client, and echoed back by the server.
+    char endpointName[64];      // Name of the server's direct endpoint, or "" if there is none.
+    uint32_t directCount;       // Number of sessions connected through a direct endpoint.
+}
+test4_Message_t;
+
+#endif // MESSAGING_TEST4_PROTOCOL_H_INCLUDE_GUARD
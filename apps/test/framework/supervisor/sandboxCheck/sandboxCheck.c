@@ -0,0 +1,35 @@
+//--------------------------------------------------------------------------------------------------
+/** @file sandboxCheck.c
+ *
+ * This program logs whether a file is present in its app's sandbox, and then exits.  It must be
+ * provided with the appName and the path of the file in the command-line arguments.
+ *
+ * It is used to check that the Supervisor sets up the sandbox again when an app's links change,
+ * rather than reusing the runtime area left by the previous run of the app.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+#include "legato.h"
+
+
+COMPONENT_INIT
+{
+    // Get the app name.
+    const char* appName = le_arg_GetArg(0);
+    LE_ASSERT(appName != NULL);
+
+    // Get the path of the file to look for.
+    const char* pathPtr = le_arg_GetArg(1);
+    LE_ASSERT(pathPtr != NULL);
+
+    if (access(pathPtr, F_OK) == 0)
+    {
+        LE_INFO("======== '%s' is present in '%s' ========", pathPtr, appName);
+    }
+    else
+    {
+        LE_INFO("======== '%s' is absent from '%s' ========", pathPtr, appName);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,103 @@
+#!/bin/bash
+
+# Checks that the Supervisor only reuses a sandboxed app's runtime area when neither the installed
+# app nor its bundles and requires config have changed since the area was set up.
+
+LoadTestLib
+
+targetAddr=$1
+targetType=${2:-ar7}
+
+OnFail() {
+    echo "Sandbox Reuse Test Failed!"
+}
+
+OnExit() {
+    rm -rf "$v2Dir"
+}
+
+app=SandboxReuseApp
+requiredFileCfg=/apps/$app/requires/files/sandboxReuseTest
+
+if [ "$LEGATO_ROOT" == "" ]
+then
+    if [ "$WORKSPACE" == "" ]
+    then
+        echo "Neither LEGATO_ROOT nor WORKSPACE are defined." >&2
+        exit 1
+    else
+        LEGATO_ROOT="$WORKSPACE"
+    fi
+fi
+
+# Runs the app, which logs whether /etc/passwd is in its sandbox and exits.
+RunApp() {
+    ssh root@$targetAddr "$BIN_PATH/app start $app"
+    CheckRet
+    sleep 2
+}
+
+echo "******** Sandbox Reuse Test Starting ***********"
+
+echo "Make sure Legato is running."
+ssh root@$targetAddr "$BIN_PATH/legato start"
+CheckRet
+
+echo "Install the app."
+appDir="$LEGATO_ROOT/build/$targetType/tests/apps"
+cd "$appDir"
+CheckRet
+InstallApp $app
+
+echo "Build a second version of the app, which has a different md5 hash."
+v2Dir=$(mktemp -d)
+mkapp "$LEGATO_ROOT/apps/test/framework/supervisor/$app.adef" \
+      -t $targetType \
+      -a .v2 \
+      -w "$v2Dir/_build" \
+      -i "$LEGATO_ROOT/apps/test/framework/supervisor" \
+      -c "$LEGATO_ROOT/apps/test/framework/supervisor" \
+      -o "$v2Dir"
+CheckRet
+
+echo "Stop all other apps."
+ssh root@$targetAddr "$BIN_PATH/app stop \"*\""
+sleep 1
+
+ClearLogs
+
+echo "Run the app twice.  The second run reuses the runtime area."
+RunApp
+RunApp
+CheckLogStr "==" 2 "'/etc/passwd' is absent from '$app'"
+CheckLogStr "==" 1 "Reusing the runtime area of app '$app'."
+
+echo "Require /etc/passwd at runtime.  The runtime area is set up again, with the new link."
+ssh root@$targetAddr "$BIN_PATH/config set $requiredFileCfg/src /etc/passwd && \
+                      $BIN_PATH/config set $requiredFileCfg/dest /etc/"
+CheckRet
+RunApp
+CheckLogStr "==" 1 "'/etc/passwd' is present in '$app'"
+CheckLogStr "==" 1 "App '$app' or its config has changed since its runtime area was set up."
+
+echo "Remove the requirement.  The runtime area is set up again, without the link."
+ssh root@$targetAddr "$BIN_PATH/config delete $requiredFileCfg"
+CheckRet
+RunApp
+CheckLogStr "==" 3 "'/etc/passwd' is absent from '$app'"
+CheckLogStr "==" 2 "App '$app' or its config has changed since its runtime area was set up."
+
+echo "Install the second version.  The old runtime area is unmounted and set up again."
+InstallApp "$v2Dir/$app.$targetType.update"
+ssh root@$targetAddr "$BIN_PATH/app stop $app"
+RunApp
+CheckLogStr "==" 4 "'/etc/passwd' is absent from '$app'"
+CheckLogStr "==" 3 "App '$app' or its config has changed since its runtime area was set up."
+CheckLogStr "==" 1 "Reusing the runtime area of app '$app'."
+
+echo "Uninstall the app."
+ssh root@$targetAddr "$BIN_PATH/app remove $app"
+CheckRet
+
+echo "Sandbox Reuse Test Passed!"
+exit 0
@@ -0,0 +1,150 @@
+/**
+ * This program measures how long it takes to start and stop a large number of timers in one
+ * thread, and checks that they still expire in the right order.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ *
+ */
+
+#include "legato.h"
+
+
+// Must be less than 100000, so that the expiry test intervals are less than a second.
+#define NUM_TIMERS 99999
+
+static le_timer_Ref_t Timers[NUM_TIMERS];
+
+// Number of timers that have expired so far.
+static size_t NumExpired = 0;
+
+// Index of the timer that expired last.
+static intptr_t LastExpiredIndex = -1;
+
+// Set to false if a timer expires out of order.
+static bool InOrder = true;
+
+// When the timers were started for the expiry test.
+static le_clk_Time_t StartTime;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the time elapsed since a given time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double MsecSince
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return (diffTime.sec * 1000.0) + (diffTime.usec / 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer expiry handler for the expiry test.  The timers are started so that a timer with a
+ * higher index always expires later.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExpiryHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    intptr_t index = (intptr_t)le_timer_GetContextPtr(timerRef);
+
+    if (index <= LastExpiredIndex)
+    {
+        InOrder = false;
+    }
+    LastExpiredIndex = index;
+    NumExpired++;
+
+    if (NumExpired == NUM_TIMERS)
+    {
+        LE_INFO("%d timers expired in %.1f ms", NUM_TIMERS, MsecSince(StartTime));
+
+        LE_TEST(InOrder);
+        LE_TEST(le_timer_GetExpiryCount(timerRef) == 1);
+
+        LE_TEST_SUMMARY;
+    }
+}
+
+
+COMPONENT_INIT
+{
+    int i;
+    bool allStarted = true;
+    bool allStopped = true;
+    le_clk_Time_t startTime;
+
+    LE_TEST_INIT;
+
+    LE_INFO("====  Benchmark for le_timer with %d timers. ====", NUM_TIMERS);
+
+    for (i = 0; i < NUM_TIMERS; i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "bench%d", i);
+        Timers[i] = le_timer_Create(name);
+
+        // Long intervals, spread out so that the timers don't all end up next to each other.
+        le_timer_SetMsInterval(Timers[i], 1000000 + (uint32_t)((i * 7919) % NUM_TIMERS));
+    }
+
+    // Start all the timers.
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < NUM_TIMERS; i++)
+    {
+        if (le_timer_Start(Timers[i]) != LE_OK)
+        {
+            allStarted = false;
+        }
+    }
+    LE_INFO("Started %d timers in %.1f ms", NUM_TIMERS, MsecSince(startTime));
+    LE_TEST(allStarted);
+
+    // Stop them again, in a different order from the one they were started in.
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < NUM_TIMERS; i++)
+    {
+        if (le_timer_Stop(Timers[(i * 7919) % NUM_TIMERS]) != LE_OK)
+        {
+            allStopped = false;
+        }
+    }
+    LE_INFO("Stopped %d timers in %.1f ms", NUM_TIMERS, MsecSince(startTime));
+    LE_TEST(allStopped);
+
+    // Restart each timer several times.
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < NUM_TIMERS; i++)
+    {
+        le_timer_Restart(Timers[i]);
+        le_timer_Restart(Timers[i]);
+        le_timer_Restart(Timers[NUM_TIMERS - 1 - i]);
+    }
+    LE_INFO("Restarted timers %d times in %.1f ms", 3 * NUM_TIMERS, MsecSince(startTime));
+    for (i = 0; i < NUM_TIMERS; i++)
+    {
+        le_timer_Stop(Timers[i]);
+    }
+
+    // Start them all with short intervals that increase with the index, so that they must expire
+    // in index order.
+    StartTime = le_clk_GetRelativeTime();
+    for (i = 0; i < NUM_TIMERS; i++)
+    {
+        le_clk_Time_t interval = { 0, i * 10 };
+
+        le_timer_SetInterval(Timers[i], interval);
+        le_timer_SetHandler(Timers[i], ExpiryHandler);
+        le_timer_SetContextPtr(Timers[i], (void*)(intptr_t)i);
+        le_timer_Start(Timers[i]);
+    }
+}
@@ -253,6 +253,76 @@ void test1(void)
 }
 
 
+// Number of pipelined requests that are outstanding at once in testPipelined().
+#define NUM_PIPELINED_CALLS 5
+
+static int NumPipelinedResponses = 0;
+
+
+static void PipelinedResponseHandler
+(
+    uint32_t b,
+    size_t outputNumElements,
+    uint32_t* outputPtr,
+    char* response,
+    char* more,
+    void* contextPtr
+)
+{
+    int i;
+    int callIndex = (intptr_t)contextPtr;
+
+    LE_PRINT_VALUE("%d", callIndex);
+    LE_PRINT_VALUE("%i", b);
+    LE_PRINT_ARRAY("%i", outputNumElements, outputPtr);
+    LE_PRINT_VALUE("%s", response);
+
+    // Responses arrive in the order the requests were sent, and the output array is limited to
+    // its maximum size from the API definition.
+    LE_ASSERT( callIndex == NumPipelinedResponses );
+    LE_ASSERT( b == (callIndex % 2 ? COMMON_ONE : COMMON_TWO) );
+    LE_ASSERT( outputNumElements == 10 );
+    for (i=0; i<outputNumElements; i++)
+    {
+        LE_ASSERT( outputPtr[i] == i*b );
+    }
+    LE_ASSERT( strcmp(response, "response string") == 0 );
+    LE_ASSERT( strcmp(more, "more info") == 0 );
+
+    // Continue with the next test once all the responses are in.
+    NumPipelinedResponses++;
+    if ( NumPipelinedResponses == NUM_PIPELINED_CALLS )
+    {
+        banner("Test 2");
+        test2();
+    }
+}
+
+
+void testPipelined(void)
+{
+    intptr_t i;
+    uint32_t data[] = {1, 2, 3, 4};
+
+    // Send all the requests before any of the responses are processed.
+    for (i=0; i<NUM_PIPELINED_CALLS; i++)
+    {
+        allParametersPipelined(i % 2 ? COMMON_ONE : COMMON_TWO,
+                           data,
+                           4,
+                           20,
+                           "async string",
+                           21,
+                           21,
+                           PipelinedResponseHandler,
+                           (void*)i);
+    }
+
+    // Need to allow the event loop to process the responses.
+    // The rest of the test will be continued in the handler.
+}
+
+
 void StartTest(void)
 {
     banner("Test 1");
@@ -268,8 +338,8 @@ void StartTest(void)
     // Re-connect to the service to continue the test
     ConnectService();
 
-    banner("Test 2");
-    test2();
+    banner("Test Pipelined");
+    testPipelined();
 }
 
 
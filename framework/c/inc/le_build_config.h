@@ -3,7 +3,8 @@
  * @page c_le_build_cfg Build Configuration
  *
  * In the file @c le_build_conifg.h are a number of preprocessor macros.  Uncommenting these macros
- * enables a non-standard feature of the framework.
+ * enables a non-standard feature of the framework.  The ones that are defined by default can be
+ * commented out to remove an optional feature.
  *
  * <HR>
  *
@@ -19,6 +20,20 @@
  * switches to use malloc/free per-block.  This way, tools like valgrind can be used on a Legato
  * executable.
  *
+ * @section bld_cfg_msg_direct LE_MSG_DIRECT_CONNECT
+ *
+ * @c LE_MSG_DIRECT_CONNECT is defined by default.  A client that opens sessions on the same
+ * interface more than once asks the server for a direct connection endpoint, and opens later
+ * sessions on that interface straight to the server, without going through the Service Directory.
+ * See @ref serviceDirectoryProtocol_Direct.
+ *
+ * The endpoints are remembered by each client process, so only processes that keep re-opening
+ * their sessions gain anything.  Short-lived tools that open each interface once still go through
+ * the Service Directory every time they run.
+ *
+ * When it is commented out, clients, servers and the Service Directory are all built without
+ * direct connection support, so no endpoints are ever opened.
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
@@ -48,4 +63,9 @@
 
 
 
+// Comment out this define to make clients open all of their sessions through the Service Directory.
+#define LE_MSG_DIRECT_CONNECT
+
+
+
 #endif
@@ -218,6 +218,16 @@
  * This  results in the report getting queued to the Event Queues of all threads with
  * handlers registered for that event ID.
  *
+ * A publisher that has several reports ready at once can pass them all to
+ * @c le_event_ReportBatch() as an array.  Each subscribing thread is then woken up only once for
+ * the whole batch, instead of once per report.
+ *
+ * @code
+ * MyEventReport_t reports[10];
+ * ...     // Fill in the event reports.
+ * le_event_ReportBatch(EventId, reports, sizeof(reports[0]), NUM_ARRAY_MEMBERS(reports));
+ * @endcode
+ *
  * To register a handler, the subscriber calls @c le_event_AddHandler().
  *
  * @note    It's okay to have a payload size of zero, in which case NULL can be passed into
@@ -437,6 +447,24 @@
  *
  * @endcode
  *
+ * @section c_event_sharedPayloads Event Reports Shared by Multiple Handlers
+ *
+ * Normally, each handler of an event gets its own copy of the report payload, so reporting a large
+ * payload to many handlers costs one copy per handler.  If the handlers only need to read the
+ * payload, the Event ID can be created using @c le_event_CreateIdWithSharedPayload() instead of
+ * le_event_CreateId().  The payload passed to le_event_Report() (or le_event_ReportBatch()) is then
+ * copied only once, and all the handlers (in any thread) are passed a pointer to that one copy.
+ * The Event Loop API keeps it reference counted and releases it after the last handler returns.
+ *
+ * @warning Handlers of these events must not modify the payload, because other handlers may be
+ *          reading it at the same time.  Nor may they keep the pointer after they return.
+ *
+ * @code
+ * EventId = le_event_CreateIdWithSharedPayload("PositionUpdate", sizeof(Position_t));
+ * ...
+ * le_event_Report(EventId, &position, sizeof(position));
+ * @endcode
+ *
  * @section c_event_miscThreadingTopics Miscellaneous Multithreading Topics
  *
  * All functions in this API are thread safe.
@@ -650,6 +678,24 @@ le_event_Id_t le_event_CreateIdWithRefCounting
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new event ID to report events where a single copy of each report's payload is shared
+ * (read-only) by all the handlers.  See @ref c_event_sharedPayloads.
+ *
+ * @return
+ *      Event ID.
+ *
+ * @note Doesn't return on failure, there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_event_Id_t le_event_CreateIdWithSharedPayload
+(
+    const char* name,       ///< [in] Name of the event ID.  (Named for diagnostic purposes.)
+    size_t      payloadSize ///< [in] Data payload size (in bytes) of the event reports (can be 0).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Adds a handler function for a publish-subscribe event ID.
@@ -728,6 +774,28 @@ void le_event_Report
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a Batch of Events
+ *
+ * Queues an Event Report for each payload in an array to any and all event loops that have
+ * handlers for that event.  The reports are delivered to each handler in array order, and each
+ * event loop is woken up at most once for the whole batch.
+ *
+ * @note Copies the event report payloads, so it is safe to release or reuse the array that
+ *       payloadArrayPtr points to as soon as le_event_ReportBatch() returns.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_ReportBatch
+(
+    le_event_Id_t   eventId,        ///< [in] Event ID created using le_event_CreateId().
+    void*           payloadArrayPtr,///< [in] Pointer to an array of payloads, each payloadSize
+                                    ///       bytes long, to be copied into the reports.
+    size_t          payloadSize,    ///< [in] Number of bytes of payload to copy into each report.
+    size_t          numReports      ///< [in] Number of payloads in the array.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends an Event Report with a pointer to a reference-counted object as its payload.
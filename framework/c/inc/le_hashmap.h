@@ -15,10 +15,18 @@
  * type of key that you intend to store. It's unwise to mix types in a single table because
  * implementation of the table has no way to detect this behaviour.
  *
- * Choose the initial size should carefully as the index size remains fixed. The best
- * choice for the initial size is a prime number slightly larger than the
- * maximum expected capacity. If a too small size is chosen, there will be an
- * increase in collisions that degrade performance over time.
+ * The capacity passed to @c le_hashmap_Create() is the number of keys the map is expected to
+ * hold.  The map grows automatically when more keys than that are added.  Growing is done
+ * incrementally: the index is doubled, and the existing entries are moved into the new index
+ * a few at a time by subsequent calls to @c le_hashmap_Put() and @c le_hashmap_Remove(), so that
+ * no single call has to rehash the whole map.  Choosing a capacity close to the maximum expected
+ * number of keys still avoids the cost of growing.
+ *
+ * Use @c le_hashmap_CreateOpenAddressed() instead to create a map that stores its entries
+ * directly in its index (using linear probing) rather than in separately allocated chain
+ * entries.  This avoids a memory pool allocation per key and keeps lookups within a few
+ * adjacent cache lines, which is usually faster for small keys and values. Both kinds of map
+ * are used through the same functions.
  *
  * All hashmaps have names for diagnostic purposes.
  *
@@ -119,6 +127,12 @@
  * le_hashmap_GetKey, and le_hashmap_GetValue will return NULL until either,
  * le_hashmap_NextNode, or le_hashmap_PrevNode are called.
  *
+ * Adding items during an iteration may make the map grow.  While the iterator is part way
+ * through the map, entries are not moved into the new index, so each entry is still visited
+ * once.  Only if the map grows much further before the iteration ends (more than four keys per
+ * bucket on average, or 7/8 of the slots of an open addressed map) are the entries moved anyway,
+ * in which case some entries may be skipped or visited twice.
+ *
  * For example (assuming a table of string/string):
  *
  * @code
@@ -241,7 +255,7 @@ typedef bool (*le_hashmap_ForEachHandler_t)
  * Create a HashMap.
  *
  * If you create a hashmap with a smaller capacity than you actually use, then
- * the map will continue to work, but performance will degrade the more you put in the map.
+ * the map will grow as needed.
  *
  * @return  Returns a reference to the map.
  *
@@ -256,6 +270,26 @@ le_hashmap_Ref_t le_hashmap_Create
     le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an open addressed HashMap.  Entries are stored in the map's index itself instead of in
+ * chains of entries allocated from a memory pool.
+ *
+ * The map grows as needed, in the same way as maps created by le_hashmap_Create().
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateOpenAddressed
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Expected number of keys
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] Hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add a key-value pair to a HashMap. If the key already exists in the map, the previous value
@@ -429,6 +463,9 @@ le_result_t le_hashmap_NextNode
  * Moves the iterator to the previous key/value pair in the map. Order is dependent
  * on the hash algorithm and the order of inserts, and is not sorted at all.
  *
+ * After le_hashmap_NextNode() has gone past the end of the map, this moves the iterator to the
+ * last key/value pair, so walking back from there visits every pair once.
+ *
  * @return  Returns LE_OK unless you go past the beginning of the map, then returns LE_NOT_FOUND.
  *
  */
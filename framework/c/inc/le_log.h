@@ -281,6 +281,30 @@ $ export LE_LOG_LEVEL=DEBUG
  * @verbatim
 $ export LE_LOG_TRACE=framework/fdMonitor:framework/logControl
 @endverbatim
+ *
+ * @subsubsection c_log_control_env_binary LE_LOG_BINARY
+ *
+ * @c LE_LOG_BINARY turns on binary logging, which makes debug, info and trace messages much
+ * cheaper to log.  Messages are still filtered by level and keyword as usual, but the ones that
+ * pass the filter are not formatted.  Instead, the format string's address and the raw arguments
+ * are written to a ring buffer in shared memory (one per thread).  Warnings and more severe
+ * messages are always formatted and logged straight away.  The value of the variable is the
+ * size of each thread's ring buffer, in bytes.
+ *
+ * For example,
+ * @verbatim
+$ export LE_LOG_BINARY=65536
+@endverbatim
+ *
+ * The messages waiting in the ring buffers are formatted and printed by the @c log tool's
+ * @c dump command.  If a ring buffer fills up before it is dumped, new messages are dropped
+ * (and counted).  The messages left in a thread's ring buffer when the thread exits are
+ * formatted and logged normally.
+ *
+ * Only these printf conversions can be used in messages logged in binary mode: @c d, @c i, @c o,
+ * @c u, @c x, @c X, @c e, @c E, @c f, @c F, @c g, @c G, @c a, @c A, @c c, @c s, @c p, @c m
+ * and @c %%, with any flags, widths, precisions and length modifiers (except wide characters and
+ * strings).  Strings are truncated to 128 bytes, and the format string must be a string literal.
  *
  * @subsection c_log_control_functions Programmatic Log Control
  *
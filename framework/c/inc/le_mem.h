@@ -295,6 +295,28 @@
  * the data structure, then the mutex must be held by the thread that calls le_mem_Release() to
  * ensure there's no other thread accessing the data structure when the destructor runs.
  *
+ * @section mem_thread_caches Thread Caches
+ *
+ * All memory pools in a process are protected by a single mutex.  If a pool is used heavily by
+ * several threads at the same time, those threads can end up spending a lot of time waiting for
+ * each other on that mutex.  Calling @c le_mem_EnableThreadCache() on such a pool gives every
+ * thread that uses the pool its own small cache of free objects.  Allocations and releases are then
+ * served from the calling thread's cache without taking the mutex; the mutex is only needed when a
+ * thread's cache runs empty or overflows, at which point half of the cache is refilled from, or
+ * flushed back to, the pool in one go.  When a thread dies, its cache is given back to the pool.
+ *
+ * @code
+ *     MsgPool = le_mem_CreatePool("Messages", sizeof(Msg_t));
+ *     le_mem_ExpandPool(MsgPool, MAX_MSGS);
+ *     le_mem_EnableThreadCache(MsgPool, 16);
+ * @endcode
+ *
+ * Objects sitting in a thread's cache are still counted as free in the pool's statistics, but they
+ * can only be allocated by the thread that owns the cache.  So, with thread caches, a pool may
+ * have to be expanded by @c le_mem_ForceAlloc() (or @c le_mem_TryAlloc() may return NULL) even
+ * though some of its objects are free.  Pools with thread caches should therefore be sized
+ * with some slack (up to the cache size per thread).
+ *
  * @section mem_pool_sizes Managing Pool Sizes
  *
  * We know it's possible to have pools automatically expand
@@ -665,6 +687,27 @@ void le_mem_SetNumObjsToForce
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives each thread that uses a pool its own cache of free objects, so that most allocations and
+ * releases from that pool don't have to take the memory pool mutex.
+ *
+ * See @ref mem_thread_caches for more information.
+ *
+ * @return
+ *      Nothing.
+ *
+ * @note
+ *      Can't be used on sub-pools.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_EnableThreadCache
+(
+    le_mem_PoolRef_t    pool,       ///< [IN] The pool.
+    size_t              numObjects  ///< [IN] Maximum number of free objects cached per thread.
+);
+
+
 #ifndef LE_MEM_TRACE
     //----------------------------------------------------------------------------------------------
     /**
@@ -679,6 +679,29 @@
  * From this, they obtain a protocol reference that they provide to sessions when they create
  * them.
  *
+ * @subsection c_messagingVariableSize Variable-Size Messages
+ *
+ * Most messages in a protocol are much smaller than the largest one.  A sender that knows the
+ * largest payload a particular message can carry can create it using le_msg_CreateMsgWithSize()
+ * instead of le_msg_CreateMsg().  The message is then allocated from the smallest of the
+ * protocol's message pools (size classes) that can hold that payload, instead of from the pool
+ * of maximum-sized messages.
+ *
+ * Whichever way a message is created, once its payload has been filled in, the sender can call
+ * le_msg_SetPayloadSize() to say how many bytes of the payload buffer are actually in use.  Only
+ * those bytes are sent.  The receiver always receives into a maximum-sized message, with the rest
+ * of its payload buffer zeroed.
+ *
+ * @code
+ *     msgRef = le_msg_CreateMsgWithSize(sessionRef, sizeof(MyRequest_t));
+ *     requestPtr = le_msg_GetPayloadPtr(msgRef);
+ *     requestPtr->... = ...; // <-- Populate message payload...
+ *     le_msg_SetPayloadSize(msgRef, sizeof(*requestPtr));
+ * @endcode
+ *
+ * The C code generated by ifgen for .api files does this for every function call and handler
+ * message.
+ *
  * @section c_messagingSecurity Security
  *
  * Security is provided in the form of authentication and access control.
@@ -766,6 +789,47 @@
  * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.  That can be exploited to break out of chroot()
  * jails.
  *
+ * @section c_messagingBulkData Sending Bulk Data
+ *
+ * Large amounts of data (audio samples, file contents, etc.) don't have to be chopped up into
+ * many maximum-sized messages.  A server can give each session opened with its service a
+ * <b>bulk channel</b> by calling le_msg_SetServiceBulkChannelSize() before advertising the
+ * service.  The bulk channel is shared memory that is set up when the session opens, and is
+ * mapped by both the client and the server.
+ *
+ * Either side can then attach one chunk of bulk data to each message it sends, by calling
+ * le_msg_AllocBulkData() and writing the data directly into the memory it returns.  The
+ * receiver gets a pointer to the same memory using le_msg_GetBulkData(), so the data is never
+ * copied by the Messaging API.
+ *
+ * @code
+ *     msgRef = le_msg_CreateMsg(sessionRef);
+ *     samplesPtr = le_msg_AllocBulkData(msgRef, numBytes);
+ *     if (samplesPtr != NULL)
+ *     {
+ *         memcpy(samplesPtr, ..., numBytes); // <-- Or generate the data in place.
+ *     }
+ *     else
+ *     {
+ *         // No bulk channel, or it's full right now.  Send the data some other way.
+ *     }
+ * @endcode
+ *
+ * le_msg_AllocBulkData() returns NULL if the session doesn't have a bulk channel (because the
+ * service didn't ask for one) or if the channel doesn't have enough room because too much bulk
+ * data is still held by the receiver.  The space is freed when the receiver releases (or responds
+ * to) the message it came with, so the receiver should copy out anything it needs to keep.
+ *
+ * Every message on a session with a bulk channel carries a bulk data descriptor, so both sides
+ * must be built with a version of the framework that supports bulk channels.  If the server
+ * can't create the bulk channel, it refuses the session, and if the client can't map it, the
+ * client is killed, the same as for a protocol mismatch.
+ *
+ * Bulk channels are only available through this API for now.  The code generated by ifgen
+ * still copies array and string parameters into the message, however large they are, so a
+ * service that wants to pass large data through a bulk channel has to handle those messages
+ * with hand-written code.
+ *
  * @section c_messagingFutureEnhancements Future Enhancements
  *
  * As an optimization to reduce the number of copies in cases where the sender of a message
@@ -1267,6 +1331,28 @@ le_msg_MessageRef_t le_msg_CreateMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message to be sent over a given session, with a payload buffer that only needs to
+ * be big enough to hold a given number of bytes.  See @ref c_messagingVariableSize.
+ *
+ * If the size is larger than the protocol's maximum message size, the maximum is used instead.
+ *
+ * @return  Message reference.
+ *
+ * @note
+ * - Function never returns on failure, there's no need to check the return code.
+ * - le_msg_GetMaxPayloadSize() returns the size of the payload buffer actually allocated, which
+ *   may be larger than requested.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t le_msg_CreateMsgWithSize
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t payloadSize              ///< [in] Size of the largest payload the message will carry.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Adds to the reference count on a message object.
@@ -1336,6 +1422,35 @@ size_t le_msg_GetMaxPayloadSize
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the number of bytes at the start of the message payload buffer that are to be sent.
+ * See @ref c_messagingVariableSize.
+ *
+ * By default, the whole payload buffer is sent.  This is also the case for responses to received
+ * messages, unless this function is called on the request message before responding.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              payloadSize ///< [in] Number of payload bytes to send.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of bytes at the start of the message payload buffer that are to be sent.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_msg_GetPayloadSize
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the file descriptor to be sent with this message.
@@ -1367,6 +1482,41 @@ int le_msg_GetFd
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates space for bulk data to be sent with this message in the session's bulk channel.
+ * See @ref c_messagingBulkData.
+ *
+ * Any bulk data that the message already holds (including bulk data received with a request
+ * that is being responded to) is released first.
+ *
+ * @return Pointer to where the bulk data should be written, or NULL if the session doesn't have
+ *         a bulk channel or there isn't enough room in it right now.
+ **/
+//--------------------------------------------------------------------------------------------------
+void* le_msg_AllocBulkData
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              numBytes    ///< [in] Number of bytes of bulk data.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetches the bulk data held by a message.  For a received message, this is the bulk data that
+ * the sender attached to it.  See @ref c_messagingBulkData.
+ *
+ * @return Pointer to the bulk data, or NULL if the message doesn't have any.  The pointer is only
+ *         valid until the message is released (or responded to).
+ **/
+//--------------------------------------------------------------------------------------------------
+void* le_msg_GetBulkData
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t*             numBytesPtr ///< [out] Number of bytes of bulk data (0 if none).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a message.  No response expected.
@@ -1555,6 +1705,24 @@ void le_msg_SetServiceRecvHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives each session that clients open with this service a bulk channel: shared memory through
+ * which large amounts of data can be passed with messages.  See @ref c_messagingBulkData.
+ *
+ * Only affects sessions opened after this is called.
+ *
+ * @note    Server-only function.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetServiceBulkChannelSize
+(
+    le_msg_ServiceRef_t     serviceRef, ///< [in] Reference to the service.
+    size_t                  numBytes    ///< [in] Bytes of bulk data that can be in transit in
+                                        ///       each direction at once (0 = no bulk channel).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
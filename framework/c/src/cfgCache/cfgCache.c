@@ -0,0 +1,464 @@
+//--------------------------------------------------------------------------------------------------
+/** @file cfgCache.c
+ *
+ * Keeps client-side copies of config subtrees.  Each cache holds the records returned by
+ * le_cfgBatch_GetSubtree() along with a hash map from each node's relative path to its record, so a
+ * read is a single hash lookup.  A config change handler on the subtree's base node marks the copy
+ * as stale, so that the next read reloads it.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+
+#include "legato.h"
+#include "cfgCache.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate of the number of nodes in a cached subtree.  Used to size the record maps.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_RECORD_MAP_SIZE                       31
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A cached subtree.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct cfgCache_Cache
+{
+    char basePath[LE_CFG_STR_LEN_BYTES];        ///< Path to the base node of the subtree.
+    le_hashmap_Ref_t recordMap;                 ///< Relative node path to the node's record in
+                                                ///<   buffer.
+    bool isValid;                               ///< Does buffer hold the current contents of the
+                                                ///<   subtree?
+    uint8_t buffer[LE_CFGBATCH_BATCH_BYTES];    ///< Records read by le_cfgBatch_GetSubtree().
+}
+Cache_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for the caches.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CachePool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called by the config tree when something changes in a cached subtree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConfigChangeHandler
+(
+    void* contextPtr            ///< [IN] The cache that is now stale.
+)
+{
+    Cache_t* cachePtr = contextPtr;
+
+    LE_DEBUG("Config cache for '%s' is stale.", cachePtr->basePath);
+
+    cachePtr->isValid = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure that a cache holds the current contents of its subtree, reloading it if needed.
+ *
+ * @return
+ *      True if the cache can be used, false if the subtree is too large to be cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool Load
+(
+    Cache_t* cachePtr           ///< [IN] The cache to load.
+)
+{
+    if (cachePtr->isValid)
+    {
+        return true;
+    }
+
+    le_hashmap_RemoveAll(cachePtr->recordMap);
+
+    size_t size = sizeof(cachePtr->buffer);
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(cachePtr->basePath);
+    le_result_t result = le_cfgBatch_GetSubtree(iterRef, "", cachePtr->buffer, &size);
+
+    le_cfg_CancelTxn(iterRef);
+
+    if (result != LE_OK)
+    {
+        LE_DEBUG("Config subtree '%s' is too large to be cached.", cachePtr->basePath);
+        return false;
+    }
+
+    // Each record is a type byte followed by the node's path and value strings.  The paths in the
+    // buffer are used as the keys.
+    const char* recordPtr = (const char*)cachePtr->buffer;
+    const char* endPtr = recordPtr + size;
+
+    while (recordPtr < endPtr)
+    {
+        const char* pathPtr = recordPtr + 1;
+        const char* valuePtr = pathPtr + strlen(pathPtr) + 1;
+
+        le_hashmap_Put(cachePtr->recordMap, pathPtr, recordPtr);
+
+        recordPtr = valuePtr + strlen(valuePtr) + 1;
+    }
+
+    cachePtr->isValid = true;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Puts a node path into the form used for the keys of a cache's record map, the form that
+ * le_cfgBatch_GetSubtree() gives them in: "." names, repeated separators and a trailing separator
+ * are dropped, so "./sub//name/" becomes "sub/name".
+ *
+ * @return
+ *      True if the path can be looked up in the cache.  False if it has to be read from the config
+ *      tree directly: the path is empty (the base node isn't in its own subtree), absolute, goes up
+ *      with "..", names a tree, or is too long.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool NormalizePath
+(
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    char* bufPtr,               ///< [OUT] Buffer to store the normalized path.
+    size_t bufSize              ///< [IN] Size of the buffer.
+)
+{
+    size_t len = 0;
+
+    if ((pathPtr[0] == '/') || (strchr(pathPtr, ':') != NULL))
+    {
+        return false;
+    }
+
+    while (*pathPtr != '\0')
+    {
+        size_t nameLen = strcspn(pathPtr, "/");
+
+        if ((nameLen == 2) && (strncmp(pathPtr, "..", 2) == 0))
+        {
+            return false;
+        }
+
+        if ((nameLen > 0) && !((nameLen == 1) && (pathPtr[0] == '.')))
+        {
+            size_t sepLen = (len > 0) ? 1 : 0;
+
+            if (len + sepLen + nameLen >= bufSize)
+            {
+                return false;
+            }
+
+            if (sepLen > 0)
+            {
+                bufPtr[len] = '/';
+            }
+
+            memcpy(bufPtr + len + sepLen, pathPtr, nameLen);
+            len += sepLen + nameLen;
+        }
+
+        pathPtr += nameLen;
+        pathPtr += strspn(pathPtr, "/");
+    }
+
+    bufPtr[len] = '\0';
+
+    return (len > 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up a node in a loaded cache.
+ *
+ * @return
+ *      Pointer to the node's value string, or NULL if the node doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* FindValue
+(
+    Cache_t* cachePtr,              ///< [IN] The cache to read.
+    const char* pathPtr,            ///< [IN] Path of the node, relative to the cache's base node.
+    le_cfg_nodeType_t* typePtr      ///< [OUT] The type of the node.
+)
+{
+    const char* recordPtr = le_hashmap_Get(cachePtr->recordMap, pathPtr);
+
+    if (recordPtr == NULL)
+    {
+        return NULL;
+    }
+
+    *typePtr = (le_cfg_nodeType_t)recordPtr[0];
+
+    return recordPtr + 1 + strlen(recordPtr + 1) + 1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a cache of the subtree below a node in the config tree.  Caches last for the life of
+ * the process.
+ *
+ * @return
+ *      Reference to the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+cfgCache_Ref_t cfgCache_Create
+(
+    const char* pathPtr         ///< [IN] Path to the base node of the subtree.  May include a
+                                ///<      tree name.
+)
+{
+    Cache_t* cachePtr = le_mem_ForceAlloc(CachePool);
+
+    le_result_t result = le_utf8_Copy(cachePtr->basePath, pathPtr, sizeof(cachePtr->basePath), NULL);
+
+    LE_FATAL_IF(result != LE_OK, "Config cache path '%s' is too long.", pathPtr);
+
+    cachePtr->recordMap = le_hashmap_Create("CfgCacheRecords",
+                                            CACHE_RECORD_MAP_SIZE,
+                                            le_hashmap_HashString,
+                                            le_hashmap_EqualsString);
+    cachePtr->isValid = false;
+
+    le_cfg_AddChangeHandler(pathPtr, ConfigChangeHandler, cachePtr);
+
+    return cachePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks to see if a node exists in the cached subtree.
+ *
+ * @return
+ *      True if the node exists, false if not.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgCache_NodeExists
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr         ///< [IN] Path of the node, relative to the cache's base node.
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+
+    if (!NormalizePath(pathPtr, path, sizeof(path)) || !Load(cacheRef))
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(cacheRef->basePath);
+        bool exists = le_cfg_NodeExists(iterRef, pathPtr);
+
+        le_cfg_CancelTxn(iterRef);
+
+        return exists;
+    }
+
+    return le_hashmap_Get(cacheRef->recordMap, path) != NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a string value from the cached subtree.  If the node isn't a string, or if it's empty or
+ * doesn't exist, the default value is returned.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer was not big enough for the value.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgCache_GetString
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    char* bufPtr,               ///< [OUT] Buffer to store the value.
+    size_t bufSize,             ///< [IN] Size of the buffer.
+    const char* defaultPtr      ///< [IN] Value to use if the node can't be read.
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+
+    if (!NormalizePath(pathPtr, path, sizeof(path)) || !Load(cacheRef))
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(cacheRef->basePath);
+        le_result_t result = le_cfg_GetString(iterRef, pathPtr, bufPtr, bufSize, defaultPtr);
+
+        le_cfg_CancelTxn(iterRef);
+
+        return result;
+    }
+
+    le_cfg_nodeType_t type;
+    const char* valuePtr = FindValue(cacheRef, path, &type);
+
+    if ((valuePtr == NULL) || (type != LE_CFG_TYPE_STRING))
+    {
+        valuePtr = defaultPtr;
+    }
+
+    return le_utf8_Copy(bufPtr, valuePtr, bufSize, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a signed integer value from the cached subtree.  Floating point values are rounded.  If the
+ * node holds some other type, or if it's empty or doesn't exist, the default value is returned.
+ *
+ * @return
+ *      The node's value.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t cfgCache_GetInt
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    int32_t defaultValue        ///< [IN] Value to use if the node can't be read.
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+
+    if (!NormalizePath(pathPtr, path, sizeof(path)) || !Load(cacheRef))
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(cacheRef->basePath);
+        int32_t value = le_cfg_GetInt(iterRef, pathPtr, defaultValue);
+
+        le_cfg_CancelTxn(iterRef);
+
+        return value;
+    }
+
+    le_cfg_nodeType_t type;
+    const char* valuePtr = FindValue(cacheRef, path, &type);
+
+    if (valuePtr != NULL)
+    {
+        if (type == LE_CFG_TYPE_INT)
+        {
+            return atoi(valuePtr);
+        }
+
+        if (type == LE_CFG_TYPE_FLOAT)
+        {
+            double value = atof(valuePtr);
+
+            return (int32_t)(value >= 0.0 ? value + 0.5 : value - 0.5);
+        }
+    }
+
+    return defaultValue;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a floating point value from the cached subtree.  Integer values are promoted.  If the node
+ * holds some other type, or if it's empty or doesn't exist, the default value is returned.
+ *
+ * @return
+ *      The node's value.
+ */
+//--------------------------------------------------------------------------------------------------
+double cfgCache_GetFloat
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    double defaultValue         ///< [IN] Value to use if the node can't be read.
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+
+    if (!NormalizePath(pathPtr, path, sizeof(path)) || !Load(cacheRef))
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(cacheRef->basePath);
+        double value = le_cfg_GetFloat(iterRef, pathPtr, defaultValue);
+
+        le_cfg_CancelTxn(iterRef);
+
+        return value;
+    }
+
+    le_cfg_nodeType_t type;
+    const char* valuePtr = FindValue(cacheRef, path, &type);
+
+    if (valuePtr != NULL)
+    {
+        if (type == LE_CFG_TYPE_INT)
+        {
+            return atoi(valuePtr);
+        }
+
+        if (type == LE_CFG_TYPE_FLOAT)
+        {
+            return atof(valuePtr);
+        }
+    }
+
+    return defaultValue;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a boolean value from the cached subtree.  If the node holds some other type, or if it's
+ * empty or doesn't exist, the default value is returned.
+ *
+ * @return
+ *      The node's value.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgCache_GetBool
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    bool defaultValue           ///< [IN] Value to use if the node can't be read.
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+
+    if (!NormalizePath(pathPtr, path, sizeof(path)) || !Load(cacheRef))
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(cacheRef->basePath);
+        bool value = le_cfg_GetBool(iterRef, pathPtr, defaultValue);
+
+        le_cfg_CancelTxn(iterRef);
+
+        return value;
+    }
+
+    le_cfg_nodeType_t type;
+    const char* valuePtr = FindValue(cacheRef, path, &type);
+
+    if ((valuePtr != NULL) && (type == LE_CFG_TYPE_BOOL))
+    {
+        return (strcmp(valuePtr, "true") == 0);
+    }
+
+    return defaultValue;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config cache's initialization function.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    CachePool = le_mem_CreatePool("CfgCache", sizeof(Cache_t));
+}
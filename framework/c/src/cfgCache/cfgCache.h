@@ -0,0 +1,143 @@
+//--------------------------------------------------------------------------------------------------
+/** @file cfgCache.h
+ *
+ * This API keeps a client-side copy of a subtree of the config tree, so that configuration that is
+ * read over and over again can be read without going back to the config tree each time.
+ *
+ * A cache is loaded with a single le_cfgBatch_GetSubtree() request the first time it's read.
+ * After that, reads are served from the local copy until the config tree reports a change anywhere
+ * in the cached subtree, at which point the copy is thrown away and reloaded on the next read.
+ *
+ * The change notification is delivered through the event loop of the thread that created the
+ * cache, so a cache must only be used by that thread.  A read made between a commit and the
+ * delivery of its notification can return the old value, just like reads made with the "quick"
+ * le_cfg functions aren't protected from other activity in the system.
+ *
+ * If the subtree is too large to fit in a single le_cfgBatch_GetSubtree() response, reads fall
+ * back to reading the config tree directly.
+ *
+ * Node paths are taken the same way as by the le_cfg functions.  Relative paths are looked up in
+ * the cache, with "." names, repeated separators and a trailing separator ignored.  Paths that
+ * aren't below the base node (absolute paths, paths that go up with "..", paths that name a tree,
+ * and the empty path to the base node itself) are read from the config tree directly.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+
+#ifndef LEGATO_CFG_CACHE_INCLUDE_GUARD
+#define LEGATO_CFG_CACHE_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a config cache.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct cfgCache_Cache* cfgCache_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a cache of the subtree below a node in the config tree.  Caches last for the life of
+ * the process.
+ *
+ * @return
+ *      Reference to the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+cfgCache_Ref_t cfgCache_Create
+(
+    const char* pathPtr         ///< [IN] Path to the base node of the subtree.  May include a
+                                ///<      tree name.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks to see if a node exists in the cached subtree.
+ *
+ * @return
+ *      True if the node exists, false if not.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgCache_NodeExists
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr         ///< [IN] Path of the node, relative to the cache's base node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a string value from the cached subtree.  If the node isn't a string, or if it's empty or
+ * doesn't exist, the default value is returned.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer was not big enough for the value.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgCache_GetString
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    char* bufPtr,               ///< [OUT] Buffer to store the value.
+    size_t bufSize,             ///< [IN] Size of the buffer.
+    const char* defaultPtr      ///< [IN] Value to use if the node can't be read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a signed integer value from the cached subtree.  Floating point values are rounded.  If the
+ * node holds some other type, or if it's empty or doesn't exist, the default value is returned.
+ *
+ * @return
+ *      The node's value.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t cfgCache_GetInt
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    int32_t defaultValue        ///< [IN] Value to use if the node can't be read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a floating point value from the cached subtree.  Integer values are promoted.  If the node
+ * holds some other type, or if it's empty or doesn't exist, the default value is returned.
+ *
+ * @return
+ *      The node's value.
+ */
+//--------------------------------------------------------------------------------------------------
+double cfgCache_GetFloat
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    double defaultValue         ///< [IN] Value to use if the node can't be read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a boolean value from the cached subtree.  If the node holds some other type, or if it's
+ * empty or doesn't exist, the default value is returned.
+ *
+ * @return
+ *      The node's value.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgCache_GetBool
+(
+    cfgCache_Ref_t cacheRef,    ///< [IN] The cache to read.
+    const char* pathPtr,        ///< [IN] Path of the node, relative to the cache's base node.
+    bool defaultValue           ///< [IN] Value to use if the node can't be read.
+);
+
+
+
+
+#endif  // LEGATO_CFG_CACHE_INCLUDE_GUARD
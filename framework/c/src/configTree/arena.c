@@ -0,0 +1,179 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file arena.c
+ *
+ *  A simple arena allocator.  Memory is handed out from large chunks and is never freed piece by
+ *  piece, instead the whole arena is freed at once.
+ *
+ *  The chunks come straight from the heap rather than from a memory pool, so that the memory
+ *  used by a large arena is given back once the arena is deleted.
+ *
+ *  Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ *  Use of this work is subject to license.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "arena.h"
+
+
+
+
+/// Size of each of the chunks that an arena's memory is allocated from, in bytes.
+#define CHUNK_BYTES (64 * 1024)
+
+
+
+
+/// Every block allocated from an arena is aligned to this many bytes.
+#define ALIGNMENT sizeof(uint64_t)
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A chunk of arena memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct Chunk
+{
+    struct Chunk* nextPtr;  ///< The chunk that was allocated before this one, if any.
+    size_t used;            ///< Number of bytes of data that have been handed out so far.
+    uint8_t data[];         ///< The memory that's handed out.
+}
+Chunk_t;
+
+
+
+
+/// Number of bytes of data in each chunk.
+#define CHUNK_DATA_BYTES (CHUNK_BYTES - sizeof(Chunk_t))
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The arena object itself.  It's allocated from the arena's own first chunk.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct Arena
+{
+    Chunk_t* chunkPtr;  ///< The chunk that memory is currently being handed out from.  The older
+                        ///<   chunks are chained off of this one.
+}
+Arena_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Allocate a new, empty chunk.
+ *
+ *  @return The new chunk.
+ */
+//--------------------------------------------------------------------------------------------------
+static Chunk_t* NewChunk
+(
+    Chunk_t* nextPtr  ///< [IN] The arena's current chunk, if it has one.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Chunk_t* chunkPtr = malloc(CHUNK_BYTES);
+
+    LE_ASSERT(chunkPtr != NULL);
+
+    chunkPtr->nextPtr = nextPtr;
+    chunkPtr->used = 0;
+
+    return chunkPtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Create a new, empty arena.
+ *
+ *  @return The new arena.
+ */
+//--------------------------------------------------------------------------------------------------
+arena_Ref_t arena_Create
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Chunk_t* chunkPtr = NewChunk(NULL);
+    arena_Ref_t arenaRef = (arena_Ref_t)chunkPtr->data;
+
+    chunkPtr->used = sizeof(Arena_t);
+    arenaRef->chunkPtr = chunkPtr;
+
+    return arenaRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Allocate a block of memory from an arena.  The memory is not initialized, and it stays
+ *  allocated until the whole arena is deleted.
+ *
+ *  @return A pointer to the block.
+ */
+//--------------------------------------------------------------------------------------------------
+void* arena_Alloc
+(
+    arena_Ref_t arenaRef,  ///< [IN] The arena to allocate from.
+    size_t size            ///< [IN] Size of the block in bytes, at most ARENA_MAX_ALLOC_BYTES.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(size <= ARENA_MAX_ALLOC_BYTES);
+
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    Chunk_t* chunkPtr = arenaRef->chunkPtr;
+
+    if (chunkPtr->used + size > CHUNK_DATA_BYTES)
+    {
+        chunkPtr = NewChunk(chunkPtr);
+        arenaRef->chunkPtr = chunkPtr;
+    }
+
+    void* blockPtr = chunkPtr->data + chunkPtr->used;
+    chunkPtr->used += size;
+
+    return blockPtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Free an arena, along with everything that was ever allocated from it.
+ */
+//--------------------------------------------------------------------------------------------------
+void arena_Delete
+(
+    arena_Ref_t arenaRef  ///< [IN] The arena to free.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Chunk_t* chunkPtr = arenaRef->chunkPtr;
+
+    // The arena object lives in the oldest chunk, so it can't be touched once that's freed.
+    while (chunkPtr != NULL)
+    {
+        Chunk_t* nextPtr = chunkPtr->nextPtr;
+
+        free(chunkPtr);
+        chunkPtr = nextPtr;
+    }
+}
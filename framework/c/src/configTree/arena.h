@@ -0,0 +1,80 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file arena.h
+ *
+ *  A simple arena allocator.  Memory is handed out from large chunks and is never freed piece by
+ *  piece, instead the whole arena is freed at once.
+ *
+ *  Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ *  Use of this work is subject to license.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_ARENA_INCLUDE_GUARD
+#define CFG_ARENA_INCLUDE_GUARD
+
+
+
+
+/// The largest single allocation that can be made from an arena.
+#define ARENA_MAX_ALLOC_BYTES (32 * 1024)
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The arena object pointer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct Arena* arena_Ref_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Create a new, empty arena.
+ *
+ *  @return The new arena.
+ */
+//--------------------------------------------------------------------------------------------------
+arena_Ref_t arena_Create
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Allocate a block of memory from an arena.  The memory is not initialized, and it stays
+ *  allocated until the whole arena is deleted.
+ *
+ *  @return A pointer to the block.
+ */
+//--------------------------------------------------------------------------------------------------
+void* arena_Alloc
+(
+    arena_Ref_t arenaRef,  ///< [IN] The arena to allocate from.
+    size_t size            ///< [IN] Size of the block in bytes, at most ARENA_MAX_ALLOC_BYTES.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Free an arena, along with everything that was ever allocated from it.
+ */
+//--------------------------------------------------------------------------------------------------
+void arena_Delete
+(
+    arena_Ref_t arenaRef  ///< [IN] The arena to free.
+);
+
+
+
+
+#endif
@@ -13,18 +13,18 @@
 
 #include "legato.h"
 #include "interfaces.h"
-#include "dynamicString.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "nodeIterator.h"
 #include "treeIterator.h"
 #include "requestQueue.h"
 #include "internalConfig.h"
+#include "importExport.h"
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called when a config API, or a configAdmin session is opened.  This function will call into the
+ *  Called when a config API, a configAdmin or a configBatch session is opened.  This function will call into the
  *  user subsystem to allow it to keep track of the active users of a system.
  */
 // -------------------------------------------------------------------------------------------------
@@ -82,6 +82,26 @@ static void OnConfigAdminSessionClosed
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  When clients of the batch API disconnect from the service this function is called.  Batch
+ *  requests work on the iterators of the client's config API session, so the only thing to release
+ *  is the connection's reference to the user information.
+ */
+// -------------------------------------------------------------------------------------------------
+static void OnConfigBatchSessionClosed
+(
+    le_msg_SessionRef_t sessionRef,  ///< [IN] Reference to the session that's going away.
+    void* contextPtr                 ///< [IN] Our callback context.  Configured as NULL.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tu_SessionDisconnected(sessionRef);
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Initialize the configTree server interfaces and all of it's subsystems.
@@ -92,12 +112,12 @@ COMPONENT_INIT
     LE_DEBUG("** Config Tree, begin init.");
 
     // Initilize our internal subsystems.
-    dstr_Init();   // Dynamic strings.
     rq_Init();     // Request queue.
     ni_Init();     // Node iterator.
     ti_Init();     // Tree iterator.
     tu_Init();     // Tree user.
     tdb_Init();    // Tree DB.
+    ie_Init();     // Import/export worker.
     ic_Init();     // Internal config, this depends on other subsystems and so need to go last.
 
     // Register our service handlers on those services so that we can properly free up resources if
@@ -106,9 +126,11 @@ COMPONENT_INIT
 
     le_msg_AddServiceOpenHandler(le_cfg_GetServiceRef(), OnConfigSessionOpened, NULL);
     le_msg_AddServiceOpenHandler(le_cfgAdmin_GetServiceRef(), OnConfigSessionOpened, NULL);
+    le_msg_AddServiceOpenHandler(le_cfgBatch_GetServiceRef(), OnConfigSessionOpened, NULL);
 
     le_msg_AddServiceCloseHandler(le_cfg_GetServiceRef(), OnConfigSessionClosed, NULL);
     le_msg_AddServiceCloseHandler(le_cfgAdmin_GetServiceRef(), OnConfigAdminSessionClosed, NULL);
+    le_msg_AddServiceCloseHandler(le_cfgBatch_GetServiceRef(), OnConfigBatchSessionClosed, NULL);
 
 
     // Because this is a system process, we need to close our standard in.  This way the supervisor
@@ -16,6 +16,7 @@
 #include "treeUser.h"
 #include "nodeIterator.h"
 #include "treeIterator.h"
+#include "importExport.h"
 
 
 
@@ -235,6 +236,137 @@ void le_cfgAdmin_ExportTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a subset of the configuration tree from an open file descriptor, and write it into the
+ *  iterator's transaction at the given nodePath.
+ *
+ *  The data is read, and for JSON parsed, on the import/export worker thread.  So, the response is
+ *  sent later, once the data has been applied to the transaction.
+ *
+ *  \b Responds \b With:
+ *
+ *  Responds with one of the following values:
+ *
+ *          - LE_OK            - The import was completed successfully.
+ *          - LE_FAULT         - An I/O error occurred while reading the data.
+ *          - LE_FORMAT_ERROR  - Configuration data being imported appears corrupted.
+ *          - LE_NOT_POSSIBLE  - A JSON stem conflicts with an existing value node.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_ImportTreeFd
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Write iterator that is being used for the
+                                            ///<      import.
+    int fd,                                 ///< [IN] Import the tree data from this descriptor.
+    const char* nodePathPtr,                ///< [IN] Where in the tree should this import happen?
+                                            ///<      Leave as an empty string to use the iterator's
+                                            ///<      current node.
+    le_cfgAdmin_Format_t format             ///< [IN] The format of the data being imported.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Importing a tree from fd %d onto node '%s', using iterator, '%p'.",
+             fd, nodePathPtr, externalRef);
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+
+    if (iteratorRef == NULL)
+    {
+        if (fd != -1)
+        {
+            close(fd);
+        }
+
+        le_cfgAdmin_ImportTreeFdRespond(commandRef, LE_OK);
+        return;
+    }
+
+    if (ni_IsWriteable(iteratorRef) == false)
+    {
+        if (fd != -1)
+        {
+            close(fd);
+        }
+
+        tu_TerminateConfigAdminClient(le_cfgAdmin_GetClientSessionRef(),
+                                      "This operation requires a write iterator.");
+        le_cfgAdmin_ImportTreeFdRespond(commandRef, LE_OK);
+        return;
+    }
+
+    if (fd == -1)
+    {
+        LE_ERROR("No file descriptor was sent for the import.");
+        le_cfgAdmin_ImportTreeFdRespond(commandRef, LE_FAULT);
+        return;
+    }
+
+    ie_ImportTree(commandRef, iteratorRef, externalRef, fd, nodePathPtr, format);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Take a node given from nodePath and write it and it's children to an open file descriptor.
+ *
+ *  The sub-tree is copied out of the iterator right away, then formatted and written on the
+ *  import/export worker thread.  The response is sent once the write is complete.
+ *
+ *  \b Responds \b With:
+ *
+ *  Responds with one of the following values:
+ *
+ *          - LE_OK            - The export was completed successfully.
+ *          - LE_FAULT         - An I/O error occurred while writing the data.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_ExportTreeFd
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Iterator that is being used for the export.
+    int fd,                                 ///< [IN] Export the tree data to this descriptor.
+    const char* nodePathPtr,                ///< [IN] Where in the tree should this export happen?
+                                            ///<      Leave as an empty string to use the iterator's
+                                            ///<      current node.
+    le_cfgAdmin_Format_t format             ///< [IN] The format to write the data in.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Exporting a tree from node '%s' into fd %d, using iterator, '%p'.",
+             nodePathPtr, fd, externalRef);
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+
+    if (iteratorRef == NULL)
+    {
+        if (fd != -1)
+        {
+            close(fd);
+        }
+
+        le_cfgAdmin_ExportTreeFdRespond(commandRef, LE_OK);
+        return;
+    }
+
+    if (fd == -1)
+    {
+        LE_ERROR("No file descriptor was sent for the export.");
+        le_cfgAdmin_ExportTreeFdRespond(commandRef, LE_FAULT);
+        return;
+    }
+
+    ie_ExportTree(commandRef, iteratorRef, fd, nodePathPtr, format);
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 //  Tree maintenance.
 // -------------------------------------------------------------------------------------------------
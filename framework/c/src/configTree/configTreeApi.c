@@ -12,7 +12,6 @@
 
 #include "legato.h"
 #include "interfaces.h"
-#include "dynamicString.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "treePath.h"
@@ -219,8 +218,8 @@ static tdb_TreeRef_t QuickGetTree
  *         Once the read timeout expires, then all active read iterators on that tree will be
  *         expired and the clients killed.
  *
- *  @note: A tree transaction is global to that tree; a long held read transaction will block other
- *         users write transactions from being comitted.
+ *  @note: A read transaction sees the tree as it was when the transaction was created.  Changes
+ *         committed by other users while it's open are not visible through it.
  *
  *  @return This will return a newly created iterator reference.
  */
@@ -0,0 +1,182 @@
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file configTreeBatchApi.c
+ *
+ *  Implementation of the configTree batch API.  Batch requests work on the iterators created
+ *  through the configTree API by the same user.
+ *
+ *  Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "treeDb.h"
+#include "treeUser.h"
+#include "treePath.h"
+#include "nodeIterator.h"
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get an iterator pointer from an iterator reference.
+ *
+ *  @return An internal reference to the iterator.  Or NULL the safe reference could not be
+ *          resolved.
+ */
+// -------------------------------------------------------------------------------------------------
+static ni_IteratorRef_t GetIteratorFromRef
+(
+    le_cfg_IteratorRef_t externalRef  ///< [IN] Iterator reference to extract a pointer from.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ni_IteratorRef_t iteratorRef = ni_InternalRefFromExternalRef(tu_GetCurrentConfigBatchUserInfo(),
+                                                                 externalRef);
+
+    if (iteratorRef == NULL)
+    {
+        tu_TerminateConfigClient(le_cfgBatch_GetClientSessionRef(), "Bad iterator reference.");
+    }
+
+    return iteratorRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get an iterator pointer from an iterator reference.
+ *
+ *  @return An internal reference to the iterator.  Or NULL the safe reference could not be
+ *          resolved.  NULL is also returned if the iterator in question is not writeable.
+ */
+// -------------------------------------------------------------------------------------------------
+static ni_IteratorRef_t GetWriteIteratorFromRef
+(
+    le_cfg_IteratorRef_t externalRef  ///< [IN] Iterator reference to extract a pointer from.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+
+    if (   (iteratorRef != NULL)
+        && (ni_IsWriteable(iteratorRef) == false))
+    {
+        tu_TerminateConfigClient(le_cfgBatch_GetClientSessionRef(),
+                                 "This operation requires a write iterator.");
+
+        return NULL;
+    }
+
+    return iteratorRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check the path to see if the user specified a specific tree to use.  If so, kill the client,
+ *  because trees can't be changed in the middle of a transaction.
+ *
+ *  @return True if the path has a tree specifier, (and the client has been killed,) false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool CheckPathForSpecifier
+(
+    const char* pathPtr  ///< [IN] Path string to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (tp_PathHasTreeSpecifier(pathPtr))
+    {
+        tu_TerminateConfigClient(le_cfgBatch_GetClientSessionRef(),
+                                 "Can not change trees in the middle of a transaction.");
+
+        return true;
+    }
+
+    return false;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read the paths, types and values of all of the nodes below the given node with a single
+ *  request.
+ *
+ *  If the path is empty, the nodes below the iterator's current node are read.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgBatch_GetSubtree
+(
+    le_cfgBatch_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Iterator to use as a basis for the
+                                            ///<      transaction.
+    const char* pathPtr,                    ///< [IN] Absolute or relative path to the base node.
+    size_t bufferSize                       ///< [IN] Maximum size of the result buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Reading the subtree of the iterator's <%p> current node.", externalRef);
+    LE_DEBUG_IF((pathPtr != NULL) && (strlen(pathPtr) != 0), "** Offset by \"%s\"", pathPtr);
+
+    static uint8_t buffer[LE_CFGBATCH_BATCH_BYTES];
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+    size_t size = (bufferSize < sizeof(buffer)) ? bufferSize : sizeof(buffer);
+    le_result_t result = LE_OK;
+
+    if (   (iteratorRef != NULL)
+        && (CheckPathForSpecifier(pathPtr) == false))
+    {
+        result = ni_GetSubtree(iteratorRef, pathPtr, buffer, &size);
+    }
+    else
+    {
+        size = 0;
+    }
+
+    le_cfgBatch_GetSubtreeRespond(commandRef, result, size, buffer);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Apply a batch of writes to the configuration tree with a single request.  Only valid during a
+ *  write transaction.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgBatch_SetBatch
+(
+    le_cfgBatch_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Iterator to use as a basis for the
+                                            ///<      transaction.
+    const uint8_t* bufferPtr,               ///< [IN] Records for the nodes to write.
+    size_t bufferSize                       ///< [IN] Size of the records.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Applying a %zu byte batch with iterator <%p>.", bufferSize, externalRef);
+
+    ni_IteratorRef_t iteratorRef = GetWriteIteratorFromRef(externalRef);
+    le_result_t result = LE_OK;
+
+    if (iteratorRef != NULL)
+    {
+        result = ni_SetBatch(iteratorRef, bufferPtr, bufferSize);
+    }
+
+    le_cfgBatch_SetBatchRespond(commandRef, result);
+}
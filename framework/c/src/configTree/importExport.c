@@ -0,0 +1,1168 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file importExport.c
+ *
+ *  Bulk import and export of config sub-trees through a file descriptor passed in by the client.
+ *
+ *  The tree isn't thread safe, so a transfer is split up into steps that bounce between the main
+ *  thread and a worker thread:
+ *
+ *  - An import reads the whole descriptor on the worker thread.  JSON is also parsed there and
+ *    turned into the same batch records that le_cfgBatch_SetBatch() takes.  The main thread then
+ *    writes the records, or parses the native text, into the iterator's transaction and responds.
+ *  - An export copies the sub-tree out of the iterator on the main thread, as batch records or as
+ *    native text.  The worker thread then formats the JSON and writes the descriptor, and the main
+ *    thread responds.
+ *
+ *  The client is waiting for the response the whole time, so it can't use the iterator in the
+ *  meantime.  It can still be released or timed out though, so an import checks that it's still
+ *  valid before applying the data.
+ *
+ *  Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ *  Use of this work is subject to license.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "jansson.h"
+#include "treeDb.h"
+#include "treeUser.h"
+#include "nodeIterator.h"
+#include "importExport.h"
+
+
+
+
+/// Name of the pool the transfer jobs are allocated from.
+#define CFG_TRANSFER_JOB_POOL "configTree.transferJobPool"
+
+
+
+
+/// Size the buffers used to read a descriptor, or to build batch records, start out at.  They're
+/// doubled whenever they fill up.
+#define INITIAL_BUFFER_BYTES (64 * 1024)
+
+
+
+
+/// Deepest a node can be below the root of an export.  Every level of a path takes at least two
+/// characters.
+#define MAX_EXPORT_DEPTH (LE_CFG_STR_LEN_BYTES / 2)
+
+
+
+
+/// JSON field names, the same as the ones used by the config tool.
+#define JSON_FIELD_TYPE "type"
+#define JSON_FIELD_NAME "name"
+#define JSON_FIELD_CHILDREN "children"
+#define JSON_FIELD_VALUE "value"
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  An import or export that's in progress.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct TransferJob
+{
+    le_cfgAdmin_ServerCmdRef_t commandRef;   ///< Reference used to reply to the request.
+    ni_IteratorRef_t iteratorRef;            ///< The iterator being imported into.
+    le_cfg_IteratorRef_t externalRef;        ///< The client's reference to the iterator.
+    le_cfgAdmin_Format_t format;             ///< The format of the data.
+    int fd;                                  ///< The descriptor the client passed in.
+    char nodePath[LE_CFG_STR_LEN_BYTES];     ///< Path to the node being imported or exported.
+
+    char* dataPtr;                           ///< Data that's being passed between the threads.
+                                             ///<   Allocated with malloc().
+    size_t dataSize;                         ///< Number of bytes of data.
+    le_result_t result;                      ///< Result of the job so far.
+}
+TransferJob_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A growable buffer of batch records.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct RecordBuffer
+{
+    char* dataPtr;  ///< The records, allocated with malloc().
+    size_t size;    ///< Number of bytes of records written so far.
+    size_t max;     ///< Size of the allocated buffer.
+}
+RecordBuffer_t;
+
+
+
+
+/// Pool that the transfer jobs are allocated from.
+static le_mem_PoolRef_t JobPool = NULL;
+
+
+
+
+/// The thread that owns the tree, and handles all of the IPC.
+static le_thread_Ref_t MainThreadRef = NULL;
+
+
+
+
+/// The thread that does the reading, writing, parsing and formatting.
+static le_thread_Ref_t WorkerThreadRef = NULL;
+
+
+
+
+/// Posted by the worker thread once its event loop is ready to take jobs.
+static le_sem_Ref_t WorkerReadySemRef = NULL;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Close a descriptor, retrying if interrupted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseFd
+(
+    int fd  ///< [IN] The descriptor to close.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int retVal = -1;
+
+    do
+    {
+        retVal = close(fd);
+    }
+    while ((retVal == -1) && (errno == EINTR));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Grow a malloc()ed buffer so that it can hold at least the given number of bytes.
+ *
+ *  @return LE_OK if the buffer is big enough, LE_NO_MEMORY if it couldn't be grown.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GrowBuffer
+(
+    char** bufferPtrPtr,  ///< [IN/OUT] The buffer.
+    size_t* maxPtr,       ///< [IN/OUT] The size of the buffer.
+    size_t needed         ///< [IN]     The number of bytes that the buffer needs to hold.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (needed <= *maxPtr)
+    {
+        return LE_OK;
+    }
+
+    size_t newMax = (*maxPtr == 0) ? INITIAL_BUFFER_BYTES : *maxPtr;
+
+    while (newMax < needed)
+    {
+        newMax *= 2;
+    }
+
+    char* newBufferPtr = realloc(*bufferPtrPtr, newMax);
+
+    if (newBufferPtr == NULL)
+    {
+        LE_ERROR("Could not allocate %zu bytes for a tree transfer.", newMax);
+        return LE_NO_MEMORY;
+    }
+
+    *bufferPtrPtr = newBufferPtr;
+    *maxPtr = newMax;
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read everything from a descriptor, up to end of file, into a job's data buffer.
+ *
+ *  @return LE_OK if the read succeeded, LE_FAULT if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadAll
+(
+    TransferJob_t* jobPtr  ///< [IN] The job to read the data of.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t max = 0;
+
+    for (;;)
+    {
+        if (GrowBuffer(&jobPtr->dataPtr, &max, jobPtr->dataSize + 1) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        ssize_t readSize = read(jobPtr->fd,
+                                jobPtr->dataPtr + jobPtr->dataSize,
+                                max - jobPtr->dataSize);
+
+        if (readSize > 0)
+        {
+            jobPtr->dataSize += readSize;
+        }
+        else if (readSize == 0)
+        {
+            return LE_OK;
+        }
+        else if (errno != EINTR)
+        {
+            LE_ERROR("Could not read tree data, reason: %m");
+            return LE_FAULT;
+        }
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write all of a job's data to its descriptor.
+ *
+ *  @return LE_OK if the write succeeded, LE_FAULT if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAll
+(
+    TransferJob_t* jobPtr  ///< [IN] The job to write the data of.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t written = 0;
+
+    while (written < jobPtr->dataSize)
+    {
+        ssize_t writeSize = write(jobPtr->fd,
+                                  jobPtr->dataPtr + written,
+                                  jobPtr->dataSize - written);
+
+        if (writeSize >= 0)
+        {
+            written += writeSize;
+        }
+        else if (errno != EINTR)
+        {
+            LE_ERROR("Could not write tree data, reason: %m");
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a batch record to a record buffer.
+ *
+ *  @return LE_OK if the record was added, LE_NO_MEMORY if the buffer couldn't be grown.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AppendRecord
+(
+    RecordBuffer_t* recordsPtr,  ///< [IN] The buffer to append to.
+    le_cfg_nodeType_t type,      ///< [IN] The type of the node.
+    const char* pathPtr,         ///< [IN] The path to the node.
+    const char* valuePtr         ///< [IN] The node's value as a string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t pathSize = strlen(pathPtr) + 1;
+    size_t valueSize = strlen(valuePtr) + 1;
+
+    if (GrowBuffer(&recordsPtr->dataPtr,
+                   &recordsPtr->max,
+                   recordsPtr->size + 1 + pathSize + valueSize) != LE_OK)
+    {
+        return LE_NO_MEMORY;
+    }
+
+    char* recordPtr = recordsPtr->dataPtr + recordsPtr->size;
+
+    recordPtr[0] = (char)type;
+    memcpy(recordPtr + 1, pathPtr, pathSize);
+    memcpy(recordPtr + 1 + pathSize, valuePtr, valueSize);
+
+    recordsPtr->size += 1 + pathSize + valueSize;
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the node type named by a JSON node's type field.  The root of a whole tree export is of
+ *  type "tree", which is treated as a stem.
+ *
+ *  @return The node type, or LE_CFG_TYPE_DOESNT_EXIST if the type isn't recognized.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_cfg_nodeType_t JsonNodeType
+(
+    json_t* nodePtr  ///< [IN] The JSON node.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* typePtr = json_string_value(json_object_get(nodePtr, JSON_FIELD_TYPE));
+
+    if (typePtr == NULL)
+    {
+        return LE_CFG_TYPE_DOESNT_EXIST;
+    }
+    else if (strcmp(typePtr, "string") == 0)
+    {
+        return LE_CFG_TYPE_STRING;
+    }
+    else if (strcmp(typePtr, "bool") == 0)
+    {
+        return LE_CFG_TYPE_BOOL;
+    }
+    else if (strcmp(typePtr, "int") == 0)
+    {
+        return LE_CFG_TYPE_INT;
+    }
+    else if (strcmp(typePtr, "float") == 0)
+    {
+        return LE_CFG_TYPE_FLOAT;
+    }
+    else if (strcmp(typePtr, "empty") == 0)
+    {
+        return LE_CFG_TYPE_EMPTY;
+    }
+    else if (   (strcmp(typePtr, "stem") == 0)
+             || (strcmp(typePtr, "tree") == 0))
+    {
+        return LE_CFG_TYPE_STEM;
+    }
+
+    return LE_CFG_TYPE_DOESNT_EXIST;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Convert a JSON node, and all of its children, into batch records.
+ *
+ *  @return LE_OK if the records were added, LE_FORMAT_ERROR if the JSON isn't a valid config
+ *          tree, or LE_NO_MEMORY if the record buffer couldn't be grown.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AppendJsonRecords
+(
+    RecordBuffer_t* recordsPtr,  ///< [IN] The buffer to append to.
+    json_t* nodePtr,             ///< [IN] The JSON node to convert.
+    char* pathPtr,               ///< [IN] Buffer holding the path to the node.  Children's paths
+                                 ///<      are built up in this buffer.
+    size_t pathLen               ///< [IN] Length of the node's path.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char valueBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    json_t* valuePtr = json_object_get(nodePtr, JSON_FIELD_VALUE);
+    le_cfg_nodeType_t type = JsonNodeType(nodePtr);
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_STRING:
+            if (   (json_is_string(valuePtr) == false)
+                || (le_utf8_Copy(valueBuffer,
+                                 json_string_value(valuePtr),
+                                 sizeof(valueBuffer),
+                                 NULL) != LE_OK))
+            {
+                return LE_FORMAT_ERROR;
+            }
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            if (json_is_boolean(valuePtr) == false)
+            {
+                return LE_FORMAT_ERROR;
+            }
+
+            strcpy(valueBuffer, json_is_true(valuePtr) ? "true" : "false");
+            break;
+
+        case LE_CFG_TYPE_INT:
+            if (json_is_integer(valuePtr) == false)
+            {
+                return LE_FORMAT_ERROR;
+            }
+
+            snprintf(valueBuffer,
+                     sizeof(valueBuffer),
+                     "%" JSON_INTEGER_FORMAT,
+                     json_integer_value(valuePtr));
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            if (json_is_number(valuePtr) == false)
+            {
+                return LE_FORMAT_ERROR;
+            }
+
+            snprintf(valueBuffer, sizeof(valueBuffer), "%.17g", json_number_value(valuePtr));
+            break;
+
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_STEM:
+            break;
+
+        default:
+            return LE_FORMAT_ERROR;
+    }
+
+    le_result_t result = AppendRecord(recordsPtr, type, pathPtr, valueBuffer);
+
+    if (   (result != LE_OK)
+        || (type != LE_CFG_TYPE_STEM))
+    {
+        return result;
+    }
+
+    json_t* childrenPtr = json_object_get(nodePtr, JSON_FIELD_CHILDREN);
+    json_t* childPtr;
+    size_t i;
+
+    if (   (childrenPtr != NULL)
+        && (json_is_array(childrenPtr) == false))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    json_array_foreach(childrenPtr, i, childPtr)
+    {
+        const char* namePtr = json_string_value(json_object_get(childPtr, JSON_FIELD_NAME));
+
+        if (   (namePtr == NULL)
+            || (namePtr[0] == '\0')
+            || (strchr(namePtr, '/') != NULL)
+            || (strlen(namePtr) >= LE_CFG_NAME_LEN_BYTES))
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        // Only add a separator if the path doesn't already end in one, so that an import onto "/"
+        // stays absolute.
+        size_t childPathLen = pathLen;
+
+        if (   (childPathLen > 0)
+            && (pathPtr[childPathLen - 1] != '/'))
+        {
+            pathPtr[childPathLen] = '/';
+            childPathLen++;
+        }
+
+        if (le_utf8_Copy(pathPtr + childPathLen,
+                         namePtr,
+                         LE_CFG_STR_LEN_BYTES - childPathLen,
+                         NULL) != LE_OK)
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        result = AppendJsonRecords(recordsPtr,
+                                   childPtr,
+                                   pathPtr,
+                                   childPathLen + strlen(namePtr));
+        pathPtr[pathLen] = '\0';
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Parse a job's JSON data, and replace it with the equivalent batch records.
+ *
+ *  @return LE_OK if the data was converted, LE_FORMAT_ERROR if the JSON isn't a valid config tree,
+ *          or LE_FAULT if memory ran out.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t JsonToRecords
+(
+    TransferJob_t* jobPtr  ///< [IN] The job to convert the data of.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    json_error_t error;
+    json_t* rootPtr = json_loadb(jobPtr->dataPtr, jobPtr->dataSize, 0, &error);
+
+    if (rootPtr == NULL)
+    {
+        LE_ERROR("JSON import error: line: %d, column: %d, error: %s",
+                 error.line,
+                 error.column,
+                 error.text);
+        return LE_FORMAT_ERROR;
+    }
+
+    RecordBuffer_t records = { NULL, 0, 0 };
+    char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    le_utf8_Copy(pathBuffer, jobPtr->nodePath, sizeof(pathBuffer), NULL);
+
+    le_result_t result = AppendJsonRecords(&records, rootPtr, pathBuffer, strlen(pathBuffer));
+    json_decref(rootPtr);
+
+    if (result != LE_OK)
+    {
+        free(records.dataPtr);
+        return (result == LE_NO_MEMORY) ? LE_FAULT : result;
+    }
+
+    free(jobPtr->dataPtr);
+    jobPtr->dataPtr = records.dataPtr;
+    jobPtr->dataSize = records.size;
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Create the JSON node for a batch record, the same way that the config tool's JSON export does.
+ *  Empty nodes are written as stems with no children.
+ *
+ *  @return The new JSON node, or NULL if the record's node can't be represented.
+ */
+//--------------------------------------------------------------------------------------------------
+static json_t* CreateJsonNode
+(
+    le_cfg_nodeType_t type,  ///< [IN] The type of the node.
+    const char* namePtr,     ///< [IN] The name of the node.
+    const char* valuePtr     ///< [IN] The node's value as a string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    json_t* valueNodePtr = NULL;
+    const char* typePtr = NULL;
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_STRING:
+            typePtr = "string";
+            valueNodePtr = json_string(valuePtr);
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            typePtr = "bool";
+            valueNodePtr = json_boolean(strcmp(valuePtr, "true") == 0);
+            break;
+
+        case LE_CFG_TYPE_INT:
+            typePtr = "int";
+            valueNodePtr = json_integer(strtoll(valuePtr, NULL, 10));
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            typePtr = "float";
+            valueNodePtr = json_real(strtod(valuePtr, NULL));
+            break;
+
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_STEM:
+            typePtr = "stem";
+            valueNodePtr = json_array();
+            break;
+
+        default:
+            return NULL;
+    }
+
+    if (valueNodePtr == NULL)
+    {
+        return NULL;
+    }
+
+    json_t* nodePtr = json_object();
+
+    json_object_set_new(nodePtr, JSON_FIELD_NAME, json_string(namePtr));
+    json_object_set_new(nodePtr, JSON_FIELD_TYPE, json_string(typePtr));
+    json_object_set_new(nodePtr,
+                        json_is_array(valueNodePtr) ? JSON_FIELD_CHILDREN : JSON_FIELD_VALUE,
+                        valueNodePtr);
+
+    return nodePtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Replace a job's batch records with the equivalent JSON text.  The first record is for the
+ *  exported node itself, with the node's name in place of the path.  The rest are the node's
+ *  children, depth first, with paths relative to the exported node.
+ *
+ *  @return LE_OK if the data was converted, LE_FAULT if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RecordsToJson
+(
+    TransferJob_t* jobPtr  ///< [IN] The job to convert the data of.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The children arrays of the current stem at each depth, so that each child can be added to
+    // its parent.  A stem's record always comes before the records of its children.
+    json_t* childArrays[MAX_EXPORT_DEPTH + 1];
+    json_t* rootPtr = NULL;
+
+    const char* recordPtr = jobPtr->dataPtr;
+    const char* dataEndPtr = jobPtr->dataPtr + jobPtr->dataSize;
+
+    while (recordPtr < dataEndPtr)
+    {
+        le_cfg_nodeType_t type = (uint8_t)recordPtr[0];
+        const char* pathPtr = recordPtr + 1;
+        const char* valuePtr = pathPtr + strlen(pathPtr) + 1;
+
+        recordPtr = valuePtr + strlen(valuePtr) + 1;
+
+        if (rootPtr == NULL)
+        {
+            // The node name is empty for the root of a tree, which the config tool exports as a
+            // "tree" rather than a "stem".
+            rootPtr = CreateJsonNode(type, pathPtr, valuePtr);
+
+            if (rootPtr == NULL)
+            {
+                rootPtr = json_object();
+            }
+            else if (type == LE_CFG_TYPE_STEM)
+            {
+                if (pathPtr[0] == '\0')
+                {
+                    json_object_set_new(rootPtr, JSON_FIELD_TYPE, json_string("tree"));
+                }
+
+                childArrays[0] = json_object_get(rootPtr, JSON_FIELD_CHILDREN);
+            }
+
+            continue;
+        }
+
+        size_t depth = 0;
+        const char* namePtr = pathPtr;
+        const char* separatorPtr;
+
+        while ((separatorPtr = strchr(namePtr, '/')) != NULL)
+        {
+            depth++;
+            namePtr = separatorPtr + 1;
+        }
+
+        json_t* nodePtr = CreateJsonNode(type, namePtr, valuePtr);
+
+        if (nodePtr == NULL)
+        {
+            LE_WARN("Skipping node '%s' in JSON export.", pathPtr);
+            continue;
+        }
+
+        json_array_append_new(childArrays[depth], nodePtr);
+
+        if (type == LE_CFG_TYPE_STEM)
+        {
+            childArrays[depth + 1] = json_object_get(nodePtr, JSON_FIELD_CHILDREN);
+        }
+    }
+
+    char* textPtr = json_dumps(rootPtr, JSON_COMPACT);
+    json_decref(rootPtr);
+
+    if (textPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    free(jobPtr->dataPtr);
+    jobPtr->dataPtr = textPtr;
+    jobPtr->dataSize = strlen(textPtr);
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Free a job, along with its data.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseJob
+(
+    TransferJob_t* jobPtr  ///< [IN] The job to free.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    free(jobPtr->dataPtr);
+    le_mem_Release(jobPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Make sure that none of the stems in a batch of JSON records would overwrite a value node.  The
+ *  config tool's own JSON import refuses to do that.
+ *
+ *  @return LE_OK if there are no conflicts, LE_NOT_POSSIBLE if there are.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckStemConflicts
+(
+    TransferJob_t* jobPtr  ///< [IN] The job to check the records of.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* recordPtr = jobPtr->dataPtr;
+    const char* dataEndPtr = jobPtr->dataPtr + jobPtr->dataSize;
+
+    while (recordPtr < dataEndPtr)
+    {
+        le_cfg_nodeType_t type = (uint8_t)recordPtr[0];
+        const char* pathPtr = recordPtr + 1;
+        const char* valuePtr = pathPtr + strlen(pathPtr) + 1;
+
+        recordPtr = valuePtr + strlen(valuePtr) + 1;
+
+        if (type != LE_CFG_TYPE_STEM)
+        {
+            continue;
+        }
+
+        switch (ni_GetNodeType(jobPtr->iteratorRef, pathPtr))
+        {
+            case LE_CFG_TYPE_DOESNT_EXIST:
+            case LE_CFG_TYPE_STEM:
+            case LE_CFG_TYPE_EMPTY:
+                break;
+
+            default:
+                LE_ERROR("Node conflict when importing, at node '%s'.", pathPtr);
+                return LE_NOT_POSSIBLE;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Main thread, last step of an import.  Write the data into the iterator's transaction and
+ *  respond to the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyImport
+(
+    void* param1Ptr,  ///< [IN] The job.
+    void* param2Ptr   ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TransferJob_t* jobPtr = param1Ptr;
+    le_result_t result = jobPtr->result;
+
+    if (   (result == LE_OK)
+        && (ni_IsRefStillValid(jobPtr->iteratorRef, jobPtr->externalRef) == false))
+    {
+        LE_ERROR("Iterator <%p> went away during import.", jobPtr->externalRef);
+        result = LE_FAULT;
+    }
+
+    if (result == LE_OK)
+    {
+        if (jobPtr->format == LE_CFGADMIN_FORMAT_JSON)
+        {
+            result = CheckStemConflicts(jobPtr);
+
+            if (result == LE_OK)
+            {
+                result = ni_SetBatch(jobPtr->iteratorRef,
+                                     (const uint8_t*)jobPtr->dataPtr,
+                                     jobPtr->dataSize);
+            }
+        }
+        else
+        {
+            tdb_NodeRef_t nodeRef = ni_TryCreateNode(jobPtr->iteratorRef, jobPtr->nodePath);
+
+            if (nodeRef == NULL)
+            {
+                result = LE_NOT_FOUND;
+            }
+            else if (tdb_ReadTreeNodeFromBuffer(nodeRef, jobPtr->dataPtr, jobPtr->dataSize) == false)
+            {
+                result = LE_FORMAT_ERROR;
+            }
+        }
+    }
+
+    le_cfgAdmin_ImportTreeFdRespond(jobPtr->commandRef, result);
+    ReleaseJob(jobPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Worker thread, first step of an import.  Read the descriptor, and convert JSON to batch records.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadImport
+(
+    void* param1Ptr,  ///< [IN] The job.
+    void* param2Ptr   ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TransferJob_t* jobPtr = param1Ptr;
+
+    jobPtr->result = ReadAll(jobPtr);
+    CloseFd(jobPtr->fd);
+
+    if (   (jobPtr->result == LE_OK)
+        && (jobPtr->format == LE_CFGADMIN_FORMAT_JSON))
+    {
+        jobPtr->result = JsonToRecords(jobPtr);
+    }
+
+    le_event_QueueFunctionToThread(MainThreadRef, ApplyImport, jobPtr, NULL);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Main thread, last step of an export.  Respond to the client.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishExport
+(
+    void* param1Ptr,  ///< [IN] The job.
+    void* param2Ptr   ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TransferJob_t* jobPtr = param1Ptr;
+
+    le_cfgAdmin_ExportTreeFdRespond(jobPtr->commandRef, jobPtr->result);
+    ReleaseJob(jobPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Worker thread, second step of an export.  Convert batch records to JSON, and write the
+ *  descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteExport
+(
+    void* param1Ptr,  ///< [IN] The job.
+    void* param2Ptr   ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TransferJob_t* jobPtr = param1Ptr;
+
+    if (jobPtr->format == LE_CFGADMIN_FORMAT_JSON)
+    {
+        jobPtr->result = RecordsToJson(jobPtr);
+    }
+
+    if (jobPtr->result == LE_OK)
+    {
+        jobPtr->result = WriteAll(jobPtr);
+    }
+
+    CloseFd(jobPtr->fd);
+
+    le_event_QueueFunctionToThread(MainThreadRef, FinishExport, jobPtr, NULL);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Copy a node, and all of its children, out of an iterator as batch records.  The node's own
+ *  record comes first, holding its name instead of a path.
+ *
+ *  @return LE_OK if the records were copied, LE_FAULT if memory ran out.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyExportRecords
+(
+    TransferJob_t* jobPtr  ///< [IN] The job to copy the records into.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ni_IteratorRef_t iteratorRef = jobPtr->iteratorRef;
+    const char* pathPtr = jobPtr->nodePath;
+
+    char nameBuffer[LE_CFG_NAME_LEN_BYTES] = "";
+    char valueBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    le_cfg_nodeType_t type = ni_GetNodeType(iteratorRef, pathPtr);
+
+    if (type != LE_CFG_TYPE_DOESNT_EXIST)
+    {
+        ni_GetNodeName(iteratorRef, pathPtr, nameBuffer, sizeof(nameBuffer));
+    }
+
+    if (type == LE_CFG_TYPE_BOOL)
+    {
+        strcpy(valueBuffer, ni_GetNodeValueBool(iteratorRef, pathPtr, false) ? "true" : "false");
+    }
+    else if (type != LE_CFG_TYPE_STEM)
+    {
+        ni_GetNodeValueString(iteratorRef, pathPtr, valueBuffer, sizeof(valueBuffer), "");
+    }
+
+    RecordBuffer_t records = { NULL, 0, 0 };
+
+    if (AppendRecord(&records, type, nameBuffer, valueBuffer) != LE_OK)
+    {
+        free(records.dataPtr);
+        return LE_FAULT;
+    }
+
+    // The children are appended after the node's record.  The buffer is grown until they all fit.
+    size_t rootSize = records.size;
+
+    while (type == LE_CFG_TYPE_STEM)
+    {
+        size_t subtreeSize = records.max - rootSize;
+
+        if (ni_GetSubtree(iteratorRef,
+                          pathPtr,
+                          (uint8_t*)records.dataPtr + rootSize,
+                          &subtreeSize) != LE_OVERFLOW)
+        {
+            records.size = rootSize + subtreeSize;
+            break;
+        }
+
+        if (GrowBuffer(&records.dataPtr, &records.max, records.max + 1) != LE_OK)
+        {
+            free(records.dataPtr);
+            return LE_FAULT;
+        }
+    }
+
+    jobPtr->dataPtr = records.dataPtr;
+    jobPtr->dataSize = records.size;
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The worker thread's main function.  It just runs an event loop, and the jobs are queued to it
+ *  as functions.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WorkerThreadMain
+(
+    void* contextPtr  ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sem_Post(WorkerReadySemRef);
+    le_event_RunLoop();
+
+    return NULL;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Allocate a new job for a request.
+ *
+ *  @return The new job.
+ */
+//--------------------------------------------------------------------------------------------------
+static TransferJob_t* NewJob
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to reply to the request.
+    ni_IteratorRef_t iteratorRef,           ///< [IN] The iterator to transfer with.
+    int fd,                                 ///< [IN] The client's descriptor.
+    const char* nodePathPtr,                ///< [IN] Path to the node to transfer.
+    le_cfgAdmin_Format_t format             ///< [IN] The format of the data.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TransferJob_t* jobPtr = le_mem_ForceAlloc(JobPool);
+
+    memset(jobPtr, 0, sizeof(TransferJob_t));
+
+    jobPtr->commandRef = commandRef;
+    jobPtr->iteratorRef = iteratorRef;
+    jobPtr->format = format;
+    jobPtr->fd = fd;
+    jobPtr->result = LE_OK;
+
+    le_utf8_Copy(jobPtr->nodePath, nodePathPtr, sizeof(jobPtr->nodePath), NULL);
+
+    return jobPtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Start the import/export worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void ie_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Initialize Import/Export subsystem.");
+
+    JobPool = le_mem_CreatePool(CFG_TRANSFER_JOB_POOL, sizeof(TransferJob_t));
+
+    MainThreadRef = le_thread_GetCurrent();
+    WorkerReadySemRef = le_sem_Create("cfgTransferReady", 0);
+    WorkerThreadRef = le_thread_Create("cfgTransfer", WorkerThreadMain, NULL);
+
+    le_thread_Start(WorkerThreadRef);
+    le_sem_Wait(WorkerReadySemRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Start importing a sub-tree from a file descriptor into a write iterator.  The response is sent
+ *  once the data has been read and applied to the iterator's transaction.
+ */
+//--------------------------------------------------------------------------------------------------
+void ie_ImportTree
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to reply to this request.
+    ni_IteratorRef_t iteratorRef,           ///< [IN] The iterator to import into.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] The client's reference to the iterator.
+    int fd,                                 ///< [IN] The descriptor to read.  It's closed once
+                                            ///<      read.
+    const char* nodePathPtr,                ///< [IN] Path to the node to import into.
+    le_cfgAdmin_Format_t format             ///< [IN] The format of the data.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TransferJob_t* jobPtr = NewJob(commandRef, iteratorRef, fd, nodePathPtr, format);
+
+    jobPtr->externalRef = externalRef;
+
+    le_event_QueueFunctionToThread(WorkerThreadRef, ReadImport, jobPtr, NULL);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Start exporting a sub-tree to a file descriptor.  The sub-tree is copied out of the iterator
+ *  right away, and the response is sent once it has been written.
+ */
+//--------------------------------------------------------------------------------------------------
+void ie_ExportTree
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to reply to this request.
+    ni_IteratorRef_t iteratorRef,           ///< [IN] The iterator to export from.
+    int fd,                                 ///< [IN] The descriptor to write.  It's closed once
+                                            ///<      written.
+    const char* nodePathPtr,                ///< [IN] Path to the node to export.
+    le_cfgAdmin_Format_t format             ///< [IN] The format to write.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TransferJob_t* jobPtr = NewJob(commandRef, iteratorRef, fd, nodePathPtr, format);
+
+    if (format == LE_CFGADMIN_FORMAT_JSON)
+    {
+        jobPtr->result = CopyExportRecords(jobPtr);
+    }
+    else
+    {
+        // Like ExportTree, a node that doesn't exist is written out as a deleted node.
+        if (tdb_WriteTreeNodeToBuffer(ni_GetNode(iteratorRef, nodePathPtr),
+                                      &jobPtr->dataPtr,
+                                      &jobPtr->dataSize) != LE_OK)
+        {
+            jobPtr->result = LE_FAULT;
+        }
+    }
+
+    // The iterator isn't touched again, so the job doesn't need it any more.
+    jobPtr->iteratorRef = NULL;
+
+    if (jobPtr->result != LE_OK)
+    {
+        CloseFd(fd);
+        FinishExport(jobPtr, NULL);
+        return;
+    }
+
+    le_event_QueueFunctionToThread(WorkerThreadRef, WriteExport, jobPtr, NULL);
+}
@@ -0,0 +1,72 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  @file importExport.h
+ *
+ *  Bulk import and export of config sub-trees through a file descriptor passed in by the client.
+ *  Reading, writing, and JSON parsing and formatting are done on a worker thread, the tree itself
+ *  is only ever touched from the main thread.
+ *
+ *  Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ *  Use of this work is subject to license.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef CFG_IMPORT_EXPORT_INCLUDE_GUARD
+#define CFG_IMPORT_EXPORT_INCLUDE_GUARD
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Start the import/export worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void ie_Init
+(
+    void
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Start importing a sub-tree from a file descriptor into a write iterator.  The response is sent
+ *  once the data has been read and applied to the iterator's transaction.
+ */
+//--------------------------------------------------------------------------------------------------
+void ie_ImportTree
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to reply to this request.
+    ni_IteratorRef_t iteratorRef,           ///< [IN] The iterator to import into.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] The client's reference to the iterator.
+    int fd,                                 ///< [IN] The descriptor to read.  It's closed once
+                                            ///<      read.
+    const char* nodePathPtr,                ///< [IN] Path to the node to import into.
+    le_cfgAdmin_Format_t format             ///< [IN] The format of the data.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Start exporting a sub-tree to a file descriptor.  The sub-tree is copied out of the iterator
+ *  right away, and the response is sent once it has been written.
+ */
+//--------------------------------------------------------------------------------------------------
+void ie_ExportTree
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to reply to this request.
+    ni_IteratorRef_t iteratorRef,           ///< [IN] The iterator to export from.
+    int fd,                                 ///< [IN] The descriptor to write.  It's closed once
+                                            ///<      written.
+    const char* nodePathPtr,                ///< [IN] Path to the node to export.
+    le_cfgAdmin_Format_t format             ///< [IN] The format to write.
+);
+
+
+
+
+#endif
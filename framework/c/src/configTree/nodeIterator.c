@@ -16,6 +16,7 @@
 #include "treeUser.h"
 #include "internalConfig.h"
 #include "nodeIterator.h"
+#include "treePath.h"
 
 
 
@@ -212,6 +213,412 @@ static le_result_t CloneAndAppendPath
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a node's batch record to a buffer.  The record is made up of the node's type, followed by
+ *  its path and its value as NULL terminated strings.
+ *
+ *  @return LE_OK if the record was added, LE_OVERFLOW if it doesn't fit in the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AppendBatchRecord
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN]     The node to write a record for.
+    const char* pathPtr,    ///< [IN]     The node's path relative to the base of the batch.
+    uint8_t* bufferPtr,     ///< [IN]     The buffer to write the record to.
+    size_t bufferMax,       ///< [IN]     The size of the buffer.
+    size_t* bufferUsedPtr   ///< [IN/OUT] How much of the buffer has been filled so far.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char valueBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+
+    // Booleans are stored internally as "t" and "f", so spell them out the way the config tool
+    // does.
+    if (type == LE_CFG_TYPE_BOOL)
+    {
+        le_utf8_Copy(valueBuffer,
+                     tdb_GetValueAsBool(nodeRef, false) ? "true" : "false",
+                     sizeof(valueBuffer),
+                     NULL);
+    }
+    else
+    {
+        tdb_GetValueAsString(nodeRef, valueBuffer, sizeof(valueBuffer), "");
+    }
+
+    size_t pathSize = strlen(pathPtr) + 1;
+    size_t valueSize = strlen(valueBuffer) + 1;
+    size_t recordSize = 1 + pathSize + valueSize;
+
+    if (*bufferUsedPtr + recordSize > bufferMax)
+    {
+        return LE_OVERFLOW;
+    }
+
+    uint8_t* recordPtr = bufferPtr + *bufferUsedPtr;
+
+    recordPtr[0] = (uint8_t)type;
+    memcpy(recordPtr + 1, pathPtr, pathSize);
+    memcpy(recordPtr + 1 + pathSize, valueBuffer, valueSize);
+
+    *bufferUsedPtr += recordSize;
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append the batch records of all of the active children of a node, depth first.
+ *
+ *  @return LE_OK if all of the records were added, LE_OVERFLOW if they don't fit in the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AppendSubtreeRecords
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN]     The node whose children are being written.
+    char* pathPtr,          ///< [IN]     Buffer holding the relative path of the node.  Children's
+                            ///<          paths are built up in this buffer.
+    size_t pathLen,         ///< [IN]     Length of the node's relative path.
+    uint8_t* bufferPtr,     ///< [IN]     The buffer to write the records to.
+    size_t bufferMax,       ///< [IN]     The size of the buffer.
+    size_t* bufferUsedPtr   ///< [IN/OUT] How much of the buffer has been filled so far.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+    while (   (childRef != NULL)
+           && (result == LE_OK))
+    {
+        size_t childPathLen = pathLen;
+
+        if (childPathLen > 0)
+        {
+            pathPtr[childPathLen] = '/';
+            childPathLen++;
+        }
+
+        if (   (childPathLen >= LE_CFG_STR_LEN_BYTES)
+            || (tdb_GetNodeName(childRef,
+                                pathPtr + childPathLen,
+                                LE_CFG_STR_LEN_BYTES - childPathLen) != LE_OK))
+        {
+            result = LE_OVERFLOW;
+            break;
+        }
+
+        childPathLen += strlen(pathPtr + childPathLen);
+
+        result = AppendBatchRecord(childRef, pathPtr, bufferPtr, bufferMax, bufferUsedPtr);
+
+        if (   (result == LE_OK)
+            && (tdb_GetNodeType(childRef) == LE_CFG_TYPE_STEM))
+        {
+            result = AppendSubtreeRecords(childRef,
+                                          pathPtr,
+                                          childPathLen,
+                                          bufferPtr,
+                                          bufferMax,
+                                          bufferUsedPtr);
+        }
+
+        pathPtr[pathLen] = '\0';
+        childRef = tdb_GetNextActiveSiblingNode(childRef);
+    }
+
+    return result;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Parse the value of an integer batch record.
+ *
+ *  @return LE_OK if the value is a decimal integer that fits in 32 bits, LE_FORMAT_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseBatchInt
+(
+    const char* valuePtr,  ///< [IN]  The value as a string.
+    int32_t* intPtr        ///< [OUT] The parsed value.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char* endPtr = NULL;
+
+    errno = 0;
+    long value = strtol(valuePtr, &endPtr, 10);
+
+    if (   (valuePtr[0] == '\0')
+        || (*endPtr != '\0')
+        || (errno != 0)
+        || (value < INT32_MIN)
+        || (value > INT32_MAX))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    *intPtr = (int32_t)value;
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Parse the value of a floating point batch record.
+ *
+ *  @return LE_OK if the value is a decimal number, LE_FORMAT_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseBatchFloat
+(
+    const char* valuePtr,  ///< [IN]  The value as a string.
+    double* floatPtr       ///< [OUT] The parsed value.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char* endPtr = NULL;
+
+    errno = 0;
+    double value = strtod(valuePtr, &endPtr);
+
+    if (   (valuePtr[0] == '\0')
+        || (*endPtr != '\0')
+        || (errno != 0))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    *floatPtr = value;
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Parse the value of a boolean batch record.
+ *
+ *  @return LE_OK if the value is "true" or "false", LE_FORMAT_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseBatchBool
+(
+    const char* valuePtr,  ///< [IN]  The value as a string.
+    bool* boolPtr          ///< [OUT] The parsed value.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (strcmp(valuePtr, "true") == 0)
+    {
+        *boolPtr = true;
+    }
+    else if (strcmp(valuePtr, "false") == 0)
+    {
+        *boolPtr = false;
+    }
+    else
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Find the parts of the batch record at the given position in a buffer, and check that the record
+ *  can be applied to the tree: its path and value have to fit in the tree's limits, and its value
+ *  has to match its type.
+ *
+ *  @return LE_OK if the record is well formed, LE_FORMAT_ERROR if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseBatchRecord
+(
+    const char* recordPtr,        ///< [IN]  The start of the record.
+    const char* bufferEndPtr,     ///< [IN]  The end of the buffer holding the record.
+    le_cfg_nodeType_t* typePtr,   ///< [OUT] The type of the record.
+    const char** pathPtrPtr,      ///< [OUT] The path in the record.
+    const char** valuePtrPtr,     ///< [OUT] The value in the record.
+    const char** nextRecordPtrPtr ///< [OUT] The start of the next record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_cfg_nodeType_t type = (uint8_t)recordPtr[0];
+    const char* pathPtr = recordPtr + 1;
+    const char* pathEndPtr = memchr(pathPtr, '\0', bufferEndPtr - pathPtr);
+
+    if (pathEndPtr == NULL)
+    {
+        LE_ERROR("Batch record is truncated.");
+        return LE_FORMAT_ERROR;
+    }
+
+    const char* valuePtr = pathEndPtr + 1;
+    const char* valueEndPtr = memchr(valuePtr, '\0', bufferEndPtr - valuePtr);
+
+    if (valueEndPtr == NULL)
+    {
+        LE_ERROR("Batch record is truncated.");
+        return LE_FORMAT_ERROR;
+    }
+
+    if ((pathEndPtr - pathPtr) > LE_CFG_STR_LEN)
+    {
+        LE_ERROR("Batch record path is too long.");
+        return LE_FORMAT_ERROR;
+    }
+
+    if ((valueEndPtr - valuePtr) > LE_CFG_STR_LEN)
+    {
+        LE_ERROR("Batch record value for '%s' is too long.", pathPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    if (tp_PathHasTreeSpecifier(pathPtr))
+    {
+        LE_ERROR("Batch record path '%s' can not change trees.", pathPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    const char* namePtr = pathPtr;
+
+    while (*namePtr != '\0')
+    {
+        size_t nameLen = strcspn(namePtr, "/");
+
+        if (nameLen > LE_CFG_NAME_LEN)
+        {
+            LE_ERROR("Batch record path '%s' has a node name that is too long.", pathPtr);
+            return LE_FORMAT_ERROR;
+        }
+
+        namePtr += nameLen;
+        namePtr += strspn(namePtr, "/");
+    }
+
+    le_result_t result;
+    int32_t intValue;
+    double floatValue;
+    bool boolValue;
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+        case LE_CFG_TYPE_STEM:
+            result = LE_OK;
+            break;
+
+        case LE_CFG_TYPE_INT:
+            result = ParseBatchInt(valuePtr, &intValue);
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            result = ParseBatchFloat(valuePtr, &floatValue);
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            result = ParseBatchBool(valuePtr, &boolValue);
+            break;
+
+        default:
+            result = LE_FORMAT_ERROR;
+            break;
+    }
+
+    if (result != LE_OK)
+    {
+        LE_ERROR("Bad batch record for '%s', type %d, value '%s'.", pathPtr, type, valuePtr);
+        return result;
+    }
+
+    *typePtr = type;
+    *pathPtrPtr = pathPtr;
+    *valuePtrPtr = valuePtr;
+    *nextRecordPtrPtr = valueEndPtr + 1;
+
+    return LE_OK;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Apply one batch record to the tree.  The record must have been checked by ParseBatchRecord().
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyBatchRecord
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] The iterator to write with.
+    le_cfg_nodeType_t type,        ///< [IN] The type of value to write.
+    const char* pathPtr,           ///< [IN] Path to the node, relative to the iterator.
+    const char* valuePtr           ///< [IN] The value to write, as a string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int32_t intValue;
+    double floatValue;
+    bool boolValue;
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_STRING:
+            ni_SetNodeValueString(iteratorRef, pathPtr, valuePtr);
+            break;
+
+        case LE_CFG_TYPE_INT:
+            LE_ASSERT(ParseBatchInt(valuePtr, &intValue) == LE_OK);
+            ni_SetNodeValueInt(iteratorRef, pathPtr, intValue);
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            LE_ASSERT(ParseBatchFloat(valuePtr, &floatValue) == LE_OK);
+            ni_SetNodeValueFloat(iteratorRef, pathPtr, floatValue);
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            LE_ASSERT(ParseBatchBool(valuePtr, &boolValue) == LE_OK);
+            ni_SetNodeValueBool(iteratorRef, pathPtr, boolValue);
+            break;
+
+        case LE_CFG_TYPE_EMPTY:
+            ni_SetEmpty(iteratorRef, pathPtr);
+            break;
+
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            ni_DeleteNode(iteratorRef, pathPtr);
+            break;
+
+        case LE_CFG_TYPE_STEM:
+            ni_TryCreateNode(iteratorRef, pathPtr);
+            break;
+
+        default:
+            LE_FATAL("Unexpected batch record type %d.", type);
+    }
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Init the node iterator subsystem and get it ready for use by the other subsystems in this
@@ -375,6 +782,29 @@ ni_IteratorRef_t ni_InternalRefFromExternalRef
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check that an external reference still refers to the given iterator.  Requests that finish
+ *  after a round trip through another thread use this, as the iterator may have been released, or
+ *  closed by a timeout, in the meantime.
+ *
+ *  @return True if the reference still refers to the iterator, false if not.
+ */
+//--------------------------------------------------------------------------------------------------
+bool ni_IsRefStillValid
+(
+    ni_IteratorRef_t iteratorRef,     ///< [IN] The iterator the reference used to refer to.
+    le_cfg_IteratorRef_t externalRef  ///< [IN] The reference to check.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Closing an iterator deletes its reference, so this also catches closed iterators.
+    return le_ref_Lookup(IteratorRefMap, externalRef) == iteratorRef;
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Commit the changes introduced by an iterator to the config tree.
@@ -443,10 +873,7 @@ void ni_Release
  *  Close an iterator object and invalidate it's external safe reference.  (If there is one.)  Once
  *  done, this iterator is no longer accessable from outside of the process.
  *
- *  An iterator is closed with out releasing in the case where you have an open write iterator on a
- *  tree with open reads.  The iterator is closed, but it's data is not yet mergable into the tree.
- *
- *  So, the iterator is marked as closed and it's external ref is invalidated so no more work can be
+ *  The iterator is marked as closed and it's external ref is invalidated so no more work can be
  *  done with that iterator.
  */
 //--------------------------------------------------------------------------------------------------
@@ -608,6 +1035,46 @@ void ni_ForEachIter
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Move all of the read iterators on one tree over to another, such as a snapshot of the original
+ *  tree.  Each iterator stays on the same path, but in the new tree.  The trees' iterator counts
+ *  are not updated, that is left to the caller.
+ *
+ *  @return The number of iterators that were moved.
+ */
+// -------------------------------------------------------------------------------------------------
+size_t ni_MoveReadIterators
+(
+    tdb_TreeRef_t fromTreeRef,  ///< [IN] Move the read iterators off of this tree.
+    tdb_TreeRef_t toTreeRef     ///< [IN] The tree to move them to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t count = 0;
+    le_ref_IterRef_t refIterator = le_ref_GetIterator(IteratorRefMap);
+
+    while (le_ref_NextNode(refIterator) == LE_OK)
+    {
+        ni_IteratorRef_t iteratorRef = (ni_IteratorRef_t)le_ref_GetValue(refIterator);
+
+        if (   (iteratorRef != NULL)
+            && (iteratorRef->type == NI_READ)
+            && (iteratorRef->treeRef == fromTreeRef))
+        {
+            iteratorRef->treeRef = toTreeRef;
+            iteratorRef->currentNodeRef = tdb_GetNode(tdb_GetRootNode(toTreeRef),
+                                                      iteratorRef->pathIterRef);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Move the iterator to a different node in the current tree.
@@ -1131,6 +1598,8 @@ le_result_t ni_GetNodeValueString
 //--------------------------------------------------------------------------------------------------
 /**
  *  Write a string value into the config tree.
+ *
+ *  @note   This function will terminate the client if the value is too long.
  */
 //--------------------------------------------------------------------------------------------------
 void ni_SetNodeValueString
@@ -1143,9 +1612,11 @@ void ni_SetNodeValueString
 {
     tdb_NodeRef_t nodeRef = ni_TryCreateNode(iteratorRef, pathPtr);
 
-    if (nodeRef)
+    if (   (nodeRef)
+        && (tdb_SetValueAsString(nodeRef, valuePtr) != LE_OK))
     {
-        tdb_SetValueAsString(nodeRef, valuePtr);
+        iteratorRef->isTerminated = true;
+        tu_TerminateConfigClient(iteratorRef->sessionRef, "Specified value too large.");
     }
 }
 
@@ -1309,3 +1780,98 @@ void ni_SetNodeValueBool
         tdb_SetValueAsBool(nodeRef, value);
     }
 }
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read the batch records of all of the nodes below a given node.
+ *
+ *  @return LE_OK if the whole subtree was read, LE_OVERFLOW if it doesn't fit in the buffer.  In
+ *          that case the buffer holds as many whole records as would fit.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ni_GetSubtree
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN]     The iterator object to access.
+    const char* pathPtr,           ///< [IN]     Optional path to another node in the tree.
+    uint8_t* bufferPtr,            ///< [OUT]    The buffer to write the records to.
+    size_t* bufferSizePtr          ///< [IN/OUT] The size of the buffer on the way in, and the size
+                                   ///<          of the records written on the way out.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t bufferMax = *bufferSizePtr;
+    tdb_NodeRef_t nodeRef = ni_GetNode(iteratorRef, pathPtr);
+
+    *bufferSizePtr = 0;
+
+    if (nodeRef == NULL)
+    {
+        return LE_OK;
+    }
+
+    char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    return AppendSubtreeRecords(nodeRef, pathBuffer, 0, bufferPtr, bufferMax, bufferSizePtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Apply a buffer of batch records to the tree, in order.  All of the records are checked before
+ *  any of them are applied.
+ *
+ *  @return LE_OK if all of the records were applied, LE_FORMAT_ERROR if a record is malformed.  In
+ *          that case none of the records are applied.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ni_SetBatch
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] The iterator object to access.
+    const uint8_t* bufferPtr,      ///< [IN] The records to apply.
+    size_t bufferSize              ///< [IN] The size of the records.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* bufferEndPtr = (const char*)bufferPtr + bufferSize;
+    const char* recordPtr;
+    le_cfg_nodeType_t type;
+    const char* pathPtr;
+    const char* valuePtr;
+
+    // Check the whole batch first, so that a bad record doesn't leave the transaction half written.
+    recordPtr = (const char*)bufferPtr;
+
+    while (recordPtr < bufferEndPtr)
+    {
+        if (ParseBatchRecord(recordPtr,
+                             bufferEndPtr,
+                             &type,
+                             &pathPtr,
+                             &valuePtr,
+                             &recordPtr) != LE_OK)
+        {
+            return LE_FORMAT_ERROR;
+        }
+    }
+
+    recordPtr = (const char*)bufferPtr;
+
+    while (recordPtr < bufferEndPtr)
+    {
+        LE_ASSERT(ParseBatchRecord(recordPtr,
+                                   bufferEndPtr,
+                                   &type,
+                                   &pathPtr,
+                                   &valuePtr,
+                                   &recordPtr) == LE_OK);
+
+        ApplyBatchRecord(iteratorRef, type, pathPtr, valuePtr);
+    }
+
+    return LE_OK;
+}
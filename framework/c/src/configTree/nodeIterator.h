@@ -115,6 +115,24 @@ ni_IteratorRef_t ni_InternalRefFromExternalRef
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check that an external reference still refers to the given iterator.  Requests that finish
+ *  after a round trip through another thread use this, as the iterator may have been released, or
+ *  closed by a timeout, in the meantime.
+ *
+ *  @return True if the reference still refers to the iterator, false if not.
+ */
+//--------------------------------------------------------------------------------------------------
+bool ni_IsRefStillValid
+(
+    ni_IteratorRef_t iteratorRef,     ///< [IN] The iterator the reference used to refer to.
+    le_cfg_IteratorRef_t externalRef  ///< [IN] The reference to check.
+);
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Commit the changes introduced by an iterator to the config tree.
@@ -147,10 +165,7 @@ void ni_Release
  *  Close an iterator object and invalidate it's external safe reference.  (If there is one.)  Once
  *  done, this iterator is no longer accessable from outside of the process.
  *
- *  An iterator is closed with out releasing in the case where you have an open write iterator on a
- *  tree with open reads.  The iterator is closed, but it's data is not yet mergable into the tree.
- *
- *  So, the iterator is marked as closed and it's external ref is invalidated so no more work can be
+ *  The iterator is marked as closed and it's external ref is invalidated so no more work can be
  *  done with that iterator.
  */
 //--------------------------------------------------------------------------------------------------
@@ -254,6 +269,24 @@ void ni_ForEachIter
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Move all of the read iterators on one tree over to another, such as a snapshot of the original
+ *  tree.  Each iterator stays on the same path, but in the new tree.  The trees' iterator counts
+ *  are not updated, that is left to the caller.
+ *
+ *  @return The number of iterators that were moved.
+ */
+// -------------------------------------------------------------------------------------------------
+size_t ni_MoveReadIterators
+(
+    tdb_TreeRef_t fromTreeRef,  ///< [IN] Move the read iterators off of this tree.
+    tdb_TreeRef_t toTreeRef     ///< [IN] The tree to move them to.
+);
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Move the iterator to a different node in the current tree.
@@ -499,6 +532,8 @@ le_result_t ni_GetNodeValueString
 //--------------------------------------------------------------------------------------------------
 /**
  *  Write a string value into the config tree.
+ *
+ *  @note   This function will terminate the client if the value is too long.
  */
 //--------------------------------------------------------------------------------------------------
 void ni_SetNodeValueString
@@ -612,4 +647,43 @@ void ni_SetNodeValueBool
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read the batch records of all of the nodes below a given node.
+ *
+ *  @return LE_OK if the whole subtree was read, LE_OVERFLOW if it doesn't fit in the buffer.  In
+ *          that case the buffer holds as many whole records as would fit.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ni_GetSubtree
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN]     The iterator object to access.
+    const char* pathPtr,           ///< [IN]     Optional path to another node in the tree.
+    uint8_t* bufferPtr,            ///< [OUT]    The buffer to write the records to.
+    size_t* bufferSizePtr          ///< [IN/OUT] The size of the buffer on the way in, and the size
+                                   ///<          of the records written on the way out.
+);
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Apply a buffer of batch records to the tree, in order.  All of the records are checked before
+ *  any of them are applied.
+ *
+ *  @return LE_OK if all of the records were applied, LE_FORMAT_ERROR if a record is malformed.  In
+ *          that case none of the records are applied.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ni_SetBatch
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] The iterator object to access.
+    const uint8_t* bufferPtr,      ///< [IN] The records to apply.
+    size_t bufferSize              ///< [IN] The size of the records.
+);
+
+
+
+
 #endif
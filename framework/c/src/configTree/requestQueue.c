@@ -43,8 +43,6 @@ typedef enum
     RQ_INVALID,
 
     RQ_CREATE_WRITE_TXN,
-    RQ_COMMIT_WRITE_TXN,
-    RQ_CREATE_READ_TXN,
     RQ_DELETE_TXN,
 
     RQ_DELETE_NODE,
@@ -84,12 +82,6 @@ typedef struct UpdateRequest
         }
         createTxn;                               ///< Create new transaction info.
 
-        struct
-        {
-            ni_IteratorRef_t iteratorRef;        ///< Ptr to the iterator to commit.
-        }
-        commitTxn;
-
         struct
         {
             ni_IteratorRef_t iteratorRef;        ///< Ptr to the iterator to commit.
@@ -210,7 +202,7 @@ static void QueueRequest
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Queue a create transaction request.
+ *  Queue a create write transaction request.
  */
 // -------------------------------------------------------------------------------------------------
 static void QueueCreateTxnRequest
@@ -219,13 +211,15 @@ static void QueueCreateTxnRequest
     tdb_TreeRef_t treeRef,             ///< [IN] The tree we're working on.
     le_msg_SessionRef_t sessionRef,    ///< [IN] The user session this request occured on.
     le_cfg_ServerCmdRef_t commandRef,  ///< [IN] Context for this request.
-    ni_IteratorType_t iteratorType,    ///< [IN] The kind of iterator to create.
     const char* basePathPtr            ///< [IN] The initial path for the iterator.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    RequestType_t type = iteratorType == NI_READ ? RQ_CREATE_READ_TXN : RQ_CREATE_WRITE_TXN;
-    UpdateRequest_t* requestPtr = NewRequestBlock(type, userRef, treeRef, sessionRef, commandRef);
+    UpdateRequest_t* requestPtr = NewRequestBlock(RQ_CREATE_WRITE_TXN,
+                                                  userRef,
+                                                  treeRef,
+                                                  sessionRef,
+                                                  commandRef);
 
     LE_ASSERT(le_utf8_Copy(requestPtr->data.createTxn.pathPtr,
                            basePathPtr,
@@ -329,30 +323,6 @@ static void ProcessRequestQueue
                                               requestPtr->data.createTxn.pathPtr);
                     break;
 
-                case RQ_COMMIT_WRITE_TXN:
-                    LE_DEBUG("Committing deferred write txn for user %u (%s) on tree '%s'.",
-                             tu_GetUserId(requestPtr->userRef),
-                             tu_GetUserName(requestPtr->userRef),
-                             tdb_GetTreeName(requestPtr->treeRef));
-
-                    rq_HandleCommitTxnRequest(requestPtr->commandRef,
-                                              requestPtr->data.commitTxn.iteratorRef);
-                    break;
-
-               case RQ_CREATE_READ_TXN:
-                    LE_DEBUG("Starting deferred read txn for user %u (%s) on tree '%s'.",
-                             tu_GetUserId(requestPtr->userRef),
-                             tu_GetUserName(requestPtr->userRef),
-                             tdb_GetTreeName(requestPtr->treeRef));
-
-                    rq_HandleCreateTxnRequest(requestPtr->userRef,
-                                              requestPtr->treeRef,
-                                              requestPtr->sessionRef,
-                                              requestPtr->commandRef,
-                                              NI_READ,
-                                              requestPtr->data.createTxn.pathPtr);
-                    break;
-
                 case RQ_DELETE_TXN:
                     LE_DEBUG("Handling deferred iterator delete for user %u (%s) on tree '%s'.",
                              tu_GetUserId(requestPtr->userRef),
@@ -471,14 +441,9 @@ static bool CanQuickSet
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If there are active readers or writers on the tree then a quick write should be defered.
-    if (   (tdb_HasActiveReaders(treeRef) == false)
-        && (tdb_GetActiveWriteIter(treeRef) == NULL))
-    {
-        return true;
-    }
-
-    return false;
+    // If there is an active writer on the tree then a quick write should be defered.  Active
+    // readers don't matter, they are moved to a snapshot of the tree when it's changed.
+    return tdb_GetActiveWriteIter(treeRef) == NULL;
 }
 
 
@@ -557,7 +522,9 @@ void rq_CleanUpForSession
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a transaction.  If it can not be crated now, queue it for later.
+ *  Create a transaction.  If it can not be crated now, queue it for later.  Only write transactions
+ *  are ever queued, as there can only be one of them on a tree at a time.  Read transactions are
+ *  always created right away.
  */
 // -------------------------------------------------------------------------------------------------
 void rq_HandleCreateTxnRequest
@@ -571,18 +538,10 @@ void rq_HandleCreateTxnRequest
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ni_IteratorRef_t writeIteratorRef = tdb_GetActiveWriteIter(treeRef);
-
-    if (   (iterType == NI_READ)
-        && (writeIteratorRef != NULL)
-        && (ni_IsClosed(writeIteratorRef)))
+    if (   (iterType == NI_WRITE)
+        && (tdb_GetActiveWriteIter(treeRef) != NULL))
     {
-        QueueCreateTxnRequest(userRef, treeRef, sessionRef, commandRef, iterType, pathPtr);
-    }
-    else if (   (iterType == NI_WRITE)
-             && (writeIteratorRef != NULL))
-    {
-        QueueCreateTxnRequest(userRef, treeRef, sessionRef, commandRef, iterType, pathPtr);
+        QueueCreateTxnRequest(userRef, treeRef, sessionRef, commandRef, pathPtr);
     }
     else
     {
@@ -613,7 +572,9 @@ void rq_HandleCreateTxnRequest
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Attempt to commit an outstanding write transaction.
+ *  Commit an outstanding write transaction.  The commit happens right away, even if there are read
+ *  transactions open on the tree, because those reads are moved to a snapshot of the tree as it was
+ *  before the commit.
  */
 // -------------------------------------------------------------------------------------------------
 void rq_HandleCommitTxnRequest
@@ -631,7 +592,7 @@ void rq_HandleCommitTxnRequest
         le_cfg_CommitTxnRespond(commandRef);
         ProcessRequestQueue(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), NULL);
     }
-    else if (tdb_HasActiveReaders(ni_GetTree(iteratorRef)) == false)
+    else
     {
         ni_Close(iteratorRef);
         ni_Commit(iteratorRef);
@@ -640,17 +601,6 @@ void rq_HandleCommitTxnRequest
         le_cfg_CommitTxnRespond(commandRef);
         ProcessRequestQueue(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), NULL);
     }
-    else
-    {
-        UpdateRequest_t* requestPtr = NewRequestBlock(RQ_COMMIT_WRITE_TXN,
-                                                      ni_GetUser(iteratorRef),
-                                                      ni_GetTree(iteratorRef),
-                                                      ni_GetSession(iteratorRef),
-                                                      commandRef);
-
-        requestPtr->data.commitTxn.iteratorRef = iteratorRef;
-        QueueRequest(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), requestPtr);
-    }
 }
 
 
@@ -32,7 +32,12 @@
  *
  *  Each Tree object has a single "root" Node.
  *
- *  Each Node can have either a value or a list of child Nodes.
+ *  Each Node can have either a value or a list of child Nodes.  Stems with many children also get
+ *  a Child Index, a hash table that maps child names to child Nodes, so that looking up a child by
+ *  name doesn't have to walk the whole child list.  The index is built the first time a lookup
+ *  has to walk past CHILD_INDEX_THRESHOLD children, and from then on it is kept up to date as
+ *  children are named, renamed, added and removed.  It is released once it has no children left
+ *  in it.
  *
  *  When a write transaction is started for a Tree, the iterator reference for that transaction
  *  is recorded in the Tree object.  When the transaction is committed or cancelled, that reference
@@ -41,10 +46,16 @@
  *  When a read transaction is started for a Tree, the count of read iterators in that Tree is
  *  incremented.  When it ends, the count is decremented.
  *
+ *  When a change is merged into a Tree that has read transactions in progress, the Tree's nodes
+ *  are first copied into a "Snapshot" Tree and the read iterators are moved over to it.  That way
+ *  the readers keep seeing the Tree as it was when they started, and the change doesn't have to
+ *  wait for them to finish.  The Snapshot isn't part of the Tree Collection, and is freed when the
+ *  last of its read iterators is released.
+ *
  *  When client requests are received that cannot be processed immediately, because of the state
- *  of the tree the request is for (e.g., if a write transaction commit request is received while
- *  there are read transactions in progress on the tree), then the request is queued onto the tree's
- *  Request Queue.
+ *  of the tree the request is for (e.g., if a write transaction is requested while another write
+ *  transaction is in progress on the tree), then the request is queued onto the tree's Request
+ *  Queue.
  *
  *  <b>Shadow Trees:</b>
  *
@@ -60,6 +71,10 @@
  *  tree.  When nodes are deleted, the shadow node is marked "deleted".
  *
  *  When a write transaction is cancelled, the shadow tree and all its shadow nodes are discarded.
+ *  The nodes of a shadow tree, along with their strings and child indexes, are allocated from an
+ *  arena that belongs to the tree, so discarding the tree frees all of them in one operation.
+ *  Snapshot trees are allocated the same way.  The nodes of the original trees still come from
+ *  memory pools, because they're added and removed one at a time for as long as the tree lives.
  *
  *  When a write transaction is committed, the shadow tree is traversed, and any changes found
  *  in it are applied to the "original" tree that the shadow tree was shadowing.  This process is
@@ -80,7 +95,10 @@
  *  @verbatim system:/apps @endverbatim
  *
  *  For each unique path a registration object is created, and that registration object will hold a
- *  list of event handlers for the node.
+ *  list of event handlers for the node.  The registration objects are also linked together into a
+ *  trie that follows the paths, one level per node name.  A registration object is created for each
+ *  node on the way down to a watched node, (with an empty handler list if nothing is registered on
+ *  that node itself,) and the root of each tree's trie is the registration for the path "tree:".
  *
  * @verbatim
 
@@ -113,13 +131,43 @@
  *  The system also employs the use of SafeRefs to keep track of each registered handler so that a
  *  handler can quickly and easily remove a handler as required.
  *
- *  When a merge occurs each modified node path is checked against the registration map.  If there
- *  is a registration object for that node each of the registered handlers is invoked.
+ *  When a merge occurs, the trie is walked down alongside the shadow tree.  If there is a
+ *  registration object for a modified node, it is queued to have its handlers invoked once the merge
+ *  is done.  Once the walk leaves the trie, there's nothing more to look up below that node.  When a
+ *  subtree is deleted or renamed, only the branches of the trie under it are visited, looking up the
+ *  matching nodes by name.  So the cost of dispatching handlers depends on the number of
+ *  registrations that match, not on the number of nodes that were changed.
  *
  *  Handlers are registered in this hash map so that the target node doesn't need to actually exist
  *  in order to have a handler registed for it.  In fact, a handler will be called when a node is
  *  deleted and when it is recreated.
  *
+ *  <b>Persistence:</b>
+ *
+ *  Each tree is stored in the filesystem as a tree file plus a journal.  The tree file holds a full
+ *  snapshot of the tree, and is named after one of three rotating revisions, "paper", "rock" and
+ *  "scissors".  The journal, "<tree>.journal", holds the changes that have been committed since
+ *  that snapshot was written.
+ *
+ *  When a write transaction is merged, the paths and new contents of the changed nodes (or the
+ *  paths of the deleted nodes) are appended to the journal as a single checksummed entry.  So the
+ *  cost of a commit depends on the size of the change, not on the size of the tree.  Once the
+ *  journal has grown bigger than the snapshot (or JOURNAL_MIN_COMPACT_BYTES, whichever is bigger,)
+ *  a timer is started.  When it expires, the tree is compacted, that is a new snapshot is written
+ *  to the next revision's tree file, then the old tree file and the journal are deleted.
+ *
+ *  Snapshots are written in a compact binary format: a small header, followed by an array of fixed
+ *  size node records in depth first order, followed by a table of the NULL terminated node names
+ *  and values.  The records refer to their strings by offset, so the loader can map the file into
+ *  memory and build the tree in a single pass, without any parsing.  The text format is still used
+ *  by the import and export commands, and text tree files (for example ones written by older
+ *  versions of the config tree) are still loaded.
+ *
+ *  When a tree is loaded, its snapshot is read and then the journal's entries are replayed on top
+ *  of it.  An entry that was only partly written when the system went down fails its checksum, and
+ *  is cut off the end of the journal.  The journal records the revision of the snapshot it applies
+ *  to, so a journal left behind by an interrupted compaction is recognized and discarded.
+ *
  *  Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
  *  Use of this work is subject to license.
  */
@@ -128,12 +176,13 @@
 #include "legato.h"
 #include "limit.h"
 #include "interfaces.h"
-#include "dynamicString.h"
+#include "arena.h"
 #include "treePath.h"
 #include "treeDb.h"
 #include "treeUser.h"
 #include "nodeIterator.h"
 #include "sysPaths.h"
+#include <sys/mman.h>
 
 
 
@@ -158,17 +207,22 @@ typedef struct Registration
 {
     char registrationPath[CFG_MAX_PATH_SIZE];  ///< Path to the node being watched.  This *must*
                                                ///<   also include the tree name.
+    const char* namePtr;                       ///< Name of the watched node, the last part of
+                                               ///<   registrationPath.  Empty for a tree's root.
     bool triggered;                            ///< Has this registration been triggered for
                                                ///<   callback?
+    le_sls_Link_t triggeredLink;               ///< Link in TriggeredList, while triggered is set.
 
-    union
-    {
-        le_dls_List_t handlerList;   ///< List of handlers to watch the specified node.
-        le_sls_Link_t link;          ///< When a client session is destroyed, all of it's handlers
+    struct Registration* parentPtr;  ///< Registration for the watched node's parent, or NULL if
+                                     ///<   the watched node is the root of its tree.
+    le_dls_List_t childList;         ///< Registrations for the children of the watched node.
+    le_dls_Link_t siblingLink;       ///< Link in the parent registration's childList.
+
+    le_dls_List_t handlerList;       ///< List of handlers to watch the specified node.
+    le_sls_Link_t link;              ///< When a client session is destroyed, all of it's handlers
                                      ///<   are automatically removed.  If a registration object is
                                      ///<   determined to be no longer required, this link is used
                                      ///<   to queue the registration object for deletion.
-    };
 }
 Registration_t;
 
@@ -243,6 +297,151 @@ NodeFlags_t;
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A stem needs at least this many children before it is given a child index.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define CHILD_INDEX_THRESHOLD 16
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets in each size of child index.  An index is moved to the next size up once it
+ * holds more children than it has buckets.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const size_t ChildIndexSizes[] = { 32, 128, 512, 2048 };
+
+#define NUM_CHILD_INDEX_SIZES NUM_ARRAY_MEMBERS(ChildIndexSizes)
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Node names and values that fit in this many bytes, (including the terminator,) are stored inside
+ * the node itself.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define NODE_SHORT_STR_BYTES 24
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sizes of the buffers that longer names and values of live tree nodes are allocated from.  A
+ * string goes into the smallest buffer it fits in.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const size_t StringSizes[] = { 64, 128, 256, LE_CFG_STR_LEN_BYTES };
+
+#define NUM_STRING_SIZES NUM_ARRAY_MEMBERS(StringSizes)
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A tree is compacted once its journal is bigger than its tree file, but small journals are left
+ * alone until they reach this size (in bytes).
+ **/
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_MIN_COMPACT_BYTES (16 * 1024)
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How long to wait (in seconds) after a journal needs compacting before compacting it.  This keeps
+ * bursts of commits from each paying for a full snapshot.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_COMPACT_DELAY 5
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format of the first line of a journal file, which records the revision of the tree file that the
+ * journal's entries apply to.  Each entry that follows is a line holding the size of the entry's
+ * records in bytes and their checksum, followed by the records themselves.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_HEADER_FORMAT "journal %d\n"
+#define JOURNAL_ENTRY_FORMAT "%zu %08" PRIx32 "\n"
+#define JOURNAL_ENTRY_SCAN_FORMAT "%zu %" SCNx32 "\n"
+
+/// Starting value of an entry's checksum, see UpdateChecksum().
+#define JOURNAL_CHECKSUM_INIT 2166136261u
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Journal records start with one of these, followed by the path of the node as a string token.  A
+ * set record is followed by the node's new contents, written the same way as in a tree file.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_SET_RECORD '='
+#define JOURNAL_DELETE_RECORD '-'
+
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Binary tree files start with this 8 byte magic number.  (Text tree files can never start with
+ * these bytes.)
+ **/
+//--------------------------------------------------------------------------------------------------
+#define BINARY_TREE_MAGIC "\177cfgtree"
+#define BINARY_TREE_MAGIC_BYTES 8
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Hash table of a stem's children, indexed by name.  Children with the same hash bucket are
+ *  chained together through their nextInBucketRef pointers, in the order they were added.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct ChildIndex
+{
+    size_t sizeIndex;                ///< Index into ChildIndexSizes[] of this index's size.
+    size_t count;                    ///< Number of children in the index.
+    struct Node* buckets[];          ///< The buckets.
+}
+ChildIndex_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A node's name or value.  Short strings are kept in the node itself, longer ones are kept in a
+ *  separate buffer.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char* strPtr;                          ///< The string, or NULL if it has never been set.  Points
+                                           ///<   either at shortStr or at a separate buffer.
+    char shortStr[NODE_SHORT_STR_BYTES];   ///< Storage for short strings.
+}
+NodeString_t;
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  The Node object structure.
@@ -258,19 +457,29 @@ typedef struct Node
     tdb_NodeRef_t shadowRef;         ///< If this node is shadowing another then the pointer to
                                      ///<   that shadowed node is here.
 
-    dstr_Ref_t nameRef;              ///< The name of this node.
+    NodeString_t name;               ///< The name of this node.
 
     le_dls_Link_t siblingList;       ///< The linked list of node siblings.  All of the nodes
                                      ///<   in this list have the same parent node.
 
     union
     {
-        dstr_Ref_t valueRef;         ///< The value of the node.  This is only valid if the
+        NodeString_t value;          ///< The value of the node.  This is only valid if the
                                      ///<   node is not a stem.
 
         le_dls_List_t children;      ///< The linked list of children belonging to this node.
     }
     info;                            ///< The actual inforation that this node stores.
+
+    ChildIndex_t* childIndexPtr;     ///< Index of this node's children by name, or NULL if this
+                                     ///<   node doesn't have one.
+
+    bool isIndexed;                  ///< Is this node in its parent's child index?
+    size_t nameHash;                 ///< Hash of this node's name, valid if isIndexed is set.
+    struct Node* nextInBucketRef;    ///< Next node in the same bucket of the parent's child index.
+
+    arena_Ref_t arenaRef;            ///< Arena the node, its strings and its child index were
+                                     ///<   allocated from.  NULL if they come from the pools.
 }
 Node_t;
 
@@ -291,6 +500,11 @@ typedef struct Tree
     struct Tree* originalTreeRef;         ///< If non-NULL then this points back to the original
                                           ///<   tree this one is shadowing.
 
+    bool isSnapshot;                      ///< Is this a frozen copy of a tree, kept for the read
+                                          ///<   iterators that were open when a change was
+                                          ///<   merged into the tree?  A snapshot is freed once
+                                          ///<   the last of those iterators is released.
+
     char name[MAX_TREE_NAME_BYTES];       ///< The name of this tree.
 
     int revisionId;                       ///< The current revision,
@@ -299,6 +513,16 @@ typedef struct Tree
 
     Node_t* rootNodeRef;                  ///< The root node of this tree.
 
+    arena_Ref_t arenaRef;                 ///< Arena that all of the tree's nodes are allocated
+                                          ///<   from, or NULL if they come from the node pool.
+
+    int journalFd;                        ///< The tree's journal file, open for appending.  -1 if
+                                          ///<   it isn't open.
+    size_t journalSize;                   ///< Size of the journal file in bytes, 0 if there isn't
+                                          ///<   one.
+    size_t snapshotSize;                  ///< Size of the current revision's tree file in bytes.
+    bool isCompactPending;                ///< Is this tree waiting for the compaction timer?
+
     ssize_t activeReadCount;              ///< Count of reads that are currently active on
                                           ///<   this tree.
     ni_IteratorRef_t activeWriteIterRef;  ///< The parent write iterator that's active on
@@ -333,6 +557,79 @@ TokenType_t;
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a binary tree file.  The header is followed by the tree's nodes, (an array of
+ * BinaryNode_t,) and then the string table, which holds all of the nodes' names and values as
+ * NULL terminated strings.
+ *
+ * All of the fields in a binary tree file are in the byte order of the device that wrote it.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char magic[BINARY_TREE_MAGIC_BYTES];  ///< BINARY_TREE_MAGIC.
+    uint32_t nodeCount;                   ///< Number of nodes in the tree.
+    uint32_t stringTableSize;             ///< Size of the string table, in bytes.
+}
+BinaryTreeHeader_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A node in a binary tree file.  The nodes are stored depth first, so each stem is followed by its
+ * children, with each child followed by its own children, and so on.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t tokenType;   ///< The kind of node, as the TokenType_t that would start the node in
+                          ///<   a text tree file.  (TT_OPEN_GROUP for a stem.)
+    uint32_t nameOffset;  ///< Offset of the node's name in the string table.
+    uint32_t info;        ///< For a stem, the number of children.  For a value node, the offset of
+                          ///<   its value in the string table.
+}
+BinaryNode_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Used to keep track of where we are while loading a binary tree file.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const BinaryNode_t* nodesPtr;  ///< The node array.
+    uint32_t nodeCount;            ///< Number of nodes in the array.
+    uint32_t nextNodeIndex;        ///< Index of the next node to load.
+    const char* stringsPtr;        ///< The string table.
+    uint32_t stringTableSize;      ///< Size of the string table in bytes.
+}
+BinaryLoadContext_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Used to keep track of the node array and the string table while writing a binary tree file.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    FILE* nodesPtr;       ///< Stream the node array is written to.
+    FILE* stringsPtr;     ///< Stream the string table is written to.
+    uint32_t nodeCount;   ///< Number of nodes written so far.
+}
+BinaryWriteContext_t;
+
+
+
+
 /// The memory pool responsible for tree nodes.
 static le_mem_PoolRef_t NodePoolRef = NULL;
 
@@ -365,6 +662,12 @@ static le_hashmap_Ref_t HandlerRegistrationMap = NULL;
 
 
 
+/// Registrations that have been triggered by the merge in progress, in the order they were
+/// triggered.
+static le_sls_List_t TriggeredList = LE_SLS_LIST_INIT;
+
+
+
 /// Pool for registered change handlers.
 static le_mem_PoolRef_t HandlerPool = NULL;
 
@@ -388,6 +691,22 @@ static le_mem_PoolRef_t RegistrationPool = NULL;
 
 
 
+/// Pools for the child index objects, one for each of the sizes in ChildIndexSizes[].
+static le_mem_PoolRef_t ChildIndexPools[NUM_CHILD_INDEX_SIZES];
+
+
+
+/// Pools for the names and values that don't fit in a node, one for each of the sizes in
+/// StringSizes[].
+static le_mem_PoolRef_t StringPools[NUM_STRING_SIZES];
+
+
+
+/// Timer that compacts the journals of the trees that have isCompactPending set.
+static le_timer_Ref_t CompactTimerRef = NULL;
+
+
+
 
 // -------------------------------------------------------------------------------------------------
 /**
@@ -544,29 +863,19 @@ static void ClearDeletedFlag
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node and fill out it's default information.
+ *  Get the bucket of a child index that a name hash belongs in.
  *
- *  @return The newly created node.
+ *  @return Pointer to the head of the bucket's chain.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewNode
+static tdb_NodeRef_t* GetIndexBucket
 (
-    void
+    ChildIndex_t* indexPtr,  ///< [IN] The child index.
+    size_t nameHash          ///< [IN] Hash of the name.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Create a new blank node.
-    tdb_NodeRef_t newNodeRef = le_mem_ForceAlloc(NodePoolRef);
-
-    newNodeRef->parentRef = NULL;
-    newNodeRef->type = LE_CFG_TYPE_EMPTY;
-    ClearFlags(newNodeRef);
-    newNodeRef->shadowRef = NULL;
-    newNodeRef->nameRef = NULL;
-    newNodeRef->siblingList = LE_DLS_LINK_INIT;
-    memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
-
-    return newNodeRef;
+    return &indexPtr->buckets[nameHash & (ChildIndexSizes[indexPtr->sizeIndex] - 1)];
 }
 
 
@@ -574,63 +883,35 @@ static tdb_NodeRef_t NewNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  The node destructor function.  This will take care of freeing a node's string values and any
- *  children it may have.  Called automaticly by the memory system when a node is released.
+ *  Allocate a new, empty child index.
+ *
+ *  @return The new index.
  */
 // -------------------------------------------------------------------------------------------------
-static void NodeDestructor
+static ChildIndex_t* NewChildIndex
 (
-    void* objectPtr  ///< [IN] The generic object to free.
+    tdb_NodeRef_t parentRef,  ///< [IN] The stem the index is for.
+    size_t sizeIndex          ///< [IN] Index into ChildIndexSizes[] of the size of index to create.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
+    ChildIndex_t* indexPtr;
+    size_t size = sizeof(ChildIndex_t) + (ChildIndexSizes[sizeIndex] * sizeof(tdb_NodeRef_t));
 
-    if (nodeRef->nameRef)
+    if (parentRef->arenaRef != NULL)
     {
-        dstr_Release(nodeRef->nameRef);
+        indexPtr = arena_Alloc(parentRef->arenaRef, size);
     }
-
-    switch (nodeRef->type)
+    else
     {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            // Nothing to do here.
-            break;
-
-        case LE_CFG_TYPE_STRING:
-        case LE_CFG_TYPE_BOOL:
-        case LE_CFG_TYPE_INT:
-        case LE_CFG_TYPE_FLOAT:
-            if (nodeRef->info.valueRef)
-            {
-                dstr_Release(nodeRef->info.valueRef);
-            }
-            break;
-
-        case LE_CFG_TYPE_STEM:
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
-
-                while (childRef != NULL)
-                {
-                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
-
-                    le_mem_Release(childRef);
-                    childRef = nextChildRef;
-                }
-            }
-            break;
+        indexPtr = le_mem_ForceAlloc(ChildIndexPools[sizeIndex]);
     }
 
-    if (nodeRef->parentRef != NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
-        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
-        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
+    indexPtr->sizeIndex = sizeIndex;
+    indexPtr->count = 0;
+    memset(indexPtr->buckets, 0, ChildIndexSizes[sizeIndex] * sizeof(indexPtr->buckets[0]));
 
-        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
-    }
+    return indexPtr;
 }
 
 
@@ -638,40 +919,21 @@ static void NodeDestructor
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
- *
- *  @return A new node that shadows the existing node.
+ *  Free a stem's child index.  An index allocated from an arena is left for the arena to free.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewShadowNode
+static void ReleaseChildIndex
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
+    tdb_NodeRef_t parentRef  ///< [IN] The stem that owns the index.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Allocate a new blank node.
-    tdb_NodeRef_t newShadowRef = NewNode();
-
-    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
-    // be creating a shadow node for which no original exists.  Which is the case when creating a
-    // new path that didn't exist in the original tree.
-    if (nodeRef != NULL)
+    if (parentRef->arenaRef == NULL)
     {
-        newShadowRef->type = nodeRef->type;
-        newShadowRef->flags = nodeRef->flags;
-        newShadowRef->shadowRef = nodeRef;
-
-        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
-        // same with this new node.
-        if (   (nodeRef->parentRef != NULL)
-            && (IsDeleted(nodeRef->parentRef)))
-        {
-            SetDeletedFlag(newShadowRef);
-        }
+        le_mem_Release(parentRef->childIndexPtr);
     }
 
-    SetShadowFlag(newShadowRef);
-    return newShadowRef;
+    parentRef->childIndexPtr = NULL;
 }
 
 
@@ -679,48 +941,70 @@ static tdb_NodeRef_t NewShadowNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new node and insert it into the given node's children collection.
- *
- *  @return The newly create node, already inserted into the supplied node's child collection.
+ *  Append a node to the end of its bucket's chain in a child index.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewChildNode
+static void InsertIntoIndex
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
+    ChildIndex_t* indexPtr,  ///< [IN] The child index.
+    tdb_NodeRef_t nodeRef    ///< [IN] The node to insert.  Its nameHash must already be set.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node is currently empty, then turn it into a stem.
-    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
+    tdb_NodeRef_t* linkPtr = GetIndexBucket(indexPtr, nodeRef->nameHash);
+
+    while (*linkPtr != NULL)
     {
-        nodeRef->type = LE_CFG_TYPE_STEM;
+        linkPtr = &(*linkPtr)->nextInBucketRef;
     }
 
-    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
+    nodeRef->nextInBucketRef = NULL;
+    *linkPtr = nodeRef;
+    indexPtr->count++;
+}
 
-    // Create a new node.  Then set it's parent to the given node
-    tdb_NodeRef_t newRef = NewNode();
 
-    newRef->parentRef = nodeRef;
-    newRef->type = LE_CFG_TYPE_EMPTY;
 
-    // Get the new node to inheret the parent's shadow and deletion flags.
-    if (IsShadow(nodeRef))
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Move a stem's child index to the next size up, if it has outgrown its current size.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GrowChildIndex
+(
+    tdb_NodeRef_t parentRef  ///< [IN] The stem that owns the index.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ChildIndex_t* oldIndexPtr = parentRef->childIndexPtr;
+
+    if (   (oldIndexPtr->count <= ChildIndexSizes[oldIndexPtr->sizeIndex])
+        || (oldIndexPtr->sizeIndex + 1 >= NUM_CHILD_INDEX_SIZES))
     {
-        SetShadowFlag(newRef);
-        SetDeletedFlag(newRef);
+        return;
     }
 
-    if (IsDeleted(nodeRef))
+    ChildIndex_t* newIndexPtr = NewChildIndex(parentRef, oldIndexPtr->sizeIndex + 1);
+
+    // Re-insert the children in sibling list order, so that each bucket's chain stays in the order
+    // the children were added in.
+    tdb_NodeRef_t childRef = tdb_GetFirstChildNode(parentRef);
+
+    while (childRef != NULL)
     {
-        SetDeletedFlag(newRef);
+        if (childRef->isIndexed)
+        {
+            InsertIntoIndex(newIndexPtr, childRef);
+        }
+
+        childRef = tdb_GetNextSiblingNode(childRef);
     }
 
-    // Now make sure to add the new child node to the end of the parents collection.
-    le_dls_Queue(&nodeRef->info.children, &newRef->siblingList);
+    LE_ASSERT(newIndexPtr->count == oldIndexPtr->count);
 
-    // Finally return the newly created node to the caller.
-    return newRef;
+    ReleaseChildIndex(parentRef);
+    parentRef->childIndexPtr = newIndexPtr;
 }
 
 
@@ -728,58 +1012,82 @@ static tdb_NodeRef_t NewChildNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to shadow a node's collection of children.
+ *  If the node's parent has a child index, add the node to it under the node's current name.
+ *  Nodes that don't have a name yet are left out of the index.
  */
 // -------------------------------------------------------------------------------------------------
-static void ShadowChildren
+static void AddToParentIndex
 (
-    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to add.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the parent node isn't a stem then there isn't much else to do here.
-    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
-    {
-        return;
-    }
+    tdb_NodeRef_t parentRef = nodeRef->parentRef;
 
-    // Does this node have any children currently?  If yes, then we don't need to do anything else.
-    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
+    if (   (parentRef == NULL)
+        || (parentRef->childIndexPtr == NULL)
+        || (nodeRef->isIndexed))
     {
         return;
     }
 
-    // Has this node been modified?  If so, then the shadow children may have been cleared from
-    // this collection.
-    if (IsModified(shadowParentRef) == true)
+    char name[LE_CFG_NAME_LEN_BYTES] = "";
+
+    tdb_GetNodeName(nodeRef, name, sizeof(name));
+
+    if (name[0] == '\0')
     {
         return;
     }
 
-    // This node has no shadow children.  So what we do now is check the original node... Does it
-    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
-    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
-    // this piecemeal and possibly out of order.
-    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
+    nodeRef->nameHash = le_hashmap_HashString(name);
+    nodeRef->isIndexed = true;
 
-    if (   (originalRef == NULL)
-        || (originalRef->type != LE_CFG_TYPE_STEM))
+    InsertIntoIndex(parentRef->childIndexPtr, nodeRef);
+    GrowChildIndex(parentRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  If the node is in its parent's child index, take it out.  The parent's index is released once
+ *  it is empty.
+ */
+// -------------------------------------------------------------------------------------------------
+static void RemoveFromParentIndex
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to remove.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (nodeRef->isIndexed == false)
     {
         return;
     }
 
-    // Simply iterate through the original collection and add a new shadow child to our own
-    // collection.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+    ChildIndex_t* indexPtr = nodeRef->parentRef->childIndexPtr;
 
-    while (originalChildRef != NULL)
+    LE_ASSERT(indexPtr != NULL);
+
+    tdb_NodeRef_t* linkPtr = GetIndexBucket(indexPtr, nodeRef->nameHash);
+
+    while (*linkPtr != nodeRef)
     {
-        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
-        newShadowRef->parentRef = shadowParentRef;
+        LE_ASSERT(*linkPtr != NULL);
+        linkPtr = &(*linkPtr)->nextInBucketRef;
+    }
 
-        le_dls_Queue(&shadowParentRef->info.children, &newShadowRef->siblingList);
+    *linkPtr = nodeRef->nextInBucketRef;
+    nodeRef->nextInBucketRef = NULL;
+    nodeRef->isIndexed = false;
 
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    indexPtr->count--;
+
+    if (indexPtr->count == 0)
+    {
+        ReleaseChildIndex(nodeRef->parentRef);
     }
 }
 
@@ -788,24 +1096,32 @@ static void ShadowChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Search up through a node tree until we find the root node.
+ *  Build a child index for a stem, containing all of its named children.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetRootParentNode
+static void BuildChildIndex
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
+    tdb_NodeRef_t parentRef  ///< [IN] The stem to index.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t parentRef = NULL;
+    LE_ASSERT(parentRef->childIndexPtr == NULL);
 
-    while (nodeRef != NULL)
+    parentRef->childIndexPtr = NewChildIndex(parentRef, 0);
+
+    tdb_NodeRef_t childRef = tdb_GetFirstChildNode(parentRef);
+
+    while (childRef != NULL)
     {
-        parentRef = nodeRef;
-        nodeRef = tdb_GetNodeParent(nodeRef);
+        AddToParentIndex(childRef);
+        childRef = tdb_GetNextSiblingNode(childRef);
     }
 
-    return parentRef;
+    // If none of the children had names, there's nothing to index.
+    if (parentRef->childIndexPtr->count == 0)
+    {
+        ReleaseChildIndex(parentRef);
+    }
 }
 
 
@@ -813,52 +1129,70 @@ static tdb_NodeRef_t GetRootParentNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to look for a named child in a given node's child collection.
+ *  Look for a child with the given name in a stem's child collection, using the stem's child index
+ *  if it has one.  If it doesn't, and the search had to look at a lot of children, build an index
+ *  for next time.
  *
- *  @return Reference to the found child node, or NULL if a node was not found.
+ *  @return Reference to the child node, or NULL if there isn't one with that name.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetNamedChild
+static tdb_NodeRef_t FindChild
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    tdb_NodeRef_t parentRef,  ///< [IN] The node to search.
+    const char* namePtr       ///< [IN] The name to search for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is this one of the "special" names?
-    if (strcmp(nameRef, ".") == 0)
-    {
-        return nodeRef;
-    }
+    char currentName[LE_CFG_NAME_LEN_BYTES] = "";
 
-    if (strcmp(nameRef, "..") == 0)
-    {
-        return nodeRef->parentRef;
-    }
+    // Note that this has to be called first, because if this is a shadow node, it will create the
+    // node's shadow children.
+    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(parentRef);
 
-    // If the current node isn't a stem, then this node can't have any children.
-    if (nodeRef->type != LE_CFG_TYPE_STEM)
+    if (parentRef->childIndexPtr != NULL)
     {
+        size_t nameHash = le_hashmap_HashString(namePtr);
+
+        currentRef = *GetIndexBucket(parentRef->childIndexPtr, nameHash);
+
+        while (currentRef != NULL)
+        {
+            if (currentRef->nameHash == nameHash)
+            {
+                tdb_GetNodeName(currentRef, currentName, sizeof(currentName));
+
+                if (strncmp(currentName, namePtr, sizeof(currentName)) == 0)
+                {
+                    return currentRef;
+                }
+            }
+
+            currentRef = currentRef->nextInBucketRef;
+        }
+
         return NULL;
     }
 
-    // Search the child list for a node with the given name.
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(nodeRef);
-    char currentNameRef[LE_CFG_NAME_LEN_BYTES] = "";
+    size_t numSearched = 0;
 
     while (currentRef != NULL)
     {
-        tdb_GetNodeName(currentRef, currentNameRef, sizeof(currentNameRef));
+        tdb_GetNodeName(currentRef, currentName, sizeof(currentName));
 
-        if (strncmp(currentNameRef, nameRef, sizeof(currentNameRef)) == 0)
+        if (strncmp(currentName, namePtr, sizeof(currentName)) == 0)
         {
             return currentRef;
         }
 
+        numSearched++;
         currentRef = tdb_GetNextSiblingNode(currentRef);
     }
 
-    // Looks like there was no node to return.
+    if (numSearched >= CHILD_INDEX_THRESHOLD)
+    {
+        BuildChildIndex(parentRef);
+    }
+
     return NULL;
 }
 
@@ -867,46 +1201,61 @@ static tdb_NodeRef_t GetNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to create a named child in a nodes child collection.  However, this function will only
- *  create nodes on shadow trees.
+ *  Allocate a new node and fill out it's default information.
  *
- *  @return Reference to newly created child node, or NULL if it can not be created.
+ *  @return The newly created node.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t CreateNamedChild
+static tdb_NodeRef_t NewNode
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    arena_Ref_t arenaRef  ///< [IN] Arena to allocate the node from, or NULL to use the node pool.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t childRef = NULL;
+    // Create a new blank node.
+    tdb_NodeRef_t newNodeRef = (arenaRef != NULL) ? arena_Alloc(arenaRef, sizeof(Node_t))
+                                                  : le_mem_ForceAlloc(NodePoolRef);
 
-    if (IsShadow(nodeRef) == true)
-    {
-        // If the node isn't a stem, then convert it into an empty one now.
-        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
-            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
-        {
-            tdb_SetEmpty(nodeRef);
-            nodeRef->type = LE_CFG_TYPE_STEM;
-            nodeRef->info.children = LE_DLS_LIST_INIT;
-        }
+    newNodeRef->parentRef = NULL;
+    newNodeRef->type = LE_CFG_TYPE_EMPTY;
+    ClearFlags(newNodeRef);
+    newNodeRef->shadowRef = NULL;
+    newNodeRef->name.strPtr = NULL;
+    newNodeRef->siblingList = LE_DLS_LINK_INIT;
+    memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
+    newNodeRef->childIndexPtr = NULL;
+    newNodeRef->isIndexed = false;
+    newNodeRef->nameHash = 0;
+    newNodeRef->nextInBucketRef = NULL;
+    newNodeRef->arenaRef = arenaRef;
 
-        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
-        childRef = NewChildNode(nodeRef);
-        SetDeletedFlag(childRef);
+    return newNodeRef;
+}
 
-        // Set the name of the new node, if that fails then the user had given us a bad name for the
-        // new node.  So in that case free the node and return NULL.
-        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
-        {
-            le_mem_Release(childRef);
-            childRef = NULL;
-        }
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Free the separate buffer of a node's name or value, if it has one, and mark the string as unset.
+ *  A buffer allocated from an arena is left for the arena to free.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ClearNodeString
+(
+    tdb_NodeRef_t nodeRef,     ///< [IN] The node the string belongs to.
+    NodeString_t* stringPtr    ///< [IN] The node's name or value.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (   (stringPtr->strPtr != NULL)
+        && (stringPtr->strPtr != stringPtr->shortStr)
+        && (nodeRef->arenaRef == NULL))
+    {
+        le_mem_Release(stringPtr->strPtr);
     }
 
-    return childRef;
+    stringPtr->strPtr = NULL;
 }
 
 
@@ -914,34 +1263,45 @@ static tdb_NodeRef_t CreateNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a given node exists within a node's child collection.
- *
- *  @return True if the given node exists within the parent node's collection.  False if not.
+ *  Set the contents of a node's name or value.  The length of strings that come from clients or
+ *  files has to have been checked already, by tdb_SetNodeName() or tdb_SetValueAsString().
  */
 // -------------------------------------------------------------------------------------------------
-static bool NodeExists
+static void SetNodeString
 (
-    tdb_NodeRef_t parentRef,  ///< [IN] The parent node to search.
-    const char* namePtr       ///< [IN] The name to search for.
+    tdb_NodeRef_t nodeRef,     ///< [IN] The node the string belongs to.
+    NodeString_t* stringPtr,   ///< [IN] The node's name or value.
+    const char* newStrPtr      ///< [IN] The new contents of the string.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(parentRef);
-    char currentName[LE_CFG_NAME_LEN_BYTES] = "";
+    size_t size = strlen(newStrPtr) + 1;
 
-    while (currentRef != NULL)
+    LE_ASSERT(size <= LE_CFG_STR_LEN_BYTES);
+
+    ClearNodeString(nodeRef, stringPtr);
+
+    if (size <= NODE_SHORT_STR_BYTES)
     {
-        tdb_GetNodeName(currentRef, currentName, sizeof(currentName));
+        stringPtr->strPtr = stringPtr->shortStr;
+    }
+    else if (nodeRef->arenaRef != NULL)
+    {
+        stringPtr->strPtr = arena_Alloc(nodeRef->arenaRef, size);
+    }
+    else
+    {
+        size_t i = 0;
 
-        if (strncmp(currentName, namePtr, sizeof(currentName)) == 0)
+        while (StringSizes[i] < size)
         {
-            return true;
+            i++;
         }
 
-        currentRef = tdb_GetNextSiblingNode(currentRef);
+        stringPtr->strPtr = le_mem_ForceAlloc(StringPools[i]);
     }
 
-    return false;
+    memcpy(stringPtr->strPtr, newStrPtr, size);
 }
 
 
@@ -949,28 +1309,31 @@ static bool NodeExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node type and see if it should have a string value.
+ *  Get the first child of a node, without creating shadows of the original node's children the way
+ *  tdb_GetFirstChildNode does.
  *
- *  @return True if the given node could hold a string value.  False if not.
+ *  @return The first child in the node's child list, or NULL if the list is empty.
  */
 // -------------------------------------------------------------------------------------------------
-static bool IsStringType
+static tdb_NodeRef_t GetFirstListedChild
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
+    tdb_NodeRef_t nodeRef  ///< [IN] Get the first child of this node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
+    {
+        return NULL;
+    }
 
-    if (   (type == LE_CFG_TYPE_STRING)
-        || (type == LE_CFG_TYPE_BOOL)
-        || (type == LE_CFG_TYPE_INT)
-        || (type == LE_CFG_TYPE_FLOAT))
+    le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+    if (linkPtr == NULL)
     {
-        return true;
+        return NULL;
     }
 
-    return false;
+    return CONTAINER_OF(linkPtr, Node_t, siblingList);
 }
 
 
@@ -978,33 +1341,25 @@ static bool IsStringType
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function will copy a string value from an original tree node into a node that has shadowed
- *  it.
+ *  Take a node out of its parent's child list and index.
  */
 // -------------------------------------------------------------------------------------------------
-static void PropagateValue
+static void DetachNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to detach.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node doesn't even have a ref to an original node, then there's nothing left to do
-    // here.
-    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
-
-    if (shadowRef == NULL)
+    if (nodeRef->parentRef != NULL)
     {
-        return;
-    }
+        RemoveFromParentIndex(nodeRef);
 
-    // Ok, figure out the type for this node.  If it has a value, and the original
-    if (   (IsStringType(nodeRef) == true)
-        && (IsStringType(shadowRef) == true)
-        && (nodeRef->info.valueRef == NULL)
-        && (shadowRef->info.valueRef != NULL))
-    {
-        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
-        nodeRef->info.valueRef = dstr_NewFromDstr(shadowRef->info.valueRef);
+        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
+        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
+        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
+
+        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
+        nodeRef->parentRef = NULL;
     }
 }
 
@@ -1013,116 +1368,57 @@ static void PropagateValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow node with the original it represents.
+ *  The node destructor function.  This will take care of freeing a node's string values and any
+ *  children it may have.  Called automaticly by the memory system when a node is released.
  */
 // -------------------------------------------------------------------------------------------------
-static void MergeNode
+static void NodeDestructor
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
+    void* objectPtr  ///< [IN] The generic object to free.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_ASSERT(nodeRef != NULL);
+    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
 
-    // If this shadow node for some reason doesn't have a ref check for an original version of it in
-    // the original tree.  This shadow node may have been destroyed and re-created loosing this
-    // link.
-    if (nodeRef->shadowRef == NULL)
-    {
-        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
+    ClearNodeString(nodeRef, &nodeRef->name);
 
-        if (shadowedParentRef != NULL)
-        {
-            char name[LE_CFG_NAME_LEN_BYTES] = "";
+    switch (nodeRef->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            // Nothing to do here.
+            break;
 
-            tdb_GetNodeName(nodeRef, name, sizeof(name));
-            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
-        }
-    }
-
-    // If this node has been marked as deleted, then simply drop the original node and move on.
-    if (IsDeleted(nodeRef))
-    {
-        if (   (nodeRef->shadowRef != NULL)
-            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
-        {
-            le_mem_Release(nodeRef->shadowRef);
-        }
-        else
-        {
-            // We delete every node but the root node.  Since this is the root node, we just need
-            // to clear it out.
-            tdb_SetEmpty(nodeRef->shadowRef);
-        }
-
-        return;
-    }
-
-    // If the original node doesn't exist, create it now.
-    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
-
-    if (originalRef == NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef != NULL);
-        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
-
-        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
-    }
-
-    ClearModifiedFlag(originalRef);
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            ClearNodeString(nodeRef, &nodeRef->info.value);
+            break;
 
-    // If the name has been changed, then copy it over now.
-    if (dstr_IsNullOrEmpty(nodeRef->nameRef) == false)
-    {
-        if (originalRef->nameRef != NULL)
-        {
-            dstr_Copy(originalRef->nameRef, nodeRef->nameRef);
-        }
-        else
-        {
-            originalRef->nameRef = dstr_NewFromDstr(nodeRef->nameRef);
-        }
-    }
+        case LE_CFG_TYPE_STEM:
+            {
+                tdb_NodeRef_t childRef = GetFirstListedChild(nodeRef);
 
-    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
-    // then clear out the original node.  If the types have changed, then clear out the original so
-    // that we can properly populate it again.
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+                while (childRef != NULL)
+                {
+                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
 
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != originalRef->type))
-    {
-        tdb_SetEmpty(originalRef);
+                    le_mem_Release(childRef);
+                    childRef = nextChildRef;
+                }
+            }
+            break;
     }
 
-    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
-    // that it isn't a stem.  If not, then copy over the string value.
-    if (   (nodeType != LE_CFG_TYPE_EMPTY)
-        && (nodeType != LE_CFG_TYPE_STEM))
+    // Releasing the children normally empties out and frees this node's child index.  But if the
+    // node stopped being a stem without its children being released, the index is still here.
+    if (nodeRef->childIndexPtr != NULL)
     {
-        if (nodeRef->info.valueRef != NULL)
-        {
-            if (originalRef->info.valueRef != NULL)
-            {
-                dstr_Copy(originalRef->info.valueRef, nodeRef->info.valueRef);
-            }
-            else
-            {
-                originalRef->info.valueRef = dstr_NewFromDstr(nodeRef->info.valueRef);
-            }
-
-            // Propigate over the type as that may have changed, like going from an int value to a
-            // bool value.
-
-            originalRef->type = nodeRef->type;
-        }
+        ReleaseChildIndex(nodeRef);
     }
 
-    // Now at this point, if both the original and the shadow node are stems, we'll let the function
-    // InternalMergeTree take care of the children, (if any.)
-
-    // If the original has been cleared out, we can still just rely on InternalMergeTree to
-    // propigate over the new nodes.
+    DetachNode(nodeRef);
 }
 
 
@@ -1130,77 +1426,66 @@ static void MergeNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to fire any callbacks registered on the given node path.  If nothing is registered on the
- *  given path, nothing happens.
+ *  Free a node, along with its children.  Nodes allocated from an arena are only freed along with
+ *  the whole arena, so one of those is just taken out of its tree.
  */
 // -------------------------------------------------------------------------------------------------
-static void TriggerCallbacks
+static void ReleaseNode
 (
-    le_pathIter_Ref_t pathRef  ///< [IN] The path to search for callback registrations.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to free.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Read the path out of the buffer.
-    char pathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
-    if (le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
+    if (nodeRef->arenaRef == NULL)
     {
-        LE_ERROR("Callback path buffer overflow.");
-        return;
+        le_mem_Release(nodeRef);
     }
-
-    // Try to find a registration object for this path.  If one is found, flag it for calling once
-    // the merge is complete.
-    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathBuffer);
-
-    if (foundRegistrationPtr != NULL)
+    else
     {
-        foundRegistrationPtr->triggered = true;
+        DetachNode(nodeRef);
     }
 }
 
 
 
 
-
 // -------------------------------------------------------------------------------------------------
 /**
- *  Go through all of the registered event callbacks, and fire the call backs for each of the
- *  registrations that has been makred as triggered.
+ *  Allocate a new node from a shadow tree's arena, and turn it into a shadow of an existing node.
  *
- *  Once this is done, the triggered flag is cleared for next time.
+ *  @return A new node that shadows the existing node.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireTriggeredCallbacks
+static tdb_NodeRef_t NewShadowNode
 (
-    void
+    arena_Ref_t arenaRef,  ///< [IN] The shadow tree's arena.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Go through the registration map.
-    le_hashmap_It_Ref_t handlerIterRef = le_hashmap_GetIterator(HandlerRegistrationMap);
+    // Allocate a new blank node.
+    tdb_NodeRef_t newShadowRef = NewNode(arenaRef);
 
-    while (le_hashmap_NextNode(handlerIterRef) == LE_OK)
+    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
+    // be creating a shadow node for which no original exists.  Which is the case when creating a
+    // new path that didn't exist in the original tree.
+    if (nodeRef != NULL)
     {
-        // For each registration, check to see if it was triggered.
-        Registration_t* registrationPtr = (Registration_t*)le_hashmap_GetValue(handlerIterRef);
+        newShadowRef->type = nodeRef->type;
+        newShadowRef->flags = nodeRef->flags;
+        newShadowRef->shadowRef = nodeRef;
 
-        if (registrationPtr->triggered)
+        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
+        // same with this new node.
+        if (   (nodeRef->parentRef != NULL)
+            && (IsDeleted(nodeRef->parentRef)))
         {
-            // This registration has been triggered, so call all of the handlers attached to it.
-            le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
-
-            while (linkPtr != NULL)
-            {
-                Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
-
-                handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
-                linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
-            }
-
-            // Now that that's done, clear the triggered flag.
-            registrationPtr->triggered = false;
+            SetDeletedFlag(newShadowRef);
         }
     }
+
+    SetShadowFlag(newShadowRef);
+    return newShadowRef;
 }
 
 
@@ -1208,39 +1493,48 @@ static void FireTriggeredCallbacks
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node to see if it was renamed.
+ *  Create a new node and insert it into the given node's children collection.
  *
- *  @return True if the node was renamed within this transaction.  False if not.
+ *  @return The newly create node, already inserted into the supplied node's child collection.
  */
 // -------------------------------------------------------------------------------------------------
-static bool WasRenamed
+static tdb_NodeRef_t NewChildNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    if (IsModified(nodeRef) == false)
+    // If the node is currently empty, then turn it into a stem.
+    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
     {
-        // The node wasn't even modified, so it can not have been renamed.
-        return false;
+        nodeRef->type = LE_CFG_TYPE_STEM;
     }
 
-    if (nodeRef->shadowRef == NULL)
+    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
+
+    // Create a new node.  Then set it's parent to the given node
+    tdb_NodeRef_t newRef = NewNode(nodeRef->arenaRef);
+
+    newRef->parentRef = nodeRef;
+    newRef->type = LE_CFG_TYPE_EMPTY;
+
+    // Get the new node to inheret the parent's shadow and deletion flags.
+    if (IsShadow(nodeRef))
     {
-        // If the node doesn't have a shadow reference, then most likely this is a new node and not
-        // a rename of an existing one.
-        return false;
+        SetShadowFlag(newRef);
+        SetDeletedFlag(newRef);
     }
 
-    if (nodeRef->nameRef == NULL)
+    if (IsDeleted(nodeRef))
     {
-        // The shadow node does not have a local copy of a name, so it can not have been renamed.
-        // It must have been modified for other reasons.
-        return false;
+        SetDeletedFlag(newRef);
     }
 
-    // Looks like the node has a new name.
-    return true;
+    // Now make sure to add the new child node to the end of the parents collection.
+    le_dls_Queue(&nodeRef->info.children, &newRef->siblingList);
+
+    // Finally return the newly created node to the caller.
+    return newRef;
 }
 
 
@@ -1248,54 +1542,67 @@ static bool WasRenamed
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the original non-shadow node to see if it will need to be cleared during the merge.
- *
- *  @return True if the merge will clear out the original value.  False if not.
+ *  Called to shadow a node's collection of children.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OriginalToBeCleared
+static void ShadowChildren
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
+    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+    // If the parent node isn't a stem then there isn't much else to do here.
+    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
 
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
+    // Does this node have any children currently?  If yes, then we don't need to do anything else.
+    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
     {
-        return true;
+        return;
     }
 
-    return false;
-}
+    // Has this node been modified?  If so, then the shadow children may have been cleared from
+    // this collection.
+    if (IsModified(shadowParentRef) == true)
+    {
+        return;
+    }
+
+    // This node has no shadow children.  So what we do now is check the original node... Does it
+    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
+    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
+    // this piecemeal and possibly out of order.
+    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
 
+    if (   (originalRef == NULL)
+        || (originalRef->type != LE_CFG_TYPE_STEM))
+    {
+        return;
+    }
 
+    // Simply iterate through the original collection and add a new shadow child to our own
+    // collection.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
 
+    while (originalChildRef != NULL)
+    {
+        tdb_NodeRef_t newShadowRef = NewShadowNode(shadowParentRef->arenaRef, originalChildRef);
+        newShadowRef->parentRef = shadowParentRef;
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Append the name of a node onto the end of a path object.
- */
-// -------------------------------------------------------------------------------------------------
-static void AppendNodeName
-(
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+        le_dls_Queue(&shadowParentRef->info.children, &newShadowRef->siblingList);
 
-    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
-    le_result_t result = le_pathIter_Append(pathRef, nodeName);
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
 
-    LE_WARN_IF(result != LE_OK,
-               "Could not append node '%s' onto the update callback tracking path.  "
-               "Reason: %d, '%s'.",
-               nodeName,
-               result,
-               LE_RESULT_TXT(result));
+    // If the original had a child index, the shadow will need one too, so build it now rather
+    // than waiting for a slow lookup to do it.
+    if (   (originalRef->childIndexPtr != NULL)
+        && (shadowParentRef->childIndexPtr == NULL))
+    {
+        BuildChildIndex(shadowParentRef);
+    }
 }
 
 
@@ -1303,45 +1610,63 @@ static void AppendNodeName
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new config path for the tree name given.
- *
- *  @return A new config path, rooted on the given tree.
+ *  Copy a node's value and all of its children into an empty node.  Unlike a shadow node, the copy
+ *  doesn't refer back to the original in any way, so the original can be changed, or freed, without
+ *  affecting it.
  */
 // -------------------------------------------------------------------------------------------------
-static le_pathIter_Ref_t CreateBasePath
+static void CopyNode
 (
-    const char* treeNamePtr  ///< [IN] The tree name to use for the new path object.
+    tdb_NodeRef_t destRef,  ///< [IN] The empty node to copy into.
+    tdb_NodeRef_t srcRef    ///< [IN] The node to copy.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char basePath[CFG_MAX_PATH_SIZE] = { 0 };
+    switch (srcRef->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            break;
 
-    snprintf(basePath, sizeof(basePath), "%s:/", treeNamePtr);
-    return le_pathIter_CreateForUnix(basePath);
-}
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            destRef->type = srcRef->type;
 
+            if (srcRef->info.value.strPtr != NULL)
+            {
+                SetNodeString(destRef, &destRef->info.value, srcRef->info.value.strPtr);
+            }
+            break;
 
+        case LE_CFG_TYPE_STEM:
+            {
+                destRef->type = LE_CFG_TYPE_STEM;
 
+                tdb_NodeRef_t srcChildRef = GetFirstListedChild(srcRef);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Generate a config path to the given node.
- */
-// -------------------------------------------------------------------------------------------------
-static void GeneratePath
-(
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    if (nodeRef == NULL)
-    {
-        return;
-    }
+                while (srcChildRef != NULL)
+                {
+                    tdb_NodeRef_t destChildRef = NewChildNode(destRef);
 
-    GeneratePath(pathRef, nodeRef->parentRef);
-    AppendNodeName(pathRef, nodeRef);
+                    if (srcChildRef->name.strPtr != NULL)
+                    {
+                        SetNodeString(destChildRef, &destChildRef->name, srcChildRef->name.strPtr);
+                    }
+
+                    CopyNode(destChildRef, srcChildRef);
+                    srcChildRef = tdb_GetNextSiblingNode(srcChildRef);
+                }
+
+                // The children were added before the index existed, so build it in one pass.
+                if (srcRef->childIndexPtr != NULL)
+                {
+                    BuildChildIndex(destRef);
+                }
+            }
+            break;
+    }
 }
 
 
@@ -1349,36 +1674,24 @@ static void GeneratePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Trigger callbacks for this node and all of it's children.
+ *  Search up through a node tree until we find the root node.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireAllChildren
+static tdb_NodeRef_t GetRootParentNode
 (
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t nodeRef       ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Add this node to the path we're using to find registered callbacks.
-    AppendNodeName(pathRef, nodeRef);
+    tdb_NodeRef_t parentRef = NULL;
 
-    // If the node is a stem then traverse it's children and try to trigger callbacks for them.  If
-    // there are no callbacks registered for those nodes, then nothing will happen.
-    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    while (nodeRef != NULL)
     {
-        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
-
-        while (childRef != NULL)
-        {
-            FireAllChildren(pathRef, childRef);
-            childRef = tdb_GetNextSiblingNode(childRef);
-        }
+        parentRef = nodeRef;
+        nodeRef = tdb_GetNodeParent(nodeRef);
     }
 
-    // Like with the children, try to do the same for this node.  Then remove this node from the
-    // tracking path.
-    TriggerCallbacks(pathRef);
-    le_pathIter_Truncate(pathRef);
+    return parentRef;
 }
 
 
@@ -1386,82 +1699,37 @@ static void FireAllChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check a given shadow node and the original node it's shadowing.  If the original has children
- *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
- *  about to go away.
- *
- *  The algorithm employed by this function is as follows:
- *
- *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
- *         mark all of the children as deleted.  (This is done with the expectation that the
- *         original tree does not have nodes with the deleted flag set.)
- *
- *      2. Go through the shadow collection, and any shadow children that have links to the original
- *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *  Called to look for a named child in a given node's child collection.
  *
- *      3. Travers the original children one more time.  For any node that is still marked as
- *         deleted we queue up an event handler.  As this node has been removed from the colection
- *         and will be removed as part of the final merge.  The delete flag is also cleared at this
- *         step to ensure that there are no external side effects.
+ *  @return Reference to the found child node, or NULL if a node was not found.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireLostChildren
+static tdb_NodeRef_t GetNamedChild
 (
-    le_pathIter_Ref_t pathRef,   ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t shadowNodeRef  ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is the original a stem?  If no, then done.
-    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
-
-    if (originalRef->type != LE_CFG_TYPE_STEM)
+    // Is this one of the "special" names?
+    if (strcmp(nameRef, ".") == 0)
     {
-        return;
+        return nodeRef;
     }
 
-    // Mark all originals deleted.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
-
-    while (originalChildRef != NULL)
+    if (strcmp(nameRef, "..") == 0)
     {
-        // Children in the original tree shouldn't currently be marked as deleted.
-        LE_ASSERT(IsDeleted(originalChildRef) == false);
-
-        SetDeletedFlag(originalChildRef);
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+        return nodeRef->parentRef;
     }
 
-    // Follow through all of the shadow links and unmark deletions.
-    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    // If the current node isn't a stem, then this node can't have any children.
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
     {
-        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
-
-        while (shadowChildRef != NULL)
-        {
-            if (shadowChildRef->shadowRef != NULL)
-            {
-                ClearDeletedFlag(shadowChildRef->shadowRef);
-            }
-
-            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
-        }
+        return NULL;
     }
 
-    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
-    // in order to leave everything as it was.
-    originalChildRef = tdb_GetFirstChildNode(originalRef);
-
-    while (originalChildRef != NULL)
-    {
-        if (IsDeleted(originalChildRef) == true)
-        {
-            FireAllChildren(pathRef, originalChildRef);
-            ClearDeletedFlag(originalChildRef);
-        }
-
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
-    }
+    // Search the child collection for a node with the given name.
+    return FindChild(nodeRef, nameRef);
 }
 
 
@@ -1469,93 +1737,46 @@ static void FireLostChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Recursive function to merge a collection of shadow nodes with the original tree.
+ *  Called to create a named child in a nodes child collection.  However, this function will only
+ *  create nodes on shadow trees.
  *
- *  @return True if the given node or any if it's children have been modified.  False if not.
+ *  @return Reference to newly created child node, or NULL if it can not be created.
  */
 // -------------------------------------------------------------------------------------------------
-static bool InternalMergeTree
+static tdb_NodeRef_t CreateNamedChild
 (
-    const char* treeNamePtr,    ///< [IN] The name of the tree we're merging.
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of hte current node.
-    tdb_NodeRef_t nodeRef,      ///< [IN] Node and any children to merge.
-    bool forceFire              ///< [IN] Should update handlers be fired for this node and all it's
-                                ///<      children, regardless of wether or not this node has been
-                                ///<      directly modified?
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool isModified = IsModified(nodeRef);
-    bool renamed = WasRenamed(nodeRef);
-
-    // If this node was renamed, then all children also need to be triggered as well.
-    forceFire = renamed || forceFire;
+    tdb_NodeRef_t childRef = NULL;
 
-    // If this node has been renamed, marked as deleted or set empty, then all of the children need
-    // notifications fired on the original nodes.
-    if (   (renamed == true)
-        || (IsDeleted(nodeRef) == true)
-        || (OriginalToBeCleared(nodeRef) == true))
+    if (IsShadow(nodeRef) == true)
     {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        if (nodeRef->shadowRef != NULL)
+        // If the node isn't a stem, then convert it into an empty one now.
+        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
+            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
         {
-            GeneratePath(originalPathRef, nodeRef->shadowRef->parentRef);
-            FireAllChildren(originalPathRef, nodeRef->shadowRef);
+            tdb_SetEmpty(nodeRef);
+            nodeRef->type = LE_CFG_TYPE_STEM;
+            nodeRef->info.children = LE_DLS_LIST_INIT;
         }
 
-        le_pathIter_Delete(originalPathRef);
-    }
-    else if (   (isModified == true)
-             && (nodeRef->type == LE_CFG_TYPE_STEM))
-    {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        GeneratePath(originalPathRef, nodeRef->shadowRef);
-        FireLostChildren(originalPathRef, nodeRef);
-
-        le_pathIter_Delete(originalPathRef);
-    }
-
-    AppendNodeName(pathRef, nodeRef);
-
-    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
-    // track of whether any of those children have been modified as well.
-    if (isModified)
-    {
-        MergeNode(nodeRef);
-    }
-
-    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
-        && (IsDeleted(nodeRef) == false))
-    {
-        nodeRef = tdb_GetFirstChildNode(nodeRef);
+        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
+        childRef = NewChildNode(nodeRef);
+        SetDeletedFlag(childRef);
 
-        while (nodeRef != NULL)
+        // Set the name of the new node, if that fails then the user had given us a bad name for the
+        // new node.  So in that case free the node and return NULL.
+        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
         {
-            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
-
-            isModified = InternalMergeTree(treeNamePtr, pathRef, nodeRef, forceFire) || isModified;
-            nodeRef = nextNodeRef;
+            ReleaseNode(childRef);
+            childRef = NULL;
         }
     }
 
-    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
-    // be registered.
-    if (isModified || forceFire)
-    {
-        TriggerCallbacks(pathRef);
-    }
-
-    // Now remove this node from the tracking path and let our caller know if any modifications have
-    // happened at this level or lower.
-    if (le_pathIter_GoToEnd(pathRef) == LE_OK)
-    {
-        le_pathIter_Truncate(pathRef);
-    }
-
-    return isModified;
+    return childRef;
 }
 
 
@@ -1563,31 +1784,19 @@ static bool InternalMergeTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new tree object and set it to default values.
+ *  Check to see if a given node exists within a node's child collection.
  *
- *  @return A ref to the newly created tree object.
+ *  @return True if the given node exists within the parent node's collection.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-tdb_TreeRef_t NewTree
+static bool NodeExists
 (
-    const char* treeNameRef,   ///< [IN] The name of the new tree.
-    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
+    tdb_NodeRef_t parentRef,  ///< [IN] The parent node to search.
+    const char* namePtr       ///< [IN] The name to search for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
-
-    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
-
-    treeRef->isDeletePending = false;
-    treeRef->originalTreeRef = NULL;
-    treeRef->revisionId = 0;
-    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode();
-    treeRef->activeReadCount = 0;
-    treeRef->activeWriteIterRef = NULL;
-    treeRef->requestList = LE_SLS_LIST_INIT;
-
-    return treeRef;
+    return FindChild(parentRef, namePtr) != NULL;
 }
 
 
@@ -1595,25 +1804,28 @@ tdb_TreeRef_t NewTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Destructor called when a tree object is to be freed from memory.
+ *  Check the given node type and see if it should have a string value.
+ *
+ *  @return True if the given node could hold a string value.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void TreeDestructor
+static bool IsStringType
 (
-    void* objectPtr  ///< The memory object to destruct.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
 
-    // Kill the root node.
-    le_mem_Release(treeRef->rootNodeRef);
-    treeRef->rootNodeRef = NULL;
+    if (   (type == LE_CFG_TYPE_STRING)
+        || (type == LE_CFG_TYPE_BOOL)
+        || (type == LE_CFG_TYPE_INT)
+        || (type == LE_CFG_TYPE_FLOAT))
+    {
+        return true;
+    }
 
-    // Sanity check, is the tree actually ready to clean up?
-    LE_ASSERT(treeRef->activeReadCount == 0);
-    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
-    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
+    return false;
 }
 
 
@@ -1621,40 +1833,33 @@ static void TreeDestructor
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a path to a tree file with the given revision id.
- *
- *  @return A stringBuffer backed string containing the full path to the tree file.
+ *  This function will copy a string value from an original tree node into a node that has shadowed
+ *  it.
  */
 // -------------------------------------------------------------------------------------------------
-static void GetTreePath
+static void PropagateValue
 (
-    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
-    int revisionId,           ///< [IN] Generate a name based on the tree revision.
-    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
-    size_t pathSize           ///< [IN] Size of the path buffer.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // paper    --> rock       1 -> 2
-    // rock     --> scissors   2 -> 3
-    // scissors --> paper      3 -> 1
-
-    static const char* revNames[] = { "paper", "rock", "scissors" };
-    int printSize;
-
-    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
+    // If the node doesn't even have a ref to an original node, then there's nothing left to do
+    // here.
+    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
 
-    printSize = snprintf(pathBuffer,
-                         pathSize,
-                         "%s/%s.%s",
-                         CFG_TREE_PATH,
-                         treeNameRef,
-                         revNames[revisionId - 1]);
+    if (shadowRef == NULL)
+    {
+        return;
+    }
 
-    if (printSize >= pathSize)
+    // Ok, figure out the type for this node.  If it has a value, and the original
+    if (   (IsStringType(nodeRef) == true)
+        && (IsStringType(shadowRef) == true)
+        && (nodeRef->info.value.strPtr == NULL)
+        && (shadowRef->info.value.strPtr != NULL))
     {
-       LE_ERROR("Unable to store config tree path in buffer");
-       pathBuffer[0] = '\0';
+        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
+        SetNodeString(nodeRef, &nodeRef->info.value, shadowRef->info.value.strPtr);
     }
 }
 
@@ -1663,57 +1868,105 @@ static void GetTreePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a configTree file at the given revision already exists in the filesystem.
- *
- *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
- *
- *  @return True if the named file exists, false otherwise.
+ *  Merge a shadow node with the original it represents.
  */
 // -------------------------------------------------------------------------------------------------
-static bool TreeFileExists
+static void MergeNode
 (
-    const char* treeNameRef,  ///< [IN] Name of the tree to check.
-    int revisionId            ///< [IN] The revision of the tree to check against.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
+    LE_ASSERT(nodeRef != NULL);
 
-    // Make sure this part was successful.
-    if (fullPath[0] == '\0')
+    // If this shadow node for some reason doesn't have a ref check for an original version of it in
+    // the original tree.  This shadow node may have been destroyed and re-created loosing this
+    // link.
+    if (nodeRef->shadowRef == NULL)
     {
-        return false;
+        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
+
+        if (shadowedParentRef != NULL)
+        {
+            char name[LE_CFG_NAME_LEN_BYTES] = "";
+
+            tdb_GetNodeName(nodeRef, name, sizeof(name));
+            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
+        }
     }
 
-    // stat() the file to see if it exists and get its size.
-    struct stat s;
-    if (stat(fullPath, &s) == -1)
+    // If this node has been marked as deleted, then simply drop the original node and move on.
+    if (IsDeleted(nodeRef))
     {
-        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
-        return false;
+        if (   (nodeRef->shadowRef != NULL)
+            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
+        {
+            ReleaseNode(nodeRef->shadowRef);
+        }
+        else
+        {
+            // We delete every node but the root node.  Since this is the root node, we just need
+            // to clear it out.
+            tdb_SetEmpty(nodeRef->shadowRef);
+        }
+
+        return;
     }
 
-    // Make sure it's a regular file.
-    if (!S_ISREG(s.st_mode))
+    // If the original node doesn't exist, create it now.
+    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
+
+    if (originalRef == NULL)
     {
-        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
+        LE_ASSERT(nodeRef->parentRef != NULL);
+        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
+
+        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
     }
 
-    // If it's zero size, delete it and report that it doesn't exist.
-    if (s.st_size == 0)
+    ClearModifiedFlag(originalRef);
+
+    // If the name has been changed, then copy it over now.
+    if (   (nodeRef->name.strPtr != NULL)
+        && (nodeRef->name.strPtr[0] != '\0'))
     {
-        if (unlink(fullPath) == -1)
+        RemoveFromParentIndex(originalRef);
+        SetNodeString(originalRef, &originalRef->name, nodeRef->name.strPtr);
+        AddToParentIndex(originalRef);
+    }
+
+    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
+    // then clear out the original node.  If the types have changed, then clear out the original so
+    // that we can properly populate it again.
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != originalRef->type))
+    {
+        tdb_SetEmpty(originalRef);
+    }
+
+    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
+    // that it isn't a stem.  If not, then copy over the string value.
+    if (   (nodeType != LE_CFG_TYPE_EMPTY)
+        && (nodeType != LE_CFG_TYPE_STEM))
+    {
+        if (nodeRef->info.value.strPtr != NULL)
         {
-            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
-        }
+            SetNodeString(originalRef, &originalRef->info.value, nodeRef->info.value.strPtr);
 
-        return false;
+            // Propigate over the type as that may have changed, like going from an int value to a
+            // bool value.
+
+            originalRef->type = nodeRef->type;
+        }
     }
 
-    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
+    // Now at this point, if both the original and the shadow node are stems, we'll let the function
+    // InternalMergeTree take care of the children, (if any.)
 
-    return true;
+    // If the original has been cleared out, we can still just rely on InternalMergeTree to
+    // propigate over the new nodes.
 }
 
 
@@ -1721,52 +1974,43 @@ static bool TreeFileExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- * Check the filesystem and get the current "valid" version of the file and update the tree object
- * with that version number.
+ *  Find the registration for one of the children of a watched node.
  *
- * If there are two files for a given tree, we use the older one.  The idea being, if there are
- * two versions of the same file in the filesystem then there was a system failure during a save
- * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
- * unless the size of the older file is zero, which can happen if deletion of that file is
- * interrupted.
+ *  @return The child's registration, or NULL if there are no handlers registered on or below the
+ *          child.
  */
 // -------------------------------------------------------------------------------------------------
-static void UpdateRevision
+static Registration_t* FindChildRegistration
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+    Registration_t* registrationPtr,  ///< [IN] Registration for the parent node, may be NULL.
+    tdb_NodeRef_t childRef            ///< [IN] The child node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    int newRevision = 0;
-
-    if (TreeFileExists(treeRef->name, 1))
+    if (   (registrationPtr == NULL)
+        || (le_dls_IsEmpty(&registrationPtr->childList)))
     {
-        if (TreeFileExists(treeRef->name, 3))
-        {
-            newRevision = 3;
-        }
-        else
-        {
-            newRevision = 1;
-        }
+        return NULL;
     }
-    else if (TreeFileExists(treeRef->name, 3))
+
+    char name[LE_CFG_NAME_LEN_BYTES] = "";
+    tdb_GetNodeName(childRef, name, sizeof(name));
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->childList);
+
+    while (linkPtr != NULL)
     {
-        if (TreeFileExists(treeRef->name, 2))
-        {
-            newRevision = 2;
-        }
-        else
+        Registration_t* childRegistrationPtr = CONTAINER_OF(linkPtr, Registration_t, siblingLink);
+
+        if (strcmp(childRegistrationPtr->namePtr, name) == 0)
         {
-            newRevision = 3;
+            return childRegistrationPtr;
         }
-    }
-    else if (TreeFileExists(treeRef->name, 2))
-    {
-        newRevision = 2;
+
+        linkPtr = le_dls_PeekNext(&registrationPtr->childList, linkPtr);
     }
 
-    treeRef->revisionId = newRevision;
+    return NULL;
 }
 
 
@@ -1774,65 +2018,65 @@ static void UpdateRevision
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Peek into the input stream one character ahead.
+ *  Called to fire any callbacks registered on a node.  The registration is queued to have its
+ *  handlers called once the merge is complete.
  */
 // -------------------------------------------------------------------------------------------------
-static signed char PeekChar
+static void TriggerCallbacks
 (
-    FILE* filePtr  ///< [IN] The file stream to peek into.
+    Registration_t* registrationPtr  ///< [IN] Registration for the node, may be NULL if there are
+                                     ///<      no handlers registered on or below it.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char next = fgetc(filePtr);
-    ungetc(next, filePtr);
-
-    return next;
+    if (   (registrationPtr != NULL)
+        && (registrationPtr->triggered == false)
+        && (le_dls_IsEmpty(&registrationPtr->handlerList) == false))
+    {
+        registrationPtr->triggered = true;
+        le_sls_Queue(&TriggeredList, &registrationPtr->triggeredLink);
+    }
 }
 
 
 
 
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *  Go through the registrations that have been triggered, and fire the call backs for each of them.
  *
- *  @return LE_OK if the whitespace is skiped and there is still more file to read.
- *          LE_OUT_OF_RANGE if the end of the file is hit.
+ *  Once this is done, the triggered flags are cleared for next time.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t SkipWhiteSpace
+static void FireTriggeredCallbacks
 (
-    FILE* filePtr  ///< [IN] The file stream to seek through.
+    void
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool done = false;
-    bool isEof = false;
+    le_sls_Link_t* triggeredLinkPtr;
 
-    while (done == false)
+    while ((triggeredLinkPtr = le_sls_Pop(&TriggeredList)) != NULL)
     {
-        switch (PeekChar(filePtr))
-        {
-            case '\n':
-            case '\r':
-            case '\t':
-            case ' ':
-                // Eat the character.
-                fgetc(filePtr);
-                break;
+        Registration_t* registrationPtr = CONTAINER_OF(triggeredLinkPtr,
+                                                       Registration_t,
+                                                       triggeredLink);
 
-            case EOF:
-                done = true;
-                isEof = true;
-                break;
+        // This registration has been triggered, so call all of the handlers attached to it.
+        le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
 
-            default:
-                done = true;
-                break;
+        while (linkPtr != NULL)
+        {
+            Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+
+            handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
+            linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
         }
-    }
 
-    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+        // Now that that's done, clear the triggered flag.
+        registrationPtr->triggered = false;
+    }
 }
 
 
@@ -1840,32 +2084,39 @@ static le_result_t SkipWhiteSpace
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a boolean literal from the input file.
+ *  Check the given node to see if it was renamed.
  *
- *  @return LE_OK if the literal could be read.
- *          LE_FORMAT_ERROR if the literal could not be read.
+ *  @return True if the node was renamed within this transaction.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static bool ReadBoolToken
+static bool WasRenamed
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next = fgetc(filePtr);
+    if (IsModified(nodeRef) == false)
+    {
+        // The node wasn't even modified, so it can not have been renamed.
+        return false;
+    }
 
-    if (   (next == 't')
-        || (next == 'f'))
+    if (nodeRef->shadowRef == NULL)
     {
-        stringPtr[0] = next;
-        stringPtr[1] = 0;
+        // If the node doesn't have a shadow reference, then most likely this is a new node and not
+        // a rename of an existing one.
+        return false;
+    }
 
-        return LE_OK;
+    if (nodeRef->name.strPtr == NULL)
+    {
+        // The shadow node does not have a local copy of a name, so it can not have been renamed.
+        // It must have been modified for other reasons.
+        return false;
     }
 
-    return LE_FORMAT_ERROR;
+    // Looks like the node has a new name.
+    return true;
 }
 
 
@@ -1873,67 +2124,2096 @@ static bool ReadBoolToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
- *  character is found.
+ *  Check the original non-shadow node to see if it will need to be cleared during the merge.
  *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  @return True if the merge will clear out the original value.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadTextLiteral
+static bool OriginalToBeCleared
 (
-    FILE* filePtr,        ///< [IN]  The file we're reading from.
-    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
-    signed char terminal  ///< [IN]  The terminal character we're searching for.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next;
-    size_t count = 0;
-
-    char* oldPtr = stringPtr;
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
 
-    while ((next = fgetc(filePtr)) != terminal)
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
     {
-        if (next == EOF)
-        {
-            LE_ERROR("Missing end specifier, ']' in int value.");
-            return LE_FORMAT_ERROR;
-        }
+        return true;
+    }
 
-        if (next == '\\')
-        {
-            next = fgetc(filePtr);
+    return false;
+}
 
-            if (next == EOF)
-            {
-                LE_ERROR("Unexpected EOF after finding \\ character.");
-                return LE_FORMAT_ERROR;
-            }
-        }
 
-        *stringPtr = next;
 
-        ++stringPtr;
-        ++count;
 
-        if (count >= (stringSize - 1))
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Append the name of a node onto the end of a path object.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AppendNodeName
+(
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
+    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+    le_result_t result = le_pathIter_Append(pathRef, nodeName);
+
+    LE_WARN_IF(result != LE_OK,
+               "Could not append node '%s' onto the update callback tracking path.  "
+               "Reason: %d, '%s'.",
+               nodeName,
+               result,
+               LE_RESULT_TXT(result));
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Generate a config path to the given node.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GeneratePath
+(
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
+    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (nodeRef == NULL)
+    {
+        return;
+    }
+
+    GeneratePath(pathRef, nodeRef->parentRef);
+    AppendNodeName(pathRef, nodeRef);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Trigger callbacks for this node and all of it's children.  Rather than visiting every child,
+ *  this follows the registrations below the node, and looks up the children they are watching.
+ */
+// -------------------------------------------------------------------------------------------------
+static void FireAllChildren
+(
+    Registration_t* registrationPtr,  ///< [IN] Registration for the node, may be NULL.
+    tdb_NodeRef_t nodeRef             ///< [IN] Node and any children to trigger callbacks for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (registrationPtr == NULL)
+    {
+        return;
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->childList);
+
+    while (linkPtr != NULL)
+    {
+        Registration_t* childRegistrationPtr = CONTAINER_OF(linkPtr, Registration_t, siblingLink);
+        tdb_NodeRef_t childRef = FindChild(nodeRef, childRegistrationPtr->namePtr);
+
+        if (childRef != NULL)
+        {
+            FireAllChildren(childRegistrationPtr, childRef);
+        }
+
+        linkPtr = le_dls_PeekNext(&registrationPtr->childList, linkPtr);
+    }
+
+    TriggerCallbacks(registrationPtr);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check a given shadow node and the original node it's shadowing.  If the original has children
+ *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
+ *  about to go away.
+ *
+ *  The algorithm employed by this function is as follows:
+ *
+ *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
+ *         mark all of the children as deleted.  (This is done with the expectation that the
+ *         original tree does not have nodes with the deleted flag set.)
+ *
+ *      2. Go through the shadow collection, and any shadow children that have links to the original
+ *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *
+ *      3. Travers the original children one more time.  For any node that is still marked as
+ *         deleted we queue up an event handler.  As this node has been removed from the colection
+ *         and will be removed as part of the final merge.  The delete flag is also cleared at this
+ *         step to ensure that there are no external side effects.
+ */
+// -------------------------------------------------------------------------------------------------
+static void FireLostChildren
+(
+    Registration_t* registrationPtr,  ///< [IN] Registration for the node, may be NULL.
+    tdb_NodeRef_t shadowNodeRef       ///< [IN] Node and any children to merge.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If nothing is registered below this node, there's nobody to tell about lost children.
+    if (   (registrationPtr == NULL)
+        || (le_dls_IsEmpty(&registrationPtr->childList)))
+    {
+        return;
+    }
+
+    // Is the original a stem?  If no, then done.
+    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
+
+    if (originalRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
+
+    // Mark all originals deleted.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        // Children in the original tree shouldn't currently be marked as deleted.
+        LE_ASSERT(IsDeleted(originalChildRef) == false);
+
+        SetDeletedFlag(originalChildRef);
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
+
+    // Follow through all of the shadow links and unmark deletions.
+    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
+
+        while (shadowChildRef != NULL)
+        {
+            if (shadowChildRef->shadowRef != NULL)
+            {
+                ClearDeletedFlag(shadowChildRef->shadowRef);
+            }
+
+            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
+        }
+    }
+
+    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
+    // in order to leave everything as it was.
+    originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        if (IsDeleted(originalChildRef) == true)
+        {
+            FireAllChildren(FindChildRegistration(registrationPtr, originalChildRef),
+                            originalChildRef);
+            ClearDeletedFlag(originalChildRef);
+        }
+
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Recursive function to merge a collection of shadow nodes with the original tree.
+ *
+ *  @return True if the given node or any if it's children have been modified.  False if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool InternalMergeTree
+(
+    Registration_t* parentRegPtr,  ///< [IN] Registration for the parent of the current node, NULL
+                                   ///<      if nothing is registered on or below the parent.
+    Registration_t* regPtr,        ///< [IN] Registration for the current node, NULL if nothing is
+                                   ///<      registered on or below it.
+    tdb_NodeRef_t nodeRef,         ///< [IN] Node and any children to merge.
+    bool forceFire                 ///< [IN] Should update handlers be fired for this node and all
+                                   ///<      it's children, regardless of wether or not this node
+                                   ///<      has been directly modified?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool isModified = IsModified(nodeRef);
+    bool renamed = WasRenamed(nodeRef);
+
+    // An unmodified shadow node whose children were never shadowed looks just like its original,
+    // so nothing below it was touched by the transaction.  Such nodes are left alone, rather than
+    // shadowing their children just to find that out.  This keeps the cost of a merge down to the
+    // size of the change, rather than the size of the tree.
+    bool isUntouched =    (isModified == false)
+                       && (   (nodeRef->type != LE_CFG_TYPE_STEM)
+                           || (le_dls_IsEmpty(&nodeRef->info.children)));
+
+    // If this node was renamed, then all children also need to be triggered as well.
+    forceFire = renamed || forceFire;
+
+    // If this node has been renamed, marked as deleted or set empty, then all of the children need
+    // notifications fired on the original nodes.
+    if (   (renamed == true)
+        || (IsDeleted(nodeRef) == true)
+        || (   (isUntouched == false)
+            && (OriginalToBeCleared(nodeRef) == true)))
+    {
+        if (nodeRef->shadowRef != NULL)
+        {
+            // The handlers to fire are the ones registered under the original's name.
+            Registration_t* originalRegPtr = renamed
+                                             ? FindChildRegistration(parentRegPtr,
+                                                                     nodeRef->shadowRef)
+                                             : regPtr;
+
+            FireAllChildren(originalRegPtr, nodeRef->shadowRef);
+        }
+    }
+    else if (   (isModified == true)
+             && (nodeRef->type == LE_CFG_TYPE_STEM))
+    {
+        FireLostChildren(regPtr, nodeRef);
+    }
+
+    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
+    // track of whether any of those children have been modified as well.
+    if (isModified)
+    {
+        MergeNode(nodeRef);
+    }
+
+    // Unless handlers registered below it have to be fired, there's no need to walk through the
+    // children of an untouched node.
+    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
+        && (IsDeleted(nodeRef) == false)
+        && (   (   (forceFire == true)
+                && (regPtr != NULL))
+            || (isUntouched == false)))
+    {
+        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+
+        while (childRef != NULL)
+        {
+            tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
+
+            isModified = InternalMergeTree(regPtr,
+                                           FindChildRegistration(regPtr, childRef),
+                                           childRef,
+                                           forceFire) || isModified;
+            childRef = nextChildRef;
+        }
+    }
+
+    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
+    // be registered.
+    if (isModified || forceFire)
+    {
+        TriggerCallbacks(regPtr);
+    }
+
+    // Let our caller know if any modifications have happened at this level or lower.
+    return isModified;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new tree object and set it to default values.
+ *
+ *  @return A ref to the newly created tree object.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t NewTree
+(
+    const char* treeNameRef,   ///< [IN] The name of the new tree.
+    arena_Ref_t arenaRef,      ///< [IN] Arena for the tree's nodes, or NULL to use the node pool.
+    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
+
+    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
+
+    treeRef->isDeletePending = false;
+    treeRef->originalTreeRef = NULL;
+    treeRef->isSnapshot = false;
+    treeRef->revisionId = 0;
+    treeRef->arenaRef = arenaRef;
+    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode(arenaRef);
+    treeRef->activeReadCount = 0;
+    treeRef->activeWriteIterRef = NULL;
+    treeRef->requestList = LE_SLS_LIST_INIT;
+    treeRef->journalFd = -1;
+    treeRef->journalSize = 0;
+    treeRef->snapshotSize = 0;
+    treeRef->isCompactPending = false;
+
+    return treeRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Destructor called when a tree object is to be freed from memory.
+ */
+// -------------------------------------------------------------------------------------------------
+static void TreeDestructor
+(
+    void* objectPtr  ///< The memory object to destruct.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
+
+    // Kill the root node.  If the tree has an arena, that frees every node in it in one go.
+    ReleaseNode(treeRef->rootNodeRef);
+    treeRef->rootNodeRef = NULL;
+
+    if (treeRef->arenaRef != NULL)
+    {
+        arena_Delete(treeRef->arenaRef);
+        treeRef->arenaRef = NULL;
+    }
+
+    // Sanity check, is the tree actually ready to clean up?
+    LE_ASSERT(treeRef->activeReadCount == 0);
+    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
+    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
+    LE_ASSERT(treeRef->journalFd == -1);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a path to a tree file with the given revision id.
+ *
+ *  @return A stringBuffer backed string containing the full path to the tree file.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetTreePath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    int revisionId,           ///< [IN] Generate a name based on the tree revision.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // paper    --> rock       1 -> 2
+    // rock     --> scissors   2 -> 3
+    // scissors --> paper      3 -> 1
+
+    static const char* revNames[] = { "paper", "rock", "scissors" };
+    int printSize;
+
+    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
+
+    printSize = snprintf(pathBuffer,
+                         pathSize,
+                         "%s/%s.%s",
+                         CFG_TREE_PATH,
+                         treeNameRef,
+                         revNames[revisionId - 1]);
+
+    if (printSize >= pathSize)
+    {
+       LE_ERROR("Unable to store config tree path in buffer");
+       pathBuffer[0] = '\0';
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check to see if a configTree file at the given revision already exists in the filesystem.
+ *
+ *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
+ *
+ *  @return True if the named file exists, false otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool TreeFileExists
+(
+    const char* treeNameRef,  ///< [IN] Name of the tree to check.
+    int revisionId            ///< [IN] The revision of the tree to check against.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
+
+    // Make sure this part was successful.
+    if (fullPath[0] == '\0')
+    {
+        return false;
+    }
+
+    // stat() the file to see if it exists and get its size.
+    struct stat s;
+    if (stat(fullPath, &s) == -1)
+    {
+        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
+        return false;
+    }
+
+    // Make sure it's a regular file.
+    if (!S_ISREG(s.st_mode))
+    {
+        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
+    }
+
+    // If it's zero size, delete it and report that it doesn't exist.
+    if (s.st_size == 0)
+    {
+        if (unlink(fullPath) == -1)
+        {
+            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
+        }
+
+        return false;
+    }
+
+    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
+
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Check the filesystem and get the current "valid" version of the file and update the tree object
+ * with that version number.
+ *
+ * If there are two files for a given tree, we use the older one.  The idea being, if there are
+ * two versions of the same file in the filesystem then there was a system failure during a save
+ * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
+ * unless the size of the older file is zero, which can happen if deletion of that file is
+ * interrupted.
+ */
+// -------------------------------------------------------------------------------------------------
+static void UpdateRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int newRevision = 0;
+
+    if (TreeFileExists(treeRef->name, 1))
+    {
+        if (TreeFileExists(treeRef->name, 3))
+        {
+            newRevision = 3;
+        }
+        else
+        {
+            newRevision = 1;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 3))
+    {
+        if (TreeFileExists(treeRef->name, 2))
+        {
+            newRevision = 2;
+        }
+        else
+        {
+            newRevision = 3;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 2))
+    {
+        newRevision = 2;
+    }
+
+    treeRef->revisionId = newRevision;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Peek into the input stream one character ahead.
+ */
+// -------------------------------------------------------------------------------------------------
+static signed char PeekChar
+(
+    FILE* filePtr  ///< [IN] The file stream to peek into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char next = fgetc(filePtr);
+    ungetc(next, filePtr);
+
+    return next;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *
+ *  @return LE_OK if the whitespace is skiped and there is still more file to read.
+ *          LE_OUT_OF_RANGE if the end of the file is hit.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t SkipWhiteSpace
+(
+    FILE* filePtr  ///< [IN] The file stream to seek through.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool done = false;
+    bool isEof = false;
+
+    while (done == false)
+    {
+        switch (PeekChar(filePtr))
+        {
+            case '\n':
+            case '\r':
+            case '\t':
+            case ' ':
+                // Eat the character.
+                fgetc(filePtr);
+                break;
+
+            case EOF:
+                done = true;
+                isEof = true;
+                break;
+
+            default:
+                done = true;
+                break;
+        }
+    }
+
+    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a boolean literal from the input file.
+ *
+ *  @return LE_OK if the literal could be read.
+ *          LE_FORMAT_ERROR if the literal could not be read.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool ReadBoolToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next = fgetc(filePtr);
+
+    if (   (next == 't')
+        || (next == 'f'))
+    {
+        stringPtr[0] = next;
+        stringPtr[1] = 0;
+
+        return LE_OK;
+    }
+
+    return LE_FORMAT_ERROR;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
+ *  character is found.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadTextLiteral
+(
+    FILE* filePtr,        ///< [IN]  The file we're reading from.
+    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
+    signed char terminal  ///< [IN]  The terminal character we're searching for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next;
+    size_t count = 0;
+
+    char* oldPtr = stringPtr;
+
+    while ((next = fgetc(filePtr)) != terminal)
+    {
+        if (next == EOF)
+        {
+            LE_ERROR("Missing end specifier, ']' in int value.");
+            return LE_FORMAT_ERROR;
+        }
+
+        if (next == '\\')
+        {
+            next = fgetc(filePtr);
+
+            if (next == EOF)
+            {
+                LE_ERROR("Unexpected EOF after finding \\ character.");
+                return LE_FORMAT_ERROR;
+            }
+        }
+
+        *stringPtr = next;
+
+        ++stringPtr;
+        ++count;
+
+        if (count >= (stringSize - 1))
+        {
+            *stringPtr = 0;
+
+            LE_ERROR("String literal, '%s', too large.  (%zd/%zd)",
+                     oldPtr,
+                     strlen(oldPtr),
+                     stringSize);
+
+            return LE_FORMAT_ERROR;
+        }
+    }
+
+    *stringPtr = 0;
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read an integer token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadIntToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+
+    // TODO: Validate the int string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a floating point token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadFloatToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+
+    // TODO: Validate the float string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a string from the config tree file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadStringToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+
+    // TODO: Validate the literal string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a token from the input stream.
+ *
+ *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
+ *          before a token could be finished.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadToken
+(
+    FILE* filePtr,         ///< [IN]  The file we're reading from.
+    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
+    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    *stringPtr = 0;
+
+    if (SkipWhiteSpace(filePtr) != LE_OK)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    signed char next;
+
+    while ((next = fgetc(filePtr)) != EOF)
+    {
+        switch (next)
+        {
+            case '~':
+                *typePtr = TT_EMPTY_VALUE;
+                return LE_OK;
+
+            case '!':
+                *typePtr = TT_BOOL_VALUE;
+                return ReadBoolToken(filePtr, stringPtr, stringSize);
+
+            case '[':
+                *typePtr = TT_INT_VALUE;
+                return ReadIntToken(filePtr, stringPtr, stringSize);
+
+            case '(':
+                *typePtr = TT_FLOAT_VALUE;
+                return ReadFloatToken(filePtr, stringPtr, stringSize);
+
+            case '\"':
+                *typePtr = TT_STRING_VALUE;
+                return ReadStringToken(filePtr, stringPtr, stringSize);
+
+            case '{':
+                *typePtr = TT_OPEN_GROUP;
+                return LE_OK;
+
+            case '}':
+                *typePtr = TT_CLOSE_GROUP;
+                return LE_OK;
+
+            default:
+                LE_ERROR("Unexpected character in input stream.");
+                return LE_FORMAT_ERROR;
+        }
+    }
+
+    return LE_OUT_OF_RANGE;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write data to the output stream.  This function will record any faults to the system log.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteFile
+(
+    FILE* filePtr,        ///< [IN] The file being written to.
+    const void* dataPtr,  ///< [IN] The data being written to the file.
+    size_t dataSize       ///< [IN] The amount of data being written.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+
+    if (ferror(filePtr) != 0)
+    {
+        LE_EMERG("Failed to write to config tree file.");
+        return LE_IO_ERROR;
+    }
+
+    if (written < dataSize)
+    {
+        LE_EMERG("Data truncated while writing to configuration file.");
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a string token to the output stream.  This function will write the string and escape all
+ *  control characters as it does so.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteStringValue
+(
+    FILE* filePtr,         ///< [IN] The file to write to.
+    char startChar,        ///< [IN] The delimiter to use.
+    char endChar,          ///< [IN] The closing delimiter to use.
+    const char* stringPtr  ///< [IN] The actual string to write.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    result = WriteFile(filePtr, &startChar, 1);
+
+    while (   (*stringPtr != 0)
+           && (result == LE_OK))
+    {
+        if (   (*stringPtr == '\"')
+            || (*stringPtr == '\\'))
+        {
+            result = WriteFile(filePtr, "\\", 1);
+        }
+
+        if (result == LE_OK)
+        {
+            result = WriteFile(filePtr, stringPtr, 1);
+        }
+
+        stringPtr++;
+    }
+
+    if (result == LE_OK)
+    {
+        char strBuffer[2] = { endChar, ' ' };
+        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node value from the given file.  If the value is a collection, then read in those nodes
+ *  too.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if parse errors are encountered.
+ *          LE_NOT_FOUND if the end of file is reached.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalReadNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
+    FILE* filePtr,          ///< [IN] The file we're reading the value from.
+    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    TokenType_t tokenType;
+
+    // Try to read this node's value.
+    if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+    {
+        LE_ERROR("Unexpected EOF or bad token in file.");
+        return LE_FORMAT_ERROR;
+    }
+
+    tdb_SetEmpty(nodeRef);
+
+    switch (tokenType)
+    {
+        case TT_BOOL_VALUE:
+        case TT_INT_VALUE:
+        case TT_FLOAT_VALUE:
+        case TT_STRING_VALUE:
+            if (tdb_SetValueAsString(nodeRef, stringBuffer) != LE_OK)
+            {
+                LE_ERROR("Value string is too long.");
+                return LE_FORMAT_ERROR;
+            }
+
+            if (tokenType == TT_BOOL_VALUE)
+            {
+                nodeRef->type = LE_CFG_TYPE_BOOL;
+            }
+            else if (tokenType == TT_INT_VALUE)
+            {
+                nodeRef->type = LE_CFG_TYPE_INT;
+            }
+            else if (tokenType == TT_FLOAT_VALUE)
+            {
+                nodeRef->type = LE_CFG_TYPE_FLOAT;
+            }
+            break;
+
+        case TT_EMPTY_VALUE:
+            // The node has already been cleared, so there's nothing left to do but make sure that
+            // the node exists.
+            ClearDeletedFlag(nodeRef);
+            break;
+
+        case TT_OPEN_GROUP:
+            while (tokenType != TT_CLOSE_GROUP)
+            {
+                if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+                {
+                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
+                    return LE_FORMAT_ERROR;
+                }
+
+                if (tokenType == TT_STRING_VALUE)
+                {
+                    size_t strLen = le_utf8_NumBytes(stringBuffer);
+                    size_t newPathLen = pathLen + 1 + strLen;
+
+                    if (newPathLen > LE_CFG_STR_LEN)
+                    {
+                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
+                                 stringBuffer,
+                                 strLen,
+                                 (size_t)LE_CFG_STR_LEN);
+
+                        return LE_FORMAT_ERROR;
+                    }
+
+                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+
+                    if (childRef == NULL)
+                    {
+                        childRef = NewChildNode(nodeRef);
+                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
+                        {
+                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
+                            return LE_FORMAT_ERROR;
+                        }
+
+                        LE_DEBUG("New node, %s", stringBuffer);
+                    }
+
+                    tdb_EnsureExists(childRef);
+
+                    le_result_t result = InternalReadNode(childRef, filePtr, newPathLen);
+
+                    if (result != LE_OK)
+                    {
+                        return result;
+                    }
+                }
+                else if (tokenType == TT_CLOSE_GROUP)
+                {
+                    break;
+                }
+                else
+                {
+                    LE_ERROR("Unexpected token in found while looking for '}'.");
+                    return LE_FORMAT_ERROR;
+                }
+            }
+            break;
+
+        case TT_CLOSE_GROUP:
+        default:
+            LE_ERROR("Unexpected token found.");
+            return LE_FORMAT_ERROR;
+    }
+
+    if (IsShadow(nodeRef) == false)
+    {
+        ClearModifiedFlag(nodeRef);
+    }
+    else
+    {
+        SetModifiedFlag(nodeRef);
+    }
+
+    tdb_EnsureExists(nodeRef);
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree node and it's children to a file in the filesystem.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalWriteNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
+    FILE* filePtr           ///< [IN] The file being written to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If there is no node to write, or if the node is marked as having been deleted...  Then write
+    // a blank node.
+    if (   (nodeRef == NULL)
+        || (IsDeleted(nodeRef) == true))
+    {
+        return WriteFile(filePtr, "~ ", 2);
+    }
+
+    // Get the node's value as a string.
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    le_result_t result = LE_OK;
+
+    tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
+
+    // Now, depending on the type of node, write out any required format information.
+    switch (nodeRef->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            result = WriteFile(filePtr, "~ ", 2);
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            {
+                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
+                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
+            }
+            break;
+
+        case LE_CFG_TYPE_STRING:
+            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_INT:
+            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
+            break;
+
+        // Looks like this node is a collection, so write out it's child nodes now.
+        case LE_CFG_TYPE_STEM:
+            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
+            {
+                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+                while (   (childRef != NULL)
+                       && (result == LE_OK))
+                {
+                    tdb_GetNodeName(childRef, stringBuffer, sizeof(stringBuffer));
+                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+
+                    if (result == LE_OK)
+                    {
+                        result = InternalWriteNode(childRef, filePtr);
+                    }
+
+                    childRef = tdb_GetNextActiveSiblingNode(childRef);
+                }
+
+                if (result == LE_OK)
+                {
+                    result = WriteFile(filePtr, "} ", 2);
+                }
+            }
+            break;
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Calculate the number of bytes required to store a node path, including seperators and a trailing
+ *  NULL.
+ *
+ *  @return The amount of bytes required to store the whole path string.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t ComputePathLength
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t pathLen = 0;
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    while (nodeRef != NULL)
+    {
+        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+
+        // Add this path segment's length to our running total, along with the required path
+        // seperator.
+        pathLen += 1 + le_utf8_NumBytes(nodeName);
+        nodeRef = tdb_GetNodeParent(nodeRef);
+    }
+
+    // Don't forget to include a spot for the trailing NULL.
+    return pathLen + 1;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Bump up the version id of this tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void IncrementRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    treeRef->revisionId++;
+
+    if (treeRef->revisionId > 3)
+    {
+        treeRef->revisionId = 1;
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create the path to a tree's journal file.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetJournalPath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int printSize = snprintf(pathBuffer, pathSize, "%s/%s.journal", CFG_TREE_PATH, treeNameRef);
+
+    if (printSize >= pathSize)
+    {
+       LE_ERROR("Unable to store config tree journal path in buffer");
+       pathBuffer[0] = '\0';
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add a block of data to the checksum of a journal entry.  (This is a 32-bit FNV-1a hash.)
+ *
+ *  @return The updated checksum.
+ */
+// -------------------------------------------------------------------------------------------------
+static uint32_t UpdateChecksum
+(
+    uint32_t checksum,    ///< [IN] Checksum so far, JOURNAL_CHECKSUM_INIT for a new checksum.
+    const void* dataPtr,  ///< [IN] The data to add to the checksum.
+    size_t dataSize       ///< [IN] The amount of data.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    const uint8_t* bytePtr = dataPtr;
+
+    while (dataSize > 0)
+    {
+        checksum = (checksum ^ *bytePtr) * 16777619;
+        bytePtr++;
+        dataSize--;
+    }
+
+    return checksum;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the node at the given path of a journal record.  If the node doesn't exist, it (and any
+ *  missing parent nodes) can optionally be created.
+ *
+ *  @return The node, or NULL if it doesn't exist and wasn't created, or if the path is bad.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t GetJournalNode
+(
+    tdb_NodeRef_t rootRef,  ///< [IN] The root node of the tree being loaded.
+    const char* pathPtr,    ///< [IN] The absolute path of the node.
+    bool create             ///< [IN] Create the node if it doesn't exist?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_pathIter_Ref_t pathRef = le_pathIter_CreateForUnix(pathPtr);
+    tdb_NodeRef_t currentRef = rootRef;
+    char nameRef[LE_CFG_NAME_LEN_BYTES] = "";
+
+    le_result_t result = le_pathIter_GoToStart(pathRef);
+
+    while (   (result != LE_NOT_FOUND)
+           && (currentRef != NULL))
+    {
+        result = le_pathIter_GetCurrentNode(pathRef, nameRef, sizeof(nameRef));
+
+        if (result == LE_OK)
+        {
+            tdb_NodeRef_t childRef = GetNamedChild(currentRef, nameRef);
+
+            if (   (childRef == NULL)
+                && (create == true))
+            {
+                // A value node has to be cleared out before it can be given children.
+                if (currentRef->type != LE_CFG_TYPE_STEM)
+                {
+                    tdb_SetEmpty(currentRef);
+                }
+
+                childRef = NewChildNode(currentRef);
+
+                if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
+                {
+                    LE_ERROR("Bad node name, '%s'.", nameRef);
+                    ReleaseNode(childRef);
+                    childRef = NULL;
+                }
+                else
+                {
+                    ClearModifiedFlag(childRef);
+                }
+
+                ClearModifiedFlag(currentRef);
+            }
+
+            currentRef = childRef;
+            result = le_pathIter_GoToNext(pathRef);
+        }
+        else if (result != LE_NOT_FOUND)
+        {
+            LE_ERROR("Bad path segment in journal path, '%s'.", pathPtr);
+            currentRef = NULL;
+        }
+    }
+
+    le_pathIter_Delete(pathRef);
+
+    return currentRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Apply the records of one journal entry to a tree.
+ *
+ *  @return LE_OK if all of the records were applied.
+ *          LE_FORMAT_ERROR if a bad record was found.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReplayJournalEntry
+(
+    tdb_NodeRef_t rootRef,  ///< [IN] The root node of the tree being loaded.
+    FILE* filePtr,          ///< [IN] The journal, positioned at the start of the entry's records.
+    long entryEnd           ///< [IN] Offset of the end of the entry in the journal.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    while (   (SkipWhiteSpace(filePtr) == LE_OK)
+           && (ftell(filePtr) < entryEnd))
+    {
+        int recordType = fgetc(filePtr);
+        TokenType_t tokenType;
+
+        if (   (ReadToken(filePtr, pathBuffer, sizeof(pathBuffer), &tokenType) != LE_OK)
+            || (tokenType != TT_STRING_VALUE))
+        {
+            LE_ERROR("Bad node path in journal record.");
+            return LE_FORMAT_ERROR;
+        }
+
+        tdb_NodeRef_t nodeRef;
+
+        switch (recordType)
+        {
+            case JOURNAL_SET_RECORD:
+                nodeRef = GetJournalNode(rootRef, pathBuffer, true);
+
+                if (   (nodeRef == NULL)
+                    || (InternalReadNode(nodeRef, filePtr, ComputePathLength(nodeRef)) != LE_OK))
+                {
+                    LE_ERROR("Could not replay the journal record for '%s'.", pathBuffer);
+                    return LE_FORMAT_ERROR;
+                }
+                break;
+
+            case JOURNAL_DELETE_RECORD:
+                nodeRef = GetJournalNode(rootRef, pathBuffer, false);
+
+                if (nodeRef == rootRef)
+                {
+                    // The root node is never deleted, only cleared out.
+                    tdb_SetEmpty(nodeRef);
+                    ClearModifiedFlag(nodeRef);
+                }
+                else if (nodeRef != NULL)
+                {
+                    tdb_DeleteNode(nodeRef);
+                }
+                break;
+
+            default:
+                LE_ERROR("Unexpected journal record type, '%c'.", recordType);
+                return LE_FORMAT_ERROR;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check the checksum of the journal entry at the current position in the journal.
+ *
+ *  @return True if the whole entry is there and its checksum matches, false if not.  On return the
+ *          file position is somewhere inside the entry.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool IsJournalEntryValid
+(
+    FILE* filePtr,      ///< [IN] The journal, positioned at the start of the entry's records.
+    size_t entrySize,   ///< [IN] Size of the entry's records.
+    uint32_t checksum   ///< [IN] The checksum from the entry's header.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    uint32_t actualChecksum = JOURNAL_CHECKSUM_INIT;
+    char buffer[512];
+
+    while (entrySize > 0)
+    {
+        size_t readSize = fread(buffer,
+                                1,
+                                (entrySize < sizeof(buffer)) ? entrySize : sizeof(buffer),
+                                filePtr);
+
+        if (readSize == 0)
+        {
+            return false;
+        }
+
+        actualChecksum = UpdateChecksum(actualChecksum, buffer, readSize);
+        entrySize -= readSize;
+    }
+
+    return actualChecksum == checksum;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Replay a tree's journal on top of the tree that was loaded from its tree file.
+ *
+ *  If the journal was written for a different revision of the tree file, it is left over from an
+ *  interrupted compaction, and its changes are already in the tree file.  So it is deleted.  If an
+ *  entry at the end of the journal is incomplete or corrupted, it is cut off the journal.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReplayJournal
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree being loaded.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeRef->name, pathPtr, sizeof(pathPtr));
+
+    treeRef->journalSize = 0;
+
+    FILE* filePtr = fopen(pathPtr, "r");
+
+    if (filePtr == NULL)
+    {
+        LE_ERROR_IF(errno != ENOENT, "Could not open journal file '%s' (%m).", pathPtr);
+        return;
+    }
+
+    int baseRevisionId;
+
+    if (   (fscanf(filePtr, JOURNAL_HEADER_FORMAT, &baseRevisionId) != 1)
+        || (baseRevisionId != treeRef->revisionId))
+    {
+        LE_INFO("Discarding stale journal '%s'.", pathPtr);
+        fclose(filePtr);
+
+        if (unlink(pathPtr) != 0)
+        {
+            LE_ERROR("File delete failure, '%s', reason '%m'.", pathPtr);
+        }
+
+        return;
+    }
+
+    long validSize = ftell(filePtr);
+    size_t entryCount = 0;
+    bool isTruncated = false;
+
+    while (true)
+    {
+        size_t entrySize;
+        uint32_t checksum;
+        int scanCount = fscanf(filePtr, JOURNAL_ENTRY_SCAN_FORMAT, &entrySize, &checksum);
+
+        if (scanCount == EOF)
+        {
+            break;
+        }
+
+        long entryStart = ftell(filePtr);
+
+        if (   (scanCount != 2)
+            || (IsJournalEntryValid(filePtr, entrySize, checksum) == false))
+        {
+            isTruncated = true;
+            break;
+        }
+
+        fseek(filePtr, entryStart, SEEK_SET);
+
+        if (ReplayJournalEntry(treeRef->rootNodeRef, filePtr, entryStart + entrySize) != LE_OK)
+        {
+            isTruncated = true;
+            break;
+        }
+
+        fseek(filePtr, entryStart + entrySize, SEEK_SET);
+        validSize = ftell(filePtr);
+        entryCount++;
+    }
+
+    fclose(filePtr);
+
+    if (isTruncated)
+    {
+        LE_WARN("Discarding incomplete entry at offset %ld of journal '%s'.", validSize, pathPtr);
+
+        if (truncate(pathPtr, validSize) != 0)
+        {
+            LE_ERROR("Could not truncate journal '%s' (%m).", pathPtr);
+        }
+    }
+
+    LE_DEBUG("Replayed %zu journal entries from '%s'.", entryCount, pathPtr);
+    treeRef->journalSize = validSize;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get a string out of the string table of a binary tree file.
+ *
+ *  @return A pointer to the string, or NULL if the offset is outside of the string table.
+ */
+// -------------------------------------------------------------------------------------------------
+static const char* GetBinaryString
+(
+    const BinaryLoadContext_t* contextPtr,  ///< [IN] The file being loaded.
+    uint32_t offset                         ///< [IN] Offset of the string in the string table.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // The string table is known to end with a NULL, so any offset within it is a valid string.
+    if (offset >= contextPtr->stringTableSize)
+    {
+        LE_ERROR("String offset %" PRIu32 " is outside of the string table.", offset);
+        return NULL;
+    }
+
+    return contextPtr->stringsPtr + offset;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Load a node from a binary tree file, along with all of its children.
+ *
+ *  @return LE_OK if the node was loaded, LE_FORMAT_ERROR if the file is corrupted.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t LoadBinaryNode
+(
+    tdb_NodeRef_t nodeRef,              ///< [IN] The node to load the record into.
+    const BinaryNode_t* recordPtr,      ///< [IN] The node's record in the file.
+    BinaryLoadContext_t* contextPtr,    ///< [IN] The file being loaded.
+    size_t pathLen                      ///< [IN] The length of the path including nodeRef.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    const char* valuePtr;
+
+    switch (recordPtr->tokenType)
+    {
+        case TT_EMPTY_VALUE:
+            break;
+
+        case TT_BOOL_VALUE:
+        case TT_INT_VALUE:
+        case TT_FLOAT_VALUE:
+        case TT_STRING_VALUE:
+            if ((valuePtr = GetBinaryString(contextPtr, recordPtr->info)) == NULL)
+            {
+                return LE_FORMAT_ERROR;
+            }
+
+            if (tdb_SetValueAsString(nodeRef, valuePtr) != LE_OK)
+            {
+                LE_ERROR("Value string is too long.");
+                return LE_FORMAT_ERROR;
+            }
+
+            if (recordPtr->tokenType == TT_BOOL_VALUE)
+            {
+                nodeRef->type = LE_CFG_TYPE_BOOL;
+            }
+            else if (recordPtr->tokenType == TT_INT_VALUE)
+            {
+                nodeRef->type = LE_CFG_TYPE_INT;
+            }
+            else if (recordPtr->tokenType == TT_FLOAT_VALUE)
+            {
+                nodeRef->type = LE_CFG_TYPE_FLOAT;
+            }
+            break;
+
+        case TT_OPEN_GROUP:
+            for (uint32_t i = 0; i < recordPtr->info; i++)
+            {
+                if (contextPtr->nextNodeIndex >= contextPtr->nodeCount)
+                {
+                    LE_ERROR("Binary tree file ends in the middle of a collection.");
+                    return LE_FORMAT_ERROR;
+                }
+
+                const BinaryNode_t* childRecordPtr =
+                                                &contextPtr->nodesPtr[contextPtr->nextNodeIndex];
+                contextPtr->nextNodeIndex++;
+
+                const char* namePtr = GetBinaryString(contextPtr, childRecordPtr->nameOffset);
+
+                if (namePtr == NULL)
+                {
+                    return LE_FORMAT_ERROR;
+                }
+
+                size_t newPathLen = pathLen + 1 + le_utf8_NumBytes(namePtr);
+
+                if (newPathLen > LE_CFG_STR_LEN)
+                {
+                    LE_ERROR("New path length for node '%s' is too long.", namePtr);
+                    return LE_FORMAT_ERROR;
+                }
+
+                tdb_NodeRef_t childRef = NewChildNode(nodeRef);
+
+                if (tdb_SetNodeName(childRef, namePtr) != LE_OK)
+                {
+                    LE_ERROR("Bad node name, '%s'.", namePtr);
+                    return LE_FORMAT_ERROR;
+                }
+
+                le_result_t result = LoadBinaryNode(childRef,
+                                                    childRecordPtr,
+                                                    contextPtr,
+                                                    newPathLen);
+
+                if (result != LE_OK)
+                {
+                    return result;
+                }
+            }
+            break;
+
+        default:
+            LE_ERROR("Unexpected node type, %" PRIu32 ", in binary tree file.",
+                     recordPtr->tokenType);
+            return LE_FORMAT_ERROR;
+    }
+
+    ClearModifiedFlag(nodeRef);
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Load a tree from the contents of a binary tree file.
+ *
+ *  @return True if the tree was loaded, false if the file is corrupted.  (In which case the root
+ *          node is left empty.)
+ */
+// -------------------------------------------------------------------------------------------------
+static bool LoadBinaryTree
+(
+    tdb_NodeRef_t rootRef,  ///< [IN] The root node of the tree being loaded.
+    const void* dataPtr,    ///< [IN] The contents of the file.
+    size_t dataSize         ///< [IN] Size of the file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    const BinaryTreeHeader_t* headerPtr = dataPtr;
+    BinaryLoadContext_t context;
+
+    LE_ASSERT(dataSize >= sizeof(BinaryTreeHeader_t));
+
+    context.nodesPtr = (const BinaryNode_t*)(headerPtr + 1);
+    context.nodeCount = headerPtr->nodeCount;
+    context.nextNodeIndex = 1;
+    context.stringTableSize = headerPtr->stringTableSize;
+
+    // Check the counts against the size of the file without multiplying first, so that a corrupt
+    // header can't wrap the sum around on 32-bit targets.
+    size_t bodySize = dataSize - sizeof(BinaryTreeHeader_t);
+
+    if (   (context.nodeCount == 0)
+        || (context.nodeCount > bodySize / sizeof(BinaryNode_t))
+        || (context.stringTableSize == 0)
+        || (context.stringTableSize
+                != bodySize - ((size_t)context.nodeCount * sizeof(BinaryNode_t))))
+    {
+        LE_ERROR("Binary tree file header doesn't match the size of the file.");
+        return false;
+    }
+
+    context.stringsPtr = (const char*)(context.nodesPtr + context.nodeCount);
+
+    if (context.stringsPtr[context.stringTableSize - 1] != '\0')
+    {
+        LE_ERROR("Binary tree file string table isn't terminated.");
+        return false;
+    }
+
+    tdb_SetEmpty(rootRef);
+    tdb_EnsureExists(rootRef);
+
+    le_result_t result = LoadBinaryNode(rootRef,
+                                        &context.nodesPtr[0],
+                                        &context,
+                                        ComputePathLength(rootRef));
+
+    if (   (result == LE_OK)
+        && (context.nextNodeIndex != context.nodeCount))
+    {
+        LE_ERROR("Unexpected nodes found at the end of the binary tree file.");
+        result = LE_FORMAT_ERROR;
+    }
+
+    if (result != LE_OK)
+    {
+        tdb_SetEmpty(rootRef);
+        ClearModifiedFlag(rootRef);
+        return false;
+    }
+
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a tree file into a tree.  Binary tree files are mapped into memory and loaded in a single
+ *  pass.  Otherwise the file is parsed as a text tree file.
+ *
+ *  @return True if the read is successful, or false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool ReadTreeFile
+(
+    tdb_NodeRef_t rootRef,  ///< [IN] The root node of the tree being loaded.
+    int descriptor,         ///< [IN] The tree file.
+    size_t fileSize         ///< [IN] Size of the tree file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (fileSize >= sizeof(BinaryTreeHeader_t))
+    {
+        void* mapPtr = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+        if (mapPtr == MAP_FAILED)
         {
-            *stringPtr = 0;
+            LE_ERROR("Could not map tree file (%m).");
+        }
+        else
+        {
+            bool isBinary = (memcmp(mapPtr, BINARY_TREE_MAGIC, BINARY_TREE_MAGIC_BYTES) == 0);
+            bool result = false;
+
+            if (isBinary)
+            {
+                result = LoadBinaryTree(rootRef, mapPtr, fileSize);
+            }
+
+            munmap(mapPtr, fileSize);
+
+            if (isBinary)
+            {
+                return result;
+            }
+        }
+    }
+
+    return tdb_ReadTreeNode(rootRef, descriptor);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Attempt to load a configuration tree from a config file.  This function will look for the latest
+ *  valid version of the config file and load that one, then replay the tree's journal on top of it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void LoadTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If we don't know the revision then hunt it out from the filesystem.
+    if (treeRef->revisionId == 0)
+    {
+        UpdateRevision(treeRef);
+    }
+
+    // If this tree has no root, create it now.
+    if (treeRef->rootNodeRef == NULL)
+    {
+        treeRef->rootNodeRef = NewNode(treeRef->arenaRef);
+    }
+
+    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
+    if (treeRef->revisionId != 0)
+    {
+        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
+        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
+
+        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
+
+        int fileRef = -1;
+
+        do
+        {
+            fileRef = open(pathPtr, O_RDONLY);
+        }
+        while ((fileRef == -1) && (errno == EINTR));
+
+        tdb_EnsureExists(treeRef->rootNodeRef);
+
+        if (fileRef == -1)
+        {
+            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
+                     pathPtr,
+                     strerror(errno));
+        }
+        else
+        {
+            struct stat fileStat;
+
+            if (fstat(fileRef, &fileStat) == 0)
+            {
+                treeRef->snapshotSize = fileStat.st_size;
+            }
+
+            if (ReadTreeFile(treeRef->rootNodeRef, fileRef, treeRef->snapshotSize) == false)
+            {
+                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
+                ReleaseNode(treeRef->rootNodeRef);
+                treeRef->rootNodeRef = NewNode(treeRef->arenaRef);
+            }
+
+            int retVal = -1;
+
+            do
+            {
+                retVal = close(fileRef);
+            }
+            while ((retVal == -1) && (errno == EINTR));
+        }
+    }
+
+    // Now bring the tree up to date with the changes committed since that tree file was written.
+    ReplayJournal(treeRef);
+}
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get the registration object for a path, creating it if it doesn't exist yet.  The registrations
+ *  for the path's parent nodes are created too, so that the new one can be linked into the trie.
+ *
+ *  @return The registration object.
+ */
+// -------------------------------------------------------------------------------------------------
+static Registration_t* GetRegistration
+(
+    const char* pathPtr  ///< [IN] Normalized path of the node, including the tree name.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    Registration_t* registrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathPtr);
+
+    if (registrationPtr != NULL)
+    {
+        return registrationPtr;
+    }
+
+    registrationPtr = le_mem_ForceAlloc(RegistrationPool);
+
+    le_utf8_Copy(registrationPtr->registrationPath,
+                 pathPtr,
+                 sizeof(registrationPtr->registrationPath),
+                 NULL);
+    registrationPtr->triggered = false;
+    registrationPtr->triggeredLink = LE_SLS_LINK_INIT;
+    registrationPtr->childList = LE_DLS_LIST_INIT;
+    registrationPtr->siblingLink = LE_DLS_LINK_INIT;
+    registrationPtr->handlerList = LE_DLS_LIST_INIT;
+    registrationPtr->link = LE_SLS_LINK_INIT;
+
+    // A normalized path to a tree's root node is just "tree:", everything else has a parent.
+    char* lastSlashPtr = strrchr(registrationPtr->registrationPath, '/');
+
+    if (lastSlashPtr == NULL)
+    {
+        registrationPtr->namePtr = "";
+        registrationPtr->parentPtr = NULL;
+    }
+    else
+    {
+        char parentPath[CFG_MAX_PATH_SIZE] = "";
+        size_t parentPathLen = lastSlashPtr - registrationPtr->registrationPath;
+
+        memcpy(parentPath, registrationPtr->registrationPath, parentPathLen);
+        parentPath[parentPathLen] = '\0';
+
+        registrationPtr->namePtr = lastSlashPtr + 1;
+        registrationPtr->parentPtr = GetRegistration(parentPath);
+        le_dls_Queue(&registrationPtr->parentPtr->childList, &registrationPtr->siblingLink);
+    }
+
+    le_hashmap_Put(HandlerRegistrationMap, registrationPtr->registrationPath, registrationPtr);
+
+    return registrationPtr;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Free a registration object if it has no handlers and no other registrations below it.  Its
+ *  parents are then checked the same way, as they may have only been kept for this one.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReleaseRegistration
+(
+    Registration_t* registrationPtr  ///< [IN] The registration object to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    while (   (registrationPtr != NULL)
+           && (le_dls_IsEmpty(&registrationPtr->handlerList))
+           && (le_dls_IsEmpty(&registrationPtr->childList)))
+    {
+        Registration_t* parentPtr = registrationPtr->parentPtr;
+
+        if (parentPtr != NULL)
+        {
+            le_dls_Remove(&parentPtr->childList, &registrationPtr->siblingLink);
+        }
+
+        le_hashmap_Remove(HandlerRegistrationMap, registrationPtr->registrationPath);
+        le_mem_Release(registrationPtr);
+
+        registrationPtr = parentPtr;
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Removes the handler object from the given registration object.  This function will also free the
+ *  memory that the handler object had used.
+ */
+// -------------------------------------------------------------------------------------------------
+static void RemoveHandler
+(
+    Registration_t* registrationPtr,  ///< [IN] The registration object to remove the link from.
+    Handler_t* handlerPtr             ///< [IN] The handler object we're removing.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Kill the ref, and remove the object from the registration list.
+    le_ref_DeleteRef(HandlerSafeRefMap, handlerPtr->safeRef);
+    le_dls_Remove(&registrationPtr->handlerList, &handlerPtr->link);
+
+    // Clear out the link data, just to be safe.
+    handlerPtr->link = LE_DLS_LINK_INIT;
+    handlerPtr->sessionRef = NULL;
+    handlerPtr->registrationPtr = NULL;
+    handlerPtr->safeRef = NULL;
+
+    // Finally kill the object.
+    le_mem_Release(handlerPtr);
+}
 
-            LE_ERROR("String literal, '%s', too large.  (%zd/%zd)",
-                     oldPtr,
-                     strlen(oldPtr),
-                     stringSize);
 
-            return LE_FORMAT_ERROR;
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  This function is called by the hash map ForEach function, which is invoked when a session closed
+ *  event occurs.
+ *
+ *  This function takes care of cleaning out orphaned event handlers from the registration objects
+ *  currently stored in the registration hash map.  If a given registration handler is no longer
+ *  required then the object itself is queued for deletion.  It is queued and not deleted in place
+ *  because the hash map does not support deleting objects in the middle of an iteration.
+ *
+ *  @return True.  This function always returns true to indicate that iteration should continue
+ *          until the end of the hash map.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool OnHandlerRegistrationCleanup
+(
+    const void* keyPtr,    ///< [IN] The key used by this hash entry.
+    const void* valuePtr,  ///< [IN] The registration object.
+    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Convert our pointers into something useable.
+    Registration_t* registrationPtr = (Registration_t*)valuePtr;
+    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
+
+    // Go through this registration object's list of update handlers and check to see if they were
+    // registered on the target session.  If so, free them from the list.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+
+    while (linkPtr != NULL)
+    {
+        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+
+        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
+        {
+            RemoveHandler(registrationPtr, handlerObjectPtr);
         }
     }
 
-    *stringPtr = 0;
+    // Now, check to see if there are any handlers left in this object.  If the registration object
+    // is empty, then queue it for deletion.  Registrations that still have others below them are
+    // kept, they're deleted along with the last of those.
+    if (   (le_dls_IsEmpty(&registrationPtr->handlerList))
+        && (le_dls_IsEmpty(&registrationPtr->childList)))
+    {
+        registrationPtr->link = LE_SLS_LINK_INIT;
+        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
+    }
 
-    return LE_OK;
+    // We want to continue iterating through the collection.
+    return true;
 }
 
 
@@ -1941,25 +4221,54 @@ static le_result_t ReadTextLiteral
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read an integer token string from the file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Call this function to delete a tree file from the filesystem.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadIntToken
+static void DeleteTreeFile
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    const char* filePathPtr  ///< Path to the tree file in question.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
 
-    // TODO: Validate the int string.
+    if (unlink(filePathPtr) != 0)
+    {
+        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
+    }
+}
 
-    return result;
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the root node represented by the path ref.
+ *
+ *  If the path is an absolute path, then the base node for the reference is the root node of the
+ *  tree in question.
+ *
+ *  If the path is a relative path, then the base node of the request is the node given.
+ *
+ *  @return A reference to the base node of the operation.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t GetPathBaseNodeRef
+(
+    tdb_NodeRef_t nodeRef,         ///< [IN] The base node to start from.
+    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If the path is absolute and the node we were given is NOT the root node of it's tree, find
+    // the root node of the tree.  Otherwise just return the node reference we were given.
+    if (   (le_pathIter_IsAbsolute(nodePathRef))
+        && (nodeRef->parentRef != NULL))
+    {
+        nodeRef = GetRootParentNode(nodeRef);
+    }
+
+    return nodeRef;
 }
 
 
@@ -1967,25 +4276,58 @@ static le_result_t ReadIntToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a floating point token string from the file.
+ *  Create a new C style file pointer from the POSIX file descriptor.
  *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  @return A file pointer that may be read or written if successful.  A null pointer otherwise.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadFloatToken
+static FILE* OpenFilePtr
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    int descriptor,   ///< [IN] The POSIX file descriptor to create a file pointer from.
+    const char* mode  ///< [IN] The mode to open the file pointer in.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+    // Duplicate the file descriptor, this is because we later use a C library file pointer for the
+    // parsing routines.  When the file pointer is closed it also closes the underlying descriptor,
+    // which may not be what the caller wants or expects.
+    int newDescriptor = -1;
 
-    // TODO: Validate the float string.
+    do
+    {
+        newDescriptor = dup(descriptor);
+    }
+    while (   (newDescriptor == -1)
+           && (errno == EINTR));
 
-    return result;
+    if (newDescriptor == -1)
+    {
+        LE_ERROR("Could not duplicate file descriptor, reason: %s", strerror(errno));
+        return NULL;
+    }
+
+    // Attempt to open the file pointer from the descriptor.
+    FILE* filePtr = fdopen(newDescriptor, mode);
+
+    if (filePtr == NULL)
+    {
+        // The open failed, so clean up the dangling descriptor.
+        int oldErrno = errno;
+        int closeResult;
+
+        do
+        {
+            closeResult = close(newDescriptor);
+        }
+        while (   (closeResult == -1)
+               && (errno == EINTR));
+
+        LE_ERROR("Could not access the input stream for tree import, reason: %s",
+                 strerror(oldErrno));
+    }
+
+    // Return the file pointer we have now.  Note, it may be NULL at this point.
+    return filePtr;
 }
 
 
@@ -1993,25 +4335,28 @@ static le_result_t ReadFloatToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a string from the config tree file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Close the file pointer and flush any data left unwritten.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadStringToken
+static void CloseFilePtr
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    FILE* filePtr  ///< The file pointer to close.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+    int closeResult = EOF;
 
-    // TODO: Validate the literal string.
+    do
+    {
+        closeResult = fclose(filePtr);
+    }
+    while (   (closeResult == EOF)
+           && (errno == EINTR));
 
-    return result;
+    if (closeResult == EOF)
+    {
+        LE_ERROR("Could not properly close file, reason: %s", strerror(errno));
+    }
 }
 
 
@@ -2019,69 +4364,100 @@ static le_result_t ReadStringToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a token from the input stream.
+ *  Write the start of a journal record: the record type and the absolute path of the node, (within
+ *  its tree.)
  *
- *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
- *          before a token could be finished.
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed or the path is too long.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadToken
+static le_result_t WriteJournalRecordStart
 (
-    FILE* filePtr,         ///< [IN]  The file we're reading from.
-    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
-    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
+    FILE* filePtr,         ///< [IN] The journal entry being written.
+    char recordType,       ///< [IN] JOURNAL_SET_RECORD or JOURNAL_DELETE_RECORD.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node the record is for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    *stringPtr = 0;
+    char pathBuffer[CFG_MAX_PATH_SIZE] = "";
+    le_pathIter_Ref_t pathRef = le_pathIter_CreateForUnix("/");
 
-    if (SkipWhiteSpace(filePtr) != LE_OK)
+    GeneratePath(pathRef, nodeRef);
+    le_result_t result = le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer));
+    le_pathIter_Delete(pathRef);
+
+    if (result != LE_OK)
     {
-        return LE_OUT_OF_RANGE;
+        LE_ERROR("Journal path buffer overflow.");
+        return LE_IO_ERROR;
     }
 
-    signed char next;
+    result = WriteFile(filePtr, &recordType, 1);
 
-    while ((next = fgetc(filePtr)) != EOF)
+    if (result == LE_OK)
     {
-        switch (next)
-        {
-            case '~':
-                *typePtr = TT_EMPTY_VALUE;
-                return LE_OK;
-
-            case '!':
-                *typePtr = TT_BOOL_VALUE;
-                return ReadBoolToken(filePtr, stringPtr, stringSize);
+        result = WriteStringValue(filePtr, '\"', '\"', pathBuffer);
+    }
 
-            case '[':
-                *typePtr = TT_INT_VALUE;
-                return ReadIntToken(filePtr, stringPtr, stringSize);
+    return result;
+}
 
-            case '(':
-                *typePtr = TT_FLOAT_VALUE;
-                return ReadFloatToken(filePtr, stringPtr, stringSize);
 
-            case '\"':
-                *typePtr = TT_STRING_VALUE;
-                return ReadStringToken(filePtr, stringPtr, stringSize);
 
-            case '{':
-                *typePtr = TT_OPEN_GROUP;
-                return LE_OK;
 
-            case '}':
-                *typePtr = TT_CLOSE_GROUP;
-                return LE_OK;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write delete records for the nodes of the original tree that a merge of the given shadow node is
+ *  going to delete or rename.  This has to be done before the merge, while the original nodes still
+ *  have their old names.
+ *
+ *  Modified nodes aren't descended into, because a set record for the whole modified node is
+ *  written after the merge, (see JournalChangedNodes.)
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t JournalRemovedNodes
+(
+    FILE* filePtr,         ///< [IN] The journal entry being written.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node being merged.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (IsModified(nodeRef))
+    {
+        if (IsDeleted(nodeRef))
+        {
+            // If the link to the original was lost, the merge finds the original by name.
+            return WriteJournalRecordStart(filePtr,
+                                           JOURNAL_DELETE_RECORD,
+                                           (nodeRef->shadowRef != NULL) ? nodeRef->shadowRef
+                                                                        : nodeRef);
+        }
 
-            default:
-                LE_ERROR("Unexpected character in input stream.");
-                return LE_FORMAT_ERROR;
+        if (WasRenamed(nodeRef))
+        {
+            return WriteJournalRecordStart(filePtr, JOURNAL_DELETE_RECORD, nodeRef->shadowRef);
         }
+
+        return LE_OK;
+    }
+
+    if (IsDeleted(nodeRef))
+    {
+        return LE_OK;
+    }
+
+    le_result_t result = LE_OK;
+    tdb_NodeRef_t childRef = GetFirstListedChild(nodeRef);
+
+    while (   (childRef != NULL)
+           && (result == LE_OK))
+    {
+        result = JournalRemovedNodes(filePtr, childRef);
+        childRef = tdb_GetNextSiblingNode(childRef);
     }
 
-    return LE_OUT_OF_RANGE;
+    return result;
 }
 
 
@@ -2089,83 +4465,93 @@ static le_result_t ReadToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write data to the output stream.  This function will record any faults to the system log.
+ *  Once a shadow node has been merged, write set records holding the new contents of the original
+ *  nodes that were changed by the merge.
  *
  *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteFile
+static le_result_t JournalChangedNodes
 (
-    FILE* filePtr,        ///< [IN] The file being written to.
-    const void* dataPtr,  ///< [IN] The data being written to the file.
-    size_t dataSize       ///< [IN] The amount of data being written.
+    FILE* filePtr,         ///< [IN] The journal entry being written.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node that was merged.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+    if (IsDeleted(nodeRef))
+    {
+        return LE_OK;
+    }
 
-    if (ferror(filePtr) != 0)
+    le_result_t result = LE_OK;
+
+    if (IsModified(nodeRef))
     {
-        LE_EMERG("Failed to write to config tree file.");
-        return LE_IO_ERROR;
+        if (nodeRef->shadowRef != NULL)
+        {
+            result = WriteJournalRecordStart(filePtr, JOURNAL_SET_RECORD, nodeRef->shadowRef);
+
+            if (result == LE_OK)
+            {
+                result = InternalWriteNode(nodeRef->shadowRef, filePtr);
+            }
+        }
+
+        return result;
     }
 
-    if (written < dataSize)
+    tdb_NodeRef_t childRef = GetFirstListedChild(nodeRef);
+
+    while (   (childRef != NULL)
+           && (result == LE_OK))
     {
-        LE_EMERG("Data truncated while writing to configuration file.");
-        return LE_IO_ERROR;
+        result = JournalChangedNodes(filePtr, childRef);
+        childRef = tdb_GetNextSiblingNode(childRef);
     }
 
-    return LE_OK;
+    return result;
 }
 
 
 
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write a string token to the output stream.  This function will write the string and escape all
- *  control characters as it does so.
+ *  Write a whole buffer to a file descriptor.
  *
  *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteStringValue
+static le_result_t WriteDescriptor
 (
-    FILE* filePtr,         ///< [IN] The file to write to.
-    char startChar,        ///< [IN] The delimiter to use.
-    char endChar,          ///< [IN] The closing delimiter to use.
-    const char* stringPtr  ///< [IN] The actual string to write.
+    int descriptor,       ///< [IN] The file being written to.
+    const void* dataPtr,  ///< [IN] The data being written to the file.
+    size_t dataSize       ///< [IN] The amount of data being written.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = LE_OK;
-
-    result = WriteFile(filePtr, &startChar, 1);
+    const char* bytePtr = dataPtr;
 
-    while (   (*stringPtr != 0)
-           && (result == LE_OK))
+    while (dataSize > 0)
     {
-        if (   (*stringPtr == '\"')
-            || (*stringPtr == '\\'))
-        {
-            result = WriteFile(filePtr, "\\", 1);
-        }
+        ssize_t written = write(descriptor, bytePtr, dataSize);
 
-        if (result == LE_OK)
+        if (written == -1)
         {
-            result = WriteFile(filePtr, stringPtr, 1);
-        }
+            if (errno == EINTR)
+            {
+                continue;
+            }
 
-        stringPtr++;
-    }
+            LE_EMERG("Failed to write to config tree file (%m).");
+            return LE_IO_ERROR;
+        }
 
-    if (result == LE_OK)
-    {
-        char strBuffer[2] = { endChar, ' ' };
-        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+        bytePtr += written;
+        dataSize -= written;
     }
 
-    return result;
+    return LE_OK;
 }
 
 
@@ -2173,139 +4559,136 @@ static le_result_t WriteStringValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a node value from the given file.  If the value is a collection, then read in those nodes
- *  too.
+ *  Add a string to the string table of a binary tree file.  The empty string is always found at
+ *  offset zero, so it isn't stored again.
  *
- *  @return LE_OK if the read is successful.
- *          LE_FORMAT_ERROR if parse errors are encountered.
- *          LE_NOT_FOUND if the end of file is reached.
+ *  @return LE_OK if the string was added, LE_IO_ERROR if the write failed.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalReadNode
+static le_result_t AddBinaryString
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
-    FILE* filePtr,          ///< [IN] The file we're reading the value from.
-    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+    BinaryWriteContext_t* contextPtr,  ///< [IN] The file being written.
+    const char* stringPtr,             ///< [IN] The string to add.
+    uint32_t* offsetPtr                ///< [OUT] The string's offset in the string table.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    if (stringPtr[0] == '\0')
+    {
+        *offsetPtr = 0;
+        return LE_OK;
+    }
 
-    TokenType_t tokenType;
+    long offset = ftell(contextPtr->stringsPtr);
 
-    // Try to read this node's value.
-    if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+    if (   (offset < 0)
+        || ((unsigned long)offset > UINT32_MAX))
     {
-        LE_ERROR("Unexpected EOF or bad token in file.");
-        return LE_FORMAT_ERROR;
+        LE_EMERG("Config tree string table is too large.");
+        return LE_IO_ERROR;
     }
 
-    tdb_SetEmpty(nodeRef);
+    *offsetPtr = (uint32_t)offset;
 
-    switch (tokenType)
-    {
-        case TT_BOOL_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_BOOL;
-            break;
+    return WriteFile(contextPtr->stringsPtr, stringPtr, strlen(stringPtr) + 1);
+}
 
-        case TT_INT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_INT;
-            break;
 
-        case TT_FLOAT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_FLOAT;
-            break;
 
-        case TT_STRING_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            break;
 
-        case TT_EMPTY_VALUE:
-            // The node has already been cleared, so there's nothing left to do but make sure that
-            // the node exists.
-            ClearDeletedFlag(nodeRef);
-            break;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Append a node, followed by all of its active children, to a binary tree file.  Nodes are stored
+ *  depth first, so that a collection's children immediately follow it.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t AppendBinaryNode
+(
+    BinaryWriteContext_t* contextPtr,  ///< [IN] The file being written.
+    tdb_NodeRef_t nodeRef              ///< [IN] The node being written.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    BinaryNode_t record = { TT_EMPTY_VALUE, 0, 0 };
+    le_result_t result;
 
-        case TT_OPEN_GROUP:
-            while (tokenType != TT_CLOSE_GROUP)
-            {
-                if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
-                {
-                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
-                    return LE_FORMAT_ERROR;
-                }
+    tdb_GetNodeName(nodeRef, stringBuffer, sizeof(stringBuffer));
 
-                if (tokenType == TT_STRING_VALUE)
-                {
-                    size_t strLen = le_utf8_NumBytes(stringBuffer);
-                    size_t newPathLen = pathLen + 1 + strLen;
+    if ((result = AddBinaryString(contextPtr, stringBuffer, &record.nameOffset)) != LE_OK)
+    {
+        return result;
+    }
 
-                    if (newPathLen > LE_CFG_STR_LEN)
-                    {
-                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
-                                 stringBuffer,
-                                 strLen,
-                                 (size_t)LE_CFG_STR_LEN);
+    // Deleted nodes are written as empty ones, the same as in the text format.
+    if (IsDeleted(nodeRef) == false)
+    {
+        switch (nodeRef->type)
+        {
+            case LE_CFG_TYPE_EMPTY:
+            case LE_CFG_TYPE_DOESNT_EXIST:
+                break;
 
-                        return LE_FORMAT_ERROR;
-                    }
+            case LE_CFG_TYPE_BOOL:
+                record.tokenType = TT_BOOL_VALUE;
+                break;
 
-                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+            case LE_CFG_TYPE_STRING:
+                record.tokenType = TT_STRING_VALUE;
+                break;
 
-                    if (childRef == NULL)
-                    {
-                        childRef = NewChildNode(nodeRef);
-                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
-                        {
-                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
-                            return LE_FORMAT_ERROR;
-                        }
+            case LE_CFG_TYPE_INT:
+                record.tokenType = TT_INT_VALUE;
+                break;
 
-                        LE_DEBUG("New node, %s", stringBuffer);
-                    }
+            case LE_CFG_TYPE_FLOAT:
+                record.tokenType = TT_FLOAT_VALUE;
+                break;
 
-                    tdb_EnsureExists(childRef);
+            case LE_CFG_TYPE_STEM:
+                {
+                    record.tokenType = TT_OPEN_GROUP;
 
-                    le_result_t result = InternalReadNode(childRef, filePtr, newPathLen);
+                    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
 
-                    if (result != LE_OK)
+                    while (childRef != NULL)
                     {
-                        return result;
+                        record.info++;
+                        childRef = tdb_GetNextActiveSiblingNode(childRef);
                     }
                 }
-                else if (tokenType == TT_CLOSE_GROUP)
-                {
-                    break;
-                }
-                else
-                {
-                    LE_ERROR("Unexpected token in found while looking for '}'.");
-                    return LE_FORMAT_ERROR;
-                }
-            }
-            break;
-
-        case TT_CLOSE_GROUP:
-        default:
-            LE_ERROR("Unexpected token found.");
-            return LE_FORMAT_ERROR;
+                break;
+        }
     }
 
-    if (IsShadow(nodeRef) == false)
+    if (   (record.tokenType != TT_EMPTY_VALUE)
+        && (record.tokenType != TT_OPEN_GROUP))
     {
-        ClearModifiedFlag(nodeRef);
+        tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
+        result = AddBinaryString(contextPtr, stringBuffer, &record.info);
     }
-    else
+
+    if (result == LE_OK)
     {
-        SetModifiedFlag(nodeRef);
+        result = WriteFile(contextPtr->nodesPtr, &record, sizeof(record));
+        contextPtr->nodeCount++;
     }
 
-    tdb_EnsureExists(nodeRef);
+    if (record.tokenType == TT_OPEN_GROUP)
+    {
+        tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
 
-    return LE_OK;
+        while (   (childRef != NULL)
+               && (result == LE_OK))
+        {
+            result = AppendBinaryNode(contextPtr, childRef);
+            childRef = tdb_GetNextActiveSiblingNode(childRef);
+        }
+    }
+
+    return result;
 }
 
 
@@ -2313,87 +4696,92 @@ static le_result_t InternalReadNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Serialize a tree node and it's children to a file in the filesystem.
+ *  Write a tree to a file in the binary tree format.  The node array and the string table are
+ *  built up in memory and then written out after the header.
  *
  *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalWriteNode
+static le_result_t WriteBinaryTree
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
-    FILE* filePtr           ///< [IN] The file being written to.
+    tdb_NodeRef_t rootRef,  ///< [IN] The root node of the tree being written.
+    int descriptor          ///< [IN] The file to write to.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If there is no node to write, or if the node is marked as having been deleted...  Then write
-    // a blank node.
-    if (   (nodeRef == NULL)
-        || (IsDeleted(nodeRef) == true))
-    {
-        return WriteFile(filePtr, "~ ", 2);
-    }
-
-    // Get the node's value as a string.
-    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    char* nodesBufferPtr = NULL;
+    size_t nodesSize = 0;
+    char* stringsBufferPtr = NULL;
+    size_t stringsSize = 0;
     le_result_t result = LE_OK;
 
-    tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
+    BinaryWriteContext_t context =
+        {
+            .nodesPtr = open_memstream(&nodesBufferPtr, &nodesSize),
+            .stringsPtr = open_memstream(&stringsBufferPtr, &stringsSize),
+            .nodeCount = 0
+        };
 
-    // Now, depending on the type of node, write out any required format information.
-    switch (nodeRef->type)
+    if (   (context.nodesPtr == NULL)
+        || (context.stringsPtr == NULL))
     {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            result = WriteFile(filePtr, "~ ", 2);
-            break;
-
-        case LE_CFG_TYPE_BOOL:
-            {
-                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
-                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
-            }
-            break;
-
-        case LE_CFG_TYPE_STRING:
-            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
-            break;
+        LE_EMERG("Failed to allocate binary tree buffers.");
+        result = LE_IO_ERROR;
+    }
+    else
+    {
+        // Offset zero of the string table holds the empty string.
+        result = WriteFile(context.stringsPtr, "", 1);
 
-        case LE_CFG_TYPE_INT:
-            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
-            break;
+        if (result == LE_OK)
+        {
+            result = AppendBinaryNode(&context, rootRef);
+        }
+    }
 
-        case LE_CFG_TYPE_FLOAT:
-            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
-            break;
+    // The buffers are only guaranteed to be complete once the streams are closed.
+    if (   (context.nodesPtr != NULL)
+        && (fclose(context.nodesPtr) != 0))
+    {
+        result = LE_IO_ERROR;
+    }
 
-        // Looks like this node is a collection, so write out it's child nodes now.
-        case LE_CFG_TYPE_STEM:
-            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+    if (   (context.stringsPtr != NULL)
+        && (fclose(context.stringsPtr) != 0))
+    {
+        result = LE_IO_ERROR;
+    }
 
-                while (   (childRef != NULL)
-                       && (result == LE_OK))
-                {
-                    tdb_GetNodeName(childRef, stringBuffer, sizeof(stringBuffer));
-                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+    if (   (result == LE_OK)
+        && (stringsSize > UINT32_MAX))
+    {
+        LE_EMERG("Config tree string table is too large.");
+        result = LE_IO_ERROR;
+    }
 
-                    if (result == LE_OK)
-                    {
-                        result = InternalWriteNode(childRef, filePtr);
-                    }
+    if (result == LE_OK)
+    {
+        BinaryTreeHeader_t header = { .nodeCount = context.nodeCount,
+                                      .stringTableSize = (uint32_t)stringsSize };
 
-                    childRef = tdb_GetNextActiveSiblingNode(childRef);
-                }
+        memcpy(header.magic, BINARY_TREE_MAGIC, BINARY_TREE_MAGIC_BYTES);
 
-                if (result == LE_OK)
-                {
-                    result = WriteFile(filePtr, "} ", 2);
-                }
-            }
-            break;
+        result = WriteDescriptor(descriptor, &header, sizeof(header));
+
+        if (result == LE_OK)
+        {
+            result = WriteDescriptor(descriptor, nodesBufferPtr, nodesSize);
+        }
+
+        if (result == LE_OK)
+        {
+            result = WriteDescriptor(descriptor, stringsBufferPtr, stringsSize);
+        }
     }
 
+    free(nodesBufferPtr);
+    free(stringsBufferPtr);
+
     return result;
 }
 
@@ -2402,33 +4790,27 @@ static le_result_t InternalWriteNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Calculate the number of bytes required to store a node path, including seperators and a trailing
- *  NULL.
- *
- *  @return The amount of bytes required to store the whole path string.
+ *  Close a tree's journal file, if it's open.
  */
 // -------------------------------------------------------------------------------------------------
-static size_t ComputePathLength
+static void CloseJournal
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree whose journal is to be closed.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    size_t pathLen = 0;
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
-
-    while (nodeRef != NULL)
+    if (treeRef->journalFd != -1)
     {
-        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+        int retVal = -1;
 
-        // Add this path segment's length to our running total, along with the required path
-        // seperator.
-        pathLen += 1 + le_utf8_NumBytes(nodeName);
-        nodeRef = tdb_GetNodeParent(nodeRef);
-    }
+        do
+        {
+            retVal = close(treeRef->journalFd);
+        }
+        while ((retVal == -1) && (errno == EINTR));
 
-    // Don't forget to include a spot for the trailing NULL.
-    return pathLen + 1;
+        treeRef->journalFd = -1;
+    }
 }
 
 
@@ -2436,21 +4818,27 @@ static size_t ComputePathLength
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Bump up the version id of this tree.
+ *  Close and delete a tree's journal file, if it has one.
  */
 // -------------------------------------------------------------------------------------------------
-static void IncrementRevision
+static void DeleteJournal
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree whose journal is to be deleted.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    treeRef->revisionId++;
+    char filePath[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeRef->name, filePath, sizeof(filePath));
 
-    if (treeRef->revisionId > 3)
+    CloseJournal(treeRef);
+
+    if (   (unlink(filePath) != 0)
+        && (errno != ENOENT))
     {
-        treeRef->revisionId = 1;
+        LE_ERROR("File delete failure, '%s', reason '%m'.", filePath);
     }
+
+    treeRef->journalSize = 0;
 }
 
 
@@ -2458,99 +4846,86 @@ static void IncrementRevision
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Attempt to load a configuration tree from a config file.  This function will look for the latest
- *  valid version of the config file and load that one.
+ *  Append an entry to a tree's journal, creating the journal if the tree doesn't have one yet.
+ *
+ *  @return LE_OK if the entry was appended, LE_IO_ERROR if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void LoadTree
+static le_result_t AppendJournalEntry
 (
-    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree that was changed.
+    const char* entryPtr,   ///< [IN] The records of the entry.
+    size_t entrySize        ///< [IN] Size of the entry's records.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If we don't know the revision then hunt it out from the filesystem.
-    if (treeRef->revisionId == 0)
-    {
-        UpdateRevision(treeRef);
-    }
-
-    // If this tree has no root, create it now.
-    if (treeRef->rootNodeRef == NULL)
-    {
-        treeRef->rootNodeRef = NewNode();
-    }
+    char headerBuffer[64];
+    size_t oldSize = treeRef->journalSize;
+    le_result_t result = LE_OK;
 
-    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
-    if (treeRef->revisionId != 0)
+    if (treeRef->journalFd == -1)
     {
-        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
-        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
-
-        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
-
-        int fileRef = -1;
+        char filePath[LE_CFG_STR_LEN_BYTES] = "";
+        GetJournalPath(treeRef->name, filePath, sizeof(filePath));
 
         do
         {
-            fileRef = open(pathPtr, O_RDONLY);
+            treeRef->journalFd = open(filePath,
+                                      O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC,
+                                      S_IRUSR | S_IWUSR);
         }
-        while ((fileRef == -1) && (errno == EINTR));
-
-        tdb_EnsureExists(treeRef->rootNodeRef);
+        while (   (treeRef->journalFd == -1)
+               && (errno == EINTR));
 
-        if (fileRef == -1)
+        if (treeRef->journalFd == -1)
         {
-            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
-                     pathPtr,
-                     strerror(errno));
+            LE_EMERG("Failed to open config tree journal '%s' (%m).", filePath);
+            return LE_IO_ERROR;
         }
-        else
-        {
-            if (tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef) == false)
-            {
-                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
-                le_mem_Release(treeRef->rootNodeRef);
-                treeRef->rootNodeRef = NewNode();
-            }
 
-            int retVal = -1;
+        // A new journal starts with the revision of the tree file it applies to.
+        if (treeRef->journalSize == 0)
+        {
+            int headerSize = snprintf(headerBuffer,
+                                      sizeof(headerBuffer),
+                                      JOURNAL_HEADER_FORMAT,
+                                      treeRef->revisionId);
 
-            do
-            {
-                retVal = close(fileRef);
-            }
-            while ((retVal == -1) && (errno == EINTR));
+            result = WriteDescriptor(treeRef->journalFd, headerBuffer, headerSize);
+            treeRef->journalSize += headerSize;
         }
     }
-}
 
+    if (result == LE_OK)
+    {
+        int headerSize = snprintf(headerBuffer,
+                                  sizeof(headerBuffer),
+                                  JOURNAL_ENTRY_FORMAT,
+                                  entrySize,
+                                  UpdateChecksum(JOURNAL_CHECKSUM_INIT, entryPtr, entrySize));
 
+        result = WriteDescriptor(treeRef->journalFd, headerBuffer, headerSize);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Removes the handler object from the given registration object.  This function will also free the
- *  memory that the handler object had used.
- */
-// -------------------------------------------------------------------------------------------------
-static void RemoveHandler
-(
-    Registration_t* registrationPtr,  ///< [IN] The registration object to remove the link from.
-    Handler_t* handlerPtr             ///< [IN] The handler object we're removing.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // Kill the ref, and remove the object from the registration list.
-    le_ref_DeleteRef(HandlerSafeRefMap, handlerPtr->safeRef);
-    le_dls_Remove(&registrationPtr->handlerList, &handlerPtr->link);
+        if (result == LE_OK)
+        {
+            result = WriteDescriptor(treeRef->journalFd, entryPtr, entrySize);
+        }
 
-    // Clear out the link data, just to be safe.
-    handlerPtr->link = LE_DLS_LINK_INIT;
-    handlerPtr->sessionRef = NULL;
-    handlerPtr->registrationPtr = NULL;
-    handlerPtr->safeRef = NULL;
+        treeRef->journalSize += headerSize + entrySize;
+    }
 
-    // Finally kill the object.
-    le_mem_Release(handlerPtr);
+    // Don't leave a partial entry in the middle of the journal, later entries would be lost with it
+    // when the journal is replayed.
+    if (result != LE_OK)
+    {
+        LE_ERROR_IF(ftruncate(treeRef->journalFd, oldSize) != 0,
+                    "Could not truncate config tree journal (%m).");
+
+        CloseJournal(treeRef);
+        treeRef->journalSize = oldSize;
+    }
+
+    return result;
 }
 
 
@@ -2558,110 +4933,96 @@ static void RemoveHandler
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function is called by the hash map ForEach function, which is invoked when a session closed
- *  event occurs.
+ *  Write a full snapshot of a tree to the tree file of its next revision, then delete the tree file
+ *  of the old revision and the journal.
  *
- *  This function takes care of cleaning out orphaned event handlers from the registration objects
- *  currently stored in the registration hash map.  If a given registration handler is no longer
- *  required then the object itself is queued for deletion.  It is queued and not deleted in place
- *  because the hash map does not support deleting objects in the middle of an iteration.
- *
- *  @return True.  This function always returns true to indicate that iteration should continue
- *          until the end of the hash map.
+ *  @return LE_OK if the tree was written, LE_IO_ERROR if not.  If the write fails, the old tree file
+ *          and journal are left alone.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OnHandlerRegistrationCleanup
+static le_result_t CompactTree
 (
-    const void* keyPtr,    ///< [IN] The key used by this hash entry.
-    const void* valuePtr,  ///< [IN] The registration object.
-    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to write.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Convert our pointers into something useable.
-    Registration_t* registrationPtr = (Registration_t*)valuePtr;
-    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
+    int oldId = treeRef->revisionId;
 
-    // Go through this registration object's list of update handlers and check to see if they were
-    // registered on the target session.  If so, free them from the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+    treeRef->isCompactPending = false;
+    IncrementRevision(treeRef);
 
-    while (linkPtr != NULL)
-    {
-        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
-        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+    char filePath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeRef->name, treeRef->revisionId, filePath, sizeof(filePath));
 
-        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
-        {
-            RemoveHandler(registrationPtr, handlerObjectPtr);
-        }
+    LE_DEBUG("Compacting the tree into '%s'.", filePath);
+
+    int fileRef = -1;
+
+    do
+    {
+        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
     }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
 
-    // Now, check to see if there are any handlers left in this object.  If the registration object
-    // is empty, then queue it for deletion.
-    if (le_dls_IsEmpty(&registrationPtr->handlerList))
+    if (fileRef == -1)
     {
-        registrationPtr->link = LE_SLS_LINK_INIT;
-        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
+        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
+        treeRef->revisionId = oldId;
+        return LE_IO_ERROR;
     }
 
-    // We want to continue iterating through the collection.
-    return true;
-}
+    // Write the tree to the new file as a binary snapshot, and make sure that it has made it to
+    // storage before the old file and the journal are deleted.
+    le_result_t writeResult = WriteBinaryTree(treeRef->rootNodeRef, fileRef);
 
+    if (   (writeResult == LE_OK)
+        && (fsync(fileRef) != 0))
+    {
+        LE_EMERG("Failed to sync config file '%s' (%m).", filePath);
+        writeResult = LE_IO_ERROR;
+    }
 
+    struct stat fileStat;
 
+    if (fstat(fileRef, &fileStat) == 0)
+    {
+        treeRef->snapshotSize = fileStat.st_size;
+    }
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Call this function to delete a tree file from the filesystem.
- */
-// -------------------------------------------------------------------------------------------------
-static void DeleteTreeFile
-(
-    const char* filePathPtr  ///< Path to the tree file in question.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
+    int retVal = -1;
 
-    if (unlink(filePathPtr) != 0)
+    do
     {
-        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
+        retVal = close(fileRef);
     }
-}
+    while ((retVal == -1) && (errno == EINTR));
 
+    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
 
+    if (writeResult != LE_OK)
+    {
+        // The write failed, delete the new file we attempted to create.
+        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
+        DeleteTreeFile(filePath);
+        treeRef->revisionId = oldId;
 
+        return writeResult;
+    }
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Find the root node represented by the path ref.
- *
- *  If the path is an absolute path, then the base node for the reference is the root node of the
- *  tree in question.
- *
- *  If the path is a relative path, then the base node of the request is the node given.
- *
- *  @return A reference to the base node of the operation.
- */
-// -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetPathBaseNodeRef
-(
-    tdb_NodeRef_t nodeRef,         ///< [IN] The base node to start from.
-    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // If the path is absolute and the node we were given is NOT the root node of it's tree, find
-    // the root node of the tree.  Otherwise just return the node reference we were given.
-    if (   (le_pathIter_IsAbsolute(nodePathRef))
-        && (nodeRef->parentRef != NULL))
+    // Remove the old version of the tree file, if there is one, and then the journal.  The journal
+    // has to go last, otherwise if the system went down in between, the old tree file would be
+    // loaded without the changes that were in the journal.
+    if (   (oldId != 0)
+        && (TreeFileExists(treeRef->name, oldId)))
     {
-        nodeRef = GetRootParentNode(nodeRef);
+        GetTreePath(treeRef->name, oldId, filePath, sizeof(filePath));
+        DeleteTreeFile(filePath);
     }
 
-    return nodeRef;
+    DeleteJournal(treeRef);
+
+    return LE_OK;
 }
 
 
@@ -2669,58 +5030,53 @@ static tdb_NodeRef_t GetPathBaseNodeRef
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new C style file pointer from the POSIX file descriptor.
- *
- *  @return A file pointer that may be read or written if successful.  A null pointer otherwise.
+ *  Called when the compaction timer expires to compact all of the trees that are waiting for it.
  */
 // -------------------------------------------------------------------------------------------------
-static FILE* OpenFilePtr
+static void OnCompactTimerExpiry
 (
-    int descriptor,   ///< [IN] The POSIX file descriptor to create a file pointer from.
-    const char* mode  ///< [IN] The mode to open the file pointer in.
+    le_timer_Ref_t timerRef  ///< [IN] The timer that expired.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Duplicate the file descriptor, this is because we later use a C library file pointer for the
-    // parsing routines.  When the file pointer is closed it also closes the underlying descriptor,
-    // which may not be what the caller wants or expects.
-    int newDescriptor = -1;
+    le_hashmap_It_Ref_t treeIterRef = le_hashmap_GetIterator(TreeCollectionRef);
 
-    do
+    while (le_hashmap_NextNode(treeIterRef) == LE_OK)
     {
-        newDescriptor = dup(descriptor);
-    }
-    while (   (newDescriptor == -1)
-           && (errno == EINTR));
+        tdb_TreeRef_t treeRef = (tdb_TreeRef_t)le_hashmap_GetValue(treeIterRef);
 
-    if (newDescriptor == -1)
-    {
-        LE_ERROR("Could not duplicate file descriptor, reason: %s", strerror(errno));
-        return NULL;
+        if (treeRef->isCompactPending)
+        {
+            CompactTree(treeRef);
+        }
     }
+}
 
-    // Attempt to open the file pointer from the descriptor.
-    FILE* filePtr = fdopen(newDescriptor, mode);
 
-    if (filePtr == NULL)
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check the size of a tree's journal, and if it's grown too big, schedule the tree for compaction.
+ */
+// -------------------------------------------------------------------------------------------------
+static void CheckJournalSize
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (   (treeRef->isCompactPending == false)
+        && (treeRef->journalSize >= JOURNAL_MIN_COMPACT_BYTES)
+        && (treeRef->journalSize >= treeRef->snapshotSize))
     {
-        // The open failed, so clean up the dangling descriptor.
-        int oldErrno = errno;
-        int closeResult;
+        treeRef->isCompactPending = true;
 
-        do
+        if (le_timer_IsRunning(CompactTimerRef) == false)
         {
-            closeResult = close(newDescriptor);
+            LE_ASSERT(le_timer_Start(CompactTimerRef) == LE_OK);
         }
-        while (   (closeResult == -1)
-               && (errno == EINTR));
-
-        LE_ERROR("Could not access the input stream for tree import, reason: %s",
-                 strerror(oldErrno));
     }
-
-    // Return the file pointer we have now.  Note, it may be NULL at this point.
-    return filePtr;
 }
 
 
@@ -2728,27 +5084,39 @@ static FILE* OpenFilePtr
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Close the file pointer and flush any data left unwritten.
+ *  Called before a change is merged into a tree that has open read iterators.  The tree's current
+ *  contents are copied into a snapshot, and the read iterators are moved over to it, so they keep
+ *  seeing the tree as it was when they were created.  The change can then be merged right away
+ *  instead of waiting for the reads to finish.
  */
 // -------------------------------------------------------------------------------------------------
-static void CloseFilePtr
+static void SnapshotTree
 (
-    FILE* filePtr  ///< The file pointer to close.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree that's about to be changed.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    int closeResult = EOF;
+    tdb_TreeRef_t snapshotRef = NewTree(treeRef->name, arena_Create(), NULL);
 
-    do
-    {
-        closeResult = fclose(filePtr);
-    }
-    while (   (closeResult == EOF)
-           && (errno == EINTR));
+    snapshotRef->isSnapshot = true;
+    snapshotRef->revisionId = treeRef->revisionId;
 
-    if (closeResult == EOF)
+    CopyNode(snapshotRef->rootNodeRef, treeRef->rootNodeRef);
+
+    size_t movedCount = ni_MoveReadIterators(treeRef, snapshotRef);
+
+    LE_DEBUG("** Moved %zu read iterator(s) on tree '%s' to snapshot <%p>.",
+             movedCount,
+             treeRef->name,
+             snapshotRef);
+
+    snapshotRef->activeReadCount = movedCount;
+    treeRef->activeReadCount -= movedCount;
+    LE_ASSERT(treeRef->activeReadCount >= 0);
+
+    if (movedCount == 0)
     {
-        LE_ERROR("Could not properly close file, reason: %s", strerror(errno));
+        le_mem_Release(snapshotRef);
     }
 }
 
@@ -2801,6 +5169,31 @@ void tdb_Init
     HandlerPool = le_mem_CreatePool(CFG_HANDLER_POOL_NAME, sizeof(Handler_t));
     RegistrationPool = le_mem_CreatePool(CFG_REGISTRATION_POOL_NAME, sizeof(Registration_t));
 
+    size_t i;
+
+    for (i = 0; i < NUM_CHILD_INDEX_SIZES; i++)
+    {
+        char poolName[LIMIT_MAX_MEM_POOL_NAME_BYTES];
+
+        snprintf(poolName, sizeof(poolName), "childIndex%zu", ChildIndexSizes[i]);
+        ChildIndexPools[i] = le_mem_CreatePool(poolName,
+                                               sizeof(ChildIndex_t)
+                                               + (ChildIndexSizes[i] * sizeof(tdb_NodeRef_t)));
+    }
+
+    for (i = 0; i < NUM_STRING_SIZES; i++)
+    {
+        char poolName[LIMIT_MAX_MEM_POOL_NAME_BYTES];
+
+        snprintf(poolName, sizeof(poolName), "string%zu", StringSizes[i]);
+        StringPools[i] = le_mem_CreatePool(poolName, StringSizes[i]);
+    }
+
+    CompactTimerRef = le_timer_Create("journalCompaction");
+    le_clk_Time_t compactDelay = { JOURNAL_COMPACT_DELAY, 0 };
+    LE_ASSERT(le_timer_SetInterval(CompactTimerRef, compactDelay) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(CompactTimerRef, OnCompactTimerExpiry) == LE_OK);
+
     // Preload the system tree.
     tdb_GetTree("system");
 }
@@ -2827,10 +5220,11 @@ tdb_TreeRef_t tdb_GetTree
     if (treeRef == NULL)
     {
         // Looks like we don't so create an object for it, and add it to our map.
-        treeRef = NewTree(treeNamePtr, NULL);
+        treeRef = NewTree(treeNamePtr, NULL, NULL);
         le_hashmap_Put(TreeCollectionRef, treeRef->name, treeRef);
 
         LoadTree(treeRef);
+        CheckJournalSize(treeRef);
     }
 
     // Finally return the tree we have to the user.
@@ -2875,6 +5269,8 @@ void tdb_DeleteTree
             }
         }
 
+        DeleteJournal(treeRef);
+
         LE_ASSERT(le_hashmap_Remove(TreeCollectionRef, treeRef->name) == treeRef);
         le_mem_Release(treeRef);
     }
@@ -2924,7 +5320,12 @@ tdb_TreeRef_t tdb_ShadowTree
 // -------------------------------------------------------------------------------------------------
 {
     LE_ASSERT(treeRef->originalTreeRef == NULL);
-    tdb_TreeRef_t shadowRef = NewTree(treeRef->name, NewShadowNode(treeRef->rootNodeRef));
+    // Shadow trees are thrown away as a whole once their transaction ends, so their nodes come
+    // from an arena.
+    arena_Ref_t arenaRef = arena_Create();
+    tdb_TreeRef_t shadowRef = NewTree(treeRef->name,
+                                      arenaRef,
+                                      NewShadowNode(arenaRef, treeRef->rootNodeRef));
     shadowRef->originalTreeRef = treeRef;
 
     return shadowRef;
@@ -3135,8 +5536,8 @@ le_sls_List_t* tdb_GetRequestQueue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow tree into the original tree it was created from.  Once the change is merged the
- *  updated tree is serialized to the filesystem.
+ *  Merge a shadow tree into the original tree it was created from.  Once the change is merged it is
+ *  appended to the tree's journal in the filesystem.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_MergeTree
@@ -3147,71 +5548,71 @@ void tdb_MergeTree
 {
     // Get our shadow tree's root node and merge it's changes into the real tree.  Create a path
     // iterator to track the merge and allow for update handlers to be called.
-    tdb_NodeRef_t nodeRef = shadowTreeRef->rootNodeRef;
-    le_pathIter_Ref_t pathRef = CreateBasePath(shadowTreeRef->originalTreeRef->name);
-
-    InternalMergeTree(shadowTreeRef->originalTreeRef->name, pathRef, nodeRef, false);
-    le_pathIter_Delete(pathRef);
-
-    // Now, go through and call the triggered callbacks.
-    FireTriggeredCallbacks();
-
-    // Now increment revision of the tree and open a tree file for writing.
     tdb_TreeRef_t originalTreeRef = shadowTreeRef->originalTreeRef;
-    int oldId = originalTreeRef->revisionId;
-
-    IncrementRevision(originalTreeRef);
-
-    char filePath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(originalTreeRef->name, originalTreeRef->revisionId, filePath, sizeof(filePath));
-
-    LE_DEBUG("Changes merged, now attempting to serialize the tree to '%s'.", filePath);
-
-    int fileRef = -1;
+    tdb_NodeRef_t nodeRef = shadowTreeRef->rootNodeRef;
 
-    do
+    // Any reads still open on the tree have to keep seeing it as it was, so give them a snapshot of
+    // it before it's changed.
+    if (originalTreeRef->activeReadCount > 0)
     {
-        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        SnapshotTree(originalTreeRef);
     }
-    while (   (fileRef == -1)
-           && (errno == EINTR));
 
-    if (fileRef == -1)
+    // Start a journal entry for the change.  The nodes that are going to be deleted or renamed have
+    // to be recorded before the merge, while they still have their old names.
+    char* entryBuffer = NULL;
+    size_t entrySize = 0;
+    FILE* entryPtr = open_memstream(&entryBuffer, &entrySize);
+    le_result_t journalResult = LE_IO_ERROR;
+
+    if (entryPtr != NULL)
     {
-        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
-        LE_EMERG("Changes have been merged in memory, however they could not be committed to the "
-                 "filesystem!!");
-        return;
+        journalResult = JournalRemovedNodes(entryPtr, nodeRef);
     }
-
-    // We have a tree file to write to, so stream the new tree to it then close the output file.
-    le_result_t writeResult = tdb_WriteTreeNode(originalTreeRef->rootNodeRef, fileRef);
-    int retVal = -1;
-
-    do
+    else
     {
-        retVal = close(fileRef);
+        LE_ERROR("Could not create journal entry buffer (%m).");
     }
-    while ((retVal == -1) && (errno == EINTR));
 
-    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
+    // Walk the tree's registrations down along with the merge, starting from the one for the root.
+    char rootPath[CFG_MAX_PATH_SIZE] = "";
+    snprintf(rootPath, sizeof(rootPath), "%s:", originalTreeRef->name);
+
+    InternalMergeTree(NULL, le_hashmap_Get(HandlerRegistrationMap, rootPath), nodeRef, false);
 
+    // Now, go through and call the triggered callbacks.
+    FireTriggeredCallbacks();
 
-    // Finally remove the old version of the tree file, if there is one.
-    if (writeResult == LE_OK)
+    // Now record the changes in the tree's journal.  If that can't be done, fall back to writing out
+    // the whole tree.
+    if (entryPtr != NULL)
     {
-        if (   (oldId != 0)
-            && (TreeFileExists(originalTreeRef->name, oldId)))
+        if (journalResult == LE_OK)
+        {
+            journalResult = JournalChangedNodes(entryPtr, nodeRef);
+        }
+
+        if (fclose(entryPtr) != 0)
+        {
+            journalResult = LE_IO_ERROR;
+        }
+
+        if (journalResult == LE_OK)
         {
-            GetTreePath(originalTreeRef->name, oldId, filePath, sizeof(filePath));
-            DeleteTreeFile(filePath);
+            journalResult = AppendJournalEntry(originalTreeRef, entryBuffer, entrySize);
         }
+
+        free(entryBuffer);
     }
-    else
+
+    if (journalResult == LE_OK)
     {
-        // The write failed, delete the new file we attempted to create.
-        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
-        DeleteTreeFile(filePath);
+        CheckJournalSize(originalTreeRef);
+    }
+    else if (CompactTree(originalTreeRef) != LE_OK)
+    {
+        LE_EMERG("Changes have been merged in memory, however they could not be committed to the "
+                 "filesystem!!");
     }
 }
 
@@ -3231,7 +5632,11 @@ void tdb_ReleaseTree
 {
     LE_ASSERT(treeRef != NULL);
 
-    if (treeRef->originalTreeRef != NULL)
+    // Shadow trees belong to a single write iterator, and snapshots are shared by the read
+    // iterators that were moved onto them.
+    if (   (treeRef->originalTreeRef != NULL)
+        || (   (treeRef->isSnapshot)
+            && (treeRef->activeReadCount == 0)))
     {
         le_mem_Release(treeRef);
     }
@@ -3245,36 +5650,19 @@ void tdb_ReleaseTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a configuration tree node's contents from the file system.
- *
- *  @note On exit the descriptor's file pointer will be at EOF.  If the function fails, then the
- *        file pointer will be somewhere in the middle of the file.
+ *  Read a configuration tree node's contents from a C style file pointer, and close the file
+ *  pointer when done.
  *
  *  @return True if the read is successful, or false if not.
  */
 // -------------------------------------------------------------------------------------------------
-bool tdb_ReadTreeNode
+static bool ReadTreeNodeFromFilePtr
 (
     tdb_NodeRef_t nodeRef,  ///< [IN] The node to write the new data to.
-    int descriptor          ///< [IN] The file to read from.
+    FILE* filePtr           ///< [IN] The file to read from.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_ASSERT(nodeRef != NULL);
-    LE_ASSERT(descriptor != -1);
-
-    // Clear out any contents that the node may have, and make sure that it isn't marked as deleted.
-    tdb_SetEmpty(nodeRef);
-    tdb_EnsureExists(nodeRef);
-
-    // Convert to a C style file pointer.
-    FILE* filePtr = OpenFilePtr(descriptor, "r");
-
-    if (filePtr == NULL)
-    {
-        return false;
-    }
-
     // Ok read the specified node from the file object.  If the read fails, report it and clear out
     // the node.  We shouldn't be leaving the node in a half initialized state.
     bool result = true;
@@ -3312,6 +5700,44 @@ bool tdb_ReadTreeNode
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a configuration tree node's contents from the file system.
+ *
+ *  @note On exit the descriptor's file pointer will be at EOF.  If the function fails, then the
+ *        file pointer will be somewhere in the middle of the file.
+ *
+ *  @return True if the read is successful, or false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+bool tdb_ReadTreeNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to write the new data to.
+    int descriptor          ///< [IN] The file to read from.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(nodeRef != NULL);
+    LE_ASSERT(descriptor != -1);
+
+    // Clear out any contents that the node may have, and make sure that it isn't marked as deleted.
+    tdb_SetEmpty(nodeRef);
+    tdb_EnsureExists(nodeRef);
+
+    // Convert to a C style file pointer.
+    FILE* filePtr = OpenFilePtr(descriptor, "r");
+
+    if (filePtr == NULL)
+    {
+        return false;
+    }
+
+    return ReadTreeNodeFromFilePtr(nodeRef, filePtr);
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Serialize a tree node and it's children to a file in the filesystem.
@@ -3344,6 +5770,93 @@ le_result_t tdb_WriteTreeNode
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a configuration tree node's contents from a buffer holding the same text that
+ *  tdb_ReadTreeNode() reads from a file.
+ *
+ *  @return True if the read is successful, or false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+bool tdb_ReadTreeNodeFromBuffer
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to write the new data to.
+    const char* bufferPtr,  ///< [IN] The text to read.
+    size_t bufferSize       ///< [IN] The size of the text.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(nodeRef != NULL);
+
+    tdb_SetEmpty(nodeRef);
+    tdb_EnsureExists(nodeRef);
+
+    // An empty buffer can't hold a node, and fmemopen() won't take one anyway.
+    if (bufferSize == 0)
+    {
+        LE_ERROR("No data to import.");
+        return false;
+    }
+
+    FILE* filePtr = fmemopen((void*)bufferPtr, bufferSize, "r");
+
+    if (filePtr == NULL)
+    {
+        LE_ERROR("Could not access the input buffer for tree import, reason: %s",
+                 strerror(errno));
+        return false;
+    }
+
+    return ReadTreeNodeFromFilePtr(nodeRef, filePtr);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree node and it's children to a newly allocated buffer, in the same format that
+ *  tdb_WriteTreeNode() writes to a file.  The caller must free() the buffer.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_WriteTreeNodeToBuffer
+(
+    tdb_NodeRef_t nodeRef,    ///< [IN]  Write the contents of this node to the buffer.
+    char** bufferPtrPtr,      ///< [OUT] The newly allocated buffer.
+    size_t* bufferSizePtr     ///< [OUT] The size of the text in the buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    *bufferPtrPtr = NULL;
+    *bufferSizePtr = 0;
+
+    FILE* filePtr = open_memstream(bufferPtrPtr, bufferSizePtr);
+
+    if (filePtr == NULL)
+    {
+        LE_ERROR("Could not access the output buffer for tree export, reason: %s",
+                 strerror(errno));
+        return LE_IO_ERROR;
+    }
+
+    le_result_t result = InternalWriteNode(nodeRef, filePtr);
+    CloseFilePtr(filePtr);
+
+    if (result != LE_OK)
+    {
+        free(*bufferPtrPtr);
+        *bufferPtrPtr = NULL;
+        *bufferSizePtr = 0;
+    }
+
+    return result;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Given a base node and a path, find another node in the tree.
@@ -3507,19 +6020,19 @@ le_result_t tdb_GetNodeName
     // NULL.  The reason that the name may be NULL is because the client never changed the name of
     // the node.  So, we just get the name from the original node, saving memory.  However, nodes
     // like the root node of a tree also do not have names.
-    dstr_Ref_t nameRef = nodeRef->nameRef;
+    const char* namePtr = nodeRef->name.strPtr;
 
     if (   (IsShadow(nodeRef))
-        && (nodeRef->nameRef == NULL)
+        && (namePtr == NULL)
         && (nodeRef->shadowRef != NULL))
     {
-        nameRef = nodeRef->shadowRef->nameRef;
+        namePtr = nodeRef->shadowRef->name.strPtr;
     }
 
     // If the node has a name, copy it into the user buffer now.
-    if (nameRef != NULL)
+    if (namePtr != NULL)
     {
-        return dstr_CopyToCstr(stringPtr, maxSize, nameRef, NULL);
+        return le_utf8_Copy(stringPtr, namePtr, maxSize, NULL);
     }
 
     return LE_OK;
@@ -3577,14 +6090,9 @@ le_result_t tdb_SetNodeName
 
     // Copy over the new name.  Note that we don't care if this node is a shadow node.  Coping over
     // the name is taken care of as part of the merge process.
-    if (nodeRef->nameRef == NULL)
-    {
-        nodeRef->nameRef = dstr_NewFromCstr(stringPtr);
-    }
-    else
-    {
-        dstr_CopyFromCstr(nodeRef->nameRef, stringPtr);
-    }
+    RemoveFromParentIndex(nodeRef);
+    SetNodeString(nodeRef, &nodeRef->name, stringPtr);
+    AddToParentIndex(nodeRef);
 
     // If this is a shadow node and this is the change that modified it, then try to get it's
     // children now.  This is done so that later when this node is merged the merge code doesn't end
@@ -3642,7 +6150,7 @@ le_cfg_nodeType_t tdb_GetNodeType
 
     // If the node isn't a stem and there is no string value then this node is definitly empty.
     if (   (nodeRef->type != LE_CFG_TYPE_STEM)
-        && (nodeRef->info.valueRef == NULL))
+        && (nodeRef->info.value.strPtr == NULL))
     {
         if (   (IsShadow(nodeRef))
             && (IsModified(nodeRef) == false))
@@ -3719,17 +6227,16 @@ void tdb_SetEmpty
 
             // We don't remove the child from the list explicitly, because the destructor will take
             // care of that for us.
-            le_mem_Release(childRef);
+            ReleaseNode(childRef);
             childRef = nextChildRef;
         }
 
         nodeRef->info.children = LE_DLS_LIST_INIT;
     }
-    else if (nodeRef->info.valueRef)
+    else
     {
         // It's a string value, so free it now.
-        dstr_Release(nodeRef->info.valueRef);
-        nodeRef->info.valueRef = NULL;
+        ClearNodeString(nodeRef, &nodeRef->info.value);
     }
 
     // Mark the node as being emtpy, and that it has been modified.
@@ -3777,7 +6284,7 @@ void tdb_DeleteNode
     }
     else
     {
-        le_mem_Release(nodeRef);
+        ReleaseNode(nodeRef);
     }
 }
 
@@ -3972,18 +6479,19 @@ le_result_t tdb_GetValueAsString
 
     // Check to see if we have the value locally, or if we need to go back to the original node for
     // the value.
-    if (nodeRef->info.valueRef == NULL)
+    if (nodeRef->info.value.strPtr == NULL)
     {
         if (IsShadow(nodeRef))
         {
             LE_ASSERT(nodeRef->shadowRef != NULL);
-            return dstr_CopyToCstr(stringPtr, maxSize, nodeRef->shadowRef->info.valueRef, NULL);
+            LE_ASSERT(nodeRef->shadowRef->info.value.strPtr != NULL);
+            return le_utf8_Copy(stringPtr, nodeRef->shadowRef->info.value.strPtr, maxSize, NULL);
         }
 
         return LE_OK;
     }
 
-    return dstr_CopyToCstr(stringPtr, maxSize, nodeRef->info.valueRef, NULL);
+    return le_utf8_Copy(stringPtr, nodeRef->info.value.strPtr, maxSize, NULL);
 }
 
 
@@ -3993,9 +6501,12 @@ le_result_t tdb_GetValueAsString
 /**
  *  Set the given node to a string value.  If the given node is a stem then all children will be
  *  lost.
+ *
+ *  @return LE_OK if the value was written, LE_OVERFLOW if it's longer than LE_CFG_STR_LEN.  In that
+ *          case the node is left as it was.
  */
 // -------------------------------------------------------------------------------------------------
-void tdb_SetValueAsString
+le_result_t tdb_SetValueAsString
 (
     tdb_NodeRef_t nodeRef,  ///< [IN] The node to set.
     const char* stringPtr   ///< [IN] The value to write to the node.
@@ -4004,31 +6515,30 @@ void tdb_SetValueAsString
 {
     LE_ASSERT(nodeRef != NULL);
 
+    if (strlen(stringPtr) > LE_CFG_STR_LEN)
+    {
+        return LE_OVERFLOW;
+    }
+
     // Make sure the node is cleared out and value is set to it's default state.
     if (   (nodeRef->type == LE_CFG_TYPE_STEM)
         || (nodeRef->type != LE_CFG_TYPE_EMPTY))
     {
         tdb_SetEmpty(nodeRef);
-        nodeRef->info.valueRef = NULL;
+        nodeRef->info.value.strPtr = NULL;
     }
 
     // Mark this as a string node, and copy over the value.
     nodeRef->type = LE_CFG_TYPE_STRING;
-
-    if (nodeRef->info.valueRef == NULL)
-    {
-        nodeRef->info.valueRef = dstr_NewFromCstr(stringPtr);
-    }
-    else
-    {
-        dstr_CopyFromCstr(nodeRef->info.valueRef, stringPtr);
-    }
+    SetNodeString(nodeRef, &nodeRef->info.value, stringPtr);
 
     // Make sure the system knows this node has been modified so that it can be included for merging
     // into the original tree.  Also, make sure that this node and it's parents are not marked as
     // having been deleted.
     SetModifiedFlag(nodeRef);
     tdb_EnsureExists(nodeRef);
+
+    return LE_OK;
 }
 
 
@@ -4100,7 +6610,7 @@ void tdb_SetValueAsBool
 {
     LE_ASSERT(nodeRef != NULL);
 
-    tdb_SetValueAsString(nodeRef, value ? "t" : "f");
+    LE_ASSERT(tdb_SetValueAsString(nodeRef, value ? "t" : "f") == LE_OK);
     nodeRef->type = LE_CFG_TYPE_BOOL;
 }
 
@@ -4176,7 +6686,7 @@ void tdb_SetValueAsInt
     char buffer[SMALL_STR] = { 0 };
     snprintf(buffer, SMALL_STR, "%d", value);
 
-    tdb_SetValueAsString(nodeRef, buffer);
+    LE_ASSERT(tdb_SetValueAsString(nodeRef, buffer) == LE_OK);
     nodeRef->type = LE_CFG_TYPE_INT;
 }
 
@@ -4246,7 +6756,7 @@ void tdb_SetValueAsFloat
     char buffer[LE_CFG_STR_LEN_BYTES] = { 0 };
 
     snprintf(buffer, LE_CFG_STR_LEN_BYTES, "%f", value);
-    tdb_SetValueAsString(nodeRef, buffer);
+    LE_ASSERT(tdb_SetValueAsString(nodeRef, buffer) == LE_OK);
     nodeRef->type = LE_CFG_TYPE_FLOAT;
 }
 
@@ -4304,27 +6814,8 @@ le_cfg_ChangeHandlerRef_t tdb_AddChangeHandler
         return NULL;
     }
 
-    // Find the registration object for the given node, if it currently exists.
-    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, newPathBuffer);
-
-    if (foundRegistrationPtr == NULL)
-    {
-        // Looks like a registration object hasn't been created yet.  So, do so now and add it to
-        // our map.
-        foundRegistrationPtr = le_mem_ForceAlloc(RegistrationPool);
-
-        foundRegistrationPtr->triggered = false;
-
-        foundRegistrationPtr->handlerList = LE_DLS_LIST_INIT;
-        le_utf8_Copy(foundRegistrationPtr->registrationPath,
-                     newPathBuffer,
-                     sizeof(foundRegistrationPtr->registrationPath),
-                     NULL);
-
-        le_hashmap_Put(HandlerRegistrationMap,
-                       foundRegistrationPtr->registrationPath,
-                       foundRegistrationPtr);
-    }
+    // Find the registration object for the given node, creating it if it doesn't exist yet.
+    Registration_t* foundRegistrationPtr = GetRegistration(newPathBuffer);
 
     // Add this handler to the registration object to keep track of it for later.
     Handler_t* handlerObjectPtr = le_mem_ForceAlloc(HandlerPool);
@@ -4369,11 +6860,7 @@ void tdb_RemoveChangeHandler
         RemoveHandler(registrationPtr, handlerObjectPtr);
 
         // If there are no more handlers in this registration object, kill the object.
-        if (le_dls_IsEmpty(&registrationPtr->handlerList))
-        {
-            le_hashmap_Remove(HandlerRegistrationMap, registrationPtr->registrationPath);
-            le_mem_Release(registrationPtr);
-        }
+        ReleaseRegistration(registrationPtr);
     }
 }
 
@@ -4405,7 +6892,6 @@ void tdb_CleanUpHandlers
     {
         Registration_t* registrationPtr = CONTAINER_OF(linkPtr, Registration_t, link);
 
-        le_hashmap_Remove(HandlerRegistrationMap, registrationPtr->registrationPath);
-        le_mem_Release(registrationPtr);
+        ReleaseRegistration(registrationPtr);
     }
 }
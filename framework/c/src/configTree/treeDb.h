@@ -287,6 +287,42 @@ le_result_t tdb_WriteTreeNode
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a configuration tree node's contents from a buffer holding the same text that
+ *  tdb_ReadTreeNode() reads from a file.
+ *
+ *  @return True if the read is successful, or false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+bool tdb_ReadTreeNodeFromBuffer
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to write the new data to.
+    const char* bufferPtr,  ///< [IN] The text to read.
+    size_t bufferSize       ///< [IN] The size of the text.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree node and it's children to a newly allocated buffer, in the same format that
+ *  tdb_WriteTreeNode() writes to a file.  The caller must free() the buffer.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_WriteTreeNodeToBuffer
+(
+    tdb_NodeRef_t nodeRef,    ///< [IN]  Write the contents of this node to the buffer.
+    char** bufferPtrPtr,      ///< [OUT] The newly allocated buffer.
+    size_t* bufferSizePtr     ///< [OUT] The size of the text in the buffer.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Given a base node and a path, find another node in the tree.
@@ -528,9 +564,12 @@ le_result_t tdb_GetValueAsString
 /**
  *  Set the given node to a string value.  If the given node is a stem then all children will be
  *  lost.
+ *
+ *  @return LE_OK if the value was written, LE_OVERFLOW if it's longer than LE_CFG_STR_LEN.  In that
+ *          case the node is left as it was.
  */
 // -------------------------------------------------------------------------------------------------
-void tdb_SetValueAsString
+le_result_t tdb_SetValueAsString
 (
     tdb_NodeRef_t nodeRef,  ///< [IN] The node to set.
     const char* stringPtr   ///< [IN] The value to write to the node.
@@ -247,7 +247,8 @@ static void FindFileTrees
 
         if (   (strcmp(dotStrPtr, ".rock") != 0)
             && (strcmp(dotStrPtr, ".paper") != 0)
-            && (strcmp(dotStrPtr, ".scissors") != 0))
+            && (strcmp(dotStrPtr, ".scissors") != 0)
+            && (strcmp(dotStrPtr, ".journal") != 0))
         {
             continue;
         }
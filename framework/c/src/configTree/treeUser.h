@@ -152,6 +152,25 @@ tu_UserRef_t tu_GetCurrentConfigAdminUserInfo
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the information for the current user on the other side of a configBatch API connection.
+ *
+ *  @note This function must be called within the context of one of the configBatch API service
+ *        handlers.
+ *
+ *  @return A reference to the user information that represents the user on the other end of the
+ *          current API connection.
+ */
+//--------------------------------------------------------------------------------------------------
+tu_UserRef_t tu_GetCurrentConfigBatchUserInfo
+(
+    void
+);
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Get a tree for a user, if the tree is specified in the path, get that tree, (if allowed.)
@@ -65,14 +65,22 @@
  * Included in the set of file descriptors that are being monitored by epoll is an eventfd
  * (see 'man eventfd') monitored in "level-triggered" mode.
  *
- * Whenever an Event Report is added to the Event Queue for a thread, the number 1 is written to
- * that thread's eventfd.  When Event Reports are popped off a thread's Event Queue, that thread's
- * eventfd is read to decrement it.  As long as the eventfd's value is greater than 0, epoll_wait()
+ * Each thread's Event Queue is a lock-free multiple-producer, single-consumer queue.  Any thread
+ * can push Event Reports onto the queue's "incoming" stack (eventQueueHead) using an atomic
+ * compare-and-swap.  Only the thread that owns the queue takes Reports off that stack, by
+ * atomically swapping the whole stack out for an empty one and then reversing it onto its
+ * private pending queue, so the Reports are processed in the order they were pushed.
+ *
+ * The thread's eventfd is only written when a push finds the incoming stack empty (i.e., when the
+ * queue goes from empty to non-empty), so a burst of Reports costs one write() and one read()
+ * instead of one of each per Report.  The eventfd is read (resetting it to zero) before the
+ * incoming stack is swapped out, so a Report pushed after that swap will always find the stack
+ * empty and write the eventfd again.  As long as the eventfd's value is greater than 0, epoll_wait()
  * will return immediately, reporting that there is something to read from that fd.
  *
  * The Event Loop is an infinite loop that calls epoll_wait() and then responds to any fd events
- * that epoll_wait() reports.  If epoll_wait() reports an event on the eventfd, then an Event Report
- * is popped off the Event Queue and processed.  If epoll_wait() reports an event on any other fd,
+ * that epoll_wait() reports.  If epoll_wait() reports an event on the eventfd, then the Event
+ * Reports are taken off the Event Queue and processed.  If epoll_wait() reports an event on any other fd,
  * FD Event Reports are created and pushed onto Event Queues according to what handlers are
  * registered for those events.  All pending Event Reports are processed until the Event Queue is
  * empty before returning to epoll_wait().  (NOTE: This choice was made to save system call
@@ -86,7 +94,8 @@
  *
  * Everything can be shared between multiple threads, and therefore must be protected from
  * multithreaded race conditions.  A Mutex is provided for that purpose, and it can be locked
- * and unlocked using the functions Lock() and Unlock().
+ * and unlocked using the functions Lock() and Unlock().  The Event Queues are the exception;
+ * they are lock-free (see above).
  *
  * ----
  *
@@ -153,6 +162,8 @@ typedef struct
     le_mem_PoolRef_t    reportPoolRef;          ///< Pool for this event's Report objects.
     size_t              payloadSize;            ///< Size of the Report payload, in bytes.
     bool                isRefCounted;           ///< true = payload is a ref-counted object pointer.
+    le_mem_PoolRef_t    sharedPayloadPoolRef;   ///< Pool for payloads shared by all handlers, or
+                                                ///  NULL if each handler gets its own copy.
 }
 Event_t;
 
@@ -235,6 +246,10 @@ typedef enum
     LE_EVENT_REPORT_COUNTED_REF,    ///< Publish-Subscribe Event Report containing poiner to
                                     ///  reference-counted object allocated from a memory pool.
 
+    LE_EVENT_REPORT_SHARED,         ///< Publish-Subscribe Event Report containing pointer to
+                                    ///  a payload shared by all the event's handlers.  The
+                                    ///  report holds one reference to the payload.
+
     LE_EVENT_REPORT_QUEUED_FUNC,    ///< Queued Function.
 }
 EventReportType_t;
@@ -276,6 +291,7 @@ typedef struct
     Report_t                baseClass;  ///< Part that is common to all types of report.
     le_event_HandlerRef_t   handlerRef; ///< Safe Reference to the handler for this event.
     void*                   payload[0]; ///< If the report has payload, it comes at the end.
+                                        ///  For counted-ref and shared reports, it is a pointer.
 }
 PubSubEventReport_t;
 
@@ -410,7 +426,8 @@ static Event_t* CreateEvent
 (
     const char* name,       ///< [in] Name of the event ID.  (Named for diagnostic purposes.)
     size_t      payloadSize,///< [in] Data payload size (in bytes) of the event reports (can be 0).
-    bool        isRefCounted///< [in] true = the payload will be a pointer to a ref-counted object.
+    bool        isRefCounted,///< [in] true = the payload will be a pointer to a ref-counted object.
+    bool        isShared    ///< [in] true = one copy of the payload is shared by all handlers.
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -432,7 +449,7 @@ static Event_t* CreateEvent
     // Create the memory pool from which reports for this event are to be allocated.
     // Note: We can't delete pools, so we don't allow Event Ids to be deleted.
     /// @todo Make this configurable.
-    char poolNameStr[LIMIT_MAX_EVENT_NAME_BYTES + 8];
+    char poolNameStr[LIMIT_MAX_EVENT_NAME_BYTES + 9];
     size_t bytesCopied;
     le_utf8_Copy(poolNameStr, eventPtr->name, sizeof(poolNameStr), &bytesCopied);
     if (LE_OVERFLOW == le_utf8_Copy(poolNameStr + bytesCopied,
@@ -442,8 +459,28 @@ static Event_t* CreateEvent
     {
         LE_WARN("Event report pool name truncated for '%s' events.", name);
     }
-    eventPtr->reportPoolRef = le_mem_CreatePool(poolNameStr,
-                                              offsetof(PubSubEventReport_t, payload) + payloadSize);
+    eventPtr->sharedPayloadPoolRef = NULL;
+    if (isShared)
+    {
+        // The reports only carry a pointer to the payload, which comes from its own pool.
+        eventPtr->reportPoolRef = le_mem_CreatePool(poolNameStr,
+                                                    offsetof(PubSubEventReport_t, payload)
+                                                    + sizeof(void*));
+
+        le_utf8_Copy(poolNameStr + bytesCopied,
+                     "-payloads",
+                     sizeof(poolNameStr) - bytesCopied,
+                     NULL);
+        eventPtr->sharedPayloadPoolRef = le_mem_CreatePool(poolNameStr,
+                                                           (payloadSize > 0) ? payloadSize : 1);
+        le_mem_ExpandPool(eventPtr->sharedPayloadPoolRef, DEFAULT_REPORT_POOL_SIZE);
+    }
+    else
+    {
+        eventPtr->reportPoolRef = le_mem_CreatePool(poolNameStr,
+                                                    offsetof(PubSubEventReport_t, payload)
+                                                    + payloadSize);
+    }
     le_mem_ExpandPool(eventPtr->reportPoolRef, DEFAULT_REPORT_POOL_SIZE);
 
     // Up until now, we have not accessed anything that is available to anyone else; except for
@@ -488,7 +525,8 @@ static void DeleteHandler
 /**
  * Write to a thread's Event File Descriptor.  This increments it by one.
  *
- * This must be done exactly once for each Event Report pushed onto the thread's Event Queue.
+ * This must be done whenever Event Reports are pushed onto the thread's Event Queue while it is
+ * empty.
  */
 //--------------------------------------------------------------------------------------------------
 static void WriteEventFd
@@ -526,9 +564,10 @@ static void WriteEventFd
 //--------------------------------------------------------------------------------------------------
 /**
  * Read a thread's Event File Descriptor.  This fetches the value of the Event FD (which is
- * the number of event reports on the Event Queue) and resets the Event FD value to zero.
+ * the number of times it has been written since it was last read) and resets the Event FD value
+ * to zero.
  *
- * @return The number of Event Reports on the thread's Event Queue.
+ * @return The value of the Event FD (0 if it was already zero).
  */
 //--------------------------------------------------------------------------------------------------
 static uint64_t ReadEventFd
@@ -547,6 +586,10 @@ static uint64_t ReadEventFd
         {
             return readBuff;
         }
+        else if ((readSize == -1) && (errno == EAGAIN))
+        {
+            return 0;
+        }
         else
         {
             if ((readSize == -1) && (errno != EINTR))
@@ -562,6 +605,185 @@ static uint64_t ReadEventFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a payload into a new shared payload object for an event created using
+ * le_event_CreateIdWithSharedPayload().
+ *
+ * @return Pointer to the shared payload.  The caller owns one reference to it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CreateSharedPayload
+(
+    Event_t*    eventPtr,   ///< [in] Ptr to the Event object.
+    const void* payloadPtr, ///< [in] Ptr to the payload bytes to be copied.
+    size_t      payloadSize ///< [in] Number of bytes of payload to copy.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    void* sharedPayloadPtr = le_mem_ForceAlloc(eventPtr->sharedPayloadPoolRef);
+
+    memset(sharedPayloadPtr, 0, eventPtr->payloadSize);
+    memcpy(sharedPayloadPtr, payloadPtr, payloadSize);
+
+    return sharedPayloadPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a Publish-Subscribe Event Report for a given handler.
+ *
+ * If a shared payload is given, the report gets its own reference to it.  Otherwise, the payload
+ * is copied into the report.
+ *
+ * @return Pointer to the Report, which has not been queued yet.
+ *
+ * @warning Assumes the Mutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static PubSubEventReport_t* CreatePubSubReport
+(
+    Event_t*    eventPtr,           ///< [in] Ptr to the Event object.
+    Handler_t*  handlerPtr,         ///< [in] Ptr to the Handler the report is for.
+    const void* payloadPtr,         ///< [in] Ptr to the payload bytes to be copied (if not shared).
+    size_t      payloadSize,        ///< [in] Number of bytes of payload to copy (if not shared).
+    void*       sharedPayloadPtr    ///< [in] Ptr to the shared payload, or NULL if not shared.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    PubSubEventReport_t* reportObjPtr = le_mem_ForceAlloc(eventPtr->reportPoolRef);
+
+    reportObjPtr->baseClass.link = LE_SLS_LINK_INIT;
+    reportObjPtr->handlerRef = handlerPtr->safeRef;
+
+    if (sharedPayloadPtr != NULL)
+    {
+        reportObjPtr->baseClass.type = LE_EVENT_REPORT_SHARED;
+        le_mem_AddRef(sharedPayloadPtr);
+        reportObjPtr->payload[0] = sharedPayloadPtr;
+    }
+    else
+    {
+        reportObjPtr->baseClass.type = LE_EVENT_REPORT_PLAIN;
+        memset(reportObjPtr->payload, 0, eventPtr->payloadSize);
+        memcpy(reportObjPtr->payload, payloadPtr, payloadSize);
+    }
+
+    return reportObjPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a chain of Event Reports onto a thread's Event Queue, and wake up the thread if the queue
+ * was empty.
+ *
+ * Can be called by any thread, with or without the Mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushReports
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [in] Ptr to the thread's per-thread record.
+    le_sls_Link_t* newestLinkPtr,           ///< [in] Newest Report in the chain.  Each Report's
+                                            ///       link points to the one reported before it.
+    le_sls_Link_t* oldestLinkPtr            ///< [in] Oldest Report in the chain.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The thread must not be cancelled between the push and the write to the eventfd, or the
+    // queue would never be serviced again.
+    int oldState;
+    int err = pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldState);
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+
+    le_sls_Link_t* headPtr = __atomic_load_n(&perThreadRecPtr->eventQueueHead, __ATOMIC_RELAXED);
+
+    do
+    {
+        oldestLinkPtr->nextPtr = headPtr;
+    }
+    while (!__atomic_compare_exchange_n(&perThreadRecPtr->eventQueueHead,
+                                        &headPtr,
+                                        newestLinkPtr,
+                                        true,
+                                        __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED));
+
+    // If the queue was empty, the thread may be waiting for the eventfd, so increment it.
+    // This will wake up the thread and tell it that it has something on its Event Queue.
+    if (headPtr == NULL)
+    {
+        WriteEventFd(perThreadRecPtr);
+    }
+
+    err = pthread_setcancelstate(oldState, &oldState);
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push one Event Report onto a thread's Event Queue.
+ *
+ * Can be called by any thread, with or without the Mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void PushReport
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [in] Ptr to the thread's per-thread record.
+    Report_t* reportPtr                     ///< [in] The Report to queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    PushReports(perThreadRecPtr, &reportPtr->link, &reportPtr->link);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move all Event Reports that have been pushed onto the calling thread's Event Queue to the end of
+ * its pending queue, oldest first.
+ *
+ * @return The number of Event Reports moved.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TakeReports
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* linkPtr = __atomic_exchange_n(&perThreadRecPtr->eventQueueHead,
+                                                 NULL,
+                                                 __ATOMIC_ACQUIRE);
+    le_sls_Link_t* oldestLinkPtr = NULL;
+    size_t numReports = 0;
+
+    // Reverse the chain, so that it goes from oldest to newest.
+    while (linkPtr != NULL)
+    {
+        le_sls_Link_t* nextLinkPtr = linkPtr->nextPtr;
+
+        linkPtr->nextPtr = oldestLinkPtr;
+        oldestLinkPtr = linkPtr;
+        linkPtr = nextLinkPtr;
+        numReports++;
+    }
+
+    while (oldestLinkPtr != NULL)
+    {
+        linkPtr = oldestLinkPtr;
+        oldestLinkPtr = oldestLinkPtr->nextPtr;
+
+        *linkPtr = LE_SLS_LINK_INIT;
+        le_sls_Queue(&perThreadRecPtr->pendingQueue, linkPtr);
+    }
+
+    return numReports;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Process one event report from the calling thread's Event Queue.
@@ -576,13 +798,11 @@ static void ProcessOneEventReport
     le_sls_Link_t* linkPtr;
     Report_t* reportObjPtr;
     Handler_t* handlerPtr;
+    int oldState;
 
-    int oldState = Lock();
-
-    // Pop an Event Report off the head of the Event Queue (inside a critical section).
-    linkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue);
-
-    Unlock(oldState);
+    // Pop an Event Report off the head of the pending queue.  Only this thread accesses that queue,
+    // so there's no need to lock the Mutex.
+    linkPtr = le_sls_Pop(&perThreadRecPtr->pendingQueue);
 
     if (linkPtr == NULL)
     {
@@ -623,7 +843,8 @@ static void ProcessOneEventReport
 
             // If its payload is a pointer to a reference-counted memory pool object,
             // then that has to be released.
-            if (reportObjPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+            if (   (reportObjPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+                || (reportObjPtr->type == LE_EVENT_REPORT_SHARED) )
             {
                 le_mem_Release(pubSubReportPtr->payload[0]);
             }
@@ -637,22 +858,29 @@ static void ProcessOneEventReport
             le_event_LayeredHandlerFunc_t firstLayerFunc = handlerPtr->firstLayerFunc;
             void* secondLayerFunc = handlerPtr->secondLayerFunc;
 
-            // If it's a reference-counted report, then the payload is a pointer to the
-            // report.  Otherwise, the report itself is in the payload.
+            // If it's a reference-counted or shared report, then the payload is a pointer to
+            // the report.  Otherwise, the report itself is in the payload.
             void* reportPtr;
-            if (reportObjPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+            if (reportObjPtr->type == LE_EVENT_REPORT_PLAIN)
             {
-                reportPtr = pubSubReportPtr->payload[0];
+                reportPtr = pubSubReportPtr->payload;
             }
             else
             {
-                reportPtr = pubSubReportPtr->payload;
+                reportPtr = pubSubReportPtr->payload[0];
             }
 
             Unlock(oldState);  // Unlock the mutex before calling the handler function.
                                // Don't access the Handler object anymore after this.
 
             firstLayerFunc(reportPtr, secondLayerFunc);
+
+            // The handler doesn't own a shared payload, so drop this report's reference to it.
+            // The payload is freed when the last handler of the report is done with it.
+            if (reportObjPtr->type == LE_EVENT_REPORT_SHARED)
+            {
+                le_mem_Release(reportPtr);
+            }
         }
     }
 
@@ -674,9 +902,12 @@ static void ProcessEventReports
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Read the eventfd to fetch the number of Reports on the Event Queue and reset the count
-    // to zero.
-    uint64_t numReports = ReadEventFd(perThreadRecPtr);
+    // Reset the eventfd to zero before taking the Reports off the Event Queue, so that anything
+    // queued after that will find the queue empty and write the eventfd again.
+    (void)ReadEventFd(perThreadRecPtr);
+
+    (void)TakeReports(perThreadRecPtr);
+    size_t numReports = le_sls_NumLinks(&perThreadRecPtr->pendingQueue);
 
     // Process only those event reports that are already on the queue.  Anything reported by the
     // event handlers will have to wait until next time ProcessEventReports() is called.
@@ -718,7 +949,7 @@ static void PubSubHandlerFunc
  * Queue a function onto a specific thread's Event Queue (could belong to the calling thread or
  * could belong to some other thread).
  *
- * @warning Assumes the mutex is locked and the thread is protected from cancellation.
+ * @note Doesn't need the Mutex to be locked.
  */
 //--------------------------------------------------------------------------------------------------
 static void QueueFunction
@@ -740,11 +971,9 @@ static void QueueFunction
     reportPtr->param1Ptr = param1Ptr;
     reportPtr->param2Ptr = param2Ptr;
 
-    // Queue it to the Event Queue.
-    le_sls_Queue(&perThreadRecPtr->eventQueue, &reportPtr->baseClass.link);
-
-    // Write to the eventfd to notify the Event Loop that there is something on the queue.
-    WriteEventFd(perThreadRecPtr);
+    // Queue it to the Event Queue.  This writes to the eventfd to notify the Event Loop that
+    // there is something on the queue, if necessary.
+    PushReport(perThreadRecPtr, &reportPtr->baseClass);
 }
 
 
@@ -838,7 +1067,8 @@ void event_InitThread
     event_PerThreadRec_t* recPtr = thread_GetEventRecPtr();
 
     // Initialize the various thread-specific lists and queues.
-    recPtr->eventQueue = LE_SLS_LIST_INIT;
+    recPtr->eventQueueHead = NULL;
+    recPtr->pendingQueue = LE_SLS_LIST_INIT;
     recPtr->handlerList = LE_DLS_LIST_INIT;
     recPtr->fdMonitorList = LE_DLS_LIST_INIT;
 
@@ -849,7 +1079,9 @@ void event_InitThread
 
     // Open an eventfd for this thread.  This will be uses to signal to the epoll fd that there
     // are Event Reports on the Event Queue.
-    recPtr->eventQueueFd = eventfd(0, 0);
+    // It is non-blocking because it is only written when the queue becomes non-empty, so the Event
+    // Loop can find it already reset after taking Reports off the queue.
+    recPtr->eventQueueFd = eventfd(0, EFD_NONBLOCK);
     LE_FATAL_IF(recPtr->eventQueueFd < 0, "eventfd() failed with errno %d (%m).", errno);
 
     // Add the eventfd to the list of file descriptors to wait for using epoll_wait().
@@ -946,13 +1178,15 @@ void event_DestructThread
     fdMon_DestructThread(perThreadRecPtr);
 
     // Discard everything on the Event Queue.
-    while (NULL != (singleLinkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue)))
+    (void)TakeReports(perThreadRecPtr);
+    while (NULL != (singleLinkPtr = le_sls_Pop(&perThreadRecPtr->pendingQueue)))
     {
         Report_t* reportPtr = CONTAINER_OF(singleLinkPtr, Report_t, link);
 
         // If it is carrying a pointer to a reference-counted object from a memory pool,
         // release that thing first.
-        if (reportPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+        if (   (reportPtr->type == LE_EVENT_REPORT_COUNTED_REF)
+            || (reportPtr->type == LE_EVENT_REPORT_SHARED) )
         {
             PubSubEventReport_t* pubSubReportPtr = CONTAINER_OF(reportPtr,
                                                                 PubSubEventReport_t,
@@ -1012,7 +1246,7 @@ le_event_Id_t le_event_CreateId
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return CreateEvent(name, payloadSize, false)->id;
+    return CreateEvent(name, payloadSize, false, false)->id;
 }
 
 
@@ -1033,7 +1267,30 @@ le_event_Id_t le_event_CreateIdWithRefCounting
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return CreateEvent(name, sizeof(void*), true)->id;
+    return CreateEvent(name, sizeof(void*), true, false)->id;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new event ID whose report payloads are copied only once, no matter how many handlers
+ * there are.  All the handlers of a report are passed a pointer to the same copy, which is
+ * released after the last of them has returned.
+ *
+ * @return
+ *      Event ID.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_event_Id_t le_event_CreateIdWithSharedPayload
+(
+    const char* name,       ///< [in] Name of the event ID.  (Named for diagnostic purposes.)
+    size_t      payloadSize ///< [in] Data payload size (in bytes) of the event reports (can be 0).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return CreateEvent(name, payloadSize, false, true)->id;
 }
 
 
@@ -1204,6 +1461,14 @@ void le_event_Report
 
     TRACE("Reporting event '%s'...", eventPtr->name);
 
+    // If the handlers are to share the payload, copy it once now.
+    void* sharedPayloadPtr = NULL;
+    if (   (eventPtr->sharedPayloadPoolRef != NULL)
+        && (!le_dls_IsEmpty(&eventPtr->handlerList)) )
+    {
+        sharedPayloadPtr = CreateSharedPayload(eventPtr, payloadPtr, payloadSize);
+    }
+
     // For each Handler registered for this Event,
     le_dls_Link_t* linkPtr = le_dls_Peek(&eventPtr->handlerList);
     while (linkPtr != NULL)
@@ -1215,21 +1480,175 @@ void le_event_Report
         TRACE("  ...to handler '%s'.", handlerPtr->name);
 
         // Queue a report to the handler's thread's Event Queue.
-        PubSubEventReport_t* reportObjPtr = le_mem_ForceAlloc(eventPtr->reportPoolRef);
-        reportObjPtr->baseClass.link = LE_SLS_LINK_INIT;
-        reportObjPtr->baseClass.type = LE_EVENT_REPORT_PLAIN;
-        reportObjPtr->handlerRef = handlerPtr->safeRef;
-        memset(reportObjPtr->payload, 0, eventPtr->payloadSize);
-        memcpy(reportObjPtr->payload, payloadPtr, payloadSize);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
+        PubSubEventReport_t* reportObjPtr = CreatePubSubReport(eventPtr,
+                                                               handlerPtr,
+                                                               payloadPtr,
+                                                               payloadSize,
+                                                               sharedPayloadPtr);
+        PushReport(perThreadRecPtr, &reportObjPtr->baseClass);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
+    }
+
+    // The reports hold their own references to the shared payload now.
+    if (sharedPayloadPtr != NULL)
+    {
+        le_mem_Release(sharedPayloadPtr);
+    }
+
+    Unlock(oldState);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a batch of Event Reports to all the registered event handlers.
+ *
+ * Each handler's reports are pushed onto its thread's Event Queue together, so the handler's
+ * thread is woken up at most once for the whole batch.  The reports are delivered in array order.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_ReportBatch
+(
+    le_event_Id_t   eventId,        ///< [in] The event ID.
+    void*           payloadArrayPtr,///< [in] Pointer to an array of payloads, each payloadSize
+                                    ///       bytes long, to be copied into the reports.
+    size_t          payloadSize,    ///< [in] The number of bytes of payload to copy into each
+                                    ///       report.
+    size_t          numReports      ///< [in] The number of payloads in the array.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (numReports == 0)
+    {
+        return;
+    }
+
+    int oldState = Lock();
+
+    Event_t* eventPtr = le_ref_Lookup(EventRefMap, eventId);
+
+    LE_FATAL_IF(eventPtr == NULL, "No such event %p.", eventId);
+
+    LE_FATAL_IF(eventPtr->isRefCounted,
+                "Attempt to use Event ID (%s) created using le_event_CreateIdWithRefCounting().",
+                eventPtr->name);
+
+    LE_FATAL_IF(eventPtr->payloadSize < payloadSize,
+                "Payload size too big for event '%s' (%zu > %zu).",
+                eventPtr->name,
+                payloadSize,
+                eventPtr->payloadSize);
+
+    TRACE("Reporting %zu events '%s'...", numReports, eventPtr->name);
+
+    // If the handlers are to share the payloads, the first handler's chain of reports is built
+    // from the payload array, and holds the only copies of the payloads.  The other handlers'
+    // chains are built from that chain, so the first chain must be queued last.
+    bool isShared = (eventPtr->sharedPayloadPoolRef != NULL);
+    Handler_t* firstHandlerPtr = NULL;
+    le_sls_Link_t* firstNewestLinkPtr = NULL;
+    le_sls_Link_t* firstOldestLinkPtr = NULL;
+
+    // For each Handler registered for this Event,
+    le_dls_Link_t* linkPtr = le_dls_Peek(&eventPtr->handlerList);
+    while (linkPtr != NULL)
+    {
+        Handler_t* handlerPtr = CONTAINER_OF(linkPtr, Handler_t, eventLink);
+
+        TRACE("  ...to handler '%s'.", handlerPtr->name);
+
+        // Build a chain of reports, newest first, and queue it to the handler's thread's
+        // Event Queue in one go.
+        le_sls_Link_t* newestLinkPtr = NULL;
+        le_sls_Link_t* oldestLinkPtr = NULL;
+        PubSubEventReport_t* reportObjPtr;
+
+        if (firstNewestLinkPtr == NULL)
+        {
+            size_t i;
+
+            for (i = 0; i < numReports; i++)
+            {
+                const void* payloadPtr = (uint8_t*)payloadArrayPtr + (i * payloadSize);
+                void* sharedPayloadPtr = NULL;
+
+                if (isShared)
+                {
+                    sharedPayloadPtr = CreateSharedPayload(eventPtr, payloadPtr, payloadSize);
+                }
+
+                reportObjPtr = CreatePubSubReport(eventPtr,
+                                                  handlerPtr,
+                                                  payloadPtr,
+                                                  payloadSize,
+                                                  sharedPayloadPtr);
+                reportObjPtr->baseClass.link.nextPtr = newestLinkPtr;
+
+                // The report holds its own reference to the shared payload now.
+                if (sharedPayloadPtr != NULL)
+                {
+                    le_mem_Release(sharedPayloadPtr);
+                }
+
+                newestLinkPtr = &reportObjPtr->baseClass.link;
+                if (oldestLinkPtr == NULL)
+                {
+                    oldestLinkPtr = newestLinkPtr;
+                }
+            }
+
+            if (isShared)
+            {
+                firstHandlerPtr = handlerPtr;
+                firstNewestLinkPtr = newestLinkPtr;
+                firstOldestLinkPtr = oldestLinkPtr;
+            }
+        }
+        else
+        {
+            // Walk the first handler's chain, newest first, appending to this handler's chain.
+            le_sls_Link_t* firstLinkPtr;
+
+            for (firstLinkPtr = firstNewestLinkPtr;
+                 firstLinkPtr != NULL;
+                 firstLinkPtr = firstLinkPtr->nextPtr)
+            {
+                PubSubEventReport_t* firstReportPtr = CONTAINER_OF(firstLinkPtr,
+                                                                   PubSubEventReport_t,
+                                                                   baseClass.link);
+
+                reportObjPtr = CreatePubSubReport(eventPtr,
+                                                  handlerPtr,
+                                                  NULL,
+                                                  0,
+                                                  firstReportPtr->payload[0]);
+
+                if (oldestLinkPtr == NULL)
+                {
+                    newestLinkPtr = &reportObjPtr->baseClass.link;
+                }
+                else
+                {
+                    oldestLinkPtr->nextPtr = &reportObjPtr->baseClass.link;
+                }
+                oldestLinkPtr = &reportObjPtr->baseClass.link;
+            }
+        }
+
+        if (handlerPtr != firstHandlerPtr)
+        {
+            PushReports(handlerPtr->threadRecPtr, newestLinkPtr, oldestLinkPtr);
+        }
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
 
+    if (firstHandlerPtr != NULL)
+    {
+        PushReports(firstHandlerPtr->threadRecPtr, firstNewestLinkPtr, firstOldestLinkPtr);
+    }
+
     Unlock(oldState);
 }
 
@@ -1282,11 +1701,7 @@ void le_event_ReportWithRefCounting
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         reportObjPtr->payload[0] = objectPtr;
         le_mem_AddRef(objectPtr);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
-
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        PushReport(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1366,11 +1781,7 @@ void le_event_QueueFunction
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
-
     QueueFunction(thread_GetEventRecPtr(), func, param1Ptr, param2Ptr);
-
-    Unlock(oldState);
 }
 
 
@@ -1389,11 +1800,7 @@ void le_event_QueueFunctionToThread
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
-
     QueueFunction(thread_GetOtherEventRecPtr(thread), func, param1Ptr, param2Ptr);
-
-    Unlock(oldState);
 }
 
 
@@ -1589,27 +1996,21 @@ le_result_t le_event_ServiceLoop
     (void)ReadEventFd(perThreadRecPtr);
 
     // If there is something on the Event Queue, process one thing.
-    int oldState = Lock();
-
-    if (!le_sls_IsEmpty(&perThreadRecPtr->eventQueue))
-    {
-        Unlock(oldState);
-
-        ProcessOneEventReport(perThreadRecPtr); // This function assumes the mutex is NOT locked.
-
-        oldState = Lock();
-    }
-
-    // The caller needs to know if there is more stuff waiting on the Event Queue.
-    le_result_t returnCode = LE_OK;
-    if (le_sls_IsEmpty(&perThreadRecPtr->eventQueue))
+    (void)TakeReports(perThreadRecPtr);
+    ProcessOneEventReport(perThreadRecPtr); // This function assumes the mutex is NOT locked.
+
+    // The caller needs to know if there is more stuff waiting on the Event Queue.  If there is,
+    // keep the eventfd readable, because it will not be written again until the queue has been
+    // emptied.
+    if (   le_sls_IsEmpty(&perThreadRecPtr->pendingQueue)
+        && (__atomic_load_n(&perThreadRecPtr->eventQueueHead, __ATOMIC_ACQUIRE) == NULL) )
     {
-        returnCode = LE_WOULD_BLOCK;
+        return LE_WOULD_BLOCK;
     }
 
-    Unlock(oldState);
+    WriteEventFd(perThreadRecPtr);
 
-    return returnCode;
+    return LE_OK;
 }
 
 
@@ -51,7 +51,10 @@ event_LoopState_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    le_sls_List_t       eventQueue;         ///< The thread's event queue.
+    le_sls_Link_t*      eventQueueHead;     ///< Reports queued to the thread's event queue by any
+                                            ///  thread, newest first.  Lock-free (see eventLoop.c).
+    le_sls_List_t       pendingQueue;       ///< Reports taken off eventQueueHead but not processed
+                                            ///  yet, oldest first.  Only accessed by the thread.
     le_dls_List_t       handlerList;        ///< List of handlers registered with this thread.
     le_dls_List_t       fdMonitorList;      ///< List of FD Monitors created by this thread.
     int                 epollFd;            ///< epoll(7) file descriptor.
@@ -23,6 +23,7 @@
 #include "hashmap.h"
 
 
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Trace if tracing is enabled for a given hashmap.
@@ -35,6 +36,47 @@
     }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A map grows when adding a key would make the number of keys (or, for open addressed maps, the
+ * number of used slots) exceed this fraction of the number of buckets (or slots).
+ **/
+//--------------------------------------------------------------------------------------------------
+#define MAX_LOAD_NUMERATOR      3
+#define MAX_LOAD_DENOMINATOR    4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of old buckets (or slots) moved to the new table by each le_hashmap_Put() and
+ * le_hashmap_Remove() while a map is being resized.  Growing starts at 3/4 load and the table
+ * doubles, so at least 3/4 of the old bucket count puts happen before the next resize is due.
+ * Any step of 2 or more is therefore enough to always finish moving before then.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define REHASH_STEP             8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moving entries while an iteration is in progress could make the iterator skip or repeat
+ * entries, so a resize is put on hold while iterating.  If the load still grows past this many
+ * keys per bucket (or, for open addressed maps, past 7/8 of the slots), the map is resized anyway.
+ **/
+//--------------------------------------------------------------------------------------------------
+#define MAX_CHAINED_LOAD_WHILE_ITERATING    4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marker stored in the key pointer of a slot whose entry has been removed from an open addressed
+ * map.  Lookups must continue probing past such slots, but new entries may reuse them.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const char DeletedSlotMarker;
+#define DELETED_KEY ((const void*)&DeletedSlotMarker)
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Calculate a hash. First this calls the user-supplied hash function.
@@ -79,7 +121,7 @@ static inline size_t HashKey(Hashmap_t* map, const void* key) {
 static Entry_t* CreateEntry
 (
     const void* newKeyPtr,
-    int newHash,
+    size_t newHash,
     const void* newValuePtr,
     le_mem_PoolRef_t poolRef
 )
@@ -124,9 +166,9 @@ static inline size_t CalculateIndex(size_t bucketCount, size_t hash) {
 static inline bool EqualKeys
 (
     const void* keyAPtr,
-    int hashA,
+    size_t hashA,
     const void* keyBPtr,
-    int hashB,
+    size_t hashB,
     le_hashmap_EqualsFunc_t equalsFuncPtr
 )
 {
@@ -142,257 +184,911 @@ static inline bool EqualKeys
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a HashMap
- *
- * @return  Returns a reference to the map.
+ * Checks if a slot of an open addressed map holds an entry.
  *
- * @note Terminates the process on failure, so no need to check the return value for errors.
+ * @return  Returns true if the slot is neither empty nor deleted.
  */
 //--------------------------------------------------------------------------------------------------
-le_hashmap_Ref_t le_hashmap_Create
+static inline bool IsSlotInUse
 (
-    const char*                nameStr,          ///< [in] Name of the HashMap
-    size_t                     capacity,         ///< [in] Expected capacity of the map
-    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
-    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
+    const Slot_t* slotPtr
 )
 {
-    LE_ASSERT(hashFunc);
-    LE_ASSERT(equalsFunc);
+    return (slotPtr->keyPtr != NULL) && (slotPtr->keyPtr != DELETED_KEY);
+}
 
-    // It is ok to use malloc here as we will not be destroying the map
-    le_hashmap_Ref_t mapRef = malloc(sizeof(Hashmap_t));
-    LE_ASSERT(mapRef);
 
-    mapRef->traceRef = NULL;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a map is open addressed (as opposed to chained).
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsOpenAddressed
+(
+    Hashmap_t* mapRef
+)
+{
+    return (mapRef->slotsPtr != NULL);
+}
 
-    /**
-     * 0.75 load factor. We have more buckets than expected keys as we want
-     * to reduce the chance of collisions. 1-1 would assume a perfect hashing
-     * function which is rather unlikely. Also, ensure that the capacity is
-     * at least 3 which avoids strange issues in the hashing algorithm
-     */
-    capacity = (capacity < 3)? 3 : capacity;
-    size_t minimumBucketCount = capacity * 4 / 3;
-    mapRef->bucketCount = 1;
-    while (mapRef->bucketCount <= minimumBucketCount) {
-        // Bucket count must be power of 2.
-        mapRef->bucketCount <<= 1;
-    }
 
-    /**
-     * The memory pool is required to store entries. We set a default size and expansion
-     * size to reduce the number of forced allocations.
-     * Initial entries for each hash are actually doubly linked list objects which store
-     * where the starting entry is in the pool.
-     */
-    char poolName[LIMIT_MAX_MEM_POOL_NAME_BYTES] = "hashMap_";
-    le_utf8_Append(poolName, nameStr, sizeof(poolName), NULL);
-    mapRef->entryPoolRef = le_mem_ExpandPool(le_mem_CreatePool(poolName,
-                                                               sizeof(Entry_t)),
-                                                               mapRef->bucketCount / 2);
-    le_mem_SetNumObjsToForce(mapRef->entryPoolRef, mapRef->bucketCount / 8);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a map is in the middle of moving its entries from the old table to the new one.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsResizing
+(
+    Hashmap_t* mapRef
+)
+{
+    return (mapRef->oldBucketCount != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of positions an iterator can be at: all the buckets (or slots) of the current
+ * table followed by all the buckets (or slots) of the old table.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t IteratorRange
+(
+    Hashmap_t* mapRef
+)
+{
+    return mapRef->bucketCount + mapRef->oldBucketCount;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if the map's iterator is part way through the map (i.e., it is on an entry).
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsIterating
+(
+    Hashmap_t* mapRef
+)
+{
+    int32_t index = mapRef->iteratorPtr->currentIndex;
+
+    return (index >= 0) && ((size_t)index < IteratorRange(mapRef));
+}
 
-    mapRef->bucketsPtr = malloc(mapRef->bucketCount * sizeof(le_dls_List_t));
-    LE_ASSERT(mapRef->bucketsPtr);
-    mapRef->chainLengthPtr = malloc(mapRef->bucketCount * sizeof(size_t));
-    LE_ASSERT(mapRef->chainLengthPtr);
-    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
-    LE_ASSERT(mapRef->iteratorPtr);
 
-    uint32_t i = 0;
-    for (i=0; i<mapRef->bucketCount; i++)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the bucket at a given iterator position in a chained map.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_dls_List_t* GetBucketAt
+(
+    Hashmap_t* mapRef,
+    size_t position
+)
+{
+    if (position < mapRef->bucketCount)
     {
-        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
-        mapRef->chainLengthPtr[i] = 0;
+        return &(mapRef->bucketsPtr[position]);
     }
 
-    mapRef->size = 0;
+    return &(mapRef->oldBucketsPtr[position - mapRef->bucketCount]);
+}
 
-    mapRef->hashFuncPtr = hashFunc;
-    mapRef->equalsFuncPtr = equalsFunc;
-    mapRef->nameStr = nameStr;
 
-    memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
-    mapRef->iteratorPtr->theMapPtr = mapRef;
-    mapRef->iteratorPtr->isValueValid = true;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the slot at a given iterator position in an open addressed map.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline Slot_t* GetSlotAt
+(
+    Hashmap_t* mapRef,
+    size_t position
+)
+{
+    if (position < mapRef->bucketCount)
+    {
+        return &(mapRef->slotsPtr[position]);
+    }
 
-    return mapRef;
+    return &(mapRef->oldSlotsPtr[position - mapRef->bucketCount]);
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a key-value pair to a HashMap. If the key already exists in the map then the previous value
- * will be replaced with the new value passed into this function.
- *
- * The process will terminate if this fails as it implies an inability to allocate any more memory
- *
+ * Gets the iterator position of a slot in an open addressed map.
  */
 //--------------------------------------------------------------------------------------------------
-
-void* le_hashmap_Put
+static inline size_t GetSlotPosition
 (
-    le_hashmap_Ref_t mapRef,   ///< [in] Reference to the map
-    const void* keyPtr,        ///< [in] Pointer to the key to be stored
-    const void* valuePtr       ///< [in] Pointer to the value to be stored
+    Hashmap_t* mapRef,
+    const Slot_t* slotPtr
 )
 {
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    if ((slotPtr >= mapRef->slotsPtr) && (slotPtr < mapRef->slotsPtr + mapRef->bucketCount))
+    {
+        return slotPtr - mapRef->slotsPtr;
+    }
 
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
-        mapRef->nameStr,
-        index,
-        (int)hash
-    );
+    return mapRef->bucketCount + (slotPtr - mapRef->oldSlotsPtr);
+}
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
 
-    if (le_dls_NumLinks(listHeadPtr) == 0)
-    {
-        Entry_t* newEntryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
-        LE_ASSERT(newEntryPtr);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calculates the number of buckets (or slots) needed to hold a given number of keys without
+ * exceeding the maximum load.
+ *
+ * @return  A power of 2.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CalculateBucketCount
+(
+    size_t capacity
+)
+{
+    /**
+     * 0.75 load factor. We have more buckets than expected keys as we want
+     * to reduce the chance of collisions. 1-1 would assume a perfect hashing
+     * function which is rather unlikely. Also, ensure that the capacity is
+     * at least 3 which avoids strange issues in the hashing algorithm
+     */
+    capacity = (capacity < 3)? 3 : capacity;
+    size_t minimumBucketCount = capacity * MAX_LOAD_DENOMINATOR / MAX_LOAD_NUMERATOR;
+    size_t bucketCount = 1;
+    while (bucketCount <= minimumBucketCount) {
+        // Bucket count must be power of 2.
+        bucketCount <<= 1;
+    }
 
-        le_dls_Stack(listHeadPtr, &(newEntryPtr->entryListLink));
-        mapRef->size++;
+    return bucketCount;
+}
 
-        HASHMAP_TRACE(
-            mapRef,
-            "Hashmap %s: Added first entry to bucket. Total map size now %zu",
-            mapRef->nameStr,
-            mapRef->size
-        );
 
-        mapRef->chainLengthPtr[index]++;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a new, empty current table for a map.  The previous table (if any) must have been
+ * saved elsewhere by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AllocTable
+(
+    Hashmap_t* mapRef,
+    size_t bucketCount,
+    bool isOpenAddressed
+)
+{
+    mapRef->bucketCount = bucketCount;
 
-        return NULL;
+    if (isOpenAddressed)
+    {
+        mapRef->slotsPtr = calloc(bucketCount, sizeof(Slot_t));
+        LE_ASSERT(mapRef->slotsPtr);
+        mapRef->numUsedSlots = 0;
     }
     else
     {
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+        mapRef->bucketsPtr = malloc(bucketCount * sizeof(le_dls_List_t));
+        LE_ASSERT(mapRef->bucketsPtr);
+        mapRef->chainLengthPtr = malloc(bucketCount * sizeof(size_t));
+        LE_ASSERT(mapRef->chainLengthPtr);
 
-        while (true) {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+        size_t i;
+        for (i = 0; i < bucketCount; i++)
+        {
+            mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
+            mapRef->chainLengthPtr[i] = 0;
+        }
+    }
+}
 
-            // Replace existing value if the keys match.
-            if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-            {
-                const void* oldValue = currentEntryPtr->valuePtr;
-                currentEntryPtr->valuePtr = valuePtr;
 
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Replaced entry in bucket. Total map size now %zu",
-                    mapRef->nameStr,
-                    mapRef->size
-                );
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keeps an iterator that has gone past the end of the map past the end when the number of
+ * iterator positions changes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateFinishedIterator
+(
+    Hashmap_t* mapRef,
+    size_t oldRange
+)
+{
+    HashmapIt_t* iteratorPtr = mapRef->iteratorPtr;
 
-                return (void *)oldValue;
-            }
+    if ((iteratorPtr->currentIndex >= 0) && ((size_t)iteratorPtr->currentIndex >= oldRange))
+    {
+        iteratorPtr->currentIndex = IteratorRange(mapRef);
+        iteratorPtr->currentListPtr = NULL;
+        iteratorPtr->currentLinkPtr = NULL;
+        iteratorPtr->currentSlotPtr = NULL;
+    }
+}
 
-            // Add a new entry if we are at the tail
-            if (le_dls_PeekNext(listHeadPtr, theLinkPtr) == NULL) {
-                Entry_t* newEntryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
-                LE_ASSERT(newEntryPtr);
 
-                le_dls_Queue(listHeadPtr, &(newEntryPtr->entryListLink));
-                mapRef->size++;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts resizing a map: the current table becomes the old table and a new, empty current table
+ * is allocated.  No entries are moved yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartResize
+(
+    Hashmap_t* mapRef,
+    size_t newBucketCount
+)
+{
+    LE_ASSERT(!IsResizing(mapRef));
 
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Added entry to bucket at tail. Map size now %zu",
-                    mapRef->nameStr,
-                    mapRef->size
-                );
+    size_t oldRange = IteratorRange(mapRef);
 
-                mapRef->chainLengthPtr[index]++;
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Resizing from %zu to %zu buckets",
+        mapRef->nameStr,
+        mapRef->bucketCount,
+        newBucketCount
+    );
 
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Bucket now contains %zu entries (%zu)",
-                    mapRef->nameStr,
-                    le_dls_NumLinks(listHeadPtr),
-                    mapRef->chainLengthPtr[index]
-                );
+    mapRef->oldBucketCount = mapRef->bucketCount;
+    mapRef->oldBucketsPtr = mapRef->bucketsPtr;
+    mapRef->oldChainLengthPtr = mapRef->chainLengthPtr;
+    mapRef->oldSlotsPtr = mapRef->slotsPtr;
+    mapRef->rehashIndex = 0;
 
-                return NULL;
-            }
+    AllocTable(mapRef, newBucketCount, IsOpenAddressed(mapRef));
 
-            // Move to next entry.
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-        }
+    // The current table now comes first in the iteration order, so an iterator that is part way
+    // through the (now old) table has to be moved along.
+    int32_t index = mapRef->iteratorPtr->currentIndex;
+    if ((index >= 0) && ((size_t)index < oldRange))
+    {
+        mapRef->iteratorPtr->currentIndex += newBucketCount;
+    }
+    else
+    {
+        UpdateFinishedIterator(mapRef, oldRange);
     }
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Retrieve a value from a HashMap.
- *
- * @return  Returns a pointer to the value or NULL if the key is not found.
- *
+ * Finishes resizing a map once all its entries have been moved out of the old table.
  */
 //--------------------------------------------------------------------------------------------------
-
-void* le_hashmap_Get
+static void FinishResize
 (
-    le_hashmap_Ref_t mapRef,   ///< [in] Reference to the map
-    const void* keyPtr         ///< [in] Pointer to the key to be retrieved
+    Hashmap_t* mapRef
 )
 {
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    size_t oldRange = IteratorRange(mapRef);
+
+    free(mapRef->oldBucketsPtr);
+    free(mapRef->oldChainLengthPtr);
+    free(mapRef->oldSlotsPtr);
+
+    mapRef->oldBucketCount = 0;
+    mapRef->oldBucketsPtr = NULL;
+    mapRef->oldChainLengthPtr = NULL;
+    mapRef->oldSlotsPtr = NULL;
+    mapRef->rehashIndex = 0;
+
+    UpdateFinishedIterator(mapRef, oldRange);
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
     HASHMAP_TRACE(
         mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
+        "Hashmap %s: Resized to %zu buckets",
         mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
+        mapRef->bucketCount
     );
+}
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds a free slot for a key that is known not to be in the current table of an open addressed
+ * map.  Deleted slots are reused.
+ *
+ * @return  Pointer to the slot.
+ */
+//--------------------------------------------------------------------------------------------------
+static Slot_t* FindFreeSlot
+(
+    Hashmap_t* mapRef,
+    size_t hash
+)
+{
+    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+
+    while (IsSlotInUse(&(mapRef->slotsPtr[index])))
+    {
+        index = CalculateIndex(mapRef->bucketCount, index + 1);
+    }
+
+    return &(mapRef->slotsPtr[index]);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves one bucket (or slot) of the old table into the current table.  If the map's iterator is
+ * on an entry that gets moved, the iterator is moved with it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MoveOldBucket
+(
+    Hashmap_t* mapRef,
+    size_t oldIndex
+)
+{
+    HashmapIt_t* iteratorPtr = mapRef->iteratorPtr;
+    bool isIterating = IsIterating(mapRef);
+
+    if (IsOpenAddressed(mapRef))
+    {
+        Slot_t* oldSlotPtr = &(mapRef->oldSlotsPtr[oldIndex]);
+
+        if (IsSlotInUse(oldSlotPtr))
+        {
+            Slot_t* newSlotPtr = FindFreeSlot(mapRef, oldSlotPtr->hash);
+
+            if (newSlotPtr->keyPtr == NULL)
+            {
+                mapRef->numUsedSlots++;
+            }
+            *newSlotPtr = *oldSlotPtr;
+
+            if (isIterating && (iteratorPtr->currentSlotPtr == oldSlotPtr))
+            {
+                iteratorPtr->currentSlotPtr = newSlotPtr;
+                iteratorPtr->currentIndex = newSlotPtr - mapRef->slotsPtr;
+            }
+        }
+
+        // Leave a deleted marker behind so that lookups of keys still in the old table keep
+        // probing past this slot.
+        if (oldSlotPtr->keyPtr != NULL)
+        {
+            oldSlotPtr->keyPtr = DELETED_KEY;
+        }
+    }
+    else
+    {
+        le_dls_List_t* oldListPtr = &(mapRef->oldBucketsPtr[oldIndex]);
+        le_dls_Link_t* linkPtr;
+
+        while ((linkPtr = le_dls_Pop(oldListPtr)) != NULL)
+        {
+            Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, entryListLink);
+            size_t index = CalculateIndex(mapRef->bucketCount, entryPtr->hash);
+
+            le_dls_Queue(&(mapRef->bucketsPtr[index]), linkPtr);
+            mapRef->chainLengthPtr[index]++;
+
+            if (isIterating && (iteratorPtr->currentEntryPtr == entryPtr))
+            {
+                iteratorPtr->currentListPtr = &(mapRef->bucketsPtr[index]);
+                iteratorPtr->currentIndex = index;
+            }
+        }
+
+        mapRef->oldChainLengthPtr[oldIndex] = 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves some old buckets (or slots) to the current table, if the map is being resized.
+ *
+ * Nothing is moved while an iteration is in progress, unless forced.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Rehash
+(
+    Hashmap_t* mapRef,
+    size_t numBuckets,      ///< [in] Number of old buckets to move.
+    bool force              ///< [in] true to move them even if an iteration is in progress.
+)
+{
+    if (!IsResizing(mapRef) || (!force && IsIterating(mapRef)))
+    {
+        return;
+    }
+
+    while ((numBuckets > 0) && (mapRef->rehashIndex < mapRef->oldBucketCount))
+    {
+        MoveOldBucket(mapRef, mapRef->rehashIndex);
+        mapRef->rehashIndex++;
+        numBuckets--;
+    }
+
+    if (mapRef->rehashIndex == mapRef->oldBucketCount)
+    {
+        FinishResize(mapRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes room for one more key in a map, starting a resize if the current table is getting full.
+ * If a resize is needed while a previous resize is still in progress, the previous one is
+ * completed first.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MakeRoom
+(
+    Hashmap_t* mapRef
+)
+{
+    size_t maxLoad = mapRef->bucketCount * MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR;
+
+    if (IsOpenAddressed(mapRef))
+    {
+        if (mapRef->numUsedSlots + 1 <= maxLoad)
+        {
+            return;
+        }
+
+        // While iterating, hold off until the table is 7/8 full.  There must always be at least
+        // one empty slot for probing to terminate.
+        if (   IsResizing(mapRef)
+            && IsIterating(mapRef)
+            && (mapRef->numUsedSlots + 1 <= mapRef->bucketCount - (mapRef->bucketCount / 8)) )
+        {
+            return;
+        }
+
+        Rehash(mapRef, SIZE_MAX, true);
+
+        // If many slots are just deleted ones, clean them out without growing.
+        size_t newBucketCount = mapRef->bucketCount;
+        if (mapRef->size + 1 > mapRef->bucketCount / 2)
+        {
+            newBucketCount *= 2;
+        }
+
+        StartResize(mapRef, newBucketCount);
+    }
+    else
+    {
+        if (mapRef->size + 1 <= maxLoad)
+        {
+            return;
+        }
+
+        if (IsResizing(mapRef))
+        {
+            if (   IsIterating(mapRef)
+                && (mapRef->size + 1 <= mapRef->bucketCount * MAX_CHAINED_LOAD_WHILE_ITERATING) )
+            {
+                return;
+            }
+
+            Rehash(mapRef, SIZE_MAX, true);
+        }
+
+        StartResize(mapRef, mapRef->bucketCount * 2);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the entry for a key in a chained map, searching the old table too if the map is being
+ * resized.
+ *
+ * @return  Pointer to the entry, or NULL if the key is not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* FindEntry
+(
+    Hashmap_t* mapRef,
+    const void* keyPtr,
+    size_t hash,
+    le_dls_List_t** listHeadPtrPtr,     ///< [out] The bucket the entry is in.
+    size_t** chainLengthPtrPtr,         ///< [out] The chain length counter of that bucket.
+    size_t* positionPtr                 ///< [out] Iterator position of that bucket.
+)
+{
+    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+
+    *chainLengthPtrPtr = &(mapRef->chainLengthPtr[index]);
+    *positionPtr = index;
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Generated index of %zu for hash %zu",
+        mapRef->nameStr,
+        index,
+        hash
+    );
+
+    int pass;
+    for (pass = 0; pass < 2; pass++)
+    {
+        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+
+        while (theLinkPtr != NULL) {
+            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+            if (EqualKeys(currentEntryPtr->keyPtr,
                           currentEntryPtr->hash,
                           keyPtr,
                           hash,
                           mapRef->equalsFuncPtr)
                           )
+            {
+                *listHeadPtrPtr = listHeadPtr;
+                return currentEntryPtr;
+            }
+            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+        }
+
+        // Entries in old buckets that haven't been moved yet can be found in the old table.
+        if (!IsResizing(mapRef))
+        {
+            break;
+        }
+        index = CalculateIndex(mapRef->oldBucketCount, hash);
+        if (index < mapRef->rehashIndex)
+        {
+            break;
+        }
+        listHeadPtr = &(mapRef->oldBucketsPtr[index]);
+        *chainLengthPtrPtr = &(mapRef->oldChainLengthPtr[index]);
+        *positionPtr = mapRef->bucketCount + index;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the slot holding a key in an open addressed map, searching the old table too if the map
+ * is being resized.
+ *
+ * @return  Pointer to the slot, or NULL if the key is not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static Slot_t* FindSlot
+(
+    Hashmap_t* mapRef,
+    const void* keyPtr,
+    size_t hash
+)
+{
+    Slot_t* slotsPtr = mapRef->slotsPtr;
+    size_t slotCount = mapRef->bucketCount;
+
+    int pass;
+    for (pass = 0; pass < 2; pass++)
+    {
+        size_t index = CalculateIndex(slotCount, hash);
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Generated index of %zu for hash %zu",
+            mapRef->nameStr,
+            index,
+            hash
+        );
+
+        // There is always at least one empty slot, so this terminates.
+        while (slotsPtr[index].keyPtr != NULL)
+        {
+            if (   (slotsPtr[index].keyPtr != DELETED_KEY)
+                && EqualKeys(slotsPtr[index].keyPtr,
+                             slotsPtr[index].hash,
+                             keyPtr,
+                             hash,
+                             mapRef->equalsFuncPtr) )
+            {
+                return &(slotsPtr[index]);
+            }
+
+            index = CalculateIndex(slotCount, index + 1);
+        }
+
+        if (!IsResizing(mapRef))
+        {
+            break;
+        }
+        slotsPtr = mapRef->oldSlotsPtr;
+        slotCount = mapRef->oldBucketCount;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Common part of the map constructors.
+ *
+ * @return  Returns a reference to the map.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t CreateMap
+(
+    const char*                nameStr,
+    size_t                     capacity,
+    le_hashmap_HashFunc_t      hashFunc,
+    le_hashmap_EqualsFunc_t    equalsFunc,
+    bool                       isOpenAddressed
+)
+{
+    LE_ASSERT(hashFunc);
+    LE_ASSERT(equalsFunc);
+
+    // It is ok to use malloc here as we will not be destroying the map
+    le_hashmap_Ref_t mapRef = calloc(1, sizeof(Hashmap_t));
+    LE_ASSERT(mapRef);
+
+    mapRef->traceRef = NULL;
+
+    AllocTable(mapRef, CalculateBucketCount(capacity), isOpenAddressed);
+
+    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
+    LE_ASSERT(mapRef->iteratorPtr);
+
+    mapRef->size = 0;
+
+    mapRef->hashFuncPtr = hashFunc;
+    mapRef->equalsFuncPtr = equalsFunc;
+    mapRef->nameStr = nameStr;
+
+    memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
+    mapRef->iteratorPtr->theMapPtr = mapRef;
+    mapRef->iteratorPtr->isValueValid = true;
+
+    return mapRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a HashMap
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_Create
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Expected capacity of the map
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
+)
+{
+    le_hashmap_Ref_t mapRef = CreateMap(nameStr, capacity, hashFunc, equalsFunc, false);
+
+    /**
+     * The memory pool is required to store entries. We set a default size and expansion
+     * size to reduce the number of forced allocations.
+     * Initial entries for each hash are actually doubly linked list objects which store
+     * where the starting entry is in the pool.
+     */
+    char poolName[LIMIT_MAX_MEM_POOL_NAME_BYTES] = "hashMap_";
+    le_utf8_Append(poolName, nameStr, sizeof(poolName), NULL);
+    mapRef->entryPoolRef = le_mem_ExpandPool(le_mem_CreatePool(poolName,
+                                                               sizeof(Entry_t)),
+                                                               mapRef->bucketCount / 2);
+    le_mem_SetNumObjsToForce(mapRef->entryPoolRef, mapRef->bucketCount / 8);
+
+    return mapRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an open addressed HashMap
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateOpenAddressed
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Expected capacity of the map
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
+)
+{
+    return CreateMap(nameStr, capacity, hashFunc, equalsFunc, true);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a key-value pair to a HashMap. If the key already exists in the map then the previous value
+ * will be replaced with the new value passed into this function.
+ *
+ * The process will terminate if this fails as it implies an inability to allocate any more memory
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+
+void* le_hashmap_Put
+(
+    le_hashmap_Ref_t mapRef,   ///< [in] Reference to the map
+    const void* keyPtr,        ///< [in] Pointer to the key to be stored
+    const void* valuePtr       ///< [in] Pointer to the value to be stored
+)
+{
+    LE_ASSERT(keyPtr != NULL);
+
+    Rehash(mapRef, REHASH_STEP, false);
+
+    size_t hash = HashKey(mapRef, keyPtr);
+
+    if (IsOpenAddressed(mapRef))
+    {
+        Slot_t* slotPtr = FindSlot(mapRef, keyPtr, hash);
+
+        if (slotPtr != NULL)
         {
+            const void* oldValue = slotPtr->valuePtr;
+            slotPtr->valuePtr = valuePtr;
+
             HASHMAP_TRACE(
                 mapRef,
-                "Hashmap %s: Returning found value for key",
-                mapRef->nameStr
+                "Hashmap %s: Replaced entry in slot. Total map size now %zu",
+                mapRef->nameStr,
+                mapRef->size
             );
-            return (void*)(currentEntryPtr->valuePtr);
+
+            return (void *)oldValue;
         }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+
+        MakeRoom(mapRef);
+
+        slotPtr = FindFreeSlot(mapRef, hash);
+        if (slotPtr->keyPtr == NULL)
+        {
+            mapRef->numUsedSlots++;
+        }
+        slotPtr->hash = hash;
+        slotPtr->keyPtr = keyPtr;
+        slotPtr->valuePtr = valuePtr;
+        mapRef->size++;
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Added entry to slot %zu. Map size now %zu",
+            mapRef->nameStr,
+            (size_t)(slotPtr - mapRef->slotsPtr),
+            mapRef->size
+        );
+
+        return NULL;
     }
 
+    le_dls_List_t* listHeadPtr;
+    size_t* chainLengthPtr;
+    size_t position;
+    Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, hash,
+                                         &listHeadPtr, &chainLengthPtr, &position);
+
+    // Replace existing value if the keys match.
+    if (currentEntryPtr != NULL)
+    {
+        const void* oldValue = currentEntryPtr->valuePtr;
+        currentEntryPtr->valuePtr = valuePtr;
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Replaced entry in bucket. Total map size now %zu",
+            mapRef->nameStr,
+            mapRef->size
+        );
+
+        return (void *)oldValue;
+    }
+
+    MakeRoom(mapRef);
+
+    // New entries always go into the current table.
+    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    listHeadPtr = &(mapRef->bucketsPtr[index]);
+
+    Entry_t* newEntryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
+
+    le_dls_Queue(listHeadPtr, &(newEntryPtr->entryListLink));
+    mapRef->size++;
+    mapRef->chainLengthPtr[index]++;
+
     HASHMAP_TRACE(
         mapRef,
-        "Hashmap %s: Key not found",
-        mapRef->nameStr
+        "Hashmap %s: Added entry to bucket %zu at tail. Map size now %zu",
+        mapRef->nameStr,
+        index,
+        mapRef->size
     );
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Bucket now contains %zu entries",
+        mapRef->nameStr,
+        mapRef->chainLengthPtr[index]
+    );
+
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Retrieve a value from a HashMap.
+ *
+ * @return  Returns a pointer to the value or NULL if the key is not found.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+
+void* le_hashmap_Get
+(
+    le_hashmap_Ref_t mapRef,   ///< [in] Reference to the map
+    const void* keyPtr         ///< [in] Pointer to the key to be retrieved
+)
+{
+    size_t hash = HashKey(mapRef, keyPtr);
+    const void* valuePtr = NULL;
+    bool found = false;
+
+    if (IsOpenAddressed(mapRef))
+    {
+        Slot_t* slotPtr = FindSlot(mapRef, keyPtr, hash);
+
+        if (slotPtr != NULL)
+        {
+            valuePtr = slotPtr->valuePtr;
+            found = true;
+        }
+    }
+    else
+    {
+        le_dls_List_t* listHeadPtr;
+        size_t* chainLengthPtr;
+        size_t position;
+        Entry_t* entryPtr = FindEntry(mapRef, keyPtr, hash,
+                                      &listHeadPtr, &chainLengthPtr, &position);
+
+        if (entryPtr != NULL)
+        {
+            valuePtr = entryPtr->valuePtr;
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Returning found value for key",
+            mapRef->nameStr
+        );
+    }
+    else
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key not found",
+            mapRef->nameStr
+        );
+    }
+
+    return (void*)valuePtr;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieve a stored key from a HashMap.
@@ -409,50 +1105,49 @@ void* le_hashmap_GetStoredKey
 )
 {
     size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    const void* storedKeyPtr = NULL;
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
-        mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
-    );
+    if (IsOpenAddressed(mapRef))
+    {
+        Slot_t* slotPtr = FindSlot(mapRef, keyPtr, hash);
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+        if (slotPtr != NULL)
+        {
+            storedKeyPtr = slotPtr->keyPtr;
+        }
+    }
+    else
+    {
+        le_dls_List_t* listHeadPtr;
+        size_t* chainLengthPtr;
+        size_t position;
+        Entry_t* entryPtr = FindEntry(mapRef, keyPtr, hash,
+                                      &listHeadPtr, &chainLengthPtr, &position);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
+        if (entryPtr != NULL)
         {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Returning original key",
-                mapRef->nameStr
-            );
-            return (void*)(currentEntryPtr->keyPtr);
+            storedKeyPtr = entryPtr->keyPtr;
         }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
     }
 
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Key not found",
-        mapRef->nameStr
-    );
-    return NULL;
+    if (storedKeyPtr != NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Returning original key",
+            mapRef->nameStr
+        );
+    }
+    else
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key not found",
+            mapRef->nameStr
+        );
+    }
+
+    return (void*)storedKeyPtr;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -473,58 +1168,76 @@ void* le_hashmap_Remove
    const void* keyPtr       ///< [in] Pointer to the key to be removed
 )
 {
-    int hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    Rehash(mapRef, REHASH_STEP, false);
 
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    size_t hash = HashKey(mapRef, keyPtr);
+    void* value = NULL;
+    bool found = false;
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    if (IsOpenAddressed(mapRef))
+    {
+        Slot_t* slotPtr = FindSlot(mapRef, keyPtr, hash);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
+        if (slotPtr != NULL)
         {
-            if (mapRef->iteratorPtr->currentLinkPtr == theLinkPtr)
+            if (IsIterating(mapRef) && (mapRef->iteratorPtr->currentSlotPtr == slotPtr))
             {
                 le_hashmap_PrevNode(mapRef->iteratorPtr);
                 mapRef->iteratorPtr->isValueValid = false;
             }
 
-            void* value = (void*)(currentEntryPtr->valuePtr);
-            le_dls_Remove(listHeadPtr, theLinkPtr);
-            le_mem_Release( currentEntryPtr );
+            // The slot stays "used" so that lookups keep probing past it.
+            value = (void*)(slotPtr->valuePtr);
+            slotPtr->keyPtr = DELETED_KEY;
+            slotPtr->valuePtr = NULL;
             mapRef->size--;
-            mapRef->chainLengthPtr[index]--;
+            found = true;
+        }
+    }
+    else
+    {
+        le_dls_List_t* listHeadPtr;
+        size_t* chainLengthPtr;
+        size_t position;
+        Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, hash,
+                                             &listHeadPtr, &chainLengthPtr, &position);
 
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Removing key from map",
-                mapRef->nameStr
-            );
+        if (currentEntryPtr != NULL)
+        {
+            if (   IsIterating(mapRef)
+                && (mapRef->iteratorPtr->currentLinkPtr == &(currentEntryPtr->entryListLink)) )
+            {
+                le_hashmap_PrevNode(mapRef->iteratorPtr);
+                mapRef->iteratorPtr->isValueValid = false;
+            }
 
-            return value;
+            value = (void*)(currentEntryPtr->valuePtr);
+            le_dls_Remove(listHeadPtr, &(currentEntryPtr->entryListLink));
+            le_mem_Release( currentEntryPtr );
+            mapRef->size--;
+            (*chainLengthPtr)--;
+            found = true;
         }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
     }
 
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Key not found",
-        mapRef->nameStr
-    );
-    return NULL;
+    if (found)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Removing key from map",
+            mapRef->nameStr
+        );
+    }
+    else
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key not found",
+            mapRef->nameStr
+        );
+    }
+
+    return value;
 }
 
 
@@ -577,47 +1290,16 @@ bool le_hashmap_ContainsKey
     const void* keyPtr        ///< [in] Pointer to the key to be searched for
 )
 {
-    int hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    bool found = (le_hashmap_GetStoredKey(mapRef, keyPtr) != NULL);
 
     HASHMAP_TRACE(
         mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
+        "Hashmap %s: Key %s",
         mapRef->nameStr,
-        index,
-        hash
-    );
-
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
-
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-        {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Key found",
-                mapRef->nameStr
-            );
-
-            return true;
-        }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-    }
-
-    HASHMAP_TRACE(
-       mapRef,
-       "Hashmap %s: Key not found",
-       mapRef->nameStr
+        found ? "found" : "not found"
     );
 
-    return false;
+    return found;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -640,21 +1322,38 @@ void le_hashmap_RemoveAll
     mapRef->iteratorPtr->currentListPtr = NULL;
     mapRef->iteratorPtr->currentLinkPtr = NULL;
     mapRef->iteratorPtr->currentEntryPtr = NULL;
+    mapRef->iteratorPtr->currentSlotPtr = NULL;
 
-    uint32_t i;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    if (IsOpenAddressed(mapRef))
+    {
+        if (IsResizing(mapRef))
+        {
+            FinishResize(mapRef);
+        }
 
-        while (theLinkPtr != NULL) {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-            le_dls_Link_t* linkPtrToRemove = theLinkPtr;
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-            le_dls_Remove(listHeadPtr, linkPtrToRemove);
-            le_mem_Release( currentEntryPtr );
+        memset(mapRef->slotsPtr, 0, mapRef->bucketCount * sizeof(Slot_t));
+        mapRef->numUsedSlots = 0;
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < IteratorRange(mapRef); i++) {
+            le_dls_List_t* listHeadPtr = GetBucketAt(mapRef, i);
+            le_dls_Link_t* theLinkPtr;
+
+            while ((theLinkPtr = le_dls_Pop(listHeadPtr)) != NULL) {
+                le_mem_Release(CONTAINER_OF(theLinkPtr, Entry_t, entryListLink));
+            }
+        }
+
+        if (IsResizing(mapRef))
+        {
+            FinishResize(mapRef);
+        }
+
+        for (i = 0; i < mapRef->bucketCount; i++) {
+            mapRef->chainLengthPtr[i] = 0;
         }
-        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
-        mapRef->chainLengthPtr[i] = 0;
     }
     mapRef->size=0;
 
@@ -682,9 +1381,20 @@ void le_hashmap_ForEach
     void* context                            ///< [in] Pointer to a context to be supplied to the callback
 )
 {
-    uint32_t i;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
+    size_t i;
+    for (i = 0; i < IteratorRange(mapRef); i++) {
+        if (IsOpenAddressed(mapRef))
+        {
+            Slot_t* slotPtr = GetSlotAt(mapRef, i);
+
+            if (IsSlotInUse(slotPtr) && !forEachFn(slotPtr->keyPtr, slotPtr->valuePtr, context))
+            {
+                return;
+            }
+            continue;
+        }
+
+        le_dls_List_t* listHeadPtr = GetBucketAt(mapRef, i);
         le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
         while (theLinkPtr != NULL) {
@@ -723,6 +1433,49 @@ le_hashmap_It_Ref_t le_hashmap_GetIterator
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves the iterator of an open addressed map to the next (or previous) slot in use.
+ *
+ * @return  Returns LE_OK, or LE_NOT_FOUND if there are no more entries in that direction.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MoveToSlotInUse
+(
+    le_hashmap_It_Ref_t iteratorRef,
+    int32_t step            ///< [in] 1 to move forwards, -1 to move backwards.
+)
+{
+    Hashmap_t* mapRef = iteratorRef->theMapPtr;
+
+    for (
+           iteratorRef->currentIndex = iteratorRef->currentIndex + step;
+           (iteratorRef->currentIndex >= 0) &&
+               ((size_t)iteratorRef->currentIndex < IteratorRange(mapRef));
+           iteratorRef->currentIndex += step )
+    {
+        Slot_t* slotPtr = GetSlotAt(mapRef, iteratorRef->currentIndex);
+
+        if (IsSlotInUse(slotPtr))
+        {
+            iteratorRef->currentSlotPtr = slotPtr;
+
+            HASHMAP_TRACE(
+                mapRef,
+                "Found slot in use, index is %d",
+                iteratorRef->currentIndex
+            );
+            return LE_OK;
+        }
+    }
+
+    // Went off the end of the map, need to invalidate the iterator
+    iteratorRef->currentSlotPtr = NULL;
+    iteratorRef->isValueValid = false;
+    return LE_NOT_FOUND;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Moves the iterator to the next key/value pair in the map. Order is dependent
@@ -737,15 +1490,30 @@ le_result_t le_hashmap_NextNode
     le_hashmap_It_Ref_t iteratorRef        ///< [IN] Reference to the iterator
 )
 {
+    Hashmap_t* mapRef = iteratorRef->theMapPtr;
+
     iteratorRef->isValueValid = true;
 
     // If the map is empty immediately return LE_NOT_FOUND
-    if (le_hashmap_isEmpty(iteratorRef->theMapPtr))
+    if (le_hashmap_isEmpty(mapRef))
+    {
+        iteratorRef->isValueValid = false;
+        return LE_NOT_FOUND;
+    }
+
+    // Already past the end of the map.
+    if (   (iteratorRef->currentIndex >= 0)
+        && ((size_t)iteratorRef->currentIndex >= IteratorRange(mapRef)) )
     {
         iteratorRef->isValueValid = false;
         return LE_NOT_FOUND;
     }
 
+    if (IsOpenAddressed(mapRef))
+    {
+        return MoveToSlotInUse(iteratorRef, 1);
+    }
+
     le_dls_Link_t* theLinkPtr = NULL;
 
     // -1 indicates the iterator is new
@@ -759,10 +1527,10 @@ le_result_t le_hashmap_NextNode
         // Find the next list head
         for (
                iteratorRef->currentIndex = iteratorRef->currentIndex + 1;
-               iteratorRef->currentIndex < iteratorRef->theMapPtr->bucketCount;
+               (size_t)iteratorRef->currentIndex < IteratorRange(mapRef);
                iteratorRef->currentIndex++ )
         {
-            le_dls_List_t* listHeadPtr = &(iteratorRef->theMapPtr->bucketsPtr[iteratorRef->currentIndex]);
+            le_dls_List_t* listHeadPtr = GetBucketAt(mapRef, iteratorRef->currentIndex);
             theLinkPtr = le_dls_Peek(listHeadPtr);
 
             if (NULL != theLinkPtr)
@@ -773,7 +1541,7 @@ le_result_t le_hashmap_NextNode
                 iteratorRef->currentListPtr = listHeadPtr;
 
                 HASHMAP_TRACE(
-                    iteratorRef->theMapPtr,
+                    mapRef,
                     "Found index head match, index is %d",
                     iteratorRef->currentIndex
                 );
@@ -789,7 +1557,7 @@ le_result_t le_hashmap_NextNode
         // No change to the current list head pointer as we're in the same list
 
         HASHMAP_TRACE(
-            iteratorRef->theMapPtr,
+            mapRef,
             "Found index list match, index is %d",
             iteratorRef->currentIndex
         );
@@ -817,12 +1585,14 @@ le_result_t le_hashmap_PrevNode
     le_hashmap_It_Ref_t iteratorRef        ///< [IN] Reference to the iterator
 )
 {
+    Hashmap_t* mapRef = iteratorRef->theMapPtr;
+
     iteratorRef->isValueValid = true;
 
     // If the map is empty or if we're already at the beginning of the table, immediately return
     // LE_NOT_FOUND.
     if (
-         (le_hashmap_isEmpty(iteratorRef->theMapPtr)) ||
+         (le_hashmap_isEmpty(mapRef)) ||
          (iteratorRef->currentIndex == -1)
        )
     {
@@ -830,8 +1600,24 @@ le_result_t le_hashmap_PrevNode
         return LE_NOT_FOUND;
     }
 
-    le_dls_Link_t* theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr,
-                                                iteratorRef->currentLinkPtr);
+    // Coming back from past the end of the map.
+    if ((size_t)iteratorRef->currentIndex >= IteratorRange(mapRef))
+    {
+        iteratorRef->currentIndex = IteratorRange(mapRef);
+        iteratorRef->currentLinkPtr = NULL;
+    }
+
+    if (IsOpenAddressed(mapRef))
+    {
+        return MoveToSlotInUse(iteratorRef, -1);
+    }
+
+    le_dls_Link_t* theLinkPtr = NULL;
+
+    if (iteratorRef->currentLinkPtr != NULL)
+    {
+        theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr, iteratorRef->currentLinkPtr);
+    }
 
     if (NULL == theLinkPtr)
     {
@@ -841,7 +1627,7 @@ le_result_t le_hashmap_PrevNode
                iteratorRef->currentIndex >= 0;
                iteratorRef->currentIndex-- )
         {
-            le_dls_List_t* listHeadPtr = &(iteratorRef->theMapPtr->bucketsPtr[iteratorRef->currentIndex]);
+            le_dls_List_t* listHeadPtr = GetBucketAt(mapRef, iteratorRef->currentIndex);
             theLinkPtr = le_dls_PeekTail(listHeadPtr);
 
             if (NULL != theLinkPtr)
@@ -852,7 +1638,7 @@ le_result_t le_hashmap_PrevNode
                 iteratorRef->currentListPtr = listHeadPtr;
 
                 HASHMAP_TRACE(
-                    iteratorRef->theMapPtr,
+                    mapRef,
                     "Found index head match, index is %d",
                     iteratorRef->currentIndex
                 );
@@ -868,7 +1654,7 @@ le_result_t le_hashmap_PrevNode
         // No change to the current list head pointer as we're in the same list
 
         HASHMAP_TRACE(
-            iteratorRef->theMapPtr,
+            mapRef,
             "Found index list match, index is %d",
             iteratorRef->currentIndex
         );
@@ -897,6 +1683,11 @@ void const * le_hashmap_GetKey
 {
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
+    if (IsOpenAddressed(iteratorRef->theMapPtr))
+    {
+        return iteratorRef->currentSlotPtr->keyPtr;
+    }
+
     return iteratorRef->currentEntryPtr->keyPtr;
 }
 
@@ -915,9 +1706,69 @@ void const * le_hashmap_GetValue
 {
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
+    if (IsOpenAddressed(iteratorRef->theMapPtr))
+    {
+        return iteratorRef->currentSlotPtr->valuePtr;
+    }
+
     return iteratorRef->currentEntryPtr->valuePtr;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the first entry at or after a given iterator position.
+ *
+ * @return  LE_OK if an entry was found, LE_NOT_FOUND otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetFirstNodeFrom
+(
+    le_hashmap_Ref_t mapRef,
+    size_t position,
+    void **keyPtrPtr,
+    void **valuePtrPtr
+)
+{
+    for (; position < IteratorRange(mapRef); position++)
+    {
+        const void* keyPtr;
+        const void* valuePtr;
+
+        if (IsOpenAddressed(mapRef))
+        {
+            Slot_t* slotPtr = GetSlotAt(mapRef, position);
+
+            if (!IsSlotInUse(slotPtr))
+            {
+                continue;
+            }
+            keyPtr = slotPtr->keyPtr;
+            valuePtr = slotPtr->valuePtr;
+        }
+        else
+        {
+            le_dls_Link_t* theLinkPtr = le_dls_Peek(GetBucketAt(mapRef, position));
+
+            if (NULL == theLinkPtr)
+            {
+                continue;
+            }
+            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+            keyPtr = currentEntryPtr->keyPtr;
+            valuePtr = currentEntryPtr->valuePtr;
+        }
+
+        *keyPtrPtr = (void *)keyPtr;
+        if (NULL != valuePtrPtr)
+        {
+            *valuePtrPtr = (void *)valuePtr;
+        }
+        return LE_OK;
+    }
+
+    return LE_NOT_FOUND;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieves the key and value of the first node stored in the hashmap.
@@ -952,24 +1803,7 @@ le_result_t le_hashmap_GetFirstNode
     }
 
     // Find the first list head
-    size_t index = 0;
-    for (
-           ;
-           index < mapRef->bucketCount;
-           index++ )
-    {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
-
-        if (NULL != theLinkPtr)
-        {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-            *firstKeyPtr = (void *)currentEntryPtr->keyPtr;
-            *firstValuePtr = (void *)currentEntryPtr->valuePtr;
-            break;
-        }
-    }
-    return LE_OK;
+    return GetFirstNodeFrom(mapRef, 0, firstKeyPtr, firstValuePtr);
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -1006,82 +1840,56 @@ le_result_t le_hashmap_GetNodeAfter
 
     // Find the node pointed to by the key
     size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    size_t position;
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
-        mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
-    );
+    if (IsOpenAddressed(mapRef))
+    {
+        Slot_t* slotPtr = FindSlot(mapRef, keyPtr, hash);
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+        if (slotPtr == NULL)
+        {
+            // The original key was never found
+            return LE_BAD_PARAMETER;
+        }
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
+        position = GetSlotPosition(mapRef, slotPtr);
+    }
+    else
+    {
+        le_dls_List_t* listHeadPtr;
+        size_t* chainLengthPtr;
+        Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, hash,
+                                             &listHeadPtr, &chainLengthPtr, &position);
+
+        if (currentEntryPtr == NULL)
         {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Found value for key",
-                mapRef->nameStr
-            );
-            // Now find the next node, if there is one
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-            if (NULL == theLinkPtr)
-            {
-                // Find the next list head
-                for (
-                       index++;
-                       index < mapRef->bucketCount;
-                       index++ )
-                {
-                    listHeadPtr = &(mapRef->bucketsPtr[index]);
-                    theLinkPtr = le_dls_Peek(listHeadPtr);
-
-                    if (NULL != theLinkPtr)
-                    {
-                        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-                        *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
-                        if (NULL != nextValuePtr)
-                        {
-                            *nextValuePtr = (void *)currentEntryPtr->valuePtr;
-                        }
-                        return LE_OK;
-                    }
-                }
-                // There was no list head - we are off the end of the map
-                return LE_NOT_FOUND;
-            }
-            else
+            // The original key was never found
+            return LE_BAD_PARAMETER;
+        }
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Found value for key",
+            mapRef->nameStr
+        );
+
+        // Now find the next node in the same list, if there is one
+        le_dls_Link_t* theLinkPtr = le_dls_PeekNext(listHeadPtr,
+                                                    &(currentEntryPtr->entryListLink));
+        if (NULL != theLinkPtr)
+        {
+            currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+            *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
+            if (NULL != nextValuePtr)
             {
-                Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-                *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
-                if (NULL != nextValuePtr)
-                {
-                    *nextValuePtr = (void *)currentEntryPtr->valuePtr;
-                }
-                return LE_OK;
+                *nextValuePtr = (void *)currentEntryPtr->valuePtr;
             }
+            return LE_OK;
         }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
     }
 
-    // The original key was never found
-    return LE_BAD_PARAMETER;
+    // Find the next list head (or slot in use).  If there isn't one, we are off the end of the map.
+    return GetFirstNodeFrom(mapRef, position + 1, nextKeyPtr, nextValuePtr);
 }
 
 
@@ -1090,6 +1898,9 @@ le_result_t le_hashmap_GetNodeAfter
  * Counts the total number of collisions in the map. A collision occurs
  * when more than one entry is stored in the map at the same index.
  *
+ * For open addressed maps, this is the number of entries that are not stored in the slot their
+ * hash points to.
+ *
  * @return  Returns The sum of the collisions in the map
  *
  */
@@ -1101,11 +1912,32 @@ size_t le_hashmap_CountCollisions
 )
 {
     size_t i, collCount = 0;
+
+    if (IsOpenAddressed(mapRef))
+    {
+        for (i = 0; i < IteratorRange(mapRef); i++) {
+            Slot_t* slotPtr = GetSlotAt(mapRef, i);
+            size_t slotCount = (i < mapRef->bucketCount) ? mapRef->bucketCount
+                                                         : mapRef->oldBucketCount;
+            size_t index = (i < mapRef->bucketCount) ? i : i - mapRef->bucketCount;
+
+            if (IsSlotInUse(slotPtr) && (CalculateIndex(slotCount, slotPtr->hash) != index)) {
+                collCount++;
+            }
+        }
+        return collCount;
+    }
+
     for (i = 0; i < mapRef->bucketCount; i++) {
         if (mapRef->chainLengthPtr[i] > 1) {
             collCount += mapRef->chainLengthPtr[i] - 1;
         }
     }
+    for (i = 0; i < mapRef->oldBucketCount; i++) {
+        if (mapRef->oldChainLengthPtr[i] > 1) {
+            collCount += mapRef->oldChainLengthPtr[i] - 1;
+        }
+    }
     return collCount;
 }
 
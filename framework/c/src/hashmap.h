@@ -20,8 +20,22 @@ struct Entry {
     le_dls_Link_t entryListLink;
 };
 
+/**
+ * A slot in the table of an open addressed map.  The hash is stored next to the key so that
+ * probing rarely has to call the equality function.
+ */
+typedef struct Slot Slot_t;
+struct Slot {
+    size_t hash;
+    const void* keyPtr;         ///< NULL if the slot is empty.
+    const void* valuePtr;
+};
+
 /**
  * A hashmap iterator
+ *
+ * The iterator walks the buckets (or slots) of the current table first, then the buckets (or
+ * slots) of the old table if the map is being resized.
  */
 typedef struct le_hashmap_It {
     le_hashmap_Ref_t theMapPtr;
@@ -29,21 +43,36 @@ typedef struct le_hashmap_It {
     le_dls_List_t* currentListPtr;
     le_dls_Link_t* currentLinkPtr;
     Entry_t* currentEntryPtr;
+    Slot_t* currentSlotPtr;
     bool isValueValid;
 }
 HashmapIt_t;
 
 /**
  *  The hashmap itself
+ *
+ *  When a map grows, its bucket (or slot) array becomes the "old" table, a new table twice the
+ *  size is allocated, and entries are moved from the old table to the new one a few buckets at a
+ *  time (starting from bucket 0) by subsequent puts and removes.  Until that is finished, lookups
+ *  search both tables.
  */
 typedef struct le_hashmap {
-    size_t bucketCount;
+    size_t bucketCount;                 ///< Number of buckets (or slots) in the current table.
     le_hashmap_HashFunc_t hashFuncPtr;
     le_hashmap_EqualsFunc_t equalsFuncPtr;
     size_t size;
-    le_mem_PoolRef_t entryPoolRef;
-    le_dls_List_t* bucketsPtr;
+    le_mem_PoolRef_t entryPoolRef;      ///< Pool of Entry_t (NULL if open addressed).
+    le_dls_List_t* bucketsPtr;          ///< Buckets of the current table (NULL if open addressed).
     size_t* chainLengthPtr;
+    Slot_t* slotsPtr;                   ///< Slots of the current table (NULL if chained).
+    size_t numUsedSlots;                ///< Number of non-empty slots (including deleted ones)
+                                        ///  in the current table of an open addressed map.
+    size_t oldBucketCount;              ///< Number of buckets (or slots) in the old table.
+                                        ///  0 if the map is not being resized.
+    le_dls_List_t* oldBucketsPtr;
+    size_t* oldChainLengthPtr;
+    Slot_t* oldSlotsPtr;
+    size_t rehashIndex;                 ///< Index of the next old bucket (or slot) to be moved.
     const char* nameStr;
     HashmapIt_t* iteratorPtr;
     le_log_TraceRef_t traceRef;
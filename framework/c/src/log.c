@@ -9,8 +9,10 @@
 
 #include "legato.h"
 #include "log.h"
+#include "logRing.h"
 #include "logDaemon/logDaemon.h"
 #include "limit.h"
+#include "messagingBulk.h"
 #include "messagingSession.h"
 
 //--------------------------------------------------------------------------------------------------
@@ -443,6 +445,43 @@ static void ReadLevelFromEnv
 }
 
 
+static void LogRingMsg(const logRing_Msg_t* msgPtr, void* contextPtr);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Turns on binary logging if the environment asks for it.  The value of LE_LOG_BINARY is the size
+ * of each thread's ring buffer, in bytes.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ReadBinaryModeFromEnv
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* envStrPtr = getenv("LE_LOG_BINARY");
+
+    if (envStrPtr != NULL)
+    {
+        char* endPtr;
+        unsigned long ringSize;
+
+        errno = 0;
+        ringSize = strtoul(envStrPtr, &endPtr, 0);
+
+        if ((errno == 0) && (endPtr != envStrPtr) && (*endPtr == '\0') && (ringSize > 0))
+        {
+            logRing_Enable(ringSize, LogRingMsg);
+        }
+        else
+        {
+            LE_ERROR("LE_LOG_BINARY environment variable has invalid value '%s'.", envStrPtr);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Loads the default list of enabled trace keywords from the environment, if present.
@@ -769,6 +808,9 @@ void log_Init
     // Get a reference to the trace keyword that is used to control tracing in this module.
     TraceRef = le_log_GetTraceRef("logControl");
 
+    // Turn on binary logging, if required.
+    ReadBinaryModeFromEnv();
+
     // Set the syslog format.
     openlog("Legato", 0, LOG_USER);
 }
@@ -1017,6 +1059,79 @@ static int ConvertToSyslogLevel
 #endif
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a formatted log message out to the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteMsg
+(
+    le_log_Level_t level,           ///< [IN] Severity level, or -1 for a trace message.
+    const char* levelPtr,           ///< [IN] Severity level string or trace keyword.
+    const char* procNamePtr,        ///< [IN] Process name.
+    pid_t pid,                      ///< [IN] PID of the process.
+    const char* compNamePtr,        ///< [IN] Component name.
+    const char* threadNamePtr,      ///< [IN] Thread name.
+    const char* baseFileNamePtr,    ///< [IN] Base name of the source file.
+    const char* functionNamePtr,    ///< [IN] Function name.
+    unsigned int lineNumber,        ///< [IN] Line number in the source file.
+    time_t timestamp,               ///< [IN] When the message was logged.
+    const char* msgPtr              ///< [IN] The user message.
+)
+{
+    // If running on an embedded target, write the message out to the log.
+#ifdef LEGATO_EMBEDDED
+
+    syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+           levelPtr, procNamePtr, pid, compNamePtr, threadNamePtr, baseFileNamePtr,
+           functionNamePtr, lineNumber, msgPtr);
+
+    // If running on a PC, write the message to standard error with a timestamp added.
+#else
+
+    char timeStamp[26] = "";
+    char* timeStampPtr = timeStamp;
+
+    if ( (timestamp != ((time_t)-1)) && (ctime_r(&timestamp, timeStamp) != NULL) )
+    {
+        // Tue Jan 14 18:01:56 2014
+        // 0123456789012345678901234
+        timeStampPtr = timeStamp + 4; // Skip day of week.
+        timeStamp[19] = '\0';  // Exclude the year.
+    }
+
+    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+            timeStampPtr, levelPtr, procNamePtr, pid, compNamePtr, threadNamePtr,
+            baseFileNamePtr, functionNamePtr, lineNumber, msgPtr);
+
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Logs a message that was left in a thread's binary log ring buffer when the thread exited.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogRingMsg
+(
+    const logRing_Msg_t* msgPtr,    ///< [IN] The message.
+    void* contextPtr                ///< [IN] Not used.
+)
+{
+    const char* levelPtr = msgPtr->keywordPtr;
+
+    if ( (msgPtr->level <= LOG_DEBUG) && (msgPtr->level >= LOG_EMERG) )
+    {
+        levelPtr = SeverityStr[msgPtr->level];
+    }
+
+    WriteMsg(msgPtr->level, levelPtr, msgPtr->procNamePtr, msgPtr->pid, msgPtr->compNamePtr,
+             msgPtr->threadNamePtr, msgPtr->fileNamePtr, msgPtr->functionNamePtr,
+             msgPtr->lineNumber, msgPtr->timestamp.tv_sec, msgPtr->msgPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Builds the log message and sends it to the logging system.
@@ -1052,6 +1167,38 @@ void _le_log_Send
         }
     }
 
+    // In binary mode, debug, info and trace messages are written raw to the thread's ring buffer
+    // and formatted later.  More severe messages are always formatted straight away.
+    if (logRing_IsEnabled() && ((level <= LE_LOG_INFO) || (level == (le_log_Level_t)-1)))
+    {
+        const char* keywordPtr = NULL;
+
+        if (level == (le_log_Level_t)-1)
+        {
+            keywordPtr = CONTAINER_OF(traceRef, KeywordObj_t, isEnabled)->keyword;
+        }
+
+        va_list ringParams;
+        va_start(ringParams, formatPtr);
+
+        le_result_t result = logRing_Write(level,
+                                           keywordPtr,
+                                           logSession->componentNamePtr,
+                                           filenamePtr,
+                                           functionNamePtr,
+                                           lineNumber,
+                                           savedErrno,
+                                           formatPtr,
+                                           ringParams);
+        va_end(ringParams);
+
+        // If the thread has no ring, fall back to formatting the message now.
+        if (result != LE_FAULT)
+        {
+            return;
+        }
+    }
+
     // Get either the log level or the trace keyword.
     const char* levelPtr;
 
@@ -1102,33 +1249,8 @@ void _le_log_Send
 
     va_end(varParams);
 
-    // If running on an embedded target, write the message out to the log.
-#ifdef LEGATO_EMBEDDED
-
-    syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-           levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
-           functionNamePtr, lineNumber, msg);
-
-    // If running on a PC, write the message to standard error with a timestamp added.
-#else
-
-    time_t now;
-    char timeStamp[26] = "";
-    char* timeStampPtr = timeStamp;
-
-    if ( (time(&now) != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
-    {
-        // Tue Jan 14 18:01:56 2014
-        // 0123456789012345678901234
-        timeStampPtr = timeStamp + 4; // Skip day of week.
-        timeStamp[19] = '\0';  // Exclude the year.
-    }
-
-    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-            timeStampPtr, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
-            baseFileNamePtr, functionNamePtr, lineNumber, msg);
-
-#endif
+    WriteMsg(level, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
+             functionNamePtr, lineNumber, time(NULL), msg);
 }
 
 
@@ -0,0 +1,1456 @@
+/** @file logRing.c
+ *
+ * Log module's "Binary Ring" implementation.  See logRing.h for an overview.
+ *
+ * Each ring is a shared memory file, laid out like this:
+ *
+ * @verbatim
+ *
+ *   +--------+--------+--------+-----+--------+---------+
+ *   | Header | Record | Record | ... | Record | (free)  |
+ *   +--------+--------+--------+-----+--------+---------+
+ *
+ * @endverbatim
+ *
+ * The header holds the head (written only by the thread that owns the ring) and the tail (written
+ * only by the reader).  Both only ever increase; the offset of a record in the data area is its
+ * position modulo the data area size.  Records never wrap around the end of the data area.  If a
+ * record doesn't fit before the end, a padding record fills the rest and the record goes at the
+ * start.
+ *
+ * A record is a Record_t followed by the message's arguments.  Integer, floating point and pointer
+ * arguments each take an 8-byte slot.  String arguments are copied into the record (a 4-byte length
+ * followed by the string, padded to a multiple of 8 bytes).  Both the writer and the reader walk
+ * the format string to work out what the arguments are, so only a subset of printf conversions is
+ * supported (no positional arguments or wide strings).  Formatting stops at the first conversion
+ * that isn't supported.
+ *
+ * The reader copies each record out of the ring and checks it before using it, because the ring
+ * belongs to another process.  Strings referred to by pointers in the record are read from
+ * /proc/<pid>/mem, and the format string is only ever passed to snprintf() one checked conversion
+ * at a time.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+
+#include "legato.h"
+#include "logRing.h"
+#include "limit.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of the magic number at the start of every ring ("LRNG").
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_MAGIC              0x4C524E47
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Smallest and largest sizes of a ring's data area, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIN_RING_SIZE           4096
+#define MAX_RING_SIZE           (16 * 1024 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of arguments in a record, and of a single string argument.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_ARGS_BYTES          512
+#define MAX_STR_ARG_BYTES       128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a formatted message (same as for messages that are logged straight away).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_MSG_SIZE            256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum lengths of the strings a reader fetches from the logging process's memory.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_FORMAT_BYTES        512
+#define MAX_NAME_BYTES          128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Level value used to mark a padding record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PAD_RECORD_LEVEL        INT32_MAX
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Values used in place of a /proc/<pid>/mem file descriptor when reading strings: for a ring that
+ * belongs to this process, and for a process whose memory can't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOCAL_MEM_FD            -1
+#define NO_MEM_FD               -2
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring header, at the start of the shared memory file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                                 ///< RING_MAGIC.
+    uint32_t size;                                  ///< Size of the data area (a power of two).
+    int32_t  pid;                                   ///< PID of the process that owns the ring.
+    int32_t  tid;                                   ///< Thread ID of the thread that owns the ring.
+    char     procName[LIMIT_MAX_PROCESS_NAME_BYTES];///< Name of the process.
+    char     threadName[LIMIT_MAX_THREAD_NAME_BYTES];///< Name of the thread.
+
+    uint64_t head __attribute__((aligned(64)));     ///< Position after the last record written.
+    uint64_t dropCount;                             ///< Messages dropped because the ring was full.
+
+    uint64_t tail __attribute__((aligned(64)));     ///< Position of the first record not yet read.
+
+    uint8_t  data[] __attribute__((aligned(64)));   ///< Data area.
+}
+RingHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record header.  Pointers are those of the process that wrote the record.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t size;              ///< Size of the record, including this header (multiple of 8).
+    int32_t  level;             ///< Severity level, -1 for a trace, or PAD_RECORD_LEVEL.
+    uint64_t timestamp;         ///< Nanoseconds since the epoch (CLOCK_REALTIME).
+    uint64_t formatPtr;         ///< Format string.
+    uint64_t fileNamePtr;       ///< Source file name.
+    uint64_t functionNamePtr;   ///< Function name.
+    uint64_t compNamePtr;       ///< Component name.
+    uint64_t keywordPtr;        ///< Trace keyword (0 if not a trace).
+    uint32_t lineNumber;        ///< Source line number.
+    int32_t  savedErrno;        ///< errno value to use for "%m".
+}
+Record_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest possible record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECORD_SIZE         (sizeof(Record_t) + MAX_ARGS_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length modifier of a printf conversion.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LENGTH_NONE,
+    LENGTH_HH,
+    LENGTH_H,
+    LENGTH_L,
+    LENGTH_LL,
+    LENGTH_BIG_L,
+    LENGTH_J,
+    LENGTH_Z,
+    LENGTH_T
+}
+LengthMod_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A parsed printf conversion specification.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* flagsPtr;       ///< First flag character (just after the '%').
+    size_t      flagsLen;       ///< Number of flag characters.
+    bool        widthStar;      ///< true if the width is an argument ('*').
+    const char* widthPtr;       ///< Width digits (if not '*').
+    size_t      widthLen;       ///< Number of width digits.
+    bool        hasPrecision;   ///< true if there is a precision.
+    bool        precisionStar;  ///< true if the precision is an argument (".*").
+    const char* precisionPtr;   ///< Precision digits (if not '*').
+    size_t      precisionLen;   ///< Number of precision digits.
+    LengthMod_t lengthMod;      ///< Length modifier.
+    char        conv;           ///< Conversion character.
+    const char* endPtr;         ///< Character after the conversion character.
+}
+Conversion_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of each thread's ring's data area, in bytes.  0 if binary logging is off.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t RingSize = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to call with the messages left in a ring when its thread exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static logRing_MsgHandler_t FlushHandler;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread-local data key for the thread's ring.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t RingKey;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stored as the thread's ring if its ring couldn't be created, so that it doesn't keep trying.
+ */
+//--------------------------------------------------------------------------------------------------
+static RingHeader_t FailedRing;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the name of a ring's shared memory file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetShmName
+(
+    pid_t pid,
+    pid_t tid,
+    char* buffPtr,
+    size_t buffSize
+)
+{
+    snprintf(buffPtr, buffSize, "/" LOG_RING_SHM_PREFIX "%d.%d", pid, tid);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parses a printf conversion specification.
+ *
+ * @return true if it is one that is supported.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParseConversion
+(
+    const char* specPtr,    ///< [IN] The '%' that starts the conversion specification.
+    Conversion_t* convPtr   ///< [OUT] The parsed specification.
+)
+{
+    const char* p = specPtr + 1;
+
+    memset(convPtr, 0, sizeof(*convPtr));
+
+    convPtr->flagsPtr = p;
+    while ((*p != '\0') && (strchr("-+ #0'", *p) != NULL))
+    {
+        p++;
+    }
+    convPtr->flagsLen = p - convPtr->flagsPtr;
+
+    if (*p == '*')
+    {
+        convPtr->widthStar = true;
+        p++;
+    }
+    else
+    {
+        convPtr->widthPtr = p;
+        while (isdigit((unsigned char)*p))
+        {
+            p++;
+        }
+        convPtr->widthLen = p - convPtr->widthPtr;
+
+        // Positional arguments ("%1$d") aren't supported.
+        if (*p == '$')
+        {
+            return false;
+        }
+    }
+
+    if (*p == '.')
+    {
+        p++;
+        convPtr->hasPrecision = true;
+
+        if (*p == '*')
+        {
+            convPtr->precisionStar = true;
+            p++;
+        }
+        else
+        {
+            convPtr->precisionPtr = p;
+            while (isdigit((unsigned char)*p))
+            {
+                p++;
+            }
+            convPtr->precisionLen = p - convPtr->precisionPtr;
+        }
+    }
+
+    switch (*p)
+    {
+        case 'h':
+            p++;
+            if (*p == 'h')
+            {
+                p++;
+                convPtr->lengthMod = LENGTH_HH;
+            }
+            else
+            {
+                convPtr->lengthMod = LENGTH_H;
+            }
+            break;
+
+        case 'l':
+            p++;
+            if (*p == 'l')
+            {
+                p++;
+                convPtr->lengthMod = LENGTH_LL;
+            }
+            else
+            {
+                convPtr->lengthMod = LENGTH_L;
+            }
+            break;
+
+        case 'q':
+            p++;
+            convPtr->lengthMod = LENGTH_LL;
+            break;
+
+        case 'L':
+            p++;
+            convPtr->lengthMod = LENGTH_BIG_L;
+            break;
+
+        case 'j':
+            p++;
+            convPtr->lengthMod = LENGTH_J;
+            break;
+
+        case 'z':
+        case 'Z':
+            p++;
+            convPtr->lengthMod = LENGTH_Z;
+            break;
+
+        case 't':
+            p++;
+            convPtr->lengthMod = LENGTH_T;
+            break;
+    }
+
+    if ((*p == '\0') || (strchr("diouxXeEfFgGaAcspnm%", *p) == NULL))
+    {
+        return false;
+    }
+
+    // Wide characters and strings aren't supported.
+    if (((*p == 'c') || (*p == 's')) && (convPtr->lengthMod != LENGTH_NONE))
+    {
+        return false;
+    }
+
+    convPtr->conv = *p;
+    convPtr->endPtr = p + 1;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an 8-byte slot to a record's arguments.
+ *
+ * @return false if there isn't room.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PutSlot
+(
+    uint8_t* buffPtr,
+    size_t buffSize,
+    size_t* usedPtr,
+    const void* valuePtr    ///< [IN] 8 bytes to store.
+)
+{
+    if (*usedPtr + 8 > buffSize)
+    {
+        return false;
+    }
+
+    memcpy(buffPtr + *usedPtr, valuePtr, 8);
+    *usedPtr += 8;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a string to a record's arguments, truncating it if there isn't room for all of it.
+ *
+ * No more than maxLen bytes of the string are read, so it needn't be null-terminated if the
+ * conversion has a precision.
+ *
+ * @return false if there isn't room for any of it.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PutString
+(
+    uint8_t* buffPtr,
+    size_t buffSize,
+    size_t* usedPtr,
+    const char* strPtr,
+    size_t maxLen       ///< [IN] Most bytes of the string to use (at most MAX_STR_ARG_BYTES).
+)
+{
+    if (strPtr == NULL)
+    {
+        strPtr = "(null)";
+    }
+
+    if (*usedPtr + sizeof(uint32_t) > buffSize)
+    {
+        return false;
+    }
+
+    uint32_t len = strnlen(strPtr, maxLen);
+    if (*usedPtr + sizeof(uint32_t) + len > buffSize)
+    {
+        len = buffSize - *usedPtr - sizeof(uint32_t);
+    }
+
+    memcpy(buffPtr + *usedPtr, &len, sizeof(len));
+    memcpy(buffPtr + *usedPtr + sizeof(len), strPtr, len);
+
+    *usedPtr += (sizeof(len) + len + 7) & ~(size_t)7;
+    if (*usedPtr > buffSize)
+    {
+        *usedPtr = buffSize;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a message's arguments into a buffer, in the record format.
+ *
+ * @return Number of bytes of the buffer used (a multiple of 8).
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t EncodeArgs
+(
+    const char* formatPtr,
+    va_list args,
+    uint8_t* buffPtr,
+    size_t buffSize     ///< [IN] Must be a multiple of 8.
+)
+{
+    size_t used = 0;
+    const char* p = formatPtr;
+
+    while ((p = strchr(p, '%')) != NULL)
+    {
+        Conversion_t conv;
+        int64_t intVal;
+        uint64_t uintVal;
+        double doubleVal;
+        bool fits = true;
+        size_t maxStrLen = MAX_STR_ARG_BYTES;
+
+        if (!ParseConversion(p, &conv))
+        {
+            break;
+        }
+        p = conv.endPtr;
+
+        if (conv.widthStar)
+        {
+            intVal = va_arg(args, int);
+            fits = PutSlot(buffPtr, buffSize, &used, &intVal);
+        }
+        if (fits && conv.precisionStar)
+        {
+            intVal = va_arg(args, int);
+            fits = PutSlot(buffPtr, buffSize, &used, &intVal);
+
+            // A negative precision is taken as if there were none.
+            if ((intVal >= 0) && (intVal < MAX_STR_ARG_BYTES))
+            {
+                maxStrLen = intVal;
+            }
+        }
+        else if (conv.hasPrecision)
+        {
+            // No digits means a precision of zero.
+            size_t i;
+            size_t precision = 0;
+            for (i = 0; (i < conv.precisionLen) && (precision < MAX_STR_ARG_BYTES); i++)
+            {
+                precision = (precision * 10) + (conv.precisionPtr[i] - '0');
+            }
+            if (precision < MAX_STR_ARG_BYTES)
+            {
+                maxStrLen = precision;
+            }
+        }
+        if (!fits)
+        {
+            break;
+        }
+
+        switch (conv.conv)
+        {
+            case 'd':
+            case 'i':
+                switch (conv.lengthMod)
+                {
+                    case LENGTH_HH: intVal = (signed char)va_arg(args, int);   break;
+                    case LENGTH_H:  intVal = (short)va_arg(args, int);         break;
+                    case LENGTH_L:  intVal = va_arg(args, long);               break;
+                    case LENGTH_LL: intVal = va_arg(args, long long);          break;
+                    case LENGTH_J:  intVal = va_arg(args, intmax_t);           break;
+                    case LENGTH_Z:  intVal = va_arg(args, ssize_t);            break;
+                    case LENGTH_T:  intVal = va_arg(args, ptrdiff_t);          break;
+                    default:        intVal = va_arg(args, int);                break;
+                }
+                fits = PutSlot(buffPtr, buffSize, &used, &intVal);
+                break;
+
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                switch (conv.lengthMod)
+                {
+                    case LENGTH_HH: uintVal = (unsigned char)va_arg(args, unsigned int);  break;
+                    case LENGTH_H:  uintVal = (unsigned short)va_arg(args, unsigned int); break;
+                    case LENGTH_L:  uintVal = va_arg(args, unsigned long);                break;
+                    case LENGTH_LL: uintVal = va_arg(args, unsigned long long);           break;
+                    case LENGTH_J:  uintVal = va_arg(args, uintmax_t);                    break;
+                    case LENGTH_Z:  uintVal = va_arg(args, size_t);                       break;
+                    case LENGTH_T:  uintVal = va_arg(args, ptrdiff_t);                    break;
+                    default:        uintVal = va_arg(args, unsigned int);                 break;
+                }
+                fits = PutSlot(buffPtr, buffSize, &used, &uintVal);
+                break;
+
+            case 'c':
+                intVal = va_arg(args, int);
+                fits = PutSlot(buffPtr, buffSize, &used, &intVal);
+                break;
+
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (conv.lengthMod == LENGTH_BIG_L)
+                {
+                    doubleVal = va_arg(args, long double);
+                }
+                else
+                {
+                    doubleVal = va_arg(args, double);
+                }
+                fits = PutSlot(buffPtr, buffSize, &used, &doubleVal);
+                break;
+
+            case 'p':
+                uintVal = (uintptr_t)va_arg(args, void*);
+                fits = PutSlot(buffPtr, buffSize, &used, &uintVal);
+                break;
+
+            case 's':
+                fits = PutString(buffPtr, buffSize, &used, va_arg(args, const char*), maxStrLen);
+                break;
+
+            case 'n':
+                // Nothing is written back through the pointer.
+                (void)va_arg(args, void*);
+                break;
+
+            default:
+                // '%m' and "%%" have no arguments.
+                break;
+        }
+
+        if (!fits)
+        {
+            break;
+        }
+    }
+
+    return used;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next 8-byte slot from a record's arguments.
+ *
+ * @return false if there are no more arguments.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetSlot
+(
+    const uint8_t* argsPtr,
+    size_t argsSize,
+    size_t* offsetPtr,
+    void* valuePtr      ///< [OUT] 8 bytes.
+)
+{
+    if (*offsetPtr + 8 > argsSize)
+    {
+        return false;
+    }
+
+    memcpy(valuePtr, argsPtr + *offsetPtr, 8);
+    *offsetPtr += 8;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next string from a record's arguments.
+ *
+ * @return false if there are no more arguments.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetString
+(
+    const uint8_t* argsPtr,
+    size_t argsSize,
+    size_t* offsetPtr,
+    char* buffPtr,      ///< [OUT] The string (null-terminated).
+    size_t buffSize     ///< [IN] Must be more than MAX_STR_ARG_BYTES.
+)
+{
+    uint32_t len;
+
+    if (*offsetPtr + sizeof(len) > argsSize)
+    {
+        return false;
+    }
+    memcpy(&len, argsPtr + *offsetPtr, sizeof(len));
+
+    if ((len >= buffSize) || (*offsetPtr + sizeof(len) + len > argsSize))
+    {
+        return false;
+    }
+    memcpy(buffPtr, argsPtr + *offsetPtr + sizeof(len), len);
+    buffPtr[len] = '\0';
+
+    *offsetPtr += (sizeof(len) + len + 7) & ~(size_t)7;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Appends text to a message buffer, truncating it if it doesn't fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendText
+(
+    char* msgPtr,
+    size_t msgSize,
+    size_t* msgLenPtr,
+    const char* textPtr,
+    size_t textLen
+)
+{
+    if (*msgLenPtr + textLen >= msgSize)
+    {
+        textLen = msgSize - 1 - *msgLenPtr;
+    }
+
+    memcpy(msgPtr + *msgLenPtr, textPtr, textLen);
+    *msgLenPtr += textLen;
+    msgPtr[*msgLenPtr] = '\0';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Formats a message from its format string and the arguments stored in its record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatMsg
+(
+    const char* formatPtr,
+    const uint8_t* argsPtr,
+    size_t argsSize,
+    int savedErrno,
+    char* msgPtr,
+    size_t msgSize
+)
+{
+    const char* p = formatPtr;
+    size_t msgLen = 0;
+    size_t offset = 0;
+
+    msgPtr[0] = '\0';
+
+    while ((*p != '\0') && (msgLen < msgSize - 1))
+    {
+        const char* specPtr = strchr(p, '%');
+        Conversion_t conv;
+
+        if (specPtr == NULL)
+        {
+            AppendText(msgPtr, msgSize, &msgLen, p, strlen(p));
+            break;
+        }
+
+        AppendText(msgPtr, msgSize, &msgLen, p, specPtr - p);
+
+        if (!ParseConversion(specPtr, &conv))
+        {
+            AppendText(msgPtr, msgSize, &msgLen, specPtr, strlen(specPtr));
+            break;
+        }
+        p = conv.endPtr;
+
+        // Rebuild the conversion specification, with '*' widths and precisions filled in and
+        // the length modifier replaced by one that matches the type the argument was stored as.
+        char spec[64];
+        int specLen;
+        int64_t width = 0;
+        int64_t precision = 0;
+
+        if (   (conv.widthStar && !GetSlot(argsPtr, argsSize, &offset, &width))
+            || (conv.precisionStar && !GetSlot(argsPtr, argsSize, &offset, &precision)) )
+        {
+            AppendText(msgPtr, msgSize, &msgLen, "...", 3);
+            break;
+        }
+
+        specLen = snprintf(spec, sizeof(spec), "%%%.*s", (int)conv.flagsLen, conv.flagsPtr);
+
+        if (conv.widthStar)
+        {
+            specLen += snprintf(spec + specLen, sizeof(spec) - specLen, "%d", (int)width);
+        }
+        else
+        {
+            specLen += snprintf(spec + specLen, sizeof(spec) - specLen, "%.*s",
+                                (int)conv.widthLen, conv.widthPtr);
+        }
+
+        if (conv.precisionStar)
+        {
+            specLen += snprintf(spec + specLen, sizeof(spec) - specLen, ".%d", (int)precision);
+        }
+        else if (conv.hasPrecision)
+        {
+            specLen += snprintf(spec + specLen, sizeof(spec) - specLen, ".%.*s",
+                                (int)conv.precisionLen, conv.precisionPtr);
+        }
+
+        if (specLen >= (int)sizeof(spec) - 4)
+        {
+            AppendText(msgPtr, msgSize, &msgLen, specPtr, strlen(specPtr));
+            break;
+        }
+
+        char text[MAX_MSG_SIZE];
+        int64_t intVal;
+        uint64_t uintVal;
+        double doubleVal;
+        char strArg[MAX_STR_ARG_BYTES + 1];
+        bool haveArg = true;
+
+        text[0] = '\0';
+
+        switch (conv.conv)
+        {
+            case 'd':
+            case 'i':
+                snprintf(spec + specLen, sizeof(spec) - specLen, "ll%c", conv.conv);
+                haveArg = GetSlot(argsPtr, argsSize, &offset, &intVal);
+                if (haveArg)
+                {
+                    snprintf(text, sizeof(text), spec, (long long)intVal);
+                }
+                break;
+
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                snprintf(spec + specLen, sizeof(spec) - specLen, "ll%c", conv.conv);
+                haveArg = GetSlot(argsPtr, argsSize, &offset, &uintVal);
+                if (haveArg)
+                {
+                    snprintf(text, sizeof(text), spec, (unsigned long long)uintVal);
+                }
+                break;
+
+            case 'c':
+                snprintf(spec + specLen, sizeof(spec) - specLen, "c");
+                haveArg = GetSlot(argsPtr, argsSize, &offset, &intVal);
+                if (haveArg)
+                {
+                    snprintf(text, sizeof(text), spec, (int)intVal);
+                }
+                break;
+
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                snprintf(spec + specLen, sizeof(spec) - specLen, "%c", conv.conv);
+                haveArg = GetSlot(argsPtr, argsSize, &offset, &doubleVal);
+                if (haveArg)
+                {
+                    snprintf(text, sizeof(text), spec, doubleVal);
+                }
+                break;
+
+            case 'p':
+                snprintf(spec + specLen, sizeof(spec) - specLen, "p");
+                haveArg = GetSlot(argsPtr, argsSize, &offset, &uintVal);
+                if (haveArg)
+                {
+                    snprintf(text, sizeof(text), spec, (void*)(uintptr_t)uintVal);
+                }
+                break;
+
+            case 's':
+                snprintf(spec + specLen, sizeof(spec) - specLen, "s");
+                haveArg = GetString(argsPtr, argsSize, &offset, strArg, sizeof(strArg));
+                if (haveArg)
+                {
+                    snprintf(text, sizeof(text), spec, strArg);
+                }
+                break;
+
+            case 'm':
+                snprintf(spec + specLen, sizeof(spec) - specLen, "m");
+                errno = savedErrno;
+                snprintf(text, sizeof(text), spec, 0);
+                break;
+
+            case '%':
+                snprintf(text, sizeof(text), "%%");
+                break;
+
+            default:
+                // '%n' prints nothing.
+                break;
+        }
+
+        if (!haveArg)
+        {
+            AppendText(msgPtr, msgSize, &msgLen, "...", 3);
+            break;
+        }
+
+        AppendText(msgPtr, msgSize, &msgLen, text, strlen(text));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a null-terminated string from the memory of the process that wrote a ring.
+ *
+ * If the string can't be read, a placeholder showing its address is returned instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadString
+(
+    int memFd,          ///< [IN] The process's /proc/<pid>/mem, LOCAL_MEM_FD or NO_MEM_FD.
+    uint64_t addr,      ///< [IN] Address of the string in the process.
+    char* buffPtr,      ///< [OUT] The string.
+    size_t buffSize     ///< [IN] Size of the buffer.
+)
+{
+    if (addr == 0)
+    {
+        buffPtr[0] = '\0';
+        return;
+    }
+
+    if (memFd == LOCAL_MEM_FD)
+    {
+        le_utf8_Copy(buffPtr, (const char*)(uintptr_t)addr, buffSize, NULL);
+        return;
+    }
+
+    // Read a page at a time, so that a read doesn't run into an unmapped page after the string.
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t numRead = 0;
+
+    while ((memFd >= 0) && (numRead < buffSize - 1))
+    {
+        uint64_t readAddr = addr + numRead;
+        size_t chunkSize = pageSize - (readAddr % pageSize);
+
+        if (chunkSize > buffSize - 1 - numRead)
+        {
+            chunkSize = buffSize - 1 - numRead;
+        }
+
+        ssize_t n = pread(memFd, buffPtr + numRead, chunkSize, (off_t)readAddr);
+        if (n <= 0)
+        {
+            break;
+        }
+
+        if (memchr(buffPtr + numRead, '\0', n) != NULL)
+        {
+            return;
+        }
+        numRead += n;
+    }
+
+    if (numRead == 0)
+    {
+        snprintf(buffPtr, buffSize, "<%#" PRIx64 ">", addr);
+    }
+    else
+    {
+        buffPtr[numRead] = '\0';
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads all the records waiting in a ring, formats them and passes them to a handler function.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_FORMAT_ERROR if a bad record was found.  The rest of the ring is discarded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DrainRing
+(
+    RingHeader_t* ringPtr,
+    int memFd,                      ///< [IN] Process's /proc/<pid>/mem, LOCAL_MEM_FD or NO_MEM_FD.
+    logRing_MsgHandler_t handler,
+    void* contextPtr
+)
+{
+    uint64_t tail = ringPtr->tail;
+    uint64_t head = __atomic_load_n(&ringPtr->head, __ATOMIC_ACQUIRE);
+    uint32_t size = ringPtr->size;
+    le_result_t result = LE_OK;
+
+    // Copies of the header strings, in case the owner overwrites them.
+    char procName[LIMIT_MAX_PROCESS_NAME_BYTES];
+    char threadName[LIMIT_MAX_THREAD_NAME_BYTES];
+    le_utf8_Copy(procName, ringPtr->procName, sizeof(procName), NULL);
+    le_utf8_Copy(threadName, ringPtr->threadName, sizeof(threadName), NULL);
+
+    if (head - tail > size)
+    {
+        tail = head;
+        result = LE_FORMAT_ERROR;
+    }
+
+    while (tail != head)
+    {
+        size_t offset = tail & (size - 1);
+        uint64_t recordBuff[MAX_RECORD_SIZE / sizeof(uint64_t)];
+        Record_t* recPtr = (Record_t*)recordBuff;
+
+        // The first 8 bytes are all that's guaranteed to be there (for padding records).
+        memcpy(recPtr, ringPtr->data + offset, 8);
+
+        if (   (recPtr->size < 8)
+            || ((recPtr->size % 8) != 0)
+            || (recPtr->size > head - tail)
+            || (offset + recPtr->size > size) )
+        {
+            result = LE_FORMAT_ERROR;
+            tail = head;
+            break;
+        }
+
+        if (recPtr->level != PAD_RECORD_LEVEL)
+        {
+            if ((recPtr->size < sizeof(Record_t)) || (recPtr->size > MAX_RECORD_SIZE))
+            {
+                result = LE_FORMAT_ERROR;
+                tail = head;
+                break;
+            }
+
+            memcpy(recPtr, ringPtr->data + offset, recPtr->size);
+
+            char format[MAX_FORMAT_BYTES];
+            char fileName[MAX_NAME_BYTES];
+            char functionName[MAX_NAME_BYTES];
+            char compName[LIMIT_MAX_COMPONENT_NAME_BYTES];
+            char keyword[LIMIT_MAX_LOG_KEYWORD_BYTES];
+            char msg[MAX_MSG_SIZE];
+
+            ReadString(memFd, recPtr->formatPtr, format, sizeof(format));
+            ReadString(memFd, recPtr->fileNamePtr, fileName, sizeof(fileName));
+            ReadString(memFd, recPtr->functionNamePtr, functionName, sizeof(functionName));
+            ReadString(memFd, recPtr->compNamePtr, compName, sizeof(compName));
+            ReadString(memFd, recPtr->keywordPtr, keyword, sizeof(keyword));
+
+            FormatMsg(format,
+                      (const uint8_t*)(recPtr + 1),
+                      recPtr->size - sizeof(Record_t),
+                      recPtr->savedErrno,
+                      msg,
+                      sizeof(msg));
+
+            logRing_Msg_t logMsg =
+                {
+                    .level = recPtr->level,
+                    .keywordPtr = keyword,
+                    .procNamePtr = procName,
+                    .pid = ringPtr->pid,
+                    .compNamePtr = compName,
+                    .threadNamePtr = threadName,
+                    .fileNamePtr = le_path_GetBasenamePtr(fileName, "/"),
+                    .functionNamePtr = functionName,
+                    .lineNumber = recPtr->lineNumber,
+                    .timestamp = { .tv_sec = recPtr->timestamp / 1000000000,
+                                   .tv_nsec = recPtr->timestamp % 1000000000 },
+                    .msgPtr = msg
+                };
+
+            handler(&logMsg, contextPtr);
+        }
+
+        tail += recPtr->size;
+
+        // Give the space back to the writer straight away.
+        __atomic_store_n(&ringPtr->tail, tail, __ATOMIC_RELEASE);
+    }
+
+    __atomic_store_n(&ringPtr->tail, tail, __ATOMIC_RELEASE);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Logs the messages left in a thread's ring, then deletes the ring.  Called when the thread
+ * exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingDestructor
+(
+    void* ringPtr       ///< [IN] The thread's ring.
+)
+{
+    RingHeader_t* headerPtr = ringPtr;
+    char shmName[64];
+
+    if (headerPtr == &FailedRing)
+    {
+        return;
+    }
+
+    DrainRing(headerPtr, LOCAL_MEM_FD, FlushHandler, NULL);
+
+    GetShmName(headerPtr->pid, headerPtr->tid, shmName, sizeof(shmName));
+    munmap(headerPtr, sizeof(RingHeader_t) + headerPtr->size);
+    shm_unlink(shmName);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flushes the calling thread's ring when the process exits.  Only the thread that called exit()
+ * gets to flush its ring; the rings of other threads are left for the log tool to read.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushAtExit
+(
+    void
+)
+{
+    void* ringPtr = pthread_getspecific(RingKey);
+
+    if (ringPtr != NULL)
+    {
+        pthread_setspecific(RingKey, NULL);
+        RingDestructor(ringPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Forgets the ring inherited from the parent process in a newly forked child process.  The parent
+ * still owns it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ForgetRingAfterFork
+(
+    void
+)
+{
+    RingHeader_t* ringPtr = pthread_getspecific(RingKey);
+
+    if ((ringPtr != NULL) && (ringPtr != &FailedRing))
+    {
+        munmap(ringPtr, sizeof(RingHeader_t) + ringPtr->size);
+    }
+
+    pthread_setspecific(RingKey, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the calling thread's ring.
+ *
+ * @return Pointer to the ring, or &FailedRing if it couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static RingHeader_t* CreateRing
+(
+    void
+)
+{
+    pid_t pid = getpid();
+    pid_t tid = syscall(SYS_gettid);
+    size_t fileSize = sizeof(RingHeader_t) + RingSize;
+    RingHeader_t* ringPtr = &FailedRing;
+    char shmName[64];
+
+    // Mark the ring failed first, so that anything logged while creating it isn't written to it.
+    pthread_setspecific(RingKey, &FailedRing);
+
+    GetShmName(pid, tid, shmName, sizeof(shmName));
+
+    int fd = shm_open(shmName, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        LE_WARN("Failed to create binary log ring '%s' (%m).", shmName);
+        return ringPtr;
+    }
+
+    if (ftruncate(fd, fileSize) != 0)
+    {
+        LE_WARN("Failed to size binary log ring '%s' (%m).", shmName);
+    }
+    else
+    {
+        void* addr = mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            LE_WARN("Failed to map binary log ring '%s' (%m).", shmName);
+        }
+        else
+        {
+            ringPtr = addr;
+        }
+    }
+
+    close(fd);
+
+    if (ringPtr == &FailedRing)
+    {
+        shm_unlink(shmName);
+        return ringPtr;
+    }
+
+    const char* procNamePtr = le_arg_GetProgramName();
+
+    ringPtr->size = RingSize;
+    ringPtr->pid = pid;
+    ringPtr->tid = tid;
+    le_utf8_Copy(ringPtr->procName,
+                 (procNamePtr != NULL) ? procNamePtr : "n/a",
+                 sizeof(ringPtr->procName),
+                 NULL);
+    le_utf8_Copy(ringPtr->threadName, le_thread_GetMyName(), sizeof(ringPtr->threadName), NULL);
+
+    // The magic number goes in last, so a reader never sees a half-initialized header.
+    __atomic_store_n(&ringPtr->magic, RING_MAGIC, __ATOMIC_RELEASE);
+
+    pthread_setspecific(RingKey, ringPtr);
+
+    return ringPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Turns on binary logging in the calling process.  Rings are created by each thread the first
+ * time it logs a binary message.
+ *
+ * @note Must be called only once, while there is only one thread running.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRing_Enable
+(
+    size_t ringSize,                    ///< [IN] Size of each thread's ring, in bytes.  Rounded up
+                                        ///       to a power of two.
+    logRing_MsgHandler_t flushHandler   ///< [IN] Called to log the messages left in a ring when
+                                        ///       its thread exits.
+)
+{
+    size_t size = MIN_RING_SIZE;
+
+    while ((size < ringSize) && (size < MAX_RING_SIZE))
+    {
+        size *= 2;
+    }
+
+    LE_ASSERT(pthread_key_create(&RingKey, RingDestructor) == 0);
+    LE_ASSERT(pthread_atfork(NULL, NULL, ForgetRingAfterFork) == 0);
+    LE_ASSERT(atexit(FlushAtExit) == 0);
+
+    FlushHandler = flushHandler;
+    RingSize = size;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether binary logging is on in the calling process.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logRing_IsEnabled
+(
+    void
+)
+{
+    return (RingSize != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a message into the calling thread's ring buffer.
+ *
+ * The format string, file name, function name, component name and keyword strings are not
+ * copied, so they must stay valid for the lifetime of the process (as string literals do).
+ * String arguments are copied (possibly truncated).
+ *
+ * @return
+ * - LE_OK if the message was written.
+ * - LE_NO_MEMORY if the ring was full and the message was dropped.
+ * - LE_FAULT if the thread doesn't have a ring and it couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logRing_Write
+(
+    le_log_Level_t level,           ///< [IN] Severity level, or -1 for a trace message.
+    const char* keywordPtr,         ///< [IN] Trace keyword (NULL if not a trace message).
+    const char* compNamePtr,        ///< [IN] Component name.
+    const char* fileNamePtr,        ///< [IN] Source file name.
+    const char* functionNamePtr,    ///< [IN] Function name.
+    unsigned int lineNumber,        ///< [IN] Source line number.
+    int savedErrno,                 ///< [IN] errno value to use for "%m".
+    const char* formatPtr,          ///< [IN] printf-style format string.
+    va_list args                    ///< [IN] Arguments for the format string.
+)
+{
+    RingHeader_t* ringPtr = pthread_getspecific(RingKey);
+
+    if (ringPtr == NULL)
+    {
+        ringPtr = CreateRing();
+    }
+    if (ringPtr == &FailedRing)
+    {
+        return LE_FAULT;
+    }
+
+    uint64_t argsBuff[MAX_ARGS_BYTES / sizeof(uint64_t)];
+    size_t argsSize = EncodeArgs(formatPtr, args, (uint8_t*)argsBuff, sizeof(argsBuff));
+    size_t recSize = sizeof(Record_t) + argsSize;
+
+    uint32_t size = ringPtr->size;
+    uint64_t head = ringPtr->head;
+    uint64_t tail = __atomic_load_n(&ringPtr->tail, __ATOMIC_ACQUIRE);
+    size_t offset = head & (size - 1);
+    size_t padSize = (offset + recSize > size) ? (size - offset) : 0;
+
+    if ((head + padSize + recSize) - tail > size)
+    {
+        __atomic_fetch_add(&ringPtr->dropCount, 1, __ATOMIC_RELAXED);
+        return LE_NO_MEMORY;
+    }
+
+    if (padSize > 0)
+    {
+        Record_t* padPtr = (Record_t*)(ringPtr->data + offset);
+        padPtr->size = padSize;
+        padPtr->level = PAD_RECORD_LEVEL;
+
+        head += padSize;
+        offset = 0;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    Record_t* recPtr = (Record_t*)(ringPtr->data + offset);
+    recPtr->size = recSize;
+    recPtr->level = level;
+    recPtr->timestamp = ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+    recPtr->formatPtr = (uintptr_t)formatPtr;
+    recPtr->fileNamePtr = (uintptr_t)fileNamePtr;
+    recPtr->functionNamePtr = (uintptr_t)functionNamePtr;
+    recPtr->compNamePtr = (uintptr_t)compNamePtr;
+    recPtr->keywordPtr = (uintptr_t)keywordPtr;
+    recPtr->lineNumber = lineNumber;
+    recPtr->savedErrno = savedErrno;
+    memcpy(recPtr + 1, argsBuff, argsSize);
+
+    // Publish the record to the reader.
+    __atomic_store_n(&ringPtr->head, head + recSize, __ATOMIC_RELEASE);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads and formats all the messages waiting in a ring buffer, and removes them from the ring.
+ *
+ * Strings referred to by the messages are read from the memory of the process that logged them
+ * (through /proc/<pid>/mem), so the caller must be allowed to do that.
+ *
+ * If the process that owned the ring has gone away, the ring's shared memory file is deleted.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_NOT_FOUND if the ring doesn't exist.
+ * - LE_FORMAT_ERROR if the ring's contents are not valid.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logRing_Read
+(
+    const char* shmName,            ///< [IN] Ring's shared memory file name (in /dev/shm).
+    logRing_MsgHandler_t handler,   ///< [IN] Function to call for each message.
+    void* contextPtr,               ///< [IN] Passed to the handler.
+    size_t* numDroppedPtr           ///< [OUT] Number of messages that were dropped because the ring
+                                    ///        was full (since the last read).
+)
+{
+    char path[PATH_MAX];
+    struct stat fileStat;
+    le_result_t result;
+
+    *numDroppedPtr = 0;
+
+    snprintf(path, sizeof(path), "/%s", shmName);
+
+    int fd = shm_open(path, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size < (off_t)sizeof(RingHeader_t)))
+    {
+        close(fd);
+        return LE_FORMAT_ERROR;
+    }
+
+    RingHeader_t* ringPtr = mmap(NULL,
+                                 fileStat.st_size,
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_SHARED,
+                                 fd,
+                                 0);
+    close(fd);
+
+    if (ringPtr == MAP_FAILED)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    uint32_t size = ringPtr->size;
+
+    if (   (__atomic_load_n(&ringPtr->magic, __ATOMIC_ACQUIRE) != RING_MAGIC)
+        || (size < MIN_RING_SIZE)
+        || ((size & (size - 1)) != 0)
+        || (sizeof(RingHeader_t) + size > (size_t)fileStat.st_size) )
+    {
+        munmap(ringPtr, fileStat.st_size);
+        return LE_FORMAT_ERROR;
+    }
+
+    pid_t pid = ringPtr->pid;
+    int memFd = LOCAL_MEM_FD;
+
+    if (pid != getpid())
+    {
+        char memPath[64];
+
+        snprintf(memPath, sizeof(memPath), "/proc/%d/mem", pid);
+
+        // If this fails, the strings will just be shown as addresses.
+        memFd = open(memPath, O_RDONLY | O_CLOEXEC);
+        if (memFd < 0)
+        {
+            memFd = NO_MEM_FD;
+        }
+    }
+
+    result = DrainRing(ringPtr, memFd, handler, contextPtr);
+
+    *numDroppedPtr = __atomic_exchange_n(&ringPtr->dropCount, 0, __ATOMIC_RELAXED);
+
+    if (memFd >= 0)
+    {
+        close(memFd);
+    }
+
+    munmap(ringPtr, fileStat.st_size);
+
+    if ((pid != getpid()) && (kill(pid, 0) != 0) && (errno == ESRCH))
+    {
+        shm_unlink(path);
+    }
+
+    return result;
+}
@@ -0,0 +1,148 @@
+/** @file logRing.h
+ *
+ * Log module's "Binary Ring" inter-module interface definitions.
+ *
+ * When binary logging is enabled (see the @c LE_LOG_BINARY environment variable in @ref c_log),
+ * debug, info and trace messages are not formatted when they are logged.  Instead, each thread
+ * writes the message's format string pointer, a timestamp and the message's raw arguments into
+ * its own ring buffer.  The ring buffer is a shared memory file, so the messages can be formatted
+ * later by another process (the log tool's "dump" command), which reads the format strings out
+ * of the logging process's memory.
+ *
+ * Each ring has only one writer (its thread) and one reader, so no locking is needed.  If the
+ * ring is full, new messages are dropped and counted.  When a thread exits, the messages still
+ * in its ring are formatted and logged normally, and the ring is deleted.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+
+#ifndef LEGATO_LOG_RING_H_INCLUDE_GUARD
+#define LEGATO_LOG_RING_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prefix of the names of the ring buffers' shared memory files (in /dev/shm).  The rest of the
+ * name is "<pid>.<tid>".
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_RING_SHM_PREFIX     "legato_log."
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A log message read out of a ring buffer and formatted.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_log_Level_t  level;              ///< Severity level, or -1 if this is a trace message.
+    const char*     keywordPtr;         ///< Trace keyword (only for trace messages).
+    const char*     procNamePtr;        ///< Name of the process that logged the message.
+    pid_t           pid;                ///< PID of the process that logged the message.
+    const char*     compNamePtr;        ///< Name of the component that logged the message.
+    const char*     threadNamePtr;      ///< Name of the thread that logged the message.
+    const char*     fileNamePtr;        ///< Base name of the source file.
+    const char*     functionNamePtr;    ///< Name of the function.
+    unsigned int    lineNumber;         ///< Line number in the source file.
+    struct timespec timestamp;          ///< When the message was logged (CLOCK_REALTIME).
+    const char*     msgPtr;             ///< The formatted message.
+}
+logRing_Msg_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that is called for each message read out of a ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*logRing_MsgHandler_t)
+(
+    const logRing_Msg_t* msgPtr,    ///< [IN] The message.
+    void* contextPtr                ///< [IN] Context pointer passed to the read function.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Turns on binary logging in the calling process.  Rings are created by each thread the first
+ * time it logs a binary message.
+ *
+ * @note Must be called only once, while there is only one thread running.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRing_Enable
+(
+    size_t ringSize,                    ///< [IN] Size of each thread's ring, in bytes.  Rounded up
+                                        ///       to a power of two.
+    logRing_MsgHandler_t flushHandler   ///< [IN] Called to log the messages left in a ring when
+                                        ///       its thread exits.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether binary logging is on in the calling process.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logRing_IsEnabled
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a message into the calling thread's ring buffer.
+ *
+ * The format string, file name, function name, component name and keyword strings are not
+ * copied, so they must stay valid for the lifetime of the process (as string literals do).
+ * String arguments are copied (possibly truncated).
+ *
+ * @return
+ * - LE_OK if the message was written.
+ * - LE_NO_MEMORY if the ring was full and the message was dropped.
+ * - LE_FAULT if the thread doesn't have a ring and it couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logRing_Write
+(
+    le_log_Level_t level,           ///< [IN] Severity level, or -1 for a trace message.
+    const char* keywordPtr,         ///< [IN] Trace keyword (NULL if not a trace message).
+    const char* compNamePtr,        ///< [IN] Component name.
+    const char* fileNamePtr,        ///< [IN] Source file name.
+    const char* functionNamePtr,    ///< [IN] Function name.
+    unsigned int lineNumber,        ///< [IN] Source line number.
+    int savedErrno,                 ///< [IN] errno value to use for "%m".
+    const char* formatPtr,          ///< [IN] printf-style format string.
+    va_list args                    ///< [IN] Arguments for the format string.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads and formats all the messages waiting in a ring buffer, and removes them from the ring.
+ *
+ * Strings referred to by the messages are read from the memory of the process that logged them
+ * (through /proc/<pid>/mem), so the caller must be allowed to do that.
+ *
+ * If the process that owned the ring has gone away, the ring's shared memory file is deleted.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_NOT_FOUND if the ring doesn't exist.
+ * - LE_FORMAT_ERROR if the ring's contents are not valid.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logRing_Read
+(
+    const char* shmName,            ///< [IN] Ring's shared memory file name (in /dev/shm).
+    logRing_MsgHandler_t handler,   ///< [IN] Function to call for each message.
+    void* contextPtr,               ///< [IN] Passed to the handler.
+    size_t* numDroppedPtr           ///< [OUT] Number of messages that were dropped because the ring
+                                    ///        was full (since the last read).
+);
+
+
+#endif // LEGATO_LOG_RING_H_INCLUDE_GUARD
@@ -39,6 +39,20 @@
  * is unlikely to occur in normal data.  Whenever a block is allocated or released, the
  * guard bands are checked for corruption and any corruption is reported.
  *
+ * THREAD CACHES
+ * =============
+ *
+ * All pools share a single mutex, so pools that are hammered by several threads at once can be
+ * given per-thread caches using le_mem_EnableThreadCache().  Each thread then keeps a small stack
+ * of free blocks for that pool (found through a pthread key stored in the pool) and only takes the
+ * mutex when its cache runs empty, in which case it refills half of the cache from the pool's free
+ * list in one go, or when its cache overflows, in which case it flushes half of the cache back to
+ * the pool's free list.  A thread's cache is flushed back to the pool when the thread dies.
+ *
+ * Blocks sitting in a thread cache are still counted as free in the pool's statistics.  To keep
+ * the statistics correct without the mutex, the counters in the pool and the reference counts in
+ * the blocks are always updated using atomic operations.
+ *
  * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
  *
  */
@@ -109,6 +123,22 @@ typedef struct
 MemBlock_t;
 
 
+#ifndef LE_MEM_VALGRIND
+//--------------------------------------------------------------------------------------------------
+/**
+ * A thread's private cache of free blocks for a given pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MemPool_t* poolPtr;         ///< The pool that the cached blocks belong to.
+    le_sls_List_t freeList;     ///< Stack of free blocks owned by this thread.
+    size_t numBlocks;           ///< Number of blocks on the free list.
+}
+ThreadCache_t;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Local list of all memory pools created with le_mem_CreatePool and le_mem_CreateSubPool
@@ -199,6 +229,65 @@ static inline void Unlock
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Raises a pool's high-water mark to a given number of blocks in use, if it is lower.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void UpdateMaxNumBlocksUsed
+(
+    MemPool_t*  poolPtr,        ///< [IN] The pool.
+    size_t      numBlocksInUse  ///< [IN] The number of blocks in use just observed.
+)
+{
+    size_t maxNumBlocksUsed = __atomic_load_n(&poolPtr->maxNumBlocksUsed, __ATOMIC_RELAXED);
+
+    while (   (numBlocksInUse > maxNumBlocksUsed)
+           && !__atomic_compare_exchange_n(&poolPtr->maxNumBlocksUsed,
+                                           &maxNumBlocksUsed,
+                                           numBlocksInUse,
+                                           true,
+                                           __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED) )
+    {
+        // maxNumBlocksUsed has been refreshed by the failed compare-exchange, so just try again.
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds to the number of blocks in use in a pool and updates its high-water mark.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void AddBlocksInUse
+(
+    MemPool_t*  poolPtr,    ///< [IN] The pool.
+    size_t      numBlocks   ///< [IN] The number of blocks that are now in use.
+)
+{
+    UpdateMaxNumBlocksUsed(poolPtr,
+                           __atomic_add_fetch(&poolPtr->numBlocksInUse, numBlocks, __ATOMIC_RELAXED));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a pool's thread cache size.
+ *
+ * @return The maximum number of blocks each thread can cache, or 0 if thread caching is disabled.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t GetThreadCacheSize
+(
+    MemPool_t*  poolPtr     ///< [IN] The pool.
+)
+{
+    // Acquire, so that the thread cache key is seen to be valid if the size is non-zero.
+    return __atomic_load_n(&poolPtr->threadCacheSize, __ATOMIC_ACQUIRE);
+}
+
+
 #ifdef USE_GUARD_BAND
 
     //----------------------------------------------------------------------------------------------
@@ -336,6 +425,7 @@ static void InitPool
     pool->numBlocksInUse = 0;
     pool->maxNumBlocksUsed = 0;
     pool->numBlocksToForce = DEFAULT_NUM_BLOCKS_TO_FORCE;
+    pool->threadCacheSize = 0;
 
     #ifdef LE_MEM_TRACE
         pool->memTrace = NULL;
@@ -466,6 +556,204 @@ static void InitBlock
 #endif
 
 
+#ifndef LE_MEM_VALGRIND
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Moves up to a given number of blocks from a pool's free list into a thread cache.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void RefillThreadCache
+    (
+        ThreadCache_t*  cachePtr,   ///< [IN] The thread cache to refill.
+        size_t          numBlocks   ///< [IN] The maximum number of blocks to move.
+    )
+    {
+        le_sls_Link_t* blockLinkPtr;
+
+        while (   (numBlocks > 0)
+               && ((blockLinkPtr = le_sls_Pop(&(cachePtr->poolPtr->freeList))) != NULL) )
+        {
+            le_sls_Stack(&(cachePtr->freeList), blockLinkPtr);
+            cachePtr->numBlocks++;
+            numBlocks--;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Moves a given number of blocks from a thread cache back to its pool's free list.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void FlushThreadCache
+    (
+        ThreadCache_t*  cachePtr,   ///< [IN] The thread cache to flush.
+        size_t          numBlocks   ///< [IN] The number of blocks to move.
+    )
+    {
+        LE_ASSERT(numBlocks <= cachePtr->numBlocks);
+
+        while (numBlocks > 0)
+        {
+            le_sls_Stack(&(cachePtr->poolPtr->freeList), le_sls_Pop(&(cachePtr->freeList)));
+            cachePtr->numBlocks--;
+            numBlocks--;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Destructor for thread caches.  Called by pthreads when a thread that has a cache dies, to
+     * give all the blocks in its cache back to the pool.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void ThreadCacheDestructor
+    (
+        void* cachePtr  ///< [IN] The dead thread's cache.
+    )
+    {
+        Lock();
+        FlushThreadCache(cachePtr, ((ThreadCache_t*)cachePtr)->numBlocks);
+        Unlock();
+
+        free(cachePtr);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets the calling thread's cache for a given pool, creating it if it doesn't exist yet.
+     *
+     * @return Pointer to the thread cache.
+     */
+    //----------------------------------------------------------------------------------------------
+    static ThreadCache_t* GetThreadCache
+    (
+        MemPool_t*  poolPtr     ///< [IN] The pool, which must have thread caching enabled.
+    )
+    {
+        ThreadCache_t* cachePtr = pthread_getspecific(poolPtr->threadCacheKey);
+
+        if (cachePtr == NULL)
+        {
+            cachePtr = malloc(sizeof(ThreadCache_t));
+            LE_ASSERT(cachePtr);
+
+            cachePtr->poolPtr = poolPtr;
+            cachePtr->freeList = LE_SLS_LIST_INIT;
+            cachePtr->numBlocks = 0;
+
+            LE_ASSERT(pthread_setspecific(poolPtr->threadCacheKey, cachePtr) == 0);
+        }
+
+        return cachePtr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Pops a free block from the calling thread's cache for a given pool.  If the cache is empty,
+     * it is first refilled with half its capacity from the pool's free list.
+     *
+     * @return Pointer to the block's link, or NULL if the pool has no free blocks left.
+     */
+    //----------------------------------------------------------------------------------------------
+    static le_sls_Link_t* PopFromThreadCache
+    (
+        MemPool_t*  poolPtr,    ///< [IN] The pool.
+        size_t      cacheSize   ///< [IN] The pool's thread cache size.
+    )
+    {
+        ThreadCache_t* cachePtr = GetThreadCache(poolPtr);
+
+        if (cachePtr->numBlocks == 0)
+        {
+            Lock();
+            RefillThreadCache(cachePtr, (cacheSize + 1) / 2);
+            Unlock();
+        }
+
+        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(cachePtr->freeList));
+
+        if (blockLinkPtr != NULL)
+        {
+            cachePtr->numBlocks--;
+        }
+
+        return blockLinkPtr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Pushes a free block onto the calling thread's cache for a given pool.  If that makes the
+     * cache overflow, half of the cache is flushed back to the pool's free list.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void PushToThreadCache
+    (
+        MemPool_t*      poolPtr,        ///< [IN] The pool.
+        size_t          cacheSize,      ///< [IN] The pool's thread cache size.
+        le_sls_Link_t*  blockLinkPtr    ///< [IN] Link of the block being freed.
+    )
+    {
+        ThreadCache_t* cachePtr = GetThreadCache(poolPtr);
+
+        le_sls_Stack(&(cachePtr->freeList), blockLinkPtr);
+        cachePtr->numBlocks++;
+
+        if (cachePtr->numBlocks > cacheSize)
+        {
+            Lock();
+            FlushThreadCache(cachePtr, cachePtr->numBlocks - (cacheSize / 2));
+            Unlock();
+        }
+    }
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Puts a block whose reference count has dropped to zero back into its pool (or its thread
+ * cache).
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseBlock
+(
+    MemPool_t*  poolPtr,    ///< [IN] The pool the block belongs to.
+    MemBlock_t* blockPtr    ///< [IN] The block.
+)
+{
+    // Count the block as free before putting it back on a free list, so that another thread can't
+    // allocate it and push the number of blocks in use above the total number of blocks.
+    __atomic_sub_fetch(&poolPtr->numBlocksInUse, 1, __ATOMIC_RELAXED);
+
+    #ifndef LE_MEM_VALGRIND
+        size_t cacheSize = GetThreadCacheSize(poolPtr);
+
+        if (cacheSize > 0)
+        {
+            PushToThreadCache(poolPtr, cacheSize, &(blockPtr->link));
+        }
+        else
+        {
+            Lock();
+            le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
+            Unlock();
+        }
+    #else
+        free(blockPtr);
+    #endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log an error message if there is another pool with the same name as a given pool.
@@ -693,12 +981,7 @@ le_mem_PoolRef_t le_mem_ExpandPool
             pool->totalBlocks = pool->totalBlocks + numObjects;
 
             // Update the super-pool's block use counts.
-            pool->superPoolPtr->numBlocksInUse += numObjects;
-
-            if (pool->superPoolPtr->numBlocksInUse > pool->superPoolPtr->maxNumBlocksUsed)
-            {
-                pool->superPoolPtr->maxNumBlocksUsed = pool->superPoolPtr->numBlocksInUse;
-            }
+            AddBlocksInUse(pool->superPoolPtr, numObjects);
         }
         else
         {
@@ -730,13 +1013,22 @@ void* le_mem_TryAlloc
     LE_ASSERT(pool != NULL);
 
     MemBlock_t* blockPtr = NULL;
-    void* userPtr = NULL;
-
-    Lock();
 
     #ifndef LE_MEM_VALGRIND
-        // Pop a link off the pool.
-        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(pool->freeList));
+        le_sls_Link_t* blockLinkPtr;
+        size_t cacheSize = GetThreadCacheSize(pool);
+
+        // Pop a link off the thread's cache or off the pool.
+        if (cacheSize > 0)
+        {
+            blockLinkPtr = PopFromThreadCache(pool, cacheSize);
+        }
+        else
+        {
+            Lock();
+            blockLinkPtr = le_sls_Pop(&(pool->freeList));
+            Unlock();
+        }
 
         if (blockLinkPtr != NULL)
         {
@@ -752,31 +1044,24 @@ void* le_mem_TryAlloc
         }
     #endif
 
-    if (blockPtr != NULL)
+    if (blockPtr == NULL)
     {
-        // Update the pool and the block.
-        pool->numAllocations++;
-        pool->numBlocksInUse++;
-
-        if (pool->numBlocksInUse > pool->maxNumBlocksUsed)
-        {
-            pool->maxNumBlocksUsed = pool->numBlocksInUse;
-        }
-
-        blockPtr->refCount = 1;
-
-        // Return the user object in the block.
-        #ifdef USE_GUARD_BAND
-            CheckGuardBands(blockPtr);
-            userPtr = blockPtr->data + GUARD_BAND_SIZE;
-        #else
-            userPtr = blockPtr->data;
-        #endif
+        return NULL;
     }
 
-    Unlock();
+    // Update the pool and the block.
+    __atomic_add_fetch(&pool->numAllocations, 1, __ATOMIC_RELAXED);
+    AddBlocksInUse(pool, 1);
 
-    return userPtr;
+    blockPtr->refCount = 1;
+
+    // Return the user object in the block.
+    #ifdef USE_GUARD_BAND
+        CheckGuardBands(blockPtr);
+        return blockPtr->data + GUARD_BAND_SIZE;
+    #else
+        return blockPtr->data;
+    #endif
 }
 
 
@@ -876,6 +1161,49 @@ void le_mem_SetNumObjsToForce
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives each thread that uses a pool its own cache of free blocks, so that most allocations and
+ * releases don't need to take the memory pool mutex.
+ *
+ * @return
+ *      Nothing.
+ *
+ * @note
+ *      Can't be used on sub-pools.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_EnableThreadCache
+(
+    le_mem_PoolRef_t    pool,       ///< [IN] The pool.
+    size_t              numObjects  ///< [IN] The maximum number of free objects cached per thread.
+)
+{
+    LE_ASSERT(pool != NULL);
+    LE_ASSERT(numObjects > 0);
+
+    #ifndef LE_MEM_VALGRIND
+        Lock();
+
+        LE_FATAL_IF(pool->superPoolPtr != NULL,
+                    "Thread caches can't be used on sub-pool '%s'.",
+                    pool->name);
+
+        if (pool->threadCacheSize == 0)
+        {
+            LE_FATAL_IF(pthread_key_create(&pool->threadCacheKey, ThreadCacheDestructor) != 0,
+                        "Failed to create thread cache key for pool '%s'.",
+                        pool->name);
+        }
+
+        // Release, so that the key is seen to be valid by any thread that sees the size.
+        __atomic_store_n(&pool->threadCacheSize, numObjects, __ATOMIC_RELEASE);
+
+        Unlock();
+    #endif
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Releases an object.  If the object's reference count has reached zero, it will be destructed
@@ -911,44 +1239,30 @@ void le_mem_Release
         CheckGuardBands(blockPtr);
     #endif
 
-    Lock();
+    size_t oldRefCount = __atomic_fetch_sub(&blockPtr->refCount, 1, __ATOMIC_ACQ_REL);
 
-    switch (blockPtr->refCount)
+    switch (oldRefCount)
     {
         case 1:
         {
-            MemPool_t* poolPtr = blockPtr->poolPtr;
-
             // The reference count has reached zero.
-            blockPtr->refCount = 0;
+            MemPool_t* poolPtr = blockPtr->poolPtr;
 
-            // Call the destructor, if there is one.
-            if (poolPtr->destructor)
+            // Call the destructor, if there is one.  The mutex is not held here, so the
+            // destructor is free to use the memory pool API.
+            le_mem_Destructor_t destructor = __atomic_load_n(&poolPtr->destructor,
+                                                             __ATOMIC_ACQUIRE);
+            if (destructor)
             {
-                // Make sure that the destructor is not called with the mutex locked, because
-                // it is not a recursive mutex and therefore will deadlock if locked again by
-                // the same thread.  Also, fetch the destructor function address before unlocking
-                // the mutex so that we don't touch the pool object while the mutex is unlocked.
-                le_mem_Destructor_t destructor = poolPtr->destructor;
-                Unlock();
                 destructor(objPtr);
-
-                // Re-lock the mutex now so that it is safe to access the pool object again.
-                Lock();
             }
 
-            #ifndef LE_MEM_VALGRIND
-                // Release the memory back into the pool.
-                // Note that we don't do this before calling the destructor because the destructor
-                // still needs to access it, but after it goes back on the free list, it could get
-                // reallocated by another thread (or even the destructor itself) and have its
-                // contents clobbered.
-                le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
-            #else
-                free(blockPtr);
-            #endif
-
-            poolPtr->numBlocksInUse--;
+            // Release the memory back into the pool.
+            // Note that we don't do this before calling the destructor because the destructor
+            // still needs to access it, but after it goes back on the free list, it could get
+            // reallocated by another thread (or even the destructor itself) and have its
+            // contents clobbered.
+            ReleaseBlock(poolPtr, blockPtr);
 
             break;
         }
@@ -960,10 +1274,8 @@ void le_mem_Release
                      blockPtr->poolPtr->name);
 
         default:
-            blockPtr->refCount--;
+            break;
     }
-
-    Unlock();
 }
 
 
@@ -991,13 +1303,7 @@ void le_mem_AddRef
         CheckGuardBands(memBlockPtr);
     #endif
 
-    Lock();
-
-    LE_ASSERT(memBlockPtr->refCount != 0);
-
-    memBlockPtr->refCount++;
-
-    Unlock();
+    LE_ASSERT(__atomic_fetch_add(&memBlockPtr->refCount, 1, __ATOMIC_RELAXED) != 0);
 }
 
 
@@ -1019,9 +1325,7 @@ void le_mem_SetDestructor
 {
     LE_ASSERT(pool != NULL);
 
-    Lock();
-    pool->destructor = destructor;
-    Unlock();
+    __atomic_store_n(&pool->destructor, destructor, __ATOMIC_RELEASE);
 }
 
 
@@ -1043,11 +1347,13 @@ void le_mem_GetStats
 
     Lock();
 
-    statsPtr->numAllocs = pool->numAllocations;
+    size_t numBlocksInUse = __atomic_load_n(&pool->numBlocksInUse, __ATOMIC_RELAXED);
+
+    statsPtr->numAllocs = __atomic_load_n(&pool->numAllocations, __ATOMIC_RELAXED);
     statsPtr->numOverflows = pool->numOverflows;
-    statsPtr->numFree = pool->totalBlocks - pool->numBlocksInUse;
-    statsPtr->numBlocksInUse = pool->numBlocksInUse;
-    statsPtr->maxNumBlocksUsed = pool->maxNumBlocksUsed;
+    statsPtr->numFree = pool->totalBlocks - numBlocksInUse;
+    statsPtr->numBlocksInUse = numBlocksInUse;
+    statsPtr->maxNumBlocksUsed = __atomic_load_n(&pool->maxNumBlocksUsed, __ATOMIC_RELAXED);
 
     Unlock();
 }
@@ -1069,7 +1375,7 @@ void le_mem_ResetStats
     LE_ASSERT(pool != NULL);
 
     Lock();
-    pool->numAllocations = 0;
+    __atomic_store_n(&pool->numAllocations, 0, __ATOMIC_RELAXED);
     pool->numOverflows = 0;
     Unlock();
 }
@@ -1333,7 +1639,7 @@ void le_mem_DeleteSubPool
     // Make sure all sub-pool objects are free.
     le_mem_PoolRef_t superPool = subPool->superPoolPtr;
 
-    LE_FATAL_IF(subPool->numBlocksInUse != 0,
+    LE_FATAL_IF(__atomic_load_n(&subPool->numBlocksInUse, __ATOMIC_RELAXED) != 0,
                 "Subpool '%s' deleted while %zu blocks remain allocated.",
                 subPool->name,
                 subPool->numBlocksInUse);
@@ -1344,7 +1650,7 @@ void le_mem_DeleteSubPool
     MoveBlocks(superPool, subPool, numBlocks);
 
     // Update the superPool's block use count.
-    superPool->numBlocksInUse -= numBlocks;
+    __atomic_sub_fetch(&superPool->numBlocksInUse, numBlocks, __ATOMIC_RELAXED);
 
     // Remove the sub-pool from the list of sub-pools.
     PoolListChangeCount++;
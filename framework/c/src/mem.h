@@ -40,6 +40,10 @@ typedef struct le_mem_Pool
     size_t maxNumBlocksUsed;            ///< Maximum number of allocated blocks at any one time.
     size_t numBlocksToForce;            ///< Number of blocks that is added when Force Alloc
                                         ///  expands the pool.
+    size_t threadCacheSize;             ///< Maximum number of free blocks each thread may keep in
+                                        ///  its private cache (0 = per-thread caching disabled).
+    pthread_key_t threadCacheKey;       ///< Key to the calling thread's cache for this pool.
+                                        ///  Only valid if threadCacheSize is non-zero.
     #ifdef LE_MEM_TRACE
         le_log_TraceRef_t memTrace;     ///< If tracing is enabled, keeps track of a trace object
                                         ///  for this pool.
@@ -85,6 +85,12 @@
  * side.  For all other types of messages, this is set to 0 (NULL) to indicate that it does
  * not belong to a request-response transaction.
  *
+ * A server can ask for each of its sessions to have a bulk channel (see messagingBulk.c).  The
+ * server creates the channel's shared memory when the session opens and sends its file
+ * descriptor to the client along with the LE_OK "hello" message.  On such sessions, every
+ * message's header also carries a bulk data descriptor (offset and size) in front of the
+ * transaction identifier.
+ *
  * See also @ref serviceDirectoryProtocol.
  *
  * @warning The code in this subsystem @b must be thread safe and re-entrant.
@@ -94,6 +100,7 @@
 
 #include "legato.h"
 #include "serviceDirectory/serviceDirectoryProtocol.h"
+#include "messagingBulk.h"
 #include "messagingMessage.h"
 #include "messagingProtocol.h"
 #include "messagingSession.h"
@@ -116,6 +123,7 @@ void msg_Init
 //--------------------------------------------------------------------------------------------------
 {
     msgProto_Init();
+    msgBulk_Init();
     msgMessage_Init();
     msgInterface_Init();
     msgSession_Init();
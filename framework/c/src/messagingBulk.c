@@ -0,0 +1,545 @@
+/** @file messagingBulk.c
+ *
+ * @ref c_messaging implementation's "Bulk Channel" module implementation.
+ *
+ * See @ref messaging.c for an overview of the @ref c_messaging implementation.
+ *
+ * The shared memory is laid out like this:
+ *
+ * @verbatim
+ *
+ *   +--------+--------------------------------+--------------------------------+
+ *   | Header | Client-to-server ring          | Server-to-client ring          |
+ *   +--------+--------------------------------+--------------------------------+
+ *
+ * @endverbatim
+ *
+ * Each ring is a sequence of chunks, each starting with a Chunk Header.  Only the sender knows
+ * where the head and tail of its ring are; the receiver only ever sees the chunks it is told
+ * about in messages, and all it does with them is read them and then set their "free" flag.
+ * The sender then moves its tail past any free chunks the next time it allocates, so chunks can
+ * be freed in any order, but the space is only re-used in order.
+ *
+ * Because the other side of the session can write to any part of the shared memory, everything
+ * read from it (descriptors and chunk sizes) is range checked before it is used.
+ *
+ * @warning The code in this file @b must be thread safe and re-entrant.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+
+#include "legato.h"
+#include "messagingBulk.h"
+#include "fileDescriptor.h"
+#include <sys/mman.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+
+// =======================================
+//  PRIVATE DATA
+// =======================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes at the start of the shared memory that are used by the Shared Header.
+ * The rings start right after this.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEADER_BYTES 64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number stored in the Shared Header, to catch mapping something that isn't a bulk channel.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BULK_MAGIC 0x424C4B31   // "BLK1"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Chunk sizes and offsets are always multiples of this.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_ALIGN 8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest ring size allowed, so that offsets and sizes fit in a msgBulk_Desc_t.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RING_SIZE (1024 * 1024 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header at the start of the shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;     ///< BULK_MAGIC.
+    uint32_t ringSize;  ///< Size of each ring, in bytes.
+}
+SharedHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header at the start of each chunk in a ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t size;      ///< Size of the whole chunk, including this header, in bytes.
+    uint32_t isFree;    ///< Set non-zero when the chunk can be re-used by the sender.
+}
+ChunkHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bulk Channel object.  Holds one end's view of the shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct msgBulk_Channel
+{
+    uint8_t*    basePtr;    ///< Start of the shared memory mapping.
+    size_t      mapSize;    ///< Size of the mapping, in bytes.
+    size_t      ringSize;   ///< Size of each ring, in bytes.
+    uint8_t*    txRingPtr;  ///< Ring that this end sends on.
+    uint8_t*    rxRingPtr;  ///< Ring that this end receives on.
+    size_t      txHead;     ///< Offset in the tx ring at which the next chunk will be allocated.
+    size_t      txTail;     ///< Offset in the tx ring of the oldest chunk not yet reclaimed.
+    size_t      txUsed;     ///< Number of bytes in the tx ring not yet reclaimed.
+    bool        isCorrupt;  ///< true = the other side scribbled on a chunk header in the tx ring.
+}
+Channel_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Bulk Channel objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ChannelPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex used to protect the tx ring state of channels from multi-threaded race conditions.
+ *
+ * @note This is a pthreads FAST mutex, chosen to minimize overhead.  It is non-recursive.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK    LE_ASSERT(pthread_mutex_lock(&Mutex) == 0);
+#define UNLOCK  LE_ASSERT(pthread_mutex_unlock(&Mutex) == 0);
+
+
+// =======================================
+//  PRIVATE FUNCTIONS
+// =======================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor function for Bulk Channel objects.  Unmaps the shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChannelDestructor
+(
+    void* objPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Channel_t* channelPtr = objPtr;
+
+    if (munmap(channelPtr->basePtr, channelPtr->mapSize) != 0)
+    {
+        LE_ERROR("munmap() failed. Errno = %d (%m).", errno);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps the shared memory and creates a Bulk Channel object for it.
+ *
+ * @return A reference to the channel, or NULL if the mapping failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static Channel_t* MapChannel
+(
+    int fd,             ///< [IN] File descriptor of the shared memory.
+    size_t mapSize,     ///< [IN] Size of the shared memory, in bytes.
+    bool isServer       ///< [IN] true = this is the server end of the session.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    void* basePtr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (basePtr == MAP_FAILED)
+    {
+        LE_ERROR("mmap() failed. Errno = %d (%m).", errno);
+        return NULL;
+    }
+
+    Channel_t* channelPtr = le_mem_ForceAlloc(ChannelPoolRef);
+
+    channelPtr->basePtr = basePtr;
+    channelPtr->mapSize = mapSize;
+    channelPtr->ringSize = (mapSize - HEADER_BYTES) / 2;
+
+    uint8_t* clientToServerRingPtr = channelPtr->basePtr + HEADER_BYTES;
+    uint8_t* serverToClientRingPtr = clientToServerRingPtr + channelPtr->ringSize;
+
+    channelPtr->txRingPtr = isServer ? serverToClientRingPtr : clientToServerRingPtr;
+    channelPtr->rxRingPtr = isServer ? clientToServerRingPtr : serverToClientRingPtr;
+
+    channelPtr->txHead = 0;
+    channelPtr->txTail = 0;
+    channelPtr->txUsed = 0;
+    channelPtr->isCorrupt = false;
+
+    return channelPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves the tail of a channel's tx ring past any chunks that have been freed.
+ *
+ * @warning Assumes that the Mutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Reclaim
+(
+    Channel_t* channelPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (channelPtr->txUsed > 0)
+    {
+        ChunkHeader_t* chunkPtr = (ChunkHeader_t*)(channelPtr->txRingPtr + channelPtr->txTail);
+
+        if (!__atomic_load_n(&chunkPtr->isFree, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+
+        // The other side could have changed the size, so make sure it doesn't take us past
+        // the end of the ring or past the head.
+        size_t size = chunkPtr->size;
+        if (   (size < sizeof(ChunkHeader_t))
+            || ((size % CHUNK_ALIGN) != 0)
+            || (size > channelPtr->ringSize - channelPtr->txTail)
+            || (size > channelPtr->txUsed) )
+        {
+            LE_ERROR("Corrupted bulk data chunk header (size %zu at offset %zu).",
+                     size,
+                     channelPtr->txTail);
+            channelPtr->isCorrupt = true;
+            return;
+        }
+
+        channelPtr->txTail += size;
+        if (channelPtr->txTail == channelPtr->ringSize)
+        {
+            channelPtr->txTail = 0;
+        }
+        channelPtr->txUsed -= size;
+    }
+
+    // If the ring is empty, start again at the beginning so there's as much contiguous space
+    // as possible.
+    if (channelPtr->txUsed == 0)
+    {
+        channelPtr->txHead = 0;
+        channelPtr->txTail = 0;
+    }
+}
+
+
+// =======================================
+//  PROTECTED (INTER-MODULE) FUNCTIONS
+// =======================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes this module.  This must be called only once at start-up, before any other functions
+ * in this module are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgBulk_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ChannelPoolRef = le_mem_CreatePool("BulkChannel", sizeof(Channel_t));
+    le_mem_SetDestructor(ChannelPoolRef, ChannelDestructor);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a new Bulk Channel for the server side of a session.
+ *
+ * @return A reference to the channel, or NULL if shared memory couldn't be created.
+ *
+ * @note The caller must send the file descriptor to the client and then close it.
+ */
+//--------------------------------------------------------------------------------------------------
+msgBulk_ChannelRef_t msgBulk_CreateChannel
+(
+    size_t ringSize,    ///< [IN] Size of each ring, in bytes.
+    int* fdPtr          ///< [OUT] File descriptor of the shared memory.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (ringSize > MAX_RING_SIZE)
+    {
+        LE_WARN("Bulk channel size %zu reduced to %d.", ringSize, MAX_RING_SIZE);
+        ringSize = MAX_RING_SIZE;
+    }
+    ringSize = (ringSize + CHUNK_ALIGN - 1) & ~((size_t)CHUNK_ALIGN - 1);
+
+    size_t mapSize = HEADER_BYTES + (2 * ringSize);
+
+    int fd = syscall(SYS_memfd_create, "le_msg_bulk", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to create bulk channel memory. Errno = %d (%m).", errno);
+        return NULL;
+    }
+
+    if (ftruncate(fd, mapSize) != 0)
+    {
+        LE_ERROR("Failed to size bulk channel memory. Errno = %d (%m).", errno);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    Channel_t* channelPtr = MapChannel(fd, mapSize, true);
+    if (channelPtr == NULL)
+    {
+        fd_Close(fd);
+        return NULL;
+    }
+
+    SharedHeader_t* headerPtr = (SharedHeader_t*)channelPtr->basePtr;
+    headerPtr->magic = BULK_MAGIC;
+    headerPtr->ringSize = ringSize;
+
+    *fdPtr = fd;
+
+    return channelPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attaches the client side of a session to a Bulk Channel created by the server.
+ *
+ * @return A reference to the channel, or NULL if the shared memory couldn't be mapped.
+ *
+ * @note Always closes the file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+msgBulk_ChannelRef_t msgBulk_AttachChannel
+(
+    int fd              ///< [IN] File descriptor of the shared memory, received from the server.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Channel_t* channelPtr = NULL;
+    struct stat st;
+
+    if (fstat(fd, &st) != 0)
+    {
+        LE_ERROR("fstat() failed. Errno = %d (%m).", errno);
+    }
+    else if (   (st.st_size <= HEADER_BYTES)
+             || (((st.st_size - HEADER_BYTES) % (2 * CHUNK_ALIGN)) != 0)
+             || (((st.st_size - HEADER_BYTES) / 2) > MAX_RING_SIZE) )
+    {
+        LE_ERROR("Bulk channel memory has invalid size %lld.", (long long)st.st_size);
+    }
+    else
+    {
+        channelPtr = MapChannel(fd, st.st_size, false);
+
+        if (channelPtr != NULL)
+        {
+            SharedHeader_t* headerPtr = (SharedHeader_t*)channelPtr->basePtr;
+
+            if ((headerPtr->magic != BULK_MAGIC) || (headerPtr->ringSize != channelPtr->ringSize))
+            {
+                LE_ERROR("Bulk channel memory has an invalid header.");
+                le_mem_Release(channelPtr);
+                channelPtr = NULL;
+            }
+        }
+    }
+
+    fd_Close(fd);
+
+    return channelPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a chunk from the ring that this side of the session sends on.
+ *
+ * @return Pointer to the chunk's data, or NULL if there isn't enough room in the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+void* msgBulk_Alloc
+(
+    msgBulk_ChannelRef_t channelRef,    ///< [IN] The channel.
+    size_t numBytes,                    ///< [IN] Number of bytes of data.
+    msgBulk_Desc_t* descPtr             ///< [OUT] Descriptor to send to the other side.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Channel_t* channelPtr = channelRef;
+    ChunkHeader_t* chunkPtr = NULL;
+
+    if (numBytes > channelPtr->ringSize - sizeof(ChunkHeader_t))
+    {
+        return NULL;
+    }
+    size_t need = (sizeof(ChunkHeader_t) + numBytes + CHUNK_ALIGN - 1) & ~((size_t)CHUNK_ALIGN - 1);
+
+    LOCK
+
+    if (!channelPtr->isCorrupt)
+    {
+        Reclaim(channelPtr);
+    }
+
+    if (channelPtr->isCorrupt)
+    {
+        // Won't allocate anything more from this ring.
+    }
+    else if (channelPtr->txHead < channelPtr->txTail)
+    {
+        // Free space is between the head and the tail.
+        if (channelPtr->txTail - channelPtr->txHead >= need)
+        {
+            chunkPtr = (ChunkHeader_t*)(channelPtr->txRingPtr + channelPtr->txHead);
+        }
+    }
+    else if ((channelPtr->txHead > channelPtr->txTail) || (channelPtr->txUsed == 0))
+    {
+        // Free space is from the head to the end of the ring, plus from the start of the ring
+        // to the tail.
+        if (channelPtr->ringSize - channelPtr->txHead >= need)
+        {
+            chunkPtr = (ChunkHeader_t*)(channelPtr->txRingPtr + channelPtr->txHead);
+        }
+        else if (channelPtr->txTail >= need)
+        {
+            // Fill the end of the ring with a free chunk and wrap around to the start.
+            ChunkHeader_t* padPtr = (ChunkHeader_t*)(channelPtr->txRingPtr + channelPtr->txHead);
+            padPtr->size = channelPtr->ringSize - channelPtr->txHead;
+            padPtr->isFree = 1;
+            channelPtr->txUsed += padPtr->size;
+            channelPtr->txHead = 0;
+
+            chunkPtr = (ChunkHeader_t*)channelPtr->txRingPtr;
+        }
+    }
+    // Otherwise, the head has caught up with the tail, so the ring is full.
+
+    if (chunkPtr != NULL)
+    {
+        chunkPtr->size = need;
+        chunkPtr->isFree = 0;
+
+        descPtr->offset = channelPtr->txHead;
+        descPtr->size = numBytes;
+
+        channelPtr->txHead += need;
+        if (channelPtr->txHead == channelPtr->ringSize)
+        {
+            channelPtr->txHead = 0;
+        }
+        channelPtr->txUsed += need;
+    }
+
+    UNLOCK
+
+    return (chunkPtr == NULL) ? NULL : (chunkPtr + 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up a chunk of bulk data received from the other side of the session.
+ *
+ * @return Pointer to the chunk's data, or NULL if the descriptor is not valid.
+ */
+//--------------------------------------------------------------------------------------------------
+void* msgBulk_GetRxData
+(
+    msgBulk_ChannelRef_t channelRef,    ///< [IN] The channel.
+    const msgBulk_Desc_t* descPtr       ///< [IN] Descriptor received from the other side.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = descPtr->offset;
+    size_t size = descPtr->size;
+
+    if (   ((offset % CHUNK_ALIGN) != 0)
+        || (offset > channelRef->ringSize - sizeof(ChunkHeader_t))
+        || (size > channelRef->ringSize - sizeof(ChunkHeader_t) - offset) )
+    {
+        LE_ERROR("Invalid bulk data descriptor (offset %zu, size %zu).", offset, size);
+        return NULL;
+    }
+
+    return (ChunkHeader_t*)(channelRef->rxRingPtr + offset) + 1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a chunk is in the ring that this side of the session sends on.
+ *
+ * @return true if it was allocated by msgBulk_Alloc(), false if it was received.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgBulk_IsTxData
+(
+    msgBulk_ChannelRef_t channelRef,    ///< [IN] The channel.
+    const void* dataPtr                 ///< [IN] Chunk's data.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const uint8_t* bytePtr = dataPtr;
+
+    return (bytePtr >= channelRef->txRingPtr)
+        && (bytePtr < channelRef->txRingPtr + channelRef->ringSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks a chunk free, so that its sender can re-use the space.  Works for chunks in either ring.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgBulk_Free
+(
+    void* dataPtr                       ///< [IN] Chunk's data.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ChunkHeader_t* chunkPtr = (ChunkHeader_t*)dataPtr - 1;
+
+    __atomic_store_n(&chunkPtr->isFree, 1, __ATOMIC_RELEASE);
+}
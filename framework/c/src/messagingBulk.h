@@ -0,0 +1,139 @@
+/** @file messagingBulk.h
+ *
+ * @ref c_messaging implementation's "Bulk Channel" module's inter-module interface definitions.
+ *
+ * A bulk channel is a piece of shared memory (a memfd) that is mapped by both ends of a session.
+ * It holds two rings: one for bulk data sent from the client to the server and one for bulk
+ * data sent from the server to the client.  Only the sending side allocates from a ring.  The
+ * receiving side marks chunks free when it's finished with them, and the sending side reclaims
+ * free chunks the next time it allocates.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ */
+
+#ifndef LEGATO_MESSAGING_BULK_H_INCLUDE_GUARD
+#define LEGATO_MESSAGING_BULK_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a Bulk Channel object.
+ *
+ * Bulk Channel objects are reference counted using le_mem_AddRef() and le_mem_Release().  The
+ * shared memory is unmapped when the last reference is released.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct msgBulk_Channel* msgBulk_ChannelRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Describes a chunk of bulk data.  This is sent in front of the transaction ID of every message
+ * sent on a session that has a bulk channel.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t offset;    ///< Offset of the chunk in the sender's ring.
+    uint32_t size;      ///< Number of bytes of bulk data (0 = no bulk data).
+}
+msgBulk_Desc_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes this module.  This must be called only once at start-up, before any other functions
+ * in this module are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgBulk_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a new Bulk Channel for the server side of a session.
+ *
+ * @return A reference to the channel, or NULL if shared memory couldn't be created.
+ *
+ * @note The caller must send the file descriptor to the client and then close it.
+ */
+//--------------------------------------------------------------------------------------------------
+msgBulk_ChannelRef_t msgBulk_CreateChannel
+(
+    size_t ringSize,    ///< [IN] Size of each ring, in bytes.
+    int* fdPtr          ///< [OUT] File descriptor of the shared memory.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Attaches the client side of a session to a Bulk Channel created by the server.
+ *
+ * @return A reference to the channel, or NULL if the shared memory couldn't be mapped.
+ *
+ * @note Always closes the file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+msgBulk_ChannelRef_t msgBulk_AttachChannel
+(
+    int fd              ///< [IN] File descriptor of the shared memory, received from the server.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a chunk from the ring that this side of the session sends on.
+ *
+ * @return Pointer to the chunk's data, or NULL if there isn't enough room in the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+void* msgBulk_Alloc
+(
+    msgBulk_ChannelRef_t channelRef,    ///< [IN] The channel.
+    size_t numBytes,                    ///< [IN] Number of bytes of data.
+    msgBulk_Desc_t* descPtr             ///< [OUT] Descriptor to send to the other side.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up a chunk of bulk data received from the other side of the session.
+ *
+ * @return Pointer to the chunk's data, or NULL if the descriptor is not valid.
+ */
+//--------------------------------------------------------------------------------------------------
+void* msgBulk_GetRxData
+(
+    msgBulk_ChannelRef_t channelRef,    ///< [IN] The channel.
+    const msgBulk_Desc_t* descPtr       ///< [IN] Descriptor received from the other side.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a chunk is in the ring that this side of the session sends on.
+ *
+ * @return true if it was allocated by msgBulk_Alloc(), false if it was received.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgBulk_IsTxData
+(
+    msgBulk_ChannelRef_t channelRef,    ///< [IN] The channel.
+    const void* dataPtr                 ///< [IN] Chunk's data.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks a chunk free, so that its sender can re-use the space.  Works for chunks in either ring.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgBulk_Free
+(
+    void* dataPtr                       ///< [IN] Chunk's data.
+);
+
+
+#endif // LEGATO_MESSAGING_BULK_H_INCLUDE_GUARD
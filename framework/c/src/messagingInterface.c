@@ -13,6 +13,7 @@
 #include "unixSocket.h"
 #include "serviceDirectory/serviceDirectoryProtocol.h"
 #include "messagingInterface.h"
+#include "messagingBulk.h"
 #include "messagingSession.h"
 #include "fileDescriptor.h"
 
@@ -31,6 +32,20 @@
 /// Highest number of Client Interfaces that are expected to be referred to in a single process.
 #define MAX_EXPECTED_CLIENT_INTERFACES    32
 
+#ifdef LE_MSG_DIRECT_CONNECT
+/// Highest number of direct endpoints that a Service will open for its clients.
+#define MAX_DIRECT_ENDPOINTS_PER_SERVICE  16
+
+/// Number of random bytes in the name of a direct endpoint.
+#define DIRECT_NAME_RANDOM_BYTES    12
+
+/// Prefix of the name of a direct endpoint.
+#define DIRECT_NAME_PREFIX  "le_msg."
+
+/// Number of connections that can be waiting to be accepted on a direct endpoint.
+#define DIRECT_LISTEN_BACKLOG   8
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Hashmap in which Service objects are kept.
@@ -89,6 +104,63 @@ static le_mem_PoolRef_t ClientInterfacePoolRef;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  HandlerEventPoolRef;
 
+#ifdef LE_MSG_DIRECT_CONNECT
+//--------------------------------------------------------------------------------------------------
+/**
+ * Direct endpoint.  A listening socket opened by a server for one client user's interface, so
+ * that client can open sessions without going through the Service Directory.
+ * See @ref serviceDirectoryProtocol_Direct.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t           link;           ///< Used to link onto the Service's endpoint list.
+    msgInterface_Service_t* servicePtr;     ///< The Service that the endpoint is for.
+    uid_t                   clientUid;      ///< The only client user allowed to connect.
+    char    clientInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES]; ///< Client's interface name.
+    char    name[MSG_INTERFACE_DIRECT_NAME_BYTES];  ///< Name of the socket (abstract namespace).
+    int                     fd;             ///< File descriptor of the listening socket.
+    le_fdMonitor_Ref_t      fdMonitorRef;   ///< File descriptor monitor for the listening socket.
+}
+DirectEndpoint_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Direct Endpoint objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DirectEndpointPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client-side record of a client interface that sessions have been opened on, along with the
+ * direct endpoint that the server gave us for it, if any.  These outlive the Client Interface
+ * objects, because the clients that benefit are the ones that keep deleting and re-creating their
+ * sessions.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    msgInterface_Id_t   id;                                     ///< The client interface.
+    char                directName[MSG_INTERFACE_DIRECT_NAME_BYTES]; ///< Endpoint ("" if none).
+}
+DirectCacheEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Direct Cache Entries are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DirectCachePoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hashmap in which Direct Cache Entries are kept.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t DirectCacheMapRef;
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mutex used to protect data structures in this module from multi-threaded race conditions.
@@ -239,6 +311,12 @@ static msgInterface_Service_t* CreateService
     // Initialize the open handlers dls
     servicePtr->openListPtr = LE_DLS_LIST_INIT;
 
+    servicePtr->bulkChannelSize = 0;
+
+#ifdef LE_MSG_DIRECT_CONNECT
+    servicePtr->directEndpointList = LE_DLS_LIST_INIT;
+#endif
+
     ServiceObjMapChangeCount++;
     le_hashmap_Put(ServiceMapRef, &servicePtr->interface.id, servicePtr);
 
@@ -458,6 +536,283 @@ static void CallOpenHandler
 }
 
 
+#ifdef LE_MSG_DIRECT_CONNECT
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a direct endpoint and deletes it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseDirectEndpoint
+(
+    DirectEndpoint_t* endpointPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Remove(&endpointPtr->servicePtr->directEndpointList, &endpointPtr->link);
+
+    le_fdMonitor_Delete(endpointPtr->fdMonitorRef);
+    fd_Close(endpointPtr->fd);
+
+    le_mem_Release(endpointPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds a Service's direct endpoint for a given client user's interface.
+ *
+ * @return Pointer to the endpoint, or NULL if there isn't one.
+ */
+//--------------------------------------------------------------------------------------------------
+static DirectEndpoint_t* FindDirectEndpoint
+(
+    msgInterface_Service_t* servicePtr,
+    uid_t clientUid,
+    const char* clientInterfaceName
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&servicePtr->directEndpointList);
+
+    while (linkPtr != NULL)
+    {
+        DirectEndpoint_t* endpointPtr = CONTAINER_OF(linkPtr, DirectEndpoint_t, link);
+
+        if (   (endpointPtr->clientUid == clientUid)
+            && (strcmp(endpointPtr->clientInterfaceName, clientInterfaceName) == 0) )
+        {
+            return endpointPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&servicePtr->directEndpointList, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler function called when a client connects to a direct endpoint.
+ *
+ * The connection is only accepted from the client user that the endpoint was opened for.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DirectEndpointEventHandler
+(
+    int     fd,
+    short   events
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DirectEndpoint_t* endpointPtr = le_fdMonitor_GetContextPtr();
+    msgInterface_Service_t* servicePtr = endpointPtr->servicePtr;
+
+    LE_ASSERT(fd == endpointPtr->fd);
+
+    if (!(events & POLLIN))
+    {
+        LE_ERROR("Error on direct endpoint of service (%s:%s).",
+                 servicePtr->interface.id.name,
+                 le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef));
+
+        // The client will go back to opening sessions through the Service Directory.
+        CloseDirectEndpoint(endpointPtr);
+        return;
+    }
+
+    int clientSocketFd;
+    do
+    {
+        clientSocketFd = accept4(fd, NULL, NULL, SOCK_CLOEXEC);
+    }
+    while ((clientSocketFd == -1) && (errno == EINTR));
+
+    if (clientSocketFd == -1)
+    {
+        // The client may have given up already.
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != ECONNABORTED))
+        {
+            LE_ERROR("accept() failed on direct endpoint. Errno = %d (%m).", errno);
+        }
+        return;
+    }
+
+    struct ucred credentials;
+    socklen_t credSize = sizeof(credentials);
+    if (getsockopt(clientSocketFd, SOL_SOCKET, SO_PEERCRED, &credentials, &credSize) != 0)
+    {
+        LE_ERROR("getsockopt() failed on direct connection. Errno = %d (%m).", errno);
+        fd_Close(clientSocketFd);
+        return;
+    }
+
+    if (credentials.uid != endpointPtr->clientUid)
+    {
+        LE_WARN("Refused direct connection to service (%s:%s) from uid %u (pid %d).",
+                servicePtr->interface.id.name,
+                le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef),
+                credentials.uid,
+                credentials.pid);
+        fd_Close(clientSocketFd);
+        return;
+    }
+
+    // Create a server-side Session object for that connection to this Service.
+    le_msg_SessionRef_t sessionRef = msgSession_CreateServerSideSession(servicePtr,
+                                                                        clientSocketFd,
+                                                                        NULL);
+
+    // If successful, call the registered "open" handler, if there is one.
+    if (sessionRef != NULL)
+    {
+        CallOpenHandler(servicePtr, sessionRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fills a buffer with random bytes.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetRandomBytes
+(
+    uint8_t* buffPtr,
+    size_t buffSize
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        LE_ERROR("Failed to open /dev/urandom. Errno = %d (%m).", errno);
+        return LE_FAULT;
+    }
+
+    ssize_t bytesRead = fd_ReadSize(fd, buffPtr, buffSize);
+
+    fd_Close(fd);
+
+    return (bytesRead == (ssize_t)buffSize) ? LE_OK : LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a Service's direct endpoint for a given client user's interface, opening one if there
+ * isn't one already.
+ *
+ * The endpoint's name is random only so that it doesn't clash with other endpoints.  It is not a
+ * secret; the uid check in DirectEndpointEventHandler() is what keeps other users out.
+ *
+ * @return The name of the endpoint, or NULL if there is none (the client will keep opening its
+ *         sessions through the Service Directory).
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* OpenDirectEndpoint
+(
+    msgInterface_Service_t* servicePtr,
+    uid_t clientUid,
+    const char* clientInterfaceName
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DirectEndpoint_t* endpointPtr = FindDirectEndpoint(servicePtr, clientUid, clientInterfaceName);
+
+    if (endpointPtr != NULL)
+    {
+        return endpointPtr->name;
+    }
+
+    if (le_dls_NumLinks(&servicePtr->directEndpointList) >= MAX_DIRECT_ENDPOINTS_PER_SERVICE)
+    {
+        LE_DEBUG("Too many direct endpoints for service (%s:%s).",
+                 servicePtr->interface.id.name,
+                 le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef));
+        return NULL;
+    }
+
+    uint8_t randomBytes[DIRECT_NAME_RANDOM_BYTES];
+    if (GetRandomBytes(randomBytes, sizeof(randomBytes)) != LE_OK)
+    {
+        return NULL;
+    }
+
+    char name[MSG_INTERFACE_DIRECT_NAME_BYTES] = DIRECT_NAME_PREFIX;
+    size_t prefixLen = sizeof(DIRECT_NAME_PREFIX) - 1;
+    LE_ASSERT(le_hex_BinaryToString(randomBytes,
+                                    sizeof(randomBytes),
+                                    name + prefixLen,
+                                    sizeof(name) - prefixLen) > 0);
+
+    int fd = unixSocket_CreateSeqPacketAbstract(name);
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to create direct endpoint (%s).", LE_RESULT_TXT(fd));
+        return NULL;
+    }
+
+    if (listen(fd, DIRECT_LISTEN_BACKLOG) != 0)
+    {
+        LE_ERROR("listen() failed on direct endpoint. Errno = %d (%m).", errno);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    fd_SetNonBlocking(fd);
+
+    endpointPtr = le_mem_ForceAlloc(DirectEndpointPoolRef);
+    endpointPtr->link = LE_DLS_LINK_INIT;
+    endpointPtr->servicePtr = servicePtr;
+    endpointPtr->clientUid = clientUid;
+    le_utf8_Copy(endpointPtr->clientInterfaceName,
+                 clientInterfaceName,
+                 sizeof(endpointPtr->clientInterfaceName),
+                 NULL);
+    le_utf8_Copy(endpointPtr->name, name, sizeof(endpointPtr->name), NULL);
+    endpointPtr->fd = fd;
+    endpointPtr->fdMonitorRef = le_fdMonitor_Create(name,
+                                                    fd,
+                                                    DirectEndpointEventHandler,
+                                                    POLLIN);
+    le_fdMonitor_SetContextPtr(endpointPtr->fdMonitorRef, endpointPtr);
+
+    le_dls_Queue(&servicePtr->directEndpointList, &endpointPtr->link);
+
+    LE_DEBUG("Opened direct endpoint for uid %u interface '%s' on service (%s:%s).",
+             clientUid,
+             clientInterfaceName,
+             servicePtr->interface.id.name,
+             le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef));
+
+    return endpointPtr->name;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes all of a Service's direct endpoints.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseAllDirectEndpoints
+(
+    msgInterface_Service_t* servicePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Peek(&servicePtr->directEndpointList)) != NULL)
+    {
+        CloseDirectEndpoint(CONTAINER_OF(linkPtr, DirectEndpoint_t, link));
+    }
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event handler function called when a Service's directorySocketFd becomes writeable.
@@ -526,7 +881,7 @@ static void DirectorySocketWriteable
  * Event handler function called when a Service's directorySocketFd becomes readable.
  *
  * This means that the Service Directory has sent us the file descriptor of an authenticated
- * client connection socket.
+ * client connection socket, or has revoked a client's direct endpoint.
  */
 //--------------------------------------------------------------------------------------------------
 static void DirectorySocketReadable
@@ -537,12 +892,14 @@ static void DirectorySocketReadable
 {
     le_result_t result;
 
+    svcdir_ServerMsg_t msg;
+    size_t msgSize = sizeof(msg);
     int clientSocketFd;
 
     // Receive the Client connection file descriptor from the Service Directory.
     result = unixSocket_ReceiveMsg(servicePtr->directorySocketFd,
-                                   NULL,   // dataBuffPtr
-                                   0,      // dataBuffSize
+                                   &msg,
+                                   &msgSize,
                                    &clientSocketFd,
                                    NULL);  // credPtr
     if (result == LE_CLOSED)
@@ -555,6 +912,36 @@ static void DirectorySocketReadable
                  result,
                  LE_RESULT_TXT(result));
     }
+    else if (msgSize != sizeof(msg))
+    {
+        LE_FATAL("Unexpected message size (%zu) from Service Directory for (%s:%s).",
+                 msgSize,
+                 servicePtr->interface.id.name,
+                 le_msg_GetProtocolIdStr(servicePtr->interface.id.protocolRef));
+    }
+#ifdef LE_MSG_DIRECT_CONNECT
+    else if (msg.type == SVCDIR_SERVER_MSG_REVOKE)
+    {
+        msg.clientInterfaceName[sizeof(msg.clientInterfaceName) - 1] = '\0';
+
+        DirectEndpoint_t* endpointPtr = FindDirectEndpoint(servicePtr,
+                                                           msg.clientUid,
+                                                           msg.clientInterfaceName);
+        if (endpointPtr != NULL)
+        {
+            LE_DEBUG("Closing direct endpoint for uid %u interface '%s'.",
+                     msg.clientUid,
+                     msg.clientInterfaceName);
+
+            CloseDirectEndpoint(endpointPtr);
+        }
+
+        if (clientSocketFd >= 0)
+        {
+            fd_Close(clientSocketFd);
+        }
+    }
+#endif
     else if (clientSocketFd < 0)
     {
         LE_ERROR("Received something other than a file descriptor from Service Directory for (%s:%s).",
@@ -570,9 +957,21 @@ static void DirectorySocketReadable
     }
     else
     {
+        // If the client wants to connect directly from now on, give it an endpoint to connect to.
+        const char* directNamePtr = NULL;
+#ifdef LE_MSG_DIRECT_CONNECT
+        if (msg.type == SVCDIR_SERVER_MSG_CONNECT_DIRECT)
+        {
+            msg.clientInterfaceName[sizeof(msg.clientInterfaceName) - 1] = '\0';
+
+            directNamePtr = OpenDirectEndpoint(servicePtr, msg.clientUid, msg.clientInterfaceName);
+        }
+#endif
+
         // Create a server-side Session object for that connection to this Service.
         le_msg_SessionRef_t sessionRef = msgSession_CreateServerSideSession(servicePtr,
-                                                                            clientSocketFd);
+                                                                            clientSocketFd,
+                                                                            directNamePtr);
 
         // If successful, call the registered "open" handler, if there is one.
         if (sessionRef != NULL)
@@ -819,6 +1218,13 @@ void msgInterface_Init
     // Create safe reference map for add references.
     HandlersRefMap = le_ref_CreateMap("HandlersRef", MAX_EXPECTED_SERVICES*6);
 
+#ifdef LE_MSG_DIRECT_CONNECT
+    // Create the pools of direct endpoints (server side) and Direct Cache Entries (client side).
+    DirectEndpointPoolRef = le_mem_CreatePool("MessagingDirectEndpoints",
+                                              sizeof(DirectEndpoint_t));
+    DirectCachePoolRef = le_mem_CreatePool("MessagingDirectCache", sizeof(DirectCacheEntry_t));
+#endif
+
     // Create the Service Map.
     ServiceMapRef = le_hashmap_Create("MessagingServices",
                                       MAX_EXPECTED_SERVICES,
@@ -831,6 +1237,14 @@ void msgInterface_Init
                                               ComputeInterfaceIdHash,
                                               AreInterfaceIdsTheSame);
 
+#ifdef LE_MSG_DIRECT_CONNECT
+    // Create the Direct Cache.
+    DirectCacheMapRef = le_hashmap_Create("MessagingDirectCache",
+                                          MAX_EXPECTED_CLIENT_INTERFACES,
+                                          ComputeInterfaceIdHash,
+                                          AreInterfaceIdsTheSame);
+#endif
+
     // Create the key to be used to identify thread-local data records containing the Message
     // Reference when running a Service's message receive handler.
     int result = pthread_key_create(&ThreadLocalRxMsgKey, NULL);
@@ -894,6 +1308,91 @@ void msgInterface_GetInterfaceDetails
 }
 
 
+#ifdef LE_MSG_DIRECT_CONNECT
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up the direct endpoint that the server gave this process for a client interface.
+ *
+ * No endpoint is asked for the first time an interface is opened, as most clients only open each
+ * of their interfaces once.
+ *
+ * @return
+ * - LE_OK if an endpoint is known (its name is copied into the buffer).
+ * - LE_NOT_FOUND if none is known, but one should be asked for.
+ * - LE_UNAVAILABLE if none is known and none should be asked for.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgInterface_GetDirectEndpoint
+(
+    le_msg_InterfaceRef_t interfaceRef, ///< [in] The client interface.
+    char* nameBuffPtr,                  ///< [out] Buffer for the name of the endpoint.
+    size_t nameBuffSize                 ///< [in] Size of the buffer, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+
+    LOCK
+
+    DirectCacheEntry_t* entryPtr = le_hashmap_Get(DirectCacheMapRef, &interfaceRef->id);
+
+    if (entryPtr == NULL)
+    {
+        entryPtr = le_mem_ForceAlloc(DirectCachePoolRef);
+        entryPtr->id = interfaceRef->id;
+        entryPtr->directName[0] = '\0';
+        le_hashmap_Put(DirectCacheMapRef, &entryPtr->id, entryPtr);
+
+        result = LE_UNAVAILABLE;
+    }
+    else if (entryPtr->directName[0] == '\0')
+    {
+        result = LE_NOT_FOUND;
+    }
+    else
+    {
+        result = le_utf8_Copy(nameBuffPtr, entryPtr->directName, nameBuffSize, NULL);
+    }
+
+    UNLOCK
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records the direct endpoint that the server gave this process for a client interface, or forgets
+ * it when the server no longer accepts connections on it.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_SetDirectEndpoint
+(
+    le_msg_InterfaceRef_t interfaceRef, ///< [in] The client interface.
+    const char* namePtr                 ///< [in] Name of the endpoint, or NULL to forget it.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LOCK
+
+    // The entry was created when the session was opened.
+    DirectCacheEntry_t* entryPtr = le_hashmap_Get(DirectCacheMapRef, &interfaceRef->id);
+
+    if (entryPtr != NULL)
+    {
+        if (   (namePtr == NULL)
+            || (le_utf8_Copy(entryPtr->directName, namePtr, sizeof(entryPtr->directName), NULL)
+                != LE_OK) )
+        {
+            entryPtr->directName[0] = '\0';
+        }
+    }
+
+    UNLOCK
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Release a reference to an Interface. Note that this can also be (and is meant to be) used with
@@ -1253,6 +1752,33 @@ void le_msg_SetServiceRecvHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives each session that clients open with this service a bulk channel: shared memory through
+ * which large amounts of data can be passed with messages.  See @ref c_messagingBulkData.
+ *
+ * Only affects sessions opened after this is called.
+ *
+ * @note    This is a server-only function.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetServiceBulkChannelSize
+(
+    le_msg_ServiceRef_t     serviceRef, ///< [in] Reference to the service.
+    size_t                  numBytes    ///< [in] Bytes of bulk data that can be in transit in
+                                        ///       each direction at once (0 = no bulk channel).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
+                "Service (%s:%s) not owned by calling thread.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    serviceRef->bulkChannelSize = numBytes;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
@@ -1383,6 +1909,11 @@ void le_msg_HideService
     fd_Close(serviceRef->directorySocketFd);
     serviceRef->directorySocketFd = -1;
 
+#ifdef LE_MSG_DIRECT_CONNECT
+    // Revocations can't be received any more, so stop accepting direct connections too.
+    CloseAllDirectEndpoints(serviceRef);
+#endif
+
     serviceRef->state = LE_MSG_INTERFACE_SERVICE_HIDDEN;
 }
 
@@ -14,6 +14,15 @@
 #include "serviceDirectory/serviceDirectoryProtocol.h"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the name of a direct endpoint (see @ref serviceDirectoryProtocol_Direct), in bytes,
+ * including the null-terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_INTERFACE_DIRECT_NAME_BYTES 32
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The interface type that an generic Interface object represents.
@@ -94,6 +103,14 @@ typedef struct le_msg_Service
 
     le_dls_List_t                   closeListPtr; ///< open List: list of close session handlers
                                                   ///  called when a session is opened
+
+    size_t                          bulkChannelSize; ///< Size of each ring in the bulk channel
+                                                     ///  created for each session (0 = none).
+
+#ifdef LE_MSG_DIRECT_CONNECT
+    le_dls_List_t                   directEndpointList; ///< Direct endpoints opened for clients
+                                                        ///  (while advertised).
+#endif
 }
 msgInterface_Service_t;
 
@@ -195,6 +212,42 @@ void msgInterface_GetInterfaceDetails
 );
 
 
+#ifdef LE_MSG_DIRECT_CONNECT
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up the direct endpoint that the server gave this process for a client interface.
+ *
+ * No endpoint is asked for the first time an interface is opened, as most clients only open each
+ * of their interfaces once.
+ *
+ * @return
+ * - LE_OK if an endpoint is known (its name is copied into the buffer).
+ * - LE_NOT_FOUND if none is known, but one should be asked for.
+ * - LE_UNAVAILABLE if none is known and none should be asked for.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgInterface_GetDirectEndpoint
+(
+    le_msg_InterfaceRef_t interfaceRef, ///< [in] The client interface.
+    char* nameBuffPtr,                  ///< [out] Buffer for the name of the endpoint.
+    size_t nameBuffSize                 ///< [in] Size of the buffer, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records the direct endpoint that the server gave this process for a client interface, or forgets
+ * it when the server no longer accepts connections on it.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgInterface_SetDirectEndpoint
+(
+    le_msg_InterfaceRef_t interfaceRef, ///< [in] The client interface.
+    const char* namePtr                 ///< [in] Name of the endpoint, or NULL to forget it.
+);
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get a reference to the Protocol that an Interface is running.
@@ -8,6 +8,7 @@
  */
 
 #include "legato.h"
+#include "messagingBulk.h"
 #include "messagingMessage.h"
 #include "messagingProtocol.h"
 #include "messagingSession.h"
@@ -19,6 +20,30 @@
 //  PRIVATE FUNCTIONS
 // =======================================
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases a Message object's hold on any bulk data, marking the bulk data's chunk free.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseBulkData
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (msgPtr->bulkDataPtr != NULL)
+    {
+        msgBulk_Free(msgPtr->bulkDataPtr);
+        le_mem_Release(msgPtr->bulkChannelRef);
+
+        msgPtr->bulkChannelRef = NULL;
+        msgPtr->bulkDataPtr = NULL;
+    }
+    msgPtr->bulkDesc.offset = 0;
+    msgPtr->bulkDesc.size = 0;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Destructor function for Message objects.
@@ -62,11 +87,200 @@ static void MessageDestructor
         fd_Close(msgPtr->fd);
     }
 
+    // Free any bulk data that was received, or allocated but never sent.
+    ReleaseBulkData(msgPtr);
+
     // Release the Message object's hold on the Session object.
     le_mem_Release(msgPtr->sessionRef);
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message, with a payload buffer of at least a given size, to be sent over a given
+ * session.
+ *
+ * @return  The message reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t CreateMsg
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t payloadSize              ///< [in] Payload buffer size needed (<= protocol maximum).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Get a reference to the Session's Protocol and ask the Protocol to allocate a Message
+    // object from the smallest of its Message Pools that is big enough.
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
+    Message_t* msgPtr = msgProto_AllocMessage(protocolRef, &payloadSize);
+
+    // Initialize the Message object's data members.
+    msgPtr->link = LE_DLS_LINK_INIT;
+    msgPtr->sessionRef = sessionRef;
+    le_mem_AddRef(sessionRef);  // Message object holds a reference to the Session object.
+
+    msgInterface_Type_t interfaceType = msgSession_GetInterfaceType(sessionRef);
+    switch (interfaceType)
+    {
+        case LE_MSG_INTERFACE_CLIENT:
+            msgPtr->clientServer.client.completionCallback = NULL;
+            msgPtr->clientServer.client.contextPtr = NULL;
+            break;
+
+        case LE_MSG_INTERFACE_SERVER:
+            msgPtr->clientServer.server.responseFd = -1;
+            break;
+
+        default:
+            LE_FATAL("Unhandled interface type (%d).", interfaceType);
+    }
+
+    msgPtr->fd = -1;
+    msgPtr->bulkChannelRef = NULL;
+    msgPtr->bulkDataPtr = NULL;
+    msgPtr->bulkDesc.offset = 0;
+    msgPtr->bulkDesc.size = 0;
+    msgPtr->txnId = 0;
+    msgPtr->maxPayloadSize = payloadSize;
+    msgPtr->payloadSize = payloadSize;
+    memset(msgPtr->payload, 0, payloadSize);
+
+    return msgPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the part of a Message object that is to be sent over the socket.
+ *
+ * The first bytes come from the transaction ID and the rest (if any) from the payload section,
+ * which comes right after the transaction ID.  Only the part of the payload that is in use is
+ * sent.  If the session has a bulk channel, the bulk data descriptor goes in front of that.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetTxData
+(
+    Message_t*  msgPtr,     ///< [IN] The Message to be sent.
+    void**      dataPtrPtr, ///< [OUT] Start of the data to send.
+    size_t*     sizePtr     ///< [OUT] Number of bytes to send.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    *dataPtrPtr = &msgPtr->txnId;
+    *sizePtr = sizeof(msgPtr->txnId) + msgPtr->payloadSize;
+
+    // Only bulk data allocated from this session's current channel can be sent; anything else
+    // (e.g., bulk data that came with a request being responded to) is freed now.
+    msgBulk_ChannelRef_t channelRef = msgSession_GetBulkChannel(msgPtr->sessionRef);
+    if (channelRef != NULL)
+    {
+        if (   (msgPtr->bulkDataPtr != NULL)
+            && (   (msgPtr->bulkChannelRef != channelRef)
+                || !msgBulk_IsTxData(channelRef, msgPtr->bulkDataPtr) ) )
+        {
+            ReleaseBulkData(msgPtr);
+        }
+
+        *dataPtrPtr = &msgPtr->bulkDesc;
+        *sizePtr += sizeof(msgPtr->bulkDesc);
+    }
+    else
+    {
+        ReleaseBulkData(msgPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates a Message object after it has been sent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TxDone
+(
+    Message_t*  msgPtr      ///< [IN] The Message that was sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Once sent, the bulk data belongs to the receiver, which will free it when it's finished.
+    if (msgPtr->bulkDataPtr != NULL)
+    {
+        le_mem_Release(msgPtr->bulkChannelRef);
+        msgPtr->bulkChannelRef = NULL;
+        msgPtr->bulkDataPtr = NULL;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the part of a Message object that a received message is to be stored in.
+ *
+ * The first bytes go into the transaction ID and the rest (if any) into the payload section.
+ * The sender may have sent less than a full payload, in which case the rest of the payload buffer
+ * is left zeroed.  If the session has a bulk channel, a bulk data descriptor comes first.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetRxBuffer
+(
+    Message_t*  msgPtr,     ///< [IN] The Message to receive into.
+    void**      buffPtrPtr, ///< [OUT] Start of the buffer.
+    size_t*     sizePtr     ///< [OUT] Size of the buffer, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    *buffPtrPtr = &msgPtr->txnId;
+    *sizePtr = sizeof(msgPtr->txnId) + msgPtr->maxPayloadSize;
+
+    if (msgSession_GetBulkChannel(msgPtr->sessionRef) != NULL)
+    {
+        *buffPtrPtr = &msgPtr->bulkDesc;
+        *sizePtr += sizeof(msgPtr->bulkDesc);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates a Message object after a message has been received into it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RxDone
+(
+    Message_t*  msgPtr,     ///< [IN] The Message that was received.
+    le_result_t result      ///< [IN] Result of the receive operation.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (msgSession_GetInterfaceType(msgPtr->sessionRef) == LE_MSG_INTERFACE_SERVER)
+    {
+        msgPtr->clientServer.server.responseFd = -1;
+    }
+
+    // Find the bulk data, if any was sent.  The message holds a reference to the channel for as
+    // long as it holds the bulk data.
+    msgBulk_ChannelRef_t channelRef = msgSession_GetBulkChannel(msgPtr->sessionRef);
+    if ((result == LE_OK) && (channelRef != NULL) && (msgPtr->bulkDesc.size > 0))
+    {
+        msgPtr->bulkDataPtr = msgBulk_GetRxData(channelRef, &msgPtr->bulkDesc);
+
+        if (msgPtr->bulkDataPtr != NULL)
+        {
+            le_mem_AddRef(channelRef);
+            msgPtr->bulkChannelRef = channelRef;
+        }
+        else
+        {
+            msgPtr->bulkDesc.size = 0;
+        }
+    }
+
+    // Unless told otherwise, a response or forwarded message will be sent with the whole payload.
+    msgPtr->payloadSize = msgPtr->maxPayloadSize;
+}
+
+
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
 // =======================================
@@ -83,7 +297,9 @@ void msgMessage_Init
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Don't actually need to do anything here.
+    // The bulk data descriptor is sent and received together with the transaction ID, so they
+    // must be next to each other.
+    LE_ASSERT(offsetof(Message_t, txnId) == offsetof(Message_t, bulkDesc) + sizeof(msgBulk_Desc_t));
 }
 
 
@@ -142,29 +358,67 @@ le_result_t msgMessage_Send
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If this is a response message,
-    if (le_msg_NeedsResponse(msgPtr))
+    void* dataPtr;
+    size_t dataSize;
+
+    GetTxData(msgPtr, &dataPtr, &dataSize);
+
+    le_result_t result = unixSocket_SendMsg(socketFd,
+                                            dataPtr,
+                                            dataSize,
+                                            msgPtr->fd,
+                                            false   ); // Don't send process credentials.
+    if (result == LE_OK)
     {
-        // If there was an fd that was received from the client but not fetched from the message
-        // generate a warning and close that fd.
-        if (msgPtr->fd >= 0)
-        {
-            LE_WARN("File descriptor not retrieved from message received from client.");
-            fd_Close(msgPtr->fd);
-        }
+        TxDone(msgPtr);
+    }
 
-        // Move the responseFd to the normal fd position in the message object.
-        msgPtr->fd = msgPtr->clientServer.server.responseFd;
-        msgPtr->clientServer.server.responseFd = -1;
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a batch of messages over a connected socket in a single system call.
+ *
+ * If the socket runs out of buffer space part way through the batch, only the first messages are
+ * sent.  The caller still owns all of the Message objects.
+ *
+ * @return
+ * - LE_OK if at least one message was sent (check *numSentPtr for how many).
+ * - LE_NO_MEMORY if the socket doesn't have enough send buffer space available right now.
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_SendBatch
+(
+    int         socketFd,   ///< [IN] Connected socket's file descriptor.
+    Message_t** msgPtrs,    ///< [IN] The Messages to be sent.
+    size_t      numMsgs,    ///< [IN] Number of Messages (at most UNIX_SOCKET_MAX_BATCH).
+    size_t*     numSentPtr  ///< [OUT] Number of Messages sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    unixSocket_BatchMsg_t batch[UNIX_SOCKET_MAX_BATCH];
+    size_t i;
+
+    LE_ASSERT(numMsgs <= UNIX_SOCKET_MAX_BATCH);
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        GetTxData(msgPtrs[i], &batch[i].dataPtr, &batch[i].dataSize);
+        batch[i].fd = msgPtrs[i]->fd;
+    }
+
+    le_result_t result = unixSocket_SendMsgBatch(socketFd, batch, numMsgs, numSentPtr);
+
+    for (i = 0; i < *numSentPtr; i++)
+    {
+        TxDone(msgPtrs[i]);
     }
 
-    // The first bytes come from our transaction ID and the rest (if any)
-    // from our Message object's payload section, which comes right after the transaction ID.
-    return unixSocket_SendMsg(  socketFd,
-                                &msgPtr->txnId,
-                                sizeof(msgPtr->txnId) + le_msg_GetMaxPayloadSize(msgPtr),
-                                msgPtr->fd,
-                                false   ); // Don't send process credentials.
+    return result;
 }
 
 
@@ -186,20 +440,96 @@ le_result_t msgMessage_Receive
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Receive the first bytes into our transaction ID and the rest (if any)
-    // into our Message object's payload section.
-    size_t byteCount = sizeof(msgRef->txnId) + le_msg_GetMaxPayloadSize(msgRef);
+    void* buffPtr;
+    size_t byteCount;
+
+    GetRxBuffer(msgRef, &buffPtr, &byteCount);
+
     le_result_t result = unixSocket_ReceiveMsg( socketFd,
-                                                &msgRef->txnId,
+                                                buffPtr,
                                                 &byteCount,
                                                 &msgRef->fd,
                                                 NULL    );  // Don't receive credentials.
-    if (msgSession_GetInterfaceType(msgRef->sessionRef) == LE_MSG_INTERFACE_SERVER)
+    RxDone(msgRef, result);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive a batch of messages from a connected socket in a single system call, without blocking.
+ *
+ * The messages that were received successfully are moved to the front of the array, in the order
+ * they were received.  Messages that didn't fit into their Message objects are discarded.
+ *
+ * @return
+ * - LE_OK if at least one message was received (check *numReceivedPtr for how many were kept).
+ *         If fewer messages than asked for were received, the socket has been drained.
+ * - LE_WOULD_BLOCK if there's nothing there to receive.
+ * - LE_CLOSED if the connection has closed.
+ * - LE_FAULT if an error was encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_ReceiveBatch
+(
+    int                  socketFd,      ///< [IN] The socket's file descriptor.
+    le_msg_MessageRef_t* msgRefs,       ///< [IN+OUT] Message objects to store the messages in.
+    size_t               numMsgs,       ///< [IN] Number of Message objects (at most
+                                        ///       UNIX_SOCKET_MAX_BATCH).
+    size_t*              numReceivedPtr,///< [OUT] Number of messages kept.
+    size_t*              numReadPtr     ///< [OUT] Number of messages read from the socket,
+                                        ///        including discarded ones.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    unixSocket_BatchMsg_t batch[UNIX_SOCKET_MAX_BATCH];
+    size_t numRead;
+    size_t i;
+    size_t numKept = 0;
+
+    LE_ASSERT(numMsgs <= UNIX_SOCKET_MAX_BATCH);
+
+    *numReceivedPtr = 0;
+    *numReadPtr = 0;
+
+    for (i = 0; i < numMsgs; i++)
     {
-        msgRef->clientServer.server.responseFd = -1;
+        GetRxBuffer(msgRefs[i], &batch[i].dataPtr, &batch[i].dataSize);
     }
 
-    return result;
+    le_result_t result = unixSocket_ReceiveMsgBatch(socketFd, batch, numMsgs, &numRead);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    for (i = 0; i < numRead; i++)
+    {
+        le_msg_MessageRef_t msgRef = msgRefs[i];
+
+        msgRef->fd = batch[i].fd;
+        RxDone(msgRef, batch[i].result);
+
+        if (batch[i].result != LE_OK)
+        {
+            LE_ERROR("Discarding message that is too big (%zu bytes) for protocol '%s'.",
+                     batch[i].dataSize,
+                     le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(msgRef->sessionRef)));
+        }
+        else
+        {
+            // Keep the message, moving it down over any discarded ones.
+            msgRefs[i] = msgRefs[numKept];
+            msgRefs[numKept] = msgRef;
+            numKept++;
+        }
+    }
+
+    *numReceivedPtr = numKept;
+    *numReadPtr = numRead;
+
+    return LE_OK;
 }
 
 
@@ -245,37 +575,41 @@ le_msg_MessageRef_t le_msg_CreateMsg
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Get a reference to the Session's Protocol and ask the Protocol to allocate a Message
-    // object from its Message Pool.
-    le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
-    Message_t* msgPtr = msgProto_AllocMessage(protocolRef);
-
-    // Initialize the Message object's data members.
-    msgPtr->link = LE_DLS_LINK_INIT;
-    msgPtr->sessionRef = sessionRef;
-    le_mem_AddRef(sessionRef);  // Message object holds a reference to the Session object.
+    return CreateMsg(sessionRef, le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionRef)));
+}
 
-    msgInterface_Type_t interfaceType = msgSession_GetInterfaceType(sessionRef);
-    switch (interfaceType)
-    {
-        case LE_MSG_INTERFACE_CLIENT:
-            msgPtr->clientServer.client.completionCallback = NULL;
-            msgPtr->clientServer.client.contextPtr = NULL;
-            break;
 
-        case LE_MSG_INTERFACE_SERVER:
-            msgPtr->clientServer.server.responseFd = -1;
-            break;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message to be sent over a given session, with a payload buffer that only needs to
+ * be big enough to hold a given number of bytes.  The message is allocated from the smallest of
+ * the protocol's message pools that can hold that many bytes.
+ *
+ * If the size is larger than the protocol's maximum message size, the maximum is used instead.
+ *
+ * @return  The message reference.
+ *
+ * @note
+ * - This function never returns on failure, so no need to check the return code.
+ * - le_msg_GetMaxPayloadSize() returns the size of the payload buffer actually allocated, which
+ *   may be larger than requested.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t le_msg_CreateMsgWithSize
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t payloadSize              ///< [in] Size of the largest payload the message will carry.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t maxPayloadSize = le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionRef));
 
-        default:
-            LE_FATAL("Unhandled interface type (%d).", interfaceType);
+    if (payloadSize > maxPayloadSize)
+    {
+        payloadSize = maxPayloadSize;
     }
 
-    msgPtr->fd = -1;
-    msgPtr->txnId = 0;
-    memset(msgPtr->payload, 0, le_msg_GetProtocolMaxMsgSize(protocolRef));
-
-    return msgPtr;
+    return CreateMsg(sessionRef, payloadSize);
 }
 
 
@@ -368,7 +702,48 @@ size_t le_msg_GetMaxPayloadSize
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(msgRef->sessionRef));
+    return msgRef->maxPayloadSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the number of bytes at the start of the message payload buffer that are to be sent.
+ *
+ * By default, the whole payload buffer is sent.  This is also the case for responses to received
+ * messages, unless this function is called on the request message before responding.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              payloadSize ///< [in] Number of payload bytes to send.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(payloadSize > msgRef->maxPayloadSize,
+                "Payload size (%zu) larger than payload buffer (%zu).",
+                payloadSize,
+                msgRef->maxPayloadSize);
+
+    msgRef->payloadSize = payloadSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of bytes at the start of the message payload buffer that are to be sent.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_msg_GetPayloadSize
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return msgRef->payloadSize;
 }
 
 
@@ -433,6 +808,67 @@ int le_msg_GetFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates space for bulk data to be sent with this message in the session's bulk channel.
+ * See @ref c_messagingBulkData.
+ *
+ * Any bulk data that the message already holds (including bulk data received with a request
+ * that is being responded to) is released first.
+ *
+ * @return Pointer to where the bulk data should be written, or NULL if the session doesn't have
+ *         a bulk channel or there isn't enough room in it right now.
+ **/
+//--------------------------------------------------------------------------------------------------
+void* le_msg_AllocBulkData
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              numBytes    ///< [in] Number of bytes of bulk data.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ReleaseBulkData(msgRef);
+
+    msgBulk_ChannelRef_t channelRef = msgSession_GetBulkChannel(msgRef->sessionRef);
+    if ((channelRef == NULL) || (numBytes == 0))
+    {
+        return NULL;
+    }
+
+    void* dataPtr = msgBulk_Alloc(channelRef, numBytes, &msgRef->bulkDesc);
+    if (dataPtr != NULL)
+    {
+        le_mem_AddRef(channelRef);
+        msgRef->bulkChannelRef = channelRef;
+        msgRef->bulkDataPtr = dataPtr;
+    }
+
+    return dataPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fetches the bulk data held by a message.  For a received message, this is the bulk data that
+ * the sender attached to it.  See @ref c_messagingBulkData.
+ *
+ * @return Pointer to the bulk data, or NULL if the message doesn't have any.  The pointer is only
+ *         valid until the message is released (or responded to).
+ **/
+//--------------------------------------------------------------------------------------------------
+void* le_msg_GetBulkData
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t*             numBytesPtr ///< [out] Number of bytes of bulk data (0 if none).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    *numBytesPtr = (msgRef->bulkDataPtr == NULL) ? 0 : msgRef->bulkDesc.size;
+
+    return msgRef->bulkDataPtr;
+}
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -562,6 +998,19 @@ void le_msg_Respond
     LE_FATAL_IF(!le_msg_NeedsResponse(msgRef),
                 "Attempt to respond to a message that doesn't need a response.");
 
+    // If there was an fd that was received from the client but not fetched from the message
+    // generate a warning and close that fd.
+    if (msgRef->fd >= 0)
+    {
+        LE_WARN("File descriptor not retrieved from message received from client.");
+        fd_Close(msgRef->fd);
+    }
+
+    // Move the responseFd to the normal fd position in the message object.  This is done here
+    // rather than when the message is sent, because the send may have to be retried.
+    msgRef->fd = msgRef->clientServer.server.responseFd;
+    msgRef->clientServer.server.responseFd = -1;
+
     // Send the response message.
     msgSession_SendMessage(msgRef->sessionRef, msgRef);
 }
@@ -41,6 +41,13 @@ typedef struct le_msg_Message
     clientServer;
 
     int                         fd;         ///< File descriptor to send or received (-1 = no fd)
+    size_t                      maxPayloadSize; ///< Size of the payload buffer, in bytes.
+    size_t                      payloadSize;///< Number of payload bytes to be sent.
+    msgBulk_ChannelRef_t        bulkChannelRef; ///< Bulk channel holding the bulk data (or NULL).
+    void*                       bulkDataPtr;///< Bulk data sent or received (NULL = none).
+    msgBulk_Desc_t              bulkDesc;   ///< Bulk data descriptor.  On sessions that have a
+                                            ///  bulk channel, this is sent in front of the txnId,
+                                            ///  so it must come immediately before it.
     void*                       txnId;      ///< Safe reference value used as a transaction ID.
     void*                       payload[0]; ///< Variable-length payload buffer appears at the end.
 }
@@ -90,6 +97,28 @@ le_result_t msgMessage_Send
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a batch of messages over a connected socket in a single system call.
+ *
+ * If the socket runs out of buffer space part way through the batch, only the first messages are
+ * sent.  The caller still owns all of the Message objects.
+ *
+ * @return
+ * - LE_OK if at least one message was sent (check *numSentPtr for how many).
+ * - LE_NO_MEMORY if the socket doesn't have enough send buffer space available right now.
+ * - LE_COMM_ERROR if the socket reported an error on the send operation.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_SendBatch
+(
+    int         socketFd,   ///< [IN] Connected socket's file descriptor.
+    Message_t** msgPtrs,    ///< [IN] The Messages to be sent.
+    size_t      numMsgs,    ///< [IN] Number of Messages (at most UNIX_SOCKET_MAX_BATCH).
+    size_t*     numSentPtr  ///< [OUT] Number of Messages sent.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receive a single message from a connected socket.
@@ -108,6 +137,32 @@ le_result_t msgMessage_Receive
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive a batch of messages from a connected socket in a single system call, without blocking.
+ *
+ * The messages that were received successfully are moved to the front of the array, in the order
+ * they were received.  Messages that didn't fit into their Message objects are discarded.
+ *
+ * @return
+ * - LE_OK if at least one message was received.
+ * - LE_WOULD_BLOCK if there's nothing there to receive.
+ * - LE_CLOSED if the connection has closed.
+ * - LE_FAULT if an error was encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_ReceiveBatch
+(
+    int                  socketFd,      ///< [IN] The socket's file descriptor.
+    le_msg_MessageRef_t* msgRefs,       ///< [IN+OUT] Message objects to store the messages in.
+    size_t               numMsgs,       ///< [IN] Number of Message objects (at most
+                                        ///       UNIX_SOCKET_MAX_BATCH).
+    size_t*              numReceivedPtr,///< [OUT] Number of messages kept.
+    size_t*              numReadPtr     ///< [OUT] Number of messages read from the socket,
+                                        ///        including discarded ones.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a pointer to the queue link inside a Message object.
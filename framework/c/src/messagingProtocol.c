@@ -12,6 +12,7 @@
 #include "legato.h"
 #include "unixSocket.h"
 #include "serviceDirectory/serviceDirectoryProtocol.h"
+#include "messagingBulk.h"
 #include "messagingMessage.h"
 #include "messagingProtocol.h"
 
@@ -92,6 +93,59 @@ static msgProtocol_Protocol_t* FindProtocol
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the payload size of the messages in one of a Protocol's message size classes.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetClassPayloadSize
+(
+    msgProtocol_Protocol_t* protocolPtr,
+    size_t classIndex
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (classIndex >= protocolPtr->sizeClassCount - 1)
+    {
+        return protocolPtr->maxPayloadSize;
+    }
+
+    return ((size_t)MSG_PROTOCOL_MIN_SIZE_CLASS) << (2 * classIndex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the Message Pool for one of a Protocol's message size classes.
+ *
+ * @return  A reference to the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CreateClassPool
+(
+    msgProtocol_Protocol_t* protocolPtr,
+    size_t classIndex
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t payloadSize = GetClassPayloadSize(protocolPtr, classIndex);
+
+    // The largest class's pool is named after the protocol alone.  The others are prefixed
+    // with their payload size.
+    if (classIndex == protocolPtr->sizeClassCount - 1)
+    {
+        return msgMessage_CreatePool(protocolPtr->id, payloadSize);
+    }
+
+    char name[LIMIT_MAX_PROTOCOL_ID_BYTES + 24];
+    snprintf(name, sizeof(name), "%zu-%s", payloadSize, protocolPtr->id);
+
+    return msgMessage_CreatePool(name, payloadSize);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a new Protocol object.
@@ -115,7 +169,22 @@ static msgProtocol_Protocol_t* CreateProtocol
         LE_CRIT("Protocol identifier truncated from '%s' to '%s'.", protocolId, protocolPtr->id);
     }
 
-    protocolPtr->messagePoolRef = msgMessage_CreatePool(protocolId, largestMsgSize);
+    // Work out how many message size classes there are.  Only the largest class's pool is
+    // created now; the others are created the first time a message of that size is needed.
+    size_t classIndex;
+    protocolPtr->sizeClassCount = 1;
+    while (   (protocolPtr->sizeClassCount < MSG_PROTOCOL_MAX_SIZE_CLASSES)
+           && ((((size_t)MSG_PROTOCOL_MIN_SIZE_CLASS) << (2 * (protocolPtr->sizeClassCount - 1)))
+               < largestMsgSize) )
+    {
+        protocolPtr->sizeClassCount++;
+    }
+
+    for (classIndex = 0; classIndex < protocolPtr->sizeClassCount - 1; classIndex++)
+    {
+        protocolPtr->messagePoolRefs[classIndex] = NULL;
+    }
+    protocolPtr->messagePoolRefs[classIndex] = CreateClassPool(protocolPtr, classIndex);
 
     LOCK
 
@@ -150,19 +219,43 @@ void msgProto_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Allocate a Message object from a given Protocol's Message Pool.
+ * Allocate a Message object from the smallest of a given Protocol's Message Pools that can hold
+ * a given payload size.
  *
  * @return A pointer to the (uninitialized) Message object memory.
  */
 //--------------------------------------------------------------------------------------------------
 le_msg_MessageRef_t msgProto_AllocMessage
 (
-    le_msg_ProtocolRef_t protocolRef
+    le_msg_ProtocolRef_t protocolRef,
+    size_t* payloadSizePtr      ///< [in,out] Payload size needed.  Set to the size of the
+                                ///           allocated Message object's payload buffer.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Allocate a Message object from this Protocol's Message Pool.
-    return le_mem_ForceAlloc(protocolRef->messagePoolRef);
+    size_t classIndex = 0;
+
+    while (   (classIndex < protocolRef->sizeClassCount - 1)
+           && (GetClassPayloadSize(protocolRef, classIndex) < *payloadSizePtr) )
+    {
+        classIndex++;
+    }
+
+    LOCK
+
+    le_mem_PoolRef_t poolRef = protocolRef->messagePoolRefs[classIndex];
+    if (poolRef == NULL)
+    {
+        poolRef = CreateClassPool(protocolRef, classIndex);
+        protocolRef->messagePoolRefs[classIndex] = poolRef;
+    }
+
+    UNLOCK
+
+    *payloadSizePtr = GetClassPayloadSize(protocolRef, classIndex);
+
+    // Allocate a Message object from the size class's Message Pool.
+    return le_mem_ForceAlloc(poolRef);
 }
 
 
@@ -10,6 +10,23 @@
 
 #include "limit.h"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Payload size (in bytes) of the messages in a protocol's smallest message size class.  Each
+ * size class is four times the size of the one before it, except for the largest, which is always
+ * the protocol's maximum payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_PROTOCOL_MIN_SIZE_CLASS     64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of message size classes in a protocol.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_PROTOCOL_MAX_SIZE_CLASSES   6
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a messaging protocol.
@@ -20,7 +37,9 @@ typedef struct le_msg_Protocol
     le_sls_Link_t link;                     ///< Used to link this into the Protocol List.
     char id[LIMIT_MAX_PROTOCOL_ID_BYTES];   ///< Unique identifier for the protocol.
     size_t maxPayloadSize;                  ///< Max payload size (in bytes) in this protocol.
-    le_mem_PoolRef_t messagePoolRef;        ///< Pool of Message objects.
+    size_t sizeClassCount;                  ///< Number of message size classes.
+    le_mem_PoolRef_t messagePoolRefs[MSG_PROTOCOL_MAX_SIZE_CLASSES]; ///< Pool of Message objects
+                                            ///  for each size class (NULL until first needed).
 }
 msgProtocol_Protocol_t;
 
@@ -39,14 +58,17 @@ void msgProto_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Allocate a Message object from a given Protocol's Message Pool.
+ * Allocate a Message object from the smallest of a given Protocol's Message Pools that can hold
+ * a given payload size.
  *
  * @return A pointer to the (uninitialized) Message object memory.
  */
 //--------------------------------------------------------------------------------------------------
 le_msg_MessageRef_t msgProto_AllocMessage
 (
-    le_msg_ProtocolRef_t protocolRef
+    le_msg_ProtocolRef_t protocolRef,
+    size_t* payloadSizePtr      ///< [in,out] Payload size needed.  Set to the size of the
+                                ///           allocated Message object's payload buffer.
 );
 
 
@@ -12,6 +12,7 @@
 #include "legato.h"
 #include "unixSocket.h"
 #include "serviceDirectory/serviceDirectoryProtocol.h"
+#include "messagingBulk.h"
 #include "messagingInterface.h"
 #include "messagingSession.h"
 #include "messagingProtocol.h"
@@ -30,6 +31,36 @@
 #define MAX_EXPECTED_TXNS 32
 
 
+//--------------------------------------------------------------------------------------------------
+/// Most bytes of Message buffers that are allocated at once to receive a batch of messages into.
+/// This keeps protocols with large messages from needing a lot of Message objects just to receive.
+//--------------------------------------------------------------------------------------------------
+#define MAX_RX_BATCH_BYTES 16384
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Session open response.  This is the "hello" message that a server sends to a client when it
+ * accepts a session, or the result code that the Service Directory sends when it refuses one.
+ * The Service Directory only sends the result code.  A server leaves out the direct endpoint
+ * name unless it is giving the client one.
+ *
+ * If hasBulkChannel is set, the bulk channel's fd comes with the message, and the server frames
+ * every message on the session with a bulk data descriptor from then on.  So the client must not
+ * treat the session as open unless it has attached the channel too.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_result_t result;                                     ///< LE_OK if the session is open.
+    uint32_t    hasBulkChannel;                             ///< Non-zero if the session has a
+                                                            ///  bulk channel.
+    char        directName[MSG_INTERFACE_DIRECT_NAME_BYTES];///< Name of the client's direct
+                                                            ///  endpoint.
+}
+OpenResponse_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mutex used to protect data structures in this module from multi-threaded race conditions.
@@ -93,10 +124,12 @@ static void AttemptOpen(msgSession_Session_t* sessionPtr);
 /**
  * Pushes a message onto the tail of the Transmit Queue.
  *
+ * @return true if the queue was empty before the message was pushed.
+ *
  * @note    This is used on both the client side and the server side.
  */
 //--------------------------------------------------------------------------------------------------
-static void PushTransmitQueue
+static bool PushTransmitQueue
 (
     msgSession_Session_t*   sessionPtr,
     le_msg_MessageRef_t     msgRef
@@ -104,10 +137,14 @@ static void PushTransmitQueue
 //--------------------------------------------------------------------------------------------------
 {
     le_dls_Link_t* linkPtr = msgMessage_GetQueueLinkPtr(msgRef);
+    bool wasEmpty;
 
     LOCK
+    wasEmpty = le_dls_IsEmpty(&sessionPtr->transmitQueue);
     le_dls_Queue(&sessionPtr->transmitQueue, linkPtr);
     UNLOCK
+
+    return wasEmpty;
 }
 
 
@@ -447,6 +484,11 @@ static msgSession_Session_t* CreateSession
     sessionPtr->openContextPtr = NULL;
     sessionPtr->closeHandler = NULL;
     sessionPtr->closeContextPtr = NULL;
+    sessionPtr->bulkChannelRef = NULL;
+    sessionPtr->isDirect = false;
+
+    memset(&sessionPtr->txStats, 0, sizeof(sessionPtr->txStats));
+    memset(&sessionPtr->rxStats, 0, sizeof(sessionPtr->rxStats));
 
     sessionPtr->interfaceRef = interfaceRef;
 
@@ -489,6 +531,14 @@ static void CloseSession
     fd_Close(sessionPtr->socketFd);
     sessionPtr->socketFd = -1;
 
+    // Let go of the bulk channel.  Messages that still hold bulk data keep it mapped until they
+    // are released.
+    if (sessionPtr->bulkChannelRef != NULL)
+    {
+        le_mem_Release(sessionPtr->bulkChannelRef);
+        sessionPtr->bulkChannelRef = NULL;
+    }
+
     // If there are any messages stranded on the transmit queue, the pending transaction list,
     // or the receive queue, clean them all up.
     if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER)
@@ -629,9 +679,24 @@ static void RetryOpen
     CloseSession(sessionPtr);
 
     le_msg_InterfaceRef_t interfaceRef = le_msg_GetSessionInterface(sessionPtr);
-    LE_ERROR("Retrying connection on interface (%s:%s)...",
-             le_msg_GetInterfaceName(interfaceRef),
-             le_msg_GetProtocolIdStr(le_msg_GetInterfaceProtocol(interfaceRef)));
+
+    // If the server stopped accepting direct connections, go through the Service Directory.
+    if (sessionPtr->isDirect)
+    {
+#ifdef LE_MSG_DIRECT_CONNECT
+        msgInterface_SetDirectEndpoint(interfaceRef, NULL);
+#endif
+
+        TRACE("Direct connection refused on interface (%s:%s).",
+              le_msg_GetInterfaceName(interfaceRef),
+              le_msg_GetProtocolIdStr(le_msg_GetInterfaceProtocol(interfaceRef)));
+    }
+    else
+    {
+        LE_ERROR("Retrying connection on interface (%s:%s)...",
+                 le_msg_GetInterfaceName(interfaceRef),
+                 le_msg_GetProtocolIdStr(le_msg_GetInterfaceProtocol(interfaceRef)));
+    }
 
     AttemptOpen(sessionPtr);
 }
@@ -639,7 +704,8 @@ static void RetryOpen
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Receives an LE_OK session open response from the server.
+ * Receives an LE_OK session open response from the server.  If it comes with a direct endpoint,
+ * the endpoint is recorded for later sessions on the same interface.
  *
  * @note    This is used only on the client side.
  *
@@ -656,25 +722,71 @@ static le_result_t ReceiveSessionOpenResponse
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // We expect to receive a very small message (one le_result_t).
-    le_result_t serverResponse;
-    size_t  bytesReceived = sizeof(serverResponse);
+    // We expect to receive a very small message (one le_result_t, maybe followed by the name of
+    // a direct endpoint), possibly with the file descriptor of the session's bulk channel.
+    OpenResponse_t response;
+    size_t  bytesReceived = sizeof(response);
+    int bulkFd;
 
     // Receive the message.
     le_result_t result;
-    result = unixSocket_ReceiveDataMsg(sessionPtr->socketFd, &serverResponse, &bytesReceived);
+    result = unixSocket_ReceiveMsg(sessionPtr->socketFd,
+                                   &response,
+                                   &bytesReceived,
+                                   &bulkFd,
+                                   NULL);   // Don't need credentials.
+
+    le_result_t serverResponse = response.result;
 
     if (result == LE_OK)
     {
         if (serverResponse == LE_OK)
         {
             le_msg_InterfaceRef_t interfaceRef = le_msg_GetSessionInterface(sessionPtr);
-            TRACE("Session opened on interface (%s:%s)",
+
+            // The server has already started framing messages for the bulk channel, so the
+            // session is unusable without it.
+            if (   (bytesReceived >= offsetof(OpenResponse_t, directName))
+                && (response.hasBulkChannel != 0))
+            {
+                if (bulkFd >= 0)
+                {
+                    sessionPtr->bulkChannelRef = msgBulk_AttachChannel(bulkFd);
+                }
+
+                if (sessionPtr->bulkChannelRef == NULL)
+                {
+                    LE_FATAL("Failed to attach the bulk channel of a session on interface "
+                             "(%s:%s).",
+                             le_msg_GetInterfaceName(interfaceRef),
+                             le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+                }
+            }
+            else if (bulkFd >= 0)
+            {
+                fd_Close(bulkFd);
+            }
+
+            TRACE("Session opened on interface (%s:%s)%s%s",
                   le_msg_GetInterfaceName(interfaceRef),
-                  le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+                  le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)),
+                  (sessionPtr->bulkChannelRef != NULL) ? " with bulk channel" : "",
+                  sessionPtr->isDirect ? " directly" : "");
+
+#ifdef LE_MSG_DIRECT_CONNECT
+            if (bytesReceived == sizeof(response))
+            {
+                response.directName[sizeof(response.directName) - 1] = '\0';
+                msgInterface_SetDirectEndpoint(interfaceRef, response.directName);
+            }
+#endif
         }
         else if ((serverResponse == LE_UNAVAILABLE) || (serverResponse == LE_NOT_PERMITTED))
         {
+            if (bulkFd >= 0)
+            {
+                fd_Close(bulkFd);
+            }
             result = serverResponse;
         }
         else
@@ -706,16 +818,45 @@ static le_result_t ReceiveSessionOpenResponse
 //--------------------------------------------------------------------------------------------------
 static le_result_t SendSessionOpenResponse
 (
-    int socketFd    ///< [IN] Connected socket to send through.
+    int socketFd,   ///< [IN] Connected socket to send through.
+    int bulkFd,     ///< [IN] File descriptor of the session's bulk channel (-1 if none).
+    const char* directNamePtr   ///< [IN] Name of the client's direct endpoint (NULL if none).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    const le_result_t response = LE_OK;
+    OpenResponse_t response;
+    size_t responseSize = offsetof(OpenResponse_t, directName);
     ssize_t bytesSent;
 
+    memset(&response, 0, sizeof(response));
+    response.result = LE_OK;
+    response.hasBulkChannel = (bulkFd >= 0);
+
+    if (directNamePtr != NULL)
+    {
+        le_utf8_Copy(response.directName, directNamePtr, sizeof(response.directName), NULL);
+        responseSize = sizeof(response);
+    }
+
+    // The bulk channel's fd has to go as ancillary data.
+    if (bulkFd >= 0)
+    {
+        le_result_t result = unixSocket_SendMsg(socketFd,
+                                                &response,
+                                                responseSize,
+                                                bulkFd,
+                                                false); // Don't send credentials.
+        if (result != LE_OK)
+        {
+            LE_ERROR("Failed to send session open response (%s).", LE_RESULT_TXT(result));
+            return LE_COMM_ERROR;
+        }
+        return LE_OK;
+    }
+
     do
     {
-        bytesSent = send(socketFd, &response, sizeof(response), MSG_EOR);
+        bytesSent = send(socketFd, &response, responseSize, MSG_EOR);
     }
     while ((bytesSent == -1) && (errno == EINTR));
 
@@ -727,7 +868,7 @@ static le_result_t SendSessionOpenResponse
     }
     else
     {
-        LE_ASSERT(bytesSent == sizeof(response));
+        LE_ASSERT(bytesSent == responseSize);
         return LE_OK;
     }
 }
@@ -900,9 +1041,37 @@ static void ClientSocketError
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates a session's batch counters after a batch of messages was sent or received.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountBatch
+(
+    msgSession_BatchStats_t* statsPtr,  ///< [IN] The counters to update.
+    size_t numMsgs                      ///< [IN] Number of messages in the batch.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    statsPtr->msgCount += numMsgs;
+    statsPtr->batchCount++;
+
+    if (numMsgs > statsPtr->maxBatch)
+    {
+        statsPtr->maxBatch = numMsgs;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receive messages from the socket and put them on the Receive Queue.
+ *
+ * Messages are received in batches, using one system call per batch.  To avoid allocating a lot of
+ * Message objects when only one message is waiting, the batch size starts small and is doubled
+ * each time a full batch is received, and Message objects that weren't filled are kept for the
+ * next batch.  The batch size is also limited so that no more than MAX_RX_BATCH_BYTES of
+ * Message buffers are allocated at once.
  */
 //--------------------------------------------------------------------------------------------------
 static void ReceiveMessages
@@ -911,25 +1080,83 @@ static void ReceiveMessages
 )
 //--------------------------------------------------------------------------------------------------
 {
+    le_msg_MessageRef_t msgRefs[UNIX_SOCKET_MAX_BATCH];
+    size_t numCreated = 0;
+
+    size_t maxMsgSize = le_msg_GetProtocolMaxMsgSize(
+                            le_msg_GetInterfaceProtocol(sessionPtr->interfaceRef));
+    size_t maxBatchSize = MAX_RX_BATCH_BYTES / (maxMsgSize > 0 ? maxMsgSize : 1);
+    if (maxBatchSize > UNIX_SOCKET_MAX_BATCH)
+    {
+        maxBatchSize = UNIX_SOCKET_MAX_BATCH;
+    }
+    else if (maxBatchSize == 0)
+    {
+        maxBatchSize = 1;
+    }
+
+    size_t batchSize = (maxBatchSize < 4) ? maxBatchSize : 4;
+
     for (;;)
     {
-        // Create a Message object.
-        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionPtr);
+        size_t numReceived = 0;
+        size_t numRead = 0;
+        size_t i;
 
-        // Receive from the socket into the Message object.
-        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, msgRef);
+        // Create the Message objects that aren't left over from the last batch.
+        for (; numCreated < batchSize; numCreated++)
+        {
+            msgRefs[numCreated] = le_msg_CreateMsg(sessionPtr);
+        }
 
+        // Receive from the socket into the Message objects.
+        le_result_t result = msgMessage_ReceiveBatch(sessionPtr->socketFd,
+                                                     msgRefs,
+                                                     batchSize,
+                                                     &numReceived,
+                                                     &numRead);
         if (result == LE_OK)
         {
-            // Received something.  Push it onto the Receive Queue for later processing.
-            PushReceiveQueue(sessionPtr, msgRef);
+            CountBatch(&sessionPtr->rxStats, numRead);
         }
-        else
+
+        // Push what was received onto the Receive Queue for later processing, release the
+        // Message objects of discarded messages, and keep the ones that weren't read into at the
+        // front of the array.
+        for (i = 0; i < numReceived; i++)
+        {
+            PushReceiveQueue(sessionPtr, msgRefs[i]);
+        }
+        for (i = numReceived; i < numRead; i++)
+        {
+            le_msg_ReleaseMsg(msgRefs[i]);
+        }
+        for (i = numRead; i < numCreated; i++)
+        {
+            msgRefs[i - numRead] = msgRefs[i];
+        }
+        numCreated -= numRead;
+
+        // If the batch wasn't filled, there's nothing left to receive from the socket.
+        if ((result != LE_OK) || (numRead < batchSize))
         {
-            // Nothing left to receive from the socket.  We are done.
-            le_msg_ReleaseMsg(msgRef);
             break;
         }
+
+        if (batchSize < maxBatchSize)
+        {
+            batchSize *= 2;
+            if (batchSize > maxBatchSize)
+            {
+                batchSize = maxBatchSize;
+            }
+        }
+    }
+
+    // Release the Message objects that weren't needed.
+    while (numCreated > 0)
+    {
+        le_msg_ReleaseMsg(msgRefs[--numCreated]);
     }
 }
 
@@ -980,10 +1207,60 @@ static void ServerSocketError
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disposes of a message that has been sent from a session's Transmit Queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishSentMessage
+(
+    msgSession_Session_t* sessionPtr,
+    le_msg_MessageRef_t msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (sessionPtr->interfaceRef->interfaceType)
+    {
+        // If this is the client side of the session,
+        case LE_MSG_INTERFACE_CLIENT:
+            // If a response is expected from the other side later, then put this
+            // message on the Transaction List.
+            if (msgMessage_GetTxnId(msgRef) != 0)
+            {
+                AddToTxnList(sessionPtr, msgRef);
+            }
+            // Otherwise, release it.
+            else
+            {
+                le_msg_ReleaseMsg(msgRef);
+            }
+
+            break;
+
+        // If this is the server side of the session,
+        case LE_MSG_INTERFACE_SERVER:
+            // Release the message, but first clear out the transaction ID so that
+            // the message knows that it is not being deleted without a reponse message
+            // being sent if one was expected.
+            msgMessage_SetTxnId(msgRef, 0);
+            le_msg_ReleaseMsg(msgRef);
+
+            break;
+
+        default:
+            LE_FATAL("Unhandled interface type (%d)",
+                     sessionPtr->interfaceRef->interfaceType);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send messages from a session's Transmit Queue until either the socket becomes full or there
  * are no more messages waiting on the queue.
+ *
+ * Messages are taken off the queue in batches of up to UNIX_SOCKET_MAX_BATCH and each batch is
+ * sent using a single system call.
  */
 //--------------------------------------------------------------------------------------------------
 static void SendFromTransmitQueue
@@ -992,11 +1269,27 @@ static void SendFromTransmitQueue
 )
 //--------------------------------------------------------------------------------------------------
 {
+    le_msg_MessageRef_t msgRefs[UNIX_SOCKET_MAX_BATCH];
+
     for (;;)
     {
-        le_msg_MessageRef_t msgRef = PopTransmitQueue(sessionPtr);
+        size_t numMsgs = 0;
+        size_t numSent = 0;
+        size_t i;
 
-        if (msgRef == NULL)
+        while (numMsgs < UNIX_SOCKET_MAX_BATCH)
+        {
+            le_msg_MessageRef_t msgRef = PopTransmitQueue(sessionPtr);
+
+            if (msgRef == NULL)
+            {
+                break;
+            }
+
+            msgRefs[numMsgs++] = msgRef;
+        }
+
+        if (numMsgs == 0)
         {
             // Since the Transmit Queue is empty, tell the FD Monitor that we don't need to be
             // notified about writeability anymore.
@@ -1004,51 +1297,40 @@ static void SendFromTransmitQueue
             break;
         }
 
-        le_result_t result = msgMessage_Send(sessionPtr->socketFd, msgRef);
+        le_result_t result = msgMessage_SendBatch(sessionPtr->socketFd,
+                                                  msgRefs,
+                                                  numMsgs,
+                                                  &numSent);
+        if (result == LE_OK)
+        {
+            CountBatch(&sessionPtr->txStats, numSent);
+
+            for (i = 0; i < numSent; i++)
+            {
+                FinishSentMessage(sessionPtr, msgRefs[i]);
+            }
+        }
+
+        // Put anything that wasn't sent back on the head of the queue, in its original order.
+        for (i = numMsgs; i > numSent; i--)
+        {
+            UnPopTransmitQueue(sessionPtr, msgRefs[i - 1]);
+        }
 
         switch (result)
         {
             case LE_OK:
-                switch (sessionPtr->interfaceRef->interfaceType)
+                if (numSent == numMsgs)
                 {
-                    // If this is the client side of the session,
-                    case LE_MSG_INTERFACE_CLIENT:
-                        // If a response is expected from the other side later, then put this
-                        // message on the Transaction List.
-                        if (msgMessage_GetTxnId(msgRef) != 0)
-                        {
-                            AddToTxnList(sessionPtr, msgRef);
-                        }
-                        // Otherwise, release it.
-                        else
-                        {
-                            le_msg_ReleaseMsg(msgRef);
-                        }
-
-                        break;
-
-                    // If this is the server side of the session,
-                    case LE_MSG_INTERFACE_SERVER:
-                        // Release the message, but first clear out the transaction ID so that
-                        // the message knows that it is not being deleted without a reponse message
-                        // being sent if one was expected.
-                        msgMessage_SetTxnId(msgRef, 0);
-                        le_msg_ReleaseMsg(msgRef);
-
-                        break;
-
-                    default:
-                        LE_FATAL("Unhandled interface type (%d)",
-                                 sessionPtr->interfaceRef->interfaceType);
+                    break;  // Continue to loop around and send another batch.
                 }
 
-                break;  // Continue to loop around and send another.
+                // Only part of the batch fit, so the socket is full.
+                // Fall through.
 
             case LE_NO_MEMORY:
-                // Have to wait for the socket to become writeable.  Put the message back on
-                // the head of the queue and ask the FD Monitor to tell us when the socket becomes
-                // writeable again.
-                UnPopTransmitQueue(sessionPtr, msgRef);
+                // Have to wait for the socket to become writeable.  Ask the FD Monitor to tell us
+                // when the socket becomes writeable again.
                 EnableWriteabilityNotification(sessionPtr);
 
                 return;
@@ -1056,10 +1338,8 @@ static void SendFromTransmitQueue
             case LE_COMM_ERROR:
                 // In this case, we expect a handler function to be called by the FD Monitor,
                 // so we don't need to handle this case here.  However, we must stop
-                // trying to transmit now.  Stick the current message back on the Transmit Queue
-                // so it gets cleaned up with the others when the session closes.
-                UnPopTransmitQueue(sessionPtr, msgRef);
-
+                // trying to transmit now.  The unsent messages are back on the Transmit Queue
+                // so they get cleaned up with the others when the session closes.
                 return;
 
             default:
@@ -1317,18 +1597,46 @@ static le_result_t StartSessionOpenAttempt
 //--------------------------------------------------------------------------------------------------
 {
     sessionPtr->state = LE_MSG_SESSION_STATE_OPENING;
+    sessionPtr->isDirect = false;
 
     // Create a socket for the session.
     sessionPtr->socketFd = CreateSocket();
 
+    bool wantsDirect = false;
+
+#ifdef LE_MSG_DIRECT_CONNECT
+    // If the server gave us a direct endpoint for this interface, connect straight to it.
+    char directName[MSG_INTERFACE_DIRECT_NAME_BYTES];
+    le_result_t directResult = msgInterface_GetDirectEndpoint(sessionPtr->interfaceRef,
+                                                              directName,
+                                                              sizeof(directName));
+    if (directResult == LE_OK)
+    {
+        if (unixSocket_ConnectAbstract(sessionPtr->socketFd, directName) == LE_OK)
+        {
+            sessionPtr->isDirect = true;
+            return LE_OK;
+        }
+
+        // The endpoint has been closed, so go through the Service Directory and ask for a new one.
+        msgInterface_SetDirectEndpoint(sessionPtr->interfaceRef, NULL);
+        fd_Close(sessionPtr->socketFd);
+        sessionPtr->socketFd = CreateSocket();
+        directResult = LE_NOT_FOUND;
+    }
+    wantsDirect = (directResult == LE_NOT_FOUND);
+#endif
+
     // Connect to the Service Directory's client socket.
     le_result_t result = ConnectToServiceDirectory(sessionPtr->socketFd);
     if (result == LE_OK)
     {
         // Create an "Open" request to send to the Service Directory.
         svcdir_OpenRequest_t msg;
+        memset(&msg, 0, sizeof(msg));
         msgInterface_GetInterfaceDetails(sessionPtr->interfaceRef, &(msg.interface));
         msg.shouldWait = shouldWait;
+        msg.wantsDirect = wantsDirect;
 
         // Send the request to the Service Directory.
         result = unixSocket_SendDataMsg(sessionPtr->socketFd, &msg, sizeof(msg));
@@ -1439,6 +1747,15 @@ static le_result_t AttemptOpenSync
             else
             {
                 CloseSession(sessionPtr);
+
+#ifdef LE_MSG_DIRECT_CONNECT
+                // If the server stopped accepting direct connections, go through the
+                // Service Directory next time around.
+                if (sessionPtr->isDirect)
+                {
+                    msgInterface_SetDirectEndpoint(sessionPtr->interfaceRef, NULL);
+                }
+#endif
             }
         }
 
@@ -1575,6 +1892,23 @@ bool msgSession_IsOpen
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the bulk channel of a given Session reference.
+ *
+ * @return  The bulk channel, or NULL if the session doesn't have one.
+ */
+//--------------------------------------------------------------------------------------------------
+msgBulk_ChannelRef_t msgSession_GetBulkChannel
+(
+    le_msg_SessionRef_t sessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return sessionRef->bulkChannelRef;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a given Message object through a given Session.
@@ -1602,11 +1936,13 @@ void msgSession_SendMessage
     }
     else
     {
-        // Put the message on the Transmit Queue.
-        PushTransmitQueue(sessionRef, messageRef);
-
-        // Try to send something from the Transmit Queue.
-        SendFromTransmitQueue(sessionRef);
+        // Put the message on the Transmit Queue.  If other messages were already waiting, the
+        // socket is full and the queue will be flushed when it becomes writeable again, so don't
+        // bother trying to send now.
+        if (PushTransmitQueue(sessionRef, messageRef))
+        {
+            SendFromTransmitQueue(sessionRef);
+        }
     }
 }
 
@@ -1636,11 +1972,13 @@ void msgSession_RequestResponse
     // Create an ID for this transaction.
     CreateTxnId(msgRef);
 
-    // Put the message on the Transmit Queue.
-    PushTransmitQueue(sessionRef, msgRef);
-
-    // Try to send something from the Transmit Queue.
-    SendFromTransmitQueue(sessionRef);
+    // Put the message on the Transmit Queue.  If other messages were already waiting, the
+    // socket is full and the queue will be flushed when it becomes writeable again, so don't
+    // bother trying to send now.
+    if (PushTransmitQueue(sessionRef, msgRef))
+    {
+        SendFromTransmitQueue(sessionRef);
+    }
 }
 
 
@@ -1789,14 +2127,49 @@ le_msg_SessionRef_t msgSession_GetSessionContainingLink
 le_msg_SessionRef_t msgSession_CreateServerSideSession
 (
     le_msg_ServiceRef_t serviceRef,
-    int                 fd          ///< [IN] File descriptor of socket connected to client.
+    int                 fd,         ///< [IN] File descriptor of socket connected to client.
+    const char*         directNamePtr   ///< [IN] Name of the client's direct endpoint, to be sent
+                                        ///       with the welcome message (NULL if none).
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // If the service wants a bulk channel for each session, create one now, so it can be sent
+    // to the client with the Hello message.  Clients of the service count on having it, so if
+    // that fails, refuse the connection.
+    msgBulk_ChannelRef_t bulkChannelRef = NULL;
+    int bulkFd = -1;
+    if (serviceRef->bulkChannelSize > 0)
+    {
+        bulkChannelRef = msgBulk_CreateChannel(serviceRef->bulkChannelSize, &bulkFd);
+
+        if (bulkChannelRef == NULL)
+        {
+            LE_ERROR("Refusing session on service (%s:%s) because its bulk channel couldn't be "
+                     "created.",
+                     serviceRef->interface.id.name,
+                     le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+            fd_Close(fd);
+            return NULL;
+        }
+    }
+
     // Send a Hello message (LE_OK) to the client.
-    if (SendSessionOpenResponse(fd) != LE_OK)
+    le_result_t result = SendSessionOpenResponse(fd, bulkFd, directNamePtr);
+
+    // The client has its own copy of the bulk channel's fd now, and the mapping stays valid
+    // without ours.
+    if (bulkFd >= 0)
+    {
+        fd_Close(bulkFd);
+    }
+
+    if (result != LE_OK)
     {
         // Something went wrong.  Abort.
+        if (bulkChannelRef != NULL)
+        {
+            le_mem_Release(bulkChannelRef);
+        }
         fd_Close(fd);
         return NULL;
     }
@@ -1810,6 +2183,7 @@ le_msg_SessionRef_t msgSession_CreateServerSideSession
 
     // Record the client connection file descriptor.
     sessionPtr->socketFd = fd;
+    sessionPtr->bulkChannelRef = bulkChannelRef;
 
     // Start monitoring the server-side session connection socket for events.
     StartSocketMonitoring(sessionPtr, ServerSocketEventHandler);
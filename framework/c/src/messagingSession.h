@@ -30,6 +30,20 @@ typedef enum
 msgSession_SessionState_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counters for the batches of messages sent or received on a session's socket.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t msgCount;    ///< Number of messages sent or received.
+    size_t batchCount;  ///< Number of system calls that sent or received at least one message.
+    size_t maxBatch;    ///< Largest number of messages sent or received in one system call.
+}
+msgSession_BatchStats_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a client-server session.
@@ -61,6 +75,13 @@ typedef struct le_msg_Session
     void*                           openContextPtr; ///< Open handler's context pointer.
     le_msg_SessionEventHandler_t    closeHandler;   ///< Close handler function.
     void*                           closeContextPtr;///< Close handler's context pointer.
+    msgBulk_ChannelRef_t            bulkChannelRef; ///< Shared memory for bulk data, or NULL if
+                                                    ///  the session doesn't have any.
+    msgSession_BatchStats_t         txStats;        ///< Transmit batch counters.
+    msgSession_BatchStats_t         rxStats;        ///< Receive batch counters.
+    bool                            isDirect;       ///< true = the client connected straight to
+                                                    ///  the server's direct endpoint for the
+                                                    ///  client interface.
 }
 msgSession_Session_t;
 
@@ -114,6 +135,19 @@ bool msgSession_IsOpen
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the bulk channel of a given Session reference.
+ *
+ * @return  The bulk channel, or NULL if the session doesn't have one.
+ */
+//--------------------------------------------------------------------------------------------------
+msgBulk_ChannelRef_t msgSession_GetBulkChannel
+(
+    le_msg_SessionRef_t sessionRef
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a given Message object through a given Session.
@@ -202,7 +236,9 @@ le_msg_SessionRef_t msgSession_GetSessionContainingLink
 le_msg_SessionRef_t msgSession_CreateServerSideSession
 (
     le_msg_ServiceRef_t serviceRef,
-    int                 fd          ///< [IN] File descriptor of socket connected to client.
+    int                 fd,         ///< [IN] File descriptor of socket connected to client.
+    const char*         directNamePtr   ///< [IN] Name of the client's direct endpoint, to be sent
+                                        ///       with the welcome message (NULL if none).
 );
 
 
@@ -0,0 +1,578 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Implementation of the Service Directory Binding Loader component.
+ *
+ * The binding configuration is read from the "system" configuration tree into a binding table
+ * in an anonymous shared memory file, which is then passed to the Service Directory in a single
+ * "Load" request.  On kernels without memfd_create() (before 3.17), an unlinked temporary file
+ * under /tmp is used instead.  The Service Directory replaces all of its bindings with the table's contents in
+ * one go.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "sdirLoad.h"
+#include "serviceDirectory/sdirToolProtocol.h"
+#include "fileDescriptor.h"
+#include "limit.h"
+#include "user.h"
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory that holds the binding table if memfd_create() isn't supported.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TABLE_FALLBACK_DIR  "/tmp"
+
+
+COMPONENT_INIT
+{
+    user_Init();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the user ID for a given app name.
+ *
+ * @return LE_OK if successful.
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetServerUid
+(
+    le_cfg_IteratorRef_t    i,  ///< [in] Config tree iterator positioned at binding config.
+    uid_t*  uidPtr              ///< [out] The application's user ID.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+
+    char userName[LIMIT_MAX_USER_NAME_BYTES];
+
+    // If an app name is present in the binding config,
+    if (le_cfg_NodeExists(i, "app"))
+    {
+        // Make sure there isn't also a user name.
+        if (le_cfg_NodeExists(i, "user"))
+        {
+            char path[LIMIT_MAX_PATH_BYTES];
+            le_cfg_GetPath(i, "", path, sizeof(path));
+            LE_CRIT("Both server user and app nodes appear under binding (@ %s)", path);
+            return LE_DUPLICATE;
+        }
+
+        // Get the app name.
+        char appName[LIMIT_MAX_APP_NAME_BYTES];
+        result = le_cfg_GetString(i, "app", appName, sizeof(appName), "");
+        if (result != LE_OK)
+        {
+            char path[LIMIT_MAX_PATH_BYTES];
+            le_cfg_GetPath(i, "app", path, sizeof(path));
+            LE_CRIT("Server app name too big (@ %s)", path);
+            return result;
+        }
+        if (appName[0] == '\0')
+        {
+            char path[LIMIT_MAX_PATH_BYTES];
+            le_cfg_GetPath(i, "app", path, sizeof(path));
+            LE_CRIT("Server app name empty (@ %s)", path);
+            return LE_NOT_FOUND;
+        }
+
+        // Find out if the server app is sandboxed.  If not, it runs as root.
+        char path[LIMIT_MAX_PATH_BYTES];
+        if (snprintf(path, sizeof(path), "/apps/%s/sandboxed", appName) >= sizeof(path))
+        {
+            LE_CRIT("Config node path too long (app name '%s').", appName);
+            return LE_OVERFLOW;
+        }
+        if (!le_cfg_GetBool(i, path, true))
+        {
+            *uidPtr = 0;
+
+            return LE_OK;
+        }
+
+        // It is not sandboxed.  Convert the app name into a user name.
+        result = user_AppNameToUserName(appName, userName, sizeof(userName));
+        if (result != LE_OK)
+        {
+            LE_CRIT("Failed to convert app name '%s' into a user name.", appName);
+
+            return result;
+        }
+    }
+    // If a server app name is not present in the binding config,
+    else
+    {
+        // Get the server user name instead.
+        result = le_cfg_GetString(i, "user", userName, sizeof(userName), "");
+        if (result != LE_OK)
+        {
+            char path[LIMIT_MAX_PATH_BYTES];
+
+            le_cfg_GetPath(i, "user", path, sizeof(path));
+            LE_CRIT("Server user name too big (@ %s)", path);
+
+            return result;
+        }
+        if (userName[0] == '\0')
+        {
+            char path[LIMIT_MAX_PATH_BYTES];
+
+            le_cfg_GetPath(i, "", path, sizeof(path));
+            LE_CRIT("Server user name or app name missing (@ %s)", path);
+
+            return LE_NOT_FOUND;
+        }
+    }
+
+    // Convert the server's user name into a user ID.
+    result = user_GetUid(userName, uidPtr);
+    if (result != LE_OK)
+    {
+        // Note: This can happen if the server application isn't installed yet.
+        //       When the server application is installed, sdir load will be run
+        //       again and the bindings will be correctly set up at that time.
+        if (strncmp(userName, "app", 3) == 0)
+        {
+            LE_DEBUG("Couldn't get UID for application '%s'.  Perhaps it is not installed yet?",
+                     userName + 3);
+        }
+        else
+        {
+            char path[LIMIT_MAX_PATH_BYTES];
+            le_cfg_GetPath(i, "", path, sizeof(path));
+            LE_CRIT("Couldn't convert server user name '%s' to UID (%s @ %s)",
+                    userName,
+                    LE_RESULT_TXT(result),
+                    path);
+        }
+
+        return result;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the Unix user ID for the user configuration node that a given configuration iterator
+ * is currently positioned at.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetUserUid
+(
+    le_cfg_IteratorRef_t i, ///< [in] Configuration tree iterator.
+    uid_t*          uidPtr  ///< [out] Pointer to where the user ID will be put if successful.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+
+    char userName[LIMIT_MAX_USER_NAME_BYTES];
+    result = le_cfg_GetNodeName(i, "", userName, sizeof(userName));
+
+    if (result != LE_OK)
+    {
+        LE_CRIT("Configuration node name too long under 'system/users/'.");
+        return LE_OVERFLOW;
+    }
+
+    // Convert the user name into a user ID.
+    result = user_GetUid(userName, uidPtr);
+    if (result != LE_OK)
+    {
+        LE_CRIT("Failed to get user ID for user '%s'. (%s)", userName, LE_RESULT_TXT(result));
+        return LE_NOT_FOUND;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the Unix user ID for the app configuration node that a given configuration iterator
+ * is currently positioned at.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetAppUid
+(
+    le_cfg_IteratorRef_t i, ///< [in] Configuration tree iterator.
+    uid_t*          uidPtr  ///< [out] Pointer to where the user ID will be put if successful.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+
+    char appName[LIMIT_MAX_APP_NAME_BYTES];
+    result = le_cfg_GetNodeName(i, "", appName, sizeof(appName));
+    if (result != LE_OK)
+    {
+        LE_CRIT("Configuration node name too long under 'system/apps/'.");
+        return LE_OVERFLOW;
+    }
+
+    // If this is an "unsandboxed" app, use the root user ID.
+    if (le_cfg_GetBool(i, "sandboxed", true) == false)
+    {
+        char path[256];
+        le_cfg_GetPath(i, "", path, sizeof(path));
+        LE_DEBUG("'%s' = <root>", path);
+
+        *uidPtr = 0;
+        return LE_OK;
+    }
+
+    // Convert the app name into a user name by prefixing it with "app".
+    char userName[LIMIT_MAX_USER_NAME_BYTES] = "app";
+    result = le_utf8_Append(userName, appName, sizeof(userName), NULL);
+    if (result != LE_OK)
+    {
+        LE_CRIT("Failed to convert app name into user name.");
+        return LE_OVERFLOW;
+    }
+
+    // Convert the app user name into a user ID.
+    result = user_GetUid(userName, uidPtr);
+    if (result != LE_OK)
+    {
+        LE_CRIT("Failed to get user ID for user '%s'. (%s)", userName, LE_RESULT_TXT(result));
+        return LE_NOT_FOUND;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds the binding at a configuration tree iterator's current node to the binding table.
+ *
+ * @return LE_OK if successful, LE_FAULT if the table couldn't be written.  Misconfigured bindings
+ *         are logged and skipped.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddBinding
+(
+    int tableFd,                ///< [in] File descriptor of the binding table.
+    uid_t uid,                  ///< [in] Unix user ID of the client whose binding is being created.
+    le_cfg_IteratorRef_t i      ///< [in] Configuration read iterator.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result;
+
+    le_sdtp_Binding_t binding;
+    memset(&binding, 0, sizeof(binding));
+
+    binding.client = uid;
+
+    // Fetch the client's service name.
+    result = le_cfg_GetNodeName(i,
+                                "",
+                                binding.clientInterfaceName,
+                                sizeof(binding.clientInterfaceName));
+    if (result != LE_OK)
+    {
+        char path[LIMIT_MAX_PATH_BYTES];
+        le_cfg_GetPath(i, "", path, sizeof(path));
+        LE_CRIT("Configured client service name too long (@ %s)", path);
+        return LE_OK;
+    }
+
+    // Fetch the server's user ID.
+    result = GetServerUid(i, &binding.server);
+    if (result != LE_OK)
+    {
+        return LE_OK;
+    }
+
+    // Fetch the server's service name.
+    result = le_cfg_GetString(i,
+                              "interface",
+                              binding.serverInterfaceName,
+                              sizeof(binding.serverInterfaceName),
+                              "");
+    if (result != LE_OK)
+    {
+        char path[LIMIT_MAX_PATH_BYTES];
+        le_cfg_GetPath(i, "interface", path, sizeof(path));
+        LE_CRIT("Server interface name too big (@ %s)", path);
+        return LE_OK;
+    }
+    if (binding.serverInterfaceName[0] == '\0')
+    {
+        char path[LIMIT_MAX_PATH_BYTES];
+        le_cfg_GetPath(i, "interface", path, sizeof(path));
+        LE_CRIT("Server interface name missing (@ %s)", path);
+        return LE_OK;
+    }
+
+    if (fd_WriteSize(tableFd, &binding, sizeof(binding)) != sizeof(binding))
+    {
+        LE_ERROR("Failed to write binding table. Errno = %d (%m).", errno);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds all the bindings under the "bindings" node of each of the children of a given
+ * configuration node ("/users" or "/apps") to the binding table.
+ *
+ * @return LE_OK if successful, LE_FAULT if the table couldn't be written.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddBindings
+(
+    int tableFd,                ///< [in] File descriptor of the binding table.
+    le_cfg_IteratorRef_t i,     ///< [in] Configuration read iterator.
+    const char* path,           ///< [in] Path of the node whose children have bindings.
+    le_result_t (*getUidFunc)(le_cfg_IteratorRef_t, uid_t*) ///< [in] Gets a child's user ID.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_cfg_GoToNode(i, path);
+    le_result_t result = le_cfg_GoToFirstChild(i);
+    while (result == LE_OK)
+    {
+        uid_t uid;
+        if (getUidFunc(i, &uid) == LE_OK)
+        {
+            // Iterate over the bindings collection, adding each binding to the table.
+            le_cfg_GoToNode(i, "bindings");
+            result = le_cfg_GoToFirstChild(i);
+            while (result == LE_OK)
+            {
+                if (AddBinding(tableFd, uid, i) != LE_OK)
+                {
+                    return LE_FAULT;
+                }
+
+                result = le_cfg_GoToNextSibling(i);
+            }
+
+            // Go back up to the user or app node.
+            le_cfg_GoToNode(i, "../..");
+        }
+
+        // Move on to the next user or app.
+        result = le_cfg_GoToNextSibling(i);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an empty, anonymous file to hold the binding table.
+ *
+ * An anonymous memory file is used if the kernel supports memfd_create().  Otherwise, an unlinked
+ * file in TABLE_FALLBACK_DIR is used, so that nothing is left behind if this process dies.
+ *
+ * @return File descriptor of the file, or -1 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CreateTableFile
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd = syscall(SYS_memfd_create, "sdir_bindings", MFD_CLOEXEC);
+    if (fd >= 0)
+    {
+        return fd;
+    }
+
+    if ((errno != ENOSYS) && (errno != EINVAL))
+    {
+        LE_ERROR("Failed to create binding table. Errno = %d (%m).", errno);
+        return -1;
+    }
+
+    LE_DEBUG("memfd_create() not supported, using a temporary file for the binding table.");
+
+#ifdef O_TMPFILE
+    fd = open(TABLE_FALLBACK_DIR, O_TMPFILE | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd >= 0)
+    {
+        return fd;
+    }
+#endif
+
+    // O_TMPFILE isn't supported either (before 3.11, or by the file system), so create a named
+    // file and unlink it straight away.
+    char path[] = TABLE_FALLBACK_DIR "/sdir_bindingsXXXXXX";
+
+    fd = mkstemp(path);
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to create binding table file in '%s'. Errno = %d (%m).",
+                 TABLE_FALLBACK_DIR,
+                 errno);
+        return -1;
+    }
+
+    if (unlink(path) != 0)
+    {
+        LE_WARN("Failed to unlink '%s'. Errno = %d (%m).", path, errno);
+    }
+
+    if (fcntl(fd, F_SETFD, FD_CLOEXEC) != 0)
+    {
+        LE_ERROR("Failed to set close-on-exec on binding table. Errno = %d (%m).", errno);
+        fd_Close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a binding table containing all the bindings in the configuration tree.
+ *
+ * @return File descriptor of the table, or -1 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CreateBindingTable
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd = CreateTableFile();
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    le_cfg_ConnectService();
+
+    // Start a read transaction on the root of the "system" configuration tree.
+    le_cfg_IteratorRef_t i = le_cfg_CreateReadTxn("system:");
+
+    le_result_t result = AddBindings(fd, i, "/users", GetUserUid);
+    if (result == LE_OK)
+    {
+        result = AddBindings(fd, i, "/apps", GetAppUid);
+    }
+
+    le_cfg_CancelTxn(i);
+
+    le_cfg_DisconnectService();
+
+    if (result != LE_OK)
+    {
+        fd_Close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles the Service Directory closing the IPC session, which it does if it rejects a request.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SessionCloseHandler
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Not used.
+    void* contextPtr                ///< [in] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ERROR("Service Directory closed the session.");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates the Service Directory's bindings with the current state of the binding configuration
+ * settings in the configuration tree.  Doesn't return until the Service Directory has applied
+ * the changes.
+ *
+ * Bindings that are misconfigured are logged and skipped.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_COMM_ERROR if the Service Directory couldn't be reached, or it rejected the bindings.
+ *  - LE_FAULT if the binding table couldn't be created.
+ **/
+//--------------------------------------------------------------------------------------------------
+le_result_t sdirLoad_LoadBindings
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int tableFd = CreateBindingTable();
+    if (tableFd < 0)
+    {
+        return LE_FAULT;
+    }
+
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(LE_SDTP_PROTOCOL_ID,
+                                                             sizeof(le_sdtp_Msg_t));
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(protocolRef, LE_SDTP_INTERFACE_NAME);
+
+    le_msg_SetSessionCloseHandler(sessionRef, SessionCloseHandler, NULL);
+
+    le_result_t result = le_msg_TryOpenSessionSync(sessionRef);
+    if (result != LE_OK)
+    {
+        LE_ERROR("Can't communicate with the Service Directory (%s).", LE_RESULT_TXT(result));
+
+        fd_Close(tableFd);
+        le_msg_DeleteSession(sessionRef);
+
+        return LE_COMM_ERROR;
+    }
+
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+    le_sdtp_Msg_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
+
+    msgPtr->msgType = LE_SDTP_MSGID_LOAD;
+
+    // The table fd will be closed when the message is sent.
+    le_msg_SetFd(msgRef, tableFd);
+
+    msgRef = le_msg_RequestSyncResponse(msgRef);
+
+    if (msgRef == NULL)
+    {
+        LE_ERROR("Service Directory failed to load the bindings.");
+        result = LE_COMM_ERROR;
+    }
+    else
+    {
+        le_msg_ReleaseMsg(msgRef);
+    }
+
+    le_msg_DeleteSession(sessionRef);
+
+    return result;
+}
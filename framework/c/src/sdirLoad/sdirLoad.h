@@ -0,0 +1,37 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Service Directory Binding Loader API.
+ *
+ * Reads the binding configuration settings from the "system" configuration tree and replaces
+ * the Service Directory's bindings with them, using a single request to the Service Directory.
+ *
+ * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#ifndef SDIR_LOAD_H_INCLUDE_GUARD
+#define SDIR_LOAD_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates the Service Directory's bindings with the current state of the binding configuration
+ * settings in the configuration tree.  Doesn't return until the Service Directory has applied
+ * the changes.
+ *
+ * Bindings that are misconfigured are logged and skipped.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_COMM_ERROR if the Service Directory couldn't be reached, or it rejected the bindings.
+ *  - LE_FAULT if the binding table couldn't be created.
+ **/
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t sdirLoad_LoadBindings
+(
+    void
+);
+
+
+
+#endif // SDIR_LOAD_H_INCLUDE_GUARD
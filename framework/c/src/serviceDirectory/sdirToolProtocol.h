@@ -45,6 +45,12 @@ typedef enum
     LE_SDTP_MSGID_BIND,             ///< Create one binding.  The payload is the binding details.
                                     ///  If the Service Directory runs into an error, it will
                                     ///  drop the connection to the sdir tool without responding.
+
+    LE_SDTP_MSGID_LOAD,             ///< Replace all bindings with a binding table.  Payload is a
+                                    ///  file descriptor from which the table can be read.  The
+                                    ///  table is an array of le_sdtp_Binding_t filling the whole
+                                    ///  file.  If the table is invalid, the Service Directory
+                                    ///  will drop the connection without changing any bindings.
 }
 le_sdtp_MsgType_t;
 
@@ -65,4 +71,19 @@ typedef struct
 le_sdtp_Msg_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Binding table entry, as sent with LE_SDTP_MSGID_LOAD.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uid_t client;               ///< Unix user ID of the client.
+    uid_t server;               ///< Unix user ID of the server.
+    char clientInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES]; ///< Client's interface name.
+    char serverInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES]; ///< Server's interface name.
+}
+le_sdtp_Binding_t;
+
+
 #endif // SDIR_TOOL_PROTOCOL_H_INCLUDE_GUARD
@@ -98,31 +98,42 @@ User List ------> User --+---> Name               |        |        |
  * Each Binding object and Connection object holds a reference count on a User object.  A User
  * object will be deleted when all associated Binding objects and Connection objects are deleted.
  *
+ * So that opening and advertising services doesn't have to search these lists, the objects are
+ * also kept in hash map Indexes:
+ *  - the User Index, keyed by user ID,
+ *  - the Service Index of Server Connections, keyed by server User and service name,
+ *  - the Binding Index, keyed by client User and client interface name,
+ *  - the Unbound Clients Index of Groups of unbound Client Connections, keyed by client User and
+ *    client interface name (these Groups are what's kept on a User's Unbound Clients List), and
+ *  - the Service Bindings Index of Groups of Bindings, keyed by server User and service name.
+ *
+ * Each Index counts its look-ups, and the counts are reported by "sdir list --format=json".
+ *
  *
  * @section sd_theoryOfOperation Theory of Operation
  *
  * When a client connects and makes a request to open a service, the client's UID is looked up in
- * the User List.  The client User's Binding List is searched for the interface name provided by
- * the client.  If a matching Binding object is not found, the Client Connection object is added
- * to the User object's Unbound Clients List.  If a matching Binding object is found, it will
- * specify the server User object and service name.  The server's User's Service List will be
- * searched for a matching Server Connection object.  If no matching Server Connection can be
- * found, the Client Connection is added to the Binding object's Waiting Clients List.
- *
- * When a server connects and advertises a service, the server UID is looked-up in the User List.
- * The service name is then searched for in the Service List for that User.  If a Server Connection
- * object is not found for that service name on that User, the new one is is added to the list.
- * Otherwise, the new server connection is dropped.
- *
- * When a new Server Connection is added to a Service List, all users' Binding Lists are
- * searched for matching bindings, and if any that match have non-empty Waiting Clients Lists,
- * all those Client Connections are removed from those lists and dispatched to the new Server
- * Connection.
- *
- * When a Binding is added, it is added to the client's User object's Binding List.  That user's
- * Unbound Clients List will then be checked for matches to the new binding, and if any are found,
- * they will be removed from the Unbound Clients List and processed as though they are
- * new client connections (see above).
+ * the User Index.  The client User's binding for the interface name provided by the client is
+ * then looked up in the Binding Index.  If a matching Binding object is not found, the Client
+ * Connection object is added to the User object's Unbound Clients Group for that interface name.
+ * If a matching Binding object is found, it will specify the server User object and service name,
+ * and will point to the matching Server Connection object, if there is one.  If there isn't,
+ * the Client Connection is added to the Binding object's Waiting Clients List.
+ *
+ * When a server connects and advertises a service, the server UID is looked-up in the User Index.
+ * The service name is then looked-up in the Service Index for that User.  If a Server Connection
+ * object is not found for that service name on that User, the new one is is added to the User's
+ * Service List and the Service Index.  Otherwise, the new server connection is dropped.
+ *
+ * When a new Server Connection is added, the Group of Bindings to its service is looked-up in the
+ * Service Bindings Index.  Each of those Bindings is pointed at the new Server Connection, and if
+ * any have non-empty Waiting Clients Lists, all those Client Connections are removed from those
+ * lists and dispatched to the new Server Connection.
+ *
+ * When a Binding is added, it is added to the client User's Binding List, the Binding Index and
+ * the Group of Bindings to its service.  The Unbound Clients Group for the Binding's client
+ * User and interface name is then looked-up, and if there is one, its Client Connections will be
+ * removed from it and processed as though they are new client connections (see above).
  *
  * Likewise, if a Binding is deleted while it has Client Connections on its Waiting Clients List,
  * those Client Connections will be removed from that list and processed as though they are new
@@ -187,6 +198,14 @@ User List ------> User --+---> Name               |        |        |
  * So, instead, we created the "sdir load" tool and made the Supervisor run it before starting
  * any applications and made the installer run it after installing/removing any apps.
  *
+ * The loader (the sdirLoad component, shared by the "sdir" tool and the installer) reads every
+ * binding out of the Config Tree into a table and passes it to the Service Directory in a single
+ * "Load" request, through a file descriptor.  The Service Directory then replaces its bindings
+ * with the table's in one go: bindings that are in the table already are left alone, bindings
+ * that are no longer in it are deleted, and waiting clients are only checked once, after the
+ * whole table has been applied.  So reloading an unchanged configuration disturbs nothing, and
+ * no client ever gets connected through a half-loaded set of bindings.
+ *
  * @subsection sd_DesignNotesLateBind   Late Binding Updates
  *
  * Note that bindings can be updated after the client and/or server have already been started.
@@ -233,7 +252,8 @@ typedef struct
     char            name[LIMIT_MAX_USER_NAME_BYTES]; ///< Name of the user.
     le_dls_List_t   bindingList;        ///< List of bindings of user's client i/fs to services.
     le_dls_List_t   serviceList;        ///< List of services served up by this user.
-    le_dls_List_t   unboundClientsList; ///< List of Client Connections waiting to be bound.
+    le_dls_List_t   unboundClientsList; ///< List of Groups of Client Connections waiting to be
+                                        ///  bound, one Group per client interface name.
 }
 User_t;
 
@@ -250,6 +270,91 @@ static le_mem_PoolRef_t UserPoolRef;
 static le_dls_List_t UserList = LE_DLS_LIST_INIT;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key used to look up an object that belongs to a user by an interface name.  The key is stored
+ * inside the object it indexes, and its name points into that object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const User_t*   userPtr;            ///< Ptr to the User object.
+    const char*     name;               ///< Interface (or service) name.
+}
+NameKey_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A hash map used to look up objects, along with counters of how much the look-ups cost.  The
+ * counters are reported by the 'sdir list --format=json' command.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_hashmap_Ref_t    mapRef;         ///< The hash map.
+    size_t              lookupCount;    ///< Number of look-ups done in the map.
+    size_t              hitCount;       ///< Number of look-ups that found something.
+}
+Index_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Index of User objects, keyed by Unix user ID.
+//--------------------------------------------------------------------------------------------------
+static Index_t UserIndex;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Index of advertised services (Server Connection objects), keyed by server user and service name.
+//--------------------------------------------------------------------------------------------------
+static Index_t ServiceIndex;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Index of Binding objects, keyed by client user and client interface name.
+//--------------------------------------------------------------------------------------------------
+static Index_t BindingIndex;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Index of Groups of unbound Client Connections, keyed by client user and interface name.
+//--------------------------------------------------------------------------------------------------
+static Index_t UnboundClientsIndex;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Index of Groups of Binding objects, keyed by server user and the service name they bind to.
+//--------------------------------------------------------------------------------------------------
+static Index_t ServiceBindingsIndex;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A group of objects that belong to the same user and interface name.  Groups are used to find
+ * all the unbound Client Connections for a client interface, and all the Bindings to a service,
+ * without searching.  A Group is deleted when its last member leaves it.  Objects of this type
+ * are allocated from the Group Pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t   link;               ///< Used to link onto the owner list (if any).
+    le_dls_List_t*  ownerListPtr;       ///< Ptr to the list the Group is on (NULL if none).
+    Index_t*        indexPtr;           ///< Ptr to the Index the Group is in.
+    NameKey_t       key;                ///< Key of the Group in its Index.
+    char            name[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES]; ///< Interface name.
+    le_dls_List_t   memberList;         ///< List of members of the Group.
+}
+Group_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Pool from which Group objects are allocated.
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t GroupPoolRef;
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -265,6 +370,7 @@ typedef struct
     User_t*                     userPtr;        ///< Pointer to the User object for the client uid.
     pid_t                       pid;            ///< Process ID of client process.
     svcdir_InterfaceDetails_t   interface;      ///< IPC interface details.
+    NameKey_t                   key;            ///< Key in the Service Index (once advertised).
 }
 ServerConnection_t;
 
@@ -290,6 +396,14 @@ typedef struct
     char                serverInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];///< Service name
     ServerConnection_t* serverConnectionPtr;///< Ptr to Server Connection (NULL if service unavail.)
     le_dls_List_t       waitingClientsList; ///< List of Client Connections waiting for the service.
+    NameKey_t           key;                ///< Key in the Binding Index.
+    Group_t*            serviceGroupPtr;    ///< Ptr to the Group of Bindings to the same service.
+    le_dls_Link_t       serviceGroupLink;   ///< Used to link into the service's Group.
+    bool                isStale;            ///< true = not (yet) found in the table being loaded.
+#ifdef LE_MSG_DIRECT_CONNECT
+    bool                hasDirectEndpoint;  ///< true = the server may have opened a direct
+                                            ///  endpoint for the client interface.
+#endif
 }
 Binding_t;
 
@@ -308,7 +422,7 @@ static le_mem_PoolRef_t BindingPoolRef;
 typedef enum
 {
     CLIENT_STATE_ID_UNKNOWN,    ///< "Open" request not yet received from client. (START STATE)
-    CLIENT_STATE_UNBOUND,       ///< On user's Unbound Clients List.
+    CLIENT_STATE_UNBOUND,       ///< In a Group on user's Unbound Clients List.
     CLIENT_STATE_WAITING,       ///< On a binding's Waiting Clients List.
 }
 ClientConnectionState_t;
@@ -322,7 +436,7 @@ ClientConnectionState_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    le_dls_Link_t           link;           ///< Used to link onto unbound or waiting clients lists.
+    le_dls_Link_t           link;           ///< Used to link onto unbound Group or waiting list.
     ClientConnectionState_t state;          ///< State of the client connection.
     int                     fd;             ///< Fd of the connection socket.
     le_fdMonitor_Ref_t      fdMonitorRef;   ///< FD Monitor object monitoring this connection.
@@ -330,6 +444,8 @@ typedef struct
     pid_t                   pid;            ///< Process ID of client process.
     svcdir_InterfaceDetails_t interface;    ///< Interface details (protocol & interface name)
     Binding_t*              bindingPtr;     ///< Ptr to Binding whose Waiting Clients List we are on
+    Group_t*                groupPtr;       ///< Ptr to unbound clients Group we are in
+    bool                    wantsDirect;    ///< true = client asked for a direct endpoint.
 }
 ClientConnection_t;
 
@@ -364,12 +480,221 @@ static le_fdMonitor_Ref_t ClientSocketMonitorRef;
 static le_fdMonitor_Ref_t ServerSocketMonitorRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/// true while a binding table is being loaded.  New bindings are not followed by unbound clients
+/// until the whole table has been loaded.
+//--------------------------------------------------------------------------------------------------
+static bool IsLoadingBindings = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Maximum number of bindings in a binding table loaded by the 'sdir' tool.
+//--------------------------------------------------------------------------------------------------
+#define MAX_LOAD_BINDINGS 10000
+
+
 
 // =======================================
 //  FUNCTIONS
 // =======================================
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for Name Keys.
+ *
+ * @return The hash value of the key.
+ **/
+//--------------------------------------------------------------------------------------------------
+static size_t HashNameKey
+(
+    const void* keyPtr  ///< [in] Ptr to the Name Key.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const NameKey_t* nameKeyPtr = keyPtr;
+
+    return le_hashmap_HashString(nameKeyPtr->name) ^ nameKeyPtr->userPtr->uid;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for Name Keys.
+ *
+ * @return true if the keys refer to the same user and name.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool EqualsNameKey
+(
+    const void* firstKeyPtr,    ///< [in] Ptr to the first Name Key.
+    const void* secondKeyPtr    ///< [in] Ptr to the second Name Key.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const NameKey_t* firstPtr = firstKeyPtr;
+    const NameKey_t* secondPtr = secondKeyPtr;
+
+    return (   (firstPtr->userPtr == secondPtr->userPtr)
+            && (strcmp(firstPtr->name, secondPtr->name) == 0) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes an Index.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void InitIndex
+(
+    Index_t* indexPtr,                      ///< [in] Ptr to the Index to initialize.
+    const char* name,                       ///< [in] Name of the Index's hash map.
+    size_t capacity,                        ///< [in] Expected number of entries.
+    le_hashmap_HashFunc_t hashFunc,         ///< [in] Hash function for the keys.
+    le_hashmap_EqualsFunc_t equalsFunc      ///< [in] Equality function for the keys.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    indexPtr->mapRef = le_hashmap_Create(name, capacity, hashFunc, equalsFunc);
+    indexPtr->lookupCount = 0;
+    indexPtr->hitCount = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up a key in an Index and counts the look-up.
+ *
+ * @return Pointer to the object found, or NULL if not found.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void* LookUp
+(
+    Index_t* indexPtr,      ///< [in] Ptr to the Index to search.
+    const void* keyPtr      ///< [in] Ptr to the key to look for.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    void* objPtr = le_hashmap_Get(indexPtr->mapRef, keyPtr);
+
+    indexPtr->lookupCount++;
+
+    if (objPtr != NULL)
+    {
+        indexPtr->hitCount++;
+    }
+
+    return objPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up the Group for a given user and interface name.
+ *
+ * @return Pointer to the Group or NULL if there isn't one (the Group would be empty).
+ **/
+//--------------------------------------------------------------------------------------------------
+static Group_t* FindGroup
+(
+    Index_t* indexPtr,          ///< [in] Ptr to the Index of the Groups.
+    const User_t* userPtr,      ///< [in] Ptr to the User object.
+    const char* name            ///< [in] Interface (or service) name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    NameKey_t key = { .userPtr = userPtr, .name = name };
+
+    return LookUp(indexPtr, &key);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a member to the Group for a given user and interface name, creating the Group if it
+ * doesn't exist yet.
+ *
+ * @note The Group doesn't hold a reference on the User object.  Its members must hold one for as
+ *       long as they are in the Group.
+ *
+ * @return Pointer to the Group.
+ **/
+//--------------------------------------------------------------------------------------------------
+static Group_t* JoinGroup
+(
+    Index_t* indexPtr,              ///< [in] Ptr to the Index of the Groups.
+    le_dls_List_t* ownerListPtr,    ///< [in] List to keep a new Group on (NULL if none).
+    const User_t* userPtr,          ///< [in] Ptr to the User object.
+    const char* name,               ///< [in] Interface (or service) name.
+    le_dls_Link_t* memberLinkPtr    ///< [in] Ptr to the new member's link.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Group_t* groupPtr = FindGroup(indexPtr, userPtr, name);
+
+    if (groupPtr == NULL)
+    {
+        groupPtr = le_mem_ForceAlloc(GroupPoolRef);
+
+        groupPtr->link = LE_DLS_LINK_INIT;
+        groupPtr->ownerListPtr = ownerListPtr;
+        groupPtr->indexPtr = indexPtr;
+        groupPtr->memberList = LE_DLS_LIST_INIT;
+
+        // Note: we know the interface name is a valid length.
+        le_utf8_Copy(groupPtr->name, name, sizeof(groupPtr->name), NULL);
+
+        groupPtr->key.userPtr = userPtr;
+        groupPtr->key.name = groupPtr->name;
+
+        le_hashmap_Put(indexPtr->mapRef, &groupPtr->key, groupPtr);
+
+        if (ownerListPtr != NULL)
+        {
+            le_dls_Queue(ownerListPtr, &groupPtr->link);
+        }
+    }
+
+    le_dls_Queue(&groupPtr->memberList, memberLinkPtr);
+
+    return groupPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes a member from a Group.  Deletes the Group if that was its last member.
+ *
+ * @return true if the Group was deleted.
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool LeaveGroup
+(
+    Group_t* groupPtr,              ///< [in] Ptr to the Group.
+    le_dls_Link_t* memberLinkPtr    ///< [in] Ptr to the member's link.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Remove(&groupPtr->memberList, memberLinkPtr);
+
+    if (!le_dls_IsEmpty(&groupPtr->memberList))
+    {
+        return false;
+    }
+
+    le_hashmap_Remove(groupPtr->indexPtr->mapRef, &groupPtr->key);
+
+    if (groupPtr->ownerListPtr != NULL)
+    {
+        le_dls_Remove(groupPtr->ownerListPtr, &groupPtr->link);
+    }
+
+    le_mem_Release(groupPtr);
+
+    return true;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a User object for a given Unix user ID.
@@ -399,8 +724,9 @@ static User_t* CreateUser
     userPtr->serviceList = LE_DLS_LIST_INIT;
     userPtr->unboundClientsList = LE_DLS_LIST_INIT;
 
-    // Add it to the User List.
+    // Add it to the User List and the User Index.
     le_dls_Queue(&UserList, &userPtr->link);
+    le_hashmap_Put(UserIndex.mapRef, &userPtr->uid, userPtr);
 
     return userPtr;
 }
@@ -408,7 +734,7 @@ static User_t* CreateUser
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches the User List for a particular Unix user ID.  If found, increments the reference count
+ * Looks up a particular Unix user ID in the User Index.  If found, increments the reference count
  * on that object.  If not found, creates a new User object.
  *
  * @return Pointer to the User object.
@@ -420,19 +746,12 @@ static User_t* GetUser
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&UserList);
+    User_t* userPtr = LookUp(&UserIndex, &uid);
 
-    while (linkPtr != NULL)
+    if (userPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(linkPtr, User_t, link);
-
-        if (userPtr->uid == uid)
-        {
-            le_mem_AddRef(userPtr);
-            return userPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&UserList, linkPtr);
+        le_mem_AddRef(userPtr);
+        return userPtr;
     }
 
     return CreateUser(uid);
@@ -453,14 +772,15 @@ static void UserDestructor
 {
     User_t* userPtr = objPtr;
 
-    // Remove the User object from the User List.
+    // Remove the User object from the User List and the User Index.
     le_dls_Remove(&UserList, &userPtr->link);
+    le_hashmap_Remove(UserIndex.mapRef, &userPtr->uid);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches a (client) User's Binding List for a particular client-side interface name.
+ * Looks up a (client) User's binding for a particular client-side interface name.
  *
  * @return Pointer to the Binding object or NULL if not found.
  **/
@@ -472,21 +792,9 @@ static Binding_t* FindBinding
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&userPtr->bindingList);
-
-    while (linkPtr != NULL)
-    {
-        Binding_t* bindingPtr = CONTAINER_OF(linkPtr, Binding_t, link);
+    NameKey_t key = { .userPtr = userPtr, .name = interfaceName };
 
-        if (strcmp(bindingPtr->clientInterfaceName, interfaceName) == 0)
-        {
-            return bindingPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&userPtr->bindingList, linkPtr);
-    }
-
-    return NULL;
+    return LookUp(&BindingIndex, &key);
 }
 
 
@@ -597,9 +905,9 @@ static le_result_t ReceiveMessage
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches a User's Service List for a particular service name.
+ * Looks up a User's service by service name.
  *
- * @return Pointer to the Server Connection object for the matching service.
+ * @return Pointer to the Server Connection object for the matching service, or NULL if not found.
  **/
 //--------------------------------------------------------------------------------------------------
 static ServerConnection_t* FindService
@@ -609,21 +917,9 @@ static ServerConnection_t* FindService
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&userPtr->serviceList);
-
-    while (linkPtr != NULL)
-    {
-        ServerConnection_t* serverConnectionPtr = CONTAINER_OF(linkPtr, ServerConnection_t, link);
-
-        if (strcmp(serverConnectionPtr->interface.interfaceName, serviceName) == 0)
-        {
-            return serverConnectionPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&userPtr->serviceList, linkPtr);
-    }
+    NameKey_t key = { .userPtr = userPtr, .name = serviceName };
 
-    return NULL;
+    return LookUp(&ServiceIndex, &key);
 }
 
 
@@ -738,15 +1034,34 @@ static le_result_t DispatchToServer
 
     else
     {
+        // Tell the server who the client is, and whether it may also connect directly from now on.
+        // The client interface is bound to this service, so that has been checked already.
+        svcdir_ServerMsg_t msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.type = clientConnectionPtr->wantsDirect ? SVCDIR_SERVER_MSG_CONNECT_DIRECT
+                                                    : SVCDIR_SERVER_MSG_CONNECT;
+        msg.clientUid = clientConnectionPtr->userPtr->uid;
+        memcpy(msg.clientInterfaceName,
+               clientConnectionPtr->interface.interfaceName,
+               sizeof(msg.clientInterfaceName));
+
         // Send the client connection fd to the server.
         le_result_t result = unixSocket_SendMsg(serverConnectionPtr->fd,
-                                                NULL,   // dataPtr
-                                                0,      // dataSize
+                                                &msg,
+                                                sizeof(msg),
                                                 clientConnectionPtr->fd, // fdToSend
                                                 false); // sendCredentials
 
         if (result == LE_OK)
         {
+#ifdef LE_MSG_DIRECT_CONNECT
+            // Remember to revoke the direct endpoint if the binding goes away.
+            if (clientConnectionPtr->wantsDirect)
+            {
+                clientConnectionPtr->bindingPtr->hasDirectEndpoint = true;
+            }
+#endif
+
             LE_DEBUG("Client (uid %u '%s', pid %d) connected to server (uid %u '%s', pid %d) for "
                         "service '%s' (protocol ID = '%s').",
                      clientConnectionPtr->userPtr->uid,
@@ -775,6 +1090,56 @@ static le_result_t DispatchToServer
 }
 
 
+#ifdef LE_MSG_DIRECT_CONNECT
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tells the server of a binding's service to close the direct endpoint that it may have opened for
+ * the binding's client interface.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void RevokeDirectEndpoint
+(
+    Binding_t* bindingPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ServerConnection_t* serverConnectionPtr = bindingPtr->serverConnectionPtr;
+
+    if (bindingPtr->hasDirectEndpoint && (serverConnectionPtr != NULL))
+    {
+        svcdir_ServerMsg_t msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.type = SVCDIR_SERVER_MSG_REVOKE;
+        msg.clientUid = bindingPtr->clientUserPtr->uid;
+        le_utf8_Copy(msg.clientInterfaceName,
+                     bindingPtr->clientInterfaceName,
+                     sizeof(msg.clientInterfaceName),
+                     NULL);
+
+        LE_DEBUG("Revoking direct endpoint of <%s>.%s on <%s>.%s.",
+                 bindingPtr->clientUserPtr->name,
+                 bindingPtr->clientInterfaceName,
+                 bindingPtr->serverUserPtr->name,
+                 bindingPtr->serverInterfaceName);
+
+        le_result_t result = unixSocket_SendMsg(serverConnectionPtr->fd,
+                                                &msg,
+                                                sizeof(msg),
+                                                -1,     // fdToSend
+                                                false); // sendCredentials
+        if (result != LE_OK)
+        {
+            // The server seems to have failed.  If the server can't be told, it can't be allowed
+            // to keep the endpoint open, so close the server connection.
+            CloseServerConnection(serverConnectionPtr);
+        }
+    }
+
+    bindingPtr->hasDirectEndpoint = false;
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Processes a client connection by following a binding that matches that client connection.
@@ -832,6 +1197,37 @@ static void FollowBinding
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dispatches the unbound client connections that have been waiting for a binding (if any) via
+ * that binding.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void BindUnboundClients
+(
+    Binding_t* bindingPtr       ///< [in] The binding.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Group_t* groupPtr = FindGroup(&UnboundClientsIndex,
+                                  bindingPtr->clientUserPtr,
+                                  bindingPtr->clientInterfaceName);
+    bool isGroupDeleted = (groupPtr == NULL);
+
+    while (!isGroupDeleted)
+    {
+        ClientConnection_t* clientConnectionPtr = CONTAINER_OF(le_dls_Peek(&groupPtr->memberList),
+                                                               ClientConnection_t,
+                                                               link);
+
+        isGroupDeleted = LeaveGroup(groupPtr, &clientConnectionPtr->link);
+        clientConnectionPtr->groupPtr = NULL;
+
+        FollowBinding(bindingPtr, clientConnectionPtr, true /* shouldWait */ );
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a Binding object for a given binding between a client user's interface name and a
@@ -865,6 +1261,7 @@ static void CreateBinding
                     clientInterfaceName,
                     serverUserPtr->name,
                     serverInterfaceName);
+            oldBindingPtr->isStale = false;
             le_mem_Release(clientUserPtr);
             le_mem_Release(serverUserPtr);
             return;
@@ -916,33 +1313,33 @@ static void CreateBinding
 
     bindingPtr->serverConnectionPtr = NULL;
     bindingPtr->waitingClientsList = LE_DLS_LIST_INIT;
+    bindingPtr->isStale = false;
+#ifdef LE_MSG_DIRECT_CONNECT
+    bindingPtr->hasDirectEndpoint = false;
+#endif
 
-    // Add the Binding to the client User's Binding List.
+    // Add the Binding to the client User's Binding List and the Binding Index.
     le_dls_Queue(&bindingPtr->clientUserPtr->bindingList, &bindingPtr->link);
+    bindingPtr->key.userPtr = clientUserPtr;
+    bindingPtr->key.name = bindingPtr->clientInterfaceName;
+    le_hashmap_Put(BindingIndex.mapRef, &bindingPtr->key, bindingPtr);
+
+    // Add the Binding to the Group of Bindings to the same service, so the server can find it
+    // when it advertises the service.
+    bindingPtr->serviceGroupLink = LE_DLS_LINK_INIT;
+    bindingPtr->serviceGroupPtr = JoinGroup(&ServiceBindingsIndex,
+                                            NULL,
+                                            serverUserPtr,
+                                            bindingPtr->serverInterfaceName,
+                                            &bindingPtr->serviceGroupLink);
 
     // Look for a server serving the binding's destination service.
     bindingPtr->serverConnectionPtr = FindService(bindingPtr->serverUserPtr, serverInterfaceName);
 
-    // Check for unbound client connections that match the new binding.
-    le_dls_List_t* unboundClientsListPtr = &(bindingPtr->clientUserPtr->unboundClientsList);
-    le_dls_Link_t* linkPtr = le_dls_Peek(unboundClientsListPtr);
-    while (linkPtr != NULL)
+    // If a binding table is being loaded, unbound clients will be dealt with once it's loaded.
+    if (!IsLoadingBindings)
     {
-        ClientConnection_t* clientConnectionPtr = CONTAINER_OF(linkPtr, ClientConnection_t, link);
-
-        // Move the linkPtr to the next node in the list now, in case we have to remove
-        // the node it currently points to.
-        linkPtr = le_dls_PeekNext(unboundClientsListPtr, linkPtr);
-
-        // If this is the binding this client has been waiting for,
-        if (strcmp(clientConnectionPtr->interface.interfaceName, clientInterfaceName) == 0)
-        {
-            // Remove this client connection from the list of unbound clients and
-            // dispatch it via the binding.
-            // WARNING: Don't use linkPtr here, because it has been moved to the next node already.
-            le_dls_Remove(unboundClientsListPtr, &clientConnectionPtr->link);
-            FollowBinding(bindingPtr, clientConnectionPtr, true /* shouldWait */ );
-        }
+        BindUnboundClients(bindingPtr);
     }
 }
 
@@ -967,6 +1364,7 @@ static void CreateHardCodedBindings
     CreateBinding(uid, "le_sup_wdog", uid, "le_sup_wdog");
     CreateBinding(uid, "le_cfg", uid, "le_cfg");
     CreateBinding(uid, "le_cfgAdmin", uid, "le_cfgAdmin");
+    CreateBinding(uid, "le_cfgBatch", uid, "le_cfgBatch");
     CreateBinding(uid, "le_update", uid, "le_update");
     CreateBinding(uid, "le_updateCtrl", uid, "le_updateCtrl");
     CreateBinding(uid, "le_appRemove", uid, "le_appRemove");
@@ -990,51 +1388,44 @@ static void ResolveBindingsToServer
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // For each user,
-    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+    Group_t* groupPtr = FindGroup(&ServiceBindingsIndex,
+                                  connectionPtr->userPtr,
+                                  connectionPtr->interface.interfaceName);
+    if (groupPtr == NULL)
+    {
+        // No bindings to this service.
+        return;
+    }
 
-    while (userLinkPtr != NULL)
+    // For each of the bindings pointing at the new server's service,
+    le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&groupPtr->memberList);
+    while (bindingLinkPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+        Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, serviceGroupLink);
 
-        // For each of the user's bindings,
-        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
-        while (bindingLinkPtr != NULL)
-        {
-            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+        bindingPtr->serverConnectionPtr = connectionPtr;
 
-            // If the binding is pointing at the new server's service,
-            if (   (connectionPtr->userPtr == bindingPtr->serverUserPtr)
-                && (0 == strcmp(connectionPtr->interface.interfaceName,
-                                bindingPtr->serverInterfaceName))  )
+        // While there's still a client connection on the Waiting Clients List, get
+        // a pointer to the first one, without removing it from the list, then try
+        // to dispatch that client to the server.
+        le_dls_Link_t* clientLinkPtr;
+        while (NULL != (clientLinkPtr = le_dls_Peek(&bindingPtr->waitingClientsList)))
+        {
+            ClientConnection_t* clientConnectionPtr = CONTAINER_OF(clientLinkPtr,
+                                                                   ClientConnection_t,
+                                                                   link);
+            if (DispatchToServer(clientConnectionPtr, connectionPtr) == LE_CLOSED)
             {
-                bindingPtr->serverConnectionPtr = connectionPtr;
-
-                // While there's still a client connection on the Waiting Clients List, get
-                // a pointer to the first one, without removing it from the list, then try
-                // to dispatch that client to the server.
-                le_dls_Link_t* clientLinkPtr;
-                while (NULL != (clientLinkPtr = le_dls_Peek(&bindingPtr->waitingClientsList)))
-                {
-                    ClientConnection_t* clientConnectionPtr = CONTAINER_OF(clientLinkPtr,
-                                                                           ClientConnection_t,
-                                                                           link);
-                    if (DispatchToServer(clientConnectionPtr, connectionPtr) == LE_CLOSED)
-                    {
-                        // Server went down.  Client was left on the Waiting Clients List.
-                        // Server Connection destructor was run and it disconnected itself
-                        // from the Binding object.
-                        return;
-                    }
-                    // NOTE: If the server didn't go down, then the Client Connection has been
-                    // deleted and its destructor removed it from the Waiting Clients List.
-                }
+                // Server went down.  Client was left on the Waiting Clients List.
+                // Server Connection destructor was run and it disconnected itself
+                // from the Binding object.
+                return;
             }
+            // NOTE: If the server didn't go down, then the Client Connection has been
+            // deleted and its destructor removed it from the Waiting Clients List.
+        }
 
-            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
-        }
-
-        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+        bindingLinkPtr = le_dls_PeekNext(&groupPtr->memberList, bindingLinkPtr);
     }
 }
 
@@ -1068,8 +1459,11 @@ static void ProcessAdvertisementFromServer
     // connection to the service list.
     else
     {
-        // Add the object to the User's Service List.
+        // Add the object to the User's Service List and the Service Index.
         le_dls_Queue(&connectionPtr->userPtr->serviceList, &connectionPtr->link);
+        connectionPtr->key.userPtr = connectionPtr->userPtr;
+        connectionPtr->key.name = connectionPtr->interface.interfaceName;
+        le_hashmap_Put(ServiceIndex.mapRef, &connectionPtr->key, connectionPtr);
 
         LE_DEBUG("Server (uid %u '%s', pid %d) now serving service '%s' (%s).",
                  connectionPtr->userPtr->uid,
@@ -1173,7 +1567,11 @@ static void ProcessOpenRequestFromClient
         {
             connectionPtr->state = CLIENT_STATE_UNBOUND;
 
-            le_dls_Queue(&(connectionPtr->userPtr->unboundClientsList), &(connectionPtr->link));
+            connectionPtr->groupPtr = JoinGroup(&UnboundClientsIndex,
+                                                &(connectionPtr->userPtr->unboundClientsList),
+                                                connectionPtr->userPtr,
+                                                connectionPtr->interface.interfaceName,
+                                                &(connectionPtr->link));
 
             LE_DEBUG("Client interface <%s>.%s is unbound.",
                      connectionPtr->userPtr->name,
@@ -1239,6 +1637,9 @@ static void ClientReadHandler
         memcpy(&(clientConnectionPtr->interface),
                &(msg.interface),
                sizeof(clientConnectionPtr->interface));
+#ifdef LE_MSG_DIRECT_CONNECT
+        clientConnectionPtr->wantsDirect = msg.wantsDirect;
+#endif
         ProcessOpenRequestFromClient(clientConnectionPtr, msg.shouldWait);
     }
     // If an error occurred on the receive,
@@ -1309,6 +1710,8 @@ static void CreateClientConnection
     connectionPtr->userPtr = GetUser(uid);
     connectionPtr->pid = pid;
     connectionPtr->bindingPtr = NULL;
+    connectionPtr->groupPtr = NULL;
+    connectionPtr->wantsDirect = false;
 
     // Haven't received ID yet, so clear it out.
     memset(&connectionPtr->interface, 0, sizeof(connectionPtr->interface));
@@ -1348,8 +1751,9 @@ static void ClientConnectionDestructor
 
         case CLIENT_STATE_UNBOUND:
 
-            // Remove the connection from the user's list of unbound client connections.
-            le_dls_Remove(&connectionPtr->userPtr->unboundClientsList, &connectionPtr->link);
+            // Remove the connection from the user's unbound client connections.
+            LeaveGroup(connectionPtr->groupPtr, &connectionPtr->link);
+            connectionPtr->groupPtr = NULL;
 
             break;
 
@@ -1508,7 +1912,10 @@ static void ServerReadHandler
     bool alreadyReceivedServiceId = (connectionPtr->interface.interfaceName[0] != '\0');
 
     // Receive the service identity from the server.
-    result = ReceiveMessage(fd, &(connectionPtr->interface), sizeof(connectionPtr->interface));
+    // NOTE: Don't receive straight into the Server Connection object, because the interface name
+    //       it already has is its key in the Service Index.
+    svcdir_InterfaceDetails_t interface;
+    result = ReceiveMessage(fd, &interface, sizeof(interface));
 
     // If the connection has closed or there is simply nothing left to be received
     // from the socket,
@@ -1543,6 +1950,7 @@ static void ServerReadHandler
     else
     {
         // Got the service advertisement.  Now process it.
+        memcpy(&(connectionPtr->interface), &interface, sizeof(connectionPtr->interface));
         ProcessAdvertisementFromServer(connectionPtr);
     }
 }
@@ -1630,33 +2038,6 @@ static void ServerConnectionDestructor
 {
     ServerConnection_t* connectionPtr = objPtr;
 
-    // Disassociate the Server Connection object from all Binding objects that refer to it...
-
-    // For each user,
-    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
-
-    while (userLinkPtr != NULL)
-    {
-        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
-
-        // For each of the user's bindings,
-        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
-        while (bindingLinkPtr != NULL)
-        {
-            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
-
-            // If the binding is associated with the deleted server connection,
-            if (connectionPtr == bindingPtr->serverConnectionPtr)
-            {
-                bindingPtr->serverConnectionPtr = NULL;
-            }
-
-            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
-        }
-
-        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
-    }
-
     if (connectionPtr->interface.interfaceName[0] == '\0')
     {
         LE_DEBUG("Server (uid %u '%s', pid %d) disconnected without ever advertising a service.",
@@ -1673,12 +2054,37 @@ static void ServerConnectionDestructor
                  connectionPtr->interface.interfaceName,
                  connectionPtr->interface.protocolId);
 
-        // Remove the Server Connection from the User's Service List, if it has been added.
+        // Remove the Server Connection from the User's Service List and the Service Index, if it
+        // has been added, and disassociate it from all Binding objects that refer to it.
         // NOTE: If the connection is rejected because of a bad or duplicate advertisement,
         //       then the connection will not have made it into the user's list of services.
-        if (le_dls_IsInList(&connectionPtr->userPtr->serviceList, &connectionPtr->link))
+        if (FindService(connectionPtr->userPtr, connectionPtr->interface.interfaceName)
+            == connectionPtr)
         {
             le_dls_Remove(&connectionPtr->userPtr->serviceList, &connectionPtr->link);
+            le_hashmap_Remove(ServiceIndex.mapRef, &connectionPtr->key);
+
+            Group_t* groupPtr = FindGroup(&ServiceBindingsIndex,
+                                          connectionPtr->userPtr,
+                                          connectionPtr->interface.interfaceName);
+            if (groupPtr != NULL)
+            {
+                le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&groupPtr->memberList);
+                while (bindingLinkPtr != NULL)
+                {
+                    Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr,
+                                                         Binding_t,
+                                                         serviceGroupLink);
+                    bindingPtr->serverConnectionPtr = NULL;
+
+#ifdef LE_MSG_DIRECT_CONNECT
+                    // The server's direct endpoints go away with its connection.
+                    bindingPtr->hasDirectEndpoint = false;
+#endif
+
+                    bindingLinkPtr = le_dls_PeekNext(&groupPtr->memberList, bindingLinkPtr);
+                }
+            }
         }
     }
 
@@ -1769,8 +2175,17 @@ static void BindingDestructor
 {
     Binding_t* bindingPtr = objPtr;
 
-    // Remove the Binding object from the User's Binding List.
+#ifdef LE_MSG_DIRECT_CONNECT
+    // Stop the client from connecting directly to the service it was bound to.
+    RevokeDirectEndpoint(bindingPtr);
+#endif
+
+    // Remove the Binding object from the User's Binding List, the Binding Index and the Group of
+    // Bindings to its service.
     le_dls_Remove(&bindingPtr->clientUserPtr->bindingList, &bindingPtr->link);
+    le_hashmap_Remove(BindingIndex.mapRef, &bindingPtr->key);
+    LeaveGroup(bindingPtr->serviceGroupPtr, &bindingPtr->serviceGroupLink);
+    bindingPtr->serviceGroupPtr = NULL;
 
     // While the list of waiting clients is not empty, pop one off and process it.
     le_dls_Link_t* linkPtr;
@@ -1905,34 +2320,43 @@ static void SdirToolListWaitingClients
     {
         User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
 
-        // List all the unbound client connections:
-        le_dls_Link_t* clientLinkPtr = le_dls_Peek(&userPtr->unboundClientsList);
-        while (clientLinkPtr != NULL)
+        // List all the unbound client connections, one Group per client interface:
+        le_dls_Link_t* clientLinkPtr;
+        le_dls_Link_t* groupLinkPtr = le_dls_Peek(&userPtr->unboundClientsList);
+        while (groupLinkPtr != NULL)
         {
-            ClientConnection_t* connectionPtr = CONTAINER_OF(clientLinkPtr,
-                                                             ClientConnection_t,
-                                                             link);
+            Group_t* groupPtr = CONTAINER_OF(groupLinkPtr, Group_t, link);
 
-            if (strncmp(userPtr->name, "app", 3) == 0)
-            {
-                dprintf(fd,
-                        "        [pid %5d] %s.%s UNBOUND  (protocol ID = '%s')\n",
-                        connectionPtr->pid,
-                        userPtr->name + 3,
-                        connectionPtr->interface.interfaceName,
-                        connectionPtr->interface.protocolId);
-            }
-            else
+            clientLinkPtr = le_dls_Peek(&groupPtr->memberList);
+            while (clientLinkPtr != NULL)
             {
-                dprintf(fd,
-                        "        [pid %5d] <%s>.%s UNBOUND  (protocol ID = '%s')\n",
-                        connectionPtr->pid,
-                        userPtr->name,
-                        connectionPtr->interface.interfaceName,
-                        connectionPtr->interface.protocolId);
+                ClientConnection_t* connectionPtr = CONTAINER_OF(clientLinkPtr,
+                                                                 ClientConnection_t,
+                                                                 link);
+
+                if (strncmp(userPtr->name, "app", 3) == 0)
+                {
+                    dprintf(fd,
+                            "        [pid %5d] %s.%s UNBOUND  (protocol ID = '%s')\n",
+                            connectionPtr->pid,
+                            userPtr->name + 3,
+                            connectionPtr->interface.interfaceName,
+                            connectionPtr->interface.protocolId);
+                }
+                else
+                {
+                    dprintf(fd,
+                            "        [pid %5d] <%s>.%s UNBOUND  (protocol ID = '%s')\n",
+                            connectionPtr->pid,
+                            userPtr->name,
+                            connectionPtr->interface.interfaceName,
+                            connectionPtr->interface.protocolId);
+                }
+
+                clientLinkPtr = le_dls_PeekNext(&groupPtr->memberList, clientLinkPtr);
             }
 
-            clientLinkPtr = le_dls_PeekNext(&userPtr->unboundClientsList, clientLinkPtr);
+            groupLinkPtr = le_dls_PeekNext(&userPtr->unboundClientsList, groupLinkPtr);
         }
 
         // For each binding in the user's Binding List,
@@ -2176,36 +2600,45 @@ static void SdirToolListWaitingClientsJson
             clientTypeStr = "app";
         }
 
-        // List all the unbound client connections:
-        le_dls_Link_t* clientLinkPtr = le_dls_Peek(&userPtr->unboundClientsList);
-        while (clientLinkPtr != NULL)
+        // List all the unbound client connections, one Group per client interface:
+        le_dls_Link_t* clientLinkPtr;
+        le_dls_Link_t* groupLinkPtr = le_dls_Peek(&userPtr->unboundClientsList);
+        while (groupLinkPtr != NULL)
         {
-            ClientConnection_t* connectionPtr = CONTAINER_OF(clientLinkPtr,
-                                                             ClientConnection_t,
-                                                             link);
+            Group_t* groupPtr = CONTAINER_OF(groupLinkPtr, Group_t, link);
 
-            if (isFirstJsonEntry == false)
+            clientLinkPtr = le_dls_Peek(&groupPtr->memberList);
+            while (clientLinkPtr != NULL)
             {
-                // Not the first Json entry. So, print comma before dumping json entry.
-                dprintf(fd, ",");
-            }
+                ClientConnection_t* connectionPtr = CONTAINER_OF(clientLinkPtr,
+                                                                 ClientConnection_t,
+                                                                 link);
 
-            dprintf(fd, "{"
-                        "\"client\":{"
-                        "\"%s\":\"%s\","
-                        "\"interface\":\"%s\""
-                        "},"
-                        "\"pid\":%d,"
-                        "\"protocolId\":\"%s\""
-                        "}",
-                        clientTypeStr,
-                        userPtr->name + nameOffsetClient,
-                        connectionPtr->interface.interfaceName,
-                        connectionPtr->pid,
-                        connectionPtr->interface.protocolId);
+                if (isFirstJsonEntry == false)
+                {
+                    // Not the first Json entry. So, print comma before dumping json entry.
+                    dprintf(fd, ",");
+                }
 
-            isFirstJsonEntry = false;
-            clientLinkPtr = le_dls_PeekNext(&userPtr->unboundClientsList, clientLinkPtr);
+                dprintf(fd, "{"
+                            "\"client\":{"
+                            "\"%s\":\"%s\","
+                            "\"interface\":\"%s\""
+                            "},"
+                            "\"pid\":%d,"
+                            "\"protocolId\":\"%s\""
+                            "}",
+                            clientTypeStr,
+                            userPtr->name + nameOffsetClient,
+                            connectionPtr->interface.interfaceName,
+                            connectionPtr->pid,
+                            connectionPtr->interface.protocolId);
+
+                isFirstJsonEntry = false;
+                clientLinkPtr = le_dls_PeekNext(&groupPtr->memberList, clientLinkPtr);
+            }
+
+            groupLinkPtr = le_dls_PeekNext(&userPtr->unboundClientsList, groupLinkPtr);
         }
 
         // For each binding in the user's Binding List,
@@ -2351,6 +2784,56 @@ static void SdirToolListBindingsJson
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the size and look-up counters of an Index in json format.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintIndexJson
+(
+    int fd,                 ///< [in] The file descriptor to write the output to.
+    const char* name,       ///< [in] Name to print for the Index.
+    const Index_t* indexPtr ///< [in] Ptr to the Index.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    dprintf(fd, "\"%s\":{"
+                "\"entries\":%zu,"
+                "\"collisions\":%zu,"
+                "\"lookups\":%zu,"
+                "\"hits\":%zu"
+                "}",
+                name,
+                le_hashmap_Size(indexPtr->mapRef),
+                le_hashmap_CountCollisions(indexPtr->mapRef),
+                indexPtr->lookupCount,
+                indexPtr->hitCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lists the look-up counters of all the Indexes in json format.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolListLookupsJson
+(
+    int fd      ///< [in] The file descriptor to write the output to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    PrintIndexJson(fd, "users", &UserIndex);
+    dprintf(fd, ",");
+    PrintIndexJson(fd, "services", &ServiceIndex);
+    dprintf(fd, ",");
+    PrintIndexJson(fd, "bindings", &BindingIndex);
+    dprintf(fd, ",");
+    PrintIndexJson(fd, "unbound", &UnboundClientsIndex);
+    dprintf(fd, ",");
+    PrintIndexJson(fd, "serviceBindings", &ServiceBindingsIndex);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handles the "List" request from the 'sdir' tool. Dumps output in json format.
@@ -2382,7 +2865,12 @@ static void SdirToolListJson
 
         SdirToolListWaitingClientsJson(fd);
 
-        dprintf(fd, "]}\n");
+        dprintf(fd, "],"
+                    "\"lookups\":{");
+
+        SdirToolListLookupsJson(fd);
+
+        dprintf(fd, "}}\n");
 
         fd_Close(fd);
     }
@@ -2472,6 +2960,225 @@ static void SdirToolBind
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that an interface name received from the 'sdir' tool is not empty and is null
+ * terminated.
+ *
+ * @return true if the name is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsValidInterfaceName
+(
+    const char* name    ///< [in] Ptr to the interface name buffer.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t len = strnlen(name, LIMIT_MAX_IPC_INTERFACE_NAME_BYTES);
+
+    return ((len != 0) && (len != LIMIT_MAX_IPC_INTERFACE_NAME_BYTES));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes all the bindings that are still marked stale after a binding table has been loaded.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteStaleBindings
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+
+    while (userLinkPtr != NULL)
+    {
+        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+
+        // Increment the reference count on the User object to ensure that it doesn't go away
+        // when we delete its bindings.
+        le_mem_AddRef(userPtr);
+
+        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
+
+        while (bindingLinkPtr != NULL)
+        {
+            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+
+            // Move on before the destructor removes the binding from the User's Binding List.
+            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+
+            if (bindingPtr->isStale)
+            {
+                le_mem_Release(bindingPtr);
+            }
+        }
+
+        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+
+        le_mem_Release(userPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Follows the bindings of all the unbound client connections that now have one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResolveUnboundClients
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+
+    while (userLinkPtr != NULL)
+    {
+        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+
+        // Increment the reference count on the User object to ensure that it doesn't go away
+        // if its client connections are closed.
+        le_mem_AddRef(userPtr);
+
+        le_dls_Link_t* groupLinkPtr = le_dls_Peek(&userPtr->unboundClientsList);
+
+        while (groupLinkPtr != NULL)
+        {
+            Group_t* groupPtr = CONTAINER_OF(groupLinkPtr, Group_t, link);
+
+            // Move on before the Group is deleted by binding its clients.
+            groupLinkPtr = le_dls_PeekNext(&userPtr->unboundClientsList, groupLinkPtr);
+
+            Binding_t* bindingPtr = FindBinding(userPtr, groupPtr->name);
+            if (bindingPtr != NULL)
+            {
+                BindUnboundClients(bindingPtr);
+            }
+        }
+
+        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+
+        le_mem_Release(userPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles a "Load" request from the 'sdir' tool.
+ *
+ * The whole table is read and checked before any bindings are changed.  Bindings that are in
+ * both the old and the new tables are left alone, so clients already waiting on them are not
+ * disturbed.  Unbound clients are then resolved in one pass, once all the new bindings exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolLoad
+(
+    int fd      ///< [in] File descriptor to read the binding table from.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (fd == -1)
+    {
+        LE_KILL_CLIENT("No binding table fd provided.");
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        LE_KILL_CLIENT("Failed to stat binding table. Errno = %d (%m).", errno);
+        fd_Close(fd);
+        return;
+    }
+
+    if (   (st.st_size % sizeof(le_sdtp_Binding_t) != 0)
+        || ((st.st_size / sizeof(le_sdtp_Binding_t)) > MAX_LOAD_BINDINGS) )
+    {
+        LE_KILL_CLIENT("Binding table has invalid size %lld.", (long long)st.st_size);
+        fd_Close(fd);
+        return;
+    }
+
+    size_t count = st.st_size / sizeof(le_sdtp_Binding_t);
+    le_sdtp_Binding_t* tablePtr = NULL;
+
+    // Copy the table, so that it can't change after it has been checked.
+    if (count > 0)
+    {
+        tablePtr = malloc(count * sizeof(le_sdtp_Binding_t));
+        LE_ASSERT(tablePtr != NULL);
+
+        if (fd_ReadFromOffset(fd, 0, tablePtr, count * sizeof(le_sdtp_Binding_t)) != LE_OK)
+        {
+            LE_KILL_CLIENT("Failed to read binding table.");
+            free(tablePtr);
+            fd_Close(fd);
+            return;
+        }
+    }
+
+    fd_Close(fd);
+
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        if (   !IsValidInterfaceName(tablePtr[i].clientInterfaceName)
+            || !IsValidInterfaceName(tablePtr[i].serverInterfaceName) )
+        {
+            LE_KILL_CLIENT("Invalid interface name in binding table entry %zu.", i);
+            free(tablePtr);
+            return;
+        }
+    }
+
+    LE_DEBUG("Loading %zu bindings.", count);
+
+    // Mark all the existing bindings stale.  Loading a binding that already exists clears the mark.
+    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+    while (userLinkPtr != NULL)
+    {
+        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+
+        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
+        while (bindingLinkPtr != NULL)
+        {
+            CONTAINER_OF(bindingLinkPtr, Binding_t, link)->isStale = true;
+
+            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+        }
+
+        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+    }
+
+    IsLoadingBindings = true;
+
+    // The built-in, hard-coded bindings are always part of the table.
+    CreateHardCodedBindings();
+
+    for (i = 0; i < count; i++)
+    {
+        CreateBinding(tablePtr[i].client,
+                      tablePtr[i].clientInterfaceName,
+                      tablePtr[i].server,
+                      tablePtr[i].serverInterfaceName);
+    }
+
+    free(tablePtr);
+
+    // Clients waiting on deleted bindings become unbound, and are resolved along with the others.
+    DeleteStaleBindings();
+
+    IsLoadingBindings = false;
+
+    ResolveUnboundClients();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Process a message received from the "sdir" tool.
@@ -2508,6 +3215,11 @@ static void SdirToolRecv
             SdirToolBind(msgPtr);
             break;
 
+        case LE_SDTP_MSGID_LOAD:
+
+            SdirToolLoad(le_msg_GetFd(msgRef));
+            break;
+
         default:
             LE_KILL_CLIENT("Invalid message ID %d.", msgPtr->msgType);
             break;
@@ -2555,6 +3267,7 @@ COMPONENT_INIT
     ServerConnectionPoolRef = le_mem_CreatePool("Server Connection", sizeof(ServerConnection_t));
     UserPoolRef = le_mem_CreatePool("User", sizeof(User_t));
     BindingPoolRef = le_mem_CreatePool("Binding", sizeof(Binding_t));
+    GroupPoolRef = le_mem_CreatePool("Group", sizeof(Group_t));
 
     /// Expand the pools to their expected maximum sizes.
     /// @todo Make this configurable.
@@ -2562,6 +3275,14 @@ COMPONENT_INIT
     le_mem_ExpandPool(ServerConnectionPoolRef, 30);
     le_mem_ExpandPool(UserPoolRef, 30);
     le_mem_ExpandPool(BindingPoolRef, 30);
+    le_mem_ExpandPool(GroupPoolRef, 30);
+
+    // Create the Indexes.
+    InitIndex(&UserIndex, "Users", 30, le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+    InitIndex(&ServiceIndex, "Services", 30, HashNameKey, EqualsNameKey);
+    InitIndex(&BindingIndex, "Bindings", 30, HashNameKey, EqualsNameKey);
+    InitIndex(&UnboundClientsIndex, "UnboundClients", 30, HashNameKey, EqualsNameKey);
+    InitIndex(&ServiceBindingsIndex, "ServiceBindings", 30, HashNameKey, EqualsNameKey);
 
     // Register destructor functions.
     le_mem_SetDestructor(ClientConnectionPoolRef, ClientConnectionDestructor);
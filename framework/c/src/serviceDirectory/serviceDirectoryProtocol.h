@@ -5,6 +5,7 @@
  * @ref serviceDirectoryProtocol_SocketsAndCredentials <br>
  * @ref serviceDirectoryProtocol_Servers <br>
  * @ref serviceDirectoryProtocol_Clients <br>
+ * @ref serviceDirectoryProtocol_Direct <br>
  * @ref serviceDirectoryProtocol_Packing
  *
  * @section serviceDirectoryProtocol_Intro Introduction
@@ -40,9 +41,10 @@
  *       are connected to the service.
  *
  * When a client connects to a service, the Service Directory will send the server a file descriptor
- * of a Unix Domain SOCK_SEQPACKET socket that is connected to the client.  The server should then
- * send a welcome message (LE_OK) to the client over that connection and switch to using the
- * protocol that it advertised for that service.
+ * of a Unix Domain SOCK_SEQPACKET socket that is connected to the client, along with a
+ * svcdir_ServerMsg_t identifying the client.  The server should then send a welcome message (LE_OK)
+ * to the client over that connection and switch to using the protocol that it advertised for that
+ * service.
  *
  * @note This implies a pair of connected sockets per session.
  *
@@ -85,6 +87,29 @@
  * @note The client socket is a named socket, rather than an abstract socket because this allows
  *       file system permissions to be used to prevent DoS attacks on this socket.
  *
+ * @section serviceDirectoryProtocol_Direct Direct Connections
+ *
+ * A client that keeps opening sessions on the same interface can set wantsDirect in its "Open"
+ * request.  If the request is dispatched to a server, the Service Directory tells the server
+ * (SVCDIR_SERVER_MSG_CONNECT_DIRECT) that it may also accept later connections from that client
+ * user's interface directly.  The server then opens a listening socket in the abstract namespace
+ * for that client user and interface, and sends the socket's name to the client with its welcome
+ * message.  From then on, the client can connect straight to that socket, without going through
+ * the Service Directory.
+ *
+ * Abstract socket names are not secret (any process can list them in /proc/net/unix) and any
+ * process can connect to them.  The only access control on a direct endpoint is the server's
+ * SO_PEERCRED check: connections from any user other than the client user it was opened for are
+ * closed straight away.
+ *
+ * When the binding of that client interface is removed or changed, the Service Directory tells the
+ * server (SVCDIR_SERVER_MSG_REVOKE) to close the listening socket.  Clients that then fail to
+ * connect to it go back to opening their sessions through the Service Directory.
+ *
+ * Direct connections are only supported when the framework is built with LE_MSG_DIRECT_CONNECT
+ * (see @ref c_le_build_cfg).  Without it, the Service Directory ignores wantsDirect and never
+ * sends either of these messages.
+ *
  * @section serviceDirectoryProtocol_Packing Byte Ordering and Packing
  *
  * This protocol only goes between processes on the same host, so there's no need to do
@@ -161,8 +186,41 @@ typedef struct
                             ///         the service at this time.
                             ///  false = fail immediately if either a binding or advertisement is
                             ///         missing at this time.
+
+    bool wantsDirect;       ///< true = ask the server for a direct connection endpoint, to be used
+                            ///         for later sessions on this interface.
 }
 svcdir_OpenRequest_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Types of message sent from the Service Directory to a server.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    SVCDIR_SERVER_MSG_CONNECT,          ///< Comes with the fd of a client connection.
+    SVCDIR_SERVER_MSG_CONNECT_DIRECT,   ///< Comes with the fd of a client connection.  The client
+                                        ///  may also connect directly from now on.
+    SVCDIR_SERVER_MSG_REVOKE,           ///< No fd.  The client may no longer connect directly.
+}
+svcdir_ServerMsgType_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message sent from the Service Directory to a server over the server's connection.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    svcdir_ServerMsgType_t  type;           ///< Type of message.
+    uid_t                   clientUid;      ///< Unix user ID of the client.
+    char                    clientInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];
+                                            ///< Name of the client's interface.
+}
+svcdir_ServerMsg_t;
+
+
 #endif // LEGATO_SERVICE_DIRECTORY_PROTOCOL_INCLUDE_GUARD
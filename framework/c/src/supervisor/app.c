@@ -57,6 +57,7 @@
 #include "dir.h"
 #include "fileDescriptor.h"
 #include "fileSystem.h"
+#include "properties.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -165,6 +166,15 @@
 #define MAX_DEVICE_PERM_STR_BYTES                       3
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The app's info file in its install directory, and the key of the app's md5 hash in that file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define APP_INFO_FILE                                   "info.properties"
+#define KEY_STR_MD5                                     "app.md5"
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * File link object.  Used to hold links that should be created for applications.
@@ -327,6 +337,8 @@ typedef struct app_Ref
     le_dls_List_t   procs;              // List of processes in this application.
     le_dls_List_t   auxProcs;           // List of auxiliary processes in this application.
     le_timer_Ref_t  killTimer;          // Timeout timer for killing processes.
+    bool            tmpFsReady;         // true if the sandbox's /tmp was mounted and linked by a
+                                        // previous start of this app.
 }
 App_t;
 
@@ -339,6 +351,42 @@ App_t;
 static le_mem_PoolRef_t AppPool;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record of a sandboxed app's runtime area that has been fully set up (linked and mounted), and of
+ * the version of the app and of its bundles and requires config that it was set up for.  These
+ * outlive the app objects so that an app that is re-created can reuse its runtime area if neither
+ * the installed app nor the files it links in have changed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char            name[LIMIT_MAX_APP_NAME_BYTES]; // Name of the application.
+    char            md5[LIMIT_MD5_STR_BYTES];       // md5 hash of the app it was set up for.
+    uint32_t        linksHash;                      // Hash of the bundles and requires config.
+    le_sls_Link_t   link;                           // Link in the list of prepared sandboxes.
+}
+PreparedSandbox_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for prepared sandbox records.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PreparedSandboxPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of prepared sandbox records.  Sandboxes may be set up from several threads, so this list
+ * is protected by the PreparedSandboxMutexRef.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sls_List_t PreparedSandboxList = LE_SLS_LIST_INIT;
+static le_mutex_Ref_t PreparedSandboxMutexRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prototype for process stopped handler.
@@ -831,10 +879,6 @@ static le_result_t SetSmackRules
     app_Ref_t appRef                    ///< [IN] Reference to the application.
 )
 {
-    // Clear out any residual SMACK rules from a previous incarnation of the Legato framework,
-    // in case it wasn't shut down cleanly.
-    CleanupAppSmackSettings(appRef);
-
     // Get the app label.
     char appLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
     smack_GetAppLabel(appRef->name, appLabel, sizeof(appLabel));
@@ -1505,15 +1549,16 @@ static le_result_t RecursivelyCreateLinks
     FTS* ftsPtr = NULL;
     errno = 0;
 
+    // Don't let fts change the working directory, sandboxes may be set up on several threads.
     do
     {
         if (appRef->sandboxed)
         {
-            ftsPtr = fts_open(pathArrayPtr, FTS_LOGICAL | FTS_NOSTAT, NULL);
+            ftsPtr = fts_open(pathArrayPtr, FTS_LOGICAL | FTS_NOSTAT | FTS_NOCHDIR, NULL);
         }
         else
         {
-            ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL | FTS_NOSTAT, NULL);
+            ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL | FTS_NOSTAT | FTS_NOCHDIR, NULL);
         }
     }
     while ( (ftsPtr == NULL) && (errno == EINTR) );
@@ -1611,6 +1656,139 @@ static le_result_t CreateDefaultTmpLinks
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties the sandbox's /tmp left behind by a previous run of the app so that it can be reused.
+ * The default links into the /tmp are kept, everything the app created is removed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the /tmp could not be reused.  It should be mounted again.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ClearTmpFs
+(
+    app_Ref_t appRef                    ///< [IN] Application reference.
+)
+{
+    char tmpPath[LIMIT_MAX_PATH_BYTES] = "";
+
+    if (le_path_Concat("/", tmpPath, sizeof(tmpPath), appRef->workingDir, "tmp", NULL) != LE_OK)
+    {
+        LE_ERROR("Path '%s...' is too long.", tmpPath);
+        return LE_FAULT;
+    }
+
+    // Check that the tmpfs is still mounted.
+    struct stat workingDirStat;
+    struct stat tmpStat;
+
+    if ( (stat(appRef->workingDir, &workingDirStat) == -1) ||
+         (stat(tmpPath, &tmpStat) == -1) ||
+         (tmpStat.st_dev == workingDirStat.st_dev) )
+    {
+        LE_WARN("The /tmp of app '%s' is no longer mounted.", appRef->name);
+        return LE_FAULT;
+    }
+
+    // Check that the default links still point to their sources.
+    int i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(DefaultTmpLinks); i++)
+    {
+        char destPath[LIMIT_MAX_PATH_BYTES] = "";
+        struct stat srcStat;
+        struct stat destStat;
+
+        if ( (GetAbsDestPath(DefaultTmpLinks[i].dest, DefaultTmpLinks[i].src, appRef->workingDir,
+                             destPath, sizeof(destPath)) != LE_OK) ||
+             (stat(DefaultTmpLinks[i].src, &srcStat) == -1) ||
+             (stat(destPath, &destStat) == -1) ||
+             (srcStat.st_ino != destStat.st_ino) ||
+             (srcStat.st_dev != destStat.st_dev) )
+        {
+            LE_WARN("Link '%s' in app '%s' is stale.", DefaultTmpLinks[i].dest, appRef->name);
+            return LE_FAULT;
+        }
+    }
+
+    // Remove everything that is on the tmpfs itself.  The default links are bind mounts from
+    // other file systems so they, and the directories holding them, are left in place.
+    char* pathArrayPtr[] = {tmpPath, NULL};
+
+    FTS* ftsPtr = NULL;
+    errno = 0;
+
+    do
+    {
+        ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL | FTS_XDEV | FTS_NOCHDIR, NULL);
+    }
+    while ( (ftsPtr == NULL) && (errno == EINTR) );
+
+    if (ftsPtr == NULL)
+    {
+        LE_ERROR("Could open directory '%s'.  %m.", tmpPath);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+    FTSENT* entPtr;
+
+    while ( (result == LE_OK) && ((entPtr = fts_read(ftsPtr)) != NULL) )
+    {
+        switch (entPtr->fts_info)
+        {
+            case FTS_DNR:
+            case FTS_ERR:
+            case FTS_NS:
+                LE_ERROR("Could not read '%s'.  %s.", entPtr->fts_path,
+                         strerror(entPtr->fts_errno));
+                result = LE_FAULT;
+                break;
+
+            case FTS_D:
+                break;
+
+            case FTS_DP:
+                if ( (entPtr->fts_level > FTS_ROOTLEVEL) &&
+                     (entPtr->fts_statp->st_dev == tmpStat.st_dev) &&
+                     (rmdir(entPtr->fts_path) == -1) &&
+                     (errno != ENOTEMPTY) && (errno != EEXIST) && (errno != EBUSY) )
+                {
+                    LE_ERROR("Could not remove directory '%s'.  %m.", entPtr->fts_path);
+                    result = LE_FAULT;
+                }
+                break;
+
+            default:
+                if ( (entPtr->fts_statp->st_dev == tmpStat.st_dev) &&
+                     (unlink(entPtr->fts_path) == -1) )
+                {
+                    LE_ERROR("Could not remove '%s'.  %m.", entPtr->fts_path);
+                    result = LE_FAULT;
+                }
+                break;
+        }
+    }
+
+    if ( (result == LE_OK) && (errno != 0) )
+    {
+        LE_ERROR("Could not read directory '%s'.  %m", tmpPath);
+        result = LE_FAULT;
+    }
+
+    // Close the directory tree.
+    int r;
+    do
+    {
+        r = fts_close(ftsPtr);
+    }
+    while ( (r == -1) && (errno == EINTR) );
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create links to the default libs and files that all app's will likely need.
@@ -2144,6 +2322,269 @@ static le_result_t SetupAppArea
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the md5 hash of the installed version of an app.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetInstalledMd5
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    char* bufPtr,                       ///< [OUT] Buffer to hold the md5 string.
+    size_t bufSize                      ///< [IN] Size of the buffer.
+)
+{
+    char infoFilePath[LIMIT_MAX_PATH_BYTES] = "";
+
+    if (le_path_Concat("/", infoFilePath, sizeof(infoFilePath),
+                       appRef->installDirPath, APP_INFO_FILE, NULL) != LE_OK)
+    {
+        LE_ERROR("Path to app %s's %s is too long.", appRef->name, APP_INFO_FILE);
+        return LE_FAULT;
+    }
+
+    if (properties_GetValueForKey(infoFilePath, KEY_STR_MD5, bufPtr, bufSize) != LE_OK)
+    {
+        LE_WARN("Could not get the md5 hash of app '%s'.", appRef->name);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a block of bytes to an FNV-1a hash.
+ *
+ * @return
+ *      The new hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HashBytes
+(
+    uint32_t hash,                      ///< [IN] Hash so far.
+    const void* dataPtr,                ///< [IN] Bytes to add.
+    size_t dataSize                     ///< [IN] Number of bytes to add.
+)
+{
+    const uint8_t* bytePtr = dataPtr;
+
+    for (size_t i = 0; i < dataSize; i++)
+    {
+        hash = (hash ^ bytePtr[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds the names, types and values of all the nodes below an iterator's current node to a hash.
+ * The iterator is left on the same node.
+ *
+ * @return
+ *      The new hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HashConfigSubtree
+(
+    le_cfg_IteratorRef_t cfgIter,       ///< [IN] Config iterator.
+    uint32_t hash                       ///< [IN] Hash so far.
+)
+{
+    if (le_cfg_GoToFirstChild(cfgIter) != LE_OK)
+    {
+        return hash;
+    }
+
+    do
+    {
+        char buffer[LIMIT_MAX_PATH_BYTES] = "";
+        le_cfg_nodeType_t nodeType = le_cfg_GetNodeType(cfgIter, "");
+
+        le_cfg_GetNodeName(cfgIter, "", buffer, sizeof(buffer));
+        hash = HashBytes(hash, buffer, strlen(buffer) + 1);
+        hash = HashBytes(hash, &nodeType, sizeof(nodeType));
+
+        if (nodeType == LE_CFG_TYPE_STEM)
+        {
+            hash = HashConfigSubtree(cfgIter, hash);
+
+            // Mark the end of the stem, so that nodes can't move between levels unnoticed.
+            hash = HashBytes(hash, "", 1);
+        }
+        else
+        {
+            le_cfg_GetString(cfgIter, "", buffer, sizeof(buffer), "");
+            hash = HashBytes(hash, buffer, strlen(buffer) + 1);
+        }
+    }
+    while (le_cfg_GoToNextSibling(cfgIter) == LE_OK);
+
+    le_cfg_GoToParent(cfgIter);
+
+    return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a hash of an app's bundles and requires config, which say what is linked into its runtime
+ * area.  This config can be changed at runtime, so a runtime area must not be reused if it was set
+ * up for different config.
+ *
+ * @return
+ *      The hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetLinksConfigHash
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+{
+    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(appRef->cfgPathRoot);
+
+    uint32_t hash = 2166136261u;
+
+    le_cfg_GoToNode(appCfg, CFG_NODE_BUNDLES);
+    hash = HashConfigSubtree(appCfg, hash);
+    hash = HashBytes(hash, "", 1);
+
+    le_cfg_GoToParent(appCfg);
+    le_cfg_GoToNode(appCfg, CFG_NODE_REQUIRES);
+    hash = HashConfigSubtree(appCfg, hash);
+
+    le_cfg_CancelTxn(appCfg);
+
+    return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the prepared sandbox record for an app.
+ *
+ * @note The PreparedSandboxMutexRef must be held.
+ *
+ * @return
+ *      A pointer to the record.
+ *      NULL if the app's sandbox has never been prepared.
+ */
+//--------------------------------------------------------------------------------------------------
+static PreparedSandbox_t* GetPreparedSandbox
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+{
+    le_sls_Link_t* linkPtr = le_sls_Peek(&PreparedSandboxList);
+
+    while (linkPtr != NULL)
+    {
+        PreparedSandbox_t* sandboxPtr = CONTAINER_OF(linkPtr, PreparedSandbox_t, link);
+
+        if (strcmp(sandboxPtr->name, appRef->name) == 0)
+        {
+            return sandboxPtr;
+        }
+
+        linkPtr = le_sls_PeekNext(&PreparedSandboxList, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a sandboxed app's runtime area is still set up for the installed version of the
+ * app and for its current bundles and requires config.  If the runtime area was set up for another
+ * version or other config, it is unmounted so that links to files that the app no longer has or
+ * requires don't stay in its sandbox.
+ *
+ * @return
+ *      true if the runtime area can be used as is.
+ *      false if it must be set up.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSandboxPrepared
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    const char* md5Ptr,                 ///< [IN] md5 hash of the installed app.  Empty if unknown.
+    uint32_t linksHash                  ///< [IN] Hash of the app's bundles and requires config.
+)
+{
+    bool isPrepared = false;
+
+    le_mutex_Lock(PreparedSandboxMutexRef);
+
+    PreparedSandbox_t* sandboxPtr = GetPreparedSandbox(appRef);
+
+    if ( (sandboxPtr != NULL) && (sandboxPtr->md5[0] != '\0') )
+    {
+        if ( (md5Ptr[0] != '\0') &&
+             (strcmp(sandboxPtr->md5, md5Ptr) == 0) &&
+             (sandboxPtr->linksHash == linksHash) &&
+             fs_IsMountPoint(appRef->workingDir) )
+        {
+            isPrepared = true;
+        }
+        else
+        {
+            LE_INFO("App '%s' or its config has changed since its runtime area was set up.",
+                    appRef->name);
+
+            fs_TryLazyUmount(appRef->workingDir);
+            sandboxPtr->md5[0] = '\0';
+        }
+    }
+
+    le_mutex_Unlock(PreparedSandboxMutexRef);
+
+    return isPrepared;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records that a sandboxed app's runtime area has been set up for a version of the app and for its
+ * bundles and requires config.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordPreparedSandbox
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    const char* md5Ptr,                 ///< [IN] md5 hash of the installed app.
+    uint32_t linksHash                  ///< [IN] Hash of the app's bundles and requires config.
+)
+{
+    le_mutex_Lock(PreparedSandboxMutexRef);
+
+    PreparedSandbox_t* sandboxPtr = GetPreparedSandbox(appRef);
+
+    if (sandboxPtr == NULL)
+    {
+        sandboxPtr = le_mem_ForceAlloc(PreparedSandboxPool);
+
+        LE_ASSERT(le_utf8_Copy(sandboxPtr->name, appRef->name, sizeof(sandboxPtr->name), NULL)
+                  == LE_OK);
+        sandboxPtr->link = LE_SLS_LINK_INIT;
+
+        le_sls_Queue(&PreparedSandboxList, &(sandboxPtr->link));
+    }
+
+    LE_ASSERT(le_utf8_Copy(sandboxPtr->md5, md5Ptr, sizeof(sandboxPtr->md5), NULL) == LE_OK);
+    sandboxPtr->linksHash = linksHash;
+
+    le_mutex_Unlock(PreparedSandboxMutexRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the application system.
@@ -2156,6 +2597,8 @@ void app_Init
 {
     AppPool = le_mem_CreatePool("Apps", sizeof(App_t));
     ProcContainerPool = le_mem_CreatePool("ProcContainers", sizeof(ProcContainer_t));
+    PreparedSandboxPool = le_mem_CreatePool("PreparedSandboxes", sizeof(PreparedSandbox_t));
+    PreparedSandboxMutexRef = le_mutex_CreateNonRecursive("PreparedSandboxes");
 
     proc_Init();
 
@@ -2234,7 +2677,8 @@ static ProcContainer_t* CreateProcContainer
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Creates an application object.
+ * Creates an application object.  The application's sandbox must be set up with
+ * app_SetupSandbox() before the application can be started.
  *
  * @note
  *      The name of the application is the node name (last part) of the cfgPathRootPtr.
@@ -2270,6 +2714,7 @@ app_Ref_t app_Create
     appPtr->auxProcs = LE_DLS_LIST_INIT;
     appPtr->state = APP_STATE_STOPPED;
     appPtr->killTimer = NULL;
+    appPtr->tmpFsReady = false;
 
     // Get a config iterator for this app.
     le_cfg_IteratorRef_t cfgIterator = le_cfg_CreateReadTxn(appPtr->cfgPathRoot);
@@ -2359,31 +2804,92 @@ app_Ref_t app_Create
         while (le_cfg_GoToNextSibling(cfgIterator) == LE_OK);
     }
 
+    // Clear out any residual SMACK rules from a previous incarnation of the Legato framework,
+    // in case it wasn't shut down cleanly.  This is done here rather than when the sandbox is set
+    // up so that it can't revoke rules that a concurrent sandbox setup has just granted to this
+    // app's clients.
+    CleanupAppSmackSettings(appPtr);
+
+    le_cfg_CancelTxn(cfgIterator);
+    return appPtr;
+
+failed:
+
+    app_Delete(appPtr);
+    le_cfg_CancelTxn(cfgIterator);
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up an application's sandbox: its resource limits, its SMACK rules and its runtime area in
+ * the file system.  This must be done once after the application is created and before it is
+ * started for the first time.  A runtime area that is still set up for the installed version of
+ * the application and for its current bundles and requires config is reused as is.
+ *
+ * @note
+ *      This only touches state that belongs to this application, so sandboxes for different
+ *      applications can be set up concurrently.  The calling thread must be connected to the
+ *      le_cfg service.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  The application should be deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_SetupSandbox
+(
+    app_Ref_t appRef                    ///< [IN] Reference to the application.
+)
+{
     // Set the resource limit for this application.
-    if (resLim_SetAppLimits(appPtr) != LE_OK)
+    if (resLim_SetAppLimits(appRef) != LE_OK)
     {
         LE_ERROR("Could not set application resource limits.  Application %s cannot be started.",
-                 appPtr->name);
+                 appRef->name);
 
-        goto failed;
+        return LE_FAULT;
     }
 
     // Set SMACK rules for this app.
-    // Setup the runtime area in the file system.
-    if ( (SetSmackRules(appPtr) != LE_OK) ||
-         (SetupAppArea(appPtr) != LE_OK) )
+    if (SetSmackRules(appRef) != LE_OK)
     {
-        goto failed;
+        return LE_FAULT;
     }
 
-    le_cfg_CancelTxn(cfgIterator);
-    return appPtr;
+    // Setup the runtime area in the file system, unless it is still set up for this version of
+    // the app and for the files it currently links in.
+    char md5[LIMIT_MD5_STR_BYTES] = "";
+    uint32_t linksHash = 0;
 
-failed:
+    if (appRef->sandboxed)
+    {
+        if (GetInstalledMd5(appRef, md5, sizeof(md5)) != LE_OK)
+        {
+            md5[0] = '\0';
+        }
 
-    app_Delete(appPtr);
-    le_cfg_CancelTxn(cfgIterator);
-    return NULL;
+        linksHash = GetLinksConfigHash(appRef);
+
+        if (IsSandboxPrepared(appRef, md5, linksHash))
+        {
+            LE_INFO("Reusing the runtime area of app '%s'.", appRef->name);
+            return LE_OK;
+        }
+    }
+
+    if (SetupAppArea(appRef) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    if (md5[0] != '\0')
+    {
+        RecordPreparedSandbox(appRef, md5, linksHash);
+    }
+
+    return LE_OK;
 }
 
 
@@ -2474,16 +2980,25 @@ le_result_t app_Start
         char appDirLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
         smack_GetAppAccessLabel(app_GetName(appRef), S_IRWXU, appDirLabel, sizeof(appDirLabel));
 
-        // Create the app's /tmp for sandboxed apps.
-        if (CreateTmpFs(appRef, appDirLabel) != LE_OK)
+        // On a restart, empty the /tmp left by the previous run rather than mounting a new one and
+        // linking the default files into it again.
+        if (!appRef->tmpFsReady || (ClearTmpFs(appRef) != LE_OK))
         {
-            return LE_FAULT;
-        }
+            appRef->tmpFsReady = false;
 
-        // Create default links.
-        if (CreateDefaultTmpLinks(appRef, appDirLabel) != LE_OK)
-        {
-            return LE_FAULT;
+            // Create the app's /tmp for sandboxed apps.
+            if (CreateTmpFs(appRef, appDirLabel) != LE_OK)
+            {
+                return LE_FAULT;
+            }
+
+            // Create default links.
+            if (CreateDefaultTmpLinks(appRef, appDirLabel) != LE_OK)
+            {
+                return LE_FAULT;
+            }
+
+            appRef->tmpFsReady = true;
         }
     }
 
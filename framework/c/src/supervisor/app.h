@@ -113,7 +113,8 @@ app_Proc_Ref_t app_GetProcContainer
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Creates an application object.
+ * Creates an application object.  The application's sandbox must be set up with
+ * app_SetupSandbox() before the application can be started.
  *
  * @note
  *      Only applications that have entries in the config tree can be created.
@@ -129,6 +130,29 @@ app_Ref_t app_Create
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up an application's sandbox: its resource limits, its SMACK rules and its runtime area in
+ * the file system.  This must be done once after the application is created and before it is
+ * started for the first time.  A runtime area that is still set up for the installed version of
+ * the application is reused as is.
+ *
+ * @note
+ *      This only touches state that belongs to this application, so sandboxes for different
+ *      applications can be set up concurrently.  The calling thread must be connected to the
+ *      le_cfg service.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  The application should be deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_SetupSandbox
+(
+    app_Ref_t appRef                    ///< [IN] Reference to the application.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Deletes an application.  The application must be stopped before it is deleted.
@@ -12,6 +12,10 @@
  * An app can be started by either an IPC call or automatically on start-up using the
  * apps_AutoStart() API.
  *
+ * On auto-start the sandboxes of all the apps are set up concurrently by a small pool of worker
+ * threads, and each app is started by the main thread as soon as its sandbox is ready and all the
+ * auto-started apps it has bindings to have been started.
+ *
  * When an app is started for the first time a new app container object is created which contains a
  * list link, an app stop handler reference and the app object (which is also instantiated).
  *
@@ -92,6 +96,23 @@
 #define CFG_NODE_START_MANUAL               "startManual"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The name of the node in the config tree that contains an app's list of IPC bindings.  Each
+ * binding that goes to another app names that server app in its "app" node.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_NODE_BINDINGS                   "bindings"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of threads used to set up app sandboxes concurrently during auto-start.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_LAUNCH_WORKERS                  4
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler to be called when all applications have shutdown.
@@ -202,6 +223,94 @@ static le_mem_PoolRef_t AppProcContainerPool;
 static le_ref_MapRef_t AppProcMap;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A server app that an auto-started app has bindings to.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                name[LIMIT_MAX_APP_NAME_BYTES]; ///< Name of the server app.
+    le_sls_Link_t       link;                           ///< Link in the client's list of servers.
+}
+LaunchServer_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for launch server records.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LaunchServerPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An app being auto-started.  The app is started once its sandbox is set up and all the auto-started
+ * apps it has bindings to have been started.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    AppContainer_t*     appContainerPtr;    ///< The app container.  NULL if the app couldn't be
+                                            ///  created.
+    le_sls_List_t       serverList;         ///< Server apps this app has bindings to.
+    le_result_t         setupResult;        ///< Result of setting up the sandbox.
+    bool                isSetUp;            ///< true once the sandbox set up has finished.
+    bool                isLaunched;         ///< true once the app has been started, or given up on.
+    le_dls_Link_t       link;               ///< Link in the list of apps being auto-started.
+    le_sls_Link_t       setupLink;          ///< Link in the set up or the finished set up queue.
+}
+Launch_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for launch records.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t LaunchPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of the apps being auto-started, in config order.  Only used on the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t LaunchList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue of launches waiting for a worker to set up their sandboxes, and queue of launches whose
+ * sandbox set up has finished.  Both are protected by the LaunchMutexRef.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sls_List_t SetupQueue = LE_SLS_LIST_INIT;
+static le_sls_List_t SetupDoneQueue = LE_SLS_LIST_INIT;
+
+static le_mutex_Ref_t LaunchMutexRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Posted by the workers each time they put a launch on the SetupDoneQueue.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sem_Ref_t SetupDoneSemRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Held for reading by the launch workers whenever they do real work, and for writing by the main
+ * thread while it starts an app.  This keeps the main thread from forking an app's processes
+ * while a worker holds a lock (e.g. the syslog lock) that the child process would then inherit
+ * locked.  Writers are preferred so that apps are started as soon as they are ready.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_rwlock_t ForkLock;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Deletes application container and references to it.
@@ -430,17 +539,18 @@ static AppContainer_t* GetActiveAppWithProc
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create the app container if necessary.  This function searches for the app container in the
- * active and inactive lists first, if it can't find it then it creates the app container.
+ * Create the app container if necessary, optionally leaving the app's sandbox to be set up later.
+ * The sandbox of an app that already had a container has always been set up.
  *
  * @return
  *      A pointer to the app container if successful.
  *      NULL if the app if there was an error. The resultPtr contains the error code.
  */
 //--------------------------------------------------------------------------------------------------
-static AppContainer_t* CreateApp
+static AppContainer_t* CreateAppContainer
 (
     const char* appNamePtr,     ///< [IN] Name of the application to launch.
+    bool setupSandbox,          ///< [IN] true to set up the sandbox of a newly created app.
     le_result_t* resultPtr      ///< [OUT] Result: LE_OK if successful the app.
                                 ///                LE_NOT_FOUND if the app is not installed.
                                 ///                LE_FAULT if there was some other error.
@@ -500,6 +610,15 @@ static AppContainer_t* CreateApp
         return NULL;
     }
 
+    if (setupSandbox && (app_SetupSandbox(appRef) != LE_OK))
+    {
+        app_Delete(appRef);
+        le_cfg_CancelTxn(appCfg);
+
+        *resultPtr = LE_FAULT;
+        return NULL;
+    }
+
     // Create the app container for this app.
     appContainerPtr = le_mem_ForceAlloc(AppContainerPool);
 
@@ -518,6 +637,28 @@ static AppContainer_t* CreateApp
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the app container if necessary.  This function searches for the app container in the
+ * active and inactive lists first, if it can't find it then it creates the app container.
+ *
+ * @return
+ *      A pointer to the app container if successful.
+ *      NULL if the app if there was an error. The resultPtr contains the error code.
+ */
+//--------------------------------------------------------------------------------------------------
+static AppContainer_t* CreateApp
+(
+    const char* appNamePtr,     ///< [IN] Name of the application to launch.
+    le_result_t* resultPtr      ///< [OUT] Result: LE_OK if successful the app.
+                                ///                LE_NOT_FOUND if the app is not installed.
+                                ///                LE_FAULT if there was some other error.
+)
+{
+    return CreateAppContainer(appNamePtr, true, resultPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts an app.
@@ -886,6 +1027,393 @@ static le_result_t GetAppNameFromPid
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the launch record of an app being auto-started.
+ *
+ * @return
+ *      A pointer to the launch record.
+ *      NULL if the app is not being auto-started.
+ */
+//--------------------------------------------------------------------------------------------------
+static Launch_t* GetLaunch
+(
+    const char* appNamePtr          ///< [IN] Name of the app.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&LaunchList);
+
+    while (linkPtr != NULL)
+    {
+        Launch_t* launchPtr = CONTAINER_OF(linkPtr, Launch_t, link);
+
+        if ( (launchPtr->appContainerPtr != NULL) &&
+             (strncmp(app_GetName(launchPtr->appContainerPtr->appRef),
+                      appNamePtr,
+                      LIMIT_MAX_APP_NAME_BYTES) == 0) )
+        {
+            return launchPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&LaunchList, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the list of other apps that an app has bindings to.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadLaunchServers
+(
+    Launch_t* launchPtr             ///< [IN] The app's launch record.
+)
+{
+    app_Ref_t appRef = launchPtr->appContainerPtr->appRef;
+
+    le_cfg_IteratorRef_t bindCfg = le_cfg_CreateReadTxn(app_GetConfigPath(appRef));
+    le_cfg_GoToNode(bindCfg, CFG_NODE_BINDINGS);
+
+    if (le_cfg_GoToFirstChild(bindCfg) == LE_OK)
+    {
+        do
+        {
+            char serverName[LIMIT_MAX_APP_NAME_BYTES];
+
+            if ( (le_cfg_GetString(bindCfg, "app", serverName, sizeof(serverName), "") != LE_OK) ||
+                 (serverName[0] == '\0') ||
+                 (strcmp(serverName, app_GetName(appRef)) == 0) )
+            {
+                continue;
+            }
+
+            // Several interfaces are often bound to the same server, only list it once.
+            le_sls_Link_t* linkPtr = le_sls_Peek(&(launchPtr->serverList));
+
+            while (linkPtr != NULL)
+            {
+                if (strcmp(CONTAINER_OF(linkPtr, LaunchServer_t, link)->name, serverName) == 0)
+                {
+                    break;
+                }
+
+                linkPtr = le_sls_PeekNext(&(launchPtr->serverList), linkPtr);
+            }
+
+            if (linkPtr == NULL)
+            {
+                LaunchServer_t* serverPtr = le_mem_ForceAlloc(LaunchServerPool);
+
+                LE_ASSERT(le_utf8_Copy(serverPtr->name, serverName, sizeof(serverPtr->name), NULL)
+                          == LE_OK);
+                serverPtr->link = LE_SLS_LINK_INIT;
+
+                le_sls_Stack(&(launchPtr->serverList), &(serverPtr->link));
+            }
+        }
+        while (le_cfg_GoToNextSibling(bindCfg) == LE_OK);
+    }
+
+    le_cfg_CancelTxn(bindCfg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an app that is to be auto-started and adds it to the list of launches.  Newly created
+ * apps are put on the set up queue to have their sandboxes set up by the launch workers.
+ *
+ * @return
+ *      true if the app's sandbox has been put on the set up queue.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AddLaunch
+(
+    const char* appNamePtr          ///< [IN] Name of the app to launch.
+)
+{
+    // An app that already has a container has had its sandbox set up.
+    bool needsSetup = (GetActiveApp(appNamePtr) == NULL) && (GetInactiveApp(appNamePtr) == NULL);
+
+    le_result_t result;
+    AppContainer_t* appContainerPtr = CreateAppContainer(appNamePtr, false, &result);
+
+    if (appContainerPtr == NULL)
+    {
+        LE_ERROR("Application '%s' cannot run.", appNamePtr);
+        return false;
+    }
+
+    if (appContainerPtr->isActive)
+    {
+        LE_ERROR("Application '%s' is already running.", appNamePtr);
+        return false;
+    }
+
+    Launch_t* launchPtr = le_mem_ForceAlloc(LaunchPool);
+
+    launchPtr->appContainerPtr = appContainerPtr;
+    launchPtr->serverList = LE_SLS_LIST_INIT;
+    launchPtr->setupResult = LE_OK;
+    launchPtr->isSetUp = !needsSetup;
+    launchPtr->isLaunched = false;
+    launchPtr->link = LE_DLS_LINK_INIT;
+    launchPtr->setupLink = LE_SLS_LINK_INIT;
+
+    ReadLaunchServers(launchPtr);
+
+    le_dls_Queue(&LaunchList, &(launchPtr->link));
+
+    if (needsSetup)
+    {
+        le_sls_Queue(&SetupQueue, &(launchPtr->setupLink));
+    }
+
+    return needsSetup;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the launch worker threads.  Sets up the sandboxes on the set up queue until it
+ * is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* LaunchWorkerMain
+(
+    void* contextPtr                ///< [IN] Not used.
+)
+{
+    LE_ASSERT(pthread_rwlock_rdlock(&ForkLock) == 0);
+    le_cfg_ConnectService();
+    LE_ASSERT(pthread_rwlock_unlock(&ForkLock) == 0);
+
+    for (;;)
+    {
+        le_mutex_Lock(LaunchMutexRef);
+        le_sls_Link_t* linkPtr = le_sls_Pop(&SetupQueue);
+        le_mutex_Unlock(LaunchMutexRef);
+
+        if (linkPtr == NULL)
+        {
+            break;
+        }
+
+        Launch_t* launchPtr = CONTAINER_OF(linkPtr, Launch_t, setupLink);
+
+        LE_ASSERT(pthread_rwlock_rdlock(&ForkLock) == 0);
+        launchPtr->setupResult = app_SetupSandbox(launchPtr->appContainerPtr->appRef);
+        LE_ASSERT(pthread_rwlock_unlock(&ForkLock) == 0);
+
+        le_mutex_Lock(LaunchMutexRef);
+        le_sls_Queue(&SetupDoneQueue, linkPtr);
+        le_mutex_Unlock(LaunchMutexRef);
+
+        le_sem_Post(SetupDoneSemRef);
+    }
+
+    LE_ASSERT(pthread_rwlock_rdlock(&ForkLock) == 0);
+    le_cfg_DisconnectService();
+    LE_ASSERT(pthread_rwlock_unlock(&ForkLock) == 0);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waits for a launch worker to finish setting up a sandbox.  Apps whose sandbox could not be set
+ * up are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WaitForSetup
+(
+    void
+)
+{
+    le_sem_Wait(SetupDoneSemRef);
+
+    le_mutex_Lock(LaunchMutexRef);
+    le_sls_Link_t* linkPtr = le_sls_Pop(&SetupDoneQueue);
+    le_mutex_Unlock(LaunchMutexRef);
+
+    LE_ASSERT(linkPtr != NULL);
+
+    Launch_t* launchPtr = CONTAINER_OF(linkPtr, Launch_t, setupLink);
+
+    launchPtr->isSetUp = true;
+
+    if (launchPtr->setupResult != LE_OK)
+    {
+        LE_ERROR("Application '%s' cannot run.", app_GetName(launchPtr->appContainerPtr->appRef));
+
+        le_dls_Remove(&InactiveAppsList, &(launchPtr->appContainerPtr->link));
+        DeleteApp(launchPtr->appContainerPtr);
+
+        // Clients of this app don't need to wait for it any more.
+        launchPtr->appContainerPtr = NULL;
+        launchPtr->isLaunched = true;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether an auto-started app can be started now, i.e. its sandbox is set up and all the
+ * auto-started apps it has bindings to have been started.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsLaunchReady
+(
+    Launch_t* launchPtr             ///< [IN] The app's launch record.
+)
+{
+    if (!launchPtr->isSetUp || launchPtr->isLaunched)
+    {
+        return false;
+    }
+
+    le_sls_Link_t* linkPtr = le_sls_Peek(&(launchPtr->serverList));
+
+    while (linkPtr != NULL)
+    {
+        Launch_t* serverLaunchPtr = GetLaunch(CONTAINER_OF(linkPtr, LaunchServer_t, link)->name);
+
+        if ( (serverLaunchPtr != NULL) && !serverLaunchPtr->isLaunched )
+        {
+            return false;
+        }
+
+        linkPtr = le_sls_PeekNext(&(launchPtr->serverList), linkPtr);
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts an auto-started app.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartLaunch
+(
+    Launch_t* launchPtr             ///< [IN] The app's launch record.
+)
+{
+    launchPtr->isLaunched = true;
+
+    // No need to check the return code because there is nothing we can do about errors.
+    LE_ASSERT(pthread_rwlock_wrlock(&ForkLock) == 0);
+    StartApp(launchPtr->appContainerPtr);
+    LE_ASSERT(pthread_rwlock_unlock(&ForkLock) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts all the auto-started apps that are ready, and the apps that become ready as a result,
+ * in config order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartReadyLaunches
+(
+    void
+)
+{
+    bool started;
+
+    do
+    {
+        started = false;
+
+        le_dls_Link_t* linkPtr = le_dls_Peek(&LaunchList);
+
+        while (linkPtr != NULL)
+        {
+            Launch_t* launchPtr = CONTAINER_OF(linkPtr, Launch_t, link);
+
+            if (IsLaunchReady(launchPtr))
+            {
+                StartLaunch(launchPtr);
+                started = true;
+            }
+
+            linkPtr = le_dls_PeekNext(&LaunchList, linkPtr);
+        }
+    }
+    while (started);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the auto-started apps that are still waiting once all the sandboxes are set up.  These
+ * apps have bindings that form a cycle, so the first one in config order is started without
+ * waiting for its servers to break the cycle.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartCyclicLaunches
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&LaunchList);
+
+    while (linkPtr != NULL)
+    {
+        Launch_t* launchPtr = CONTAINER_OF(linkPtr, Launch_t, link);
+
+        if (!launchPtr->isLaunched)
+        {
+            LE_WARN("Application '%s' has a cycle of bindings.  Starting it without waiting for "
+                    "its servers.", app_GetName(launchPtr->appContainerPtr->appRef));
+
+            StartLaunch(launchPtr);
+            StartReadyLaunches();
+        }
+
+        linkPtr = le_dls_PeekNext(&LaunchList, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases all the launch records.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteLaunches
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Pop(&LaunchList);
+
+    while (linkPtr != NULL)
+    {
+        Launch_t* launchPtr = CONTAINER_OF(linkPtr, Launch_t, link);
+
+        le_sls_Link_t* serverLinkPtr = le_sls_Pop(&(launchPtr->serverList));
+
+        while (serverLinkPtr != NULL)
+        {
+            le_mem_Release(CONTAINER_OF(serverLinkPtr, LaunchServer_t, link));
+
+            serverLinkPtr = le_sls_Pop(&(launchPtr->serverList));
+        }
+
+        le_mem_Release(launchPtr);
+
+        linkPtr = le_dls_Pop(&LaunchList);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the applications system.
@@ -905,6 +1433,19 @@ void apps_Init
     AppProcMap = le_ref_CreateMap("AppProcs", 5);
     AppMap = le_ref_CreateMap("App", 5);
 
+    // Create the auto-start launch scheduler's resources.
+    LaunchPool = le_mem_CreatePool("appLaunches", sizeof(Launch_t));
+    LaunchServerPool = le_mem_CreatePool("appLaunchServers", sizeof(LaunchServer_t));
+    LaunchMutexRef = le_mutex_CreateNonRecursive("appLaunch");
+    SetupDoneSemRef = le_sem_Create("appLaunchSetupDone", 0);
+
+    pthread_rwlockattr_t forkLockAttr;
+    LE_ASSERT(pthread_rwlockattr_init(&forkLockAttr) == 0);
+    LE_ASSERT(pthread_rwlockattr_setkind_np(&forkLockAttr,
+                                            PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP) == 0);
+    LE_ASSERT(pthread_rwlock_init(&ForkLock, &forkLockAttr) == 0);
+    LE_ASSERT(pthread_rwlockattr_destroy(&forkLockAttr) == 0);
+
     le_instStat_AddAppUninstallEventHandler(DeletesInactiveApp, NULL);
     le_instStat_AddAppInstallEventHandler(DeletesInactiveApp, NULL);
 
@@ -972,6 +1513,10 @@ void apps_SetShutdownHandler
 //--------------------------------------------------------------------------------------------------
 /**
  * Start all applications marked as 'auto' start.
+ *
+ * The apps' sandboxes are set up concurrently by a pool of worker threads.  Each app is started as
+ * soon as its sandbox is ready and all the auto-started apps it has bindings to have been started,
+ * so that servers are up before their clients try to connect to them.
  */
 //--------------------------------------------------------------------------------------------------
 void apps_AutoStart
@@ -991,6 +1536,8 @@ void apps_AutoStart
         return;
     }
 
+    size_t setupCount = 0;
+
     do
     {
         // Check the start mode for this application.
@@ -1005,17 +1552,47 @@ void apps_AutoStart
                          "Max app name in bytes, %d.  Application not launched.",
                          appName, LIMIT_MAX_APP_NAME_BYTES);
             }
-            else
+            else if (AddLaunch(appName))
             {
-                // Launch the application now.  No need to check the return code because there is
-                // nothing we can do about errors.
-                LaunchApp(appName);
+                setupCount++;
             }
         }
     }
     while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
 
     le_cfg_CancelTxn(appCfg);
+
+    // Start the workers that set up the sandboxes.
+    le_thread_Ref_t workers[MAX_LAUNCH_WORKERS];
+    size_t workerCount = (setupCount < MAX_LAUNCH_WORKERS) ? setupCount : MAX_LAUNCH_WORKERS;
+    size_t i;
+
+    for (i = 0; i < workerCount; i++)
+    {
+        char workerName[32];
+        snprintf(workerName, sizeof(workerName), "appLaunch%zu", i);
+
+        workers[i] = le_thread_Create(workerName, LaunchWorkerMain, NULL);
+        le_thread_SetJoinable(workers[i]);
+        le_thread_Start(workers[i]);
+    }
+
+    // Start the apps that don't need a sandbox set up, then start the others as they become ready.
+    StartReadyLaunches();
+
+    for (; setupCount > 0; setupCount--)
+    {
+        WaitForSetup();
+        StartReadyLaunches();
+    }
+
+    for (i = 0; i < workerCount; i++)
+    {
+        LE_ASSERT(le_thread_Join(workers[i], NULL) == LE_OK);
+    }
+
+    StartCyclicLaunches();
+    DeleteLaunches();
 }
 
 
@@ -21,6 +21,7 @@
 #define DEFAULT_POOL_INITIAL_SIZE 1
 #define DEFAULT_REFMAP_NAME "Default Timer SafeRefs"
 #define DEFAULT_REFMAP_MAXSIZE 23
+#define TIMER_HEAP_INITIAL_SIZE 8
 
 
 //--------------------------------------------------------------------------------------------------
@@ -123,108 +124,184 @@ static Timer_t* CreateTimer
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the timer record to the given list, sorted according to the timer value
+ * Check if a timer should expire before another one.  Timers with the same expiry time expire in
+ * the order in which they were started.
+ *
+ * @return
+ *      true if timer A expires first.
  */
 //--------------------------------------------------------------------------------------------------
-static void AddToTimerList
+static inline bool IsEarlier
 (
-    le_dls_List_t* listPtr,               ///< [IN] The list to add to.
-    Timer_t* newTimerPtr                  ///< [IN] The timer to add
+    const Timer_t* timerAPtr,           ///< [IN] Timer A
+    const Timer_t* timerBPtr            ///< [IN] Timer B
 )
 {
-    Timer_t* timerPtr;
-    le_dls_Link_t* linkPtr;
-
-    if ( newTimerPtr->isActive )
+    if ( (timerAPtr->expiryTime.sec == timerBPtr->expiryTime.sec) &&
+         (timerAPtr->expiryTime.usec == timerBPtr->expiryTime.usec) )
     {
-        LE_ERROR("Timer '%s' is already active", newTimerPtr->name);
-        return;
+        return (timerAPtr->startSequence < timerBPtr->startSequence);
     }
 
-    // Get the start of the list
-    linkPtr = le_dls_Peek(listPtr);
+    return le_clk_GreaterThan(timerBPtr->expiryTime, timerAPtr->expiryTime);
+}
 
-    // Find the timer whose expiry time is greater than the new timer.
-    while ( linkPtr != NULL )
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put a timer at a given position in the heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void SetHeapEntry
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    size_t index,                       ///< [IN] Position in the heap.
+    Timer_t* timerPtr                   ///< [IN] The timer
+)
+{
+    threadRecPtr->heapPtr[index] = timerPtr;
+    timerPtr->heapIndex = index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the timer at the given position in the heap up towards the top, until it is no earlier
+ * than its parent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SiftUp
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    size_t index                        ///< [IN] Position of the timer in the heap.
+)
+{
+    Timer_t* timerPtr = threadRecPtr->heapPtr[index];
+
+    while (index > 0)
     {
-        timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
+        size_t parentIndex = (index - 1) / 2;
+        Timer_t* parentPtr = threadRecPtr->heapPtr[parentIndex];
 
-        if ( le_clk_GreaterThan(timerPtr->expiryTime, newTimerPtr->expiryTime) )
+        if ( !IsEarlier(timerPtr, parentPtr) )
+        {
             break;
+        }
 
-        linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+        SetHeapEntry(threadRecPtr, index, parentPtr);
+        index = parentIndex;
     }
 
-    TimerListChangeCount++;
-    if (linkPtr == NULL)
-    {
-        // The list is either empty, or the new timer has the largest expiry time.
-        // In either case, add the new timer to the end of the list.
-        le_dls_Queue(listPtr, &newTimerPtr->link);
-    }
-    else
+    SetHeapEntry(threadRecPtr, index, timerPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the timer at the given position in the heap down towards the bottom, until neither of its
+ * children is earlier.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SiftDown
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    size_t index                        ///< [IN] Position of the timer in the heap.
+)
+{
+    Timer_t* timerPtr = threadRecPtr->heapPtr[index];
+
+    for (;;)
     {
-        // Found a timer with larger expiry time; insert the new timer before it.
-        le_dls_AddBefore(listPtr, linkPtr, &newTimerPtr->link);
+        size_t childIndex = (2 * index) + 1;
+
+        if (childIndex >= threadRecPtr->heapCount)
+        {
+            break;
+        }
+
+        // Pick the earlier of the two children.
+        if ( (childIndex + 1 < threadRecPtr->heapCount) &&
+             IsEarlier(threadRecPtr->heapPtr[childIndex + 1], threadRecPtr->heapPtr[childIndex]) )
+        {
+            childIndex++;
+        }
+
+        if ( !IsEarlier(threadRecPtr->heapPtr[childIndex], timerPtr) )
+        {
+            break;
+        }
+
+        SetHeapEntry(threadRecPtr, index, threadRecPtr->heapPtr[childIndex]);
+        index = childIndex;
     }
 
-    // The new timer is now on the active list
-    newTimerPtr->isActive = true;
+    SetHeapEntry(threadRecPtr, index, timerPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Peek at the first timer from the given timer list
+ * Add the timer record to the thread's active timers.
  *
- * @return:
- *      - pointer to the first timer on the list
- *      - NULL if the list is empty
+ * The timer is added to the heap, which keeps track of which timer expires next, and to the
+ * active timer list, which is only used by the Inspect tool.
  */
 //--------------------------------------------------------------------------------------------------
-static Timer_t* PeekFromTimerList
+static void AddToTimerList
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr,      ///< [IN] The thread's timer record.
+    Timer_t* newTimerPtr                  ///< [IN] The timer to add
 )
 {
-    le_dls_Link_t* linkPtr;
+    if ( newTimerPtr->isActive )
+    {
+        LE_ERROR("Timer '%s' is already active", newTimerPtr->name);
+        return;
+    }
 
-    linkPtr = le_dls_Peek(listPtr);
-    if (linkPtr != NULL)
+    // Grow the heap if it is full.
+    if (threadRecPtr->heapCount == threadRecPtr->heapSize)
     {
-        return ( CONTAINER_OF(linkPtr, Timer_t, link) );
+        size_t newSize = (threadRecPtr->heapSize == 0) ? TIMER_HEAP_INITIAL_SIZE
+                                                        : (threadRecPtr->heapSize * 2);
+        Timer_t** newHeapPtr = realloc(threadRecPtr->heapPtr, newSize * sizeof(Timer_t*));
+        LE_ASSERT(newHeapPtr != NULL);
+
+        threadRecPtr->heapPtr = newHeapPtr;
+        threadRecPtr->heapSize = newSize;
     }
-    return NULL;
+
+    newTimerPtr->startSequence = threadRecPtr->nextStartSequence++;
+
+    TimerListChangeCount++;
+    threadRecPtr->heapCount++;
+    SetHeapEntry(threadRecPtr, threadRecPtr->heapCount - 1, newTimerPtr);
+    SiftUp(threadRecPtr, threadRecPtr->heapCount - 1);
+
+    le_dls_Queue(&threadRecPtr->activeTimerList, &newTimerPtr->link);
+
+    // The new timer is now on the active list
+    newTimerPtr->isActive = true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pop the first timer from the given timer list
+ * Peek at the first timer to expire in the thread's active timers
  *
  * @return:
- *      - pointer to the first timer on the list
- *      - NULL if the list is empty
+ *      - pointer to the first timer to expire
+ *      - NULL if there are no active timers
  */
 //--------------------------------------------------------------------------------------------------
-static Timer_t* PopFromTimerList
+static Timer_t* PeekFromTimerList
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread's timer record.
 )
 {
-    le_dls_Link_t* linkPtr;
-    Timer_t* timerPtr;
-
-    linkPtr = le_dls_Pop(listPtr);
-    if (linkPtr != NULL)
+    if (threadRecPtr->heapCount > 0)
     {
-        TimerListChangeCount++;
-        timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
-
-        // The timer is no longer on the active list
-        timerPtr->isActive = false;
-
-        return timerPtr;
+        return threadRecPtr->heapPtr[0];
     }
     return NULL;
 }
@@ -232,16 +309,16 @@ static Timer_t* PopFromTimerList
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove the timer from the given timer list
+ * Remove the timer from the thread's active timers
  *
  * @return
  *      - LE_OK on success
- *      - LE_FAULT if the timer was not in the list
+ *      - LE_FAULT if the timer was not active
  */
 //--------------------------------------------------------------------------------------------------
 static le_result_t RemoveFromTimerList
 (
-    le_dls_List_t* listPtr,             ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
     Timer_t* timerPtr                   ///< [IN] The timer to remove
 )
 {
@@ -250,15 +327,60 @@ static le_result_t RemoveFromTimerList
         return LE_FAULT;
     }
 
+    size_t index = timerPtr->heapIndex;
+    LE_ASSERT( (index < threadRecPtr->heapCount) && (threadRecPtr->heapPtr[index] == timerPtr) );
+
     // Remove the timer from the active list
     timerPtr->isActive = false;
     TimerListChangeCount++;
-    le_dls_Remove(listPtr, &timerPtr->link);
+    le_dls_Remove(&threadRecPtr->activeTimerList, &timerPtr->link);
+
+    // Fill the hole with the last timer in the heap, and move that timer up or down to where it
+    // belongs.
+    threadRecPtr->heapCount--;
+    if (index < threadRecPtr->heapCount)
+    {
+        Timer_t* lastTimerPtr = threadRecPtr->heapPtr[threadRecPtr->heapCount];
+
+        SetHeapEntry(threadRecPtr, index, lastTimerPtr);
+        if ( (index > 0) && IsEarlier(lastTimerPtr, threadRecPtr->heapPtr[(index - 1) / 2]) )
+        {
+            SiftUp(threadRecPtr, index);
+        }
+        else
+        {
+            SiftDown(threadRecPtr, index);
+        }
+    }
 
     return LE_OK;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pop the first timer to expire from the thread's active timers
+ *
+ * @return:
+ *      - pointer to the first timer to expire
+ *      - NULL if there are no active timers
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* PopFromTimerList
+(
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread's timer record.
+)
+{
+    Timer_t* timerPtr = PeekFromTimerList(threadRecPtr);
+
+    if (timerPtr != NULL)
+    {
+        (void)RemoveFromTimerList(threadRecPtr, timerPtr);
+    }
+    return timerPtr;
+}
+
+
 #if 0
 //--------------------------------------------------------------------------------------------------
 /**
@@ -404,8 +526,7 @@ static void ProcessExpiredTimer
         expiredTimer->expiryTime = le_clk_Add(expiredTimer->expiryTime, expiredTimer->interval);
 
         // Add the timer back to the timer list
-        AddToTimerList(&threadRecPtr->activeTimerList, expiredTimer);
-        //PrintTimerList(&threadRecPtr->activeTimerList);
+        AddToTimerList(threadRecPtr, expiredTimer);
     }
 
     // call the optional expiry handler function
@@ -457,7 +578,7 @@ static void TimerFdHandler
     LE_ERROR_IF(expiry != 1,  "On TimerFD read, unexpected expiry=%u", (unsigned int)expiry);
 
     // Pop off the first timer from the active list, and make sure it is the expected timer.
-    firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PopFromTimerList(threadRecPtr);
     LE_ASSERT( threadRecPtr->firstTimerPtr == firstTimerPtr );
 
     // Need to reset the expected timer, in case processing the current timer will cause the same
@@ -470,16 +591,16 @@ static void TimerFdHandler
 
     // Check if there are any other timers that have since expired, pop them off the
     // list and process them.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PeekFromTimerList(threadRecPtr);
     while ( firstTimerPtr != NULL &&
             le_clk_GreaterThan(le_clk_GetRelativeTime(), firstTimerPtr->expiryTime) )
     {
         // Pop off the timer and process it
-        firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+        firstTimerPtr = PopFromTimerList(threadRecPtr);
         ProcessExpiredTimer(firstTimerPtr);
 
         // Try the next timer on the list
-        firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+        firstTimerPtr = PeekFromTimerList(threadRecPtr);
     }
 
     // While processing expired timers in the above loop, it is possible that a timer was started,
@@ -595,6 +716,10 @@ void timer_InitThread
 
     recPtr->timerFD = -1;
     recPtr->activeTimerList = LE_DLS_LIST_INIT;
+    recPtr->heapPtr = NULL;
+    recPtr->heapCount = 0;
+    recPtr->heapSize = 0;
+    recPtr->nextStartSequence = 0;
     recPtr->firstTimerPtr = NULL;
 }
 
@@ -648,6 +773,12 @@ void timer_DestructThread
 
         le_mem_Release(timerPtr);
     }
+
+    // Release the timer heap
+    free(threadRecPtr->heapPtr);
+    threadRecPtr->heapPtr = NULL;
+    threadRecPtr->heapCount = 0;
+    threadRecPtr->heapSize = 0;
 }
 
 // =============================================
@@ -990,12 +1121,11 @@ le_result_t le_timer_Start
     // Add the timer to the timer list. This is the only place we reset the expiry count.
     timerPtr->expiryCount = 0;
     timerPtr->expiryTime = le_clk_Add(le_clk_GetRelativeTime(), timerPtr->interval);
-    AddToTimerList(&threadRecPtr->activeTimerList, timerPtr);
-    //PrintTimerList(&threadRecPtr->activeTimerList);
+    AddToTimerList(threadRecPtr, timerPtr);
 
     // Get the first timer from the active list. This is needed to determine whether the timerFD
     // needs to be restarted, in case the new timer was put at the beginning of the list.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PeekFromTimerList(threadRecPtr);
 
     // If the timerFD is not running, or it is running a timer that is no longer at the beginning
     // of the active list, then (re)start the timerFD.
@@ -1041,7 +1171,7 @@ le_result_t le_timer_Stop
 
     timer_ThreadRec_t* threadRecPtr = thread_GetTimerRecPtr();
 
-    result = RemoveFromTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    result = RemoveFromTimerList(threadRecPtr, timerPtr);
     if (result == LE_OK)
     {
         // If the timer was at the start of the active list, then restart the timerFD using the next
@@ -1051,7 +1181,7 @@ le_result_t le_timer_Stop
             TRACE("Stopping the first active timer");
             threadRecPtr->firstTimerPtr = NULL;
 
-            firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+            firstTimerPtr = PeekFromTimerList(threadRecPtr);
             if (firstTimerPtr != NULL)
             {
                 RestartTimerFD(firstTimerPtr);
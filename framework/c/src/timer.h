@@ -28,6 +28,8 @@ typedef struct
 
     // Internal State
     le_dls_Link_t link;                      ///< For adding to the timer list
+    size_t heapIndex;                        ///< Position in the thread's timer heap, if active
+    uint64_t startSequence;                  ///< Orders timers that have the same expiry time
     bool isActive;                           ///< Is the timer active/running?
     le_clk_Time_t expiryTime;                ///< Time at which the timer should expire
     uint32_t expiryCount;                    ///< Number of times the counter has expired
@@ -50,11 +52,17 @@ Timer_t;
 typedef struct
 {
     int timerFD;                        ///< System timer used by the thread.
-    le_dls_List_t activeTimerList;      ///< Linked list of running legato timers for this thread
-    Timer_t* firstTimerPtr;             ///< Pointer to the timer on the active list that is
+    le_dls_List_t activeTimerList;      ///< Linked list of running legato timers for this thread,
+                                        ///  in no particular order.
+    Timer_t** heapPtr;                  ///< Running timers for this thread, as a binary min-heap
+                                        ///  ordered by expiry time.  NULL until first needed.
+    size_t heapCount;                   ///< Number of timers in the heap.
+    size_t heapSize;                    ///< Number of timers the heap array can hold.
+    uint64_t nextStartSequence;         ///< Sequence number given to the next timer started.
+    Timer_t* firstTimerPtr;             ///< Pointer to the timer in the heap that is
                                         ///  associated with the currently running timerFD,
-                                        ///  or NULL if there are no timers on the active list.
-                                        ///  This is normally the first timer on the list.
+                                        ///  or NULL if there are no timers in the heap.
+                                        ///  This is normally the timer at the top of the heap.
 
 }
 timer_ThreadRec_t;
@@ -142,6 +142,36 @@ static void ExtractAncillaryData
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fills in a socket address in the abstract namespace (see 'man 7 unix').
+ *
+ * @return The length of the address, or 0 if the name is too long.
+ */
+//--------------------------------------------------------------------------------------------------
+static socklen_t SetAbstractAddress
+(
+    struct sockaddr_un* socketAddrPtr,  ///< [out] The address.
+    const char* nameStr                 ///< [in] Name in the abstract namespace.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The address is the name after a leading null byte, without a terminating null byte.
+    size_t nameLen = strlen(nameStr);
+    if (nameLen >= sizeof(socketAddrPtr->sun_path))
+    {
+        LE_CRIT("Abstract socket name '%s' too long.", nameStr);
+        return 0;
+    }
+
+    memset(socketAddrPtr, 0, sizeof(*socketAddrPtr));
+    socketAddrPtr->sun_family = AF_UNIX;
+    memcpy(socketAddrPtr->sun_path + 1, nameStr, nameLen);
+
+    return offsetof(struct sockaddr_un, sun_path) + 1 + nameLen;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a named sequenced-packet Unix domain socket. This binds the socket to a file system path.
@@ -210,6 +240,60 @@ int unixSocket_CreateSeqPacketNamed
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a sequenced-packet Unix domain socket bound to a name in the abstract namespace.  Nothing
+ * appears in the file system, and the name goes away when the socket is closed.
+ *
+ * @return
+ * - The file descriptor (a number > 0) of the socket, if successful.
+ * - LE_DUPLICATE if the name is already in use.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+int unixSocket_CreateSeqPacketAbstract
+(
+    const char* nameStr ///< [in] Name in the abstract namespace (without the leading null byte).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct sockaddr_un socketAddr;
+
+    socklen_t addrLen = SetAbstractAddress(&socketAddr, nameStr);
+    if (addrLen == 0)
+    {
+        return LE_FAULT;
+    }
+
+    int fd = unixSocket_CreateSeqPacketUnnamed();
+    if (fd < 0)
+    {
+        return fd;
+    }
+
+    if (bind(fd, (struct sockaddr*)(&socketAddr), addrLen) != 0)
+    {
+        le_result_t result;
+
+        if (errno == EADDRINUSE)
+        {
+            result = LE_DUPLICATE;
+        }
+        else
+        {
+            LE_ERROR("bind failed on abstract address '%s'. Errno = %d (%m).", nameStr, errno);
+            result = LE_FAULT;
+        }
+
+        fd_Close(fd);
+
+        return result;
+    }
+
+    return fd;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates an unnamed sequenced-packet Unix domain socket.
@@ -339,6 +423,60 @@ le_result_t unixSocket_Connect
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect a local socket to a socket bound to a name in the abstract namespace.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_WOULD_BLOCK if socket is non-blocking and could not be immediately connected.
+ * - LE_NOT_FOUND if no listening socket is bound to that name.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_ConnectAbstract
+(
+    int         fd,     ///< [in] Local socket file descriptor.
+    const char* nameStr ///< [in] Name in the abstract namespace (without the leading null byte).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int connectResult;
+    struct sockaddr_un socketAddr;
+
+    socklen_t addrLen = SetAbstractAddress(&socketAddr, nameStr);
+    if (addrLen == 0)
+    {
+        return LE_FAULT;
+    }
+
+    do
+    {
+        connectResult = connect(fd, (struct sockaddr*)(&socketAddr), addrLen);
+    }
+    while ((connectResult == -1) && (errno == EINTR));
+
+    if (connectResult != 0)
+    {
+        switch (errno)
+        {
+            case ECONNREFUSED:
+                return LE_NOT_FOUND;
+
+            case EINPROGRESS:
+            case EAGAIN:
+                return LE_WOULD_BLOCK;
+
+            default:
+                LE_ERROR("Connect failed with errno %d (%m).", errno);
+                return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends through a connected Unix domain socket a message containing any combination of:
@@ -714,6 +852,235 @@ le_result_t unixSocket_ReceiveDataMsg
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a batch of messages, each with an optional data payload and file descriptor, through a
+ * connected Unix domain datagram or sequenced-packet socket using a single system call.
+ *
+ * If the socket runs out of buffer space part way through the batch, only the first messages are
+ * sent.
+ *
+ * @return
+ * - LE_OK if at least one message was sent (check *numSentPtr for how many).
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ * - LE_NO_MEMORY if the send socket is set to non-blocking and it doesn't have enough buffer
+ *                  space to send right now. Wait for the "writeable" event on the file descriptor.
+ *
+ * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.  That can be exploited to break out of chroot()
+ *          jails.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_SendMsgBatch
+(
+    int localSocketFd,              ///< [IN] fd of the local socket that will be used to send.
+    unixSocket_BatchMsg_t* msgs,    ///< [IN] The messages to be sent.
+    size_t numMsgs,                 ///< [IN] Number of messages in the batch (at most
+                                    ///       UNIX_SOCKET_MAX_BATCH).
+    size_t* numSentPtr              ///< [OUT] Number of messages sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct mmsghdr msgHeaders[UNIX_SOCKET_MAX_BATCH];
+    struct iovec ioVectors[UNIX_SOCKET_MAX_BATCH];
+    char cmsgBuffers[UNIX_SOCKET_MAX_BATCH][CMSG_SPACE(sizeof(int))];
+    size_t i;
+
+    LE_ASSERT((numMsgs > 0) && (numMsgs <= UNIX_SOCKET_MAX_BATCH));
+
+    *numSentPtr = 0;
+
+    memset(msgHeaders, 0, numMsgs * sizeof(msgHeaders[0]));
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        if ((msgs[i].dataPtr != NULL) && (msgs[i].dataSize > 0))
+        {
+            ioVectors[i].iov_base = msgs[i].dataPtr;
+            ioVectors[i].iov_len = msgs[i].dataSize;
+            msgHeaderPtr->msg_iov = &ioVectors[i];
+            msgHeaderPtr->msg_iovlen = 1;
+        }
+
+        // If we are sending a file descriptor, it goes in its own control message buffer.
+        if (msgs[i].fd >= 0)
+        {
+            msgHeaderPtr->msg_control = cmsgBuffers[i];
+            msgHeaderPtr->msg_controllen = sizeof(cmsgBuffers[i]);
+
+            struct cmsghdr* cmsgHeaderPtr = CMSG_FIRSTHDR(msgHeaderPtr);
+            cmsgHeaderPtr->cmsg_level = SOL_SOCKET;
+            cmsgHeaderPtr->cmsg_type = SCM_RIGHTS;
+            cmsgHeaderPtr->cmsg_len = CMSG_LEN(sizeof(int));
+            *((int*)CMSG_DATA(cmsgHeaderPtr)) = msgs[i].fd;
+
+            msgHeaderPtr->msg_controllen = cmsgHeaderPtr->cmsg_len;
+
+            LE_DEBUG("Sending fd %d.", msgs[i].fd);
+        }
+    }
+
+    // Now send the messages (retry if interrupted by a signal).
+    int numSent;
+    do
+    {
+        numSent = sendmmsg(localSocketFd, msgHeaders, numMsgs, 0);
+    }
+    while ((numSent < 0) && (errno == EINTR));
+
+    if (numSent < 0)
+    {
+        switch (errno)
+        {
+            case EAGAIN:  // Same as EWOULDBLOCK
+                return LE_NO_MEMORY;
+
+            case ENOTCONN:
+            case ECONNRESET:
+            case EPIPE:
+                LE_WARN("sendmmsg() failed with errno %d (%m).", errno);
+                return LE_COMM_ERROR;
+
+            default:
+                LE_ERROR("sendmmsg() failed with errno %d (%m).", errno);
+                return LE_FAULT;
+        }
+    }
+
+    for (i = 0; i < numSent; i++)
+    {
+        if (msgHeaders[i].msg_len < msgs[i].dataSize)
+        {
+            LE_ERROR("The last %zu data bytes (of %zu total) were discarded by sendmmsg()!",
+                     msgs[i].dataSize - msgHeaders[i].msg_len,
+                     msgs[i].dataSize);
+            return LE_FAULT;
+        }
+    }
+
+    *numSentPtr = numSent;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives a batch of messages, each with an optional data payload and file descriptor, through a
+ * connected Unix domain datagram or sequenced-packet socket using a single system call.
+ *
+ * Never blocks.  Returns as soon as there is nothing more to receive, so a batch that isn't full
+ * means the socket has been drained.
+ *
+ * @return
+ * - LE_OK if at least one message was received (check *numReceivedPtr for how many, and the
+ *         result field of each message).
+ * - LE_WOULD_BLOCK if there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_ReceiveMsgBatch
+(
+    int localSocketFd,              ///< [IN] fd of local socket that will be used to receive.
+    unixSocket_BatchMsg_t* msgs,    ///< [IN+OUT] Buffers for the messages to be received.
+    size_t numMsgs,                 ///< [IN] Number of messages that can be received (at most
+                                    ///       UNIX_SOCKET_MAX_BATCH).
+    size_t* numReceivedPtr          ///< [OUT] Number of messages received.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct mmsghdr msgHeaders[UNIX_SOCKET_MAX_BATCH];
+    struct iovec ioVectors[UNIX_SOCKET_MAX_BATCH];
+    char cmsgBuffers[UNIX_SOCKET_MAX_BATCH][CMSG_BUFF_SIZE];
+    size_t i;
+
+    LE_ASSERT((numMsgs > 0) && (numMsgs <= UNIX_SOCKET_MAX_BATCH));
+
+    *numReceivedPtr = 0;
+
+    memset(msgHeaders, 0, numMsgs * sizeof(msgHeaders[0]));
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        msgHeaderPtr->msg_control = cmsgBuffers[i];
+        msgHeaderPtr->msg_controllen = sizeof(cmsgBuffers[i]);
+
+        if ((msgs[i].dataPtr != NULL) && (msgs[i].dataSize > 0))
+        {
+            ioVectors[i].iov_base = msgs[i].dataPtr;
+            ioVectors[i].iov_len = msgs[i].dataSize;
+            msgHeaderPtr->msg_iov = &ioVectors[i];
+            msgHeaderPtr->msg_iovlen = 1;
+        }
+
+        msgs[i].fd = -1;
+    }
+
+    // Keep trying to receive until we don't get interrupted by a signal.
+    int numReceived;
+    do
+    {
+        numReceived = recvmmsg(localSocketFd, msgHeaders, numMsgs, MSG_DONTWAIT, NULL);
+    }
+    while ((numReceived < 0) && (errno == EINTR));
+
+    // If we failed, process the error and return.
+    if (numReceived < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+        {
+            return LE_WOULD_BLOCK;
+        }
+        else if (errno == ECONNRESET)
+        {
+            return LE_CLOSED;
+        }
+        else
+        {
+            LE_ERROR("recvmmsg() failed with errno %d (%m).", errno);
+            return LE_FAULT;
+        }
+    }
+
+    for (i = 0; i < numReceived; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        if (msgHeaderPtr->msg_controllen > 0)
+        {
+            ExtractAncillaryData(msgHeaderPtr, &msgs[i].fd, NULL);
+        }
+        // If there is no ancillary data and no data, the socket must have closed.  Anything
+        // after this in the batch is just more of the same.
+        else if (msgHeaders[i].msg_len == 0)
+        {
+            break;
+        }
+
+        if ((msgHeaderPtr->msg_flags & MSG_CTRUNC) != 0)
+        {
+            LE_WARN("Ancillary data was discarded because it couldn't fit in our buffer.");
+        }
+
+        msgs[i].dataSize = msgHeaders[i].msg_len;
+        msgs[i].result = ((msgHeaderPtr->msg_flags & MSG_TRUNC) != 0) ? LE_NO_MEMORY : LE_OK;
+    }
+
+    if (i == 0)
+    {
+        return LE_CLOSED;
+    }
+
+    *numReceivedPtr = i;
+
+    return LE_OK;
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
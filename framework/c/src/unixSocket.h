@@ -157,6 +157,10 @@
  * - unixSocket_ReceiveMsg() receives a message containing any combination of normal
  *   data, a file descriptor, and authenticated credentials.
  *
+ * - unixSocket_SendMsgBatch() and unixSocket_ReceiveMsgBatch() send or receive several messages,
+ *   each with optional data and a file descriptor, in one system call (sendmmsg()/recvmmsg()).
+ *   They only work with datagram and sequenced-packet sockets.
+ *
  * When file descriptors are sent, they are duplicated in the receiving process as if they had
  * been created using the POSIX dup() function.  This means that they remain open in the sending
  * process and must be closed by the sending process when it doesn't need them anymore.
@@ -281,6 +285,33 @@
 #ifndef LEGATO_UNIX_SOCKET_INCLUDE_GUARD
 #define LEGATO_UNIX_SOCKET_INCLUDE_GUARD
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of messages that can be sent or received in one batch.
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNIX_SOCKET_MAX_BATCH 32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One message in a batch sent using unixSocket_SendMsgBatch() or received using
+ * unixSocket_ReceiveMsgBatch().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*       dataPtr;    ///< Data payload to be sent, or where the received payload will be put.
+    size_t      dataSize;   ///< Number of bytes to be sent, or that can fit in the receive buffer.
+                            ///  Updated to the number of bytes received.
+    int         fd;         ///< File descriptor to be sent (-1 if none).  Updated to the file
+                            ///  descriptor received (-1 if none).
+    le_result_t result;     ///< Set when received: LE_OK, or LE_NO_MEMORY if the message didn't
+                            ///  fit into the buffer (the rest of it is lost).
+}
+unixSocket_BatchMsg_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a named datagram Unix domain socket.  This binds the socket to a file system path.
@@ -335,6 +366,23 @@ int unixSocket_CreateSeqPacketNamed
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a sequenced-packet Unix domain socket bound to a name in the abstract namespace.  Nothing
+ * appears in the file system, and the name goes away when the socket is closed.
+ *
+ * @return
+ * - The file descriptor (a number > 0) of the socket, if successful.
+ * - LE_DUPLICATE if the name is already in use.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+int unixSocket_CreateSeqPacketAbstract
+(
+    const char* nameStr ///< [IN] Name in the abstract namespace (without the leading null byte).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates an unnamed sequenced-packet Unix domain socket.
@@ -385,6 +433,24 @@ le_result_t unixSocket_Connect
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect a local socket to a socket bound to a name in the abstract namespace.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_WOULD_BLOCK if socket is non-blocking and could not be immediately connected.
+ * - LE_NOT_FOUND if no listening socket is bound to that name.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_ConnectAbstract
+(
+    int         fd,     ///< [IN] Local socket file descriptor.
+    const char* nameStr ///< [IN] Name in the abstract namespace (without the leading null byte).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends through a connected Unix domain socket a message containing any combination of:
@@ -518,6 +584,61 @@ le_result_t unixSocket_ReceiveDataMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a batch of messages, each with an optional data payload and file descriptor, through a
+ * connected Unix domain datagram or sequenced-packet socket using a single system call.
+ *
+ * If the socket runs out of buffer space part way through the batch, only the first messages are
+ * sent.
+ *
+ * @return
+ * - LE_OK if at least one message was sent (check *numSentPtr for how many).
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ * - LE_NO_MEMORY if the send socket is set to non-blocking and it doesn't have enough buffer
+ *                  space to send right now. Wait for the "writeable" event on the file descriptor.
+ *
+ * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.  That can be exploited to break out of chroot()
+ *          jails.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_SendMsgBatch
+(
+    int localSocketFd,              ///< [IN] fd of the local socket that will be used to send.
+    unixSocket_BatchMsg_t* msgs,    ///< [IN] The messages to be sent.
+    size_t numMsgs,                 ///< [IN] Number of messages in the batch (at most
+                                    ///       UNIX_SOCKET_MAX_BATCH).
+    size_t* numSentPtr              ///< [OUT] Number of messages sent.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives a batch of messages, each with an optional data payload and file descriptor, through a
+ * connected Unix domain datagram or sequenced-packet socket using a single system call.
+ *
+ * Never blocks.  Returns as soon as there is nothing more to receive, so a batch that isn't full
+ * means the socket has been drained.
+ *
+ * @return
+ * - LE_OK if at least one message was received (check *numReceivedPtr for how many, and the
+ *         result field of each message).
+ * - LE_WOULD_BLOCK if there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_ReceiveMsgBatch
+(
+    int localSocketFd,              ///< [IN] fd of local socket that will be used to receive.
+    unixSocket_BatchMsg_t* msgs,    ///< [IN+OUT] Buffers for the messages to be received.
+    size_t numMsgs,                 ///< [IN] Number of messages that can be received (at most
+                                    ///       UNIX_SOCKET_MAX_BATCH).
+    size_t* numReceivedPtr          ///< [OUT] Number of messages received.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches the socket error state code (SO_ERROR).
@@ -28,6 +28,7 @@
 #include "interfaces.h"
 #include "limit.h"
 #include "appUser.h"
+#include "sdirLoad.h"
 #include "file.h"
 #include "dir.h"
 #include "app.h"
@@ -649,7 +650,10 @@ le_result_t app_InstallIndividual
 
 
     // Reload the bindings configuration
-    system("/legato/systems/current/bin/sdir load");
+    if (sdirLoad_LoadBindings() != LE_OK)
+    {
+        LE_ERROR("Failed to reload the bindings configuration.");
+    }
 
     ExecPostinstallHook(appMd5Ptr);
 
@@ -734,7 +738,10 @@ le_result_t app_RemoveIndividual
     }
 
     // Reload the bindings configuration
-    system("/legato/systems/current/bin/sdir load");
+    if (sdirLoad_LoadBindings() != LE_OK)
+    {
+        LE_ERROR("Failed to reload the bindings configuration.");
+    }
 
     sysStatus_MarkTried();
 
@@ -0,0 +1,258 @@
+ /**
+  * This module tests the binary ring buffer logging mode of the log module.  It must be run with
+  * the LE_LOG_BINARY environment variable set, and the log level set to INFO.
+  *
+  * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+  */
+
+#include "legato.h"
+#include "../src/logRing.h"
+#include <sys/syscall.h>
+#include <sys/mman.h>
+
+#define MAX_MSGS            16
+#define NUM_FLOOD_MSGS      10000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Messages read out of the ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static char Msgs[MAX_MSGS][256];
+static char Functions[MAX_MSGS][64];
+static le_log_Level_t Levels[MAX_MSGS];
+static size_t NumMsgs;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread ID of the thread started by TestThreadExit().
+ */
+//--------------------------------------------------------------------------------------------------
+static pid_t ThreadTid;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Saves a message read out of the ring buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveMsg
+(
+    const logRing_Msg_t* msgPtr,
+    void* contextPtr
+)
+{
+    if (NumMsgs < MAX_MSGS)
+    {
+        le_utf8_Copy(Msgs[NumMsgs], msgPtr->msgPtr, sizeof(Msgs[NumMsgs]), NULL);
+        le_utf8_Copy(Functions[NumMsgs], msgPtr->functionNamePtr, sizeof(Functions[NumMsgs]), NULL);
+        Levels[NumMsgs] = msgPtr->level;
+    }
+    NumMsgs++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the messages out of a thread's ring buffer.
+ *
+ * @return The number of messages that were dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ReadRing
+(
+    pid_t tid
+)
+{
+    char shmName[64];
+    size_t numDropped;
+
+    snprintf(shmName, sizeof(shmName), LOG_RING_SHM_PREFIX "%d.%d", getpid(), tid);
+
+    NumMsgs = 0;
+    LE_ASSERT(logRing_Read(shmName, SaveMsg, NULL, &numDropped) == LE_OK);
+
+    return numDropped;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that messages are formatted the same way as printf would have formatted them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestFormatting
+(
+    void
+)
+{
+    char expected[256];
+    const char* strPtr = "ring";
+    long long bigNum = -1234567890123LL;
+    size_t size = 4096;
+    unsigned char byte = 0xAB;
+
+    // The ring is created by the first message.
+    LE_INFO("Hello");
+
+    LE_INFO("%d %u %#06x %c %s %p %-8s| %5.2f %lld %zu %hhx %*d %.*s %%",
+            -42, 42u, 0x2a, 'z', strPtr, (void*)strPtr, "left", 3.14159, bigNum, size, byte,
+            6, 7, 3, "abcdef");
+
+    errno = ENOENT;
+    LE_INFO("errno: %m");
+
+    LE_DEBUG("This is filtered out by the log level, %d.", 1);
+
+    LE_WARN("Warnings are not written to the ring.");
+
+    LE_ASSERT(ReadRing(syscall(SYS_gettid)) == 0);
+    LE_ASSERT(NumMsgs == 3);
+
+    LE_ASSERT(strcmp(Msgs[0], "Hello") == 0);
+    LE_ASSERT(Levels[0] == LE_LOG_INFO);
+    LE_ASSERT(strcmp(Functions[0], __func__) == 0);
+
+    snprintf(expected, sizeof(expected),
+             "%d %u %#06x %c %s %p %-8s| %5.2f %lld %zu %hhx %*d %.*s %%",
+             -42, 42u, 0x2a, 'z', strPtr, (void*)strPtr, "left", 3.14159, bigNum, size, byte,
+             6, 7, 3, "abcdef");
+    LE_ASSERT(strcmp(Msgs[1], expected) == 0);
+
+    errno = ENOENT;
+    snprintf(expected, sizeof(expected), "errno: %m");
+    LE_ASSERT(strcmp(Msgs[2], expected) == 0);
+
+    // The ring is empty now.
+    LE_ASSERT(ReadRing(syscall(SYS_gettid)) == 0);
+    LE_ASSERT(NumMsgs == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that strings logged with a precision are not read past the precision.  The string is put
+ * at the end of a page that is followed by an inaccessible one, so reading past it would crash.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestStringPrecision
+(
+    void
+)
+{
+    char expected[256];
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+
+    char* pagesPtr = mmap(NULL, 2 * pageSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    LE_ASSERT(pagesPtr != MAP_FAILED);
+    LE_ASSERT(mprotect(pagesPtr + pageSize, pageSize, PROT_NONE) == 0);
+
+    // Not null-terminated.
+    char* strPtr = pagesPtr + pageSize - 4;
+    memcpy(strPtr, "abcd", 4);
+
+    LE_INFO("[%.4s] [%.*s] [%.2s] [%.s] [%.*s]", strPtr, 4, strPtr, strPtr, strPtr, 3, "xyz");
+
+    LE_ASSERT(ReadRing(syscall(SYS_gettid)) == 0);
+    LE_ASSERT(NumMsgs == 1);
+
+    snprintf(expected, sizeof(expected), "[%.4s] [%.*s] [%.2s] [%.s] [%.*s]",
+             strPtr, 4, strPtr, strPtr, strPtr, 3, "xyz");
+    LE_ASSERT(strcmp(Msgs[0], expected) == 0);
+    LE_ASSERT(strcmp(Msgs[0], "[abcd] [abcd] [ab] [] [xyz]") == 0);
+
+    LE_ASSERT(munmap(pagesPtr, 2 * pageSize) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that messages are dropped and counted when the ring is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestFullRing
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < NUM_FLOOD_MSGS; i++)
+    {
+        LE_INFO("Flood message %d", i);
+    }
+
+    size_t numDropped = ReadRing(syscall(SYS_gettid));
+
+    LE_ASSERT(numDropped > 0);
+    LE_ASSERT(NumMsgs + numDropped == NUM_FLOOD_MSGS);
+    LE_ASSERT(strcmp(Msgs[0], "Flood message 0") == 0);
+
+    // There is room again.
+    LE_INFO("After the flood");
+    LE_ASSERT(ReadRing(syscall(SYS_gettid)) == 0);
+    LE_ASSERT(NumMsgs == 1);
+    LE_ASSERT(strcmp(Msgs[0], "After the flood") == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread main function for TestThreadExit().
+ */
+//--------------------------------------------------------------------------------------------------
+static void* LoggingThread
+(
+    void* contextPtr
+)
+{
+    ThreadTid = syscall(SYS_gettid);
+
+    LE_INFO("Logged by a thread that is about to exit.");
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that a thread's ring is deleted when the thread exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestThreadExit
+(
+    void
+)
+{
+    char path[PATH_MAX];
+    le_thread_Ref_t thread = le_thread_Create("ringThread", LoggingThread, NULL);
+
+    le_thread_SetJoinable(thread);
+    le_thread_Start(thread);
+    LE_ASSERT(le_thread_Join(thread, NULL) == LE_OK);
+
+    snprintf(path, sizeof(path), "/dev/shm/" LOG_RING_SHM_PREFIX "%d.%d", getpid(), ThreadTid);
+    LE_ASSERT(access(path, F_OK) != 0);
+}
+
+
+int main(int argc, char *argv[])
+{
+    printf("\n");
+    printf("*** Unit test for binary ring buffer logging. ***\n");
+
+    LE_ASSERT(logRing_IsEnabled());
+
+    TestFormatting();
+    TestStringPrecision();
+    TestFullRing();
+    TestThreadExit();
+
+    printf("*** Unit test for binary ring buffer logging passed. ***\n");
+    printf("\n");
+
+    return LE_OK;
+}
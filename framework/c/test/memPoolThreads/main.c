@@ -0,0 +1,167 @@
+ /**
+  * This module benchmarks multi-threaded allocation and release throughput of the le_mem module,
+  * with and without per-thread caches, and checks that the pool statistics are still correct
+  * afterwards.
+  *
+  * Copyright (C) Sierra Wireless Inc. Use of this work is subject to license.
+  */
+
+#include "legato.h"
+
+typedef struct
+{
+    uint32_t id;
+    uint8_t payload[60];
+}
+obj_t;
+
+#define NUM_THREADS         4
+#define NUM_ROUNDS          50000
+#define OBJS_PER_ROUND      8
+#define POOL_SIZE           (NUM_THREADS * OBJS_PER_ROUND * 2)
+#define THREAD_CACHE_SIZE   32
+#define NUM_ALLOCS          ((uint64_t)NUM_THREADS * NUM_ROUNDS * OBJS_PER_ROUND)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread main function.  Repeatedly allocates a handful of objects, then releases them all.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AllocReleaseThread
+(
+    void* contextPtr    ///< The pool to allocate from.
+)
+{
+    le_mem_PoolRef_t pool = contextPtr;
+    obj_t* objsPtr[OBJS_PER_ROUND];
+    int round, i;
+
+    for (round = 0; round < NUM_ROUNDS; round++)
+    {
+        for (i = 0; i < OBJS_PER_ROUND; i++)
+        {
+            objsPtr[i] = le_mem_ForceAlloc(pool);
+            objsPtr[i]->id = i;
+        }
+
+        for (i = 0; i < OBJS_PER_ROUND; i++)
+        {
+            LE_ASSERT(objsPtr[i]->id == i);
+            le_mem_Release(objsPtr[i]);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the alloc/release threads against a pool and reports the throughput.
+ *
+ * @return The number of alloc/release pairs per second.
+ */
+//--------------------------------------------------------------------------------------------------
+static double RunBenchmark
+(
+    le_mem_PoolRef_t pool   ///< The pool to allocate from.
+)
+{
+    le_thread_Ref_t threads[NUM_THREADS];
+    int i;
+
+    for (i = 0; i < NUM_THREADS; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "memThread%d", i);
+
+        threads[i] = le_thread_Create(name, AllocReleaseThread, pool);
+        le_thread_SetJoinable(threads[i]);
+    }
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < NUM_THREADS; i++)
+    {
+        le_thread_Start(threads[i]);
+    }
+
+    for (i = 0; i < NUM_THREADS; i++)
+    {
+        LE_ASSERT(le_thread_Join(threads[i], NULL) == LE_OK);
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    double seconds = elapsed.sec + (elapsed.usec / 1000000.0);
+    return NUM_ALLOCS / seconds;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that a pool's statistics add up after all the threads have finished.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckStats
+(
+    le_mem_PoolRef_t pool,  ///< The pool to check.
+    uint64_t numAllocs      ///< The number of allocations expected since the stats were reset.
+)
+{
+    le_mem_PoolStats_t stats;
+    le_mem_GetStats(pool, &stats);
+
+    LE_ASSERT(stats.numBlocksInUse == 0);
+    LE_ASSERT(stats.numFree == le_mem_GetObjectCount(pool));
+    LE_ASSERT(stats.numAllocs == numAllocs);
+    LE_ASSERT(stats.maxNumBlocksUsed >= OBJS_PER_ROUND);
+}
+
+
+int main(int argc, char *argv[])
+{
+    printf("\n");
+    printf("*** Multi-threaded throughput test for le_mem module. ***\n");
+
+    le_mem_PoolRef_t lockedPool = le_mem_CreatePool("Locked Pool", sizeof(obj_t));
+    le_mem_ExpandPool(lockedPool, POOL_SIZE);
+
+    le_mem_PoolRef_t cachedPool = le_mem_CreatePool("Cached Pool", sizeof(obj_t));
+    le_mem_ExpandPool(cachedPool, POOL_SIZE);
+    le_mem_EnableThreadCache(cachedPool, THREAD_CACHE_SIZE);
+
+    double lockedRate = RunBenchmark(lockedPool);
+    CheckStats(lockedPool, NUM_ALLOCS);
+    printf("Without thread caches: %.0f alloc/release pairs per second.\n", lockedRate);
+
+    double cachedRate = RunBenchmark(cachedPool);
+    CheckStats(cachedPool, NUM_ALLOCS);
+    printf("With thread caches:    %.0f alloc/release pairs per second.\n", cachedRate);
+
+    // The dead threads must have given their cached blocks back to the pool, so a single thread
+    // must be able to allocate every block without expanding the pool.
+    size_t numObjs = le_mem_GetObjectCount(cachedPool);
+    obj_t* objsPtr[numObjs];
+    size_t i;
+
+    le_mem_ResetStats(cachedPool);
+
+    for (i = 0; i < numObjs; i++)
+    {
+        objsPtr[i] = le_mem_TryAlloc(cachedPool);
+        LE_ASSERT(objsPtr[i] != NULL);
+    }
+    LE_ASSERT(le_mem_TryAlloc(cachedPool) == NULL);
+
+    for (i = 0; i < numObjs; i++)
+    {
+        le_mem_Release(objsPtr[i]);
+    }
+    CheckStats(cachedPool, numObjs);
+
+    printf("*** Multi-threaded throughput test for le_mem module passed. ***\n");
+    printf("\n");
+
+    return LE_OK;
+}
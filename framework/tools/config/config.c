@@ -505,6 +505,60 @@ static le_cfg_nodeType_t GetNodeTypeFromString
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Open a file to import from or export to.  The descriptor is passed to the config tree, which
+ *  closes it once it's done.
+ *
+ *  @return The file descriptor, or -1 if the file couldn't be opened.
+ */
+// -------------------------------------------------------------------------------------------------
+static int OpenFile
+(
+    const char* filePathPtr,  ///< Path to the file.
+    int flags                 ///< The flags to pass to open().
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int fd = -1;
+
+    do
+    {
+        fd = open(filePathPtr, flags, S_IRUSR | S_IWUSR);
+    }
+    while ((fd == -1) && (errno == EINTR));
+
+    if (fd == -1)
+    {
+        fprintf(stderr, "Could not open file '%s': %s.\n", filePathPtr, strerror(errno));
+    }
+
+    return fd;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get the format to transfer data to and from the config tree in, as selected by the --format
+ *  option.
+ *
+ *  @return The transfer format.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_cfgAdmin_Format_t TransferFormat
+(
+    void
+)
+// -------------------------------------------------------------------------------------------------
+{
+    return UseJson ? LE_CFGADMIN_FORMAT_JSON : LE_CFGADMIN_FORMAT_NATIVE;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  This function takes the supplied result value and generates an error message for the user.
@@ -717,145 +771,6 @@ static int HandleGetJSON
 
 
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Function that handles the actual import of JSON data into the configTree.
- *
- *  @return LE_OK if the import is successful, LE_FAULT otherwise.
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t HandleImportJSONIteration
-(
-    le_cfg_IteratorRef_t iterRef,  ///< Dump the JSON data into this iterator.
-    json_t* nodePtr                ///< From this JSON object.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // Get value
-    json_t* value = json_object_get(nodePtr, JSON_FIELD_VALUE);
-
-    // Check type
-    const char* typeStr = json_string_value(json_object_get(nodePtr, JSON_FIELD_TYPE));
-    le_cfg_nodeType_t type = GetNodeTypeFromString(typeStr);
-
-    switch (type)
-    {
-        case LE_CFG_TYPE_BOOL:
-            le_cfg_SetBool(iterRef, "", json_is_true(value));
-            break;
-
-        case LE_CFG_TYPE_STRING:
-            le_cfg_SetString(iterRef, "", json_string_value(value));
-            break;
-
-        case LE_CFG_TYPE_INT:
-            le_cfg_SetInt(iterRef, "", json_integer_value(value));
-            break;
-
-        case LE_CFG_TYPE_FLOAT:
-            le_cfg_SetFloat(iterRef, "", json_real_value(value));
-            break;
-
-        case LE_CFG_TYPE_STEM:
-            {
-                // Iterate on children
-                json_t* childrenPtr = json_object_get(nodePtr, JSON_FIELD_CHILDREN);
-                json_t* childPtr;
-                int i;
-
-                json_array_foreach(childrenPtr, i, childPtr)
-                {
-                    // Get name
-                    const char* name = json_string_value(json_object_get(childPtr,
-                                                                         JSON_FIELD_NAME));
-
-                    // Is node exist with this name?
-                    le_cfg_nodeType_t existingType = le_cfg_GetNodeType(iterRef, name);
-                    switch (existingType)
-                    {
-                        case LE_CFG_TYPE_DOESNT_EXIST:
-                        case LE_CFG_TYPE_STEM:
-                        case LE_CFG_TYPE_EMPTY:
-                            // Not existing, already a stem or empty node, nothing to do
-                        break;
-
-                        default:
-                            // Issue with node creation
-                            fprintf(stderr, "Node conflict when importing, at node %s", name);
-                            return LE_NOT_POSSIBLE;
-                        break;
-                    }
-
-                    // Iterate to this child
-                    le_cfg_GoToNode(iterRef, name);
-
-                    // Iterate
-                    le_result_t subResult = HandleImportJSONIteration(iterRef, childPtr);
-                    if (subResult != LE_OK)
-                    {
-                        // Something went wrong
-                        return subResult;
-                    }
-
-                    // Go back to parent
-                    le_cfg_GoToParent(iterRef);
-                }
-            }
-            break;
-
-        default:
-            return LE_FAULT;
-    }
-
-    return LE_OK;
-}
-
-
-
-
-// -------------------------------------------------------------------------------------------------
-/**
- *  Load a JSON representation of some config data and import it into the configTree at the
- *  iterator's starting location.
- *
- *  @return LE_OK if the import is successful.  LE_FAULT otherwise.
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t HandleImportJSON
-(
-    le_cfg_IteratorRef_t iterRef,  ///< The iterator being written to.
-    const char* filePathPtr        ///< Load the JSON from a file at this path.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // Attempt to load JSON file.  If it fails to validate, then bail out.
-    json_error_t error;
-    json_t* decodedRootPtr = json_load_file(filePathPtr, 0, &error);
-
-    if (decodedRootPtr == NULL)
-    {
-        fprintf(stderr,
-                "JSON import error: line: %d, column: %d, position: %d, source: '%s', error: %s",
-                error.line,
-                error.column,
-                error.position,
-                error.source,
-                error.text);
-
-        return LE_FAULT;
-    }
-
-    // OK, looks like the JSON loaded, so iterate through it and dump it's contents into the
-    // configTree.
-    le_result_t result = HandleImportJSONIteration(iterRef, decodedRootPtr);
-    json_decref(decodedRootPtr);
-
-    return result;
-}
-
-
-
-
 // -------------------------------------------------------------------------------------------------
 /**
  *  This function will attempt read a value from the tree, and write it to standard out.  If the
@@ -1157,19 +1072,19 @@ static int HandleImport
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(NodePath);
-    le_result_t result;
+    // The file is opened here and handed to the config tree, which reads and parses the whole
+    // thing in one request.
+    int fd = OpenFile(FilePath, O_RDONLY);
 
-    // Check requested format format.
-    if (UseJson)
-    {
-        result = HandleImportJSON(iterRef, FilePath);
-    }
-    else
+    if (fd == -1)
     {
-        result = le_cfgAdmin_ImportTree(iterRef, FilePath, "");
+        ReportImportExportFail(LE_FAULT, "Import", NodePath, FilePath);
+        return EXIT_FAILURE;
     }
 
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(NodePath);
+    le_result_t result = le_cfgAdmin_ImportTreeFd(iterRef, fd, "", TransferFormat());
+
     if (result != LE_OK)
     {
         ReportImportExportFail(result, "Import", NodePath, FilePath);
@@ -1200,16 +1115,27 @@ static int HandleExport
 {
     le_result_t result;
 
-    // Check required format.
-    if (UseJson)
+    // A JSON export of all of the trees is put together here, anything else is written by the
+    // config tree straight into the file.
+    if (   (UseJson)
+        && (strcmp("*", NodePath) == 0))
     {
-        result = HandleGetJSON(NodePath, FilePath);
+        result = (HandleGetJSON(NodePath, FilePath) == EXIT_SUCCESS) ? LE_OK : LE_FAULT;
     }
     else
     {
-        le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(NodePath);
-        result = le_cfgAdmin_ExportTree(iterRef, FilePath, "");
-        le_cfg_CancelTxn(iterRef);
+        int fd = OpenFile(FilePath, O_WRONLY | O_CREAT | O_TRUNC);
+
+        if (fd == -1)
+        {
+            result = LE_FAULT;
+        }
+        else
+        {
+            le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(NodePath);
+            result = le_cfgAdmin_ExportTreeFd(iterRef, fd, "", TransferFormat());
+            le_cfg_CancelTxn(iterRef);
+        }
     }
 
     if (result != LE_OK)
@@ -48,8 +48,9 @@ FuncImplTemplate = """
     $ endfor
     {{""}}
 
-    // Create a new message object and get the message buffer
-    _msgRef = le_msg_CreateMsg(GetCurrentSessionRef());
+    // Create a new message object, just big enough for the input parameters, and get the
+    // message buffer
+    _msgRef = le_msg_CreateMsgWithSize(GetCurrentSessionRef(), _MSGSIZE_{{func.name}});
     _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     _msgPtr->id = _MSGID_{{func.name}};
     _msgBufPtr = _msgPtr->buffer;
@@ -57,9 +58,10 @@ FuncImplTemplate = """
     // Pack the input parameters
     {{ func.parmListIn | printParmList("clientPack", sep="\n") | indent }}
 
-    // Send a request to the server and get the response.
+    // Send a request to the server and get the response.  Only the packed bytes are sent.
     LE_DEBUG("Sending message to server and waiting for response : %ti bytes sent",
              _msgBufPtr-_msgPtr->buffer);
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     _responseMsgRef = le_msg_RequestSyncResponse(_msgRef);
     // It is a serious error if we don't get a valid response from the server
     LE_FATAL_IF(_responseMsgRef == NULL, "Valid response was not received from server");
@@ -106,6 +108,110 @@ def WriteFuncCode(func, template):
 #---------------------------------------------------------------------------------------------------
 
 
+PipelinedFuncImplTemplate = """
+// This function is called when the response to {{func.name}}Pipelined() arrives.  It unpacks the
+// result and output parameters, and then calls the response handler given by the caller, which
+// is stored in a client data object.
+static void _PipelinedResp_{{func.name}}
+(
+    le_msg_MessageRef_t _responseMsgRef,
+    void* _dataPtr
+)
+{
+    _ClientData_t* _clientDataPtr = _dataPtr;
+
+    // Pull out the data from the client data pointer; it is not needed after that.
+    {{func.name}}RespHandlerFunc_t _handlerRef_{{func.name}} =
+        ({{func.name}}RespHandlerFunc_t)_clientDataPtr->handlerPtr;
+    void* _contextPtr = _clientDataPtr->contextPtr;
+    le_mem_Release(_clientDataPtr);
+
+    // It is a serious error if we don't get a valid response from the server
+    LE_FATAL_IF(_responseMsgRef == NULL, "Valid response was not received from server");
+
+    // The caller doesn't want the response.
+    if ( _handlerRef_{{func.name}} == NULL )
+    {
+        le_msg_ReleaseMsg(_responseMsgRef);
+        return;
+    }
+
+    // Process the result and/or output parameters, if there are any.
+    _Message_t* _msgPtr = le_msg_GetPayloadPtr(_responseMsgRef);
+
+    // Will not be used if no data is received from server.
+    __attribute__((unused)) uint8_t* _msgBufPtr = _msgPtr->buffer;
+
+    {% if func.type -%}
+    // Unpack the result first
+    {{func.resultStorage}}
+    _msgBufPtr = UnpackData( _msgBufPtr, &_result, sizeof(_result) );
+    {% endif %}
+
+    // Unpack any "out" parameters
+    {{ func.parmListOut | printParmList("clientPipelinedUnpack", sep="\n") | indent }}
+
+    // Call the response handler
+    _handlerRef_{{func.name}}( {{ func | printClientPipelinedRespCallList }} );
+
+    // Release the message object, now that the handler is finished with the output.
+    le_msg_ReleaseMsg(_responseMsgRef);
+}
+
+
+{{prototype}}
+{
+    le_msg_MessageRef_t _msgRef;
+    _Message_t* _msgPtr;
+
+    // Will not be used if no data is sent to server.
+    __attribute__((unused)) uint8_t* _msgBufPtr;
+
+    // Range check values, if appropriate
+    $ for p in func.parmListIn
+    $ if p.maxValue:
+    {{ p.maxValueCheck.format( parm=p ) }}
+    $ endif
+    $ endfor
+    {{""}}
+
+    // The response handler and its context are kept in a client data object, which is passed
+    // as the context for the response.
+    _ClientData_t* _clientDataPtr = le_mem_ForceAlloc(_ClientDataPool);
+    _clientDataPtr->handlerPtr = (le_event_HandlerFunc_t)handlerPtr;
+    _clientDataPtr->contextPtr = contextPtr;
+    _clientDataPtr->handlerRef = NULL;
+    _clientDataPtr->callersThreadRef = le_thread_GetCurrent();
+
+    // Create a new message object, just big enough for the input parameters, and get the
+    // message buffer
+    _msgRef = le_msg_CreateMsgWithSize(GetCurrentSessionRef(), _MSGSIZE_{{func.name}});
+    _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    _msgPtr->id = _MSGID_{{func.name}};
+    _msgBufPtr = _msgPtr->buffer;
+
+    // Pack the input parameters
+    {{ func.parmListIn | printParmList("clientPipelinedPack", sep="\n") | indent }}
+
+    // Send the request to the server without waiting for the response.  The response is matched
+    // to this request by its transaction ID, so any number of requests can be outstanding.
+    LE_DEBUG("Sending message to server : %ti bytes sent", _msgBufPtr-_msgPtr->buffer);
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
+    le_msg_RequestResponse(_msgRef, _PipelinedResp_{{func.name}}, _clientDataPtr);
+}
+"""
+
+
+def WritePipelinedFuncCode(func, template):
+    funcStr = common.FormatCode(template,
+                                func=func,
+                                prototype=codeGenCommon.GetClientPipelinedFuncPrototypeStr(func))
+    print >>ClientFileText, funcStr
+
+
+#---------------------------------------------------------------------------------------------------
+
+
 # TODO:  The code in this template should probably not be using serverUnpack and serverCallName,
 #        since this function is on the client side.  It made sense before, because the prefix was
 #        'handler' and 'unpack', respectively, instead of 'server', but there were many other cases
@@ -639,6 +745,10 @@ def WriteClientFile(headerFiles, pf, ph, genericFunctions):
         # Write out the functions next
         WriteFuncCode(f, FuncImplTemplate)
 
+        # and the pipelined version, if the function can have one
+        if codeGenCommon.IsClientPipelinedFunc(f):
+            WritePipelinedFuncCode(f, PipelinedFuncImplTemplate)
+
     funcsWithHandlers = [ f for f in pf.values() if f.handlerName ]
     WriteAsyncHandler(funcsWithHandlers, AsyncHandlerTemplate)
 
@@ -291,6 +291,137 @@ def GetServerAsyncFuncPrototypeStr(func):
 
 
 
+#---------------------------------------------------------------------------------------------------
+
+
+#
+# Returns True if a pipelined client function is generated for the given function.
+#
+# Functions that have handler parameters, or are Add and Remove handler functions, are never
+# pipelined.  Neither are functions with OUT parameters of unbounded size, since the response
+# has to be unpacked into fixed-size local storage before it is passed to the response handler.
+#
+def IsClientPipelinedFunc(func):
+    if func.handlerName or func.isRemoveHandler:
+        return False
+
+    return all( p.maxNumBytes is not None for p in func.parmListOut )
+
+
+ClientPipelinedHandlerTypeTemplate = """
+//--------------------------------------------------------------------------------------------------
+/**
+ * Response handler for {{func.name}}Pipelined()
+ *
+ * It gets the result and OUT parameters of the call.  Any buffers are only valid until the
+ * handler returns.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*{{func.name}}RespHandlerFunc_t)
+(
+    {{ func | printClientPipelinedRespParmList | indent }}
+)
+"""
+
+#
+# Define and register the filter for processing the response handler parameter list.  The result
+# and OUT parameters are passed the same way as to the server-side respond function.
+#
+def PrintClientPipelinedRespParmList(func):
+    resultList = []
+
+    # Add return parameter, if there is one
+    if func.type:
+        resultList.append( "%s _result" % func.type )
+
+    # Add OUT parameters, if there are any
+    resultList += [ p.asyncServerParmList.format(parm=p) for p in func.parmListOut ]
+
+    # This parameter always exists
+    resultList.append( "void* contextPtr" )
+
+    # Return everything as a string
+    return ',\n'.join( resultList )
+
+Environment.filters["printClientPipelinedRespParmList"] = PrintClientPipelinedRespParmList
+
+
+#
+# Define and register the filter for the arguments passed to the response handler, which are
+# unpacked into local variables by the generated response function.
+#
+def PrintClientPipelinedRespCallList(func):
+    resultList = []
+
+    if func.type:
+        resultList.append( "_result" )
+
+    resultList += [ p.clientPipelinedCallName.format(parm=p) for p in func.parmListOut ]
+    resultList.append( "_contextPtr" )
+
+    return ', '.join( resultList )
+
+Environment.filters["printClientPipelinedRespCallList"] = PrintClientPipelinedRespCallList
+
+
+#
+# Create a string for the response handler type definition used by the pipelined client functions.
+#
+def GetClientPipelinedHandlerTypeStr(func):
+    funcStr = common.FormatCode(ClientPipelinedHandlerTypeTemplate, func=func)
+
+    # Remove any leading or trailing whitespace on the return string, such as newlines, so that
+    # it doesn't add extra, unintended, spaces in the generated code output.
+    return funcStr.strip()
+
+
+ClientPipelinedFuncPrototypeTemplate = """
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pipelined version of {{func.name}}().  Sends the request and returns without waiting for the
+ * response.  The response handler is called by this thread's event loop when the response
+ * arrives, so many requests can be outstanding on the session at once.
+$ if func.parmListOut
+ *
+ * OUT arrays and strings are limited to their maximum sizes from the API definition.
+$ endif
+ */
+//--------------------------------------------------------------------------------------------------
+void {{func.name}}Pipelined
+(
+    {{ func | printClientPipelinedParmList | indent }}
+)
+"""
+
+#
+# Define and register the filter for processing the pipelined client function parameter list.
+# The IN parameters are followed by the response handler and its context pointer; if the handler
+# is NULL, the response is discarded.
+#
+def PrintClientPipelinedParmList(func):
+    resultList = [ p.clientPipelinedParmList.format(parm=p) for p in func.parmListInCall ]
+
+    # These parameters always exist
+    resultList.append( "%sRespHandlerFunc_t handlerPtr" % func.name )
+    resultList.append( "void* contextPtr" )
+
+    # Return everything as a string
+    return ',\n'.join( resultList )
+
+Environment.filters["printClientPipelinedParmList"] = PrintClientPipelinedParmList
+
+#
+# Create a string for the pipelined client function prototype/declaration.  This string is used
+# in more than one place, i.e. in the header file and also the client file.
+#
+def GetClientPipelinedFuncPrototypeStr(func):
+    funcStr = common.FormatCode(ClientPipelinedFuncPrototypeTemplate, func=func)
+
+    # Remove any leading or trailing whitespace on the return string, such as newlines, so that
+    # it doesn't add extra, unintended, spaces in the generated code output.
+    return funcStr.strip()
+
+
 #---------------------------------------------------------------------------------------------------
 # Output file templates/code
 #---------------------------------------------------------------------------------------------------
@@ -179,7 +179,8 @@ def WriteCommonInterface(fp,
                          fileName,
                          genericFunctions,
                          headerComments,
-                         genAsync):
+                         genAsync,
+                         genClientPipelined=False):
 
     codeGenCommon.WriteWarning(fp)
 
@@ -232,6 +233,11 @@ def WriteCommonInterface(fp,
         else:
             print >>fp, "%s;\n" % codeGenCommon.GetFuncPrototypeStr(f)
 
+        # Clients also get a pipelined version of the function, if it can have one.
+        if genClientPipelined and codeGenCommon.IsClientPipelinedFunc(f):
+            print >>fp, "%s;\n" % codeGenCommon.GetClientPipelinedHandlerTypeStr(f)
+            print >>fp, "%s;\n" % codeGenCommon.GetClientPipelinedFuncPrototypeStr(f)
+
     WriteIncludeGuardEnd(fp, fileName)
 
 
@@ -259,7 +265,8 @@ def WriteInterfaceHeaderFile(pf,
                          fileName,
                          genericFunctions,
                          headerComments,
-                         False)
+                         False,
+                         True)
 
     return InterfaceHeaderFileText
 
@@ -283,6 +290,9 @@ LocalHeaderStartTemplate = """
 // todo: This will need to depend on the particular protocol, but the exact size is not easy to
 //       calculate right now, so in the meantime, pick a reasonably large size.  Once interface
 //       type support has been added, this will be replaced by a more appropriate size.
+//
+// Note that this is only the largest possible message.  Each message is allocated with the size
+// given by its _MSGSIZE_ define below, and only the bytes actually packed are sent.
 #define _MAX_MSG_SIZE {{maxMsgSize}}
 
 // Define the message type for communicating between client and server
@@ -303,7 +313,11 @@ def WriteLocalHeaderFile(pf, ph, hashValue, fileName, serviceName):
     #
     #       In the future, this size will be automatically calculated.
     #
-    if fileName.endswith( ("le_secStore_messages.h", "secStoreAdmin_messages.h") ):
+    #       The config tree batch API needs the larger size for its batch buffers.  They are
+    #       kept out of le_cfg so that every le_cfg client doesn't pay for them.
+    #
+    if fileName.endswith( ("le_secStore_messages.h", "secStoreAdmin_messages.h",
+                           "le_cfgBatch_messages.h") ):
         maxMsgSize = 8500
     elif fileName.endswith("le_cfg_messages.h"):
         maxMsgSize = 1600
@@ -323,6 +337,18 @@ def WriteLocalHeaderFile(pf, ph, hashValue, fileName, serviceName):
         print >>LocalHeaderFileText, "#define _MSGID_%s %i" % (name, i)
     print >>LocalHeaderFileText
 
+    # Write out the largest request message payload for each function, and for functions that
+    # take a handler, the largest message payload sent when the handler is called.
+    for name, f in pf.items():
+        print >>LocalHeaderFileText, "#define _MSGSIZE_%s (%s)" % (name, f.maxMsgSize)
+        if f.handlerName:
+            for h in ph.values():
+                if h.name == f.handlerName:
+                    print >>LocalHeaderFileText, "#define _HANDLER_MSGSIZE_%s (%s)" % (name,
+                                                                             h.maxMsgSize)
+                    break
+    print >>LocalHeaderFileText
+
     WriteIncludeGuardEnd(LocalHeaderFileText, fileName)
 
     return LocalHeaderFileText
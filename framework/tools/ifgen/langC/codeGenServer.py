@@ -57,8 +57,10 @@ static void AsyncResponse_{{func.name}}
     // Will not be used if no data is sent back to client
     __attribute__((unused)) uint8_t* _msgBufPtr;
 
-    // Create a new message object and get the message buffer
-    _msgRef = le_msg_CreateMsg(serverDataPtr->clientSessionRef);
+    // Create a new message object, just big enough for the handler parameters, and get the
+    // message buffer
+    _msgRef = le_msg_CreateMsgWithSize(serverDataPtr->clientSessionRef,
+                                       _HANDLER_MSGSIZE_{{func.name}});
     _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     _msgPtr->id = _MSGID_{{func.name}};
     _msgBufPtr = _msgPtr->buffer;
@@ -73,6 +75,7 @@ static void AsyncResponse_{{func.name}}
     LE_DEBUG("Sending message to client session %p : %ti bytes sent",
              serverDataPtr->clientSessionRef,
              _msgBufPtr-_msgPtr->buffer);
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     SendMsgToClient(_msgRef);
 
     $ if func.handlerName and not func.isAddHandler :
@@ -167,6 +170,7 @@ static void Handle_{{func.name}}
     LE_DEBUG("Sending response to client session %p : %ti bytes sent",
              le_msg_GetSession(_msgRef),
              _msgBufPtr-_msgBufStartPtr);
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)le_msg_GetPayloadPtr(_msgRef));
     le_msg_Respond(_msgRef);
 }
 """
@@ -198,6 +202,7 @@ AsyncFuncHandlerTemplate = """
 
     // Return the response
     LE_DEBUG("Sending response to client session %p", le_msg_GetSession(_msgRef));
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     le_msg_Respond(_msgRef);
 }
 
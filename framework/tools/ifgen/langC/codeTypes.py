@@ -173,6 +173,17 @@ _msgBufPtr = PackData( _msgBufPtr, {parm.serverAddr}, {parm.numBytes} );\
 
     asyncServerPack = """\
 _msgBufPtr = PackData( _msgBufPtr, {parm.serverAddr}, {parm.numBytes} );\
+"""
+
+    # For the client-side pipelined functions, the response is unpacked into local
+    # storage in the response handler, and then passed to the caller's response handler.
+    clientPipelinedUnpack = """\
+{parm.type} {parm.name};
+_msgBufPtr = UnpackData( _msgBufPtr, &{parm.name}, {parm.numBytes} );\
+"""
+
+    clientPipelinedCallName = """\
+{parm.name}\
 """
 
     # Ensure that the array/string length is not greater than the maximum from the API definition.
@@ -233,6 +244,12 @@ if ( {parm.value} > {parm.maxValue} ) LE_FATAL("{parm.value} > {parm.maxValue}")
     def numBytes(self):
         return "sizeof(%s)" % self.type
 
+    # Largest number of bytes that this parameter can take up when packed into a message, or None
+    # if there is no limit.
+    @Getter
+    def maxNumBytes(self):
+        return self.numBytes
+
     @Getter
     def address(self):
         return "&%s" % self.name
@@ -278,6 +295,19 @@ if ( {parm.value} > {parm.maxValue} ) LE_FATAL("{parm.value} > {parm.maxValue}")
     def asyncServerCallName(self):
         return self.name
 
+    #
+    # For support of client-side pipelined functions.  The request is packed just like for the
+    # synchronous function, unless a class says otherwise.
+    #
+
+    @Getter
+    def clientPipelinedParmList(self):
+        return self.clientParmList
+
+    @Getter
+    def clientPipelinedPack(self):
+        return self.clientPack
+
 
     def __str__(self):
         return "%s %s" % (self.type, self.name)
@@ -307,6 +337,16 @@ class PointerParmData(BaseParmData):
         self.asyncServerParmType = self.type
         self.asyncServerParmName = self.name
 
+        # The pipelined client functions can't write back through a pointer, since they return
+        # before the response arrives, so INOUT parameters are only passed in by value.
+        if self.direction == common.DIR_INOUT:
+            self.clientPipelinedParmList = """\
+{parm.type} {parm.name}\
+"""
+            self.clientPipelinedPack = """\
+_msgBufPtr = PackData( _msgBufPtr, &{parm.name}, {parm.numBytes} );\
+"""
+
 
 
 class FileInParmData(BaseParmData):
@@ -314,6 +354,9 @@ class FileInParmData(BaseParmData):
     def __init__(self, name):
         super(FileInParmData, self).__init__(name, RawType('int'))
 
+        # The fd is not packed into the message buffer.
+        self.maxNumBytes = "0"
+
         self.clientPack = """\
 le_msg_SetFd(_msgRef, {parm.parmName});\
 """
@@ -329,8 +372,15 @@ class FileOutParmData(PointerParmData):
     def __init__(self, name):
         super(FileOutParmData, self).__init__(name, RawType('int'), common.DIR_OUT)
 
+        # The fd is not packed into the message buffer.
+        self.maxNumBytes = "0"
+
     clientUnpack = """\
 {parm.value} = le_msg_GetFd(_responseMsgRef);\
+"""
+
+    clientPipelinedUnpack = """\
+{parm.type} {parm.name} = le_msg_GetFd(_responseMsgRef);\
 """
 
     serverPack = """\
@@ -371,6 +421,16 @@ class ArrayParmData(BaseParmData):
         self.serverName = "%s[%s]" % (self.name, self.sizeVar)
         self.serverAddr = self.name
 
+        # IN arrays are limited by maxSize, and OUT arrays by minSize (the buffer size).
+        if self.direction == common.DIR_IN:
+            limit = getattr(self, 'maxSize', None)
+        else:
+            limit = getattr(self, 'minSize', None)
+        if limit is not None:
+            self.maxNumBytes = "%s*sizeof(%s)" % (limit, self.type)
+        else:
+            self.maxNumBytes = None
+
         # Some details depend on direction
         if self.direction == common.DIR_IN:
             # IN arrays should be "const"
@@ -389,6 +449,13 @@ class ArrayParmData(BaseParmData):
             self.numBytes = "%s*sizeof(%s)" % (self.sizeVar, self.type)
             self.serverPack = self.serverPack.format(parm=self)
 
+            # The pipelined client functions unpack into a local buffer, which is as big as the
+            # largest array the server is allowed to send.
+            self.clientPipelinedUnpack = """\
+{parm.type} {parm.name}[{parm.minSize}];
+_msgBufPtr = UnpackData( _msgBufPtr, {parm.name}, {parm.numBytes} );\
+"""
+
             # For the respond function, need a slightly different packing rule, and then go
             # ahead and pre-evaluate it, to ensure the correct numBytes is used.
             # todo: do we really need to pre-evaluate this?
@@ -433,6 +500,9 @@ class StringParmData(BaseParmData):
 
         # Need to add 1 to maxValue to account for the terminating NULL-character
         self.numBytes = self.maxValue+1
+
+        # PackString() packs the string length, followed by the string without its terminator.
+        self.maxNumBytes = "sizeof(uint32_t)+%s" % self.maxValue
         self.serverName = "%s[%s]" % (self.name, self.numBytes )
         self.serverAddr = self.name
 
@@ -464,6 +534,12 @@ _msgBufPtr = UnpackString( _msgBufPtr, {parm.serverAddr}, {parm.numBytes} );\
         self.numBytes = "%s*sizeof(%s)" % (self.sizeVar, self.type)
         self.address = self.parmName
 
+        # PackString() packs the string length, followed by the string without its terminator.
+        if minSize is not None:
+            self.maxNumBytes = "sizeof(uint32_t)+%s" % self.baseMinSize
+        else:
+            self.maxNumBytes = None
+
         # Need to init the string to an empty string, in case the function that is called does not
         # actually return a value in this string. This ensures that a valid string is packed, even
         # if it is just empty.  The init has to be done in a separate statement, since the size
@@ -484,6 +560,11 @@ _msgBufPtr = PackString( _msgBufPtr, {parm.serverAddr} );\
 _msgBufPtr = UnpackString( _msgBufPtr, {parm.address}, {parm.numBytes} );\
 """
 
+        self.clientPipelinedUnpack = """\
+{parm.type} {parm.name}[{parm.minSize}];
+_msgBufPtr = UnpackString( _msgBufPtr, {parm.name}, sizeof({parm.name}) );\
+"""
+
 
 
 class HandlerPointerParmData(BaseParmData):
@@ -519,6 +600,9 @@ _UNLOCK\
         # Nothing to do in this case
         self.serverUnpack = ""
 
+        # The handler is not packed into the message buffer.
+        self.maxNumBytes = "0"
+
 
     def setFuncName(self, funcName, funcType):
         self.funcName = funcName
@@ -558,6 +642,20 @@ def FileParmData(pName, direction):
 # Function data related classes
 #--------------------------------------------------------------------------
 
+def GetMaxMsgSize(parmList):
+    # Returns a C expression for the largest message payload needed to pack the given parameters,
+    # including the message ID.  If any of the parameters has no size limit, the whole message
+    # buffer may be needed.
+    sizeList = [ "offsetof(_Message_t, buffer)" ]
+    for p in parmList:
+        if p.maxNumBytes is None:
+            return "sizeof(_Message_t)"
+        if p.maxNumBytes != "0":
+            sizeList.append( str(p.maxNumBytes) )
+
+    return " + ".join(sizeList)
+
+
 class BaseFunctionData(object):
 
     def __init__(self, funcName, funcType, parmList, comment=""):
@@ -619,6 +717,9 @@ class FunctionData(BaseFunctionData):
         else:
             self.resultStorage = ""
 
+        # Largest request message payload; only the IN parameters are sent in the request.
+        self.maxMsgSize = GetMaxMsgSize(self.parmListIn)
+
 
     def processParmList(self, parmList):
         #
@@ -717,6 +818,16 @@ if ( {parm.serverName} > {parm.minValue} )
     LE_DEBUG("Adjusting {parm.serverName} from %zd to {parm.minValue}", {parm.serverName});
     {parm.serverName} = {parm.minValue};
 }}\
+"""
+
+                        # The pipelined client functions unpack the array into a buffer that
+                        # only holds minValue elements, so never ask for more, and don't trust
+                        # the server to send no more than was asked for.
+                        sizeParm.clientPipelinedPack = """\
+if ( {parm.name} > {parm.minValue} ) {parm.name} = {parm.minValue};
+""" + sizeParm.clientPipelinedPack
+                        sizeParm.clientPipelinedUnpack += """
+LE_FATAL_IF({parm.name} > {parm.minValue}, "{parm.name} > {parm.minValue}");\
 """
 
                     # Add the parameter to the appropriate lists.  Note that it goes into both
@@ -749,6 +860,12 @@ if ( {parm.serverName} > {parm.minValue} )
                     if hasattr(p, 'baseMinSize'):
                         sizeParm.baseMinValue = p.baseMinSize
 
+                        # The pipelined client functions unpack the string into a buffer that
+                        # only holds minValue bytes, so never ask for a longer string.
+                        sizeParm.clientPipelinedPack = """\
+if ( {parm.name} > {parm.minValue} ) {parm.name} = {parm.minValue};
+""" + sizeParm.clientPack
+
                     newParmList.append(sizeParm)
 
                     inList.append(sizeParm)
@@ -784,6 +901,9 @@ class HandlerFuncData(BaseFunctionData):
         # convention for the type is to add the 'Func_t' suffix.
         super(HandlerFuncData, self).__init__(funcName+'Func_t', '', parmList, comment)
 
+        # Largest handler message payload; this includes the contextPtr, which is always packed.
+        self.maxMsgSize = GetMaxMsgSize(self.parmList)
+
         # Store the full name, for mapping from API names to C names
         HandlerTypes[funcName] = self.name
 
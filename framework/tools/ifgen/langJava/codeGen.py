@@ -84,7 +84,7 @@ def RecordImportedTypes(importedCode):
 # --------------------------------------------------------------------------------------------------
 def BufferSize(args):
 
-    if args.interfaceFile.endswith( ("le_secStore.api", "secStoreAdmin.api") ):
+    if args.interfaceFile.endswith( ("le_secStore.api", "secStoreAdmin.api", "le_cfgBatch.api") ):
         maxMsgSize = 8504
     elif args.interfaceFile.endswith("le_cfg.api"):
         maxMsgSize = 1604
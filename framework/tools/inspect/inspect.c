@@ -17,6 +17,7 @@
 #include "hashmap.h"
 #include "messagingInterface.h"
 #include "messagingProtocol.h"
+#include "messagingBulk.h"
 #include "messagingSession.h"
 #include "limit.h"
 #include "addr.h"
@@ -85,11 +86,49 @@ typedef struct
 {
     le_dls_List_t* bucketsPtr;  ///< Array of buckets in the hashmap in the remote process.
     size_t bucketCount;         ///< Size of the array of buckets.
+    le_dls_List_t* oldBucketsPtr; ///< Array of buckets not yet moved, if the map is being resized.
+    size_t oldBucketCount;      ///< Size of the array of old buckets (0 if not being resized).
+    size_t rehashIndex;         ///< Index of the first old bucket that has not been moved yet.
     size_t* mapChgCntRef;       ///< Change counter for the remote map.
 }
 RemoteHashmapAccess_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of buckets to walk in a remote hashmap.  If the map is being resized, the old
+ * buckets that have not been moved yet are walked after the current ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetRemoteBucketCount
+(
+    RemoteHashmapAccess_t* mapPtr
+)
+{
+    return mapPtr->bucketCount + (mapPtr->oldBucketCount - mapPtr->rehashIndex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the remote address of a bucket to walk in a remote hashmap.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t* GetRemoteBucketPtr
+(
+    RemoteHashmapAccess_t* mapPtr,
+    size_t index                    ///< [IN] Index from 0 to GetRemoteBucketCount() - 1.
+)
+{
+    if (index < mapPtr->bucketCount)
+    {
+        return mapPtr->bucketsPtr + index;
+    }
+
+    return mapPtr->oldBucketsPtr + mapPtr->rehashIndex + (index - mapPtr->bucketCount);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Iterator objects for stepping through the list of memory pools, thread objects, timers, mutexes,
@@ -709,6 +748,9 @@ static InterfaceObjIter_Ref_t CreateInterfaceObjIter
 
     iteratorPtr->interfaceObjMap.bucketsPtr = map.bucketsPtr;
     iteratorPtr->interfaceObjMap.bucketCount = map.bucketCount;
+    iteratorPtr->interfaceObjMap.oldBucketsPtr = map.oldBucketsPtr;
+    iteratorPtr->interfaceObjMap.oldBucketCount = map.oldBucketCount;
+    iteratorPtr->interfaceObjMap.rehashIndex = map.rehashIndex;
 
     // Get the mapChgCntRef for the process-under-inspection.
     if (fd_ReadFromOffset(FdProcMem, mapChgCntAddrOffset, &(iteratorPtr->interfaceObjMap.mapChgCntRef),
@@ -1365,7 +1407,7 @@ static void* GetNextInterfaceObjPtr
     while (remEntryNextLinkPtr == NULL)
     {
         // Increment the bucket index. Return null if we run out of buckets.
-        if (iterator->currIndex < (iterator->interfaceObjMap.bucketCount - 1))
+        if (iterator->currIndex < (GetRemoteBucketCount(&iterator->interfaceObjMap) - 1))
         {
             iterator->currIndex++;
         }
@@ -1376,7 +1418,8 @@ static void* GetNextInterfaceObjPtr
 
         // So we haven't run out of buckets yet. Then update our interface object list.
         if (fd_ReadFromOffset(FdProcMem,
-                              (ssize_t)(iterator->interfaceObjMap.bucketsPtr + iterator->currIndex),
+                              (ssize_t)GetRemoteBucketPtr(&iterator->interfaceObjMap,
+                                                          iterator->currIndex),
                               &(iterator->interfaceObjList.List),
                               sizeof(iterator->interfaceObjList.List)) != LE_OK)
         {
@@ -1723,7 +1766,13 @@ static ColumnInfo_t SessionObjTableInfo[] =
     {"INTERFACE NAME", "%*s", NULL, "%*s", LIMIT_MAX_IPC_INTERFACE_NAME_BYTES, true,  0, true},
     {"STATE",          "%*s", NULL, "%*s", 0,                                  true,  0, true},
     {"THREAD NAME",    "%*s", NULL, "%*s", MAX_THREAD_NAME_SIZE,               true,  0, true},
-    {"FD",             "%*s", NULL, "%*d", sizeof(int),                        false, 0, false}
+    {"FD",             "%*s", NULL, "%*d", sizeof(int),                        false, 0, false},
+    {"TX MSGS",        "%*s", NULL, "%*zu", sizeof(size_t),                    false, 0, false},
+    {"TX BATCHES",     "%*s", NULL, "%*zu", sizeof(size_t),                    false, 0, false},
+    {"MAX TX BATCH",   "%*s", NULL, "%*zu", sizeof(size_t),                    false, 0, false},
+    {"RX MSGS",        "%*s", NULL, "%*zu", sizeof(size_t),                    false, 0, false},
+    {"RX BATCHES",     "%*s", NULL, "%*zu", sizeof(size_t),                    false, 0, false},
+    {"MAX RX BATCH",   "%*s", NULL, "%*zu", sizeof(size_t),                    false, 0, false}
 };
 static size_t SessionObjTableInfoSize = NUM_ARRAY_MEMBERS(SessionObjTableInfo);
 
@@ -3610,6 +3659,18 @@ static int PrintSessionObjInfo
                                                  SessionObjTableInfoSize, &index);
         FillIntColField(sessionObjRef->socketFd, SessionObjTableInfo,
                                                  SessionObjTableInfoSize, &index);
+        FillSizeTColField(sessionObjRef->txStats.msgCount,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index);
+        FillSizeTColField(sessionObjRef->txStats.batchCount,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index);
+        FillSizeTColField(sessionObjRef->txStats.maxBatch,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index);
+        FillSizeTColField(sessionObjRef->rxStats.msgCount,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index);
+        FillSizeTColField(sessionObjRef->rxStats.batchCount,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index);
+        FillSizeTColField(sessionObjRef->rxStats.maxBatch,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index);
 
         PrintInfo(SessionObjTableInfo, SessionObjTableInfoSize);
         lineCount++;
@@ -3638,6 +3699,18 @@ static int PrintSessionObjInfo
                                                  SessionObjTableInfoSize, &index, &printed);
         ExportIntToJson(sessionObjRef->socketFd, SessionObjTableInfo,
                                                  SessionObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(sessionObjRef->txStats.msgCount,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(sessionObjRef->txStats.batchCount,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(sessionObjRef->txStats.maxBatch,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(sessionObjRef->rxStats.msgCount,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(sessionObjRef->rxStats.batchCount,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson(sessionObjRef->rxStats.maxBatch,
+                          SessionObjTableInfo, SessionObjTableInfoSize, &index, &printed);
 
         printf("]");
     }
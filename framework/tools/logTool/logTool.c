@@ -27,6 +27,14 @@ $ log trace keyword processName/componentName
  * @verbatim
 $ log stoptrace keyword processName/componentName
 @endverbatim
+ *
+ * To print the messages waiting in the binary log ring buffers of all processes:
+ * @verbatim
+$ log dump
+@endverbatim
+ *
+ * The dump command doesn't go through the log daemon.  The log tool reads the ring buffers
+ * directly, and formats the messages itself.
  *
  *
  * With all of the above examples "*" can be used in place of processName and componentName to mean
@@ -53,7 +61,9 @@ $ log stoptrace keyword processName/componentName
 #include "log.h"
 #include "logDaemon.h"
 #include "limit.h"
+#include "logRing.h"
 #include <ctype.h>
+#include <dirent.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -91,6 +101,14 @@ static const char* CommandParamPtr = NULL;
 static const char* SessionIdPtr = DEFAULT_SESSION_ID;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * True if the binary log ring buffers are to be dumped (this is not a Log Control Daemon command).
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool DumpRings = false;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * True if an error response was received from the Log Control Daemon.
@@ -119,6 +137,7 @@ static void PrintHelpAndExit
         "    log trace KEYWORD_STR [DESTINATION]\n"
         "    log stoptrace KEYWORD_STR [DESTINATION]\n"
         "    log forget PROCESS_NAME\n"
+        "    log dump\n"
         "\n"
         "DESCRIPTION:\n"
         "    log list            Lists all processes/components registered with the\n"
@@ -146,6 +165,11 @@ static void PrintHelpAndExit
         "                        Future processes with that name will have default\n"
         "                        settings.\n"
         "\n"
+        "    log dump            Prints the messages waiting in the binary log ring\n"
+        "                        buffers of all processes, and empties the buffers.\n"
+        "                        Binary logging is turned on for a process by setting\n"
+        "                        the LE_LOG_BINARY environment variable.\n"
+        "\n"
         "The [DESTINATION] is optional and specifies the process and component to\n"
         "send the command to.  The [DESTINATION] must be in this format:\n"
         "\n"
@@ -522,6 +546,12 @@ static void CommandArgHandler
 
         // This command has no parameters and no destination.
     }
+    else if (strcmp(command, "dump") == 0)
+    {
+        DumpRings = true;
+
+        // This command has no parameters and no destination.
+    }
     else if (strcmp(command, "forget") == 0)
     {
         Command = LOG_CMD_FORGET_PROCESS;
@@ -538,6 +568,92 @@ static void CommandArgHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints a message read from a binary log ring buffer.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void PrintRingMsg
+(
+    const logRing_Msg_t* msgPtr,    ///< [IN] The message.
+    void* contextPtr                ///< [IN] Not used.
+)
+{
+    const char* levelPtr = msgPtr->keywordPtr;
+    char timeStamp[32] = "";
+    struct tm localTime;
+
+    if (msgPtr->level != (le_log_Level_t)-1)
+    {
+        levelPtr = log_SeverityLevelToStr(msgPtr->level);
+    }
+
+    if (localtime_r(&msgPtr->timestamp.tv_sec, &localTime) != NULL)
+    {
+        size_t len = strftime(timeStamp, sizeof(timeStamp), "%b %d %H:%M:%S", &localTime);
+
+        snprintf(timeStamp + len, sizeof(timeStamp) - len, ".%06ld",
+                 msgPtr->timestamp.tv_nsec / 1000);
+    }
+
+    printf("%s : %s | %s[%d]/%s T=%s | %s %s() %u | %s\n",
+           timeStamp, levelPtr, msgPtr->procNamePtr, msgPtr->pid, msgPtr->compNamePtr,
+           msgPtr->threadNamePtr, msgPtr->fileNamePtr, msgPtr->functionNamePtr,
+           msgPtr->lineNumber, msgPtr->msgPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the messages waiting in all the binary log ring buffers in the system, then exits.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void DumpRingsAndExit
+(
+    void
+)
+{
+    DIR* dirPtr = opendir("/dev/shm");
+    struct dirent* entryPtr;
+    int exitCode = EXIT_SUCCESS;
+
+    if (dirPtr == NULL)
+    {
+        fprintf(stderr, "Could not open /dev/shm (%m).\n");
+        exit(EXIT_FAILURE);
+    }
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        size_t numDropped;
+
+        if (strncmp(entryPtr->d_name, LOG_RING_SHM_PREFIX, sizeof(LOG_RING_SHM_PREFIX) - 1) != 0)
+        {
+            continue;
+        }
+
+        le_result_t result = logRing_Read(entryPtr->d_name, PrintRingMsg, NULL, &numDropped);
+
+        if (numDropped > 0)
+        {
+            printf("*** %zu messages dropped from %s (ring buffer full) ***\n",
+                   numDropped, entryPtr->d_name);
+        }
+
+        if ((result != LE_OK) && (result != LE_NOT_FOUND))
+        {
+            fprintf(stderr, "Could not read ring buffer %s (%s).\n",
+                    entryPtr->d_name, LE_RESULT_TXT(result));
+            exitCode = EXIT_FAILURE;
+        }
+    }
+
+    closedir(dirPtr);
+
+    exit(exitCode);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------
 COMPONENT_INIT
@@ -553,6 +669,12 @@ COMPONENT_INIT
 
     le_arg_Scan();
 
+    // Dumping the ring buffers doesn't involve the Log Control Daemon.
+    if (DumpRings)
+    {
+        DumpRingsAndExit();
+    }
+
     // Connect to the Log Control Daemon and allocate a message buffer to hold the command.
     le_msg_SessionRef_t sessionRef = ConnectToLogControlDaemon();
     le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
@@ -84,7 +84,7 @@ void CheckBindingTarget
 //--------------------------------------------------------------------------------------------------
 /**
  * Verifies that all client-side interfaces of all applications in a system have been bound
- * to something.  Will auto-bind any unbound le_cfg or le_wdog interfaces it finds.
+ * to something.  Will auto-bind any unbound le_cfg, le_cfgBatch or le_wdog interfaces it finds.
  *
  * @throw mk::Exception_t if any client-side interface is unbound.
  */
@@ -118,6 +118,11 @@ void EnsureClientInterfacesBound
                             {
                                 BindToRootService(appPtr, ifInstancePtr, "le_cfg");
                             }
+                            // Same for the config tree's batch API.
+                            else if (ifInstancePtr->ifPtr->internalName == "le_cfgBatch")
+                            {
+                                BindToRootService(appPtr, ifInstancePtr, "le_cfgBatch");
+                            }
                             // If le_wdog API, then bind it to the one served by the root user.
                             else if (ifInstancePtr->ifPtr->internalName == "le_wdog")
                             {
@@ -163,7 +168,7 @@ void EnsureClientInterfacesBound
 /**
  * Verifies that all client-side interfaces of an application have either been bound to something
  * or marked as an external interface to be bound at the system level.  Will auto-bind any unbound
- * le_cfg or le_wdog interfaces it finds.
+ * le_cfg, le_cfgBatch or le_wdog interfaces it finds.
  *
  * @throw mk::Exception_t if any client-side interface is found to be unsatisfied.
  */
@@ -192,6 +197,11 @@ void EnsureClientInterfacesSatisfied
                         {
                             BindToRootService(appPtr, ifInstancePtr, "le_cfg");
                         }
+                        // Same for the config tree's batch API.
+                        else if (ifInstancePtr->ifPtr->internalName == "le_cfgBatch")
+                        {
+                            BindToRootService(appPtr, ifInstancePtr, "le_cfgBatch");
+                        }
                         // If this is an le_wdog API, bind it to the one offered by the root user.
                         else if (ifInstancePtr->ifPtr->internalName == "le_wdog")
                         {